@@ -0,0 +1,257 @@
+/*
+  GpxMatch - a demo program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <osmscout/gpx/Import.h>
+#include <osmscout/gpx/Export.h>
+#include <osmscout/gpx/MapMatcher.h>
+
+#include <osmscout/Database.h>
+#include <osmscout/routing/SimpleRoutingService.h>
+
+#include <osmscout/util/CmdLineParsing.h>
+#include <osmscout/util/Logger.h>
+#include <osmscout/util/StopClock.h>
+
+#include <iomanip>
+#include <iostream>
+
+/*
+ * Matches all tracks of the gpx file to the road network of the database and
+ * writes the matched routes as tracks to the output file, for example:
+ *
+ *   GpxMatch --car ../maps/nordrhein-westfalen recorded.gpx matched.gpx
+ */
+
+struct Arguments
+{
+  bool              help=false;
+  std::string       router=osmscout::RoutingService::DEFAULT_FILENAME_BASE;
+  osmscout::Vehicle vehicle=osmscout::Vehicle::vehicleCar;
+  double            sigma=10.0;
+  std::string       databaseDirectory;
+  std::string       gpxInput;
+  std::string       gpxOutput;
+};
+
+/**
+ * Convert the matched route to a track segment
+ */
+static bool GetRouteSegment(osmscout::SimpleRoutingService& router,
+                            const osmscout::RouteData& route,
+                            osmscout::gpx::TrackSegment& segment)
+{
+  std::list<osmscout::Point> points;
+
+  if (!router.TransformRouteDataToPoints(route,points)) {
+    return false;
+  }
+
+  for (const auto& point : points) {
+    segment.points.emplace_back(point.GetCoord());
+  }
+
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  osmscout::CmdLineParser   argParser("GpxMatch",
+                                      argc,argv);
+  std::vector<std::string>  helpArgs{"h","help"};
+  Arguments                 args;
+
+  argParser.AddOption(osmscout::CmdLineFlag([&args](const bool& value) {
+                        args.help=value;
+                      }),
+                      helpArgs,
+                      "Return argument help",
+                      true);
+
+  argParser.AddOption(osmscout::CmdLineAlternativeFlag([&args](const std::string& value) {
+                        if (value=="foot") {
+                          args.vehicle=osmscout::Vehicle::vehicleFoot;
+                        }
+                        else if (value=="bicycle") {
+                          args.vehicle=osmscout::Vehicle::vehicleBicycle;
+                        }
+                        else if (value=="car") {
+                          args.vehicle=osmscout::Vehicle::vehicleCar;
+                        }
+                      }),
+                      {"foot","bicycle","car"},
+                      "Vehicle type used for recording the track");
+
+  argParser.AddOption(osmscout::CmdLineDoubleOption([&args](const double& value) {
+                        args.sigma=value;
+                      }),
+                      "sigma",
+                      "Standard deviation of the GPS error in meters");
+
+  argParser.AddOption(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                        args.router=value;
+                      }),
+                      "router",
+                      "Router filename base");
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                            args.databaseDirectory=value;
+                          }),
+                          "DATABASE",
+                          "Directory of the database to use");
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                            args.gpxInput=value;
+                          }),
+                          "GPXFILEINPUT",
+                          "Gpx file for import");
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                            args.gpxOutput=value;
+                          }),
+                          "GPXFILEOUTPUT",
+                          "Gpx file for export of the matched routes");
+
+  osmscout::CmdLineParseResult result=argParser.Parse();
+
+  if (result.HasError()) {
+    std::cerr << "ERROR: " << result.GetErrorDescription() << std::endl;
+    std::cout << argParser.GetHelp() << std::endl;
+    return 1;
+  } else if (args.help) {
+    std::cout << argParser.GetHelp() << std::endl;
+    return 0;
+  } else if (!osmscout::ExistsInFilesystem(args.gpxInput)) {
+    std::cerr << "ERROR: Input file " << args.gpxInput << " don't exists" << std::endl;
+    std::cout << argParser.GetHelp() << std::endl;
+    return 1;
+  }
+
+  osmscout::gpx::GpxFile gpxFile;
+
+  if (!ImportGpx(args.gpxInput, gpxFile)){
+    return 1;
+  }
+
+  osmscout::DatabaseParameter databaseParameter;
+  osmscout::DatabaseRef       database=std::make_shared<osmscout::Database>(databaseParameter);
+
+  if (!database->Open(args.databaseDirectory)) {
+    std::cerr << "Cannot open database" << std::endl;
+
+    return 1;
+  }
+
+  osmscout::RouterParameter         routerParameter;
+  osmscout::SimpleRoutingServiceRef router=std::make_shared<osmscout::SimpleRoutingService>(database,
+                                                                                            routerParameter,
+                                                                                            args.router);
+
+  if (!router->Open()) {
+    std::cerr << "Cannot open routing database" << std::endl;
+
+    return 1;
+  }
+
+  osmscout::gpx::MapMatchingParameter parameter;
+  osmscout::gpx::GpxFile              matchedFile;
+
+  parameter.SetMeasurementSigma(osmscout::Distance::Of<osmscout::Meter>(args.sigma));
+
+  for (const auto &track:gpxFile.tracks){
+    if (track.name.hasValue()) {
+      std::cout << "Track \"" << track.name.get() << "\":" << std::endl;
+    }else{
+      std::cout << "Unnamed track:" << std::endl;
+    }
+
+    osmscout::gpx::Track matchedTrack(track);
+
+    matchedTrack.segments.clear();
+
+    for (const auto &segment:track.segments) {
+      osmscout::gpx::MapMatchingResult matchingResult;
+      osmscout::StopClock              clock;
+
+      if (!osmscout::gpx::MatchTrack(router,
+                                     args.vehicle,
+                                     segment.points,
+                                     parameter,
+                                     matchingResult)) {
+        std::cerr << "Error while matching track" << std::endl;
+        router->Close();
+        return 1;
+      }
+
+      clock.Stop();
+
+      size_t matched=0;
+      double confidence=0.0;
+
+      for (const auto& point : matchingResult.points) {
+        if (point.matched) {
+          matched++;
+          confidence+=point.confidence;
+        }
+      }
+
+      double seconds=clock.GetMilliseconds()/1000.0;
+
+      std::cout << "  points:              " << segment.points.size() << std::endl;
+      std::cout << "  matching:            " << clock.GetMilliseconds() << "ms";
+      if (seconds>0.0) {
+        std::cout << " (" << std::fixed << std::setprecision(0) << segment.points.size()/seconds << " points/s)";
+      }
+      std::cout << std::endl;
+
+      if (!segment.points.empty()) {
+        std::cout << "  matched:             " << std::fixed << std::setprecision(1) << matched*100.0/segment.points.size() << "%" << std::endl;
+      }
+
+      if (matched>0) {
+        std::cout << "  mean confidence:     " << std::fixed << std::setprecision(2) << confidence/matched << std::endl;
+      }
+
+      std::cout << "  connected routes:    " << matchingResult.routes.size() << std::endl;
+
+      for (const auto& route : matchingResult.routes) {
+        osmscout::gpx::TrackSegment matchedSegment;
+
+        if (!GetRouteSegment(*router,
+                             route,
+                             matchedSegment)) {
+          std::cerr << "Cannot transform route to points" << std::endl;
+          router->Close();
+          return 1;
+        }
+
+        matchedTrack.segments.push_back(matchedSegment);
+      }
+    }
+
+    matchedFile.tracks.push_back(matchedTrack);
+  }
+
+  router->Close();
+
+  if (!ExportGpx(matchedFile, args.gpxOutput)){
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,288 @@
+/*
+  Isochrone - a demo program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <iostream>
+#include <iomanip>
+
+#include <osmscout/Database.h>
+#include <osmscout/routing/SimpleRoutingService.h>
+#include <osmscout/routing/CostGrid.h>
+
+#include <osmscout/util/CmdLineParsing.h>
+#include <osmscout/util/StopClock.h>
+
+/*
+ * Calculates everything reachable from the start position within the given time
+ * and prints the iso-polygons for the given number of steps, for example:
+ *
+ *   Isochrone --time 15 --steps 3 ../maps/nordrhein-westfalen 51.5717798 7.4587852
+ */
+
+struct Arguments
+{
+  bool                   help=false;
+  std::string            router=osmscout::RoutingService::DEFAULT_FILENAME_BASE;
+  osmscout::Vehicle      vehicle=osmscout::Vehicle::vehicleCar;
+  double                 time=15.0;
+  size_t                 steps=3;
+  double                 cellSize=250.0;
+  bool                   wkt=false;
+  std::string            databaseDirectory;
+  osmscout::GeoCoord     start;
+};
+
+static void GetCarSpeedTable(std::map<std::string,double>& map)
+{
+  map["highway_motorway"]=110.0;
+  map["highway_motorway_trunk"]=100.0;
+  map["highway_motorway_primary"]=70.0;
+  map["highway_motorway_link"]=60.0;
+  map["highway_motorway_junction"]=60.0;
+  map["highway_trunk"]=100.0;
+  map["highway_trunk_link"]=60.0;
+  map["highway_primary"]=70.0;
+  map["highway_primary_link"]=60.0;
+  map["highway_secondary"]=60.0;
+  map["highway_secondary_link"]=50.0;
+  map["highway_tertiary_link"]=55.0;
+  map["highway_tertiary"]=55.0;
+  map["highway_unclassified"]=50.0;
+  map["highway_road"]=50.0;
+  map["highway_residential"]=40.0;
+  map["highway_roundabout"]=40.0;
+  map["highway_living_street"]=10.0;
+  map["highway_service"]=30.0;
+}
+
+/**
+ * Print the polygons as WKT MULTIPOLYGON, each polygon as its own ring
+ */
+static void PrintWKT(const std::vector<std::vector<osmscout::GeoCoord>>& polygons)
+{
+  std::cout << "MULTIPOLYGON(";
+
+  for (size_t p=0; p<polygons.size(); p++) {
+    if (p>0) {
+      std::cout << ",";
+    }
+
+    std::cout << "((";
+
+    for (size_t i=0; i<=polygons[p].size(); i++) {
+      const osmscout::GeoCoord& coord=polygons[p][i%polygons[p].size()];
+
+      if (i>0) {
+        std::cout << ",";
+      }
+
+      std::cout << std::fixed << std::setprecision(6) << coord.GetLon() << " " << coord.GetLat();
+    }
+
+    std::cout << "))";
+  }
+
+  std::cout << ")" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  osmscout::CmdLineParser   argParser("Isochrone",
+                                      argc,argv);
+  std::vector<std::string>  helpArgs{"h","help"};
+  Arguments                 args;
+
+  argParser.AddOption(osmscout::CmdLineFlag([&args](const bool& value) {
+                        args.help=value;
+                      }),
+                      helpArgs,
+                      "Return argument help",
+                      true);
+
+  argParser.AddOption(osmscout::CmdLineDoubleOption([&args](double value) {
+                        args.time=value;
+                      }),
+                      "time",
+                      "Maximum travel time in minutes");
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                        args.steps=value;
+                      }),
+                      "steps",
+                      "Number of iso-polygons up to the maximum travel time");
+
+  argParser.AddOption(osmscout::CmdLineDoubleOption([&args](double value) {
+                        args.cellSize=value;
+                      }),
+                      "cellSize",
+                      "Size of the cells of the cost grid in meters");
+
+  argParser.AddOption(osmscout::CmdLineFlag([&args](const bool& value) {
+                        args.wkt=value;
+                      }),
+                      "wkt",
+                      "Print the iso-polygons as WKT");
+
+  argParser.AddOption(osmscout::CmdLineAlternativeFlag([&args](const std::string& value) {
+                        if (value=="foot") {
+                          args.vehicle=osmscout::Vehicle::vehicleFoot;
+                        }
+                        else if (value=="bicycle") {
+                          args.vehicle=osmscout::Vehicle::vehicleBicycle;
+                        }
+                        else if (value=="car") {
+                          args.vehicle=osmscout::Vehicle::vehicleCar;
+                        }
+                      }),
+                      {"foot","bicycle","car"},
+                      "Vehicle type to use for routing");
+
+  argParser.AddOption(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                        args.router=value;
+                      }),
+                      "router",
+                      "Router filename base");
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                            args.databaseDirectory=value;
+                          }),
+                          "DATABASE",
+                          "Directory of the database to use");
+
+  argParser.AddPositional(osmscout::CmdLineGeoCoordOption([&args](const osmscout::GeoCoord& value) {
+                            args.start=value;
+                          }),
+                          "START",
+                          "Start coordinate");
+
+  osmscout::CmdLineParseResult cmdLineParseResult=argParser.Parse();
+
+  if (cmdLineParseResult.HasError()) {
+    std::cerr << "ERROR: " << cmdLineParseResult.GetErrorDescription() << std::endl;
+    std::cout << argParser.GetHelp() << std::endl;
+    return 1;
+  }
+
+  if (args.help) {
+    std::cout << argParser.GetHelp() << std::endl;
+    return 0;
+  }
+
+  osmscout::DatabaseParameter databaseParameter;
+  osmscout::DatabaseRef       database=std::make_shared<osmscout::Database>(databaseParameter);
+
+  if (!database->Open(args.databaseDirectory)) {
+    std::cerr << "Cannot open database" << std::endl;
+
+    return 1;
+  }
+
+  osmscout::FastestPathRoutingProfileRef routingProfile=std::make_shared<osmscout::FastestPathRoutingProfile>(database->GetTypeConfig());
+  osmscout::RouterParameter              routerParameter;
+  osmscout::SimpleRoutingServiceRef      router=std::make_shared<osmscout::SimpleRoutingService>(database,
+                                                                                                 routerParameter,
+                                                                                                 args.router);
+
+  if (!router->Open()) {
+    std::cerr << "Cannot open routing database" << std::endl;
+
+    return 1;
+  }
+
+  osmscout::TypeConfigRef      typeConfig=database->GetTypeConfig();
+  std::map<std::string,double> carSpeedTable;
+
+  switch (args.vehicle) {
+  case osmscout::vehicleFoot:
+    routingProfile->ParametrizeForFoot(*typeConfig,
+                                       5.0);
+    break;
+  case osmscout::vehicleBicycle:
+    routingProfile->ParametrizeForBicycle(*typeConfig,
+                                          20.0);
+    break;
+  case osmscout::vehicleCar:
+    GetCarSpeedTable(carSpeedTable);
+    routingProfile->ParametrizeForCar(*typeConfig,
+                                      carSpeedTable,
+                                      160.0);
+    break;
+  }
+
+  osmscout::RoutePosition start=router->GetClosestRoutableNode(args.start,
+                                                               *routingProfile,
+                                                               osmscout::Distance::Of<osmscout::Kilometer>(1));
+
+  if (!start.IsValid()) {
+    std::cerr << "Error while searching for routing node near start location!" << std::endl;
+    router->Close();
+    return 1;
+  }
+
+  // The costs of the FastestPathRoutingProfile are the travel time in hours
+  osmscout::RoutingParameter   parameter;
+  osmscout::StopClock          searchClock;
+  osmscout::ReachabilityResult result=router->CalculateReachability(*routingProfile,
+                                                                    start,
+                                                                    args.time/60.0,
+                                                                    parameter);
+
+  searchClock.Stop();
+
+  if (!result.Success()) {
+    std::cerr << "There was an error while calculating the reachable area!" << std::endl;
+    router->Close();
+    return 1;
+  }
+
+  osmscout::StopClock gridClock;
+  osmscout::CostGrid  grid=osmscout::CostGrid::Create(result,
+                                                      osmscout::Distance::Of<osmscout::Meter>(args.cellSize));
+
+  gridClock.Stop();
+
+  std::cout << "Route nodes reached: " << result.GetNodes().size() << std::endl;
+  std::cout << "Search:              " << searchClock.GetMilliseconds() << "ms" << std::endl;
+  std::cout << "Cost grid:           " << grid.GetColumns() << "x" << grid.GetRows() << ", " << gridClock.GetMilliseconds() << "ms" << std::endl;
+
+  size_t steps=std::max(args.steps,(size_t)1);
+
+  for (size_t step=1; step<=steps; step++) {
+    double              time=args.time*step/steps;
+    osmscout::StopClock polygonClock;
+    auto                polygons=grid.GetIsoPolygons(time/60.0);
+    size_t              points=0;
+
+    polygonClock.Stop();
+
+    for (const auto& polygon : polygons) {
+      points+=polygon.size();
+    }
+
+    std::cout << std::fixed << std::setprecision(1) << time << "min: ";
+    std::cout << polygons.size() << " polygon(s), " << points << " points, " << polygonClock.GetMilliseconds() << "ms" << std::endl;
+
+    if (args.wkt) {
+      PrintWKT(polygons);
+    }
+  }
+
+  router->Close();
+
+  return 0;
+}
@@ -0,0 +1,363 @@
+/*
+  MVTTiler - a demo program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include <osmscout/Database.h>
+#include <osmscout/MapService.h>
+#include <osmscout/TileRenderPipeline.h>
+
+#include <osmscout/MapPainterMVT.h>
+
+#include <osmscout/util/CmdLineParsing.h>
+#include <osmscout/util/StopClock.h>
+
+/*
+  Exports all tiles of the given area and zoom levels as Mapbox vector tiles
+  and reports the throughput for each zoom level, for example:
+
+  MVTTiler --output tiles ../maps/nordrhein-westfalen ../stylesheets/standard.oss 51.7 6.5 51.2 8.0 10 14
+
+  The tiles are written as "<level>_<x>_<y>.mvt". Without "--output" the
+  tiles are encoded, but not written.
+*/
+
+struct Arguments
+{
+  bool               help=false;
+  std::string        output;
+  size_t             extent=4096;
+  size_t             buffer=64;
+  size_t             threads=0;
+  std::string        databaseDirectory;
+  std::string        style;
+  osmscout::GeoCoord topLeft;
+  osmscout::GeoCoord bottomRight;
+  size_t             startZoom=0;
+  size_t             endZoom=0;
+};
+
+struct LevelStatistics
+{
+  size_t tileCount=0;
+  size_t emptyTileCount=0;
+  size_t failedTileCount=0;
+  size_t bytes=0;
+  double seconds=0.0;
+  double loadSeconds=0.0;
+  double encodeSeconds=0.0;
+  double maxEncodeSeconds=0.0;
+};
+
+/**
+ * Discards the tiles, for measuring without disk I/O
+ */
+class NullTileSink : public osmscout::TileSink
+{
+public:
+  bool StoreTile(const osmscout::MagnificationLevel& /*level*/,
+                 const osmscout::OSMTileId& /*tile*/,
+                 const std::vector<char>& /*data*/) override
+  {
+    return true;
+  }
+};
+
+static bool ExportLevel(const osmscout::MapServiceRef& mapService,
+                        const osmscout::StyleConfigRef& styleConfig,
+                        const osmscout::MapPainterMVT& painter,
+                        const osmscout::TileSinkRef& sink,
+                        const osmscout::AreaSearchParameter& searchParameter,
+                        const osmscout::MapParameter& drawParameter,
+                        const osmscout::MagnificationLevel& level,
+                        const osmscout::GeoBox& boundingBox,
+                        size_t threadCount,
+                        LevelStatistics& statistics)
+{
+  osmscout::Magnification          magnification(level);
+  osmscout::OSMTileIdBox           tileBox(osmscout::OSMTileId::GetOSMTile(magnification,
+                                                                           boundingBox.GetMinCoord()),
+                                           osmscout::OSMTileId::GetOSMTile(magnification,
+                                                                           boundingBox.GetMaxCoord()));
+  std::vector<osmscout::OSMTileId> tiles(tileBox.begin(),tileBox.end());
+  std::atomic<size_t>              nextTile(0);
+  std::mutex                       statisticsMutex;
+  osmscout::StopClock              levelTimer;
+
+  auto worker=[&]() {
+    LevelStatistics   workerStatistics;
+    std::vector<char> tileData;
+
+    for (size_t index=nextTile++; index<tiles.size(); index=nextTile++) {
+      osmscout::TileProjection     projection;
+      osmscout::MapData            data;
+      std::list<osmscout::TileRef> dataTiles;
+
+      projection.Set(tiles[index],
+                     magnification,
+                     96.0,
+                     256,
+                     256);
+
+      osmscout::StopClock loadTimer;
+
+      mapService->LookupTiles(projection,dataTiles);
+
+      bool success=mapService->LoadMissingTileData(searchParameter,
+                                                   *styleConfig,
+                                                   dataTiles);
+
+      mapService->AddTileDataToMapData(dataTiles,data);
+
+      loadTimer.Stop();
+
+      osmscout::StopClock encodeTimer;
+
+      success=success && painter.DrawMap(projection,
+                                         drawParameter,
+                                         data,
+                                         tileData);
+
+      encodeTimer.Stop();
+
+      success=success && (tileData.empty() ||
+                          sink->StoreTile(level,
+                                          tiles[index],
+                                          tileData));
+
+      double encodeSeconds=encodeTimer.GetMilliseconds()/1000.0;
+
+      workerStatistics.loadSeconds+=loadTimer.GetMilliseconds()/1000.0;
+      workerStatistics.encodeSeconds+=encodeSeconds;
+      workerStatistics.maxEncodeSeconds=std::max(workerStatistics.maxEncodeSeconds,encodeSeconds);
+
+      if (!success) {
+        workerStatistics.failedTileCount++;
+      }
+      else if (tileData.empty()) {
+        workerStatistics.emptyTileCount++;
+      }
+      else {
+        workerStatistics.tileCount++;
+        workerStatistics.bytes+=tileData.size();
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+
+    statistics.tileCount+=workerStatistics.tileCount;
+    statistics.emptyTileCount+=workerStatistics.emptyTileCount;
+    statistics.failedTileCount+=workerStatistics.failedTileCount;
+    statistics.bytes+=workerStatistics.bytes;
+    statistics.loadSeconds+=workerStatistics.loadSeconds;
+    statistics.encodeSeconds+=workerStatistics.encodeSeconds;
+    statistics.maxEncodeSeconds=std::max(statistics.maxEncodeSeconds,workerStatistics.maxEncodeSeconds);
+  };
+
+  std::vector<std::thread> workers;
+
+  for (size_t i=1; i<threadCount; i++) {
+    workers.emplace_back(worker);
+  }
+
+  worker();
+
+  for (auto& thread : workers) {
+    thread.join();
+  }
+
+  levelTimer.Stop();
+
+  statistics.seconds=levelTimer.GetMilliseconds()/1000.0;
+
+  return statistics.failedTileCount==0;
+}
+
+int main(int argc, char* argv[])
+{
+  osmscout::CmdLineParser   argParser("MVTTiler",
+                                      argc,argv);
+  std::vector<std::string>  helpArgs{"h","help"};
+  Arguments                 args;
+
+  argParser.AddOption(osmscout::CmdLineFlag([&args](const bool& value) {
+                        args.help=value;
+                      }),
+                      helpArgs,
+                      "Return argument help",
+                      true);
+
+  argParser.AddOption(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                        args.output=value;
+                      }),
+                      "output",
+                      "Directory to write the tiles to");
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                        args.extent=value;
+                      }),
+                      "extent",
+                      "Width and height of a tile in tile coordinates");
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                        args.buffer=value;
+                      }),
+                      "buffer",
+                      "Size of the border around each tile in tile coordinates");
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                        args.threads=value;
+                      }),
+                      "threads",
+                      "Number of threads (0 for all hardware threads)");
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                            args.databaseDirectory=value;
+                          }),
+                          "DATABASE",
+                          "Directory of the database to use");
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                            args.style=value;
+                          }),
+                          "STYLESHEET",
+                          "Map stylesheet file to use");
+
+  argParser.AddPositional(osmscout::CmdLineGeoCoordOption([&args](const osmscout::GeoCoord& value) {
+                            args.topLeft=value;
+                          }),
+                          "TOP_LEFT",
+                          "Top left coordinate of the area");
+
+  argParser.AddPositional(osmscout::CmdLineGeoCoordOption([&args](const osmscout::GeoCoord& value) {
+                            args.bottomRight=value;
+                          }),
+                          "BOTTOM_RIGHT",
+                          "Bottom right coordinate of the area");
+
+  argParser.AddPositional(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                            args.startZoom=value;
+                          }),
+                          "START_ZOOM",
+                          "First zoom level to export");
+
+  argParser.AddPositional(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                            args.endZoom=value;
+                          }),
+                          "END_ZOOM",
+                          "Last zoom level to export");
+
+  osmscout::CmdLineParseResult cmdLineParseResult=argParser.Parse();
+
+  if (cmdLineParseResult.HasError()) {
+    std::cerr << "ERROR: " << cmdLineParseResult.GetErrorDescription() << std::endl;
+    std::cout << argParser.GetHelp() << std::endl;
+    return 1;
+  }
+
+  if (args.help) {
+    std::cout << argParser.GetHelp() << std::endl;
+    return 0;
+  }
+
+  osmscout::DatabaseParameter databaseParameter;
+  osmscout::DatabaseRef       database=std::make_shared<osmscout::Database>(databaseParameter);
+  osmscout::MapServiceRef     mapService=std::make_shared<osmscout::MapService>(database);
+
+  if (!database->Open(args.databaseDirectory)) {
+    std::cerr << "Cannot open database" << std::endl;
+    return 1;
+  }
+
+  osmscout::StyleConfigRef styleConfig=std::make_shared<osmscout::StyleConfig>(database->GetTypeConfig());
+
+  if (!styleConfig->Load(args.style)) {
+    std::cerr << "Cannot open style" << std::endl;
+    return 1;
+  }
+
+  osmscout::TileSinkRef sink;
+
+  if (args.output.empty()) {
+    sink=std::make_shared<NullTileSink>();
+  }
+  else {
+    sink=std::make_shared<osmscout::FileTileSink>(args.output,
+                                                  "mvt");
+  }
+
+  osmscout::MapPainterMVT       painter(styleConfig);
+  osmscout::MapParameter        drawParameter;
+  osmscout::AreaSearchParameter searchParameter;
+  size_t                        threads=args.threads>0 ? args.threads : std::max(std::thread::hardware_concurrency(),1u);
+  osmscout::GeoBox              boundingBox(args.topLeft,
+                                            args.bottomRight);
+  bool                          success=true;
+
+  painter.SetExtent((uint32_t)args.extent);
+  painter.SetBuffer((uint32_t)args.buffer);
+
+  searchParameter.SetUseLowZoomOptimization(true);
+  searchParameter.SetUseMultithreading(true);
+
+  std::cout << "Level   Tiles  Empty Failed      Bytes   Time[s] Load[ms] Encode[ms] Max[ms]  Tiles/s" << std::endl;
+
+  for (size_t zoom=std::min(args.startZoom,args.endZoom);
+       zoom<=std::max(args.startZoom,args.endZoom);
+       zoom++) {
+    LevelStatistics statistics;
+
+    if (!ExportLevel(mapService,
+                     styleConfig,
+                     painter,
+                     sink,
+                     searchParameter,
+                     drawParameter,
+                     osmscout::MagnificationLevel((uint32_t)zoom),
+                     boundingBox,
+                     threads,
+                     statistics)) {
+      success=false;
+    }
+
+    size_t tileCount=statistics.tileCount+statistics.emptyTileCount+statistics.failedTileCount;
+
+    // Load and encode times are the average per tile
+    std::cout << std::setw(5) << zoom << " ";
+    std::cout << std::setw(7) << statistics.tileCount << " ";
+    std::cout << std::setw(6) << statistics.emptyTileCount << " ";
+    std::cout << std::setw(6) << statistics.failedTileCount << " ";
+    std::cout << std::setw(10) << statistics.bytes << " ";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(9) << statistics.seconds << " ";
+    std::cout << std::setw(8) << (tileCount>0 ? statistics.loadSeconds*1000.0/tileCount : 0.0) << " ";
+    std::cout << std::setw(10) << (tileCount>0 ? statistics.encodeSeconds*1000.0/tileCount : 0.0) << " ";
+    std::cout << std::setw(7) << statistics.maxEncodeSeconds*1000.0 << " ";
+    std::cout << std::setw(8) << std::setprecision(1) << (statistics.seconds>0.0 ? tileCount/statistics.seconds : 0.0) << std::endl;
+  }
+
+  database->Close();
+
+  return success ? 0 : 1;
+}
@@ -0,0 +1,441 @@
+/*
+  MetaTiler - a demo program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+#include "config.h"
+
+#include <osmscout/Database.h>
+#include <osmscout/MapService.h>
+#include <osmscout/TileRenderPipeline.h>
+
+#include <osmscout/MapPainterNoOp.h>
+
+#if defined(HAVE_LIB_OSMSCOUTMAPCAIRO)
+#include <osmscout/MapPainterCairo.h>
+#endif
+
+#if defined(HAVE_LIB_OSMSCOUTMAPAGG)
+#include <osmscout/MapPainterAgg.h>
+#endif
+
+#include <osmscout/util/CmdLineParsing.h>
+
+/*
+  Renders all tiles of the given area and zoom levels using metatiles and
+  reports the throughput for each zoom level, for example:
+
+  MetaTiler --driver agg --output tiles --journal tiles/journal.txt \
+    ../maps/nordrhein-westfalen ../stylesheets/standard.oss 51.7 6.5 51.2 8.0 10 13
+
+  Without "--output" the tiles are encoded, but not written.
+*/
+
+struct Arguments
+{
+  bool               help=false;
+  std::string        driver="noop";
+  std::string        output;
+  std::string        journal;
+  std::string        fontName="/usr/share/fonts/TTF/DejaVuSans.ttf";
+  size_t             metaTileSize=8;
+  size_t             tileSize=256;
+  size_t             threads=0;
+  size_t             encoderThreads=0;
+  double             dpi=96.0;
+  std::string        databaseDirectory;
+  std::string        style;
+  osmscout::GeoCoord topLeft;
+  osmscout::GeoCoord bottomRight;
+  size_t             startZoom=0;
+  size_t             endZoom=0;
+};
+
+/**
+ * Only measures data loading, preparation and label layout
+ */
+class NoOpDrawer : public osmscout::MetaTileDrawer
+{
+private:
+  osmscout::MapPainterNoOp painter;
+
+public:
+  explicit NoOpDrawer(const osmscout::StyleConfigRef& styleConfig)
+  : painter(styleConfig)
+  {
+    // no code
+  }
+
+  bool DrawMetaTile(const osmscout::Projection& projection,
+                    const osmscout::MapParameter& parameter,
+                    const osmscout::MapData& data,
+                    osmscout::TileBitmap& bitmap) override
+  {
+    bitmap.Resize(osmscout::TileBitmap::RGB24,
+                  projection.GetWidth(),
+                  projection.GetHeight());
+
+    return painter.DrawMap(projection,
+                           parameter,
+                           data);
+  }
+};
+
+#if defined(HAVE_LIB_OSMSCOUTMAPCAIRO)
+class CairoDrawer : public osmscout::MetaTileDrawer
+{
+private:
+  osmscout::MapPainterCairo painter;
+
+public:
+  explicit CairoDrawer(const osmscout::StyleConfigRef& styleConfig)
+  : painter(styleConfig)
+  {
+    // no code
+  }
+
+  bool DrawMetaTile(const osmscout::Projection& projection,
+                    const osmscout::MapParameter& parameter,
+                    const osmscout::MapData& data,
+                    osmscout::TileBitmap& bitmap) override
+  {
+    cairo_surface_t *surface=cairo_image_surface_create(CAIRO_FORMAT_RGB24,
+                                                        (int)projection.GetWidth(),
+                                                        (int)projection.GetHeight());
+
+    if (cairo_surface_status(surface)!=CAIRO_STATUS_SUCCESS) {
+      cairo_surface_destroy(surface);
+      return false;
+    }
+
+    cairo_t *draw=cairo_create(surface);
+    bool    success=painter.DrawMap(projection,
+                                    parameter,
+                                    data,
+                                    draw);
+
+    cairo_destroy(draw);
+    cairo_surface_flush(surface);
+
+    bitmap.Resize(osmscout::TileBitmap::RGB24,
+                  projection.GetWidth(),
+                  projection.GetHeight());
+
+    const unsigned char* surfaceData=cairo_image_surface_get_data(surface);
+    int                  surfaceStride=cairo_image_surface_get_stride(surface);
+
+    // Pixels are stored as native endian 32 bit values xRGB
+    for (size_t y=0; y<bitmap.GetHeight(); y++) {
+      const uint32_t* source=reinterpret_cast<const uint32_t*>(surfaceData+y*surfaceStride);
+      unsigned char*  destination=bitmap.GetRow(y);
+
+      for (size_t x=0; x<bitmap.GetWidth(); x++) {
+        *destination++=(unsigned char)((source[x] >> 16) & 0xff);
+        *destination++=(unsigned char)((source[x] >> 8) & 0xff);
+        *destination++=(unsigned char)(source[x] & 0xff);
+      }
+    }
+
+    cairo_surface_destroy(surface);
+
+    return success;
+  }
+};
+#endif
+
+#if defined(HAVE_LIB_OSMSCOUTMAPAGG)
+class AggDrawer : public osmscout::MetaTileDrawer
+{
+private:
+  osmscout::MapPainterAgg painter;
+
+public:
+  explicit AggDrawer(const osmscout::StyleConfigRef& styleConfig)
+  : painter(styleConfig)
+  {
+    // no code
+  }
+
+  bool DrawMetaTile(const osmscout::Projection& projection,
+                    const osmscout::MapParameter& parameter,
+                    const osmscout::MapData& data,
+                    osmscout::TileBitmap& bitmap) override
+  {
+    bitmap.Resize(osmscout::TileBitmap::RGB24,
+                  projection.GetWidth(),
+                  projection.GetHeight());
+
+    agg::rendering_buffer                   rbuf(bitmap.GetData(),
+                                                 (unsigned int)bitmap.GetWidth(),
+                                                 (unsigned int)bitmap.GetHeight(),
+                                                 (int)bitmap.GetStride());
+    osmscout::MapPainterAgg::AggPixelFormat pf(rbuf);
+
+    return painter.DrawMap(projection,
+                           parameter,
+                           data,
+                           &pf);
+  }
+};
+#endif
+
+/**
+ * Discards the tiles, for measuring without disk I/O
+ */
+class NullTileSink : public osmscout::TileSink
+{
+public:
+  bool StoreTile(const osmscout::MagnificationLevel& /*level*/,
+                 const osmscout::OSMTileId& /*tile*/,
+                 const std::vector<char>& /*data*/) override
+  {
+    return true;
+  }
+};
+
+int main(int argc, char* argv[])
+{
+  osmscout::CmdLineParser   argParser("MetaTiler",
+                                      argc,argv);
+  std::vector<std::string>  helpArgs{"h","help"};
+  Arguments                 args;
+
+  argParser.AddOption(osmscout::CmdLineFlag([&args](const bool& value) {
+                        args.help=value;
+                      }),
+                      helpArgs,
+                      "Return argument help",
+                      true);
+
+  argParser.AddOption(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                        args.driver=value;
+                      }),
+                      "driver",
+                      "Rendering backend (noop, agg or cairo)");
+
+  argParser.AddOption(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                        args.output=value;
+                      }),
+                      "output",
+                      "Directory to write the tiles to");
+
+  argParser.AddOption(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                        args.journal=value;
+                      }),
+                      "journal",
+                      "Journal of rendered metatiles, to resume an aborted run");
+
+  argParser.AddOption(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                        args.fontName=value;
+                      }),
+                      "font",
+                      "Font file used by the agg backend");
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                        args.metaTileSize=value;
+                      }),
+                      "metaTileSize",
+                      "Number of tiles in each direction of a metatile");
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                        args.tileSize=value;
+                      }),
+                      "tileSize",
+                      "Width and height of a tile in pixel (256 or 512)");
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                        args.threads=value;
+                      }),
+                      "threads",
+                      "Number of drawing threads (0 for all hardware threads)");
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                        args.encoderThreads=value;
+                      }),
+                      "encoderThreads",
+                      "Number of encoding threads (0 for all hardware threads)");
+
+  argParser.AddOption(osmscout::CmdLineDoubleOption([&args](double value) {
+                        args.dpi=value;
+                      }),
+                      "dpi",
+                      "DPI of the tiles");
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                            args.databaseDirectory=value;
+                          }),
+                          "DATABASE",
+                          "Directory of the database to use");
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                            args.style=value;
+                          }),
+                          "STYLESHEET",
+                          "Map stylesheet file to use");
+
+  argParser.AddPositional(osmscout::CmdLineGeoCoordOption([&args](const osmscout::GeoCoord& value) {
+                            args.topLeft=value;
+                          }),
+                          "TOP_LEFT",
+                          "Top left coordinate of the area");
+
+  argParser.AddPositional(osmscout::CmdLineGeoCoordOption([&args](const osmscout::GeoCoord& value) {
+                            args.bottomRight=value;
+                          }),
+                          "BOTTOM_RIGHT",
+                          "Bottom right coordinate of the area");
+
+  argParser.AddPositional(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                            args.startZoom=value;
+                          }),
+                          "START_ZOOM",
+                          "First zoom level to render");
+
+  argParser.AddPositional(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                            args.endZoom=value;
+                          }),
+                          "END_ZOOM",
+                          "Last zoom level to render");
+
+  osmscout::CmdLineParseResult cmdLineParseResult=argParser.Parse();
+
+  if (cmdLineParseResult.HasError()) {
+    std::cerr << "ERROR: " << cmdLineParseResult.GetErrorDescription() << std::endl;
+    std::cout << argParser.GetHelp() << std::endl;
+    return 1;
+  }
+
+  if (args.help) {
+    std::cout << argParser.GetHelp() << std::endl;
+    return 0;
+  }
+
+  osmscout::DatabaseParameter databaseParameter;
+  osmscout::DatabaseRef       database=std::make_shared<osmscout::Database>(databaseParameter);
+  osmscout::MapServiceRef     mapService=std::make_shared<osmscout::MapService>(database);
+
+  if (!database->Open(args.databaseDirectory)) {
+    std::cerr << "Cannot open database" << std::endl;
+    return 1;
+  }
+
+  osmscout::StyleConfigRef styleConfig=std::make_shared<osmscout::StyleConfig>(database->GetTypeConfig());
+
+  if (!styleConfig->Load(args.style)) {
+    std::cerr << "Cannot open style" << std::endl;
+    return 1;
+  }
+
+  osmscout::TileRenderPipeline::DrawerFactory drawerFactory;
+
+  if (args.driver=="noop") {
+    drawerFactory=[styleConfig]() {
+      return std::make_shared<NoOpDrawer>(styleConfig);
+    };
+  }
+#if defined(HAVE_LIB_OSMSCOUTMAPCAIRO)
+  else if (args.driver=="cairo") {
+    drawerFactory=[styleConfig]() {
+      return std::make_shared<CairoDrawer>(styleConfig);
+    };
+  }
+#endif
+#if defined(HAVE_LIB_OSMSCOUTMAPAGG)
+  else if (args.driver=="agg") {
+    drawerFactory=[styleConfig]() {
+      return std::make_shared<AggDrawer>(styleConfig);
+    };
+  }
+#endif
+  else {
+    std::cerr << "Unsupported driver '" << args.driver << "'" << std::endl;
+    return 1;
+  }
+
+  osmscout::TileEncoderRef encoder=std::make_shared<osmscout::PPMTileEncoder>();
+  osmscout::TileSinkRef    sink;
+
+  if (args.output.empty()) {
+    sink=std::make_shared<NullTileSink>();
+  }
+  else {
+    sink=std::make_shared<osmscout::FileTileSink>(args.output,
+                                                  encoder->GetFileExtension());
+  }
+
+  osmscout::MapParameter        drawParameter;
+  osmscout::AreaSearchParameter searchParameter;
+
+  drawParameter.SetFontName(args.fontName);
+  // Fadings make problems with tile approach, we disable it
+  drawParameter.SetDrawFadings(false);
+  // Labels of objects outside of the metatile may reach into it
+  drawParameter.SetDropNotVisiblePointLabels(false);
+
+  searchParameter.SetUseLowZoomOptimization(true);
+  searchParameter.SetUseMultithreading(true);
+
+  // Each metatile references many data tiles
+  mapService->SetCacheSize(std::max(mapService->GetCacheSize(),(size_t)1000));
+
+  osmscout::TileRenderPipeline pipeline(mapService,
+                                        styleConfig,
+                                        drawerFactory,
+                                        encoder,
+                                        sink);
+
+  pipeline.SetMetaTileSize(args.metaTileSize);
+  pipeline.SetTileSize(args.tileSize);
+  pipeline.SetDPI(args.dpi);
+  pipeline.SetThreadCount(args.threads);
+  pipeline.SetEncoderThreadCount(args.encoderThreads);
+  pipeline.SetJournalFilename(args.journal);
+  pipeline.SetMapParameter(drawParameter);
+  pipeline.SetAreaSearchParameter(searchParameter);
+
+  std::vector<osmscout::TileRenderPipeline::LevelStatistics> statistics;
+
+  bool success=pipeline.Render(osmscout::GeoBox(args.topLeft,
+                                                args.bottomRight),
+                               osmscout::MagnificationLevel((uint32_t)args.startZoom),
+                               osmscout::MagnificationLevel((uint32_t)args.endZoom),
+                               statistics);
+
+  std::cout << "Level  Meta   Skip   Tiles Failed   Time[s]  Load[s]  Draw[s] Encode[s]  Tiles/s" << std::endl;
+
+  for (const auto& level : statistics) {
+    std::cout << std::setw(5) << level.level.Get() << " ";
+    std::cout << std::setw(5) << level.metaTileCount << " ";
+    std::cout << std::setw(6) << level.skippedMetaTiles << " ";
+    std::cout << std::setw(7) << level.tileCount << " ";
+    std::cout << std::setw(6) << level.failedTileCount << " ";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(9) << level.seconds << " ";
+    std::cout << std::setw(8) << level.loadSeconds << " ";
+    std::cout << std::setw(8) << level.drawSeconds << " ";
+    std::cout << std::setw(9) << level.encodeSeconds << " ";
+    std::cout << std::setw(8) << std::setprecision(1) << level.GetTilesPerSecond() << std::endl;
+  }
+
+  database->Close();
+
+  return success ? 0 : 1;
+}
@@ -0,0 +1,10 @@
+#ifndef LIBOSMSCOUT_METATILER_PRIVATE_CONFIG_H
+#define LIBOSMSCOUT_METATILER_PRIVATE_CONFIG_H
+
+/* Cairo backend supported */
+#cmakedefine HAVE_LIB_OSMSCOUTMAPCAIRO 1
+
+/* Agg backend supported */
+#cmakedefine HAVE_LIB_OSMSCOUTMAPAGG 1
+
+#endif
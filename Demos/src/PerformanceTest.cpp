@@ -139,6 +139,7 @@ int main(int argc, char* argv[])
   unsigned int  tileWidth;
   unsigned int  tileHeight;
   std::string   driver;
+  size_t        prepareThreads=1;
 
 #if defined(HAVE_LIB_GPERFTOOLS)
   bool          heapProfile;
@@ -152,6 +153,7 @@ int main(int argc, char* argv[])
     std::cerr << "  <start zoom> <end zoom>" << std::endl;
     std::cerr << "  <tile width> <tile height>" << std::endl;
     std::cerr << "  <cairo|Qt|ag|opengl|noop|none>" << std::endl;
+    std::cerr << "  [prepare threads, 0 for all hardware threads]" << std::endl;
 #if defined(HAVE_LIB_GPERFTOOLS)
     std::cerr << "  [heap profile prefix]" << std::endl;
 #endif
@@ -161,9 +163,9 @@ int main(int argc, char* argv[])
 #if defined(HAVE_LIB_GPERFTOOLS)
   heapProfile = false;
 
-  if (argc>12) {
+  if (argc>13) {
       heapProfile = true;
-      heapProfilePrefix = argv[12];
+      heapProfilePrefix = argv[13];
   }
 #endif
 
@@ -212,6 +214,13 @@ int main(int argc, char* argv[])
 
   driver=argv[11];
 
+  if (argc>12) {
+    if (sscanf(argv[12],"%zu",&prepareThreads)!=1) {
+      std::cerr << "prepare threads is not numeric!" << std::endl;
+      return 1;
+    }
+  }
+
 #if defined(HAVE_LIB_OSMSCOUTMAPCAIRO)
   cairo_surface_t * cairoSurface=nullptr;
   cairo_t         *cairo=nullptr;
@@ -347,6 +356,7 @@ int main(int argc, char* argv[])
 
   // TODO: Use some way to find a valid font on the system (Agg display a ton of messages otherwise)
   drawParameter.SetFontName("/usr/share/fonts/TTF/DejaVuSans.ttf");
+  drawParameter.SetPrepareThreadCount(prepareThreads);
   searchParameter.SetUseMultithreading(true);
 
   for (osmscout::MagnificationLevel level=osmscout::MagnificationLevel(std::min(startZoom,endZoom));
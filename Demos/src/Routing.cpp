@@ -27,11 +27,13 @@
 
 #include <osmscout/Database.h>
 #include <osmscout/routing/SimpleRoutingService.h>
+#include <osmscout/routing/CHRoutingService.h>
 #include <osmscout/routing/RoutePostprocessor.h>
 #include <osmscout/routing/DBFileOffset.h>
 
 #include <osmscout/util/CmdLineParsing.h>
 #include <osmscout/util/Geometry.h>
+#include <osmscout/util/StopClock.h>
 
 //#define ROUTE_DEBUG
 //#define NODE_DEBUG
@@ -65,6 +67,11 @@ struct Arguments
   std::string            router=osmscout::RoutingService::DEFAULT_FILENAME_BASE;
   osmscout::Vehicle      vehicle=osmscout::Vehicle::vehicleCar;
   bool                   gpx=false;
+  bool                   ch=false;
+  bool                   bidirectional=false;
+  bool                   noLandmarks=false;
+  bool                   noGraph=false;
+  size_t                 benchmark=0;
   std::string            databaseDirectory;
   osmscout::GeoCoord     start;
   osmscout::GeoCoord     target;
@@ -559,6 +566,144 @@ struct RouteDescriptionGeneratorCallback : public osmscout::RouteDescriptionGene
   }
 };
 
+/**
+ * Calculate the route the given number of times using the A* search, the
+ * bidirectional A* search (both without and - if available - with landmarks),
+ * the A* search on the compact routing graph and the contraction hierarchy (if
+ * available) and compare time and result.
+ */
+static bool RunBenchmark(const osmscout::DatabaseRef& database,
+                         const Arguments& args,
+                         osmscout::RoutingProfile& routingProfile,
+                         const osmscout::RoutePosition& start,
+                         const osmscout::RoutePosition& target)
+{
+  struct Run
+  {
+    std::string                       name;
+    osmscout::SimpleRoutingServiceRef router;
+    osmscout::RoutingParameter        parameter;
+    std::vector<osmscout::Id>         route;
+    double                            time;
+  };
+
+  osmscout::RouterParameter          routerParameter;
+  osmscout::SimpleRoutingServiceRef  aStarRouter=std::make_shared<osmscout::SimpleRoutingService>(database,
+                                                                                                  routerParameter,
+                                                                                                  args.router);
+  osmscout::CHRoutingServiceRef      chRouter=std::make_shared<osmscout::CHRoutingService>(database,
+                                                                                           routerParameter,
+                                                                                           args.router);
+  std::vector<Run>                   runs;
+
+  if (!aStarRouter->Open() ||
+      !chRouter->Open()) {
+    std::cerr << "Cannot open routing database" << std::endl;
+    return false;
+  }
+
+  bool landmarks=aStarRouter->HasLandmarks(routingProfile.GetVehicle());
+
+  if (!landmarks) {
+    std::cerr << "No landmark distances for vehicle, import with '--routerLandmarks <number>'" << std::endl;
+  }
+
+  bool predecessors=aStarRouter->HasRoutePredecessors();
+
+  if (!predecessors) {
+    std::cerr << "No route node predecessors for the bidirectional search, import with '--routerPredecessors true'" << std::endl;
+  }
+
+  bool graph=aStarRouter->HasRouteGraph();
+
+  if (!graph) {
+    std::cerr << "No compact routing graph, import with '--routerGraph true'" << std::endl;
+  }
+
+  for (bool bidirectional : {false,true}) {
+    for (bool useLandmarks : {false,true}) {
+      if ((bidirectional && !predecessors) ||
+          (useLandmarks && !landmarks)) {
+        continue;
+      }
+
+      Run run;
+
+      run.name=std::string(bidirectional ? "Bidirectional A*" : "A*")+(useLandmarks ? " (ALT):" : ":");
+      run.router=aStarRouter;
+      run.parameter.SetBidirectional(bidirectional);
+      run.parameter.SetUseLandmarks(useLandmarks);
+      run.parameter.SetUseRouteGraph(false);
+
+      runs.push_back(run);
+    }
+  }
+
+  for (bool useLandmarks : {false,true}) {
+    if (!graph ||
+        (useLandmarks && !landmarks)) {
+      continue;
+    }
+
+    Run run;
+
+    run.name=std::string("A* graph")+(useLandmarks ? " (ALT):" : ":");
+    run.router=aStarRouter;
+    run.parameter.SetUseLandmarks(useLandmarks);
+
+    runs.push_back(run);
+  }
+
+  if (chRouter->HasContractionHierarchy(routingProfile.GetVehicle())) {
+    Run run;
+
+    run.name="Contraction hier.:";
+    run.router=chRouter;
+
+    runs.push_back(run);
+  }
+  else {
+    std::cerr << "No contraction hierarchy for vehicle, import with '--routerCH true'" << std::endl;
+  }
+
+  for (auto& run : runs) {
+    osmscout::RoutingResult result;
+    osmscout::StopClock     clock;
+
+    for (size_t i=0; i<args.benchmark; i++) {
+      result=run.router->CalculateRoute(routingProfile,
+                                        start,
+                                        target,
+                                        run.parameter);
+    }
+
+    clock.Stop();
+
+    run.time=clock.GetMilliseconds()/args.benchmark;
+
+    for (const auto& entry : result.GetRoute().Entries()) {
+      run.route.push_back(entry.GetCurrentNodeId());
+    }
+  }
+
+  std::cout << "Iterations:          " << args.benchmark << std::endl;
+
+  for (const auto& run : runs) {
+    std::cout << std::left << std::setw(24) << run.name << std::right;
+    std::cout << std::fixed << std::setprecision(3) << run.time << "ms, " << run.route.size() << " route entries";
+    if (&run!=&runs.front()) {
+      std::cout << ", speedup " << std::setprecision(1) << runs.front().time/run.time;
+      std::cout << ", identical route: " << (runs.front().route==run.route ? "true" : "false");
+    }
+    std::cout << std::endl;
+  }
+
+  chRouter->Close();
+  aStarRouter->Close();
+
+  return true;
+}
+
 int main(int argc, char* argv[])
 {
   osmscout::CmdLineParser   argParser("Routing",
@@ -580,6 +725,36 @@ int main(int argc, char* argv[])
                       "Dump resulting route as GPX to std::cout",
                       true);
 
+  argParser.AddOption(osmscout::CmdLineFlag([&args](const bool& value) {
+                        args.ch=value;
+                      }),
+                      "ch",
+                      "Use the contraction hierarchy generated by the import");
+
+  argParser.AddOption(osmscout::CmdLineFlag([&args](const bool& value) {
+                        args.bidirectional=value;
+                      }),
+                      "bidirectional",
+                      "Use the bidirectional A* search");
+
+  argParser.AddOption(osmscout::CmdLineFlag([&args](const bool& value) {
+                        args.noLandmarks=value;
+                      }),
+                      "noLandmarks",
+                      "Do not use the landmark distances generated by the import for the A* estimate");
+
+  argParser.AddOption(osmscout::CmdLineFlag([&args](const bool& value) {
+                        args.noGraph=value;
+                      }),
+                      "noGraph",
+                      "Do not use the compact routing graph generated by the import for the A* search");
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                        args.benchmark=value;
+                      }),
+                      "benchmark",
+                      "Compare A*, bidirectional A*, landmarks, routing graph and contraction hierarchy by calculating the route the given number of times");
+
   argParser.AddOption(osmscout::CmdLineAlternativeFlag([&args](const std::string& value) {
                         if (value=="foot") {
                           args.vehicle=osmscout::Vehicle::vehicleFoot;
@@ -647,9 +822,18 @@ int main(int argc, char* argv[])
     routerParameter.SetDebugPerformance(true);
   }
 
-  osmscout::SimpleRoutingServiceRef router=std::make_shared<osmscout::SimpleRoutingService>(database,
-                                                                                            routerParameter,
-                                                                                            args.router);
+  osmscout::SimpleRoutingServiceRef router;
+
+  if (args.ch) {
+    router=std::make_shared<osmscout::CHRoutingService>(database,
+                                                        routerParameter,
+                                                        args.router);
+  }
+  else {
+    router=std::make_shared<osmscout::SimpleRoutingService>(database,
+                                                            routerParameter,
+                                                            args.router);
+  }
 
   if (!router->Open()) {
     std::cerr << "Cannot open routing database" << std::endl;
@@ -663,6 +847,9 @@ int main(int argc, char* argv[])
   osmscout::RoutingParameter          parameter;
 
   parameter.SetProgress(std::make_shared<ConsoleRoutingProgress>());
+  parameter.SetBidirectional(args.bidirectional);
+  parameter.SetUseLandmarks(!args.noLandmarks);
+  parameter.SetUseRouteGraph(!args.noGraph);
 
   switch (args.vehicle) {
   case osmscout::vehicleFoot:
@@ -707,6 +894,18 @@ int main(int argc, char* argv[])
     std::cerr << "Cannot find start node for target location!" << std::endl;
   }
 
+  if (args.benchmark>0) {
+    bool success=RunBenchmark(database,
+                              args,
+                              *routingProfile,
+                              start,
+                              target);
+
+    router->Close();
+
+    return success ? 0 : 1;
+  }
+
   osmscout::RoutingResult result=router->CalculateRoute(*routingProfile,
                                                         start,
                                                         target,
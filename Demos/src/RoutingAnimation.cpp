@@ -163,7 +163,7 @@ public:
   }
 
   virtual bool WalkToOtherDatabases(const osmscout::RoutingProfile& /*state*/,
-                                    osmscout::RoutingService::RNodeRef &current,
+                                    osmscout::RoutingService::RNode &current,
                                     osmscout::RouteNodeRef &/*currentRouteNode*/,
                                     osmscout::RoutingService::OpenList &openList,
                                     osmscout::RoutingService::OpenMap &/*openMap*/,
@@ -202,51 +202,66 @@ public:
     QPen pen;
     pen.setWidth(5);
 
+    bool success=true;
+
     // draw ways in closedSet
     painter.setBrush(QBrush(red));
     pen.setColor(red);
 
-    for (const auto &closedNode:closedSet){
-      if (!closedNode.currentNode.IsValid() ||
+    closedSet.Visit([&](const VNode &closedNode){
+      if (!success ||
+          !closedNode.currentNode.IsValid() ||
           !closedNode.previousNode.IsValid()){
-        continue;
+        return;
       }
       if (!GetRouteNode(closedNode.currentNode,n1) ||
           !GetRouteNode(closedNode.previousNode,n2)){
-        return false;
+        success=false;
+        return;
       }
 
       projection.GeoToPixel(n1->GetCoord(),x1,y1);
       projection.GeoToPixel(n2->GetCoord(),x2,y2);
       painter.setPen(pen);
       painter.drawLine(x1,y1,x2,y2);
+    });
+
+    if (!success){
+      return false;
     }
 
     // closed, restricted
     painter.setBrush(QBrush(grey));
     pen.setColor(grey);
 
-    for (const auto &closedNode:closedRestrictedSet){
-      if (!closedNode.currentNode.IsValid() ||
+    closedRestrictedSet.Visit([&](const VNode &closedNode){
+      if (!success ||
+          !closedNode.currentNode.IsValid() ||
           !closedNode.previousNode.IsValid()){
-        continue;
+        return;
       }
       if (!GetRouteNode(closedNode.currentNode,n1) ||
           !GetRouteNode(closedNode.previousNode,n2)){
-        return false;
+        success=false;
+        return;
       }
 
       projection.GeoToPixel(n1->GetCoord(),x1,y1);
       projection.GeoToPixel(n2->GetCoord(),x2,y2);
       painter.setPen(pen);
       painter.drawLine(x1,y1,x2,y2);
+    });
+
+    if (!success){
+      return false;
     }
 
     // draw nodes in open list
     pen.setColor(yellow);
     painter.setBrush(QBrush(yellow));
 
-    for (const auto &open:openList){
+    for (const auto &entry:openList){
+      const RNode* open=entry.node;
       drawDot(painter,projection,open->node->GetCoord());
       if (open->prev.IsValid()){
         if (!GetRouteNode(open->prev,n1)){
@@ -262,13 +277,13 @@ public:
     // draw current node
     pen.setColor(green);
     painter.setBrush(green);
-    drawDot(painter,projection,current->node->GetCoord());
-    if (current->prev.IsValid()){
-      if (!GetRouteNode(current->prev,n1)){
+    drawDot(painter,projection,current.node->GetCoord());
+    if (current.prev.IsValid()){
+      if (!GetRouteNode(current.prev,n1)){
         return false;
       }
       projection.GeoToPixel(n1->GetCoord(),x1,y1);
-      projection.GeoToPixel(current->node->GetCoord(),x2,y2);
+      projection.GeoToPixel(current.node->GetCoord(),x2,y2);
       painter.setPen(pen);
       painter.drawLine(x1,y1,x2,y2);
     }
@@ -0,0 +1,392 @@
+/*
+  RoutingMatrix - a demo program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <list>
+
+#include <osmscout/Database.h>
+#include <osmscout/routing/SimpleRoutingService.h>
+#include <osmscout/routing/RoutePostprocessor.h>
+
+#include <osmscout/util/CmdLineParsing.h>
+#include <osmscout/util/StopClock.h>
+
+/*
+ * Calculates the routing matrix between a number of sources and targets placed on
+ * a regular grid within the bounding box defined by the two given coordinates, for
+ * example:
+ *
+ *   RoutingMatrix --sources 50 --targets 50 ../maps/nordrhein-westfalen 51.4 7.3 51.6 7.6
+ *
+ * With --compare every entry is additionally calculated by a single route.
+ */
+
+struct Arguments
+{
+  bool                   help=false;
+  std::string            router=osmscout::RoutingService::DEFAULT_FILENAME_BASE;
+  osmscout::Vehicle      vehicle=osmscout::Vehicle::vehicleCar;
+  size_t                 sources=10;
+  size_t                 targets=10;
+  size_t                 threads=0;
+  bool                   compare=false;
+  std::string            databaseDirectory;
+  osmscout::GeoCoord     min;
+  osmscout::GeoCoord     max;
+};
+
+static void GetCarSpeedTable(std::map<std::string,double>& map)
+{
+  map["highway_motorway"]=110.0;
+  map["highway_motorway_trunk"]=100.0;
+  map["highway_motorway_primary"]=70.0;
+  map["highway_motorway_link"]=60.0;
+  map["highway_motorway_junction"]=60.0;
+  map["highway_trunk"]=100.0;
+  map["highway_trunk_link"]=60.0;
+  map["highway_primary"]=70.0;
+  map["highway_primary_link"]=60.0;
+  map["highway_secondary"]=60.0;
+  map["highway_secondary_link"]=50.0;
+  map["highway_tertiary_link"]=55.0;
+  map["highway_tertiary"]=55.0;
+  map["highway_unclassified"]=50.0;
+  map["highway_road"]=50.0;
+  map["highway_residential"]=40.0;
+  map["highway_roundabout"]=40.0;
+  map["highway_living_street"]=10.0;
+  map["highway_service"]=30.0;
+}
+
+/**
+ * Place the given number of positions on a regular grid within the bounding box
+ */
+static bool GetPositions(osmscout::SimpleRoutingService& router,
+                         const osmscout::RoutingProfile& profile,
+                         const osmscout::GeoCoord& min,
+                         const osmscout::GeoCoord& max,
+                         size_t count,
+                         std::vector<osmscout::RoutePosition>& positions)
+{
+  size_t columns=(size_t)std::ceil(std::sqrt((double)count));
+  size_t rows=(count+columns-1)/columns;
+
+  for (size_t i=0; i<count; i++) {
+    size_t             column=i%columns;
+    size_t             row=i/columns;
+    osmscout::GeoCoord coord(min.GetLat()+(max.GetLat()-min.GetLat())*(row+0.5)/rows,
+                             min.GetLon()+(max.GetLon()-min.GetLon())*(column+0.5)/columns);
+
+    osmscout::RoutePosition position=router.GetClosestRoutableNode(coord,
+                                                                   profile,
+                                                                   osmscout::Distance::Of<osmscout::Kilometer>(1));
+
+    if (!position.IsValid()) {
+      std::cerr << "Cannot find routing node near " << coord.GetDisplayText() << std::endl;
+      return false;
+    }
+
+    positions.push_back(position);
+  }
+
+  return true;
+}
+
+/**
+ * Calculate each entry of the matrix by a single route and compare length and time
+ */
+static void CompareWithRoutes(osmscout::SimpleRoutingService& router,
+                              const osmscout::DatabaseRef& database,
+                              const osmscout::RoutingProfileRef& profile,
+                              const std::vector<osmscout::RoutePosition>& sources,
+                              const std::vector<osmscout::RoutePosition>& targets,
+                              const osmscout::RoutingMatrix& matrix)
+{
+  osmscout::RoutingParameter                                parameter;
+  osmscout::RoutePostprocessor                              postprocessor;
+  std::list<osmscout::RoutePostprocessor::PostprocessorRef> postprocessors={
+    std::make_shared<osmscout::RoutePostprocessor::DistanceAndTimePostprocessor>()
+  };
+  std::vector<osmscout::RoutingProfileRef>                  profiles={profile};
+  std::vector<osmscout::DatabaseRef>                        databases={database};
+  size_t                                                    mismatches=0;
+  double                                                    maxDistanceDiff=0.0;
+  double                                                    maxTimeDiff=0.0;
+  osmscout::StopClock                                       clock;
+
+  for (size_t source=0; source<sources.size(); source++) {
+    for (size_t target=0; target<targets.size(); target++) {
+      const osmscout::RoutingMatrix::Entry& entry=matrix.Get(source,target);
+      osmscout::RoutingResult               result=router.CalculateRoute(*profile,
+                                                                         sources[source],
+                                                                         targets[target],
+                                                                         parameter);
+
+      if (result.Success()!=entry.found) {
+        mismatches++;
+        continue;
+      }
+
+      if (!result.Success()) {
+        continue;
+      }
+
+      osmscout::RouteDescription description;
+
+      router.TransformRouteDataToRouteDescription(result.GetRoute(),
+                                                  description);
+      postprocessor.PostprocessRouteDescription(description,
+                                                profiles,
+                                                databases,
+                                                postprocessors);
+
+      if (description.Nodes().empty()) {
+        continue;
+      }
+
+      const osmscout::RouteDescription::Node& last=description.Nodes().back();
+
+      if (last.GetDistance().AsMeter()>0.0) {
+        maxDistanceDiff=std::max(maxDistanceDiff,
+                                 std::abs(last.GetDistance().AsMeter()-entry.distance.AsMeter())/last.GetDistance().AsMeter());
+      }
+
+      if (last.GetTime()>0.0) {
+        maxTimeDiff=std::max(maxTimeDiff,
+                             std::abs(last.GetTime()-entry.time)/last.GetTime());
+      }
+    }
+  }
+
+  clock.Stop();
+
+  std::cout << "Single routes:       " << clock.GetMilliseconds() << "ms" << std::endl;
+  std::cout << "Found mismatches:    " << mismatches << std::endl;
+  std::cout << "Max. distance diff:  " << std::fixed << std::setprecision(1) << maxDistanceDiff*100.0 << "%" << std::endl;
+  std::cout << "Max. time diff:      " << std::fixed << std::setprecision(1) << maxTimeDiff*100.0 << "%" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  osmscout::CmdLineParser   argParser("RoutingMatrix",
+                                      argc,argv);
+  std::vector<std::string>  helpArgs{"h","help"};
+  Arguments                 args;
+
+  argParser.AddOption(osmscout::CmdLineFlag([&args](const bool& value) {
+                        args.help=value;
+                      }),
+                      helpArgs,
+                      "Return argument help",
+                      true);
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                        args.sources=value;
+                      }),
+                      "sources",
+                      "Number of sources");
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                        args.targets=value;
+                      }),
+                      "targets",
+                      "Number of targets");
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&args](size_t value) {
+                        args.threads=value;
+                      }),
+                      "threads",
+                      "Number of threads, 0 for the number of hardware threads");
+
+  argParser.AddOption(osmscout::CmdLineFlag([&args](const bool& value) {
+                        args.compare=value;
+                      }),
+                      "compare",
+                      "Compare the matrix with single routes between all sources and targets");
+
+  argParser.AddOption(osmscout::CmdLineAlternativeFlag([&args](const std::string& value) {
+                        if (value=="foot") {
+                          args.vehicle=osmscout::Vehicle::vehicleFoot;
+                        }
+                        else if (value=="bicycle") {
+                          args.vehicle=osmscout::Vehicle::vehicleBicycle;
+                        }
+                        else if (value=="car") {
+                          args.vehicle=osmscout::Vehicle::vehicleCar;
+                        }
+                      }),
+                      {"foot","bicycle","car"},
+                      "Vehicle type to use for routing");
+
+  argParser.AddOption(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                        args.router=value;
+                      }),
+                      "router",
+                      "Router filename base");
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&args](const std::string& value) {
+                            args.databaseDirectory=value;
+                          }),
+                          "DATABASE",
+                          "Directory of the database to use");
+
+  argParser.AddPositional(osmscout::CmdLineGeoCoordOption([&args](const osmscout::GeoCoord& value) {
+                            args.min=value;
+                          }),
+                          "MIN",
+                          "Minimum coordinate of the bounding box");
+
+  argParser.AddPositional(osmscout::CmdLineGeoCoordOption([&args](const osmscout::GeoCoord& value) {
+                            args.max=value;
+                          }),
+                          "MAX",
+                          "Maximum coordinate of the bounding box");
+
+  osmscout::CmdLineParseResult cmdLineParseResult=argParser.Parse();
+
+  if (cmdLineParseResult.HasError()) {
+    std::cerr << "ERROR: " << cmdLineParseResult.GetErrorDescription() << std::endl;
+    std::cout << argParser.GetHelp() << std::endl;
+    return 1;
+  }
+
+  if (args.help) {
+    std::cout << argParser.GetHelp() << std::endl;
+    return 0;
+  }
+
+  osmscout::DatabaseParameter databaseParameter;
+  osmscout::DatabaseRef       database=std::make_shared<osmscout::Database>(databaseParameter);
+
+  if (!database->Open(args.databaseDirectory)) {
+    std::cerr << "Cannot open database" << std::endl;
+
+    return 1;
+  }
+
+  osmscout::FastestPathRoutingProfileRef routingProfile=std::make_shared<osmscout::FastestPathRoutingProfile>(database->GetTypeConfig());
+  osmscout::RouterParameter              routerParameter;
+  osmscout::SimpleRoutingServiceRef      router=std::make_shared<osmscout::SimpleRoutingService>(database,
+                                                                                                 routerParameter,
+                                                                                                 args.router);
+
+  if (!router->Open()) {
+    std::cerr << "Cannot open routing database" << std::endl;
+
+    return 1;
+  }
+
+  osmscout::TypeConfigRef      typeConfig=database->GetTypeConfig();
+  std::map<std::string,double> carSpeedTable;
+
+  switch (args.vehicle) {
+  case osmscout::vehicleFoot:
+    routingProfile->ParametrizeForFoot(*typeConfig,
+                                       5.0);
+    break;
+  case osmscout::vehicleBicycle:
+    routingProfile->ParametrizeForBicycle(*typeConfig,
+                                          20.0);
+    break;
+  case osmscout::vehicleCar:
+    GetCarSpeedTable(carSpeedTable);
+    routingProfile->ParametrizeForCar(*typeConfig,
+                                      carSpeedTable,
+                                      160.0);
+    break;
+  }
+
+  std::vector<osmscout::RoutePosition> sources;
+  std::vector<osmscout::RoutePosition> targets;
+
+  if (!GetPositions(*router,
+                    *routingProfile,
+                    args.min,
+                    args.max,
+                    args.sources,
+                    sources) ||
+      !GetPositions(*router,
+                    *routingProfile,
+                    args.max,
+                    args.min,
+                    args.targets,
+                    targets)) {
+    router->Close();
+    return 1;
+  }
+
+  osmscout::RoutingParameter parameter;
+  osmscout::StopClock        clock;
+
+  parameter.SetThreadCount(args.threads);
+
+  osmscout::RoutingMatrix matrix=router->CalculateMatrix(*routingProfile,
+                                                         sources,
+                                                         targets,
+                                                         parameter);
+
+  clock.Stop();
+
+  size_t found=0;
+
+  for (size_t source=0; source<matrix.GetSourceCount(); source++) {
+    for (size_t target=0; target<matrix.GetTargetCount(); target++) {
+      if (matrix.HasRoute(source,target)) {
+        found++;
+      }
+    }
+  }
+
+  std::cout << "Matrix:              " << sources.size() << "x" << targets.size() << std::endl;
+  std::cout << "Routes found:        " << found << std::endl;
+  std::cout << "Matrix calculation:  " << clock.GetMilliseconds() << "ms" << std::endl;
+
+  if (sources.size()<=10 &&
+      targets.size()<=10) {
+    for (size_t source=0; source<matrix.GetSourceCount(); source++) {
+      for (size_t target=0; target<matrix.GetTargetCount(); target++) {
+        const osmscout::RoutingMatrix::Entry& entry=matrix.Get(source,target);
+
+        if (entry.found) {
+          std::cout << std::setw(8) << std::fixed << std::setprecision(1) << entry.distance.As<osmscout::Kilometer>() << "km";
+          std::cout << std::setw(6) << std::fixed << std::setprecision(0) << entry.time*60.0 << "min";
+        }
+        else {
+          std::cout << std::setw(15) << "-";
+        }
+      }
+      std::cout << std::endl;
+    }
+  }
+
+  if (args.compare) {
+    CompareWithRoutes(*router,
+                      database,
+                      routingProfile,
+                      sources,
+                      targets,
+                      matrix);
+  }
+
+  router->Close();
+
+  return 0;
+}
@@ -362,7 +362,7 @@ static void DumpRouteNode(const osmscout::RouteNode& routeNode)
     std::cout << std::endl;
     std::cout << "  exclude {" << std::endl;
     std::cout << "    from: " << exclude.source.GetName() << std::endl;
-    std::cout << "    to: " << routeNode.objects[exclude.targetIndex].object.GetName() << std::endl;
+    std::cout << "    to: " << routeNode.objects[routeNode.paths[exclude.targetIndex].objectIndex].object.GetName() << std::endl;
     std::cout << "  }" << std::endl;
   }
 
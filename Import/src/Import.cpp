@@ -21,6 +21,7 @@
 #include <cstdio>
 
 #include <iostream>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -28,6 +29,7 @@
 
 #include <osmscout/util/CmdLineParsing.h>
 #include <osmscout/util/File.h>
+#include <osmscout/util/String.h>
 
 #include <osmscout/import/Import.h>
 
@@ -73,6 +75,12 @@ void DumpHelp(osmscout::ImportParameter& parameter)
   std::cout << std::endl;
 
   std::cout << " --router <router description>        definition of a router (default: car,bicycle,foot:router)" << std::endl;
+  std::cout << " --routerCH true|false                generate contraction hierarchies for the router (default: " << osmscout::BoolToString(parameter.GetRouterCH()) << ")" << std::endl;
+  std::cout << " --routerCarSpeed <type>=<km/h>        speed of the type for the car profile of contraction hierarchies and landmarks" << std::endl;
+  std::cout << " --routerLandmarks <number>           number of landmarks for the ALT heuristic of the router, 0 to disable (default: " << parameter.GetRouterLandmarks() << ")" << std::endl;
+  std::cout << " --routerGraph true|false             generate the compact routing graph for the router (default: " << osmscout::BoolToString(parameter.GetRouterGraph()) << ")" << std::endl;
+  std::cout << " --routerPredecessors true|false      generate the predecessors of the route nodes for the bidirectional search (default: " << osmscout::BoolToString(parameter.GetRouterPredecessors()) << ")" << std::endl;
+  std::cout << " --routerSegmentIndex true|false      generate the spatial index of the routable segments for the router (default: " << osmscout::BoolToString(parameter.GetRouterSegmentIndex()) << ")" << std::endl;
   std::cout << std::endl;
 
   std::cout << " --strictAreas true|false             assure that areas are simple (default: " << osmscout::BoolToString(parameter.GetStrictAreas()) << ")" << std::endl;
@@ -104,6 +112,9 @@ void DumpHelp(osmscout::ImportParameter& parameter)
   std::cout << " --wayDataMemoryMaped true|false      memory maped way data file access (default: " << osmscout::BoolToString(parameter.GetWayDataMemoryMaped()) << ")" << std::endl;
   std::cout << " --wayDataCacheSize <number>          way data cache size (default: " << parameter.GetWayDataCacheSize() << ")" << std::endl;
 
+  std::cout << " --compressData true|false            block compress way and area data files (default: " << osmscout::BoolToString(parameter.GetCompressData()) << ")" << std::endl;
+  std::cout << " --compressedBlockSize <number>       nominal size of a compressed data block in bytes (default: " << parameter.GetCompressedBlockSize() << ")" << std::endl;
+
   std::cout << " --routeNodeBlockSize <number>        number of route nodes resolved in block (default: " << parameter.GetRouteNodeBlockSize() << ")" << std::endl;
   std::cout << std::endl;
   std::cout << " --langOrder <#|lang1[,#|lang2]..>    language order when parsing lang[:language] and place_name[:language] tags" << std::endl
@@ -224,6 +235,37 @@ std::vector<std::string> ParseLangOrderArgument(int argc,
     return langVec;
 }
 
+/**
+ * Speed table for the car profile of the generated routing data, identical to the
+ * default of the routing demos
+ */
+static std::map<std::string,double> GetDefaultCarSpeedTable()
+{
+  std::map<std::string,double> map;
+
+  map["highway_motorway"]=110.0;
+  map["highway_motorway_trunk"]=100.0;
+  map["highway_motorway_primary"]=70.0;
+  map["highway_motorway_link"]=60.0;
+  map["highway_motorway_junction"]=60.0;
+  map["highway_trunk"]=100.0;
+  map["highway_trunk_link"]=60.0;
+  map["highway_primary"]=70.0;
+  map["highway_primary_link"]=60.0;
+  map["highway_secondary"]=60.0;
+  map["highway_secondary_link"]=50.0;
+  map["highway_tertiary_link"]=55.0;
+  map["highway_tertiary"]=55.0;
+  map["highway_unclassified"]=50.0;
+  map["highway_road"]=50.0;
+  map["highway_residential"]=40.0;
+  map["highway_roundabout"]=40.0;
+  map["highway_living_street"]=10.0;
+  map["highway_service"]=30.0;
+
+  return map;
+}
+
 static void InitializeLocale(osmscout::Progress& progress)
 {
   try {
@@ -256,6 +298,25 @@ static void DumpParameter(const osmscout::ImportParameter& parameter,
     progress.Info(std::string("Router: ")+VehcileMaskToString(router.GetVehicleMask())+ " - '"+router.GetFilenamebase()+"'");
   }
 
+  progress.Info(std::string("RouterCH: ")+
+                (parameter.GetRouterCH() ? "true" : "false"));
+
+  for (const auto& speed : parameter.GetRouterCarSpeedTable()) {
+    progress.Info(std::string("RouterCarSpeed: ")+speed.first+"="+std::to_string(speed.second));
+  }
+
+  progress.Info(std::string("RouterLandmarks: ")+
+                std::to_string(parameter.GetRouterLandmarks()));
+
+  progress.Info(std::string("RouterGraph: ")+
+                (parameter.GetRouterGraph() ? "true" : "false"));
+
+  progress.Info(std::string("RouterPredecessors: ")+
+                (parameter.GetRouterPredecessors() ? "true" : "false"));
+
+  progress.Info(std::string("RouterSegmentIndex: ")+
+                (parameter.GetRouterSegmentIndex() ? "true" : "false"));
+
   progress.Info(std::string("StrictAreas: ")+
                 (parameter.GetStrictAreas() ? "true" : "false"));
 
@@ -303,6 +364,11 @@ static void DumpParameter(const osmscout::ImportParameter& parameter,
   progress.Info(std::string("WayDataCacheSize: ")+
                 std::to_string(parameter.GetWayDataCacheSize()));
 
+  progress.Info(std::string("CompressData: ")+
+                (parameter.GetCompressData() ? "true" : "false"));
+  progress.Info(std::string("CompressedBlockSize: ")+
+                std::to_string(parameter.GetCompressedBlockSize()));
+
   progress.Info(std::string("RouteNodeBlockSize: ")+
                 std::to_string(parameter.GetRouteNodeBlockSize()));
 
@@ -398,6 +464,7 @@ int main(int argc, char* argv[])
 
   parameter.AddRouter(osmscout::ImportParameter::Router(defaultVehicleMask,
                                                         "router"));
+  parameter.SetRouterCarSpeedTable(GetDefaultCarSpeedTable());
 
   // Simple way to analyze command line parameters, but enough for now...
   int i=1;
@@ -512,6 +579,98 @@ int main(int argc, char* argv[])
       }
 
     }
+    else if (strcmp(argv[i],"--routerCH")==0) {
+      bool routerCH;
+
+      if (osmscout::ParseBoolArgument(argc,
+                                      argv,
+                                      i,
+                                      routerCH)) {
+        parameter.SetRouterCH(routerCH);
+      }
+      else {
+        parameterError=true;
+      }
+    }
+    else if (strcmp(argv[i],"--routerCarSpeed")==0) {
+      std::string argument;
+
+      if (osmscout::ParseStringArgument(argc,
+                                        argv,
+                                        i,
+                                        argument)) {
+        std::map<std::string,double> speedTable=parameter.GetRouterCarSpeedTable();
+        size_t                       pos=argument.find('=');
+        double                       speed;
+
+        if (pos!=std::string::npos &&
+            osmscout::StringToNumber(argument.substr(pos+1).c_str(),
+                                     speed) &&
+            speed>0.0) {
+          speedTable[argument.substr(0,pos)]=speed;
+          parameter.SetRouterCarSpeedTable(speedTable);
+        }
+        else {
+          std::cerr << "Cannot parse car speed '" << argument << "'" << std::endl;
+          parameterError=true;
+        }
+      }
+      else {
+        parameterError=true;
+      }
+    }
+    else if (strcmp(argv[i],"--routerLandmarks")==0) {
+      size_t routerLandmarks;
+
+      if (osmscout::ParseSizeTArgument(argc,
+                                       argv,
+                                       i,
+                                       routerLandmarks)) {
+        parameter.SetRouterLandmarks(routerLandmarks);
+      }
+      else {
+        parameterError=true;
+      }
+    }
+    else if (strcmp(argv[i],"--routerGraph")==0) {
+      bool routerGraph;
+
+      if (osmscout::ParseBoolArgument(argc,
+                                      argv,
+                                      i,
+                                      routerGraph)) {
+        parameter.SetRouterGraph(routerGraph);
+      }
+      else {
+        parameterError=true;
+      }
+    }
+    else if (strcmp(argv[i],"--routerPredecessors")==0) {
+      bool routerPredecessors;
+
+      if (osmscout::ParseBoolArgument(argc,
+                                      argv,
+                                      i,
+                                      routerPredecessors)) {
+        parameter.SetRouterPredecessors(routerPredecessors);
+      }
+      else {
+        parameterError=true;
+      }
+    }
+    else if (strcmp(argv[i],"--routerSegmentIndex")==0) {
+      bool routerSegmentIndex;
+
+      if (osmscout::ParseBoolArgument(argc,
+                                      argv,
+                                      i,
+                                      routerSegmentIndex)) {
+        parameter.SetRouterSegmentIndex(routerSegmentIndex);
+      }
+      else {
+        parameterError=true;
+      }
+    }
     else if (strcmp(argv[i],"--strictAreas")==0) {
       bool strictAreas;
 
@@ -738,6 +897,32 @@ int main(int argc, char* argv[])
         parameterError=true;
       }
     }
+    else if (strcmp(argv[i],"--compressData")==0) {
+      bool compressData;
+
+      if (osmscout::ParseBoolArgument(argc,
+                                      argv,
+                                      i,
+                                      compressData)) {
+        parameter.SetCompressData(compressData);
+      }
+      else {
+        parameterError=true;
+      }
+    }
+    else if (strcmp(argv[i],"--compressedBlockSize")==0) {
+      size_t compressedBlockSize;
+
+      if (osmscout::ParseSizeTArgument(argc,
+                                       argv,
+                                       i,
+                                       compressedBlockSize)) {
+        parameter.SetCompressedBlockSize(compressedBlockSize);
+      }
+      else {
+        parameterError=true;
+      }
+    }
     else if (strcmp(argv[i],"--routeNodeBlockSize")==0) {
       size_t routeNodeBlockSize;
 
@@ -0,0 +1,298 @@
+/*
+  GridDatabase - a test helper for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef GRID_DATABASE_H
+#define GRID_DATABASE_H
+
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <osmscout/GeoCoord.h>
+#include <osmscout/TypeConfig.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/GeoBox.h>
+#include <osmscout/util/Progress.h>
+
+#include <osmscout/import/Import.h>
+#include <osmscout/import/Preprocessor.h>
+
+/**
+ * Synthetic database for tests: a square grid of streets, imported into the
+ * current directory. Each row and each column of nodes is connected by one way.
+ *
+ * By default all streets are residential streets. Derived classes can change the tags
+ * of the streets and add further ways.
+ */
+class GridDatabase
+{
+private:
+  class GridPreprocessor : public osmscout::Preprocessor
+  {
+  private:
+    const GridDatabase&             grid;
+    osmscout::PreprocessorCallback& callback;
+
+  public:
+    GridPreprocessor(const GridDatabase& grid,
+                     osmscout::PreprocessorCallback& callback)
+    : grid(grid),
+      callback(callback)
+    {
+      // no code
+    }
+
+    bool Import(const osmscout::TypeConfigRef& typeConfig,
+                const osmscout::ImportParameter& /*parameter*/,
+                osmscout::Progress& /*progress*/,
+                const std::string& /*filename*/) override
+    {
+      osmscout::PreprocessorCallback::RawBlockDataRef data=std::make_shared<osmscout::PreprocessorCallback::RawBlockData>();
+
+      grid.Generate(*typeConfig,
+                    *data);
+
+      callback.ProcessBlock(std::move(data));
+
+      return true;
+    }
+  };
+
+  class GridPreprocessorFactory : public osmscout::PreprocessorFactory
+  {
+  private:
+    const GridDatabase& grid;
+
+  public:
+    explicit GridPreprocessorFactory(const GridDatabase& grid)
+    : grid(grid)
+    {
+      // no code
+    }
+
+    std::unique_ptr<osmscout::Preprocessor> GetProcessor(const std::string& /*filename*/,
+                                                         osmscout::PreprocessorCallback& callback) const override
+    {
+      return std::unique_ptr<osmscout::Preprocessor>(new GridPreprocessor(grid,callback));
+    }
+  };
+
+public:
+  const size_t size;    //!< Number of nodes in each direction
+  const double spacing; //!< Distance of the nodes in degrees
+  const double lat;     //!< Latitude of the first row
+  const double lon;     //!< Longitude of the first column
+
+public:
+  GridDatabase(size_t size,
+               double spacing,
+               double lat=51.0,
+               double lon=7.0)
+  : size(size),
+    spacing(spacing),
+    lat(lat),
+    lon(lon)
+  {
+    // no code
+  }
+
+  virtual ~GridDatabase() = default;
+
+  osmscout::OSMId GetNodeId(size_t row,
+                            size_t column) const
+  {
+    return row*size+column+1;
+  }
+
+  /**
+   * Return the coordinate of the given (possibly fractional) row and column
+   */
+  osmscout::GeoCoord GetCoord(double row,
+                              double column) const
+  {
+    return osmscout::GeoCoord(lat+row*spacing,
+                              lon+column*spacing);
+  }
+
+  /**
+   * Return deterministic pseudo random coordinates within the cells of the grid
+   */
+  std::vector<osmscout::GeoCoord> GetRandomCoords(size_t count,
+                                                  size_t seed) const
+  {
+    std::vector<osmscout::GeoCoord> coords;
+    size_t                          value=seed;
+
+    for (size_t i=0; i<count; i++) {
+      value=(value*1103515245+12345)%2147483648;
+      size_t row=value%(size-1);
+      value=(value*1103515245+12345)%2147483648;
+      size_t column=value%(size-1);
+
+      coords.push_back(GetCoord(row+0.3,column+0.6));
+    }
+
+    return coords;
+  }
+
+  osmscout::GeoBox GetBoundingBox() const
+  {
+    return osmscout::GeoBox(GetCoord(0,0),
+                            GetCoord(size-1,size-1));
+  }
+
+  /**
+   * Set the tags of the horizontal (row) or vertical (column) street with the given index
+   */
+  virtual void SetStreetTags(const osmscout::TypeConfig& typeConfig,
+                             size_t /*street*/,
+                             bool /*horizontal*/,
+                             osmscout::TagMap& tags) const
+  {
+    tags[typeConfig.GetTagId("highway")]="residential";
+  }
+
+  /**
+   * Add further ways, starting with the given way id
+   */
+  virtual void AddWays(const osmscout::TypeConfig& /*typeConfig*/,
+                       osmscout::OSMId /*wayId*/,
+                       std::vector<osmscout::PreprocessorCallback::RawWayData>& /*ways*/) const
+  {
+    // no code
+  }
+
+  void Generate(const osmscout::TypeConfig& typeConfig,
+                osmscout::PreprocessorCallback::RawBlockData& data) const
+  {
+    for (size_t row=0; row<size; row++) {
+      for (size_t column=0; column<size; column++) {
+        data.nodeData.emplace_back(GetNodeId(row,column),
+                                   GetCoord(row,column));
+      }
+    }
+
+    osmscout::OSMId wayId=1;
+
+    for (size_t street=0; street<size; street++) {
+      for (bool horizontal : {true,false}) {
+        osmscout::PreprocessorCallback::RawWayData wayData;
+
+        wayData.id=wayId++;
+        SetStreetTags(typeConfig,
+                      street,
+                      horizontal,
+                      wayData.tags);
+
+        for (size_t i=0; i<size; i++) {
+          wayData.nodes.push_back(horizontal ? GetNodeId(street,i) : GetNodeId(i,street));
+        }
+
+        data.wayData.push_back(std::move(wayData));
+      }
+    }
+
+    AddWays(typeConfig,
+            wayId,
+            data.wayData);
+  }
+
+  /**
+   * Import the grid into the current directory. Routers and other options have to be set
+   * by the caller in advance.
+   *
+   * Returns 0 on success, else the exit code of the test program.
+   */
+  int Import(osmscout::ImportParameter& importParameter) const
+  {
+    osmscout::SilentProgress progress;
+    std::list<std::string>   mapfiles;
+
+    char* testsTopDirEnv=getenv("TESTS_TOP_DIR");
+
+    if (testsTopDirEnv==nullptr) {
+      std::cerr << "Expected environment variable 'TESTS_TOP_DIR' not set" << std::endl;
+      // CMake-based tests would fail, if we do not exit here
+      return 1;
+    }
+
+    std::string testsTopDir=testsTopDirEnv;
+
+    if (testsTopDir.empty()) {
+      std::cerr << "Environment variable 'TESTS_TOP_DIR' is empty" << std::endl;
+      return 77;
+    }
+
+    // The grid is generated by GridPreprocessor, the file does not exist
+    mapfiles.emplace_back("grid.test");
+
+    importParameter.SetTypefile(osmscout::AppendFileToDir(testsTopDir,"../stylesheets/map.ost"));
+    importParameter.SetMapfiles(mapfiles);
+    importParameter.SetDestinationDirectory(".");
+    importParameter.SetPreprocessorFactory(std::make_shared<GridPreprocessorFactory>(*this));
+
+    try {
+      osmscout::Importer importer(importParameter);
+
+      if (!importer.Import(progress)) {
+        std::cerr << "Import failed!" << std::endl;
+        return 1;
+      }
+    }
+    catch (osmscout::IOException& e) {
+      std::cerr << "Import failed: " << e.GetDescription() << std::endl;
+      return 1;
+    }
+
+    return 0;
+  }
+};
+
+/**
+ * A grid of streets, every fifth street is a primary street and
+ * every third street is a oneway, so that the routes are not trivial
+ */
+class MixedGridDatabase : public GridDatabase
+{
+public:
+  MixedGridDatabase(size_t size,
+                    double spacing)
+  : GridDatabase(size,spacing)
+  {
+    // no code
+  }
+
+  void SetStreetTags(const osmscout::TypeConfig& typeConfig,
+                     size_t street,
+                     bool horizontal,
+                     osmscout::TagMap& tags) const override
+  {
+    tags[typeConfig.GetTagId("highway")]=street%5==0 ? "primary" : "residential";
+
+    if (street%3==1) {
+      tags[typeConfig.GetTagId("oneway")]=horizontal==(street%2==0) ? "yes" : "-1";
+    }
+  }
+};
+
+#endif
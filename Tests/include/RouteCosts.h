@@ -0,0 +1,86 @@
+/*
+  RouteCosts - a test helper for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef ROUTE_COSTS_H
+#define ROUTE_COSTS_H
+
+#include <osmscout/Database.h>
+
+#include <osmscout/routing/RouteData.h>
+#include <osmscout/routing/RoutingProfile.h>
+
+#include <osmscout/util/Geometry.h>
+
+/**
+ * Relative tolerance for comparing costs returned by GetRouteCosts(). The routing
+ * data stores the length of paths rounded to centimeters, so the router may choose
+ * between routes that only differ by less than that (for example parallel streets
+ * in a grid), while GetRouteCosts() uses the exact geometry.
+ */
+static const double ROUTE_COSTS_EPSILON=0.0001;
+
+/**
+ * Return the costs of the route as defined by the profile, summed up over the
+ * ways the route follows, or a negative value, if a way of the route cannot
+ * be loaded.
+ *
+ * Routes of different search algorithms can be compared by their costs, even
+ * if they differ in the choice between routes with the same costs. The
+ * DistanceAndTimePostprocessor cannot be used for this, since it does not
+ * count the last path of the route.
+ */
+inline double GetRouteCosts(const osmscout::DatabaseRef& database,
+                            const osmscout::RoutingProfile& profile,
+                            const osmscout::RouteData& route)
+{
+  double costs=0.0;
+
+  for (const auto& entry : route.Entries()) {
+    if (!entry.GetPathObject().Valid()) {
+      continue;
+    }
+
+    osmscout::WayRef way;
+
+    if (entry.GetPathObject().GetType()!=osmscout::refWay ||
+        !database->GetWayByOffset(entry.GetPathObject().GetFileOffset(),
+                                  way)) {
+      return -1.0;
+    }
+
+    size_t             from=entry.GetCurrentNodeIndex();
+    size_t             to=entry.GetTargetNodeIndex();
+    osmscout::Distance distance;
+
+    while (from!=to) {
+      size_t next=from<to ? from+1 : from-1;
+
+      distance+=osmscout::GetSphericalDistance(way->GetCoord(from),
+                                               way->GetCoord(next));
+      from=next;
+    }
+
+    costs+=profile.GetCosts(*way,
+                            distance);
+  }
+
+  return costs;
+}
+
+#endif
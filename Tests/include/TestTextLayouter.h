@@ -0,0 +1,106 @@
+/*
+  TestTextLayouter - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef TEST_TEXT_LAYOUTER_H
+#define TEST_TEXT_LAYOUTER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <osmscout/LabelLayouter.h>
+
+/**
+ * Text layouter with fixed glyph metrics for testing the LabelLayouter without
+ * a font backend. Every character is a glyph of GLYPH_WIDTH x GLYPH_HEIGHT
+ * pixels (scaled by the font size), labels are never wrapped.
+ */
+struct TestGlyph
+{
+  char character;
+  double width;
+  double height;
+};
+
+struct TestLabel
+{
+  std::vector<TestGlyph> glyphs;
+};
+
+using TestLabelType = osmscout::Label<TestGlyph,TestLabel>;
+
+class TestTextLayouter
+{
+public:
+  static constexpr double GLYPH_WIDTH=7.0;
+  static constexpr double GLYPH_HEIGHT=12.0;
+
+public:
+  osmscout::DoubleRectangle GlyphBoundingBox(const TestGlyph& glyph) const
+  {
+    // glyph box relative to the baseline
+    return osmscout::DoubleRectangle(0.0,-glyph.height*0.75,glyph.width,glyph.height);
+  }
+
+  std::shared_ptr<TestLabelType> Layout(const osmscout::Projection& /*projection*/,
+                                        const osmscout::MapParameter& /*parameter*/,
+                                        const std::string& text,
+                                        double fontSize,
+                                        double /*objectWidth*/,
+                                        bool /*enableWrapping*/ = false,
+                                        bool /*contourLabel*/ = false)
+  {
+    auto label=std::make_shared<TestLabelType>();
+
+    for (char c : text) {
+      label->label.glyphs.push_back(TestGlyph{c,GLYPH_WIDTH*fontSize,GLYPH_HEIGHT*fontSize});
+    }
+
+    label->text=text;
+    label->fontSize=fontSize;
+    label->width=GLYPH_WIDTH*fontSize*text.length();
+    label->height=GLYPH_HEIGHT*fontSize;
+
+    return label;
+  }
+};
+
+namespace osmscout {
+  template<>
+  inline std::vector<Glyph<TestGlyph>> TestLabelType::ToGlyphs() const
+  {
+    std::vector<Glyph<TestGlyph>> result;
+    double                        x=0.0;
+
+    result.reserve(label.glyphs.size());
+    for (const auto& nativeGlyph : label.glyphs) {
+      Glyph<TestGlyph> glyph;
+
+      glyph.glyph=nativeGlyph;
+      glyph.position.Set(x,0.0);
+      result.push_back(glyph);
+
+      x+=nativeGlyph.width;
+    }
+
+    return result;
+  }
+}
+
+#endif
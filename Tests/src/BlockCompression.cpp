@@ -0,0 +1,163 @@
+#include <string>
+#include <vector>
+
+#include <osmscout/util/BlockCompression.h>
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+static const size_t recordCount=2000;
+
+/**
+ * Write a data file in the usual layout (record count followed by the records)
+ * and return the offsets of the records.
+ */
+static std::vector<osmscout::FileOffset> WriteRecords(const std::string& filename)
+{
+  osmscout::FileWriter              writer;
+  std::vector<osmscout::FileOffset> offsets;
+
+  writer.Open(filename);
+
+  writer.Write((uint32_t)recordCount);
+
+  for (size_t i=0; i<recordCount; i++) {
+    offsets.push_back(writer.GetPos());
+
+    writer.Write("Record "+std::to_string(i));
+    writer.WriteNumber((uint64_t)i*i);
+    writer.Write((uint32_t)i);
+    writer.WriteCoord(osmscout::GeoCoord(51.0+i/10000.0,7.0-i/10000.0));
+
+    // Some larger records, exceeding the block size
+    if (i%500==0) {
+      writer.Write(std::string(3000,'x'));
+    }
+    else {
+      writer.Write(std::string());
+    }
+  }
+
+  writer.Close();
+
+  return offsets;
+}
+
+static void CheckRecord(osmscout::FileScanner& scanner,
+                        size_t i)
+{
+  std::string        name;
+  uint64_t           square;
+  uint32_t           number;
+  osmscout::GeoCoord coord;
+  std::string        padding;
+
+  scanner.Read(name);
+  scanner.ReadNumber(square);
+  scanner.Read(number);
+  scanner.ReadCoord(coord);
+  scanner.Read(padding);
+
+  REQUIRE(name=="Record "+std::to_string(i));
+  REQUIRE(square==(uint64_t)i*i);
+  REQUIRE(number==i);
+  REQUIRE(coord.GetLat()==Approx(51.0+i/10000.0));
+  REQUIRE(coord.GetLon()==Approx(7.0-i/10000.0));
+  REQUIRE(padding.length()==(i%500==0 ? 3000 : 0));
+}
+
+TEST_CASE("Block compressed file is read transparently")
+{
+  if (!osmscout::IsBlockCompressionSupported()) {
+    WARN("Block compression is not supported by this build");
+    return;
+  }
+
+  std::vector<osmscout::FileOffset> offsets=WriteRecords("blockcompression.dat");
+
+  osmscout::WriteBlockCompressedFile("blockcompression.dat",
+                                     "blockcompression.dat.z",
+                                     offsets,
+                                     1024);
+
+  REQUIRE(osmscout::GetFileSize("blockcompression.dat.z")<osmscout::GetFileSize("blockcompression.dat"));
+
+  osmscout::FileScanner scanner;
+
+  scanner.Open("blockcompression.dat.z",
+               osmscout::FileScanner::LowMemRandom,
+               true);
+
+  REQUIRE(scanner.IsBlockCompressed());
+  REQUIRE_FALSE(scanner.IsMemoryMapped());
+
+  SECTION("Sequential reading crosses block boundaries") {
+    uint32_t count;
+
+    scanner.Read(count);
+
+    REQUIRE(count==recordCount);
+
+    for (size_t i=0; i<recordCount; i++) {
+      REQUIRE(scanner.GetPos()==offsets[i]);
+      CheckRecord(scanner,i);
+    }
+
+    REQUIRE(scanner.IsEOF());
+  }
+
+  SECTION("Random access by uncompressed offset") {
+    osmscout::BlockDataCacheRef cache=std::make_shared<osmscout::BlockDataCache>(4,2);
+
+    scanner.SetBlockCache(cache);
+
+    // Alternate between the start and the end of the file
+    for (size_t i=0; i<recordCount; i+=7) {
+      scanner.SetPos(offsets[i]);
+      CheckRecord(scanner,i);
+
+      scanner.SetPos(offsets[recordCount-1-i]);
+      CheckRecord(scanner,recordCount-1-i);
+    }
+
+    REQUIRE(cache->GetStatistics().hits>0);
+  }
+
+  SECTION("Positioning beyond the end fails") {
+    REQUIRE_THROWS_AS(scanner.SetPos(osmscout::GetFileSize("blockcompression.dat")),
+                      osmscout::IOException);
+  }
+
+  scanner.CloseFailsafe();
+
+  osmscout::RemoveFile("blockcompression.dat");
+  osmscout::RemoveFile("blockcompression.dat.z");
+}
+
+TEST_CASE("Uncompressed file is not block compressed")
+{
+  WriteRecords("blockcompression.dat");
+
+  osmscout::FileScanner scanner;
+
+  scanner.Open("blockcompression.dat",
+               osmscout::FileScanner::LowMemRandom,
+               false);
+
+  REQUIRE_FALSE(scanner.IsBlockCompressed());
+
+  uint32_t count;
+
+  scanner.Read(count);
+
+  REQUIRE(count==recordCount);
+
+  CheckRecord(scanner,0);
+
+  scanner.Close();
+
+  osmscout::RemoveFile("blockcompression.dat");
+}
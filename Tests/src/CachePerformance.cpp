@@ -19,9 +19,12 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <random>
+#include <thread>
 #include <vector>
 
 #include <osmscout/util/Cache.h>
+#include <osmscout/util/ClockCache.h>
 #include <osmscout/util/FileScanner.h>
 #include <osmscout/util/StopClock.h>
 
@@ -30,6 +33,9 @@
   * cache insertion
   * cache hit
   * cache miss
+  for the classic LRU Cache and the ClockCache. Additionally compare the hit rate
+  of both caches for a skewed access pattern and measure the throughput of the
+  ShardedCache with multiple threads.
 */
 
 /**
@@ -64,7 +70,9 @@ private:
 
 static const size_t cacheSize=2000000;
 
-typedef osmscout::Cache<osmscout::Id,Data>     DataCache;
+typedef osmscout::Cache<osmscout::Id,Data>      DataCache;
+typedef osmscout::ClockCache<osmscout::Id,Data> DataClockCache;
+typedef osmscout::ShardedCache<osmscout::Id,size_t> IdShardedCache;
 
 bool TestData()
 {
@@ -180,7 +188,256 @@ bool TestData()
   return true;
 }
 
+bool TestClockData()
+{
+  std::cout << "*** Caching of struct (CLOCK) ***" << std::endl;
+
+  DataClockCache cache(cacheSize);
+
+  std::cout << "Inserting values into cache..." << std::endl;
+
+  osmscout::StopClock insertTimer;
+
+  for (size_t i=cacheSize; i<2*cacheSize; i++) {
+    Data data;
+    data.value=i;
+    data.value2.resize(10,i);
+
+    cache.Put(i,data);
+  }
+
+  insertTimer.Stop();
+
+  if (cache.GetSize()!=cacheSize){
+    return false;
+  }
+
+  std::cout << "Updating values  in cache..." << std::endl;
+
+  osmscout::StopClock updateTimer;
+
+  for (size_t i=cacheSize; i<2*cacheSize; i++) {
+    Data data;
+
+    data.value=i;
+    data.value2.resize(10,i);
+
+    cache.Put(i,data);
+  }
+
+  updateTimer.Stop();
+
+  if (cache.GetSize()!=cacheSize){
+    return false;
+  }
+
+  std::cout << "Searching for entries not in cache..." << std::endl;
+
+  osmscout::StopClock missTimer;
+
+  for (size_t i=0; i<cacheSize; i++) {
+    if (cache.Contains(i)) {
+      return false;
+    }
+  }
+
+  for (size_t i=2*cacheSize; i<3*cacheSize; i++) {
+    if (cache.Contains(i)) {
+      return false;
+    }
+  }
+
+  missTimer.Stop();
+
+  std::cout << "Searching for entries in cache..." << std::endl;
+
+  osmscout::StopClock hitTimer;
+
+  for (size_t t=1; t<=2; t++) {
+    for (size_t i=cacheSize; i<2*cacheSize; i++) {
+      if (!cache.Contains(i)) {
+        return false;
+      }
+    }
+  }
+
+  hitTimer.Stop();
+
+  std::cout << "Copying entries from cache..." << std::endl;
+
+  osmscout::StopClock copyTimer;
+
+  for (size_t t=1; t<=2; t++) {
+    for (size_t i=cacheSize; i<2*cacheSize; i++) {
+      Data data;
+
+      if (!cache.Get(i,data)) {
+        return false;
+      }
+    }
+  }
+
+  copyTimer.Stop();
+
+  std::cout << "Insert time: "  << insertTimer << std::endl;
+  std::cout << "Update time: "  << updateTimer << std::endl;
+  std::cout << "Miss time: "  << missTimer << std::endl;
+  std::cout << "Hit time: "  << hitTimer << std::endl;
+  std::cout << "Copy time: "  << copyTimer << std::endl;
+
+  return true;
+}
+
+/**
+  Generate a skewed sequence of keys: a small set of hot keys is accessed
+  often, interleaved with scans over a large set of cold keys (like
+  rendering the same region again and again while panning the map).
+  */
+std::vector<osmscout::Id> GenerateSkewedKeys(size_t count,
+                                             size_t keyRange)
+{
+  std::mt19937                          generator(4711);
+  std::uniform_int_distribution<size_t> hotDistribution(0,keyRange/20);
+  std::uniform_int_distribution<size_t> coldDistribution(0,keyRange);
+  std::vector<osmscout::Id>             keys;
+
+  keys.reserve(count);
+
+  for (size_t i=0; i<count; i++) {
+    if (i%4==0) {
+      keys.push_back(coldDistribution(generator));
+    }
+    else {
+      keys.push_back(hotDistribution(generator));
+    }
+  }
+
+  return keys;
+}
+
+bool TestSkewedHitRate()
+{
+  std::cout << "*** Hit rate for skewed access ***" << std::endl;
+
+  const size_t                    skewedCacheSize=cacheSize/20;
+  const std::vector<osmscout::Id> keys=GenerateSkewedKeys(4*cacheSize,
+                                                          cacheSize);
+
+  osmscout::Cache<osmscout::Id,size_t>      lruCache(skewedCacheSize);
+  osmscout::ClockCache<osmscout::Id,size_t> clockCache(skewedCacheSize);
+  size_t                                    lruHits=0;
+
+  osmscout::StopClock lruTimer;
+
+  for (const auto key : keys) {
+    osmscout::Cache<osmscout::Id,size_t>::CacheRef ref;
+
+    if (lruCache.GetEntry(key,ref)) {
+      lruHits++;
+    }
+    else {
+      lruCache.SetEntry(osmscout::Cache<osmscout::Id,size_t>::CacheEntry(key,key));
+    }
+  }
+
+  lruTimer.Stop();
+
+  osmscout::StopClock clockTimer;
+
+  for (const auto key : keys) {
+    size_t value;
+
+    if (!clockCache.Get(key,value)) {
+      clockCache.Put(key,key);
+    }
+  }
+
+  clockTimer.Stop();
+
+  osmscout::CacheStatistics statistics=clockCache.GetStatistics();
+
+  if (statistics.hits+statistics.misses!=keys.size()) {
+    return false;
+  }
+
+  std::cout << "LRU:   " << lruTimer << ", hit rate " << (double)lruHits/keys.size()*100 << "%" << std::endl;
+  std::cout << "CLOCK: " << clockTimer << ", hit rate " << statistics.GetHitRate()*100 << "%, ";
+  std::cout << statistics.evictions << " evictions" << std::endl;
+
+  return true;
+}
+
+void AccessShardedCache(const IdShardedCache& cache,
+                        const std::vector<osmscout::Id>& keys,
+                        size_t start)
+{
+  for (size_t i=0; i<keys.size(); i++) {
+    osmscout::Id key=keys[(start+i)%keys.size()];
+    size_t       value;
+
+    if (!cache.Get(key,value)) {
+      cache.Put(key,key);
+    }
+  }
+}
+
+bool TestShardedThroughput()
+{
+  std::cout << "*** Sharded cache throughput ***" << std::endl;
+
+  const std::vector<osmscout::Id> keys=GenerateSkewedKeys(cacheSize,
+                                                          cacheSize);
+  size_t                          maxThreads=std::max(std::thread::hardware_concurrency(),1u);
+
+  for (size_t threadCount=1; threadCount<=maxThreads; threadCount*=2) {
+    IdShardedCache           cache(cacheSize/20);
+    std::vector<std::thread> threads;
+
+    osmscout::StopClock timer;
+
+    for (size_t i=0; i<threadCount; i++) {
+      threads.push_back(std::thread(AccessShardedCache,
+                                    std::cref(cache),
+                                    std::cref(keys),
+                                    i*keys.size()/threadCount));
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    timer.Stop();
+
+    osmscout::CacheStatistics statistics=cache.GetStatistics();
+
+    if (statistics.hits+statistics.misses!=threadCount*keys.size()) {
+      return false;
+    }
+
+    std::cout << threadCount << " thread(s): " << threadCount*keys.size() << " accesses in " << timer;
+    std::cout << ", hit rate " << statistics.GetHitRate()*100 << "%" << std::endl;
+  }
+
+  return true;
+}
+
 int main(int /*argc*/, char* /*argv*/[])
 {
-  return TestData() ? 0:1;
+  if (!TestData()) {
+    return 1;
+  }
+
+  if (!TestClockData()) {
+    return 1;
+  }
+
+  if (!TestSkewedHitRate()) {
+    return 1;
+  }
+
+  if (!TestShardedThroughput()) {
+    return 1;
+  }
+
+  return 0;
 }
@@ -0,0 +1,185 @@
+#include <osmscout/util/ClockCache.h>
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+typedef osmscout::ClockCache<size_t,size_t> TestCache;
+
+/**
+ * Accounts the value itself as memory of an entry
+ */
+struct ValueSizer : public TestCache::ValueSizer
+{
+  size_t GetSize(const size_t& value) const override
+  {
+    return value;
+  }
+};
+
+TEST_CASE("Put and get entries") {
+  TestCache cache(10);
+  size_t    value;
+
+  for (size_t i=0; i<10; i++) {
+    cache.Put(i,i*10);
+  }
+
+  REQUIRE(cache.GetSize()==10);
+
+  for (size_t i=0; i<10; i++) {
+    REQUIRE(cache.Get(i,value));
+    REQUIRE(value==i*10);
+  }
+
+  REQUIRE_FALSE(cache.Get(10,value));
+
+  cache.Put(5,4711);
+
+  REQUIRE(cache.GetSize()==10);
+  REQUIRE(cache.Get(5,value));
+  REQUIRE(value==4711);
+
+  osmscout::CacheStatistics statistics=cache.GetStatistics();
+
+  REQUIRE(statistics.hits==11);
+  REQUIRE(statistics.misses==1);
+  REQUIRE(statistics.insertions==10);
+  REQUIRE(statistics.evictions==0);
+}
+
+TEST_CASE("Referenced entries survive eviction") {
+  TestCache cache(4);
+  size_t    value;
+
+  for (size_t i=0; i<4; i++) {
+    cache.Put(i,i);
+  }
+
+  REQUIRE(cache.Get(0,value));
+  REQUIRE(cache.Get(2,value));
+
+  cache.Put(4,4);
+  cache.Put(5,5);
+
+  REQUIRE(cache.GetSize()==4);
+  REQUIRE(cache.Contains(0));
+  REQUIRE(cache.Contains(2));
+  REQUIRE_FALSE(cache.Contains(1));
+  REQUIRE_FALSE(cache.Contains(3));
+  REQUIRE(cache.GetStatistics().evictions==2);
+}
+
+TEST_CASE("Remove entries") {
+  TestCache cache(100);
+
+  for (size_t i=0; i<100; i++) {
+    cache.Put(i,i);
+  }
+
+  for (size_t i=0; i<100; i+=2) {
+    cache.Remove(i);
+  }
+
+  REQUIRE(cache.GetSize()==50);
+
+  for (size_t i=0; i<100; i++) {
+    REQUIRE(cache.Contains(i)==(i%2==1));
+  }
+
+  cache.Flush();
+
+  REQUIRE(cache.GetSize()==0);
+  REQUIRE(cache.GetMemory()==0);
+  REQUIRE_FALSE(cache.Contains(1));
+}
+
+TEST_CASE("Memory limit") {
+  ValueSizer sizer;
+  TestCache  unlimitedCache(1000,0,&sizer);
+
+  unlimitedCache.Put(0,0);
+
+  size_t     entryOverhead=unlimitedCache.GetMemory();
+  TestCache  cache(1000,10*entryOverhead+1000,&sizer);
+
+  for (size_t i=0; i<10; i++) {
+    cache.Put(i,100);
+  }
+
+  REQUIRE(cache.GetSize()==10);
+  REQUIRE(cache.GetMemory()==10*entryOverhead+1000);
+
+  // One big entry replaces multiple small ones
+  cache.Put(10,500);
+
+  REQUIRE(cache.GetSize()<10);
+  REQUIRE(cache.Contains(10));
+  REQUIRE(cache.GetMemory()<=cache.GetMaxMemory());
+
+  cache.SetMaxMemory(entryOverhead+500);
+
+  REQUIRE(cache.GetSize()==1);
+}
+
+TEST_CASE("Growing an entry evicts other entries") {
+  ValueSizer sizer;
+  size_t     entryOverhead=TestCache::GetEntryOverhead();
+  TestCache  cache(1000,10*entryOverhead+1000,&sizer);
+  size_t     value;
+
+  for (size_t i=0; i<10; i++) {
+    cache.Put(i,100);
+  }
+
+  REQUIRE(cache.GetMemory()==cache.GetMaxMemory());
+
+  cache.Put(5,400);
+
+  REQUIRE(cache.GetSize()<10);
+  REQUIRE(cache.GetMemory()<=cache.GetMaxMemory());
+  REQUIRE(cache.Get(5,value));
+  REQUIRE(value==400);
+}
+
+TEST_CASE("Entries larger than the memory limit are not cached") {
+  ValueSizer sizer;
+  size_t     entryOverhead=TestCache::GetEntryOverhead();
+  TestCache  cache(1000,entryOverhead+100,&sizer);
+  size_t     value;
+
+  cache.Put(1,50);
+  cache.Put(2,101);
+
+  REQUIRE(cache.GetSize()==1);
+  REQUIRE(cache.Get(1,value));
+  REQUIRE_FALSE(cache.Contains(2));
+
+  // An update exceeding the limit removes the old value
+  cache.Put(1,200);
+
+  REQUIRE(cache.GetSize()==0);
+  REQUIRE(cache.GetMemory()==0);
+  REQUIRE_FALSE(cache.Contains(1));
+}
+
+TEST_CASE("Sharded cache") {
+  osmscout::ShardedCache<size_t,size_t> cache(1000,8);
+  size_t                                value;
+
+  for (size_t i=0; i<2000; i++) {
+    cache.Put(i,i);
+  }
+
+  osmscout::CacheStatistics statistics=cache.GetStatistics();
+
+  REQUIRE(statistics.entries<=1000);
+  REQUIRE(statistics.insertions==2000);
+  REQUIRE(statistics.evictions==2000-statistics.entries);
+
+  REQUIRE(cache.Get(1999,value));
+  REQUIRE(value==1999);
+
+  cache.Flush();
+
+  REQUIRE_FALSE(cache.Get(1999,value));
+}
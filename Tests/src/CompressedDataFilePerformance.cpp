@@ -0,0 +1,275 @@
+/*
+  CompressedDataFilePerformance - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <osmscout/AreaDataFile.h>
+#include <osmscout/Database.h>
+#include <osmscout/WayDataFile.h>
+
+#include <osmscout/util/BlockCompression.h>
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/StopClock.h>
+#include <osmscout/util/String.h>
+
+/**
+  Compare file size and random read latency of the way and area data files of a
+  database in their plain form (memory mapped and not memory mapped) and block
+  compressed.
+
+  The compressed copies of 'ways.dat' and 'areas.dat' are written to the given
+  target directory. Object caches are disabled, objects are loaded one by one in
+  random order.
+*/
+
+struct Result
+{
+  size_t objectCount;
+  double time;
+
+  Result()
+  : objectCount(0),
+    time(0.0)
+  {
+    // no code
+  }
+};
+
+/**
+ * Return the offsets of all records of the given (uncompressed) data file.
+ */
+template<class N>
+std::vector<osmscout::FileOffset> GetRecordOffsets(const osmscout::TypeConfig& typeConfig,
+                                                   const std::string& filename)
+{
+  osmscout::FileScanner             scanner;
+  std::vector<osmscout::FileOffset> offsets;
+  uint32_t                          dataCount;
+
+  scanner.Open(filename,
+               osmscout::FileScanner::Sequential,
+               true);
+
+  scanner.Read(dataCount);
+
+  offsets.reserve(dataCount);
+
+  for (uint32_t i=0; i<dataCount; i++) {
+    N data;
+
+    offsets.push_back(scanner.GetPos());
+
+    data.Read(typeConfig,
+              scanner);
+  }
+
+  scanner.Close();
+
+  return offsets;
+}
+
+template<class N>
+bool LoadObjects(const osmscout::DataFile<N>& dataFile,
+                 const std::vector<osmscout::FileOffset>& offsets,
+                 Result& result)
+{
+  osmscout::StopClock timer;
+
+  for (const auto offset : offsets) {
+    std::shared_ptr<N> data;
+
+    if (!dataFile.GetByOffset(offset,
+                              data)) {
+      return false;
+    }
+  }
+
+  timer.Stop();
+
+  result.objectCount+=offsets.size();
+  result.time+=timer.GetMilliseconds();
+
+  return true;
+}
+
+void DumpResult(const std::string& name,
+                const Result& result)
+{
+  std::cout << name << ": " << result.objectCount << " objects, " << result.time << " ms";
+
+  if (result.objectCount>0) {
+    std::cout << ", " << result.time*1000.0/result.objectCount << " us/object";
+  }
+
+  std::cout << std::endl;
+}
+
+template<class F>
+bool Measure(const osmscout::TypeConfigRef& typeConfig,
+             const std::string& databaseDirectory,
+             const std::string& targetDirectory,
+             const std::string& datafile,
+             size_t sampleCount,
+             size_t iterationCount)
+{
+  typedef typename F::ValueType::element_type N;
+
+  std::string plainFilename=osmscout::AppendFileToDir(databaseDirectory,datafile);
+  std::string compressedFilename=osmscout::AppendFileToDir(targetDirectory,datafile);
+
+  std::vector<osmscout::FileOffset> offsets=GetRecordOffsets<N>(*typeConfig,
+                                                                plainFilename);
+
+  osmscout::StopClock compressionTimer;
+
+  osmscout::WriteBlockCompressedFile(plainFilename,
+                                     compressedFilename,
+                                     offsets);
+
+  compressionTimer.Stop();
+
+  osmscout::FileOffset plainSize=osmscout::GetFileSize(plainFilename);
+  osmscout::FileOffset compressedSize=osmscout::GetFileSize(compressedFilename);
+
+  std::cout << "'" << datafile << "': " << offsets.size() << " objects, ";
+  std::cout << osmscout::ByteSizeToString(plainSize) << " => " << osmscout::ByteSizeToString(compressedSize);
+  std::cout << " (" << (plainSize>0 ? compressedSize*100.0/plainSize : 0.0) << "%), ";
+  std::cout << "compressed in " << compressionTimer.ResultString() << "s" << std::endl;
+
+  std::mt19937 generator(4711);
+
+  std::shuffle(offsets.begin(),offsets.end(),generator);
+
+  if (offsets.size()>sampleCount) {
+    offsets.resize(sampleCount);
+  }
+
+  F      plainFile(0);
+  F      mappedFile(0);
+  F      compressedFile(0);
+  Result plainResult;
+  Result mappedResult;
+  Result compressedResult;
+
+  if (!plainFile.Open(typeConfig,databaseDirectory,false) ||
+      !mappedFile.Open(typeConfig,databaseDirectory,true) ||
+      !compressedFile.Open(typeConfig,targetDirectory,false)) {
+    std::cerr << "Cannot open data files" << std::endl;
+    return false;
+  }
+
+  for (size_t i=1; i<=iterationCount; i++) {
+    if (!LoadObjects(plainFile,offsets,plainResult) ||
+        !LoadObjects(mappedFile,offsets,mappedResult) ||
+        !LoadObjects(compressedFile,offsets,compressedResult)) {
+      std::cerr << "Error while loading data" << std::endl;
+      return false;
+    }
+  }
+
+  DumpResult(datafile+" plain",plainResult);
+  DumpResult(datafile+" plain, mmap",mappedResult);
+  DumpResult(datafile+" compressed",compressedResult);
+
+  compressedFile.DumpStatistics();
+
+  plainFile.Close();
+  mappedFile.Close();
+  compressedFile.Close();
+
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc<3 || argc>5) {
+    std::cerr << "CompressedDataFilePerformance <database directory> <target directory> [<samples> [<iterations>]]" << std::endl;
+
+    return 1;
+  }
+
+  size_t sampleCount=100000;
+  size_t iterationCount=3;
+
+  if (argc>=4 && !osmscout::StringToNumber(argv[3],sampleCount)) {
+    std::cerr << "Cannot parse samples '" << argv[3] << "'" << std::endl;
+    return 1;
+  }
+
+  if (argc>=5 && !osmscout::StringToNumber(argv[4],iterationCount)) {
+    std::cerr << "Cannot parse iterations '" << argv[4] << "'" << std::endl;
+    return 1;
+  }
+
+  if (std::string(argv[1])==std::string(argv[2])) {
+    std::cerr << "Target directory must differ from database directory" << std::endl;
+    return 1;
+  }
+
+  if (!osmscout::IsBlockCompressionSupported()) {
+    std::cerr << "Block compression is not supported by this build" << std::endl;
+
+    return 1;
+  }
+
+  osmscout::DatabaseParameter parameter;
+  osmscout::DatabaseRef       database=std::make_shared<osmscout::Database>(parameter);
+
+  if (!database->Open(argv[1])) {
+    std::cerr << "Cannot open database" << std::endl;
+
+    return 1;
+  }
+
+  osmscout::TypeConfigRef typeConfig=database->GetTypeConfig();
+
+  try {
+    if (!Measure<osmscout::WayDataFile>(typeConfig,
+                                        argv[1],
+                                        argv[2],
+                                        osmscout::WayDataFile::WAYS_DAT,
+                                        sampleCount,
+                                        iterationCount) ||
+        !Measure<osmscout::AreaDataFile>(typeConfig,
+                                         argv[1],
+                                         argv[2],
+                                         osmscout::AreaDataFile::AREAS_DAT,
+                                         sampleCount,
+                                         iterationCount)) {
+      database->Close();
+
+      return 1;
+    }
+  }
+  catch (osmscout::IOException& e) {
+    std::cerr << e.GetDescription() << std::endl;
+    database->Close();
+
+    return 1;
+  }
+
+  database->Close();
+
+  return 0;
+}
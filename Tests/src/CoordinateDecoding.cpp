@@ -0,0 +1,169 @@
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <osmscout/GeoCoord.h>
+#include <osmscout/Point.h>
+
+#include <osmscout/util/CoordinateDecoding.h>
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+static const std::vector<osmscout::CoordinateDecoderType> decoderTypes={osmscout::CoordinateDecoderType::Scalar,
+                                                                       osmscout::CoordinateDecoderType::SSE41,
+                                                                       osmscout::CoordinateDecoderType::AVX2};
+
+/**
+ * Random deltas with the given size in bytes, including the extreme values
+ */
+static std::vector<uint8_t> CreateDeltas(size_t deltaBytes,
+                                         size_t count)
+{
+  std::mt19937                           generator(4711);
+  std::uniform_int_distribution<int32_t> distribution(-(1 << (8*deltaBytes-1)),
+                                                      (1 << (8*deltaBytes-1))-1);
+  std::vector<uint8_t>                   deltas;
+
+  for (size_t i=0; i<2*count; i++) {
+    int32_t delta=distribution(generator);
+
+    if (i%7==0) {
+      delta=-(1 << (8*deltaBytes-1));
+    }
+    else if (i%11==0) {
+      delta=(1 << (8*deltaBytes-1))-1;
+    }
+
+    for (size_t b=0; b<deltaBytes; b++) {
+      deltas.push_back((uint8_t)((uint32_t)delta >> (8*b)));
+    }
+  }
+
+  return deltas;
+}
+
+TEST_CASE("Scalar decoder is always supported")
+{
+  REQUIRE(osmscout::IsCoordinateDecoderSupported(osmscout::CoordinateDecoderType::Scalar));
+  REQUIRE(osmscout::IsCoordinateDecoderSupported(osmscout::GetCoordinateDecoderType()));
+}
+
+TEST_CASE("Scalar decoder sums up signed deltas")
+{
+  const uint8_t deltas[]={0x01,0xff, 0x80,0x7f, 0x00,0x02};
+  uint32_t      latValues[3];
+  uint32_t      lonValues[3];
+
+  osmscout::DecodeCoordinateDeltas(osmscout::CoordinateDecoderType::Scalar,
+                                   deltas,1,3,
+                                   1000,0,
+                                   latValues,lonValues);
+
+  REQUIRE(latValues[0]==1001);
+  REQUIRE(latValues[1]==873);
+  REQUIRE(latValues[2]==873);
+  REQUIRE(lonValues[0]==0xffffffff);
+  REQUIRE(lonValues[1]==126);
+  REQUIRE(lonValues[2]==128);
+}
+
+TEST_CASE("All decoders return the same values as the scalar decoder")
+{
+  for (const auto type : decoderTypes) {
+    if (!osmscout::IsCoordinateDecoderSupported(type)) {
+      WARN("Decoder " << osmscout::GetCoordinateDecoderName(type) << " not supported, skipped");
+      continue;
+    }
+
+    for (size_t deltaBytes=1; deltaBytes<=3; deltaBytes++) {
+      for (size_t count : {0,1,3,4,5,7,8,9,15,16,17,33,1000}) {
+        std::vector<uint8_t>  deltas=CreateDeltas(deltaBytes,count);
+        std::vector<uint32_t> expectedLats(count);
+        std::vector<uint32_t> expectedLons(count);
+        std::vector<uint32_t> latValues(count);
+        std::vector<uint32_t> lonValues(count);
+
+        osmscout::DecodeCoordinateDeltas(osmscout::CoordinateDecoderType::Scalar,
+                                         deltas.data(),deltaBytes,count,
+                                         67108863,4294967000u,
+                                         expectedLats.data(),expectedLons.data());
+        osmscout::DecodeCoordinateDeltas(type,
+                                         deltas.data(),deltaBytes,count,
+                                         67108863,4294967000u,
+                                         latValues.data(),lonValues.data());
+
+        INFO(osmscout::GetCoordinateDecoderName(type) << ", " << deltaBytes << " byte deltas, " << count << " coordinates");
+        REQUIRE(latValues==expectedLats);
+        REQUIRE(lonValues==expectedLons);
+
+        std::vector<double> expectedLatDegrees(count);
+        std::vector<double> expectedLonDegrees(count);
+        std::vector<double> lats(count);
+        std::vector<double> lons(count);
+
+        osmscout::ConvertCoordinateValues(osmscout::CoordinateDecoderType::Scalar,
+                                          expectedLats.data(),expectedLons.data(),count,
+                                          expectedLatDegrees.data(),expectedLonDegrees.data());
+        osmscout::ConvertCoordinateValues(type,
+                                          latValues.data(),lonValues.data(),count,
+                                          lats.data(),lons.data());
+
+        // Results must be identical, not only nearly equal
+        REQUIRE(lats==expectedLatDegrees);
+        REQUIRE(lons==expectedLonDegrees);
+      }
+    }
+  }
+}
+
+TEST_CASE("Coordinates written by FileWriter are read back unchanged")
+{
+  for (int32_t maxDelta : {100,30000,4000000}) {
+    std::mt19937                           generator(4711);
+    std::uniform_int_distribution<int32_t> distribution(-maxDelta,maxDelta);
+    std::vector<osmscout::Point>           points;
+    uint32_t                               latValue=(uint32_t)round((51.0+90.0)*osmscout::latConversionFactor);
+    uint32_t                               lonValue=(uint32_t)round((7.0+180.0)*osmscout::lonConversionFactor);
+
+    // More points than decoded in one chunk
+    for (size_t i=0; i<1000; i++) {
+      points.push_back(osmscout::Point(0,osmscout::GeoCoord(latValue/osmscout::latConversionFactor-90.0,
+                                                            lonValue/osmscout::lonConversionFactor-180.0)));
+
+      latValue+=distribution(generator);
+      lonValue+=distribution(generator);
+    }
+
+    osmscout::FileWriter writer;
+
+    writer.Open("coordinatedecoding.dat");
+    writer.Write(points,false);
+    writer.Close();
+
+    for (bool memoryMapped : {false,true}) {
+      osmscout::FileScanner        scanner;
+      std::vector<osmscout::Point> result;
+
+      scanner.Open("coordinatedecoding.dat",
+                   osmscout::FileScanner::Sequential,
+                   memoryMapped);
+      scanner.Read(result,false);
+      scanner.Close();
+
+      INFO("Maximum delta " << maxDelta << (memoryMapped ? ", memory mapped" : ""));
+      REQUIRE(result.size()==points.size());
+
+      for (size_t i=0; i<points.size(); i++) {
+        REQUIRE(result[i].GetLat()==points[i].GetLat());
+        REQUIRE(result[i].GetLon()==points[i].GetLon());
+      }
+    }
+
+    osmscout::RemoveFile("coordinatedecoding.dat");
+  }
+}
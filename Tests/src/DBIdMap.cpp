@@ -0,0 +1,86 @@
+#include <map>
+#include <random>
+
+#include <osmscout/routing/DBIdMap.h>
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+TEST_CASE("Insert and find entries")
+{
+  osmscout::DBIdMap<int> map;
+
+  REQUIRE(map.IsEmpty());
+  REQUIRE(map.Insert(osmscout::DBId(0,1),1));
+  REQUIRE(map.Insert(osmscout::DBId(1,1),2));
+  REQUIRE_FALSE(map.Insert(osmscout::DBId(0,1),3));
+
+  REQUIRE(map.Size()==2);
+  REQUIRE(*map.Find(osmscout::DBId(0,1))==1);
+  REQUIRE(*map.Find(osmscout::DBId(1,1))==2);
+  REQUIRE(map.Find(osmscout::DBId(0,2))==nullptr);
+
+  map[osmscout::DBId(0,1)]=4;
+  map[osmscout::DBId(0,2)]=5;
+
+  REQUIRE(map.Size()==3);
+  REQUIRE(*map.Find(osmscout::DBId(0,1))==4);
+  REQUIRE(*map.Find(osmscout::DBId(0,2))==5);
+}
+
+TEST_CASE("Clear keeps no entries")
+{
+  osmscout::DBIdMap<int> map;
+
+  for (osmscout::Id id=1; id<=100; id++) {
+    map[osmscout::DBId(0,id)]=(int)id;
+  }
+
+  map.Clear();
+
+  REQUIRE(map.IsEmpty());
+
+  for (osmscout::Id id=1; id<=100; id++) {
+    REQUIRE_FALSE(map.Contains(osmscout::DBId(0,id)));
+  }
+
+  REQUIRE(map.Insert(osmscout::DBId(0,50),1));
+  REQUIRE(map.Size()==1);
+}
+
+TEST_CASE("Compare with std::map while growing")
+{
+  osmscout::DBIdMap<osmscout::Id>      map;
+  std::map<osmscout::DBId,osmscout::Id> reference;
+  std::mt19937_64                       random(42);
+
+  for (size_t run=0; run<3; run++) {
+    map.Clear();
+    reference.clear();
+
+    for (size_t i=0; i<20000; i++) {
+      osmscout::DBId id((osmscout::DatabaseId)(random()%2),
+                        random()%50000+1);
+
+      map[id]=id.id+run;
+      reference[id]=id.id+run;
+    }
+
+    REQUIRE(map.Size()==reference.size());
+
+    for (const auto& entry : reference) {
+      const osmscout::Id* value=map.Find(entry.first);
+
+      REQUIRE(value!=nullptr);
+      REQUIRE(*value==entry.second);
+    }
+
+    size_t visited=0;
+
+    map.Visit([&visited](const osmscout::Id&) {
+      visited++;
+    });
+
+    REQUIRE(visited==reference.size());
+  }
+}
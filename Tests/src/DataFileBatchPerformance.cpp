@@ -0,0 +1,232 @@
+/*
+  DataFileBatchPerformance - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+#include <osmscout/Database.h>
+
+#include <osmscout/util/StopClock.h>
+#include <osmscout/util/String.h>
+
+/**
+  Compare loading ways and areas by offset from non memory mapped data files with
+  batched reading disabled (objects are read one by one in the requested order) and
+  enabled (offsets are sorted, deduplicated and neighbouring objects are prefetched
+  in one range).
+
+  Offsets are requested in random order. Object caches are disabled and the page
+  cache of the data files is dropped before each run (if supported by the platform),
+  to measure the cold case.
+*/
+
+struct Result
+{
+  size_t objectCount;
+  double time;
+
+  Result()
+  : objectCount(0),
+    time(0.0)
+  {
+    // no code
+  }
+};
+
+/**
+ * Ask the operating system to drop cached pages of the given file.
+ */
+bool DropPageCache(const std::string& filename)
+{
+#if defined(POSIX_FADV_DONTNEED)
+  int fd=open(filename.c_str(),O_RDONLY);
+
+  if (fd<0) {
+    return false;
+  }
+
+  int result=posix_fadvise(fd,0,0,POSIX_FADV_DONTNEED);
+
+  close(fd);
+
+  return result==0;
+#else
+  return false;
+#endif
+}
+
+template<class N>
+bool LoadObjects(osmscout::DataFile<N>& dataFile,
+                 const std::vector<osmscout::FileOffset>& offsets,
+                 size_t batchReadWindow,
+                 bool& cold,
+                 Result& result)
+{
+  std::vector<std::shared_ptr<N>> objects;
+
+  dataFile.SetBatchReadWindow(batchReadWindow);
+
+  if (!DropPageCache(dataFile.GetFilename())) {
+    cold=false;
+  }
+
+  osmscout::StopClock timer;
+
+  if (!dataFile.GetByOffset(offsets.begin(),
+                            offsets.end(),
+                            offsets.size(),
+                            objects)) {
+    return false;
+  }
+
+  timer.Stop();
+
+  if (objects.size()!=offsets.size()) {
+    std::cerr << "Expected " << offsets.size() << " objects, but got " << objects.size() << std::endl;
+    return false;
+  }
+
+  for (size_t i=0; i<objects.size(); i++) {
+    if (objects[i]->GetFileOffset()!=offsets[i]) {
+      std::cerr << "Object #" << i << " has offset " << objects[i]->GetFileOffset() << " instead of " << offsets[i] << std::endl;
+      return false;
+    }
+  }
+
+  result.objectCount+=objects.size();
+  result.time+=timer.GetMilliseconds();
+
+  return true;
+}
+
+void DumpResult(const std::string& name,
+                const Result& result)
+{
+  std::cout << name << ": " << result.objectCount << " objects, " << result.time << " ms" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc<2 || argc>3) {
+    std::cerr << "DataFileBatchPerformance <database directory> [<iterations>]" << std::endl;
+
+    return 1;
+  }
+
+  size_t iterationCount=3;
+
+  if (argc>=3 && !osmscout::StringToNumber(argv[2],iterationCount)) {
+    std::cerr << "Cannot parse iterations '" << argv[2] << "'" << std::endl;
+    return 1;
+  }
+
+  osmscout::DatabaseParameter parameter;
+
+  parameter.SetWayDataCacheSize(0);
+  parameter.SetAreaDataCacheSize(0);
+  parameter.SetWaysDataMMap(false);
+  parameter.SetAreasDataMMap(false);
+
+  osmscout::DatabaseRef database=std::make_shared<osmscout::Database>(parameter);
+
+  if (!database->Open(argv[1])) {
+    std::cerr << "Cannot open database" << std::endl;
+
+    return 1;
+  }
+
+  osmscout::TypeConfigRef              typeConfig=database->GetTypeConfig();
+  osmscout::WayDataFileRef             wayDataFile=database->GetWayDataFile();
+  osmscout::AreaDataFileRef            areaDataFile=database->GetAreaDataFile();
+  osmscout::GeoBox                     boundingBox;
+  std::vector<osmscout::FileOffset>    wayOffsets;
+  std::vector<osmscout::DataBlockSpan> areaSpans;
+  std::vector<osmscout::AreaRef>       areas;
+  std::vector<osmscout::FileOffset>    areaOffsets;
+  osmscout::TypeInfoSet                loadedTypes;
+
+  if (!database->GetBoundingBox(boundingBox) ||
+      !database->GetAreaWayIndex()->GetOffsets(boundingBox,
+                                               osmscout::TypeInfoSet(typeConfig->GetWayTypes()),
+                                               wayOffsets,
+                                               loadedTypes) ||
+      !database->GetAreaAreaIndex()->GetAreasInArea(*typeConfig,
+                                                    boundingBox,
+                                                    std::numeric_limits<size_t>::max(),
+                                                    osmscout::TypeInfoSet(typeConfig->GetAreaTypes()),
+                                                    areaSpans,
+                                                    loadedTypes) ||
+      !areaDataFile->GetByBlockSpans(areaSpans.begin(),
+                                     areaSpans.end(),
+                                     areas)) {
+    std::cerr << "Cannot collect test data" << std::endl;
+
+    return 1;
+  }
+
+  for (const auto& area : areas) {
+    areaOffsets.push_back(area->GetFileOffset());
+  }
+
+  areas.clear();
+
+  std::mt19937 generator(4711);
+
+  std::shuffle(wayOffsets.begin(),wayOffsets.end(),generator);
+  std::shuffle(areaOffsets.begin(),areaOffsets.end(),generator);
+
+  Result wayResult;
+  Result wayBatchResult;
+  Result areaResult;
+  Result areaBatchResult;
+  bool   cold=true;
+
+  for (size_t i=1; i<=iterationCount; i++) {
+    if (!LoadObjects(*wayDataFile,wayOffsets,0,cold,wayResult) ||
+        !LoadObjects(*wayDataFile,wayOffsets,osmscout::WayDataFile::DEFAULT_BATCH_READ_WINDOW,cold,wayBatchResult) ||
+        !LoadObjects(*areaDataFile,areaOffsets,0,cold,areaResult) ||
+        !LoadObjects(*areaDataFile,areaOffsets,osmscout::AreaDataFile::DEFAULT_BATCH_READ_WINDOW,cold,areaBatchResult)) {
+      std::cerr << "Error while loading data" << std::endl;
+
+      return 1;
+    }
+  }
+
+  if (!cold) {
+    std::cout << "Note: Page cache could not be dropped, results are for a warm cache" << std::endl;
+  }
+
+  DumpResult("Way",wayResult);
+  DumpResult("Way batched",wayBatchResult);
+  DumpResult("Area",areaResult);
+  DumpResult("Area batched",areaBatchResult);
+
+  database->Close();
+
+  return 0;
+}
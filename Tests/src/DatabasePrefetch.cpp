@@ -0,0 +1,124 @@
+/*
+  DatabasePrefetch - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <osmscout/Database.h>
+
+#include <osmscout/util/Breaker.h>
+#include <osmscout/util/Magnification.h>
+
+#include "GridDatabase.h"
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+static const GridDatabase grid(40,0.001);
+
+/**
+ * Open the imported database with a single prefetch thread, so that further
+ * requests stay queued while the first one is processed
+ */
+static osmscout::DatabaseRef OpenDatabase()
+{
+  osmscout::DatabaseParameter parameter;
+
+  parameter.SetPrefetchThreadCount(1);
+
+  osmscout::DatabaseRef database=std::make_shared<osmscout::Database>(parameter);
+
+  REQUIRE(database->Open("."));
+
+  return database;
+}
+
+TEST_CASE("Completed prefetch request returns true")
+{
+  osmscout::DatabaseRef database=OpenDatabase();
+  osmscout::TypeInfoSet types(database->GetTypeConfig()->GetTypes());
+
+  std::future<bool> result=database->Prefetch(grid.GetBoundingBox(),
+                                              types,
+                                              osmscout::Magnification(osmscout::Magnification::magStreet));
+
+  REQUIRE(result.get());
+
+  database->Close();
+}
+
+TEST_CASE("Prefetch request canceled by its breaker returns false")
+{
+  osmscout::DatabaseRef database=OpenDatabase();
+  osmscout::TypeInfoSet types(database->GetTypeConfig()->GetTypes());
+  osmscout::BreakerRef  breaker=std::make_shared<osmscout::ThreadedBreaker>();
+
+  breaker->Break();
+
+  std::future<bool> result=database->Prefetch(grid.GetBoundingBox(),
+                                              types,
+                                              osmscout::Magnification(osmscout::Magnification::magStreet),
+                                              breaker);
+
+  REQUIRE_FALSE(result.get());
+
+  database->Close();
+}
+
+TEST_CASE("Close cancels queued prefetch requests and joins the threads")
+{
+  osmscout::DatabaseRef          database=OpenDatabase();
+  osmscout::TypeInfoSet          types(database->GetTypeConfig()->GetTypes());
+  std::vector<std::future<bool>> results;
+
+  for (size_t i=0; i<100; i++) {
+    results.push_back(database->Prefetch(grid.GetBoundingBox(),
+                                         types,
+                                         osmscout::Magnification(osmscout::Magnification::magStreet)));
+  }
+
+  database->Close();
+
+  // Every request has been processed or canceled before Close() returned
+  for (auto& result : results) {
+    REQUIRE(result.wait_for(std::chrono::seconds(0))==std::future_status::ready);
+    REQUIRE_NOTHROW(result.get());
+  }
+
+  // Requests after Close() fail immediately
+  REQUIRE_FALSE(database->Prefetch(grid.GetBoundingBox(),
+                                   types,
+                                   osmscout::Magnification(osmscout::Magnification::magStreet)).get());
+}
+
+int main(int argc, char* argv[])
+{
+  osmscout::ImportParameter importParameter;
+
+  int importResult=grid.Import(importParameter);
+
+  if (importResult!=0) {
+    return importResult;
+  }
+
+  return Catch::Session().run(argc,argv);
+}
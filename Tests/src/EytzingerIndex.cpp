@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <osmscout/EytzingerIndex.h>
+#include <osmscout/TypeConfig.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+#include <osmscout/util/Progress.h>
+
+#include <osmscout/import/GenEytzingerIndex.h>
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+static const char* DATA_FILE="eytzinger.dat";
+static const char* INDEX_FILE="eytzinger.idx";
+
+/**
+ * Minimal record, as expected by EytzingerIndexGenerator
+ */
+class Record
+{
+private:
+  osmscout::OSMId id;
+  std::string     name;
+
+public:
+  osmscout::OSMId GetId() const
+  {
+    return id;
+  }
+
+  void Read(const osmscout::TypeConfig& /*typeConfig*/,
+            osmscout::FileScanner& scanner)
+  {
+    scanner.Read(id);
+    scanner.Read(name);
+  }
+};
+
+/**
+ * Ids of the test records: sorted, negative and positive, with gaps
+ */
+static osmscout::OSMId GetRecordId(size_t i)
+{
+  return (osmscout::OSMId)i*3-1000;
+}
+
+static std::vector<osmscout::FileOffset> WriteRecords(size_t recordCount)
+{
+  osmscout::FileWriter              writer;
+  std::vector<osmscout::FileOffset> offsets;
+
+  writer.Open(DATA_FILE);
+
+  writer.Write((uint32_t)recordCount);
+
+  for (size_t i=0; i<recordCount; i++) {
+    offsets.push_back(writer.GetPos());
+
+    writer.Write((int64_t)GetRecordId(i));
+    writer.Write("Record "+std::to_string(i));
+  }
+
+  writer.Close();
+
+  return offsets;
+}
+
+static void GenerateIndex()
+{
+  osmscout::TypeConfigRef   typeConfig=std::make_shared<osmscout::TypeConfig>();
+  osmscout::ImportParameter parameter;
+  osmscout::SilentProgress  progress;
+
+  osmscout::EytzingerIndexGenerator<osmscout::OSMId,Record> generator("Generating index",
+                                                                      DATA_FILE,
+                                                                      INDEX_FILE);
+
+  parameter.SetDestinationDirectory(".");
+
+  REQUIRE(generator.Import(typeConfig,
+                           parameter,
+                           progress));
+}
+
+static void CheckIndex(size_t recordCount,
+                       bool memoryMapped)
+{
+  std::vector<osmscout::FileOffset>         offsets=WriteRecords(recordCount);
+  osmscout::EytzingerIndex<osmscout::OSMId> index(INDEX_FILE);
+
+  GenerateIndex();
+
+  REQUIRE(index.Open(".",memoryMapped));
+  REQUIRE(index.GetEntryCount()==recordCount);
+
+  for (size_t i=0; i<recordCount; i++) {
+    osmscout::FileOffset offset;
+
+    REQUIRE(index.GetOffset(GetRecordId(i),offset));
+    REQUIRE(offset==offsets[i]);
+
+    REQUIRE_FALSE(index.GetOffset(GetRecordId(i)+1,offset));
+  }
+
+  osmscout::FileOffset offset;
+
+  REQUIRE_FALSE(index.GetOffset(GetRecordId(0)-1,offset));
+  REQUIRE_FALSE(index.GetOffset(GetRecordId(recordCount),offset));
+
+  // Batch lookup: result in order of the ids, missing ids are skipped
+  std::vector<osmscout::OSMId>      ids;
+  std::vector<osmscout::FileOffset> expected;
+  std::vector<osmscout::FileOffset> result;
+
+  for (size_t i=0; i<recordCount; i+=2) {
+    ids.push_back(GetRecordId(i));
+    expected.push_back(offsets[i]);
+
+    ids.push_back(GetRecordId(i)+2);
+  }
+
+  for (size_t i=recordCount; i>0; i-=std::min(i,(size_t)5)) {
+    ids.push_back(GetRecordId(i-1));
+    expected.push_back(offsets[i-1]);
+  }
+
+  REQUIRE(index.GetOffsets(ids.begin(),
+                           ids.end(),
+                           ids.size(),
+                           result));
+  REQUIRE(result==expected);
+
+  REQUIRE(index.Close());
+
+  osmscout::RemoveFile(DATA_FILE);
+  osmscout::RemoveFile(INDEX_FILE);
+}
+
+TEST_CASE("Lookup in memory mapped index")
+{
+  CheckIndex(1000,true);
+}
+
+TEST_CASE("Lookup in index loaded into memory")
+{
+  CheckIndex(1000,false);
+}
+
+TEST_CASE("Lookup in index with complete tree")
+{
+  CheckIndex(1023,true);
+}
+
+TEST_CASE("Lookup in small and empty index")
+{
+  CheckIndex(1,true);
+  CheckIndex(2,false);
+  CheckIndex(0,true);
+}
+
+TEST_CASE("Index with different id size is rejected")
+{
+  WriteRecords(10);
+  GenerateIndex();
+
+  osmscout::EytzingerIndex<uint32_t> index(INDEX_FILE);
+
+  REQUIRE_FALSE(index.Open(".",false));
+
+  osmscout::RemoveFile(DATA_FILE);
+  osmscout::RemoveFile(INDEX_FILE);
+}
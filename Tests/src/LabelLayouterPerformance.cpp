@@ -0,0 +1,210 @@
+/*
+  LabelLayouterPerformance - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <osmscout/LabelLayouter.h>
+#include <osmscout/MapParameter.h>
+
+#include <osmscout/util/Projection.h>
+#include <osmscout/util/StopClock.h>
+
+#include <TestTextLayouter.h>
+
+/**
+  Measures LabelLayouter::Layout() for a growing number of random point and
+  contour labels on a screen and on a high DPI screen. The text layouter uses
+  fixed glyph metrics, so only the collision handling is measured and not the
+  font backend.
+*/
+
+using TestLabelLayouter = osmscout::LabelLayouter<TestGlyph,TestLabel,TestTextLayouter>;
+
+static const size_t ITERATIONS=5; // Number of measurements per label count, minimum is reported
+
+struct Scene
+{
+  size_t width;
+  size_t height;
+  double dpi;
+};
+
+struct Result
+{
+  double milliseconds;
+  size_t labels;
+  size_t contourLabels;
+};
+
+static std::string RandomText(std::mt19937& gen)
+{
+  std::uniform_int_distribution<size_t> lengthDis(4,20);
+  std::uniform_int_distribution<int>    charDis('a','z');
+  std::string                           text(lengthDis(gen),' ');
+
+  for (auto& c : text) {
+    c=(char)charDis(gen);
+  }
+
+  return text;
+}
+
+static void RegisterLabels(TestLabelLayouter& layouter,
+                           const osmscout::Projection& projection,
+                           const osmscout::MapParameter& parameter,
+                           const Scene& scene,
+                           size_t labelCount)
+{
+  std::mt19937                           gen(labelCount);
+  std::uniform_real_distribution<double> xDis(0.0,(double)scene.width);
+  std::uniform_real_distribution<double> yDis(0.0,(double)scene.height);
+  std::uniform_real_distribution<double> angleDis(0.0,2*M_PI);
+  std::uniform_int_distribution<size_t>  priorityDis(1,100);
+  std::uniform_int_distribution<size_t>  typeDis(0,3);
+  double                                 scale=scene.dpi/96.0;
+
+  osmscout::LabelStyleRef    labelStyle=std::make_shared<osmscout::TextStyle>();
+  osmscout::PathTextStyleRef pathTextStyle=std::make_shared<osmscout::PathTextStyle>();
+
+  pathTextStyle->SetSize(scale);
+
+  for (size_t i=0; i<labelCount; i++) {
+    osmscout::Vertex2D point(xDis(gen),yDis(gen));
+
+    // every fourth label is a contour label along a slightly bent path
+    if (typeDis(gen)==0) {
+      osmscout::PathLabelData data;
+      osmscout::LabelPath     path;
+      double                  angle=angleDis(gen);
+      double                  x=point.GetX();
+      double                  y=point.GetY();
+
+      data.priority=priorityDis(gen);
+      data.text=RandomText(gen);
+      data.style=pathTextStyle;
+      data.contourLabelOffset=5*scale;
+      data.contourLabelSpace=100*scale;
+
+      path.AddPoint(x,y);
+      for (size_t s=0; s<4; s++) {
+        x+=std::cos(angle)*50*scale;
+        y+=std::sin(angle)*50*scale;
+        angle+=0.2;
+        path.AddPoint(x,y);
+      }
+
+      layouter.RegisterContourLabel(projection,
+                                    parameter,
+                                    data,
+                                    path);
+      continue;
+    }
+
+    std::vector<osmscout::LabelData> data;
+
+    // every third point label has an icon above the text
+    if (i%3==0) {
+      osmscout::LabelData icon;
+
+      icon.type=osmscout::LabelData::Icon;
+      icon.priority=priorityDis(gen);
+      icon.iconWidth=14*scale;
+      icon.iconHeight=14*scale;
+      data.push_back(icon);
+    }
+
+    osmscout::LabelData text;
+
+    text.type=osmscout::LabelData::Text;
+    text.priority=priorityDis(gen);
+    text.fontSize=scale;
+    text.style=labelStyle;
+    text.text=RandomText(gen);
+    data.push_back(text);
+
+    layouter.RegisterLabel(projection,
+                           parameter,
+                           point,
+                           data);
+  }
+}
+
+static Result Measure(const Scene& scene,
+                      size_t labelCount)
+{
+  osmscout::MercatorProjection projection;
+  osmscout::MapParameter       parameter;
+  TestTextLayouter             textLayouter;
+  TestLabelLayouter            layouter(&textLayouter);
+  Result                       result{std::numeric_limits<double>::max(),0,0};
+
+  projection.Set(osmscout::GeoCoord(51.0,7.0),
+                 osmscout::Magnification(osmscout::MagnificationLevel(16)),
+                 scene.dpi,
+                 scene.width,
+                 scene.height);
+
+  layouter.SetViewport(osmscout::DoubleRectangle(0,0,scene.width,scene.height));
+  layouter.SetLayoutOverlap(0);
+
+  for (size_t i=0; i<ITERATIONS; i++) {
+    layouter.Reset();
+    RegisterLabels(layouter,projection,parameter,scene,labelCount);
+
+    osmscout::StopClock timer;
+
+    layouter.Layout(projection,parameter);
+
+    timer.Stop();
+
+    result.milliseconds=std::min(result.milliseconds,timer.GetMilliseconds());
+    result.labels=layouter.Labels().size();
+    result.contourLabels=layouter.ContourLabels().size();
+  }
+
+  return result;
+}
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  std::vector<Scene>  scenes={{1920,1080,96.0},{3840,2160,192.0}};
+  std::vector<size_t> labelCounts={1000,2500,5000,10000,25000,50000};
+
+  for (const auto& scene : scenes) {
+    std::cout << "Viewport " << scene.width << "x" << scene.height << " @ " << scene.dpi << " DPI" << std::endl;
+    std::cout << std::setw(10) << "labels" << std::setw(10) << "placed" << std::setw(10) << "contour" << std::setw(12) << "layout ms" << std::endl;
+
+    for (auto labelCount : labelCounts) {
+      Result result=Measure(scene,labelCount);
+
+      std::cout << std::setw(10) << labelCount;
+      std::cout << std::setw(10) << result.labels;
+      std::cout << std::setw(10) << result.contourLabels;
+      std::cout << std::setw(12) << std::fixed << std::setprecision(2) << result.milliseconds << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,199 @@
+/*
+  LabelLayouterTest - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <string>
+#include <vector>
+
+#include <osmscout/LabelLayouter.h>
+#include <osmscout/MapParameter.h>
+
+#include <osmscout/util/Projection.h>
+
+#include <TestTextLayouter.h>
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+using TestLabelLayouter = osmscout::LabelLayouter<TestGlyph,TestLabel,TestTextLayouter>;
+
+class LayouterFixture
+{
+public:
+  osmscout::MercatorProjection projection;
+  osmscout::MapParameter       parameter;
+  TestTextLayouter             textLayouter;
+  TestLabelLayouter            layouter;
+
+public:
+  LayouterFixture():
+    layouter(&textLayouter)
+  {
+    projection.Set(osmscout::GeoCoord(51.0,7.0),
+                   osmscout::Magnification(osmscout::MagnificationLevel(16)),
+                   96.0,
+                   640,
+                   480);
+
+    parameter.SetLabelPadding(0.0);
+    parameter.SetIconPadding(0.0);
+    parameter.SetContourLabelPadding(0.0);
+
+    layouter.SetViewport(osmscout::DoubleRectangle(0,0,640,480));
+    layouter.SetLayoutOverlap(0);
+  }
+
+  void AddLabel(double x, double y,
+                size_t priority,
+                const std::string& text,
+                bool withIcon=false)
+  {
+    std::vector<osmscout::LabelData> data;
+
+    if (withIcon) {
+      osmscout::LabelData icon;
+
+      icon.type=osmscout::LabelData::Icon;
+      icon.iconWidth=14;
+      icon.iconHeight=14;
+      data.push_back(icon);
+    }
+
+    osmscout::LabelData label;
+
+    label.type=osmscout::LabelData::Text;
+    label.priority=priority;
+    label.fontSize=1.0;
+    label.style=std::make_shared<osmscout::TextStyle>();
+    label.text=text;
+    data.push_back(label);
+
+    layouter.RegisterLabel(projection,parameter,osmscout::Vertex2D(x,y),data);
+  }
+
+  void AddContourLabel(double x1, double y1,
+                       double x2, double y2,
+                       size_t priority,
+                       const std::string& text)
+  {
+    osmscout::PathLabelData data;
+    osmscout::LabelPath     path;
+
+    data.priority=priority;
+    data.text=text;
+    data.style=std::make_shared<osmscout::PathTextStyle>();
+    data.contourLabelOffset=0.0;
+    data.contourLabelSpace=1000.0;
+
+    path.AddPoint(x1,y1);
+    path.AddPoint(x2,y2);
+
+    layouter.RegisterContourLabel(projection,parameter,data,path);
+  }
+
+  std::vector<std::string> PlacedTexts()
+  {
+    std::vector<std::string> result;
+
+    for (const auto& instance : layouter.Labels()) {
+      for (const auto& element : instance.elements) {
+        if (element.labelData.type==osmscout::LabelData::Text) {
+          result.push_back(element.labelData.text);
+        }
+      }
+    }
+
+    return result;
+  }
+};
+
+TEST_CASE("Overlapping label with lower priority is dropped")
+{
+  LayouterFixture fixture;
+
+  fixture.AddLabel(100,100,2,"second");
+  fixture.AddLabel(110,104,1,"first");
+  fixture.layouter.Layout(fixture.projection,fixture.parameter);
+
+  REQUIRE(fixture.PlacedTexts()==std::vector<std::string>{"first"});
+}
+
+TEST_CASE("Separate labels are all placed")
+{
+  LayouterFixture fixture;
+
+  fixture.AddLabel(100,100,1,"first");
+  fixture.AddLabel(100,200,1,"second");
+  fixture.AddLabel(300,100,2,"third");
+  fixture.layouter.Layout(fixture.projection,fixture.parameter);
+
+  REQUIRE(fixture.PlacedTexts().size()==3);
+}
+
+TEST_CASE("Elements of one label do not collide with each other")
+{
+  LayouterFixture fixture;
+
+  fixture.AddLabel(100,100,1,"label",true);
+  fixture.layouter.Layout(fixture.projection,fixture.parameter);
+
+  REQUIRE(fixture.layouter.Labels().size()==1);
+  REQUIRE(fixture.layouter.Labels().front().elements.size()==2);
+}
+
+TEST_CASE("Contour label crossing a placed label is dropped")
+{
+  LayouterFixture fixture;
+
+  fixture.AddLabel(200,200,1,"label");
+  fixture.AddContourLabel(170,200,270,200,2,"crossing");
+  fixture.AddContourLabel(170,300,270,300,2,"free");
+  fixture.layouter.Layout(fixture.projection,fixture.parameter);
+
+  REQUIRE(fixture.PlacedTexts().size()==1);
+  REQUIRE(fixture.layouter.ContourLabels().size()==1);
+  REQUIRE(fixture.layouter.ContourLabels().front().glyphs.front().position.GetY()>250);
+}
+
+TEST_CASE("Rotated glyphs of parallel contour labels do not collide")
+{
+  LayouterFixture fixture;
+
+  // Two diagonal paths with a distance of 16 pixels. The glyphs are 12 pixels
+  // high, so the rotated glyphs are disjunct while their axis aligned bounding
+  // boxes overlap.
+  double offset=16.0/std::sqrt(2.0);
+
+  fixture.AddContourLabel(100,100,200,200,1,"abcdef");
+  fixture.AddContourLabel(100+offset,100-offset,200+offset,200-offset,2,"ghijkl");
+  fixture.layouter.Layout(fixture.projection,fixture.parameter);
+
+  REQUIRE(fixture.layouter.ContourLabels().size()==2);
+}
+
+TEST_CASE("Rotated glyphs of crossing contour labels collide")
+{
+  LayouterFixture fixture;
+
+  fixture.AddContourLabel(100,100,200,200,1,"abcdefghijklmn");
+  fixture.AddContourLabel(100,200,200,100,2,"opqrstuvwxyzab");
+  fixture.layouter.Layout(fixture.projection,fixture.parameter);
+
+  REQUIRE(fixture.layouter.ContourLabels().size()==1);
+  REQUIRE(fixture.layouter.ContourLabels().front().priority==1);
+}
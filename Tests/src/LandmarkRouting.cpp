@@ -0,0 +1,171 @@
+/*
+  LandmarkRouting - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <osmscout/Database.h>
+
+#include <osmscout/routing/RoutingProfile.h>
+#include <osmscout/routing/SimpleRoutingService.h>
+
+#include "GridDatabase.h"
+#include "RouteCosts.h"
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+static const MixedGridDatabase grid(25,0.002);
+
+static const std::map<std::string,double> IMPORT_SPEED_TABLE{{"highway_primary",70.0},
+                                                             {"highway_residential",40.0}};
+
+osmscout::DatabaseRef             database;
+osmscout::SimpleRoutingServiceRef router;
+
+/**
+ * Compare the costs of the routes with and without the ALT heuristic
+ * between pairs of positions
+ */
+static void CheckRouteCosts(const osmscout::RoutingProfileRef& profile,
+                            bool bidirectional)
+{
+  std::vector<osmscout::GeoCoord> positions=grid.GetRandomCoords(30,1234);
+  osmscout::RoutingParameter      parameter;
+  osmscout::RoutingParameter      landmarkParameter;
+
+  parameter.SetUseLandmarks(false);
+  parameter.SetBidirectional(bidirectional);
+  landmarkParameter.SetUseLandmarks(true);
+  landmarkParameter.SetBidirectional(bidirectional);
+
+  for (size_t i=0; i+1<positions.size(); i++) {
+    osmscout::RoutePosition start=router->GetClosestRoutableNode(positions[i],
+                                                                 *profile,
+                                                                 osmscout::Distance::Of<osmscout::Kilometer>(1));
+    osmscout::RoutePosition target=router->GetClosestRoutableNode(positions[i+1],
+                                                                  *profile,
+                                                                  osmscout::Distance::Of<osmscout::Kilometer>(1));
+
+    REQUIRE(start.IsValid());
+    REQUIRE(target.IsValid());
+
+    osmscout::RoutingResult expected=router->CalculateRoute(*profile,
+                                                            start,
+                                                            target,
+                                                            parameter);
+    osmscout::RoutingResult actual=router->CalculateRoute(*profile,
+                                                          start,
+                                                          target,
+                                                          landmarkParameter);
+
+    REQUIRE(expected.Success());
+    REQUIRE(actual.Success());
+
+    double expectedCosts=GetRouteCosts(database,*profile,expected.GetRoute());
+    double actualCosts=GetRouteCosts(database,*profile,actual.GetRoute());
+
+    INFO("Route " << i);
+    REQUIRE(expectedCosts>0.0);
+    REQUIRE(actualCosts==Approx(expectedCosts).epsilon(ROUTE_COSTS_EPSILON));
+  }
+}
+
+static osmscout::FastestPathRoutingProfileRef GetCarProfile(const std::map<std::string,double>& speedTable,
+                                                            double maxSpeed)
+{
+  osmscout::FastestPathRoutingProfileRef profile=std::make_shared<osmscout::FastestPathRoutingProfile>(database->GetTypeConfig());
+
+  profile->ParametrizeForCar(*database->GetTypeConfig(),
+                             speedTable,
+                             maxSpeed);
+
+  return profile;
+}
+
+TEST_CASE("ALT routes have the costs of the A* routes")
+{
+  REQUIRE(router->HasLandmarks(osmscout::vehicleCar));
+  REQUIRE(router->HasRoutePredecessors());
+
+  for (bool bidirectional : {false,true}) {
+    CheckRouteCosts(GetCarProfile(IMPORT_SPEED_TABLE,160.0),
+                    bidirectional);
+  }
+}
+
+TEST_CASE("ALT routes with other speeds than the import have the costs of the A* routes")
+{
+  for (bool bidirectional : {false,true}) {
+    CheckRouteCosts(GetCarProfile({{"highway_primary",100.0},
+                                   {"highway_residential",20.0}},
+                                  160.0),
+                    bidirectional);
+    CheckRouteCosts(GetCarProfile(IMPORT_SPEED_TABLE,
+                                  30.0),
+                    bidirectional);
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  osmscout::ImportParameter importParameter;
+
+  importParameter.AddRouter(osmscout::ImportParameter::Router(osmscout::vehicleCar,
+                                                              osmscout::RoutingService::DEFAULT_FILENAME_BASE));
+  importParameter.SetRouterLandmarks(4);
+  importParameter.SetRouterPredecessors(true);
+  importParameter.SetRouterCarSpeedTable(IMPORT_SPEED_TABLE);
+
+  int importResult=grid.Import(importParameter);
+
+  if (importResult!=0) {
+    return importResult;
+  }
+
+  osmscout::DatabaseParameter dbParameter;
+
+  database=std::make_shared<osmscout::Database>(dbParameter);
+
+  if (!database->Open(".")) {
+    std::cerr << "Cannot open database" << std::endl;
+    return 1;
+  }
+
+  router=std::make_shared<osmscout::SimpleRoutingService>(database,
+                                                          osmscout::RouterParameter(),
+                                                          osmscout::RoutingService::DEFAULT_FILENAME_BASE);
+
+  if (!router->Open()) {
+    std::cerr << "Cannot open routing database" << std::endl;
+    return 1;
+  }
+
+  int result=Catch::Session().run(argc,argv);
+
+  router->Close();
+  router.reset();
+  database->Close();
+  database.reset();
+
+  return result;
+}
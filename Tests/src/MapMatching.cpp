@@ -0,0 +1,346 @@
+/*
+  MapMatching - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <cmath>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <osmscout/Database.h>
+
+#include <osmscout/routing/SimpleRoutingService.h>
+
+#include <osmscout/gpx/MapMatcher.h>
+
+#include <osmscout/util/Geometry.h>
+#include <osmscout/util/StopClock.h>
+
+#include "GridDatabase.h"
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+// A dense grid of residential streets (about 40m x 65m), so that there are multiple
+// candidates within the GPS noise for most track points
+static const GridDatabase grid(30,0.0006);
+
+static const double NOISE_SIGMA=10.0;              // Standard deviation of the GPS noise in meters
+static const double SAMPLE_DISTANCE=8.0;           // Distance of the track points in meters
+static const double JUNCTION_RADIUS=2*NOISE_SIGMA; // Distance to a junction, where both streets are a correct match
+
+/**
+ * Position on the path, the track point is sampled from
+ */
+struct TruthPoint
+{
+  osmscout::GeoCoord coord;
+  osmscout::GeoCoord junction;     // closest junction on the path
+  bool               nearJunction; // the crossing street is a correct match, too
+};
+
+osmscout::DatabaseRef             database;
+osmscout::SimpleRoutingServiceRef router;
+
+/**
+ * Deterministic random walk over the junctions of the grid, without u-turns
+ */
+static std::vector<osmscout::GeoCoord> GetTrackPath(std::mt19937& random,
+                                                    size_t segments)
+{
+  std::vector<osmscout::GeoCoord> path;
+  int                             row=grid.size/2;
+  int                             column=grid.size/2;
+  int                             rowDirection=0;
+  int                             columnDirection=1;
+
+  path.push_back(grid.GetCoord(row,column));
+
+  while (path.size()<=segments) {
+    int turn=random()%4;
+
+    if (turn==1) {
+      std::swap(rowDirection,columnDirection);
+      rowDirection=-rowDirection;
+    }
+    else if (turn==2) {
+      std::swap(rowDirection,columnDirection);
+      columnDirection=-columnDirection;
+    }
+
+    int nextRow=row+rowDirection;
+    int nextColumn=column+columnDirection;
+
+    if (nextRow<2 || nextRow>=(int)grid.size-2 ||
+        nextColumn<2 || nextColumn>=(int)grid.size-2) {
+      // Turn around at the border of the grid, without driving back
+      std::swap(rowDirection,columnDirection);
+      continue;
+    }
+
+    row=nextRow;
+    column=nextColumn;
+
+    path.push_back(grid.GetCoord(row,column));
+  }
+
+  return path;
+}
+
+static double GetNormalDistributed(std::mt19937& random)
+{
+  double u1=(random()+0.5)/4294967296.0;
+  double u2=(random()+0.5)/4294967296.0;
+
+  return std::sqrt(-2.0*std::log(u1))*std::cos(2.0*M_PI*u2);
+}
+
+/**
+ * Sample points along the path and add gaussian noise
+ */
+static void GetTrack(std::mt19937& random,
+                     const std::vector<osmscout::GeoCoord>& path,
+                     std::vector<TruthPoint>& truth,
+                     std::vector<osmscout::gpx::TrackPoint>& track)
+{
+  double metersPerLat=osmscout::GetEllipsoidalDistance(osmscout::GeoCoord(grid.lat,grid.lon),
+                                                       osmscout::GeoCoord(grid.lat+0.01,grid.lon)).As<osmscout::Meter>()/0.01;
+  double metersPerLon=osmscout::GetEllipsoidalDistance(osmscout::GeoCoord(grid.lat,grid.lon),
+                                                       osmscout::GeoCoord(grid.lat,grid.lon+0.01)).As<osmscout::Meter>()/0.01;
+  double offset=0.0;
+
+  for (size_t i=1; i<path.size(); i++) {
+    double length=osmscout::GetEllipsoidalDistance(path[i-1],path[i]).As<osmscout::Meter>();
+
+    for (; offset<length; offset+=SAMPLE_DISTANCE) {
+      double     fraction=offset/length;
+      TruthPoint point;
+
+      point.coord=osmscout::GeoCoord(path[i-1].GetLat()+(path[i].GetLat()-path[i-1].GetLat())*fraction,
+                                     path[i-1].GetLon()+(path[i].GetLon()-path[i-1].GetLon())*fraction);
+      point.junction=fraction<0.5 ? path[i-1] : path[i];
+      point.nearJunction=std::min(offset,length-offset)<JUNCTION_RADIUS;
+
+      double latNoise=GetNormalDistributed(random)*NOISE_SIGMA/metersPerLat;
+      double lonNoise=GetNormalDistributed(random)*NOISE_SIGMA/metersPerLon;
+
+      track.emplace_back(osmscout::GeoCoord(point.coord.GetLat()+latNoise,
+                                            point.coord.GetLon()+lonNoise));
+      truth.push_back(point);
+    }
+
+    offset-=length;
+  }
+}
+
+/**
+ * Return true, if the coordinate is on the (straight) street. Node coordinates
+ * are stored with limited precision, so compare with a tolerance.
+ */
+static bool IsOnStreet(const osmscout::ObjectFileRef& object,
+                       const osmscout::GeoCoord& coord)
+{
+  osmscout::WayRef way;
+
+  REQUIRE(database->GetWayByOffset(object.GetFileOffset(),way));
+
+  osmscout::GeoCoord first=way->nodes.front().GetCoord();
+  osmscout::GeoCoord last=way->nodes.back().GetCoord();
+
+  if (first.GetLat()==last.GetLat()) {
+    return std::fabs(coord.GetLat()-first.GetLat())<grid.spacing/4;
+  }
+
+  return std::fabs(coord.GetLon()-first.GetLon())<grid.spacing/4;
+}
+
+static bool IsCorrectMatch(const osmscout::ObjectFileRef& object,
+                           const TruthPoint& truth)
+{
+  return IsOnStreet(object,truth.coord) ||
+         (truth.nearJunction && IsOnStreet(object,truth.junction));
+}
+
+static double GetRouteLength(const osmscout::RouteData& route)
+{
+  std::list<osmscout::Point> points;
+  double                     length=0.0;
+
+  REQUIRE(router->TransformRouteDataToPoints(route,points));
+
+  for (auto current=points.begin(), previous=points.end(); current!=points.end(); previous=current++) {
+    if (previous!=points.end()) {
+      length+=osmscout::GetEllipsoidalDistance(previous->GetCoord(),current->GetCoord()).As<osmscout::Meter>();
+    }
+  }
+
+  return length;
+}
+
+TEST_CASE("Noisy track is matched to the streets it was sampled from")
+{
+  std::mt19937                           random(4711);
+  std::vector<osmscout::GeoCoord>        path=GetTrackPath(random,120);
+  std::vector<TruthPoint>                truth;
+  std::vector<osmscout::gpx::TrackPoint> track;
+  osmscout::gpx::MapMatchingParameter    parameter;
+  osmscout::gpx::MapMatchingResult       result;
+
+  GetTrack(random,path,truth,track);
+
+  parameter.SetMeasurementSigma(osmscout::Distance::Of<osmscout::Meter>(NOISE_SIGMA));
+
+  osmscout::StopClock clock;
+
+  REQUIRE(osmscout::gpx::MatchTrack(router,
+                                    osmscout::vehicleCar,
+                                    track,
+                                    parameter,
+                                    result));
+
+  clock.Stop();
+
+  REQUIRE(result.points.size()==track.size());
+
+  size_t matchedCorrect=0;
+  size_t closestCorrect=0;
+
+  for (size_t i=0; i<track.size(); i++) {
+    const osmscout::gpx::MatchedPoint& point=result.points[i];
+
+    REQUIRE(point.matched);
+    REQUIRE(point.confidence>=0.0);
+    REQUIRE(point.confidence<=1.0+1e-9);
+
+    if (IsCorrectMatch(point.object,truth[i])) {
+      matchedCorrect++;
+    }
+
+    // Compare with simply taking the closest street
+    osmscout::ClosestRoutableObjectResult closest=router->GetClosestRoutableObject(track[i].coord,
+                                                                                  osmscout::vehicleCar,
+                                                                                  parameter.GetSearchRadius());
+
+    if (closest.GetWay() &&
+        IsCorrectMatch(closest.GetObject(),truth[i])) {
+      closestCorrect++;
+    }
+  }
+
+  double accuracy=matchedCorrect/(double)track.size();
+  double closestAccuracy=closestCorrect/(double)track.size();
+
+  std::cout << track.size() << " points matched in " << clock << ", accuracy " << accuracy*100 << "%"
+            << " (closest way: " << closestAccuracy*100 << "%)" << std::endl;
+
+  REQUIRE(accuracy>=0.95);
+  REQUIRE(accuracy>closestAccuracy);
+
+  // The matched route follows the track
+  double pathLength=0.0;
+
+  for (size_t i=1; i<path.size(); i++) {
+    pathLength+=osmscout::GetEllipsoidalDistance(path[i-1],path[i]).As<osmscout::Meter>();
+  }
+
+  REQUIRE(result.routes.size()==1);
+
+  double routeLength=GetRouteLength(result.routes.front());
+
+  REQUIRE(routeLength>pathLength*0.95);
+  REQUIRE(routeLength<pathLength*1.05);
+}
+
+TEST_CASE("Points outside of the road network are not matched")
+{
+  std::mt19937                           random(815);
+  std::vector<osmscout::GeoCoord>        path=GetTrackPath(random,10);
+  std::vector<TruthPoint>                truth;
+  std::vector<osmscout::gpx::TrackPoint> track;
+  osmscout::gpx::MapMatchingParameter    parameter;
+  osmscout::gpx::MapMatchingResult       result;
+
+  GetTrack(random,path,truth,track);
+
+  // An outlier far away from the grid does not break the route
+  size_t outlier=track.size()/2;
+
+  track.insert(track.begin()+outlier,
+               osmscout::gpx::TrackPoint(osmscout::GeoCoord(grid.lat-0.1,grid.lon-0.1)));
+
+  parameter.SetWindowSize(5);
+
+  REQUIRE(osmscout::gpx::MatchTrack(router,
+                                    osmscout::vehicleCar,
+                                    track,
+                                    parameter,
+                                    result));
+
+  REQUIRE(result.points.size()==track.size());
+
+  for (size_t i=0; i<track.size(); i++) {
+    REQUIRE(result.points[i].matched==(i!=outlier));
+  }
+
+  REQUIRE(result.routes.size()==1);
+}
+
+int main(int argc, char* argv[])
+{
+  osmscout::ImportParameter importParameter;
+
+  importParameter.AddRouter(osmscout::ImportParameter::Router(osmscout::vehicleBicycle|osmscout::vehicleFoot|osmscout::vehicleCar,
+                                                              osmscout::RoutingService::DEFAULT_FILENAME_BASE));
+  importParameter.SetRouterGraph(true);
+
+  int importResult=grid.Import(importParameter);
+
+  if (importResult!=0) {
+    return importResult;
+  }
+
+  osmscout::DatabaseParameter dbParameter;
+
+  database=std::make_shared<osmscout::Database>(dbParameter);
+
+  if (!database->Open(".")) {
+    std::cerr << "Cannot open database" << std::endl;
+    return 1;
+  }
+
+  router=std::make_shared<osmscout::SimpleRoutingService>(database,
+                                                          osmscout::RouterParameter(),
+                                                          osmscout::RoutingService::DEFAULT_FILENAME_BASE);
+
+  if (!router->Open()) {
+    std::cerr << "Cannot open routing database" << std::endl;
+    return 1;
+  }
+
+  int result=Catch::Session().run(argc,argv);
+
+  router->Close();
+  router.reset();
+  database->Close();
+  database.reset();
+
+  return result;
+}
@@ -0,0 +1,547 @@
+/*
+  MapPainterMVT - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <osmscout/MapPainterMVT.h>
+
+#include <osmscout/TypeFeatures.h>
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+static osmscout::TypeConfigRef  typeConfig;
+static osmscout::StyleConfigRef styleConfig;
+
+typedef std::vector<std::pair<int32_t,int32_t>> DecodedPath;
+
+struct DecodedFeature
+{
+  uint32_t                          type=0;
+  std::map<std::string,std::string> attributes;
+  std::vector<DecodedPath>          paths;
+};
+
+struct DecodedLayer
+{
+  uint32_t                    version=0;
+  uint32_t                    extent=0;
+  std::vector<DecodedFeature> features;
+};
+
+/**
+ * Minimal protobuf reader for decoding the tiles
+ */
+class Reader
+{
+private:
+  const unsigned char* pos;
+  const unsigned char* end;
+
+public:
+  Reader(const char* data,
+         size_t size)
+  : pos(reinterpret_cast<const unsigned char*>(data)),
+    end(reinterpret_cast<const unsigned char*>(data)+size)
+  {
+    // no code
+  }
+
+  bool HasData() const
+  {
+    return pos<end;
+  }
+
+  uint64_t ReadVarint()
+  {
+    uint64_t value=0;
+    size_t   shift=0;
+
+    REQUIRE(pos<end);
+
+    while (*pos & 0x80) {
+      value|=(uint64_t)(*pos & 0x7f) << shift;
+      shift+=7;
+      pos++;
+      REQUIRE(pos<end);
+    }
+
+    value|=(uint64_t)*pos << shift;
+    pos++;
+
+    return value;
+  }
+
+  Reader ReadMessage()
+  {
+    size_t size=(size_t)ReadVarint();
+
+    REQUIRE(pos+size<=end);
+
+    Reader message(reinterpret_cast<const char*>(pos),size);
+
+    pos+=size;
+
+    return message;
+  }
+
+  std::string ReadString()
+  {
+    Reader message=ReadMessage();
+
+    return std::string(reinterpret_cast<const char*>(message.pos),message.end-message.pos);
+  }
+};
+
+static int32_t UnZigZag(uint32_t value)
+{
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static DecodedFeature DecodeFeature(Reader reader,
+                                    const std::vector<std::string>& keys,
+                                    const std::vector<std::string>& values)
+{
+  DecodedFeature        feature;
+  std::vector<uint32_t> tags;
+  std::vector<uint32_t> geometry;
+
+  while (reader.HasData()) {
+    uint64_t key=reader.ReadVarint();
+
+    switch (key >> 3) {
+    case 2: {
+      Reader packed=reader.ReadMessage();
+      while (packed.HasData()) {
+        tags.push_back((uint32_t)packed.ReadVarint());
+      }
+      break;
+    }
+    case 3:
+      feature.type=(uint32_t)reader.ReadVarint();
+      break;
+    case 4: {
+      Reader packed=reader.ReadMessage();
+      while (packed.HasData()) {
+        geometry.push_back((uint32_t)packed.ReadVarint());
+      }
+      break;
+    }
+    default:
+      REQUIRE((key & 0x7)==0);
+      reader.ReadVarint();
+    }
+  }
+
+  REQUIRE(tags.size()%2==0);
+
+  for (size_t i=0; i<tags.size(); i+=2) {
+    REQUIRE(tags[i]<keys.size());
+    REQUIRE(tags[i+1]<values.size());
+    feature.attributes[keys[tags[i]]]=values[tags[i+1]];
+  }
+
+  int32_t x=0;
+  int32_t y=0;
+  size_t  i=0;
+
+  while (i<geometry.size()) {
+    uint32_t command=geometry[i] & 0x7;
+    uint32_t count=geometry[i] >> 3;
+
+    i++;
+
+    if (command==7) {
+      REQUIRE(count==1);
+      REQUIRE(!feature.paths.empty());
+      continue;
+    }
+
+    REQUIRE((command==1 || command==2));
+    REQUIRE(i+2*count<=geometry.size());
+
+    for (uint32_t c=0; c<count; c++) {
+      x+=UnZigZag(geometry[i++]);
+      y+=UnZigZag(geometry[i++]);
+
+      if (command==1) {
+        feature.paths.emplace_back();
+      }
+
+      REQUIRE(!feature.paths.empty());
+      feature.paths.back().emplace_back(x,y);
+    }
+  }
+
+  return feature;
+}
+
+static std::map<std::string,DecodedLayer> DecodeTile(const std::vector<char>& data)
+{
+  std::map<std::string,DecodedLayer> layers;
+  Reader                             tile(data.data(),data.size());
+
+  while (tile.HasData()) {
+    REQUIRE(tile.ReadVarint()==((3 << 3) | 2));
+
+    Reader                   reader=tile.ReadMessage();
+    DecodedLayer             layer;
+    std::string              name;
+    std::vector<Reader>      features;
+    std::vector<std::string> keys;
+    std::vector<std::string> values;
+
+    while (reader.HasData()) {
+      uint64_t key=reader.ReadVarint();
+
+      switch (key >> 3) {
+      case 1:
+        name=reader.ReadString();
+        break;
+      case 2:
+        features.push_back(reader.ReadMessage());
+        break;
+      case 3:
+        keys.push_back(reader.ReadString());
+        break;
+      case 4: {
+        Reader value=reader.ReadMessage();
+        uint64_t valueKey=value.ReadVarint();
+
+        if (valueKey==((1 << 3) | 2)) {
+          values.push_back(value.ReadString());
+        }
+        else {
+          REQUIRE(valueKey==(7 << 3));
+          values.push_back(value.ReadVarint()!=0 ? "true" : "false");
+        }
+        break;
+      }
+      case 5:
+        layer.extent=(uint32_t)reader.ReadVarint();
+        break;
+      case 15:
+        layer.version=(uint32_t)reader.ReadVarint();
+        break;
+      default:
+        FAIL("Unexpected layer field");
+      }
+    }
+
+    for (const auto& feature : features) {
+      layer.features.push_back(DecodeFeature(feature,keys,values));
+    }
+
+    REQUIRE(!name.empty());
+    REQUIRE(layers.find(name)==layers.end());
+    layers[name]=layer;
+  }
+
+  return layers;
+}
+
+static int64_t GetArea(const DecodedPath& ring)
+{
+  int64_t area=0;
+
+  for (size_t i=0; i<ring.size(); i++) {
+    const auto& a=ring[i];
+    const auto& b=ring[(i+1)%ring.size()];
+
+    area+=(int64_t)a.first*b.second-(int64_t)b.first*a.second;
+  }
+
+  return area;
+}
+
+static osmscout::FeatureValueBuffer CreateNamedBuffer(const std::string& typeName,
+                                                      const std::string& name)
+{
+  osmscout::TypeInfoRef        type=typeConfig->GetTypeInfo(typeName);
+  osmscout::FeatureValueBuffer buffer;
+  size_t                       nameIndex;
+
+  REQUIRE(type);
+  REQUIRE(type->GetFeature(osmscout::NameFeature::NAME,nameIndex));
+
+  buffer.SetType(type);
+
+  osmscout::NameFeatureValue* value=static_cast<osmscout::NameFeatureValue*>(buffer.AllocateValue(nameIndex));
+
+  value->SetName(name);
+
+  return buffer;
+}
+
+static osmscout::WayRef CreateWay(const osmscout::GeoCoord& from,
+                                  const osmscout::GeoCoord& to,
+                                  const std::string& name)
+{
+  osmscout::WayRef way=std::make_shared<osmscout::Way>();
+
+  way->SetFeatures(CreateNamedBuffer("highway_residential",name));
+  way->nodes.emplace_back(0,from);
+  way->nodes.emplace_back(0,to);
+
+  return way;
+}
+
+static void AddRing(osmscout::Area& area,
+                    const osmscout::TypeInfoRef& type,
+                    uint8_t ring,
+                    const std::vector<osmscout::GeoCoord>& coords)
+{
+  osmscout::Area::Ring areaRing;
+
+  areaRing.SetType(type);
+  areaRing.SetRing(ring);
+
+  for (const auto& coord : coords) {
+    areaRing.nodes.emplace_back(0,coord);
+  }
+
+  area.rings.push_back(areaRing);
+}
+
+TEST_CASE("Geometry is clipped, oriented and attributed")
+{
+  osmscout::Magnification  magnification{osmscout::MagnificationLevel(16)};
+  osmscout::TileProjection projection;
+  osmscout::MapParameter   parameter;
+  osmscout::MapData        data;
+  osmscout::MapPainterMVT  painter(styleConfig);
+
+  REQUIRE(projection.Set(osmscout::OSMTileId::GetOSMTile(magnification,osmscout::GeoCoord(51.0,7.0)),
+                         magnification,
+                         96.0,
+                         256,
+                         256));
+
+  osmscout::GeoBox box=projection.GetDimensions();
+  double           top=box.GetMaxLat();
+  double           bottom=box.GetMinLat();
+  double           left=box.GetMinLon();
+  double           right=box.GetMaxLon();
+  double           width=right-left;
+  double           height=top-bottom;
+  double           centerLat=(top+bottom)/2;
+  double           centerLon=(left+right)/2;
+
+  // Crosses the whole tile
+  data.ways.push_back(CreateWay(osmscout::GeoCoord(centerLat,left-width),
+                                osmscout::GeoCoord(centerLat,right+width),
+                                "Main Street"));
+  // Completely outside
+  data.ways.push_back(CreateWay(osmscout::GeoCoord(top+height,left),
+                                osmscout::GeoCoord(top+height,right),
+                                "Far Street"));
+
+  osmscout::TypeInfoRef woodType=typeConfig->GetTypeInfo("wood");
+
+  REQUIRE(woodType);
+
+  // Reaches out of the top left corner, counter clockwise in tile coordinates
+  osmscout::AreaRef cornerArea=std::make_shared<osmscout::Area>();
+
+  AddRing(*cornerArea,woodType,osmscout::Area::outerRingId,{
+    osmscout::GeoCoord(top+height/2,left-width/2),
+    osmscout::GeoCoord(centerLat,left-width/2),
+    osmscout::GeoCoord(centerLat,centerLon),
+    osmscout::GeoCoord(top+height/2,centerLon)
+  });
+
+  data.areas.push_back(cornerArea);
+
+  // Inside the tile with a hole
+  osmscout::AreaRef holeArea=std::make_shared<osmscout::Area>();
+
+  AddRing(*holeArea,woodType,osmscout::Area::outerRingId,{
+    osmscout::GeoCoord(bottom+height/10,centerLon),
+    osmscout::GeoCoord(bottom+height/10,right-width/10),
+    osmscout::GeoCoord(centerLat-height/10,right-width/10),
+    osmscout::GeoCoord(centerLat-height/10,centerLon)
+  });
+  AddRing(*holeArea,typeConfig->typeInfoIgnore,osmscout::Area::outerRingId+1,{
+    osmscout::GeoCoord(bottom+height/5,centerLon+width/10),
+    osmscout::GeoCoord(centerLat-height/5,centerLon+width/10),
+    osmscout::GeoCoord(centerLat-height/5,right-width/5),
+    osmscout::GeoCoord(bottom+height/5,right-width/5)
+  });
+
+  data.areas.push_back(holeArea);
+
+  // Nodes inside and outside of the tile
+  osmscout::NodeRef insideNode=std::make_shared<osmscout::Node>();
+
+  insideNode->SetFeatures(CreateNamedBuffer("amenity_restaurant","Inside"));
+  insideNode->SetCoords(osmscout::GeoCoord(centerLat,centerLon));
+  data.nodes.push_back(insideNode);
+
+  osmscout::NodeRef outsideNode=std::make_shared<osmscout::Node>();
+
+  outsideNode->SetFeatures(CreateNamedBuffer("amenity_restaurant","Outside"));
+  outsideNode->SetCoords(osmscout::GeoCoord(centerLat,right+width));
+  data.nodes.push_back(outsideNode);
+
+  std::vector<char> tileData;
+
+  REQUIRE(painter.DrawMap(projection,
+                          parameter,
+                          data,
+                          tileData));
+
+  std::map<std::string,DecodedLayer> layers=DecodeTile(tileData);
+  int32_t                            min=-(int32_t)painter.GetBuffer();
+  int32_t                            max=(int32_t)(painter.GetExtent()+painter.GetBuffer());
+
+  REQUIRE(layers.size()==3);
+
+  for (const auto& layer : layers) {
+    REQUIRE(layer.second.version==2);
+    REQUIRE(layer.second.extent==painter.GetExtent());
+
+    for (const auto& feature : layer.second.features) {
+      for (const auto& path : feature.paths) {
+        for (const auto& point : path) {
+          REQUIRE(point.first>=min);
+          REQUIRE(point.first<=max);
+          REQUIRE(point.second>=min);
+          REQUIRE(point.second<=max);
+        }
+      }
+    }
+  }
+
+  const DecodedLayer& ways=layers["highway_residential"];
+
+  REQUIRE(ways.features.size()==1);
+  REQUIRE(ways.features[0].type==2);
+  REQUIRE(ways.features[0].attributes.at("Name")=="Main Street");
+  REQUIRE(ways.features[0].paths.size()==1);
+  REQUIRE(ways.features[0].paths[0].size()==2);
+  REQUIRE(ways.features[0].paths[0][0].first==min);
+  REQUIRE(ways.features[0].paths[0][1].first==max);
+  REQUIRE(std::abs(ways.features[0].paths[0][0].second-2048)<=1);
+
+  const DecodedLayer& areas=layers["wood"];
+
+  REQUIRE(areas.features.size()==2);
+
+  const DecodedFeature& corner=areas.features[0];
+
+  REQUIRE(corner.type==3);
+  REQUIRE(corner.paths.size()==1);
+  REQUIRE(GetArea(corner.paths[0])>0);
+  REQUIRE(corner.paths[0].front()!=corner.paths[0].back());
+
+  const DecodedFeature& hole=areas.features[1];
+
+  REQUIRE(hole.type==3);
+  REQUIRE(hole.paths.size()==2);
+  REQUIRE(GetArea(hole.paths[0])>0);
+  REQUIRE(GetArea(hole.paths[1])<0);
+
+  const DecodedLayer& nodes=layers["amenity_restaurant"];
+
+  REQUIRE(nodes.features.size()==1);
+  REQUIRE(nodes.features[0].type==1);
+  REQUIRE(nodes.features[0].attributes.at("Name")=="Inside");
+  REQUIRE(nodes.features[0].paths.size()==1);
+  REQUIRE(nodes.features[0].paths[0].size()==1);
+  REQUIRE(std::abs(nodes.features[0].paths[0][0].first-2048)<=1);
+  REQUIRE(std::abs(nodes.features[0].paths[0][0].second-2048)<=1);
+}
+
+TEST_CASE("Objects without style are not written")
+{
+  osmscout::Magnification  magnification{osmscout::MagnificationLevel(3)};
+  osmscout::TileProjection projection;
+  osmscout::MapParameter   parameter;
+  osmscout::MapData        data;
+  osmscout::MapPainterMVT  painter(styleConfig);
+
+  REQUIRE(projection.Set(osmscout::OSMTileId::GetOSMTile(magnification,osmscout::GeoCoord(51.0,7.0)),
+                         magnification,
+                         96.0,
+                         256,
+                         256));
+
+  // Residential streets and restaurants are not visible at this zoom level
+  data.ways.push_back(CreateWay(osmscout::GeoCoord(51.0,7.0),
+                                osmscout::GeoCoord(51.1,7.1),
+                                "Main Street"));
+
+  osmscout::NodeRef node=std::make_shared<osmscout::Node>();
+
+  node->SetFeatures(CreateNamedBuffer("amenity_restaurant","Restaurant"));
+  node->SetCoords(osmscout::GeoCoord(51.0,7.0));
+  data.nodes.push_back(node);
+
+  std::vector<char> tileData;
+
+  REQUIRE(painter.DrawMap(projection,
+                          parameter,
+                          data,
+                          tileData));
+  REQUIRE(tileData.empty());
+}
+
+int main(int argc, char* argv[])
+{
+  char* testsTopDirEnv=getenv("TESTS_TOP_DIR");
+
+  if (testsTopDirEnv==nullptr) {
+    std::cerr << "Expected environment variable 'TESTS_TOP_DIR' not set" << std::endl;
+    // CMake-based tests would fail, if we do not exit here
+    return 1;
+  }
+
+  std::string testsTopDir=testsTopDirEnv;
+
+  if (testsTopDir.empty()) {
+    std::cerr << "Environment variable 'TESTS_TOP_DIR' is empty" << std::endl;
+    return 77;
+  }
+
+  typeConfig=std::make_shared<osmscout::TypeConfig>();
+
+  if (!typeConfig->LoadFromOSTFile(testsTopDir+"/../stylesheets/map.ost")) {
+    std::cerr << "Cannot load type configuration" << std::endl;
+    return 1;
+  }
+
+  styleConfig=std::make_shared<osmscout::StyleConfig>(typeConfig);
+
+  if (!styleConfig->Load(testsTopDir+"/../stylesheets/standard.oss")) {
+    std::cerr << "Cannot load style sheet" << std::endl;
+    return 1;
+  }
+
+  int result=Catch::Session().run(argc,argv);
+
+  styleConfig=nullptr;
+  typeConfig=nullptr;
+
+  return result;
+}
@@ -0,0 +1,274 @@
+/*
+  MapPainterPrepare - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+
+#include <osmscout/MapPainterNoOp.h>
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+static const size_t GRID_SIZE=60; // Number of ways and areas in each direction
+
+static osmscout::TypeConfigRef  typeConfig;
+static osmscout::StyleConfigRef styleConfig;
+
+class TestPainter : public osmscout::MapPainterNoOp
+{
+public:
+  explicit TestPainter(const osmscout::StyleConfigRef& styleConfig);
+
+  void Prepare(const osmscout::Projection& projection,
+               const osmscout::MapParameter& parameter,
+               const osmscout::MapData& data);
+
+  osmscout::Vertex2D GetCoord(size_t index) const;
+
+  using MapPainter::GetWayData;
+  using MapPainter::GetAreaData;
+};
+
+TestPainter::TestPainter(const osmscout::StyleConfigRef& styleConfig):
+  MapPainterNoOp(styleConfig)
+{
+  // no code
+}
+
+void TestPainter::Prepare(const osmscout::Projection& projection,
+                          const osmscout::MapParameter& parameter,
+                          const osmscout::MapData& data)
+{
+  Draw(projection,
+       parameter,
+       data,
+       osmscout::RenderSteps::Initialize,
+       osmscout::RenderSteps::PreprocessData);
+}
+
+osmscout::Vertex2D TestPainter::GetCoord(size_t index) const
+{
+  return coordBuffer->buffer[index];
+}
+
+static osmscout::MapData CreateData(const osmscout::GeoCoord& center)
+{
+  osmscout::TypeInfoRef wayType=typeConfig->GetTypeInfo("highway_residential");
+  osmscout::TypeInfoRef areaType=typeConfig->GetTypeInfo("wood");
+  osmscout::MapData     data;
+  double                step=0.0003;
+  double                top=center.GetLat()+step*GRID_SIZE/2;
+  double                left=center.GetLon()-step*GRID_SIZE/2;
+
+  REQUIRE(wayType);
+  REQUIRE(areaType);
+
+  for (size_t row=0; row<GRID_SIZE; row++) {
+    for (size_t column=0; column<GRID_SIZE; column++) {
+      double lat=top-row*step;
+      double lon=left+column*step;
+
+      osmscout::WayRef way=std::make_shared<osmscout::Way>();
+
+      way->SetType(wayType);
+      way->nodes.emplace_back(0,osmscout::GeoCoord(lat,lon));
+      way->nodes.emplace_back(0,osmscout::GeoCoord(lat-step/4,lon+step/2));
+      way->nodes.emplace_back(0,osmscout::GeoCoord(lat,lon+step));
+
+      data.ways.push_back(way);
+
+      osmscout::AreaRef       area=std::make_shared<osmscout::Area>();
+      osmscout::Area::Ring    ring;
+
+      ring.SetType(areaType);
+      ring.MarkAsOuterRing();
+      ring.nodes.emplace_back(0,osmscout::GeoCoord(lat-step/10,lon+step/10));
+      ring.nodes.emplace_back(0,osmscout::GeoCoord(lat-step/10,lon+step*9/10));
+      ring.nodes.emplace_back(0,osmscout::GeoCoord(lat-step*9/10,lon+step*9/10));
+      ring.nodes.emplace_back(0,osmscout::GeoCoord(lat-step*9/10,lon+step/10));
+
+      area->rings.push_back(ring);
+
+      data.areas.push_back(area);
+    }
+  }
+
+  return data;
+}
+
+static bool IsSameCoord(const osmscout::Vertex2D& a,
+                        const osmscout::Vertex2D& b)
+{
+  return a.GetX()==b.GetX() && a.GetY()==b.GetY();
+}
+
+static void CheckRange(const TestPainter& expectedPainter,
+                       size_t expectedStart,
+                       size_t expectedEnd,
+                       const TestPainter& painter,
+                       size_t start,
+                       size_t end)
+{
+  REQUIRE(end-start==expectedEnd-expectedStart);
+
+  for (size_t i=0; i<=end-start; i++) {
+    REQUIRE(IsSameCoord(painter.GetCoord(start+i),
+                        expectedPainter.GetCoord(expectedStart+i)));
+  }
+}
+
+TEST_CASE("Parallel prepare yields the same ways and areas as sequential prepare")
+{
+  osmscout::GeoCoord          center(51.0,7.0);
+  osmscout::MercatorProjection projection;
+  osmscout::MapParameter      sequentialParameter;
+  osmscout::MapParameter      parallelParameter;
+  osmscout::MapData           data=CreateData(center);
+  TestPainter                 sequentialPainter(styleConfig);
+  TestPainter                 parallelPainter(styleConfig);
+
+  projection.Set(center,
+                 osmscout::Magnification(osmscout::MagnificationLevel(15)),
+                 96.0,
+                 1024,
+                 1024);
+
+  sequentialParameter.SetPrepareThreadCount(1);
+  parallelParameter.SetPrepareThreadCount(4);
+
+  sequentialPainter.Prepare(projection,
+                            sequentialParameter,
+                            data);
+  parallelPainter.Prepare(projection,
+                          parallelParameter,
+                          data);
+
+  const auto& expectedWays=sequentialPainter.GetWayData();
+  const auto& ways=parallelPainter.GetWayData();
+
+  REQUIRE(!expectedWays.empty());
+  REQUIRE(ways.size()==expectedWays.size());
+
+  auto expectedWay=expectedWays.begin();
+  for (const auto& way : ways) {
+    REQUIRE(way.buffer==expectedWay->buffer);
+    REQUIRE(way.lineStyle==expectedWay->lineStyle);
+    REQUIRE(way.lineWidth==expectedWay->lineWidth);
+    CheckRange(sequentialPainter,
+               expectedWay->transStart,
+               expectedWay->transEnd,
+               parallelPainter,
+               way.transStart,
+               way.transEnd);
+    ++expectedWay;
+  }
+
+  const auto& expectedAreas=sequentialPainter.GetAreaData();
+  const auto& areas=parallelPainter.GetAreaData();
+
+  REQUIRE(!expectedAreas.empty());
+  REQUIRE(areas.size()==expectedAreas.size());
+
+  auto expectedArea=expectedAreas.begin();
+  for (const auto& area : areas) {
+    REQUIRE(area.buffer==expectedArea->buffer);
+    REQUIRE(area.fillStyle==expectedArea->fillStyle);
+    REQUIRE(area.clippings.size()==expectedArea->clippings.size());
+    CheckRange(sequentialPainter,
+               expectedArea->transStart,
+               expectedArea->transEnd,
+               parallelPainter,
+               area.transStart,
+               area.transEnd);
+    ++expectedArea;
+  }
+}
+
+TEST_CASE("Parallel prepare can be repeated with the same painter")
+{
+  osmscout::GeoCoord          center(51.0,7.0);
+  osmscout::MercatorProjection projection;
+  osmscout::MapParameter      parameter;
+  osmscout::MapData           data=CreateData(center);
+  TestPainter                 painter(styleConfig);
+
+  projection.Set(center,
+                 osmscout::Magnification(osmscout::MagnificationLevel(15)),
+                 96.0,
+                 1024,
+                 1024);
+
+  parameter.SetPrepareThreadCount(4);
+
+  painter.Prepare(projection,
+                  parameter,
+                  data);
+
+  size_t wayCount=painter.GetWayData().size();
+  size_t areaCount=painter.GetAreaData().size();
+
+  painter.Prepare(projection,
+                  parameter,
+                  data);
+
+  REQUIRE(painter.GetWayData().size()==wayCount);
+  REQUIRE(painter.GetAreaData().size()==areaCount);
+}
+
+int main(int argc, char* argv[])
+{
+  char* testsTopDirEnv=getenv("TESTS_TOP_DIR");
+
+  if (testsTopDirEnv==nullptr) {
+    std::cerr << "Expected environment variable 'TESTS_TOP_DIR' not set" << std::endl;
+    // CMake-based tests would fail, if we do not exit here
+    return 1;
+  }
+
+  std::string testsTopDir=testsTopDirEnv;
+
+  if (testsTopDir.empty()) {
+    std::cerr << "Environment variable 'TESTS_TOP_DIR' is empty" << std::endl;
+    return 77;
+  }
+
+  typeConfig=std::make_shared<osmscout::TypeConfig>();
+
+  if (!typeConfig->LoadFromOSTFile(testsTopDir+"/../stylesheets/map.ost")) {
+    std::cerr << "Cannot load type configuration" << std::endl;
+    return 1;
+  }
+
+  styleConfig=std::make_shared<osmscout::StyleConfig>(typeConfig);
+
+  if (!styleConfig->Load(testsTopDir+"/../stylesheets/standard.oss")) {
+    std::cerr << "Cannot load style sheet" << std::endl;
+    return 1;
+  }
+
+  int result=Catch::Session().run(argc,argv);
+
+  styleConfig=nullptr;
+  typeConfig=nullptr;
+
+  return result;
+}
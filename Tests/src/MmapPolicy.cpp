@@ -0,0 +1,154 @@
+#include <string>
+#include <vector>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+#include <osmscout/util/MmapPolicy.h>
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+static const char* DATA_FILE="mmappolicy.dat";
+
+static void WriteData(size_t count)
+{
+  osmscout::FileWriter writer;
+
+  writer.Open(DATA_FILE);
+
+  for (size_t i=0; i<count; i++) {
+    writer.Write((uint32_t)i);
+  }
+
+  writer.Close();
+}
+
+static void CheckData(size_t count,
+                      osmscout::FileScanner::Mode mode,
+                      const osmscout::MmapPolicy& policy)
+{
+  osmscout::FileScanner scanner;
+
+  scanner.Open(DATA_FILE,
+               mode,
+               true,
+               policy);
+
+  REQUIRE(scanner.IsMemoryMapped());
+
+  for (size_t i=0; i<count; i++) {
+    uint32_t value;
+
+    scanner.Read(value);
+
+    REQUIRE(value==i);
+  }
+
+  scanner.Close();
+}
+
+TEST_CASE("Default policy keeps default behaviour")
+{
+  osmscout::MmapPolicy policy;
+
+  REQUIRE(policy.IsDefault());
+  REQUIRE(policy.GetAdvice()==osmscout::MmapPolicy::AdviceDefault);
+
+  policy.SetPopulate(true);
+
+  REQUIRE_FALSE(policy.IsDefault());
+}
+
+TEST_CASE("Files are read unchanged with all policies")
+{
+  const size_t count=100000;
+
+  WriteData(count);
+
+  for (auto advice : {osmscout::MmapPolicy::AdviceDefault,
+                      osmscout::MmapPolicy::AdviceNormal,
+                      osmscout::MmapPolicy::AdviceRandom,
+                      osmscout::MmapPolicy::AdviceSequential,
+                      osmscout::MmapPolicy::AdviceWillNeed}) {
+    for (auto mode : {osmscout::FileScanner::Sequential,
+                      osmscout::FileScanner::FastRandom,
+                      osmscout::FileScanner::LowMemRandom,
+                      osmscout::FileScanner::Normal}) {
+      CheckData(count,
+                mode,
+                osmscout::MmapPolicy().SetAdvice(advice));
+    }
+  }
+
+  // Locking may fail because of resource limits, which must not be fatal
+  CheckData(count,
+            osmscout::FileScanner::LowMemRandom,
+            osmscout::MmapPolicy().SetPopulate(true).SetLock(true).SetHugePages(true));
+
+  osmscout::RemoveFile(DATA_FILE);
+}
+
+TEST_CASE("Scanner sharing the mapping of another scanner")
+{
+  const size_t count=1000;
+
+  WriteData(count);
+
+  osmscout::FileScanner mappedScanner;
+  osmscout::FileScanner sharingScanner;
+
+  mappedScanner.Open(DATA_FILE,
+                     osmscout::FileScanner::LowMemRandom,
+                     true);
+
+  if (mappedScanner.IsMemoryMapped()) {
+    sharingScanner.Open(DATA_FILE,
+                        osmscout::FileScanner::LowMemRandom,
+                        false);
+
+    REQUIRE_FALSE(sharingScanner.IsMemoryMapped());
+
+    sharingScanner.ShareMapping(mappedScanner);
+
+    REQUIRE(sharingScanner.IsMemoryMapped());
+    REQUIRE(sharingScanner.GetMappedData(0,4)==mappedScanner.GetMappedData(0,4));
+
+    uint32_t value;
+
+    sharingScanner.SetPos(4*(count-1));
+    sharingScanner.Read(value);
+
+    REQUIRE(value==count-1);
+
+    // Closing the sharing scanner must not unmap the file
+    sharingScanner.Close();
+
+    mappedScanner.SetPos(4*(count-1));
+    mappedScanner.Read(value);
+
+    REQUIRE(value==count-1);
+  }
+
+  mappedScanner.Close();
+
+  osmscout::RemoveFile(DATA_FILE);
+}
+
+TEST_CASE("Page fault count is monotonic")
+{
+  osmscout::PageFaultCount before=osmscout::GetPageFaultCount();
+  std::vector<char>        memory(16*1024*1024,1);
+  osmscout::PageFaultCount after=osmscout::GetPageFaultCount();
+  osmscout::PageFaultCount difference=after-before;
+
+  REQUIRE(after.minorFaults>=before.minorFaults);
+  REQUIRE(after.majorFaults>=before.majorFaults);
+
+  if (osmscout::IsPageFaultCountSupported()) {
+    // Touching fresh memory causes page faults
+    REQUIRE(difference.minorFaults+difference.majorFaults>0);
+  }
+
+  REQUIRE(memory[0]==1);
+}
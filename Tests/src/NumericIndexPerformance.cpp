@@ -0,0 +1,319 @@
+/*
+  NumericIndexPerformance - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <osmscout/EytzingerIndex.h>
+#include <osmscout/NumericIndex.h>
+#include <osmscout/TypeConfig.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+#include <osmscout/util/Progress.h>
+#include <osmscout/util/StopClock.h>
+#include <osmscout/util/String.h>
+
+#include <osmscout/import/GenEytzingerIndex.h>
+#include <osmscout/import/GenNumericIndex.h>
+
+/**
+  Compare lookup times of NumericIndex and EytzingerIndex.
+
+  A synthetic data file with the given number of records (with sorted, but not dense
+  ids) is written to the given directory and both index types are generated for it.
+  Ids are then looked up one by one in random order and in sorted batches (as done
+  when loading all objects referenced by a tile).
+*/
+
+static const char* DATA_FILE="numericindexperformance.dat";
+static const char* NUMERIC_INDEX_FILE="numericindexperformance.idx";
+static const char* EYTZINGER_INDEX_FILE="numericindexperformance.eidx";
+
+static const size_t BATCH_SIZE=1000;
+
+class Record
+{
+private:
+  osmscout::OSMId id;
+  uint32_t        value;
+
+public:
+  osmscout::OSMId GetId() const
+  {
+    return id;
+  }
+
+  void Read(const osmscout::TypeConfig& /*typeConfig*/,
+            osmscout::FileScanner& scanner)
+  {
+    scanner.Read(id);
+    scanner.Read(value);
+  }
+};
+
+struct Result
+{
+  size_t lookupCount;
+  double time;
+
+  Result()
+  : lookupCount(0),
+    time(0.0)
+  {
+    // no code
+  }
+};
+
+static std::vector<osmscout::OSMId> WriteData(const std::string& filename,
+                                              size_t recordCount)
+{
+  std::mt19937                                   generator(4711);
+  std::uniform_int_distribution<osmscout::OSMId> gapDistribution(1,20);
+  osmscout::FileWriter                           writer;
+  std::vector<osmscout::OSMId>                   ids;
+  osmscout::OSMId                                id=0;
+
+  ids.reserve(recordCount);
+
+  writer.Open(filename);
+
+  writer.Write((uint32_t)recordCount);
+
+  for (size_t i=0; i<recordCount; i++) {
+    id+=gapDistribution(generator);
+
+    writer.Write((int64_t)id);
+    writer.Write((uint32_t)i);
+
+    ids.push_back(id);
+  }
+
+  writer.Close();
+
+  return ids;
+}
+
+template<class I>
+bool LookupSingle(const I& index,
+                  const std::vector<osmscout::OSMId>& ids,
+                  Result& result)
+{
+  osmscout::StopClock timer;
+
+  for (const auto id : ids) {
+    osmscout::FileOffset offset;
+
+    if (!index.GetOffset(id,offset)) {
+      return false;
+    }
+  }
+
+  timer.Stop();
+
+  result.lookupCount+=ids.size();
+  result.time+=timer.GetMilliseconds();
+
+  return true;
+}
+
+template<class I>
+bool LookupBatches(const I& index,
+                   const std::vector<std::vector<osmscout::OSMId>>& batches,
+                   Result& result)
+{
+  std::vector<osmscout::FileOffset> offsets;
+  osmscout::StopClock               timer;
+
+  for (const auto& batch : batches) {
+    if (!index.GetOffsets(batch.begin(),
+                          batch.end(),
+                          batch.size(),
+                          offsets) ||
+        offsets.size()!=batch.size()) {
+      return false;
+    }
+
+    result.lookupCount+=batch.size();
+  }
+
+  timer.Stop();
+
+  result.time+=timer.GetMilliseconds();
+
+  return true;
+}
+
+void DumpResult(const std::string& name,
+                const Result& result)
+{
+  std::cout << name << ": " << result.lookupCount << " lookups, " << result.time << " ms";
+
+  if (result.lookupCount>0) {
+    std::cout << ", " << result.time*1000000.0/result.lookupCount << " ns/lookup";
+  }
+
+  std::cout << std::endl;
+}
+
+template<class I>
+bool Measure(const std::string& name,
+             I& index,
+             const std::string& directory,
+             const std::string& indexfile,
+             bool memoryMapped,
+             const std::vector<osmscout::OSMId>& ids,
+             const std::vector<std::vector<osmscout::OSMId>>& batches,
+             size_t iterationCount)
+{
+  Result singleResult;
+  Result batchResult;
+
+  if (!index.Open(directory,memoryMapped)) {
+    std::cerr << "Cannot open index '" << indexfile << "'" << std::endl;
+    return false;
+  }
+
+  for (size_t i=1; i<=iterationCount; i++) {
+    if (!LookupSingle(index,ids,singleResult) ||
+        !LookupBatches(index,batches,batchResult)) {
+      std::cerr << "Error while looking up ids in '" << indexfile << "'" << std::endl;
+      index.Close();
+      return false;
+    }
+  }
+
+  DumpResult(name+", single",singleResult);
+  DumpResult(name+", sorted batches",batchResult);
+
+  index.Close();
+
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc<2 || argc>5) {
+    std::cerr << "NumericIndexPerformance <target directory> [<records> [<samples> [<iterations>]]]" << std::endl;
+
+    return 1;
+  }
+
+  std::string directory=argv[1];
+  size_t      recordCount=10000000;
+  size_t      sampleCount=1000000;
+  size_t      iterationCount=3;
+
+  if (argc>=3 && !osmscout::StringToNumber(argv[2],recordCount)) {
+    std::cerr << "Cannot parse records '" << argv[2] << "'" << std::endl;
+    return 1;
+  }
+
+  if (argc>=4 && !osmscout::StringToNumber(argv[3],sampleCount)) {
+    std::cerr << "Cannot parse samples '" << argv[3] << "'" << std::endl;
+    return 1;
+  }
+
+  if (argc>=5 && !osmscout::StringToNumber(argv[4],iterationCount)) {
+    std::cerr << "Cannot parse iterations '" << argv[4] << "'" << std::endl;
+    return 1;
+  }
+
+  osmscout::TypeConfigRef   typeConfig=std::make_shared<osmscout::TypeConfig>();
+  osmscout::ImportParameter parameter;
+  osmscout::ConsoleProgress progress;
+
+  parameter.SetDestinationDirectory(directory);
+
+  std::vector<osmscout::OSMId> ids;
+
+  try {
+    ids=WriteData(osmscout::AppendFileToDir(directory,DATA_FILE),
+                  recordCount);
+  }
+  catch (osmscout::IOException& e) {
+    std::cerr << e.GetDescription() << std::endl;
+    return 1;
+  }
+
+  osmscout::NumericIndexGenerator<osmscout::OSMId,Record>   numericGenerator("Generating numeric index",
+                                                                             DATA_FILE,
+                                                                             NUMERIC_INDEX_FILE);
+  osmscout::EytzingerIndexGenerator<osmscout::OSMId,Record> eytzingerGenerator("Generating Eytzinger index",
+                                                                               DATA_FILE,
+                                                                               EYTZINGER_INDEX_FILE);
+
+  if (!numericGenerator.Import(typeConfig,parameter,progress) ||
+      !eytzingerGenerator.Import(typeConfig,parameter,progress)) {
+    std::cerr << "Cannot generate index files" << std::endl;
+    return 1;
+  }
+
+  try {
+    std::cout << "NumericIndex: " << osmscout::ByteSizeToString(osmscout::GetFileSize(osmscout::AppendFileToDir(directory,NUMERIC_INDEX_FILE))) << std::endl;
+    std::cout << "EytzingerIndex: " << osmscout::ByteSizeToString(osmscout::GetFileSize(osmscout::AppendFileToDir(directory,EYTZINGER_INDEX_FILE))) << std::endl;
+  }
+  catch (osmscout::IOException& e) {
+    std::cerr << e.GetDescription() << std::endl;
+    return 1;
+  }
+
+  std::mt19937                              generator(4711);
+  std::vector<osmscout::OSMId>              samples(ids);
+  std::vector<std::vector<osmscout::OSMId>> batches;
+
+  std::shuffle(samples.begin(),samples.end(),generator);
+
+  if (samples.size()>sampleCount) {
+    samples.resize(sampleCount);
+  }
+
+  for (size_t i=0; i<samples.size(); i+=BATCH_SIZE) {
+    std::vector<osmscout::OSMId> batch(samples.begin()+i,
+                                       samples.begin()+std::min(i+BATCH_SIZE,samples.size()));
+
+    std::sort(batch.begin(),batch.end());
+
+    batches.push_back(batch);
+  }
+
+  ids.clear();
+
+  osmscout::NumericIndex<osmscout::OSMId>   numericIndex(NUMERIC_INDEX_FILE,1000);
+  osmscout::NumericIndex<osmscout::OSMId>   mappedNumericIndex(NUMERIC_INDEX_FILE,1000);
+  osmscout::EytzingerIndex<osmscout::OSMId> eytzingerIndex(EYTZINGER_INDEX_FILE);
+  osmscout::EytzingerIndex<osmscout::OSMId> mappedEytzingerIndex(EYTZINGER_INDEX_FILE);
+
+  if (!Measure("NumericIndex",numericIndex,directory,NUMERIC_INDEX_FILE,false,samples,batches,iterationCount) ||
+      !Measure("NumericIndex, mmap",mappedNumericIndex,directory,NUMERIC_INDEX_FILE,true,samples,batches,iterationCount) ||
+      !Measure("EytzingerIndex",eytzingerIndex,directory,EYTZINGER_INDEX_FILE,false,samples,batches,iterationCount) ||
+      !Measure("EytzingerIndex, mmap",mappedEytzingerIndex,directory,EYTZINGER_INDEX_FILE,true,samples,batches,iterationCount)) {
+    return 1;
+  }
+
+  osmscout::RemoveFile(osmscout::AppendFileToDir(directory,DATA_FILE));
+  osmscout::RemoveFile(osmscout::AppendFileToDir(directory,NUMERIC_INDEX_FILE));
+  osmscout::RemoveFile(osmscout::AppendFileToDir(directory,EYTZINGER_INDEX_FILE));
+
+  return 0;
+}
@@ -0,0 +1,423 @@
+/*
+  ObjectViewPerformance - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include <osmscout/Database.h>
+
+#include <osmscout/util/StopClock.h>
+#include <osmscout/util/String.h>
+
+/**
+  Compare loading all ways and areas of a database as objects (Way, Area) with
+  loading them as views (WayView, AreaView) into the memory mapped data files.
+
+  For both variants all coordinates are decoded and the number of heap allocations
+  is counted. Object caches are disabled to measure actual loading.
+
+  Additionally the database is split into tiles and the ways and areas of each tile
+  are loaded like MapService does, once with and once without the bounding box
+  filter, which skips objects outside of the tile without loading them.
+*/
+
+static std::atomic<size_t> allocationCount(0);
+
+void* operator new(std::size_t size)
+{
+  allocationCount++;
+
+  void* result=std::malloc(size==0 ? 1 : size);
+
+  if (result==nullptr) {
+    throw std::bad_alloc();
+  }
+
+  return result;
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t /*size*/) noexcept
+{
+  std::free(pointer);
+}
+
+struct Result
+{
+  size_t objectCount;
+  size_t coordCount;
+  double latSum;
+  size_t allocations;
+  double time;
+
+  Result()
+  : objectCount(0),
+    coordCount(0),
+    latSum(0.0),
+    allocations(0),
+    time(0.0)
+  {
+    // no code
+  }
+};
+
+void DumpResult(const std::string& name,
+                const Result& result)
+{
+  std::cout << name << ": " << result.objectCount << " objects, " << result.coordCount << " coords, ";
+  std::cout << result.allocations << " allocations, " << result.time << " ms" << std::endl;
+}
+
+bool LoadWays(const osmscout::WayDataFileRef& wayDataFile,
+              const std::vector<osmscout::FileOffset>& offsets,
+              Result& result)
+{
+  size_t              allocationsBefore=allocationCount;
+  osmscout::StopClock timer;
+
+  {
+    std::vector<osmscout::WayRef> ways;
+
+    if (!wayDataFile->GetByOffset(offsets.begin(),
+                                  offsets.end(),
+                                  offsets.size(),
+                                  ways)) {
+      return false;
+    }
+
+    for (const auto& way : ways) {
+      for (const auto& point : way->nodes) {
+        result.latSum+=point.GetLat();
+        result.coordCount++;
+      }
+    }
+
+    result.objectCount+=ways.size();
+  }
+
+  timer.Stop();
+
+  result.time+=timer.GetMilliseconds();
+  result.allocations+=allocationCount-allocationsBefore;
+
+  return true;
+}
+
+bool LoadWayViews(const osmscout::WayDataFileRef& wayDataFile,
+                  const std::vector<osmscout::FileOffset>& offsets,
+                  std::vector<osmscout::WayView>& views,
+                  std::vector<osmscout::GeoCoord>& coords,
+                  Result& result)
+{
+  size_t              allocationsBefore=allocationCount;
+  osmscout::StopClock timer;
+
+  views.clear();
+
+  if (!wayDataFile->GetViewsByOffset(offsets.begin(),
+                                     offsets.end(),
+                                     offsets.size(),
+                                     views)) {
+    return false;
+  }
+
+  for (const auto& view : views) {
+    view.nodes.GetCoords(coords);
+
+    for (const auto& coord : coords) {
+      result.latSum+=coord.GetLat();
+      result.coordCount++;
+    }
+  }
+
+  result.objectCount+=views.size();
+
+  timer.Stop();
+
+  result.time+=timer.GetMilliseconds();
+  result.allocations+=allocationCount-allocationsBefore;
+
+  return true;
+}
+
+bool LoadAreas(const osmscout::AreaDataFileRef& areaDataFile,
+               const std::vector<osmscout::DataBlockSpan>& spans,
+               Result& result)
+{
+  size_t              allocationsBefore=allocationCount;
+  osmscout::StopClock timer;
+
+  {
+    std::vector<osmscout::AreaRef> areas;
+
+    if (!areaDataFile->GetByBlockSpans(spans.begin(),
+                                       spans.end(),
+                                       areas)) {
+      return false;
+    }
+
+    for (const auto& area : areas) {
+      for (const auto& ring : area->rings) {
+        for (const auto& point : ring.nodes) {
+          result.latSum+=point.GetLat();
+          result.coordCount++;
+        }
+      }
+    }
+
+    result.objectCount+=areas.size();
+  }
+
+  timer.Stop();
+
+  result.time+=timer.GetMilliseconds();
+  result.allocations+=allocationCount-allocationsBefore;
+
+  return true;
+}
+
+bool LoadAreaViews(const osmscout::AreaDataFileRef& areaDataFile,
+                   const std::vector<osmscout::DataBlockSpan>& spans,
+                   std::vector<osmscout::AreaView>& views,
+                   std::vector<osmscout::AreaView::Ring>& rings,
+                   std::vector<osmscout::GeoCoord>& coords,
+                   Result& result)
+{
+  size_t              allocationsBefore=allocationCount;
+  osmscout::StopClock timer;
+
+  views.clear();
+  rings.clear();
+
+  if (!areaDataFile->GetViewsByBlockSpans(spans.begin(),
+                                          spans.end(),
+                                          views,
+                                          rings)) {
+    return false;
+  }
+
+  for (const auto& view : views) {
+    for (size_t r=0; r<view.GetRingCount(); r++) {
+      view.GetRing(r).nodes.GetCoords(coords);
+
+      for (const auto& coord : coords) {
+        result.latSum+=coord.GetLat();
+        result.coordCount++;
+      }
+    }
+  }
+
+  result.objectCount+=views.size();
+
+  timer.Stop();
+
+  result.time+=timer.GetMilliseconds();
+  result.allocations+=allocationCount-allocationsBefore;
+
+  return true;
+}
+
+bool LoadTiles(const osmscout::DatabaseRef& database,
+               const osmscout::GeoBox& boundingBox,
+               size_t tileCount,
+               bool filter,
+               Result& result)
+{
+  osmscout::TypeConfigRef typeConfig=database->GetTypeConfig();
+  double                  latStep=(boundingBox.GetMaxLat()-boundingBox.GetMinLat())/tileCount;
+  double                  lonStep=(boundingBox.GetMaxLon()-boundingBox.GetMinLon())/tileCount;
+
+  for (size_t y=0; y<tileCount; y++) {
+    for (size_t x=0; x<tileCount; x++) {
+      osmscout::GeoBox                     tileBox(osmscout::GeoCoord(boundingBox.GetMinLat()+y*latStep,
+                                                                      boundingBox.GetMinLon()+x*lonStep),
+                                                   osmscout::GeoCoord(boundingBox.GetMinLat()+(y+1)*latStep,
+                                                                      boundingBox.GetMinLon()+(x+1)*lonStep));
+      std::vector<osmscout::FileOffset>    wayOffsets;
+      std::vector<osmscout::DataBlockSpan> areaSpans;
+      osmscout::TypeInfoSet                loadedTypes;
+
+      if (!database->GetAreaWayIndex()->GetOffsets(tileBox,
+                                                   osmscout::TypeInfoSet(typeConfig->GetWayTypes()),
+                                                   wayOffsets,
+                                                   loadedTypes) ||
+          !database->GetAreaAreaIndex()->GetAreasInArea(*typeConfig,
+                                                        tileBox,
+                                                        std::numeric_limits<size_t>::max(),
+                                                        osmscout::TypeInfoSet(typeConfig->GetAreaTypes()),
+                                                        areaSpans,
+                                                        loadedTypes)) {
+        return false;
+      }
+
+      std::sort(wayOffsets.begin(),wayOffsets.end());
+      std::sort(areaSpans.begin(),areaSpans.end());
+
+      size_t              allocationsBefore=allocationCount;
+      osmscout::StopClock timer;
+
+      {
+        std::vector<osmscout::WayRef>  ways;
+        std::vector<osmscout::AreaRef> areas;
+
+        if (filter) {
+          if (!database->GetWaysByOffset(wayOffsets,tileBox,ways) ||
+              !database->GetAreasByBlockSpans(areaSpans,tileBox,areas)) {
+            return false;
+          }
+        }
+        else {
+          if (!database->GetWaysByOffset(wayOffsets,ways) ||
+              !database->GetAreasByBlockSpans(areaSpans,areas)) {
+            return false;
+          }
+        }
+
+        for (const auto& way : ways) {
+          if (way->Intersects(tileBox)) {
+            result.coordCount+=way->nodes.size();
+          }
+        }
+
+        for (const auto& area : areas) {
+          if (area->Intersects(tileBox)) {
+            result.coordCount+=area->rings.front().nodes.size();
+          }
+        }
+
+        result.objectCount+=ways.size()+areas.size();
+      }
+
+      timer.Stop();
+
+      result.time+=timer.GetMilliseconds();
+      result.allocations+=allocationCount-allocationsBefore;
+    }
+  }
+
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc<2 || argc>3) {
+    std::cerr << "ObjectViewPerformance <database directory> [<iterations>]" << std::endl;
+
+    return 1;
+  }
+
+  size_t iterationCount=3;
+
+  if (argc>=3 && !osmscout::StringToNumber(argv[2],iterationCount)) {
+    std::cerr << "Cannot parse iterations '" << argv[2] << "'" << std::endl;
+    return 1;
+  }
+
+  osmscout::DatabaseParameter parameter;
+
+  parameter.SetWayDataCacheSize(0);
+  parameter.SetAreaDataCacheSize(0);
+  parameter.SetWaysDataMMap(true);
+  parameter.SetAreasDataMMap(true);
+
+  osmscout::DatabaseRef database=std::make_shared<osmscout::Database>(parameter);
+
+  if (!database->Open(argv[1])) {
+    std::cerr << "Cannot open database" << std::endl;
+
+    return 1;
+  }
+
+  osmscout::TypeConfigRef              typeConfig=database->GetTypeConfig();
+  osmscout::GeoBox                     boundingBox;
+  std::vector<osmscout::FileOffset>    wayOffsets;
+  std::vector<osmscout::DataBlockSpan> areaSpans;
+  osmscout::TypeInfoSet                loadedTypes;
+
+  if (!database->GetBoundingBox(boundingBox) ||
+      !database->GetAreaWayIndex()->GetOffsets(boundingBox,
+                                               osmscout::TypeInfoSet(typeConfig->GetWayTypes()),
+                                               wayOffsets,
+                                               loadedTypes) ||
+      !database->GetAreaAreaIndex()->GetAreasInArea(*typeConfig,
+                                                    boundingBox,
+                                                    std::numeric_limits<size_t>::max(),
+                                                    osmscout::TypeInfoSet(typeConfig->GetAreaTypes()),
+                                                    areaSpans,
+                                                    loadedTypes)) {
+    std::cerr << "Cannot collect test data" << std::endl;
+
+    return 1;
+  }
+
+  osmscout::WayDataFileRef              wayDataFile=database->GetWayDataFile();
+  osmscout::AreaDataFileRef             areaDataFile=database->GetAreaDataFile();
+  std::vector<osmscout::WayView>        wayViews;
+  std::vector<osmscout::AreaView>       areaViews;
+  std::vector<osmscout::AreaView::Ring> areaRings;
+  std::vector<osmscout::GeoCoord>       coords;
+  Result                                wayResult;
+  Result                                wayViewResult;
+  Result                                areaResult;
+  Result                                areaViewResult;
+  Result                                tileResult;
+  Result                                tileFilterResult;
+
+  for (size_t i=1; i<=iterationCount; i++) {
+    if (!LoadWays(wayDataFile,wayOffsets,wayResult) ||
+        !LoadWayViews(wayDataFile,wayOffsets,wayViews,coords,wayViewResult) ||
+        !LoadAreas(areaDataFile,areaSpans,areaResult) ||
+        !LoadAreaViews(areaDataFile,areaSpans,areaViews,areaRings,coords,areaViewResult) ||
+        !LoadTiles(database,boundingBox,10,false,tileResult) ||
+        !LoadTiles(database,boundingBox,10,true,tileFilterResult)) {
+      std::cerr << "Error while loading data" << std::endl;
+
+      return 1;
+    }
+  }
+
+  DumpResult("Way",wayResult);
+  DumpResult("WayView",wayViewResult);
+  DumpResult("Area",areaResult);
+  DumpResult("AreaView",areaViewResult);
+  DumpResult("Tiles",tileResult);
+  DumpResult("Tiles (filtered)",tileFilterResult);
+
+  database->Close();
+
+  if (wayResult.coordCount!=wayViewResult.coordCount ||
+      wayResult.latSum!=wayViewResult.latSum ||
+      areaResult.coordCount!=areaViewResult.coordCount ||
+      areaResult.latSum!=areaViewResult.latSum ||
+      tileResult.coordCount!=tileFilterResult.coordCount) {
+    std::cerr << "Objects and views differ!" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
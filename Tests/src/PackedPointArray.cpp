@@ -0,0 +1,179 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <osmscout/PackedPointArray.h>
+
+#include <osmscout/util/Geometry.h>
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/**
+ * Create a random walk of points, with coordinates in data file resolution,
+ * so that they are represented in the packed array without loss.
+ */
+static std::vector<osmscout::Point> CreatePoints(size_t count,
+                                                 double maxStep,
+                                                 bool withSerials)
+{
+  std::mt19937                           generator(4711);
+  std::uniform_real_distribution<double> distribution(-maxStep,maxStep);
+  std::vector<osmscout::Point>           points;
+  double                                 lat=51.5;
+  double                                 lon=7.4;
+
+  for (size_t i=0; i<count; i++) {
+    uint8_t serial=0;
+
+    if (withSerials && i%3==0) {
+      serial=(uint8_t)(i%255+1);
+    }
+
+    int32_t latValue=osmscout::PackedPointArray::LatToValue(lat);
+    int32_t lonValue=osmscout::PackedPointArray::LonToValue(lon);
+
+    points.push_back(osmscout::Point(serial,
+                                     osmscout::GeoCoord(latValue/osmscout::latConversionFactor-90.0,
+                                                        lonValue/osmscout::lonConversionFactor-180.0)));
+
+    lat+=distribution(generator);
+    lon+=distribution(generator);
+  }
+
+  return points;
+}
+
+/**
+ * Regular polygon with the given number of corners, closed
+ */
+static std::vector<osmscout::Point> CreateRing(size_t corners)
+{
+  std::vector<osmscout::Point> points;
+
+  for (size_t i=0; i<corners; i++) {
+    double angle=2*M_PI*i/corners;
+
+    points.push_back(osmscout::Point(0,
+                                     osmscout::GeoCoord(51.0+0.1*sin(angle),
+                                                        7.0+0.1*cos(angle))));
+  }
+
+  return points;
+}
+
+TEST_CASE("Packed array returns the same points")
+{
+  for (bool withSerials : {false,true}) {
+    std::vector<osmscout::Point> points=CreatePoints(1000,0.01,withSerials);
+    osmscout::PackedPointArray   packed(points);
+    std::vector<osmscout::Point> unpacked;
+
+    REQUIRE(packed.GetSize()==points.size());
+    REQUIRE(packed.HasSerials()==withSerials);
+
+    packed.GetPoints(unpacked);
+
+    size_t idx=0;
+
+    for (const auto point : packed) {
+      REQUIRE(point.GetCoord()==points[idx].GetCoord());
+      REQUIRE(point.GetSerial()==points[idx].GetSerial());
+      REQUIRE(point.GetId()==points[idx].GetId());
+      REQUIRE(packed.GetPoint(idx).IsIdentical(points[idx]));
+      REQUIRE(unpacked[idx].IsIdentical(points[idx]));
+      idx++;
+    }
+
+    REQUIRE(idx==points.size());
+
+    osmscout::GeoBox expectedBox;
+
+    osmscout::GetBoundingBox(points,
+                             expectedBox);
+
+    REQUIRE(packed.GetBoundingBox().GetMinCoord()==expectedBox.GetMinCoord());
+    REQUIRE(packed.GetBoundingBox().GetMaxCoord()==expectedBox.GetMaxCoord());
+  }
+}
+
+TEST_CASE("Packed array needs less memory")
+{
+  std::vector<osmscout::Point> points=CreatePoints(1000,0.01,false);
+  osmscout::PackedPointArray   packed(points);
+
+  REQUIRE(packed.GetMemoryUsage()<points.size()*sizeof(osmscout::Point)/2);
+}
+
+TEST_CASE("Point in packed area")
+{
+  for (size_t corners : {3,8,255,256,257,1000}) {
+    std::vector<osmscout::Point> ring=CreateRing(corners);
+    osmscout::PackedPointArray   packed(ring);
+
+    // Use the quantized ring as reference
+    packed.GetPoints(ring);
+
+    REQUIRE(osmscout::IsCoordInArea(osmscout::GeoCoord(51.0,7.0),packed));
+    REQUIRE_FALSE(osmscout::IsCoordInArea(osmscout::GeoCoord(51.2,7.0),packed));
+    REQUIRE(osmscout::IsCoordInArea(ring[corners/2],packed));
+
+    std::mt19937                           generator(corners);
+    std::uniform_real_distribution<double> distribution(-0.12,0.12);
+
+    for (size_t i=0; i<1000; i++) {
+      osmscout::GeoCoord coord(51.0+distribution(generator),
+                               7.0+distribution(generator));
+
+      REQUIRE(osmscout::IsCoordInArea(coord,packed)==osmscout::IsCoordInArea(coord,ring));
+    }
+  }
+}
+
+TEST_CASE("Distance to packed polyline")
+{
+  std::vector<osmscout::Point> points=CreatePoints(1000,0.001,false);
+  osmscout::PackedPointArray   packed(points);
+  std::mt19937                 generator(4711);
+
+  std::uniform_real_distribution<double> distribution(-0.05,0.05);
+
+  for (size_t i=0; i<100; i++) {
+    osmscout::GeoCoord location(51.5+distribution(generator),
+                                7.4+distribution(generator));
+    double             expectedDistance=std::numeric_limits<double>::infinity();
+    size_t             expectedSegment=0;
+    osmscout::GeoCoord expectedIntersection;
+
+    for (size_t s=0; s+1<points.size(); s++) {
+      osmscout::GeoCoord intersection;
+      double             distance=osmscout::CalculateDistancePointToLineSegment(location,
+                                                                                points[s].GetCoord(),
+                                                                                points[s+1].GetCoord(),
+                                                                                intersection);
+
+      if (distance<expectedDistance) {
+        expectedDistance=distance;
+        expectedSegment=s;
+        expectedIntersection=intersection;
+      }
+    }
+
+    size_t             segment;
+    osmscout::GeoCoord intersection;
+    double             distance=osmscout::CalculateDistancePointToLineSegments(location,
+                                                                               packed,
+                                                                               segment,
+                                                                               intersection);
+
+    REQUIRE(distance==expectedDistance);
+    REQUIRE(segment==expectedSegment);
+    REQUIRE(intersection==expectedIntersection);
+
+    // Accessor adapter works with the templated algorithms
+    REQUIRE(osmscout::CalculateDistancePointToLineSegment(packed[segment],
+                                                          packed[segment],
+                                                          packed[segment+1])==0.0);
+  }
+}
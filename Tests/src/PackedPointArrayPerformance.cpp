@@ -0,0 +1,196 @@
+/*
+  PackedPointArrayPerformance - a test program for libosmscout
+  Copyright (C) 2026  libosmscout contributors
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <osmscout/PackedPointArray.h>
+
+#include <osmscout/util/Geometry.h>
+#include <osmscout/util/StopClock.h>
+#include <osmscout/util/String.h>
+
+/**
+  Compare memory usage and geometry throughput of std::vector<Point> and
+  PackedPointArray.
+
+  A number of random ways is generated and stored in both representations. Then the
+  ways are tested for containing a point (as done for areas) and the distance to a
+  point is calculated (as done for radius searches).
+*/
+
+static std::vector<std::vector<osmscout::Point>> CreateWays(size_t wayCount,
+                                                            size_t pointCount)
+{
+  std::mt19937                              generator(4711);
+  std::uniform_real_distribution<double>    startDistribution(-0.05,0.05);
+  std::uniform_real_distribution<double>    stepDistribution(-0.0002,0.0002);
+  std::vector<std::vector<osmscout::Point>> ways(wayCount);
+
+  for (auto& way : ways) {
+    double lat=51.5+startDistribution(generator);
+    double lon=7.4+startDistribution(generator);
+
+    way.reserve(pointCount);
+
+    for (size_t i=0; i<pointCount; i++) {
+      way.push_back(osmscout::Point(i==0 ? 1 : 0,
+                                    osmscout::GeoCoord(lat,lon)));
+
+      lat+=stepDistribution(generator);
+      lon+=stepDistribution(generator);
+    }
+  }
+
+  return ways;
+}
+
+static void DumpResult(const std::string& name,
+                       size_t pointCount,
+                       double time,
+                       double checksum)
+{
+  std::cout << name << ": " << time << " ms, " << pointCount/time/1000.0 << " Mpoints/s (" << checksum << ")" << std::endl;
+}
+
+template<class W>
+void MeasureInArea(const std::string& name,
+                   const std::vector<W>& ways,
+                   size_t pointCount)
+{
+  osmscout::GeoCoord  location(51.5,7.4);
+  size_t              inside=0;
+  osmscout::StopClock timer;
+
+  for (const auto& way : ways) {
+    if (osmscout::IsCoordInArea(location,way)) {
+      inside++;
+    }
+  }
+
+  timer.Stop();
+
+  DumpResult(name,pointCount,timer.GetMilliseconds(),(double)inside);
+}
+
+static void MeasureDistance(const std::vector<std::vector<osmscout::Point>>& ways,
+                            size_t pointCount)
+{
+  osmscout::GeoCoord  location(51.5,7.4);
+  double              checksum=0.0;
+  osmscout::StopClock timer;
+
+  for (const auto& way : ways) {
+    double minDistance=std::numeric_limits<double>::infinity();
+
+    for (size_t i=1; i<way.size(); i++) {
+      osmscout::GeoCoord intersection;
+      double             distance=osmscout::CalculateDistancePointToLineSegment(location,
+                                                                                way[i-1].GetCoord(),
+                                                                                way[i].GetCoord(),
+                                                                                intersection);
+
+      if (distance<minDistance) {
+        minDistance=distance;
+      }
+    }
+
+    checksum+=minDistance;
+  }
+
+  timer.Stop();
+
+  DumpResult("Distance, std::vector<Point>",pointCount,timer.GetMilliseconds(),checksum);
+}
+
+static void MeasureDistance(const std::vector<osmscout::PackedPointArray>& ways,
+                            size_t pointCount)
+{
+  osmscout::GeoCoord  location(51.5,7.4);
+  double              checksum=0.0;
+  osmscout::StopClock timer;
+
+  for (const auto& way : ways) {
+    size_t             segment;
+    osmscout::GeoCoord intersection;
+
+    checksum+=osmscout::CalculateDistancePointToLineSegments(location,
+                                                             way,
+                                                             segment,
+                                                             intersection);
+  }
+
+  timer.Stop();
+
+  DumpResult("Distance, PackedPointArray",pointCount,timer.GetMilliseconds(),checksum);
+}
+
+int main(int argc, char* argv[])
+{
+  size_t wayCount=200000;
+  size_t pointCount=50;
+
+  if (argc>3) {
+    std::cerr << "PackedPointArrayPerformance [<ways> [<points per way>]]" << std::endl;
+    return 1;
+  }
+
+  if (argc>=2 && !osmscout::StringToNumber(argv[1],wayCount)) {
+    std::cerr << "Cannot parse ways '" << argv[1] << "'" << std::endl;
+    return 1;
+  }
+
+  if (argc>=3 && (!osmscout::StringToNumber(argv[2],pointCount) || pointCount<2)) {
+    std::cerr << "Cannot parse points per way '" << argv[2] << "'" << std::endl;
+    return 1;
+  }
+
+  std::vector<std::vector<osmscout::Point>> ways=CreateWays(wayCount,pointCount);
+  std::vector<osmscout::PackedPointArray>   packedWays;
+  size_t                                    memory=0;
+  size_t                                    packedMemory=0;
+  size_t                                    totalPointCount=wayCount*pointCount;
+
+  packedWays.reserve(ways.size());
+
+  for (const auto& way : ways) {
+    packedWays.push_back(osmscout::PackedPointArray(way));
+
+    memory+=sizeof(way)+way.capacity()*sizeof(osmscout::Point);
+    packedMemory+=packedWays.back().GetMemoryUsage();
+  }
+
+  std::cout << wayCount << " ways with " << pointCount << " points each" << std::endl;
+  std::cout << "Memory, std::vector<Point>: " << osmscout::ByteSizeToString((double)memory) << ", " << memory/(double)wayCount << " bytes/way" << std::endl;
+  std::cout << "Memory, PackedPointArray: " << osmscout::ByteSizeToString((double)packedMemory) << ", " << packedMemory/(double)wayCount << " bytes/way" << std::endl;
+
+  for (size_t i=1; i<=2; i++) {
+    std::cout << "Iteration " << i << ":" << std::endl;
+
+    MeasureInArea("In area, std::vector<Point>",ways,totalPointCount);
+    MeasureInArea("In area, PackedPointArray",packedWays,totalPointCount);
+    MeasureDistance(ways,totalPointCount);
+    MeasureDistance(packedWays,totalPointCount);
+  }
+
+  return 0;
+}
@@ -0,0 +1,164 @@
+/*
+  ParallelViaRouting - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <osmscout/Database.h>
+
+#include <osmscout/routing/SimpleRoutingService.h>
+#include <osmscout/routing/RoutingProfile.h>
+
+#include <osmscout/util/Breaker.h>
+
+#include "GridDatabase.h"
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+osmscout::DatabaseRef             database;
+osmscout::SimpleRoutingServiceRef router;
+
+static const MixedGridDatabase grid(40,0.002);
+
+static osmscout::RoutingResult CalculateRoute(osmscout::RoutingProfile& profile,
+                                              size_t threadCount,
+                                              bool useRouteGraph,
+                                              const osmscout::BreakerRef& breaker=nullptr)
+{
+  osmscout::RoutingParameter parameter;
+
+  parameter.SetThreadCount(threadCount);
+  parameter.SetUseRouteGraph(useRouteGraph);
+  parameter.SetBreaker(breaker);
+
+  return router->CalculateRouteViaCoords(profile,
+                                         grid.GetRandomCoords(24,17),
+                                         osmscout::Distance::Of<osmscout::Kilometer>(1),
+                                         parameter);
+}
+
+static void CheckEqual(const osmscout::RoutingResult& expected,
+                       const osmscout::RoutingResult& actual)
+{
+  const auto& expectedEntries=expected.GetRoute().Entries();
+  const auto& actualEntries=actual.GetRoute().Entries();
+
+  REQUIRE(expectedEntries.size()==actualEntries.size());
+
+  auto expectedEntry=expectedEntries.begin();
+  auto actualEntry=actualEntries.begin();
+
+  while (expectedEntry!=expectedEntries.end()) {
+    REQUIRE(expectedEntry->GetDatabaseId()==actualEntry->GetDatabaseId());
+    REQUIRE(expectedEntry->GetCurrentNodeId()==actualEntry->GetCurrentNodeId());
+    REQUIRE(expectedEntry->GetCurrentNodeIndex()==actualEntry->GetCurrentNodeIndex());
+    REQUIRE(expectedEntry->GetPathObject()==actualEntry->GetPathObject());
+    REQUIRE(expectedEntry->GetTargetNodeIndex()==actualEntry->GetTargetNodeIndex());
+    REQUIRE(expectedEntry->GetObjects()==actualEntry->GetObjects());
+
+    ++expectedEntry;
+    ++actualEntry;
+  }
+}
+
+TEST_CASE("Parallel via legs match the sequential calculation")
+{
+  std::map<std::string,double>        speedMap{{"highway_primary",70.0},
+                                               {"highway_residential",40.0}};
+  osmscout::FastestPathRoutingProfile profile(database->GetTypeConfig());
+
+  profile.ParametrizeForCar(*database->GetTypeConfig(),
+                            speedMap,
+                            160.0);
+
+  for (bool useRouteGraph : {true,false}) {
+    osmscout::RoutingResult sequential=CalculateRoute(profile,1,useRouteGraph);
+
+    REQUIRE(sequential.Success());
+
+    for (size_t threadCount : {2,4,8}) {
+      osmscout::RoutingResult parallel=CalculateRoute(profile,threadCount,useRouteGraph);
+
+      REQUIRE(parallel.Success());
+      CheckEqual(sequential,parallel);
+    }
+  }
+}
+
+TEST_CASE("Parallel via legs can be aborted")
+{
+  osmscout::ShortestPathRoutingProfile profile(database->GetTypeConfig());
+  osmscout::BreakerRef                 breaker=std::make_shared<osmscout::ThreadedBreaker>();
+
+  profile.ParametrizeForFoot(*database->GetTypeConfig(),
+                             5.0);
+
+  REQUIRE(CalculateRoute(profile,4,true,breaker).Success());
+
+  breaker->Break();
+
+  REQUIRE_FALSE(CalculateRoute(profile,4,true,breaker).Success());
+}
+
+int main(int argc, char* argv[])
+{
+  osmscout::ImportParameter importParameter;
+
+  importParameter.AddRouter(osmscout::ImportParameter::Router(osmscout::vehicleBicycle|osmscout::vehicleFoot|osmscout::vehicleCar,
+                                                              osmscout::RoutingService::DEFAULT_FILENAME_BASE));
+  importParameter.SetRouterGraph(true);
+
+  int importResult=grid.Import(importParameter);
+
+  if (importResult!=0) {
+    return importResult;
+  }
+
+  osmscout::DatabaseParameter dbParameter;
+
+  database=std::make_shared<osmscout::Database>(dbParameter);
+
+  if (!database->Open(".")) {
+    std::cerr << "Cannot open database" << std::endl;
+    return 1;
+  }
+
+  router=std::make_shared<osmscout::SimpleRoutingService>(database,
+                                                          osmscout::RouterParameter(),
+                                                          osmscout::RoutingService::DEFAULT_FILENAME_BASE);
+
+  if (!router->Open()) {
+    std::cerr << "Cannot open routing database" << std::endl;
+    return 1;
+  }
+
+  int result=Catch::Session().run(argc,argv);
+
+  router->Close();
+  router.reset();
+  database->Close();
+  database.reset();
+
+  return result;
+}
@@ -0,0 +1,168 @@
+#include <cstdlib>
+#include <vector>
+
+#include <osmscout/PointArrayView.h>
+
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+#include <osmscout/util/Geometry.h>
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/**
+ * Create a random walk of points starting at the given coordinate. The maximum step
+ * size controls the size of the deltas and thus the encoding of the point array.
+ */
+static std::vector<osmscout::Point> CreatePoints(size_t count,
+                                                 double maxStep,
+                                                 bool withSerials)
+{
+  std::vector<osmscout::Point> points;
+  double                       lat=51.5;
+  double                       lon=7.4;
+
+  srand(count);
+
+  for (size_t i=0; i<count; i++) {
+    uint8_t serial=0;
+
+    if (withSerials && i%3==0) {
+      serial=(uint8_t)(i%255+1);
+    }
+
+    points.push_back(osmscout::Point(serial,
+                                     osmscout::GeoCoord(lat,lon)));
+
+    lat+=maxStep*(rand()/(double)RAND_MAX-0.5);
+    lon+=maxStep*(rand()/(double)RAND_MAX-0.5);
+  }
+
+  return points;
+}
+
+/**
+ * Write the given point arrays to a file and compare the result of reading them
+ * via FileScanner::Read() and via PointArrayView.
+ */
+static void CheckPointArrays(const std::vector<std::vector<osmscout::Point>>& arrays,
+                             bool writeIds)
+{
+  osmscout::FileWriter writer;
+
+  writer.Open("pointarrayview.dat");
+
+  for (const auto& array : arrays) {
+    writer.Write(array,
+                 writeIds);
+  }
+
+  writer.Write((uint32_t)4711);
+  writer.Close();
+
+  osmscout::FileScanner scanner;
+  osmscout::FileScanner mappedScanner;
+
+  scanner.Open("pointarrayview.dat",osmscout::FileScanner::Normal,false);
+  mappedScanner.Open("pointarrayview.dat",osmscout::FileScanner::Normal,true);
+
+  REQUIRE(mappedScanner.IsMemoryMapped());
+
+  std::vector<osmscout::GeoCoord> coords;
+
+  for (size_t a=0; a<arrays.size(); a++) {
+    std::vector<osmscout::Point> expected;
+    std::vector<osmscout::Point> points;
+    osmscout::PackedPointArray   packed;
+    osmscout::PointArrayView     view;
+
+    scanner.Read(expected,
+                 writeIds);
+    view.Read(mappedScanner,
+              writeIds);
+
+    REQUIRE(view.GetSize()==expected.size());
+    REQUIRE(mappedScanner.GetPos()==scanner.GetPos());
+
+    view.GetPoints(points);
+    view.GetCoords(coords);
+    view.GetPackedPoints(packed);
+
+    REQUIRE(packed.GetSize()==expected.size());
+
+    size_t idx=0;
+
+    for (const auto coord : view) {
+      REQUIRE(coord==expected[idx].GetCoord());
+      REQUIRE(coords[idx]==expected[idx].GetCoord());
+      REQUIRE(points[idx].GetCoord()==expected[idx].GetCoord());
+      REQUIRE(points[idx].GetSerial()==expected[idx].GetSerial());
+      REQUIRE(packed.GetCoord(idx)==expected[idx].GetCoord());
+      REQUIRE(packed.GetId(idx)==expected[idx].GetId());
+      idx++;
+    }
+
+    REQUIRE(idx==expected.size());
+
+    if (!expected.empty()) {
+      osmscout::GeoBox expectedBox;
+
+      osmscout::GetBoundingBox(expected,
+                               expectedBox);
+
+      REQUIRE(view.GetBoundingBox().GetMinCoord()==expectedBox.GetMinCoord());
+      REQUIRE(view.GetBoundingBox().GetMaxCoord()==expectedBox.GetMaxCoord());
+    }
+  }
+
+  uint32_t marker;
+
+  mappedScanner.Read(marker);
+
+  REQUIRE(marker==4711);
+
+  scanner.Close();
+  mappedScanner.Close();
+}
+
+TEST_CASE("Decode point arrays with small, medium and large deltas") {
+  std::vector<std::vector<osmscout::Point>> arrays;
+
+  arrays.push_back(CreatePoints(1,0.0,false));
+  arrays.push_back(CreatePoints(2,0.00001,false));
+  arrays.push_back(CreatePoints(17,0.00001,false));
+  arrays.push_back(CreatePoints(100,0.001,false));
+  arrays.push_back(CreatePoints(5000,0.1,false));
+
+  CheckPointArrays(arrays,false);
+}
+
+TEST_CASE("Decode point arrays with serials") {
+  std::vector<std::vector<osmscout::Point>> arrays;
+
+  arrays.push_back(CreatePoints(1,0.0,true));
+  arrays.push_back(CreatePoints(9,0.00001,true));
+  arrays.push_back(CreatePoints(100,0.001,true));
+  arrays.push_back(CreatePoints(3000,0.1,true));
+  arrays.push_back(CreatePoints(20,0.00001,false));
+
+  CheckPointArrays(arrays,true);
+}
+
+TEST_CASE("View requires memory mapped file") {
+  osmscout::FileWriter writer;
+
+  writer.Open("pointarrayview.dat");
+  writer.Write(CreatePoints(10,0.001,false),false);
+  writer.Close();
+
+  osmscout::FileScanner    scanner;
+  osmscout::PointArrayView view;
+
+  scanner.Open("pointarrayview.dat",osmscout::FileScanner::Normal,false);
+
+  REQUIRE_FALSE(scanner.IsMemoryMapped());
+  REQUIRE_THROWS_AS(view.Read(scanner,false),osmscout::IOException);
+
+  scanner.Close();
+}
@@ -0,0 +1,178 @@
+/*
+  ReachabilityTest - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <osmscout/Database.h>
+
+#include <osmscout/routing/RoutingProfile.h>
+#include <osmscout/routing/SimpleRoutingService.h>
+
+#include "GridDatabase.h"
+#include "RouteCosts.h"
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+static const MixedGridDatabase grid(15,0.002);
+
+osmscout::DatabaseRef             database;
+osmscout::SimpleRoutingServiceRef router;
+
+static const double COST_LIMIT=0.02; // hours
+
+/**
+ * Return the node of the result at the given coordinate or nullptr. Stored
+ * coordinates are rounded, so the coordinates are compared with a tolerance.
+ */
+static const osmscout::ReachabilityResult::Node* FindNode(const osmscout::ReachabilityResult& result,
+                                                         const osmscout::GeoCoord& coord)
+{
+  for (const auto& node : result.GetNodes()) {
+    if (node.coord.GetDistance(coord).AsMeter()<1.0) {
+      return &node;
+    }
+  }
+
+  return nullptr;
+}
+
+TEST_CASE("Reachable nodes are exactly the nodes with routes within the limit")
+{
+  osmscout::FastestPathRoutingProfileRef profile=std::make_shared<osmscout::FastestPathRoutingProfile>(database->GetTypeConfig());
+  std::map<std::string,double>           speedMap{{"highway_primary",70.0},
+                                                  {"highway_residential",40.0}};
+
+  profile->ParametrizeForCar(*database->GetTypeConfig(),
+                             speedMap,
+                             160.0);
+
+  size_t                  startRow=grid.size/2;
+  size_t                  startColumn=grid.size/2;
+  osmscout::RoutePosition start=router->GetClosestRoutableNode(grid.GetCoord(startRow,startColumn),
+                                                               *profile,
+                                                               osmscout::Distance::Of<osmscout::Kilometer>(1));
+
+  REQUIRE(start.IsValid());
+
+  osmscout::ReachabilityResult result=router->CalculateReachability(*profile,
+                                                                    start,
+                                                                    COST_LIMIT,
+                                                                    osmscout::RoutingParameter());
+
+  REQUIRE(result.Success());
+
+  size_t reachableCount=0;
+  size_t unreachableCount=0;
+
+  for (size_t row=0; row<grid.size; row++) {
+    for (size_t column=0; column<grid.size; column++) {
+      if (row==startRow &&
+          column==startColumn) {
+        continue;
+      }
+
+      osmscout::GeoCoord      coord=grid.GetCoord(row,column);
+      osmscout::RoutePosition target=router->GetClosestRoutableNode(coord,
+                                                                    *profile,
+                                                                    osmscout::Distance::Of<osmscout::Kilometer>(1));
+
+      REQUIRE(target.IsValid());
+
+      osmscout::RoutingResult route=router->CalculateRoute(*profile,
+                                                           start,
+                                                           target,
+                                                           osmscout::RoutingParameter());
+
+      REQUIRE(route.Success());
+
+      double                                    costs=GetRouteCosts(database,*profile,route.GetRoute());
+      const osmscout::ReachabilityResult::Node* node=FindNode(result,coord);
+
+      INFO("Row " << row << ", column " << column << ", costs " << costs);
+      REQUIRE(costs>0.0);
+
+      // Skip nodes at the limit, rounding decides about them
+      if (costs==Approx(COST_LIMIT).epsilon(ROUTE_COSTS_EPSILON)) {
+        continue;
+      }
+
+      if (costs<COST_LIMIT) {
+        REQUIRE(node!=nullptr);
+        REQUIRE(node->cost==Approx(costs).epsilon(ROUTE_COSTS_EPSILON));
+        // The costs of the fastest path profile are the travel time
+        REQUIRE(node->time==Approx(costs).epsilon(ROUTE_COSTS_EPSILON));
+        reachableCount++;
+      }
+      else {
+        REQUIRE(node==nullptr);
+        unreachableCount++;
+      }
+    }
+  }
+
+  // The limit must cut the grid, else the test checks nothing
+  REQUIRE(reachableCount>0);
+  REQUIRE(unreachableCount>0);
+}
+
+int main(int argc, char* argv[])
+{
+  osmscout::ImportParameter importParameter;
+
+  importParameter.AddRouter(osmscout::ImportParameter::Router(osmscout::vehicleCar,
+                                                              osmscout::RoutingService::DEFAULT_FILENAME_BASE));
+
+  int importResult=grid.Import(importParameter);
+
+  if (importResult!=0) {
+    return importResult;
+  }
+
+  osmscout::DatabaseParameter dbParameter;
+
+  database=std::make_shared<osmscout::Database>(dbParameter);
+
+  if (!database->Open(".")) {
+    std::cerr << "Cannot open database" << std::endl;
+    return 1;
+  }
+
+  router=std::make_shared<osmscout::SimpleRoutingService>(database,
+                                                          osmscout::RouterParameter(),
+                                                          osmscout::RoutingService::DEFAULT_FILENAME_BASE);
+
+  if (!router->Open()) {
+    std::cerr << "Cannot open routing database" << std::endl;
+    return 1;
+  }
+
+  int result=Catch::Session().run(argc,argv);
+
+  router->Close();
+  router.reset();
+  database->Close();
+  database.reset();
+
+  return result;
+}
@@ -18,21 +18,104 @@
 */
 
 #include <iostream>
+#include <random>
+#include <vector>
 
 #include <osmscout/Way.h>
 
+#include <osmscout/util/CoordinateDecoding.h>
 #include <osmscout/util/FileScanner.h>
 #include <osmscout/util/StopClock.h>
 
 /**
-  Sequentially read the ways.dat file in the current directory first using
-  FileReader and then using FileScanner and compare execution time.
+  Measure decoding of coordinate arrays with all coordinate decoders supported by the
+  processor, then sequentially read the ways.dat file in the current directory using
+  FileScanner and measure execution time.
 
   Call this program repeately to avoid different timing because of OS file caching.
 */
 
+/**
+ * Decode random coordinate arrays of the given length and delta size with the given
+ * decoder and return the time per coordinate in nanoseconds.
+ */
+static double MeasureCoordinateDecoding(osmscout::CoordinateDecoderType type,
+                                        size_t deltaBytes,
+                                        size_t arraySize)
+{
+  const size_t                       coordCount=10000000;
+  std::mt19937                       generator(4711);
+  std::uniform_int_distribution<int> distribution(0,255);
+  std::vector<uint8_t>               deltas(arraySize*2*deltaBytes);
+  std::vector<uint32_t>              latValues(arraySize);
+  std::vector<uint32_t>              lonValues(arraySize);
+  std::vector<double>                lats(arraySize);
+  std::vector<double>                lons(arraySize);
+  uint32_t                           checksum=0;
+
+  for (auto& delta : deltas) {
+    delta=(uint8_t)distribution(generator);
+  }
+
+  osmscout::StopClockNano timer;
+
+  for (size_t i=0; i<coordCount/arraySize; i++) {
+    osmscout::DecodeCoordinateDeltas(type,
+                                     deltas.data(),
+                                     deltaBytes,
+                                     arraySize,
+                                     (uint32_t)i,
+                                     (uint32_t)i,
+                                     latValues.data(),
+                                     lonValues.data());
+    osmscout::ConvertCoordinateValues(type,
+                                      latValues.data(),
+                                      lonValues.data(),
+                                      arraySize,
+                                      lats.data(),
+                                      lons.data());
+
+    checksum+=latValues.back()+(uint32_t)lons.back();
+  }
+
+  timer.Stop();
+
+  // Make sure, the result is used
+  if (checksum==0) {
+    std::cout << "";
+  }
+
+  return timer.GetNanoseconds()/(coordCount/arraySize*arraySize);
+}
+
+static void MeasureCoordinateDecoding()
+{
+  std::cout << "Coordinate decoding (selected decoder: " << osmscout::GetCoordinateDecoderName(osmscout::GetCoordinateDecoderType()) << ")" << std::endl;
+
+  for (const auto type : {osmscout::CoordinateDecoderType::Scalar,
+                          osmscout::CoordinateDecoderType::SSE41,
+                          osmscout::CoordinateDecoderType::AVX2}) {
+    if (!osmscout::IsCoordinateDecoderSupported(type)) {
+      std::cout << osmscout::GetCoordinateDecoderName(type) << ": not supported" << std::endl;
+      continue;
+    }
+
+    for (size_t deltaBytes=1; deltaBytes<=3; deltaBytes++) {
+      std::cout << osmscout::GetCoordinateDecoderName(type) << ", " << deltaBytes << " byte deltas:";
+
+      for (size_t arraySize : {8,32,256,4096}) {
+        std::cout << " " << arraySize << " coords " << MeasureCoordinateDecoding(type,deltaBytes,arraySize) << " ns/coord";
+      }
+
+      std::cout << std::endl;
+    }
+  }
+}
+
 int main(int /*argc*/, char* /*argv*/[])
 {
+  MeasureCoordinateDecoding();
+
   std::string           wayFilename="ways.dat";
 
   osmscout::StopClock   scannerTimer;
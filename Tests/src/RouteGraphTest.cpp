@@ -0,0 +1,217 @@
+/*
+  RouteGraphTest - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <osmscout/Database.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+
+#include <osmscout/routing/RouteGraph.h>
+#include <osmscout/routing/RouteNode.h>
+#include <osmscout/routing/RoutingProfile.h>
+#include <osmscout/routing/SimpleRoutingService.h>
+
+#include "GridDatabase.h"
+#include "RouteCosts.h"
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+static const MixedGridDatabase grid(25,0.002);
+
+osmscout::DatabaseRef             database;
+osmscout::SimpleRoutingServiceRef router;
+
+/**
+ * Compare the costs of the routes with and without the route graph
+ * between pairs of positions
+ */
+static void CheckRouteCosts(const osmscout::RoutingProfileRef& profile)
+{
+  std::vector<osmscout::GeoCoord> positions=grid.GetRandomCoords(30,1234);
+  osmscout::RoutingParameter      parameter;
+  osmscout::RoutingParameter      graphParameter;
+
+  parameter.SetUseRouteGraph(false);
+  graphParameter.SetUseRouteGraph(true);
+
+  for (size_t i=0; i+1<positions.size(); i++) {
+    osmscout::RoutePosition start=router->GetClosestRoutableNode(positions[i],
+                                                                 *profile,
+                                                                 osmscout::Distance::Of<osmscout::Kilometer>(1));
+    osmscout::RoutePosition target=router->GetClosestRoutableNode(positions[i+1],
+                                                                  *profile,
+                                                                  osmscout::Distance::Of<osmscout::Kilometer>(1));
+
+    REQUIRE(start.IsValid());
+    REQUIRE(target.IsValid());
+
+    osmscout::RoutingResult expected=router->CalculateRoute(*profile,
+                                                            start,
+                                                            target,
+                                                            parameter);
+    osmscout::RoutingResult actual=router->CalculateRoute(*profile,
+                                                          start,
+                                                          target,
+                                                          graphParameter);
+
+    REQUIRE(expected.Success());
+    REQUIRE(actual.Success());
+
+    double expectedCosts=GetRouteCosts(database,*profile,expected.GetRoute());
+    double actualCosts=GetRouteCosts(database,*profile,actual.GetRoute());
+
+    INFO("Route " << i);
+    REQUIRE(expectedCosts>0.0);
+    REQUIRE(actualCosts==Approx(expectedCosts).epsilon(ROUTE_COSTS_EPSILON));
+  }
+}
+
+TEST_CASE("Route graph has the adjacency of the route nodes")
+{
+  osmscout::RouteGraph graph;
+
+  REQUIRE(graph.Open(osmscout::RoutingService::GetGraphFilename(osmscout::RoutingService::DEFAULT_FILENAME_BASE),
+                     false));
+
+  osmscout::FileScanner scanner;
+  osmscout::FileOffset  indexFileOffset;
+  uint32_t              dataCount;
+  uint32_t              tileMag;
+
+  scanner.Open(osmscout::RoutingService::GetDataFilename(osmscout::RoutingService::DEFAULT_FILENAME_BASE),
+               osmscout::FileScanner::Sequential,
+               false);
+
+  scanner.Read(indexFileOffset);
+  scanner.Read(dataCount);
+  scanner.Read(tileMag);
+
+  REQUIRE(graph.GetNodeCount()==dataCount);
+
+  size_t edgeCount=0;
+  size_t excludeCount=0;
+
+  for (uint32_t current=1; current<=dataCount; current++) {
+    osmscout::RouteNode node;
+
+    node.Read(scanner);
+
+    uint32_t index=graph.GetNodeIndex(node.GetId());
+
+    INFO("Route node " << node.GetId());
+    REQUIRE(index!=osmscout::RouteGraph::NO_NODE);
+    REQUIRE(graph.GetNodeId(index)==node.GetId());
+    REQUIRE(graph.GetNodeCoord(index).GetDistance(node.GetCoord()).AsMeter()<0.01);
+    REQUIRE(graph.GetEdgesEnd(index)-graph.GetEdgesBegin(index)==node.paths.size());
+
+    for (size_t i=0; i<node.paths.size(); i++) {
+      const osmscout::RouteNode::Path&       path=node.paths[i];
+      const osmscout::RouteNode::ObjectData& object=node.objects[path.objectIndex];
+      const osmscout::RouteGraph::Edge&      edge=graph.GetEdge(graph.GetEdgesBegin(index)+(uint32_t)i);
+
+      INFO("Path " << i);
+      REQUIRE(edge.target!=osmscout::RouteGraph::NO_NODE);
+      REQUIRE(graph.GetNodeId(edge.target)==path.id);
+      REQUIRE(edge.GetDistance().AsMeter()==Approx(path.distance.AsMeter()).margin(0.01));
+      REQUIRE(edge.flags==path.flags);
+      REQUIRE(graph.GetObject(edge.object)==object.object);
+      REQUIRE(edge.objectVariantIndex==object.objectVariantIndex);
+    }
+
+    edgeCount+=node.paths.size();
+    excludeCount+=node.excludes.size();
+  }
+
+  scanner.Close();
+
+  REQUIRE(graph.GetEdgeCount()==edgeCount);
+  REQUIRE(graph.GetExcludeCount()==excludeCount);
+}
+
+TEST_CASE("Car routes using the route graph have the costs of the A* routes")
+{
+  osmscout::FastestPathRoutingProfileRef profile=std::make_shared<osmscout::FastestPathRoutingProfile>(database->GetTypeConfig());
+  std::map<std::string,double>           speedMap{{"highway_primary",70.0},
+                                                  {"highway_residential",40.0}};
+
+  profile->ParametrizeForCar(*database->GetTypeConfig(),
+                             speedMap,
+                             160.0);
+
+  CheckRouteCosts(profile);
+}
+
+TEST_CASE("Foot routes using the route graph have the costs of the A* routes")
+{
+  osmscout::FastestPathRoutingProfileRef profile=std::make_shared<osmscout::FastestPathRoutingProfile>(database->GetTypeConfig());
+
+  profile->ParametrizeForFoot(*database->GetTypeConfig(),
+                              5.0);
+
+  CheckRouteCosts(profile);
+}
+
+int main(int argc, char* argv[])
+{
+  osmscout::ImportParameter importParameter;
+
+  importParameter.AddRouter(osmscout::ImportParameter::Router(osmscout::vehicleFoot|osmscout::vehicleCar,
+                                                              osmscout::RoutingService::DEFAULT_FILENAME_BASE));
+  importParameter.SetRouterGraph(true);
+
+  int importResult=grid.Import(importParameter);
+
+  if (importResult!=0) {
+    return importResult;
+  }
+
+  osmscout::DatabaseParameter dbParameter;
+
+  database=std::make_shared<osmscout::Database>(dbParameter);
+
+  if (!database->Open(".")) {
+    std::cerr << "Cannot open database" << std::endl;
+    return 1;
+  }
+
+  router=std::make_shared<osmscout::SimpleRoutingService>(database,
+                                                          osmscout::RouterParameter(),
+                                                          osmscout::RoutingService::DEFAULT_FILENAME_BASE);
+
+  if (!router->Open()) {
+    std::cerr << "Cannot open routing database" << std::endl;
+    return 1;
+  }
+
+  int result=Catch::Session().run(argc,argv);
+
+  router->Close();
+  router.reset();
+  database->Close();
+  database.reset();
+
+  return result;
+}
@@ -0,0 +1,99 @@
+#include <osmscout/routing/RouteNode.h>
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+static osmscout::RouteNode::Path CreatePath(osmscout::Id id,
+                                            uint8_t objectIndex)
+{
+  osmscout::RouteNode::Path path;
+
+  path.id=id;
+  path.objectIndex=objectIndex;
+  path.flags=0;
+
+  return path;
+}
+
+/**
+ * Route node with three ways, where the order of the paths does not match
+ * the order of the objects:
+ *
+ * path 0 => way 30 (object 2)
+ * path 1 => way 20 (object 1)
+ * path 2 => way 10 (object 0)
+ */
+static osmscout::RouteNode CreateRouteNode()
+{
+  osmscout::RouteNode routeNode;
+
+  routeNode.Initialize(0,
+                       osmscout::Point(0,osmscout::GeoCoord(0.0,0.0)));
+
+  routeNode.AddObject(osmscout::ObjectFileRef(10,osmscout::refWay),0);
+  routeNode.AddObject(osmscout::ObjectFileRef(20,osmscout::refWay),0);
+  routeNode.AddObject(osmscout::ObjectFileRef(30,osmscout::refWay),0);
+
+  routeNode.paths.push_back(CreatePath(3,2));
+  routeNode.paths.push_back(CreatePath(2,1));
+  routeNode.paths.push_back(CreatePath(1,0));
+
+  return routeNode;
+}
+
+TEST_CASE("Route node without excludes allows every turn")
+{
+  osmscout::RouteNode routeNode=CreateRouteNode();
+
+  for (const auto& source : routeNode.objects) {
+    for (const auto& target : routeNode.objects) {
+      REQUIRE(routeNode.CanTurn(source.object,target.object));
+    }
+  }
+}
+
+TEST_CASE("Exclude target is resolved via the path")
+{
+  osmscout::RouteNode          routeNode=CreateRouteNode();
+  osmscout::RouteNode::Exclude exclude;
+
+  // Coming from way 10 you must not use path 0, which is way 30
+  exclude.source=osmscout::ObjectFileRef(10,osmscout::refWay);
+  exclude.targetIndex=0;
+
+  routeNode.excludes.push_back(exclude);
+
+  REQUIRE_FALSE(routeNode.CanTurn(osmscout::ObjectFileRef(10,osmscout::refWay),
+                                  osmscout::ObjectFileRef(30,osmscout::refWay)));
+
+  // Object 0 is the source way itself, it is not excluded
+  REQUIRE(routeNode.CanTurn(osmscout::ObjectFileRef(10,osmscout::refWay),
+                            osmscout::ObjectFileRef(10,osmscout::refWay)));
+  REQUIRE(routeNode.CanTurn(osmscout::ObjectFileRef(10,osmscout::refWay),
+                            osmscout::ObjectFileRef(20,osmscout::refWay)));
+
+  // The exclude only applies to the given source
+  REQUIRE(routeNode.CanTurn(osmscout::ObjectFileRef(20,osmscout::refWay),
+                            osmscout::ObjectFileRef(30,osmscout::refWay)));
+}
+
+TEST_CASE("Multiple excludes for the same source")
+{
+  osmscout::RouteNode          routeNode=CreateRouteNode();
+  osmscout::RouteNode::Exclude exclude;
+
+  // Coming from way 30 you must neither use path 1 (way 20) nor path 2 (way 10)
+  exclude.source=osmscout::ObjectFileRef(30,osmscout::refWay);
+  exclude.targetIndex=1;
+  routeNode.excludes.push_back(exclude);
+
+  exclude.targetIndex=2;
+  routeNode.excludes.push_back(exclude);
+
+  REQUIRE_FALSE(routeNode.CanTurn(osmscout::ObjectFileRef(30,osmscout::refWay),
+                                  osmscout::ObjectFileRef(20,osmscout::refWay)));
+  REQUIRE_FALSE(routeNode.CanTurn(osmscout::ObjectFileRef(30,osmscout::refWay),
+                                  osmscout::ObjectFileRef(10,osmscout::refWay)));
+  REQUIRE(routeNode.CanTurn(osmscout::ObjectFileRef(30,osmscout::refWay),
+                            osmscout::ObjectFileRef(30,osmscout::refWay)));
+}
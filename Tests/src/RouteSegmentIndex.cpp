@@ -0,0 +1,337 @@
+/*
+  RouteSegmentIndex - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <osmscout/Database.h>
+
+#include <osmscout/routing/SimpleRoutingService.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/Geometry.h>
+
+#include "GridDatabase.h"
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+static const char*  FALLBACK_ROUTER="fallback";
+static const size_t QUERY_COUNT=500;
+static const double DISTANCE_TOLERANCE=0.5; // Tolerance in meters for comparing distances
+
+osmscout::DatabaseRef             database;
+osmscout::SimpleRoutingServiceRef router;         // uses the segment index
+osmscout::SimpleRoutingServiceRef fallbackRouter; // loads the ways around the location
+
+/**
+ * A grid of residential streets (about 40m x 65m). The cells with an even row and
+ * column are crossed diagonally by a footway between two junctions.
+ */
+class FootwayGridDatabase : public GridDatabase
+{
+public:
+  FootwayGridDatabase()
+  : GridDatabase(30,0.0006)
+  {
+    // no code
+  }
+
+  void AddWays(const osmscout::TypeConfig& typeConfig,
+               osmscout::OSMId wayId,
+               std::vector<osmscout::PreprocessorCallback::RawWayData>& ways) const override
+  {
+    for (size_t row=0; row+1<size; row+=2) {
+      for (size_t column=0; column+1<size; column+=2) {
+        osmscout::PreprocessorCallback::RawWayData wayData;
+
+        wayData.id=wayId++;
+        wayData.tags[typeConfig.GetTagId("highway")]="footway";
+        wayData.nodes.push_back(GetNodeId(row,column));
+        wayData.nodes.push_back(GetNodeId(row+1,column+1));
+
+        ways.push_back(std::move(wayData));
+      }
+    }
+  }
+};
+
+static const FootwayGridDatabase grid;
+
+static std::vector<osmscout::GeoCoord> GetQueryLocations(size_t count)
+{
+  std::mt19937                           random(4711);
+  std::uniform_real_distribution<double> distribution(-2.0,grid.size+1.0);
+  std::vector<osmscout::GeoCoord>        locations;
+
+  locations.reserve(count);
+
+  for (size_t i=0; i<count; i++) {
+    double row=distribution(random);
+    double column=distribution(random);
+
+    locations.push_back(grid.GetCoord(row,column));
+  }
+
+  return locations;
+}
+
+static bool IsFootway(const osmscout::ClosestRoutableObjectResult& result)
+{
+  return result.GetWay() &&
+         result.GetWay()->GetType()->GetName()=="highway_footway";
+}
+
+static void CompareResults(const osmscout::GeoCoord& location,
+                           const std::vector<osmscout::ClosestRoutableObjectResult>& results,
+                           const std::vector<osmscout::ClosestRoutableObjectResult>& expected)
+{
+  INFO("Location " << location.GetDisplayText());
+
+  // Without index the closest point of diagonal segments is calculated in degrees, so the distance
+  // may be slightly too large and objects close to the radius may be missing. The distances of the
+  // index must never be larger.
+  REQUIRE(results.size()>=expected.size());
+
+  for (size_t i=0; i<results.size(); i++) {
+    double distance=results[i].GetDistance().As<osmscout::Meter>();
+
+    REQUIRE(osmscout::GetEllipsoidalDistance(location,results[i].GetClosestPoint()).As<osmscout::Meter>()==Approx(distance).margin(DISTANCE_TOLERANCE));
+
+    if (i>0) {
+      REQUIRE(results[i-1].GetDistance()<=results[i].GetDistance());
+    }
+
+    if (i>=expected.size()) {
+      continue;
+    }
+
+    REQUIRE(distance<expected[i].GetDistance().As<osmscout::Meter>()+DISTANCE_TOLERANCE);
+
+    // Objects with (nearly) the same distance may be returned in any order
+    for (const auto& entry : expected) {
+      if (entry.GetObject()==results[i].GetObject()) {
+        REQUIRE(distance<entry.GetDistance().As<osmscout::Meter>()+DISTANCE_TOLERANCE);
+      }
+    }
+  }
+}
+
+TEST_CASE("Segment index is generated and loaded")
+{
+  REQUIRE(router->HasSegmentIndex());
+  REQUIRE_FALSE(fallbackRouter->HasSegmentIndex());
+}
+
+TEST_CASE("Closest objects match the results without index")
+{
+  osmscout::Distance              radius=osmscout::Distance::Of<osmscout::Meter>(100);
+  std::vector<osmscout::GeoCoord> locations=GetQueryLocations(QUERY_COUNT);
+
+  for (osmscout::Vehicle vehicle : {osmscout::vehicleCar,osmscout::vehicleFoot}) {
+    std::chrono::steady_clock::duration indexTime(0);
+    std::chrono::steady_clock::duration fallbackTime(0);
+    size_t                              resultCount=0;
+
+    for (const auto& location : locations) {
+      auto start=std::chrono::steady_clock::now();
+      auto results=router->GetClosestRoutableObjects(location,vehicle,radius,3);
+      auto middle=std::chrono::steady_clock::now();
+      auto expected=fallbackRouter->GetClosestRoutableObjects(location,vehicle,radius,3);
+      auto end=std::chrono::steady_clock::now();
+
+      indexTime+=middle-start;
+      fallbackTime+=end-middle;
+      resultCount+=results.size();
+
+      CompareResults(location,results,expected);
+
+      for (const auto& result : results) {
+        if (vehicle==osmscout::vehicleCar) {
+          REQUIRE_FALSE(IsFootway(result));
+        }
+      }
+    }
+
+    REQUIRE(resultCount>0);
+
+    std::cout << (vehicle==osmscout::vehicleCar ? "car" : "foot") << ": "
+              << std::chrono::duration_cast<std::chrono::microseconds>(indexTime).count()/locations.size() << "us per query with index, "
+              << std::chrono::duration_cast<std::chrono::microseconds>(fallbackTime).count()/locations.size() << "us without" << std::endl;
+  }
+}
+
+TEST_CASE("Results are filtered by vehicle")
+{
+  // The center of a cell crossed by a footway
+  osmscout::GeoCoord location=grid.GetCoord(10.5,10.5);
+  osmscout::Distance radius=osmscout::Distance::Of<osmscout::Meter>(100);
+
+  osmscout::ClosestRoutableObjectResult foot=router->GetClosestRoutableObject(location,
+                                                                             osmscout::vehicleFoot,
+                                                                             radius);
+  osmscout::ClosestRoutableObjectResult car=router->GetClosestRoutableObject(location,
+                                                                            osmscout::vehicleCar,
+                                                                            radius);
+
+  REQUIRE(IsFootway(foot));
+  REQUIRE(foot.GetDistance().As<osmscout::Meter>()<1.0);
+
+  REQUIRE(car.GetWay());
+  REQUIRE_FALSE(IsFootway(car));
+  REQUIRE(car.GetDistance().As<osmscout::Meter>()>20.0);
+
+  // No routable object within the radius
+  osmscout::ClosestRoutableObjectResult none=router->GetClosestRoutableObject(osmscout::GeoCoord(grid.lat-0.01,grid.lon-0.01),
+                                                                             osmscout::vehicleCar,
+                                                                             radius);
+
+  REQUIRE_FALSE(none.GetWay());
+  REQUIRE_FALSE(none.GetArea());
+}
+
+TEST_CASE("Closest routable node is the closer node of the closest segment")
+{
+  std::map<std::string,double>        speedMap{{"highway_residential",40.0}};
+  osmscout::FastestPathRoutingProfile profile(database->GetTypeConfig());
+  osmscout::Distance                  radius=osmscout::Distance::Of<osmscout::Meter>(100);
+  std::vector<osmscout::GeoCoord>     locations=GetQueryLocations(QUERY_COUNT);
+
+  profile.ParametrizeForCar(*database->GetTypeConfig(),
+                            speedMap,
+                            160.0);
+
+  for (const auto& location : locations) {
+    osmscout::ClosestRoutableObjectResult closest=fallbackRouter->GetClosestRoutableObject(location,
+                                                                                          osmscout::vehicleCar,
+                                                                                          radius);
+    osmscout::RoutePosition               position=router->GetClosestRoutableNode(location,
+                                                                               profile,
+                                                                               radius);
+
+    if (!closest.GetWay()) {
+      REQUIRE_FALSE(position.IsValid());
+      continue;
+    }
+
+    INFO("Location " << location.GetDisplayText());
+
+    REQUIRE(position.IsValid());
+    REQUIRE(position.GetObjectFileRef().GetType()==osmscout::refWay);
+
+    osmscout::WayRef way;
+
+    REQUIRE(database->GetWayByOffset(position.GetObjectFileRef().GetFileOffset(),way));
+    REQUIRE(position.GetNodeIndex()<way->nodes.size());
+
+    // The way is (one of) the closest ways
+    double wayDistance=std::numeric_limits<double>::max();
+
+    for (size_t i=0; i+1<way->nodes.size(); i++) {
+      double r,lon,lat;
+
+      osmscout::DistanceToSegment(location.GetLon(),location.GetLat(),
+                                  way->nodes[i].GetLon(),way->nodes[i].GetLat(),
+                                  way->nodes[i+1].GetLon(),way->nodes[i+1].GetLat(),
+                                  r,lon,lat);
+
+      wayDistance=std::min(wayDistance,
+                           osmscout::GetEllipsoidalDistance(location,osmscout::GeoCoord(lat,lon)).As<osmscout::Meter>());
+    }
+
+    REQUIRE(wayDistance<closest.GetDistance().As<osmscout::Meter>()+DISTANCE_TOLERANCE);
+
+    // The node is the closer end of the closest segment
+    const osmscout::GeoCoord& node=way->nodes[position.GetNodeIndex()].GetCoord();
+    double                    nodeDistance=osmscout::GetEllipsoidalDistance(location,node).As<osmscout::Meter>();
+
+    if (position.GetNodeIndex()>0) {
+      REQUIRE(nodeDistance<=osmscout::GetEllipsoidalDistance(location,way->nodes[position.GetNodeIndex()-1].GetCoord()).As<osmscout::Meter>()+DISTANCE_TOLERANCE);
+    }
+
+    if (position.GetNodeIndex()+1<way->nodes.size()) {
+      REQUIRE(nodeDistance<=osmscout::GetEllipsoidalDistance(location,way->nodes[position.GetNodeIndex()+1].GetCoord()).As<osmscout::Meter>()+DISTANCE_TOLERANCE);
+    }
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  osmscout::ImportParameter importParameter;
+
+  importParameter.AddRouter(osmscout::ImportParameter::Router(osmscout::vehicleBicycle|osmscout::vehicleFoot|osmscout::vehicleCar,
+                                                              osmscout::RoutingService::DEFAULT_FILENAME_BASE));
+  importParameter.AddRouter(osmscout::ImportParameter::Router(osmscout::vehicleBicycle|osmscout::vehicleFoot|osmscout::vehicleCar,
+                                                              FALLBACK_ROUTER));
+  importParameter.SetRouterSegmentIndex(true);
+
+  int importResult=grid.Import(importParameter);
+
+  if (importResult!=0) {
+    return importResult;
+  }
+
+  // The second router shares all other data, but has to load the ways around the location
+  if (!osmscout::RemoveFile(osmscout::AppendFileToDir(".",
+                                                      osmscout::RoutingService::GetSegmentIndexFilename(FALLBACK_ROUTER)))) {
+    std::cerr << "Cannot remove segment index of the fallback router" << std::endl;
+    return 1;
+  }
+
+  osmscout::DatabaseParameter dbParameter;
+
+  database=std::make_shared<osmscout::Database>(dbParameter);
+
+  if (!database->Open(".")) {
+    std::cerr << "Cannot open database" << std::endl;
+    return 1;
+  }
+
+  router=std::make_shared<osmscout::SimpleRoutingService>(database,
+                                                          osmscout::RouterParameter(),
+                                                          osmscout::RoutingService::DEFAULT_FILENAME_BASE);
+  fallbackRouter=std::make_shared<osmscout::SimpleRoutingService>(database,
+                                                                  osmscout::RouterParameter(),
+                                                                  FALLBACK_ROUTER);
+
+  if (!router->Open() ||
+      !fallbackRouter->Open()) {
+    std::cerr << "Cannot open routing database" << std::endl;
+    return 1;
+  }
+
+  int result=Catch::Session().run(argc,argv);
+
+  fallbackRouter->Close();
+  fallbackRouter.reset();
+  router->Close();
+  router.reset();
+  database->Close();
+  database.reset();
+
+  return result;
+}
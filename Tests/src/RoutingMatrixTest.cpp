@@ -0,0 +1,144 @@
+/*
+  RoutingMatrixTest - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <osmscout/Database.h>
+
+#include <osmscout/routing/RoutingProfile.h>
+#include <osmscout/routing/SimpleRoutingService.h>
+
+#include "GridDatabase.h"
+#include "RouteCosts.h"
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+static const MixedGridDatabase grid(25,0.002);
+
+osmscout::DatabaseRef             database;
+osmscout::SimpleRoutingServiceRef router;
+
+static std::vector<osmscout::RoutePosition> GetPositions(const osmscout::RoutingProfile& profile,
+                                                         size_t count,
+                                                         size_t seed)
+{
+  std::vector<osmscout::RoutePosition> positions;
+
+  for (const auto& coord : grid.GetRandomCoords(count,seed)) {
+    positions.push_back(router->GetClosestRoutableNode(coord,
+                                                       profile,
+                                                       osmscout::Distance::Of<osmscout::Kilometer>(1)));
+    REQUIRE(positions.back().IsValid());
+  }
+
+  return positions;
+}
+
+TEST_CASE("Matrix entries have the costs of the single routes")
+{
+  osmscout::FastestPathRoutingProfileRef profile=std::make_shared<osmscout::FastestPathRoutingProfile>(database->GetTypeConfig());
+  std::map<std::string,double>           speedMap{{"highway_primary",70.0},
+                                                  {"highway_residential",40.0}};
+
+  profile->ParametrizeForCar(*database->GetTypeConfig(),
+                             speedMap,
+                             160.0);
+
+  std::vector<osmscout::RoutePosition> sources=GetPositions(*profile,6,42);
+  std::vector<osmscout::RoutePosition> targets=GetPositions(*profile,7,4711);
+
+  for (size_t threadCount : {1,3}) {
+    osmscout::RoutingParameter parameter;
+
+    parameter.SetThreadCount(threadCount);
+
+    osmscout::RoutingMatrix matrix=router->CalculateMatrix(*profile,
+                                                           sources,
+                                                           targets,
+                                                           parameter);
+
+    REQUIRE(matrix.GetSourceCount()==sources.size());
+    REQUIRE(matrix.GetTargetCount()==targets.size());
+
+    for (size_t source=0; source<sources.size(); source++) {
+      for (size_t target=0; target<targets.size(); target++) {
+        const osmscout::RoutingMatrix::Entry& entry=matrix.Get(source,target);
+        osmscout::RoutingResult               route=router->CalculateRoute(*profile,
+                                                                           sources[source],
+                                                                           targets[target],
+                                                                           osmscout::RoutingParameter());
+
+        INFO("Source " << source << ", target " << target);
+        REQUIRE(route.Success());
+        REQUIRE(entry.found);
+
+        // Positions are route nodes, so the route has the costs of the entry
+        REQUIRE(entry.cost==Approx(GetRouteCosts(database,*profile,route.GetRoute())).epsilon(ROUTE_COSTS_EPSILON));
+        // The costs of the fastest path profile are the travel time
+        REQUIRE(entry.time==Approx(entry.cost));
+      }
+    }
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  osmscout::ImportParameter importParameter;
+
+  importParameter.AddRouter(osmscout::ImportParameter::Router(osmscout::vehicleFoot|osmscout::vehicleCar,
+                                                              osmscout::RoutingService::DEFAULT_FILENAME_BASE));
+
+  int importResult=grid.Import(importParameter);
+
+  if (importResult!=0) {
+    return importResult;
+  }
+
+  osmscout::DatabaseParameter dbParameter;
+
+  database=std::make_shared<osmscout::Database>(dbParameter);
+
+  if (!database->Open(".")) {
+    std::cerr << "Cannot open database" << std::endl;
+    return 1;
+  }
+
+  router=std::make_shared<osmscout::SimpleRoutingService>(database,
+                                                          osmscout::RouterParameter(),
+                                                          osmscout::RoutingService::DEFAULT_FILENAME_BASE);
+
+  if (!router->Open()) {
+    std::cerr << "Cannot open routing database" << std::endl;
+    return 1;
+  }
+
+  int result=Catch::Session().run(argc,argv);
+
+  router->Close();
+  router.reset();
+  database->Close();
+  database.reset();
+
+  return result;
+}
@@ -0,0 +1,187 @@
+/*
+  StyleConfigLookup - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <osmscout/StyleConfig.h>
+
+#include <osmscout/TypeFeatures.h>
+
+#include <osmscout/util/Projection.h>
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+static osmscout::TypeConfigRef typeConfig;
+
+static const char* STYLE=
+  "OSS\n"
+  "STYLE\n"
+  "  [TYPE highway_residential] {\n"
+  "    WAY {color: #ff0000; width: 4m; }\n"
+  "    [FEATURE Bridge] WAY {color: #00ff00; }\n"
+  "    [FEATURE Tunnel] WAY {width: 2m; }\n"
+  "  }\n"
+  "  [TYPE highway_service] {\n"
+  "    WAY {color: #ff0000; width: 4m; }\n"
+  "    [FEATURE Tunnel] WAY {width: 0m; }\n"
+  "  }\n"
+  "END\n";
+
+static osmscout::FeatureValueBuffer CreateBuffer(const std::string& typeName,
+                                                 const std::vector<std::string>& features)
+{
+  osmscout::TypeInfoRef        type=typeConfig->GetTypeInfo(typeName);
+  osmscout::FeatureValueBuffer buffer;
+
+  REQUIRE(type);
+
+  buffer.SetType(type);
+
+  for (const auto& feature : features) {
+    size_t index;
+
+    REQUIRE(type->GetFeature(feature,index));
+
+    buffer.AllocateValue(index);
+  }
+
+  return buffer;
+}
+
+static osmscout::StyleConfigRef LoadStyle()
+{
+  osmscout::StyleConfigRef styleConfig=std::make_shared<osmscout::StyleConfig>(typeConfig);
+
+  REQUIRE(styleConfig->LoadContent(STYLE));
+
+  return styleConfig;
+}
+
+static osmscout::LineStyleRef GetLineStyle(const osmscout::StyleConfig& styleConfig,
+                                           const osmscout::FeatureValueBuffer& buffer)
+{
+  osmscout::MercatorProjection      projection;
+  std::vector<osmscout::LineStyleRef> lineStyles;
+
+  projection.Set(osmscout::GeoCoord(51.0,7.0),
+                 osmscout::Magnification(osmscout::MagnificationLevel(15)),
+                 96.0,
+                 1024,
+                 1024);
+
+  styleConfig.GetWayLineStyles(buffer,
+                               projection,
+                               lineStyles);
+
+  REQUIRE(lineStyles.size()<=1);
+
+  return lineStyles.empty() ? nullptr : lineStyles.front();
+}
+
+TEST_CASE("Styles of all matching selectors are composed")
+{
+  osmscout::StyleConfigRef styleConfig=LoadStyle();
+  osmscout::Color          red(1.0,0.0,0.0);
+  osmscout::Color          green(0.0,1.0,0.0);
+
+  osmscout::LineStyleRef plain=GetLineStyle(*styleConfig,CreateBuffer("highway_residential",{}));
+
+  REQUIRE(plain);
+  REQUIRE(plain->GetLineColor()==red);
+  REQUIRE(plain->GetWidth()==4.0);
+
+  osmscout::LineStyleRef bridge=GetLineStyle(*styleConfig,CreateBuffer("highway_residential",{osmscout::BridgeFeature::NAME}));
+
+  REQUIRE(bridge);
+  REQUIRE(bridge->GetLineColor()==green);
+  REQUIRE(bridge->GetWidth()==4.0);
+
+  osmscout::LineStyleRef tunnel=GetLineStyle(*styleConfig,CreateBuffer("highway_residential",{osmscout::TunnelFeature::NAME}));
+
+  REQUIRE(tunnel);
+  REQUIRE(tunnel->GetLineColor()==red);
+  REQUIRE(tunnel->GetWidth()==2.0);
+
+  osmscout::LineStyleRef both=GetLineStyle(*styleConfig,CreateBuffer("highway_residential",{osmscout::BridgeFeature::NAME,
+                                                                                           osmscout::TunnelFeature::NAME}));
+
+  REQUIRE(both);
+  REQUIRE(both->GetLineColor()==green);
+  REQUIRE(both->GetWidth()==2.0);
+}
+
+TEST_CASE("Composed styles are shared between objects")
+{
+  osmscout::StyleConfigRef styleConfig=LoadStyle();
+
+  osmscout::LineStyleRef first=GetLineStyle(*styleConfig,CreateBuffer("highway_residential",{osmscout::BridgeFeature::NAME}));
+  osmscout::LineStyleRef second=GetLineStyle(*styleConfig,CreateBuffer("highway_residential",{osmscout::BridgeFeature::NAME}));
+
+  REQUIRE(first);
+  REQUIRE(first==second);
+
+  osmscout::LineStyleRef plain=GetLineStyle(*styleConfig,CreateBuffer("highway_residential",{}));
+
+  REQUIRE(plain);
+  REQUIRE(plain!=first);
+}
+
+TEST_CASE("Invisible composed styles are dropped")
+{
+  osmscout::StyleConfigRef styleConfig=LoadStyle();
+
+  REQUIRE(GetLineStyle(*styleConfig,CreateBuffer("highway_service",{})));
+  REQUIRE(!GetLineStyle(*styleConfig,CreateBuffer("highway_service",{osmscout::TunnelFeature::NAME})));
+  REQUIRE(!GetLineStyle(*styleConfig,CreateBuffer("highway_primary",{})));
+}
+
+int main(int argc, char* argv[])
+{
+  char* testsTopDirEnv=getenv("TESTS_TOP_DIR");
+
+  if (testsTopDirEnv==nullptr) {
+    std::cerr << "Expected environment variable 'TESTS_TOP_DIR' not set" << std::endl;
+    // CMake-based tests would fail, if we do not exit here
+    return 1;
+  }
+
+  std::string testsTopDir=testsTopDirEnv;
+
+  if (testsTopDir.empty()) {
+    std::cerr << "Environment variable 'TESTS_TOP_DIR' is empty" << std::endl;
+    return 77;
+  }
+
+  typeConfig=std::make_shared<osmscout::TypeConfig>();
+
+  if (!typeConfig->LoadFromOSTFile(testsTopDir+"/../stylesheets/map.ost")) {
+    std::cerr << "Cannot load type configuration" << std::endl;
+    return 1;
+  }
+
+  int result=Catch::Session().run(argc,argv);
+
+  typeConfig=nullptr;
+
+  return result;
+}
@@ -0,0 +1,249 @@
+/*
+  ThreadedDatabasePerformance - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <osmscout/Database.h>
+
+#include <osmscout/util/StopClock.h>
+#include <osmscout/util/String.h>
+
+/**
+  Measure the throughput of concurrent way and area loading via the data files
+  of one shared Database instance with an increasing number of threads.
+
+  The test loads all ways and areas of the given database in chunks, with every
+  thread iterating over the full set of objects. The object caches can be
+  resized (or disabled by passing 0) to either measure cache or file access.
+*/
+
+static const size_t CHUNK_SIZE=1000;
+
+struct TestData
+{
+  std::vector<osmscout::FileOffset>    wayOffsets;
+  std::vector<osmscout::DataBlockSpan> areaSpans;
+};
+
+void LoadObjects(const osmscout::DatabaseRef& database,
+                 const TestData& testData,
+                 size_t iterationCount,
+                 size_t& objectCount,
+                 bool& result)
+{
+  osmscout::WayDataFileRef  wayDataFile=database->GetWayDataFile();
+  osmscout::AreaDataFileRef areaDataFile=database->GetAreaDataFile();
+
+  result=true;
+  objectCount=0;
+
+  for (size_t i=1; i<=iterationCount; i++) {
+    for (size_t start=0; start<testData.wayOffsets.size(); start+=CHUNK_SIZE) {
+      size_t                       end=std::min(start+CHUNK_SIZE,testData.wayOffsets.size());
+      std::vector<osmscout::WayRef> ways;
+
+      if (!wayDataFile->GetByOffset(testData.wayOffsets.begin()+start,
+                                    testData.wayOffsets.begin()+end,
+                                    end-start,
+                                    ways)) {
+        result=false;
+        return;
+      }
+
+      objectCount+=ways.size();
+    }
+
+    for (size_t start=0; start<testData.areaSpans.size(); start+=CHUNK_SIZE) {
+      size_t                         end=std::min(start+CHUNK_SIZE,testData.areaSpans.size());
+      std::vector<osmscout::AreaRef> areas;
+
+      if (!areaDataFile->GetByBlockSpans(testData.areaSpans.begin()+start,
+                                         testData.areaSpans.begin()+end,
+                                         areas)) {
+        result=false;
+        return;
+      }
+
+      objectCount+=areas.size();
+    }
+  }
+}
+
+bool CollectTestData(const osmscout::DatabaseRef& database,
+                     TestData& testData)
+{
+  osmscout::TypeConfigRef    typeConfig=database->GetTypeConfig();
+  osmscout::AreaWayIndexRef  areaWayIndex=database->GetAreaWayIndex();
+  osmscout::AreaAreaIndexRef areaAreaIndex=database->GetAreaAreaIndex();
+  osmscout::GeoBox           boundingBox;
+  osmscout::TypeInfoSet      wayTypes(typeConfig->GetWayTypes());
+  osmscout::TypeInfoSet      areaTypes(typeConfig->GetAreaTypes());
+  osmscout::TypeInfoSet      loadedWayTypes;
+  osmscout::TypeInfoSet      loadedAreaTypes;
+
+  if (!database->GetBoundingBox(boundingBox)) {
+    return false;
+  }
+
+  if (!areaWayIndex->GetOffsets(boundingBox,
+                                wayTypes,
+                                testData.wayOffsets,
+                                loadedWayTypes)) {
+    return false;
+  }
+
+  if (!areaAreaIndex->GetAreasInArea(*typeConfig,
+                                     boundingBox,
+                                     std::numeric_limits<size_t>::max(),
+                                     areaTypes,
+                                     testData.areaSpans,
+                                     loadedAreaTypes)) {
+    return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc<2 || argc>5) {
+    std::cerr << "ThreadedDatabasePerformance <database directory> [<max threads> [<iterations> [<data cache size>]]]" << std::endl;
+
+    return 1;
+  }
+
+  size_t maxThreads=std::max(std::thread::hardware_concurrency(),1u);
+  size_t iterationCount=3;
+  size_t cacheSize=osmscout::DatabaseParameter().GetWayDataCacheSize();
+
+  if (argc>=3 && !osmscout::StringToNumber(argv[2],maxThreads)) {
+    std::cerr << "Cannot parse max threads '" << argv[2] << "'" << std::endl;
+    return 1;
+  }
+
+  if (argc>=4 && !osmscout::StringToNumber(argv[3],iterationCount)) {
+    std::cerr << "Cannot parse iterations '" << argv[3] << "'" << std::endl;
+    return 1;
+  }
+
+  if (argc>=5 && !osmscout::StringToNumber(argv[4],cacheSize)) {
+    std::cerr << "Cannot parse data cache size '" << argv[4] << "'" << std::endl;
+    return 1;
+  }
+
+  osmscout::DatabaseParameter parameter;
+
+  parameter.SetWayDataCacheSize(cacheSize);
+  parameter.SetAreaDataCacheSize(cacheSize);
+
+  osmscout::DatabaseRef database=std::make_shared<osmscout::Database>(parameter);
+
+  std::cout << "Opening database..." << std::endl;
+
+  if (!database->Open(argv[1])) {
+    std::cerr << "Cannot open database" << std::endl;
+
+    return 1;
+  }
+
+  TestData testData;
+
+  std::cout << "Collecting test data..." << std::endl;
+
+  if (!CollectTestData(database,
+                       testData)) {
+    std::cerr << "Cannot collect test data" << std::endl;
+
+    return 1;
+  }
+
+  std::cout << " - " << testData.wayOffsets.size() << " way offset(s)" << std::endl;
+  std::cout << " - " << testData.areaSpans.size() << " area span(s)" << std::endl;
+
+  double singleThreadThroughput=0.0;
+  bool   result=true;
+
+  for (size_t threadCount=1; threadCount<=maxThreads; threadCount*=2) {
+    std::vector<std::thread> threads(threadCount);
+    std::vector<size_t>      objectCounts(threadCount,0);
+    std::unique_ptr<bool[]>  results(new bool[threadCount]);
+    size_t                   overallObjectCount=0;
+
+    osmscout::StopClock timer;
+
+    for (size_t i=0; i<threads.size(); i++) {
+      threads[i]=std::thread(LoadObjects,
+                             std::cref(database),
+                             std::cref(testData),
+                             iterationCount,
+                             std::ref(objectCounts[i]),
+                             std::ref(results[i]));
+    }
+
+    for (size_t i=0; i<threads.size(); i++) {
+      threads[i].join();
+
+      if (!results[i]) {
+        result=false;
+      }
+
+      overallObjectCount+=objectCounts[i];
+    }
+
+    timer.Stop();
+
+    double throughput=overallObjectCount/(timer.GetMilliseconds()/1000.0);
+
+    if (threadCount==1) {
+      singleThreadThroughput=throughput;
+    }
+
+    std::cout << std::setfill(' ') << std::setw(3) << threadCount << " thread(s): ";
+    std::cout << overallObjectCount << " objects in " << timer << ", ";
+    std::cout << std::fixed << std::setprecision(0) << throughput << " objects/s";
+
+    if (singleThreadThroughput>0.0) {
+      std::cout << ", speedup " << std::setprecision(2) << throughput/singleThreadThroughput;
+    }
+
+    std::cout << std::endl;
+  }
+
+  std::cout << "Closing database..." << std::endl;
+  database->Close();
+  database=nullptr;
+  std::cout << "Done." << std::endl;
+
+  if (!result) {
+    std::cerr << "Test result: ERROR" << std::endl;
+
+    return 1;
+  }
+
+  std::cout << "Test result: OK" << std::endl;
+
+  return 0;
+}
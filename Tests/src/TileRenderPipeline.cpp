@@ -0,0 +1,331 @@
+/*
+  TileRenderPipeline - a test program for libosmscout
+  Copyright (C) 2018  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <osmscout/Database.h>
+#include <osmscout/MapPainterNoOp.h>
+#include <osmscout/TileRenderPipeline.h>
+
+#include <osmscout/util/File.h>
+
+#include "GridDatabase.h"
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+static const GridDatabase grid(30,0.0006);
+
+static const size_t TILE_SIZE=64;
+static const size_t META_TILE_SIZE=2;
+static const char*  JOURNAL_FILE="journal.txt";
+
+typedef std::tuple<uint32_t,uint32_t,uint32_t> TileKey; // level, x, y
+
+osmscout::DatabaseRef    database;
+osmscout::MapServiceRef  mapService;
+osmscout::StyleConfigRef styleConfig;
+
+/**
+ * Runs the noop painter and fills each tile of the metatile with a color
+ * derived from its tile coordinates, so the slicing can be checked.
+ * Optionally aborts rendering after a number of metatiles.
+ */
+class TestDrawer : public osmscout::MetaTileDrawer
+{
+private:
+  osmscout::MapPainterNoOp painter;
+  std::atomic<size_t>&     drawCount;
+  size_t                   breakAfter;
+  osmscout::BreakerRef     breaker;
+
+public:
+  TestDrawer(std::atomic<size_t>& drawCount,
+             size_t breakAfter,
+             const osmscout::BreakerRef& breaker)
+  : painter(styleConfig),
+    drawCount(drawCount),
+    breakAfter(breakAfter),
+    breaker(breaker)
+  {
+    // no code
+  }
+
+  bool DrawMetaTile(const osmscout::Projection& projection,
+                    const osmscout::MapParameter& parameter,
+                    const osmscout::MapData& data,
+                    osmscout::TileBitmap& bitmap) override
+  {
+    if (!painter.DrawMap(projection,
+                         parameter,
+                         data)) {
+      return false;
+    }
+
+    double lon;
+    double lat;
+
+    projection.PixelToGeo(0.5,0.5,lon,lat);
+
+    osmscout::OSMTileId topLeftTile=osmscout::OSMTileId::GetOSMTile(projection.GetMagnification(),
+                                                                    osmscout::GeoCoord(lat,lon));
+
+    bitmap.Resize(osmscout::TileBitmap::RGBA32,
+                  projection.GetWidth(),
+                  projection.GetHeight());
+
+    for (size_t y=0; y<bitmap.GetHeight(); y++) {
+      unsigned char* pixel=bitmap.GetRow(y);
+
+      for (size_t x=0; x<bitmap.GetWidth(); x++) {
+        pixel[0]=(unsigned char)((topLeftTile.GetX()+x/TILE_SIZE) & 0xff);
+        pixel[1]=(unsigned char)((topLeftTile.GetY()+y/TILE_SIZE) & 0xff);
+        pixel[2]=(unsigned char)projection.GetMagnification().GetLevel();
+        pixel[3]=255;
+        pixel+=4;
+      }
+    }
+
+    if (breaker &&
+        ++drawCount>=breakAfter) {
+      breaker->Break();
+    }
+
+    return true;
+  }
+};
+
+/**
+ * Collects the tiles and checks their content
+ */
+class TestSink : public osmscout::TileSink
+{
+public:
+  std::mutex             mutex;
+  std::map<TileKey,bool> tiles; // Tile => content is valid
+  size_t                 duplicates=0;
+
+public:
+  bool StoreTile(const osmscout::MagnificationLevel& level,
+                 const osmscout::OSMTileId& tile,
+                 const std::vector<char>& data) override
+  {
+    std::string header="P6 "+std::to_string(TILE_SIZE)+" "+std::to_string(TILE_SIZE)+" 255\n";
+    bool        valid=data.size()==header.length()+TILE_SIZE*TILE_SIZE*3 &&
+                      std::string(data.data(),header.length())==header;
+
+    for (size_t i=header.length(); valid && i<data.size(); i+=3) {
+      valid=(unsigned char)data[i]==(tile.GetX() & 0xff) &&
+            (unsigned char)data[i+1]==(tile.GetY() & 0xff) &&
+            (unsigned char)data[i+2]==level.Get();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    TileKey                     key(level.Get(),tile.GetX(),tile.GetY());
+
+    if (tiles.find(key)!=tiles.end()) {
+      duplicates++;
+    }
+
+    tiles[key]=valid;
+
+    return true;
+  }
+};
+
+static size_t GetExpectedTileCount(uint32_t startLevel,
+                                   uint32_t endLevel)
+{
+  size_t count=0;
+
+  for (uint32_t level=startLevel; level<=endLevel; level++) {
+    osmscout::Magnification magnification{osmscout::MagnificationLevel(level)};
+    osmscout::OSMTileIdBox  box(osmscout::OSMTileId::GetOSMTile(magnification,grid.GetBoundingBox().GetMinCoord()),
+                                osmscout::OSMTileId::GetOSMTile(magnification,grid.GetBoundingBox().GetMaxCoord()));
+
+    count+=box.GetCount();
+  }
+
+  return count;
+}
+
+static std::unique_ptr<osmscout::TileRenderPipeline> CreatePipeline(const std::shared_ptr<TestSink>& sink,
+                                                                    std::atomic<size_t>& drawCount,
+                                                                    size_t breakAfter,
+                                                                    const osmscout::BreakerRef& breaker)
+{
+  std::unique_ptr<osmscout::TileRenderPipeline> pipeline(new osmscout::TileRenderPipeline(mapService,
+                                                                                          styleConfig,
+                                                                                          [&drawCount,breakAfter,breaker]() {
+                                                                                            return std::make_shared<TestDrawer>(drawCount,
+                                                                                                                                breakAfter,
+                                                                                                                                breaker);
+                                                                                          },
+                                                                                          std::make_shared<osmscout::PPMTileEncoder>(),
+                                                                                          sink));
+  osmscout::MapParameter                        mapParameter;
+
+  mapParameter.SetBreaker(breaker);
+
+  pipeline->SetMetaTileSize(META_TILE_SIZE);
+  pipeline->SetTileSize(TILE_SIZE);
+  pipeline->SetThreadCount(3);
+  pipeline->SetEncoderThreadCount(2);
+  pipeline->SetMapParameter(mapParameter);
+
+  return pipeline;
+}
+
+TEST_CASE("All tiles of the pyramid are rendered once")
+{
+  std::shared_ptr<TestSink>                                  sink=std::make_shared<TestSink>();
+  std::atomic<size_t>                                        drawCount(0);
+  auto                                                       pipeline=CreatePipeline(sink,drawCount,0,nullptr);
+  std::vector<osmscout::TileRenderPipeline::LevelStatistics> statistics;
+
+  REQUIRE(pipeline->Render(grid.GetBoundingBox(),
+                          osmscout::MagnificationLevel(14),
+                          osmscout::MagnificationLevel(17),
+                          statistics));
+
+  REQUIRE(statistics.size()==4);
+
+  size_t tileCount=0;
+
+  for (const auto& level : statistics) {
+    REQUIRE(level.failedTileCount==0);
+    REQUIRE(level.skippedMetaTiles==0);
+    REQUIRE(level.metaTileCount>0);
+    REQUIRE(level.tileCount<=level.metaTileCount*META_TILE_SIZE*META_TILE_SIZE);
+    tileCount+=level.tileCount;
+  }
+
+  REQUIRE(tileCount==GetExpectedTileCount(14,17));
+  REQUIRE(sink->tiles.size()==tileCount);
+  REQUIRE(sink->duplicates==0);
+
+  for (const auto& tile : sink->tiles) {
+    INFO("Tile " << std::get<0>(tile.first) << " " << std::get<1>(tile.first) << " " << std::get<2>(tile.first));
+    REQUIRE(tile.second);
+  }
+}
+
+TEST_CASE("Aborted rendering is resumed using the journal")
+{
+  osmscout::RemoveFile(JOURNAL_FILE);
+
+  std::shared_ptr<TestSink>                                  firstSink=std::make_shared<TestSink>();
+  std::atomic<size_t>                                        drawCount(0);
+  osmscout::BreakerRef                                       breaker=std::make_shared<osmscout::ThreadedBreaker>();
+  auto                                                       firstPipeline=CreatePipeline(firstSink,drawCount,3,breaker);
+  std::vector<osmscout::TileRenderPipeline::LevelStatistics> statistics;
+
+  firstPipeline->SetJournalFilename(JOURNAL_FILE);
+
+  REQUIRE_FALSE(firstPipeline->Render(grid.GetBoundingBox(),
+                                     osmscout::MagnificationLevel(17),
+                                     osmscout::MagnificationLevel(17),
+                                     statistics));
+  REQUIRE(statistics.size()==1);
+
+  size_t firstMetaTiles=statistics.front().metaTileCount;
+
+  REQUIRE(firstMetaTiles>=3);
+  REQUIRE(firstSink->tiles.size()<GetExpectedTileCount(17,17));
+
+  std::shared_ptr<TestSink>    secondSink=std::make_shared<TestSink>();
+  auto                         secondPipeline=CreatePipeline(secondSink,drawCount,0,nullptr);
+
+  secondPipeline->SetJournalFilename(JOURNAL_FILE);
+
+  REQUIRE(secondPipeline->Render(grid.GetBoundingBox(),
+                                osmscout::MagnificationLevel(17),
+                                osmscout::MagnificationLevel(17),
+                                statistics));
+  REQUIRE(statistics.size()==1);
+  REQUIRE(statistics.front().skippedMetaTiles==firstMetaTiles);
+
+  // Together both runs rendered each tile exactly once
+  for (const auto& tile : firstSink->tiles) {
+    REQUIRE(secondSink->tiles.find(tile.first)==secondSink->tiles.end());
+  }
+
+  REQUIRE(firstSink->tiles.size()+secondSink->tiles.size()==GetExpectedTileCount(17,17));
+
+  // A third run has nothing to do
+  std::shared_ptr<TestSink>    thirdSink=std::make_shared<TestSink>();
+  auto                         thirdPipeline=CreatePipeline(thirdSink,drawCount,0,nullptr);
+
+  thirdPipeline->SetJournalFilename(JOURNAL_FILE);
+
+  REQUIRE(thirdPipeline->Render(grid.GetBoundingBox(),
+                               osmscout::MagnificationLevel(17),
+                               osmscout::MagnificationLevel(17),
+                               statistics));
+  REQUIRE(statistics.front().metaTileCount==0);
+  REQUIRE(thirdSink->tiles.empty());
+}
+
+int main(int argc, char* argv[])
+{
+  osmscout::ImportParameter importParameter;
+
+  int importResult=grid.Import(importParameter);
+
+  if (importResult!=0) {
+    return importResult;
+  }
+
+  std::string testsTopDir=getenv("TESTS_TOP_DIR");
+
+  osmscout::DatabaseParameter dbParameter;
+
+  database=std::make_shared<osmscout::Database>(dbParameter);
+
+  if (!database->Open(".")) {
+    std::cerr << "Cannot open database" << std::endl;
+    return 1;
+  }
+
+  mapService=std::make_shared<osmscout::MapService>(database);
+  styleConfig=std::make_shared<osmscout::StyleConfig>(database->GetTypeConfig());
+
+  if (!styleConfig->Load(osmscout::AppendFileToDir(testsTopDir,"../stylesheets/standard.oss"))) {
+    std::cerr << "Cannot load style sheet" << std::endl;
+    return 1;
+  }
+
+  int result=Catch::Session().run(argc,argv);
+
+  styleConfig.reset();
+  mapService.reset();
+  database->Close();
+  database.reset();
+
+  return result;
+}
@@ -0,0 +1,313 @@
+#ifndef OSMSCOUT_GPX_MAPMATCHER_H
+#define OSMSCOUT_GPX_MAPMATCHER_H
+
+/*
+  This source is part of the libosmscout-gpx library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/gpx/GPXImportExport.h>
+#include <osmscout/gpx/TrackPoint.h>
+
+#include <osmscout/routing/RouteData.h>
+#include <osmscout/routing/RoutingProfile.h>
+#include <osmscout/routing/SimpleRoutingService.h>
+
+#include <osmscout/util/Breaker.h>
+#include <osmscout/util/Distance.h>
+
+#include <deque>
+#include <limits>
+#include <vector>
+
+namespace osmscout {
+namespace gpx {
+
+/**
+ * Track point matched to the road network by the MapMatcher
+ */
+class OSMSCOUT_GPX_API MatchedPoint {
+public:
+  explicit MatchedPoint(const GeoCoord &coord);
+
+  GeoCoord      coord;        // coordinate of the track point
+  bool          matched;      // false, if there is no routable way within the search radius
+  ObjectFileRef object;       // matched way
+  GeoCoord      matchedCoord; // closest point of the matched way
+  RoutePosition position;     // routable position (way node) next to the matched coordinate
+  Distance      distance;     // distance between the track point and the matched coordinate
+  double        confidence;   // probability (0.0 .. 1.0) of the matched way, given the track up to this point
+};
+
+/**
+ * Receives the results of the MapMatcher, in the order of the track points
+ */
+class OSMSCOUT_GPX_API MapMatchingCallback {
+public:
+  virtual ~MapMatchingCallback();
+
+  /**
+   * Called for each track point, after its match is final
+   */
+  virtual void OnPoint(const MatchedPoint &point);
+
+  /**
+   * Route between the previous and the current matched point. The last entry
+   * of a route is the first entry of the next route, like for the legs of a
+   * route via multiple points.
+   */
+  virtual void OnRoute(const RouteData &route);
+
+  /**
+   * The track could not be matched to a connected route, the next route
+   * starts a new part
+   */
+  virtual void OnGap();
+};
+
+/**
+ * Result of MatchTrack()
+ */
+class OSMSCOUT_GPX_API MapMatchingResult {
+public:
+  std::vector<MatchedPoint> points; // matched track points, same order and count as the track
+  std::vector<RouteData>    routes; // connected parts of the matched route, usually one
+};
+
+/**
+ * Parameter of the MapMatcher
+ */
+class OSMSCOUT_GPX_API MapMatchingParameter {
+private:
+  Distance   searchRadius;
+  size_t     maxCandidates;
+  Distance   measurementSigma;
+  Distance   transitionBeta;
+  Distance   maxDetour;
+  size_t     windowSize;
+  BreakerRef breaker;
+
+public:
+  MapMatchingParameter();
+
+  /**
+   * Maximum distance of the candidate ways from a track point (default 50m)
+   */
+  inline void SetSearchRadius(const Distance &searchRadius)
+  {
+    this->searchRadius=searchRadius;
+  }
+
+  /**
+   * Maximum number of candidate ways for each track point (default 5)
+   */
+  inline void SetMaxCandidates(size_t maxCandidates)
+  {
+    this->maxCandidates=maxCandidates;
+  }
+
+  /**
+   * Standard deviation of the GPS measurement error (default 10m)
+   */
+  inline void SetMeasurementSigma(const Distance &measurementSigma)
+  {
+    this->measurementSigma=measurementSigma;
+  }
+
+  /**
+   * Expected difference between the route length and the direct distance
+   * of consecutive track points (default 20m). Smaller values prefer
+   * direct routes.
+   */
+  inline void SetTransitionBeta(const Distance &transitionBeta)
+  {
+    this->transitionBeta=transitionBeta;
+  }
+
+  /**
+   * Detour added to the direct distance of consecutive track points, that
+   * limits the routing searches between the candidates (default 250m)
+   */
+  inline void SetMaxDetour(const Distance &maxDetour)
+  {
+    this->maxDetour=maxDetour;
+  }
+
+  /**
+   * Number of track points kept, before the oldest point is finally matched
+   * (default 20). Defines the memory used and the delay of the results.
+   */
+  inline void SetWindowSize(size_t windowSize)
+  {
+    this->windowSize=windowSize;
+  }
+
+  inline void SetBreaker(const BreakerRef &breaker)
+  {
+    this->breaker=breaker;
+  }
+
+  inline Distance GetSearchRadius() const
+  {
+    return searchRadius;
+  }
+
+  inline size_t GetMaxCandidates() const
+  {
+    return maxCandidates;
+  }
+
+  inline Distance GetMeasurementSigma() const
+  {
+    return measurementSigma;
+  }
+
+  inline Distance GetTransitionBeta() const
+  {
+    return transitionBeta;
+  }
+
+  inline Distance GetMaxDetour() const
+  {
+    return maxDetour;
+  }
+
+  inline size_t GetWindowSize() const
+  {
+    return windowSize;
+  }
+
+  inline BreakerRef GetBreaker() const
+  {
+    return breaker;
+  }
+};
+
+/**
+ * Matches a (noisy) GPS track to the road network of a routing database,
+ * using a hidden Markov model (Newson and Krumm, "Hidden Markov Map
+ * Matching Through Noise and Sparseness").
+ *
+ * The candidates of each track point are the closest routable ways, their
+ * probability depends on the distance to the track point. The probability
+ * of a transition between the candidates of consecutive points depends on
+ * the difference between the route length and the direct distance of the
+ * track points. The route lengths are calculated by a routing matrix, limited
+ * to short detours.
+ *
+ * Points are added one by one, the most probable sequence of candidates is
+ * tracked by the Viterbi algorithm. Only the last points (see
+ * MapMatchingParameter::SetWindowSize()) are kept, older points are reported
+ * as final to the callback, so the memory used does not depend on the length
+ * of the track.
+ */
+class OSMSCOUT_GPX_API MapMatcher {
+private:
+  static const size_t NO_CANDIDATE;
+  // marker for a transition along the same way segment, the route does not change
+  static const uint8_t SAME_SEGMENT;
+
+  /**
+   * Possible match of a track point
+   */
+  struct Candidate {
+    ObjectFileRef        object;
+    GeoCoord             coord;               // closest point of the way
+    Distance             distance;            // distance to the track point
+    RoutePosition        endpoints[2];        // way nodes before and after the closest point
+    Distance             offsets[2];          // distance from the closest point to the way nodes
+    double               logEmission;         // log probability of the measurement
+    double               score;               // log probability of the most probable sequence ending here
+    double               logForward;          // normalized log probability, given all points up to here
+    size_t               prev;                // previous candidate of the most probable sequence
+    std::vector<double>  logTransitions;      // log transition probability from each previous candidate
+    std::vector<uint8_t> arrivals;            // endpoint reached from each previous candidate
+  };
+
+  /**
+   * Track point in the window. A point without candidates is reported as not
+   * matched and does not break the sequence.
+   */
+  struct Step {
+    GeoCoord               coord;
+    std::vector<Candidate> candidates;
+  };
+
+private:
+  SimpleRoutingServiceRef    router;
+  Vehicle                    vehicle;
+  MapMatchingParameter       parameter;
+  MapMatchingCallback        &callback;
+  ShortestPathRoutingProfile profile;
+  RoutingParameter           routingParameter;
+
+  std::deque<Step>           window;           // track points not final yet
+  std::vector<Candidate>     lastCandidates;   // candidates of the last point with candidates, empty at the start of a sequence
+  GeoCoord                   lastCoord;        // coordinate of the last point with candidates
+
+  size_t                     emittedCandidate; // last reported candidate of the current sequence, or NO_CANDIDATE
+  RoutePosition              emittedPosition;  // way node the route to the last reported candidate ends at
+
+private:
+  std::vector<Candidate> GetCandidates(const GeoCoord &coord);
+
+  bool CalculateTransitions(const std::vector<Candidate> &previous,
+                            const GeoCoord &previousCoord,
+                            const GeoCoord &coord,
+                            std::vector<Candidate> &candidates);
+
+  size_t GetSequenceCandidate(size_t stepIndex) const;
+
+  bool EmitStep();
+  bool Flush();
+
+public:
+  MapMatcher(const SimpleRoutingServiceRef &router,
+             Vehicle vehicle,
+             const MapMatchingParameter &parameter,
+             MapMatchingCallback &callback);
+
+  bool AddPoint(const TrackPoint &point);
+  bool Finish();
+};
+
+/**
+ * Match all points of the track to the road network
+ *
+ * @param router
+ *    routing service of the database
+ * @param vehicle
+ *    vehicle used for recording the track
+ * @param points
+ *    track points
+ * @param parameter
+ *    parameter of the matching
+ * @param result
+ *    matched points and route
+ * @return
+ *    false on error or if the matching has been aborted
+ */
+extern OSMSCOUT_GPX_API bool MatchTrack(const SimpleRoutingServiceRef &router,
+                                        Vehicle vehicle,
+                                        const std::vector<TrackPoint> &points,
+                                        const MapMatchingParameter &parameter,
+                                        MapMatchingResult &result);
+
+}
+}
+
+#endif //OSMSCOUT_GPX_MAPMATCHER_H
@@ -0,0 +1,619 @@
+/*
+  This source is part of the libosmscout-gpx library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/gpx/MapMatcher.h>
+
+#include <osmscout/util/Geometry.h>
+#include <osmscout/util/Logger.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+using namespace osmscout;
+using namespace osmscout::gpx;
+
+namespace {
+const double NO_PROBABILITY=-std::numeric_limits<double>::infinity();
+
+/**
+ * Returns log(exp(a)+exp(b)) without loss of precision for small probabilities
+ */
+double AddLogProbabilities(double a, double b)
+{
+  if (a==NO_PROBABILITY) {
+    return b;
+  }
+  if (b==NO_PROBABILITY) {
+    return a;
+  }
+
+  double max=std::max(a,b);
+
+  return max+std::log(std::exp(a-max)+std::exp(b-max));
+}
+
+bool IsSamePosition(const RoutePosition &a, const RoutePosition &b)
+{
+  return a.GetDatabaseId()==b.GetDatabaseId() &&
+         a.GetObjectFileRef()==b.GetObjectFileRef() &&
+         a.GetNodeIndex()==b.GetNodeIndex();
+}
+
+size_t AddPosition(std::vector<RoutePosition> &positions, const RoutePosition &position)
+{
+  for (size_t i=0; i<positions.size(); i++) {
+    if (IsSamePosition(positions[i],position)) {
+      return i;
+    }
+  }
+
+  positions.push_back(position);
+
+  return positions.size()-1;
+}
+
+/**
+ * Collects the results of MatchTrack()
+ */
+class ResultCollector : public MapMatchingCallback {
+private:
+  MapMatchingResult &result;
+  bool              newRoute;
+
+public:
+  explicit ResultCollector(MapMatchingResult &result)
+  : result(result),
+    newRoute(true)
+  {
+    // no code
+  }
+
+  void OnPoint(const MatchedPoint &point) override
+  {
+    result.points.push_back(point);
+  }
+
+  void OnRoute(const RouteData &route) override
+  {
+    if (newRoute) {
+      result.routes.emplace_back();
+      newRoute=false;
+    }
+    else {
+      result.routes.back().PopEntry();
+    }
+
+    result.routes.back().Append(route);
+  }
+
+  void OnGap() override
+  {
+    newRoute=true;
+  }
+};
+}
+
+const size_t  MapMatcher::NO_CANDIDATE=std::numeric_limits<size_t>::max();
+const uint8_t MapMatcher::SAME_SEGMENT=2;
+
+MatchedPoint::MatchedPoint(const GeoCoord &coord)
+  : coord(coord),
+    matched(false),
+    confidence(0.0)
+{
+  // no code
+}
+
+MapMatchingCallback::~MapMatchingCallback()
+{
+  // no code
+}
+
+void MapMatchingCallback::OnPoint(const MatchedPoint &/*point*/)
+{
+  // no-op
+}
+
+void MapMatchingCallback::OnRoute(const RouteData &/*route*/)
+{
+  // no-op
+}
+
+void MapMatchingCallback::OnGap()
+{
+  // no-op
+}
+
+MapMatchingParameter::MapMatchingParameter()
+  : searchRadius(Distance::Of<Meter>(50)),
+    maxCandidates(5),
+    measurementSigma(Distance::Of<Meter>(10)),
+    transitionBeta(Distance::Of<Meter>(20)),
+    maxDetour(Distance::Of<Meter>(250)),
+    windowSize(20)
+{
+  // no code
+}
+
+MapMatcher::MapMatcher(const SimpleRoutingServiceRef &router,
+                       Vehicle vehicle,
+                       const MapMatchingParameter &parameter,
+                       MapMatchingCallback &callback)
+  : router(router),
+    vehicle(vehicle),
+    parameter(parameter),
+    callback(callback),
+    profile(router->GetTypeConfig()),
+    emittedCandidate(NO_CANDIDATE)
+{
+  TypeConfigRef typeConfig=router->GetTypeConfig();
+
+  // The costs of the shortest path profile are the route length, the speeds are irrelevant
+  switch (vehicle) {
+  case vehicleFoot:
+    profile.ParametrizeForFoot(*typeConfig,5.0);
+    break;
+  case vehicleBicycle:
+    profile.ParametrizeForBicycle(*typeConfig,20.0);
+    break;
+  case vehicleCar: {
+    std::map<std::string,double> speedMap;
+
+    for (const auto &type : typeConfig->GetTypes()) {
+      if (!type->GetIgnore() &&
+          type->CanRouteCar()) {
+        speedMap[type->GetName()]=100.0;
+      }
+    }
+
+    profile.ParametrizeForCar(*typeConfig,speedMap,160.0);
+    break;
+  }
+  }
+
+  // Routes between candidates may be the direct distance plus the detour
+  profile.SetCostLimitDistance(parameter.GetMaxDetour());
+  profile.SetCostLimitFactor(1.0);
+
+  // The searches are short, the landmarks would only add overhead
+  routingParameter.SetUseLandmarks(false);
+  routingParameter.SetThreadCount(1);
+  routingParameter.SetBreaker(parameter.GetBreaker());
+}
+
+/**
+ * Returns the closest point of each routable way next to the track point
+ */
+std::vector<MapMatcher::Candidate> MapMatcher::GetCandidates(const GeoCoord &coord)
+{
+  std::vector<Candidate> candidates;
+  double                 sigma=parameter.GetMeasurementSigma().As<Meter>();
+
+  for (const auto &object : router->GetClosestRoutableObjects(coord,
+                                                              vehicle,
+                                                              parameter.GetSearchRadius(),
+                                                              parameter.GetMaxCandidates())) {
+    WayRef way=object.GetWay();
+
+    // Routing on areas is not supported by the matching
+    if (!way ||
+        way->nodes.size()<2 ||
+        object.GetDistance()>parameter.GetSearchRadius()) {
+      continue;
+    }
+
+    Candidate candidate;
+    size_t    segment=0;
+
+    candidate.distance=Distance::Max();
+
+    for (size_t i=1; i<way->nodes.size(); i++) {
+      GeoCoord intersection;
+      double   segmentDistance=CalculateDistancePointToLineSegment(coord,
+                                                                   way->nodes[i-1].GetCoord(),
+                                                                   way->nodes[i].GetCoord(),
+                                                                   intersection);
+
+      if (!std::isfinite(segmentDistance)) {
+        continue;
+      }
+
+      Distance distance=GetEllipsoidalDistance(coord,intersection);
+
+      if (distance<candidate.distance) {
+        candidate.distance=distance;
+        candidate.coord=intersection;
+        segment=i-1;
+      }
+    }
+
+    if (candidate.distance>=Distance::Max()) {
+      continue;
+    }
+
+    candidate.object=way->GetObjectFileRef();
+
+    for (size_t e=0; e<2; e++) {
+      candidate.endpoints[e]=RoutePosition(candidate.object,segment+e,/*database*/0);
+      candidate.offsets[e]=GetEllipsoidalDistance(candidate.coord,
+                                                  way->nodes[segment+e].GetCoord());
+    }
+
+    double normalizedDistance=candidate.distance.As<Meter>()/sigma;
+
+    candidate.logEmission=-0.5*normalizedDistance*normalizedDistance;
+    candidate.score=NO_PROBABILITY;
+    candidate.logForward=NO_PROBABILITY;
+    candidate.prev=NO_CANDIDATE;
+
+    candidates.push_back(std::move(candidate));
+  }
+
+  return candidates;
+}
+
+/**
+ * Calculate the transition probabilities from the previous to the current candidates.
+ * The route length between two candidates is the shortest route between the way nodes
+ * next to them, plus the distances from the candidates to these nodes.
+ */
+bool MapMatcher::CalculateTransitions(const std::vector<Candidate> &previous,
+                                      const GeoCoord &previousCoord,
+                                      const GeoCoord &coord,
+                                      std::vector<Candidate> &candidates)
+{
+  std::vector<RoutePosition> sources;
+  std::vector<RoutePosition> targets;
+  std::vector<size_t>        sourceIndex(previous.size()*2);
+  std::vector<size_t>        targetIndex(candidates.size()*2);
+
+  for (size_t i=0; i<previous.size(); i++) {
+    for (size_t e=0; e<2; e++) {
+      sourceIndex[i*2+e]=AddPosition(sources,previous[i].endpoints[e]);
+    }
+  }
+
+  for (size_t j=0; j<candidates.size(); j++) {
+    for (size_t e=0; e<2; e++) {
+      targetIndex[j*2+e]=AddPosition(targets,candidates[j].endpoints[e]);
+    }
+  }
+
+  RoutingMatrix matrix=router->CalculateMatrix(profile,
+                                               sources,
+                                               targets,
+                                               routingParameter);
+
+  if (parameter.GetBreaker() &&
+      parameter.GetBreaker()->IsAborted()) {
+    return false;
+  }
+
+  double directDistance=GetEllipsoidalDistance(previousCoord,coord).As<Meter>();
+  double beta=parameter.GetTransitionBeta().As<Meter>();
+
+  for (size_t j=0; j<candidates.size(); j++) {
+    Candidate &candidate=candidates[j];
+
+    candidate.logTransitions.assign(previous.size(),NO_PROBABILITY);
+    candidate.arrivals.assign(previous.size(),0);
+
+    for (size_t i=0; i<previous.size(); i++) {
+      const Candidate &from=previous[i];
+      double          routeDistance=std::numeric_limits<double>::infinity();
+
+      if (from.object==candidate.object &&
+          from.endpoints[0].GetNodeIndex()==candidate.endpoints[0].GetNodeIndex()) {
+        routeDistance=std::fabs(from.offsets[0].As<Meter>()-candidate.offsets[0].As<Meter>());
+        candidate.arrivals[i]=SAME_SEGMENT;
+      }
+      else {
+        for (size_t fromEndpoint=0; fromEndpoint<2; fromEndpoint++) {
+          for (size_t toEndpoint=0; toEndpoint<2; toEndpoint++) {
+            const RoutingMatrix::Entry &entry=matrix.Get(sourceIndex[i*2+fromEndpoint],
+                                                         targetIndex[j*2+toEndpoint]);
+
+            if (!entry.found) {
+              continue;
+            }
+
+            double distance=from.offsets[fromEndpoint].As<Meter>()+
+                            entry.distance.As<Meter>()+
+                            candidate.offsets[toEndpoint].As<Meter>();
+
+            if (distance<routeDistance) {
+              routeDistance=distance;
+              candidate.arrivals[i]=(uint8_t)toEndpoint;
+            }
+          }
+        }
+      }
+
+      if (std::isfinite(routeDistance)) {
+        candidate.logTransitions[i]=-std::fabs(routeDistance-directDistance)/beta;
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Returns the candidate of the given step on the currently most probable sequence
+ */
+size_t MapMatcher::GetSequenceCandidate(size_t stepIndex) const
+{
+  size_t current=NO_CANDIDATE;
+
+  for (size_t s=window.size(); s>stepIndex;) {
+    s--;
+
+    const Step &step=window[s];
+
+    if (step.candidates.empty()) {
+      continue;
+    }
+
+    if (current==NO_CANDIDATE) {
+      current=0;
+
+      for (size_t c=1; c<step.candidates.size(); c++) {
+        if (step.candidates[c].score>step.candidates[current].score) {
+          current=c;
+        }
+      }
+    }
+
+    if (s==stepIndex) {
+      break;
+    }
+
+    current=step.candidates[current].prev;
+  }
+
+  return current;
+}
+
+/**
+ * Report the oldest point of the window as final, together with the route
+ * from the previously reported point
+ */
+bool MapMatcher::EmitStep()
+{
+  const Step   &step=window.front();
+  MatchedPoint point(step.coord);
+
+  if (!step.candidates.empty()) {
+    size_t          index=GetSequenceCandidate(0);
+    const Candidate &candidate=step.candidates[index];
+    size_t          nearest=candidate.offsets[0]<=candidate.offsets[1] ? 0 : 1;
+    RoutePosition   arrival=candidate.endpoints[nearest];
+
+    point.matched=true;
+    point.object=candidate.object;
+    point.matchedCoord=candidate.coord;
+    point.position=candidate.endpoints[nearest];
+    point.distance=candidate.distance;
+    point.confidence=std::exp(candidate.logForward);
+
+    if (emittedCandidate!=NO_CANDIDATE &&
+        !candidate.logTransitions.empty()) {
+      if (candidate.logTransitions[emittedCandidate]==NO_PROBABILITY) {
+        // The window was too small to resolve an ambiguity
+        callback.OnGap();
+      }
+      else if (candidate.arrivals[emittedCandidate]==SAME_SEGMENT) {
+        arrival=emittedPosition;
+      }
+      else {
+        arrival=candidate.endpoints[candidate.arrivals[emittedCandidate]];
+
+        if (!IsSamePosition(arrival,emittedPosition)) {
+          RoutingResult route=router->CalculateRoute(profile,
+                                                     emittedPosition,
+                                                     arrival,
+                                                     routingParameter);
+
+          if (route.Success()) {
+            callback.OnRoute(route.GetRoute());
+          }
+          else if (parameter.GetBreaker() &&
+                   parameter.GetBreaker()->IsAborted()) {
+            return false;
+          }
+          else {
+            log.Warn() << "Cannot calculate route between matched points";
+            callback.OnGap();
+          }
+        }
+      }
+    }
+
+    emittedCandidate=index;
+    emittedPosition=arrival;
+  }
+
+  callback.OnPoint(point);
+
+  window.pop_front();
+
+  return true;
+}
+
+/**
+ * Report all points of the window
+ */
+bool MapMatcher::Flush()
+{
+  while (!window.empty()) {
+    if (!EmitStep()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Add the next point of the track. Points older than the window size are
+ * reported to the callback.
+ *
+ * @return
+ *    false on error or if the matching has been aborted
+ */
+bool MapMatcher::AddPoint(const TrackPoint &point)
+{
+  if (parameter.GetBreaker() &&
+      parameter.GetBreaker()->IsAborted()) {
+    return false;
+  }
+
+  Step step;
+
+  step.coord=point.coord;
+  step.candidates=GetCandidates(point.coord);
+
+  if (!step.candidates.empty()) {
+    bool connected=false;
+
+    if (!lastCandidates.empty()) {
+      if (!CalculateTransitions(lastCandidates,
+                                lastCoord,
+                                step.coord,
+                                step.candidates)) {
+        return false;
+      }
+
+      // Viterbi (most probable sequence) and forward (probability of each candidate) step
+      for (auto &candidate : step.candidates) {
+        double forward=NO_PROBABILITY;
+
+        for (size_t i=0; i<lastCandidates.size(); i++) {
+          if (candidate.logTransitions[i]==NO_PROBABILITY) {
+            continue;
+          }
+
+          double score=lastCandidates[i].score+candidate.logTransitions[i];
+
+          if (candidate.prev==NO_CANDIDATE ||
+              score>candidate.score) {
+            candidate.score=score;
+            candidate.prev=i;
+          }
+
+          forward=AddLogProbabilities(forward,
+                                      lastCandidates[i].logForward+candidate.logTransitions[i]);
+        }
+
+        if (candidate.prev!=NO_CANDIDATE) {
+          candidate.score+=candidate.logEmission;
+          candidate.logForward=forward+candidate.logEmission;
+          connected=true;
+        }
+      }
+    }
+
+    if (!connected) {
+      // Start a new sequence, the previous one cannot be continued
+      if (!Flush()) {
+        return false;
+      }
+
+      if (emittedCandidate!=NO_CANDIDATE) {
+        callback.OnGap();
+        emittedCandidate=NO_CANDIDATE;
+      }
+
+      for (auto &candidate : step.candidates) {
+        candidate.score=candidate.logEmission;
+        candidate.logForward=candidate.logEmission;
+        candidate.prev=NO_CANDIDATE;
+        candidate.logTransitions.clear();
+        candidate.arrivals.clear();
+      }
+    }
+
+    double sum=NO_PROBABILITY;
+
+    for (const auto &candidate : step.candidates) {
+      sum=AddLogProbabilities(sum,candidate.logForward);
+    }
+
+    for (auto &candidate : step.candidates) {
+      candidate.logForward-=sum;
+    }
+
+    lastCandidates=step.candidates;
+    lastCoord=step.coord;
+  }
+
+  window.push_back(std::move(step));
+
+  while (window.size()>std::max(parameter.GetWindowSize(),(size_t)1)) {
+    if (!EmitStep()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Report the remaining points of the track. Afterwards the matcher can be
+ * used for the next track.
+ *
+ * @return
+ *    false on error or if the matching has been aborted
+ */
+bool MapMatcher::Finish()
+{
+  bool success=Flush();
+
+  window.clear();
+  lastCandidates.clear();
+  emittedCandidate=NO_CANDIDATE;
+
+  return success;
+}
+
+bool gpx::MatchTrack(const SimpleRoutingServiceRef &router,
+                     Vehicle vehicle,
+                     const std::vector<TrackPoint> &points,
+                     const MapMatchingParameter &parameter,
+                     MapMatchingResult &result)
+{
+  ResultCollector collector(result);
+  MapMatcher      matcher(router,
+                          vehicle,
+                          parameter,
+                          collector);
+
+  result.points.clear();
+  result.routes.clear();
+  result.points.reserve(points.size());
+
+  for (const auto &point : points) {
+    if (!matcher.AddPoint(point)) {
+      return false;
+    }
+  }
+
+  return matcher.Finish();
+}
@@ -0,0 +1,201 @@
+#ifndef OSMSCOUT_IMPORT_GENEYTZINGERINDEX_H
+#define OSMSCOUT_IMPORT_GENEYTZINGERINDEX_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <limits>
+#include <vector>
+
+#include <osmscout/EytzingerIndex.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+#include <osmscout/util/Progress.h>
+
+#include <osmscout/import/Import.h>
+
+namespace osmscout {
+
+  /**
+   * Generates an EytzingerIndex for the given data file. The data file must be sorted
+   * by id.
+   */
+  template <class N,class T>
+  class EytzingerIndexGenerator : public ImportModule
+  {
+  private:
+    std::string description;
+    std::string datafile;
+    std::string indexfile;
+
+  private:
+    static size_t FillEytzingerOrder(const std::vector<N>& ids,
+                                     const std::vector<FileOffset>& offsets,
+                                     std::vector<N>& treeIds,
+                                     std::vector<FileOffset>& treeOffsets,
+                                     size_t index,
+                                     size_t k);
+
+  public:
+    EytzingerIndexGenerator(const std::string& description,
+                            const std::string& datafile,
+                            const std::string& indexfile);
+
+    ~EytzingerIndexGenerator() override;
+
+    bool Import(const TypeConfigRef& typeConfig,
+                const ImportParameter& parameter,
+                Progress& progress) override;
+  };
+
+  template <class N,class T>
+  EytzingerIndexGenerator<N,T>::EytzingerIndexGenerator(const std::string& description,
+                                                        const std::string& datafile,
+                                                        const std::string& indexfile)
+   : description(description),
+     datafile(datafile),
+     indexfile(indexfile)
+  {
+    // no code
+  }
+
+  template <class N,class T>
+  EytzingerIndexGenerator<N,T>::~EytzingerIndexGenerator()
+  {
+    // no code
+  }
+
+  /**
+   * Copy the sorted entries (starting at index) into the subtree rooted at (1-based)
+   * position k by an in-order traversal of the implicit tree. Returns the index of the
+   * next entry not yet copied.
+   */
+  template <class N,class T>
+  size_t EytzingerIndexGenerator<N,T>::FillEytzingerOrder(const std::vector<N>& ids,
+                                                          const std::vector<FileOffset>& offsets,
+                                                          std::vector<N>& treeIds,
+                                                          std::vector<FileOffset>& treeOffsets,
+                                                          size_t index,
+                                                          size_t k)
+  {
+    if (k<treeIds.size()) {
+      index=FillEytzingerOrder(ids,offsets,treeIds,treeOffsets,index,2*k);
+
+      treeIds[k]=ids[index];
+      treeOffsets[k]=offsets[index];
+      index++;
+
+      index=FillEytzingerOrder(ids,offsets,treeIds,treeOffsets,index,2*k+1);
+    }
+
+    return index;
+  }
+
+  template <class N,class T>
+  bool EytzingerIndexGenerator<N,T>::Import(const TypeConfigRef& typeConfig,
+                                            const ImportParameter& parameter,
+                                            Progress& progress)
+  {
+    FileScanner             scanner;
+    FileWriter              writer;
+    uint32_t                dataCount;
+    std::vector<N>          ids;
+    std::vector<FileOffset> offsets;
+
+    progress.SetAction(std::string("Generating '")+indexfile+"'");
+
+    try {
+      scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
+                                   datafile),
+                   FileScanner::Sequential,true);
+
+      scanner.Read(dataCount);
+
+      ids.reserve(dataCount);
+      offsets.reserve(dataCount);
+
+      for (uint32_t d=0; d<dataCount; d++) {
+        progress.SetProgress(d,dataCount);
+
+        FileOffset readPos=scanner.GetPos();
+        T          data;
+
+        data.Read(*typeConfig,
+                  scanner);
+
+        if (!ids.empty() &&
+            data.GetId()<=ids.back()) {
+          progress.Error("Current id "+std::to_string(data.GetId())+" <= last id "+std::to_string(ids.back()));
+          scanner.CloseFailsafe();
+          return false;
+        }
+
+        ids.push_back(data.GetId());
+        offsets.push_back(readPos);
+      }
+
+      scanner.Close();
+
+      std::vector<N>          treeIds(ids.size()+1,0);
+      std::vector<FileOffset> treeOffsets(ids.size()+1,0);
+
+      FillEytzingerOrder(ids,offsets,treeIds,treeOffsets,0,1);
+
+      writer.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
+                                  indexfile));
+
+      writer.Write((uint32_t)ids.size()); // Number of entries
+      writer.Write((uint32_t)sizeof(N));  // Size of one id
+
+      for (const auto& id : treeIds) {
+        writer.Write(id);
+      }
+
+      size_t keyBytes=treeIds.size()*sizeof(N);
+
+      if (keyBytes%8!=0) {
+        char padding[8]={0,0,0,0,0,0,0,0};
+
+        writer.Write(padding,8-keyBytes%8);
+      }
+
+      for (const auto& offset : treeOffsets) {
+        writer.Write((uint64_t)offset);
+      }
+
+      progress.Info(std::string("Index for ")+std::to_string(dataCount)+" data elements written");
+
+      writer.Close();
+    }
+    catch (IOException& e) {
+      progress.Error(e.GetDescription());
+
+      scanner.CloseFailsafe();
+      writer.CloseFailsafe();
+
+      return false;
+    }
+
+    return true;
+  }
+}
+
+#endif
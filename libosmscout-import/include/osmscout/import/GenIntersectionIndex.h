@@ -22,13 +22,13 @@
 
 #include <osmscout/Intersection.h>
 
-#include <osmscout/import/GenNumericIndex.h>
+#include <osmscout/import/GenEytzingerIndex.h>
 
 #include <osmscout/system/Compiler.h>
 
 namespace osmscout {
 
-  class IntersectionIndexGenerator CLASS_FINAL : public NumericIndexGenerator<Id,Intersection>
+  class IntersectionIndexGenerator CLASS_FINAL : public EytzingerIndexGenerator<Id,Intersection>
   {
   public:
     IntersectionIndexGenerator();
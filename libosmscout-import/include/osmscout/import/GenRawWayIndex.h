@@ -20,14 +20,14 @@
   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 */
 
-#include <osmscout/import/GenNumericIndex.h>
+#include <osmscout/import/GenEytzingerIndex.h>
 #include <osmscout/import/RawWay.h>
 
 #include <osmscout/system/Compiler.h>
 
 namespace osmscout {
 
-  class RawWayIndexGenerator CLASS_FINAL : public NumericIndexGenerator<OSMId,RawWay>
+  class RawWayIndexGenerator CLASS_FINAL : public EytzingerIndexGenerator<OSMId,RawWay>
   {
   public:
     static const char* RAWWAY_IDX;
@@ -0,0 +1,109 @@
+#ifndef OSMSCOUT_IMPORT_GENROUTECHDAT_H
+#define OSMSCOUT_IMPORT_GENROUTECHDAT_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <string>
+#include <vector>
+
+#include <osmscout/ObjectRef.h>
+#include <osmscout/OSMScoutTypes.h>
+
+#include <osmscout/routing/RoutingProfile.h>
+
+#include <osmscout/import/Import.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * Generates a contraction hierarchy (see ContractionHierarchy) for each
+   * vehicle of each router, if enabled via ImportParameter::SetRouterCH().
+   *
+   * Edge costs are calculated using a FastestPathRoutingProfile parametrized by
+   * the speeds of the ImportParameter (see ParametrizeProfile()). The profile is
+   * stored in the hierarchy, so that the router only uses the hierarchy for
+   * matching profiles.
+   */
+  class RouteCHGenerator CLASS_FINAL : public ImportModule
+  {
+  public:
+    /**
+     * Edge of the routing graph during contraction
+     */
+    struct Edge
+    {
+      uint32_t node;   //!< Index of the node at the other end of the edge
+      uint32_t middle; //!< Index of the contracted node for shortcuts
+      uint32_t object; //!< Index of the object for original paths
+      double   cost;   //!< Costs of the edge
+    };
+
+    typedef std::vector<std::vector<Edge>> EdgeList;
+
+    /**
+     * Routing graph of one vehicle
+     */
+    struct Graph
+    {
+      std::vector<Id>            nodeIds;  //!< Ids of all route nodes, sorted
+      std::vector<ObjectFileRef> objects;  //!< Objects referenced by original paths
+      EdgeList                   outEdges; //!< Outgoing edges of each node
+      EdgeList                   inEdges;  //!< Incoming edges of each node
+    };
+
+  private:
+    bool LoadGraph(const TypeConfig& typeConfig,
+                   const ImportParameter& parameter,
+                   Progress& progress,
+                   const ImportParameter::Router& router,
+                   const RoutingProfile& profile,
+                   Graph& graph);
+
+    void Contract(Progress& progress,
+                  Graph& graph,
+                  EdgeList& upEdges,
+                  EdgeList& downEdges);
+
+    bool WriteHierarchy(const TypeConfig& typeConfig,
+                        Progress& progress,
+                        const std::string& filename,
+                        const FastestPathRoutingProfile& profile,
+                        const Graph& graph,
+                        const EdgeList& upEdges,
+                        const EdgeList& downEdges);
+
+  public:
+    static bool ParametrizeProfile(const TypeConfig& typeConfig,
+                                   const ImportParameter& parameter,
+                                   Vehicle vehicle,
+                                   FastestPathRoutingProfile& profile);
+
+    void GetDescription(const ImportParameter& parameter,
+                        ImportModuleDescription& description) const override;
+
+    bool Import(const TypeConfigRef& typeConfig,
+                const ImportParameter& parameter,
+                Progress& progress) override;
+  };
+}
+
+#endif
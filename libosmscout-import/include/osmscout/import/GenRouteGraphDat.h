@@ -0,0 +1,79 @@
+#ifndef OSMSCOUT_IMPORT_GENROUTEGRAPHDAT_H
+#define OSMSCOUT_IMPORT_GENROUTEGRAPHDAT_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <string>
+#include <vector>
+
+#include <osmscout/OSMScoutTypes.h>
+
+#include <osmscout/routing/RouteGraph.h>
+
+#include <osmscout/import/Import.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * Generates the compact routing graph (see RouteGraph) of each router, if
+   * enabled via ImportParameter::SetRouterGraph().
+   *
+   * The graph holds all paths and turn restrictions of the route nodes, so it
+   * is independent of the vehicle and the routing profile.
+   */
+  class RouteGraphGenerator CLASS_FINAL : public ImportModule
+  {
+  public:
+    /**
+     * Routing graph, as written to the file
+     */
+    struct Graph
+    {
+      std::vector<Id>                  nodeIds;        //!< Ids of all route nodes, sorted
+      std::vector<uint64_t>            objects;        //!< Encoded object references, sorted
+      std::vector<uint32_t>            edgeOffsets;    //!< Index of the first edge of each node (+1 entry)
+      std::vector<RouteGraph::Edge>    edges;          //!< Paths of all nodes
+      std::vector<uint32_t>            excludeOffsets; //!< Index of the first exclude of each node (+1 entry)
+      std::vector<RouteGraph::Exclude> excludes;       //!< Turn restrictions of all nodes
+    };
+
+  private:
+    bool LoadGraph(const ImportParameter& parameter,
+                   Progress& progress,
+                   const ImportParameter::Router& router,
+                   Graph& graph);
+
+    bool WriteGraph(Progress& progress,
+                    const std::string& filename,
+                    const Graph& graph);
+
+  public:
+    void GetDescription(const ImportParameter& parameter,
+                        ImportModuleDescription& description) const override;
+
+    bool Import(const TypeConfigRef& typeConfig,
+                const ImportParameter& parameter,
+                Progress& progress) override;
+  };
+}
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef OSMSCOUT_IMPORT_GENROUTELANDMARKDAT_H
+#define OSMSCOUT_IMPORT_GENROUTELANDMARKDAT_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <string>
+#include <vector>
+
+#include <osmscout/OSMScoutTypes.h>
+
+#include <osmscout/routing/RoutingProfile.h>
+
+#include <osmscout/import/Import.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * Generates the landmark distances (see LandmarkTable) for each vehicle of
+   * each router, if enabled via ImportParameter::SetRouterLandmarks().
+   *
+   * Landmarks are selected one after another ("farthest" selection): the first
+   * landmark is the node farthest away from an arbitrary node of the largest
+   * connected part of the graph, each following landmark is the node farthest
+   * away from all landmarks selected so far. For each landmark the distances
+   * and travel times from and to all nodes are calculated by a Dijkstra search.
+   *
+   * Travel times are calculated using a FastestPathRoutingProfile with the same
+   * parametrization as used for the contraction hierarchies (see
+   * RouteCHGenerator::ParametrizeProfile()).
+   */
+  class RouteLandmarkGenerator CLASS_FINAL : public ImportModule
+  {
+  public:
+    /**
+     * Edge of the routing graph
+     */
+    struct Edge
+    {
+      uint32_t node;   //!< Index of the node at the other end of the edge
+      double   length; //!< Length of the edge in meters
+      double   time;   //!< Travel time in hours, infinite if the path cannot be used by the profile
+    };
+
+    typedef std::vector<std::vector<Edge>> EdgeList;
+
+    /**
+     * Routing graph of one vehicle
+     */
+    struct Graph
+    {
+      std::vector<Id> nodeIds;  //!< Ids of all route nodes, sorted
+      EdgeList        outEdges; //!< Outgoing edges of each node
+      EdgeList        inEdges;  //!< Incoming edges of each node
+    };
+
+  private:
+    bool LoadGraph(const TypeConfig& typeConfig,
+                   const ImportParameter& parameter,
+                   Progress& progress,
+                   const ImportParameter::Router& router,
+                   const FastestPathRoutingProfile& profile,
+                   Graph& graph);
+
+    void CalculateDistances(Progress& progress,
+                            const Graph& graph,
+                            size_t landmarkCount,
+                            std::vector<uint32_t>& landmarks,
+                            std::vector<uint32_t>& values);
+
+    bool WriteTable(const TypeConfig& typeConfig,
+                    Progress& progress,
+                    const std::string& filename,
+                    const FastestPathRoutingProfile& profile,
+                    const Graph& graph,
+                    const std::vector<uint32_t>& landmarks,
+                    const std::vector<uint32_t>& values);
+
+  public:
+    void GetDescription(const ImportParameter& parameter,
+                        ImportModuleDescription& description) const override;
+
+    bool Import(const TypeConfigRef& typeConfig,
+                const ImportParameter& parameter,
+                Progress& progress) override;
+  };
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef OSMSCOUT_IMPORT_GENROUTEPREDECESSORDAT_H
+#define OSMSCOUT_IMPORT_GENROUTEPREDECESSORDAT_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <osmscout/OSMScoutTypes.h>
+
+#include <osmscout/import/Import.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * Generates the predecessors of the route nodes (see RoutePredecessorTable) of
+   * each router, if enabled via ImportParameter::SetRouterPredecessors().
+   *
+   * The table holds all paths of the route nodes, so it is independent of the
+   * vehicle and the routing profile.
+   */
+  class RoutePredecessorGenerator CLASS_FINAL : public ImportModule
+  {
+  public:
+    /**
+     * Path of a route node, as entry of the table
+     */
+    struct Entry
+    {
+      Id      target;    //!< Id of the route node the path leads to
+      Id      source;    //!< Id of the route node holding the path
+      uint8_t pathIndex; //!< Index of the path in RouteNode::paths of the source
+
+      inline bool operator<(const Entry& other) const
+      {
+        if (target!=other.target) {
+          return target<other.target;
+        }
+
+        if (source!=other.source) {
+          return source<other.source;
+        }
+
+        return pathIndex<other.pathIndex;
+      }
+    };
+
+  private:
+    bool LoadEntries(const ImportParameter& parameter,
+                     Progress& progress,
+                     const ImportParameter::Router& router,
+                     std::vector<Entry>& entries);
+
+    bool WriteTable(Progress& progress,
+                    const std::string& filename,
+                    const std::vector<Entry>& entries);
+
+  public:
+    void GetDescription(const ImportParameter& parameter,
+                        ImportModuleDescription& description) const override;
+
+    bool Import(const TypeConfigRef& typeConfig,
+                const ImportParameter& parameter,
+                Progress& progress) override;
+  };
+}
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef OSMSCOUT_IMPORT_GENROUTESEGMENTINDEX_H
+#define OSMSCOUT_IMPORT_GENROUTESEGMENTINDEX_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <string>
+#include <vector>
+
+#include <osmscout/Point.h>
+#include <osmscout/TypeFeatures.h>
+#include <osmscout/FeatureReader.h>
+
+#include <osmscout/routing/RouteSegmentIndex.h>
+
+#include <osmscout/import/Import.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * Generates the spatial index of the routable segments (see RouteSegmentIndex)
+   * of each router, if enabled via ImportParameter::SetRouterSegmentIndex().
+   *
+   * All ways and simple areas, that can be used by at least one vehicle of the
+   * router, are indexed.
+   */
+  class RouteSegmentIndexGenerator CLASS_FINAL : public ImportModule
+  {
+  public:
+    //! Width and height of a grid cell in 1/10^7 degree (about 220m in north-south direction)
+    static const uint32_t CELL_SIZE;
+
+    /**
+     * Segment index, as written to the file
+     */
+    struct Index
+    {
+      std::vector<RouteSegmentIndex::Segment> segments;     //!< All segments, ordered by cell
+      std::vector<uint64_t>                   cellKeys;     //!< Keys of all cells referencing a segment, sorted
+      std::vector<uint32_t>                   entryOffsets; //!< Index of the first entry of each cell (+1 entry)
+      std::vector<uint32_t>                   entries;      //!< Segments referenced by the cells
+    };
+
+  private:
+    uint8_t GetFlags(const AccessFeatureValueReader& accessReader,
+                     const FeatureValueBuffer& buffer) const;
+
+    void AddSegments(const std::vector<Point>& nodes,
+                     bool closed,
+                     const ObjectFileRef& object,
+                     TypeId type,
+                     uint8_t flags,
+                     std::vector<RouteSegmentIndex::Segment>& segments) const;
+
+    bool LoadSegments(const TypeConfig& typeConfig,
+                      const ImportParameter& parameter,
+                      Progress& progress,
+                      const ImportParameter::Router& router,
+                      std::vector<RouteSegmentIndex::Segment>& segments) const;
+
+    void BuildIndex(Progress& progress,
+                    std::vector<RouteSegmentIndex::Segment>& segments,
+                    Index& index) const;
+
+    bool WriteIndex(Progress& progress,
+                    const std::string& filename,
+                    const Index& index) const;
+
+  public:
+    void GetDescription(const ImportParameter& parameter,
+                        ImportModuleDescription& description) const override;
+
+    bool Import(const TypeConfigRef& typeConfig,
+                const ImportParameter& parameter,
+                Progress& progress) override;
+  };
+}
+
+#endif
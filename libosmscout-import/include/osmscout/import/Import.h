@@ -21,6 +21,7 @@
 */
 
 #include <list>
+#include <map>
 #include <mutex>
 #include <string>
 
@@ -33,6 +34,7 @@
 #include <osmscout/import/ImportErrorReporter.h>
 
 #include <osmscout/util/Magnification.h>
+#include <osmscout/util/MmapPolicy.h>
 #include <osmscout/util/Progress.h>
 #include <osmscout/util/Transformation.h>
 
@@ -124,6 +126,15 @@ namespace osmscout {
     std::string                  boundingPolygonFile;      //<! Polygon file containing the bounding polygon of the current import
     bool                         eco;                      //<! Eco modus, deletes temporary files ASAP
     std::list<Router>            router;                   //<! Definition of router
+    bool                         routerCH;                 //<! Generate contraction hierarchies for the router
+    std::map<std::string,double> routerCarSpeedTable;      //<! Speed (km/h) by type name for the car profile of the generated routing data
+    double                       routerFootMaxSpeed;       //<! Maximum speed (km/h) for the foot profile of the generated routing data
+    double                       routerBicycleMaxSpeed;    //<! Maximum speed (km/h) for the bicycle profile of the generated routing data
+    double                       routerCarMaxSpeed;        //<! Maximum speed (km/h) for the car profile of the generated routing data
+    size_t                       routerLandmarks;          //<! Number of landmarks for the ALT heuristic of the router, 0 to disable
+    bool                         routerGraph;              //<! Generate the compact routing graph for the router
+    bool                         routerPredecessors;       //<! Generate the predecessors of the route nodes for the router
+    bool                         routerSegmentIndex;       //<! Generate the spatial index of the routable segments for the router
 
     bool                         strictAreas;              //<! Assure that areas conform to "simple" definition
 
@@ -154,6 +165,11 @@ namespace osmscout {
     bool                         wayDataMemoryMaped;       //<! Use memory mapping for way data file access
     size_t                       wayDataCacheSize;         //<! Size of the way data cache
 
+    bool                         compressData;             //<! Store way and area data block compressed
+    size_t                       compressedBlockSize;      //<! Nominal size of an uncompressed data block in bytes
+
+    MmapPolicy                   scanMMapPolicy;           //<! Policy for memory mapped files scanned sequentially during import
+
     size_t                       areaAreaIndexMaxMag;      //<! Maximum depth of the index generated
 
     size_t                       areaNodeMinMag;           //<! Minimum magnification of index for individual type
@@ -206,6 +222,13 @@ namespace osmscout {
     bool   IsEco() const;
 
     const std::list<Router>& GetRouter() const;
+    bool GetRouterCH() const;
+    const std::map<std::string,double>& GetRouterCarSpeedTable() const;
+    double GetRouterMaxSpeed(Vehicle vehicle) const;
+    size_t GetRouterLandmarks() const;
+    bool GetRouterGraph() const;
+    bool GetRouterPredecessors() const;
+    bool GetRouterSegmentIndex() const;
 
     bool GetStrictAreas() const;
 
@@ -237,6 +260,11 @@ namespace osmscout {
     bool GetWayDataMemoryMaped() const;
     size_t GetWayDataCacheSize() const;
 
+    bool GetCompressData() const;
+    size_t GetCompressedBlockSize() const;
+
+    const MmapPolicy& GetScanMMapPolicy() const;
+
     size_t GetAreaNodeMinMag() const;
     double GetAreaNodeIndexMinFillRate() const;
     size_t GetAreaNodeIndexCellSizeAverage() const;
@@ -282,6 +310,14 @@ namespace osmscout {
 
     void ClearRouter();
     void AddRouter(const Router& router);
+    void SetRouterCH(bool routerCH);
+    void SetRouterCarSpeedTable(const std::map<std::string,double>& routerCarSpeedTable);
+    void SetRouterMaxSpeed(Vehicle vehicle,
+                           double maxSpeed);
+    void SetRouterLandmarks(size_t routerLandmarks);
+    void SetRouterGraph(bool routerGraph);
+    void SetRouterPredecessors(bool routerPredecessors);
+    void SetRouterSegmentIndex(bool routerSegmentIndex);
 
     void SetStrictAreas(bool strictAreas);
 
@@ -312,6 +348,11 @@ namespace osmscout {
     void SetWayDataMemoryMaped(bool memoryMaped);
     void SetWayDataCacheSize(size_t wayDataCacheSize);
 
+    void SetCompressData(bool compressData);
+    void SetCompressedBlockSize(size_t compressedBlockSize);
+
+    void SetScanMMapPolicy(const MmapPolicy& scanMMapPolicy);
+
     void SetAreaAreaIndexMaxMag(size_t areaAreaIndexMaxMag);
 
     void SetAreaNodeMinMag(size_t areaNodeMinMag);
@@ -21,6 +21,7 @@
 */
 
 #include <osmscout/DataFile.h>
+#include <osmscout/EytzingerIndex.h>
 
 #include <osmscout/import/RawRelation.h>
 
@@ -28,7 +29,7 @@
 
 namespace osmscout {
 
-  class RawRelationIndexedDataFile CLASS_FINAL : public IndexedDataFile<OSMId,RawRelation>
+  class RawRelationIndexedDataFile CLASS_FINAL : public IndexedDataFile<OSMId,RawRelation,EytzingerIndex<OSMId>>
   {
   public:
     RawRelationIndexedDataFile(size_t indexCacheSize,
@@ -21,6 +21,7 @@
 */
 
 #include <osmscout/DataFile.h>
+#include <osmscout/EytzingerIndex.h>
 
 #include <osmscout/import/RawWay.h>
 
@@ -28,7 +29,7 @@
 
 namespace osmscout {
 
-  class RawWayIndexedDataFile CLASS_FINAL : public IndexedDataFile<OSMId,RawWay>
+  class RawWayIndexedDataFile CLASS_FINAL : public IndexedDataFile<OSMId,RawWay,EytzingerIndex<OSMId>>
   {
   public:
     RawWayIndexedDataFile(size_t indexCacheSize,
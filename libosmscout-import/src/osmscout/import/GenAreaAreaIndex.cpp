@@ -902,7 +902,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    OptimizeAreaWayIdsGenerator::AREAS3_TMP),
                    FileScanner::Sequential,
-                   parameter.GetWayDataMemoryMaped());
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       progress.SetAction("Building in memory area index from '"+scanner.GetFilename()+"'");
 
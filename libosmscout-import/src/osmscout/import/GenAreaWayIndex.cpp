@@ -191,7 +191,8 @@ namespace osmscout {
       wayScanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                       WayDataFile::WAYS_DAT),
                       FileScanner::Sequential,
-                      parameter.GetWayDataMemoryMaped());
+                      parameter.GetWayDataMemoryMaped(),
+                      parameter.GetScanMMapPolicy());
 
       remainingWayTypes.Set(typeConfig.GetWayTypes());
 
@@ -460,7 +461,8 @@ namespace osmscout {
       wayScanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                       WayDataFile::WAYS_DAT),
                       FileScanner::Sequential,
-                      parameter.GetWayDataMemoryMaped());
+                      parameter.GetWayDataMemoryMaped(),
+                      parameter.GetScanMMapPolicy());
 
       for (MagnificationLevel l=parameter.GetAreaWayMinMag(); l<=maxLevel; l++) {
         Magnification magnification(l);
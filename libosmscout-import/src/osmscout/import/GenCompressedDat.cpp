@@ -0,0 +1,149 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/import/GenCompressedDat.h>
+
+#include <osmscout/AreaDataFile.h>
+#include <osmscout/WayDataFile.h>
+
+#include <osmscout/util/BlockCompression.h>
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/String.h>
+
+namespace osmscout {
+
+  void CompressedDataGenerator::GetDescription(const ImportParameter& /*parameter*/,
+                                               ImportModuleDescription& description) const
+  {
+    description.SetName("CompressedDataGenerator");
+    description.SetDescription("Block compress way and area data files");
+
+    description.AddRequiredFile(WayDataFile::WAYS_DAT);
+    description.AddRequiredFile(AreaDataFile::AREAS_DAT);
+  }
+
+  /**
+   * Collect the offsets of all records in the given data file (so blocks are only
+   * cut between records) and replace the file by its block compressed version.
+   */
+  template<class N>
+  bool CompressedDataGenerator::CompressDataFile(const TypeConfig& typeConfig,
+                                                 const ImportParameter& parameter,
+                                                 Progress& progress,
+                                                 const std::string& datafile)
+  {
+    std::string             filename=AppendFileToDir(parameter.GetDestinationDirectory(),
+                                                     datafile);
+    std::string             tmpFilename=filename+".tmp";
+    FileScanner             scanner;
+    std::vector<FileOffset> recordOffsets;
+
+    progress.SetAction("Compressing '"+datafile+"'");
+
+    try {
+      uint32_t dataCount;
+
+      scanner.Open(filename,
+                   FileScanner::Sequential,
+                   true,
+                   parameter.GetScanMMapPolicy());
+
+      if (scanner.IsBlockCompressed()) {
+        progress.Info("File is already compressed");
+        scanner.Close();
+
+        return true;
+      }
+
+      scanner.Read(dataCount);
+
+      recordOffsets.reserve(dataCount);
+
+      for (uint32_t current=1; current<=dataCount; current++) {
+        N data;
+
+        progress.SetProgress(current,dataCount);
+
+        recordOffsets.push_back(scanner.GetPos());
+
+        data.Read(typeConfig,
+                  scanner);
+      }
+
+      scanner.Close();
+
+      FileOffset uncompressedSize=GetFileSize(filename);
+
+      WriteBlockCompressedFile(filename,
+                               tmpFilename,
+                               recordOffsets,
+                               parameter.GetCompressedBlockSize());
+
+      FileOffset compressedSize=GetFileSize(tmpFilename);
+
+      progress.Info(std::to_string(dataCount)+" records, "+
+                    ByteSizeToString(uncompressedSize)+" => "+
+                    ByteSizeToString(compressedSize));
+    }
+    catch (IOException& e) {
+      progress.Error(e.GetDescription());
+      scanner.CloseFailsafe();
+      RemoveFile(tmpFilename);
+
+      return false;
+    }
+
+    if (!RemoveFile(filename) ||
+        !RenameFile(tmpFilename,
+                    filename)) {
+      progress.Error("Cannot replace '"+filename+"' by '"+tmpFilename+"'");
+
+      return false;
+    }
+
+    return true;
+  }
+
+  bool CompressedDataGenerator::Import(const TypeConfigRef& typeConfig,
+                                       const ImportParameter& parameter,
+                                       Progress& progress)
+  {
+    if (!parameter.GetCompressData()) {
+      progress.Info("Data compression is disabled");
+
+      return true;
+    }
+
+    if (!IsBlockCompressionSupported()) {
+      progress.Error("Data compression is not supported by this build");
+
+      return false;
+    }
+
+    return CompressDataFile<Way>(*typeConfig,
+                                 parameter,
+                                 progress,
+                                 WayDataFile::WAYS_DAT) &&
+           CompressDataFile<Area>(*typeConfig,
+                                  parameter,
+                                  progress,
+                                  AreaDataFile::AREAS_DAT);
+  }
+}
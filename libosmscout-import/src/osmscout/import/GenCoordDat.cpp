@@ -63,7 +63,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    Preprocess::RAWCOORDS_DAT),
                    FileScanner::Sequential,
-                   true);
+                   true,
+                   parameter.GetScanMMapPolicy());
 
       scanner.GotoBegin();
 
@@ -240,7 +241,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    Preprocess::RAWCOORDS_DAT),
                    FileScanner::Sequential,
-                   true);
+                   true,
+                   parameter.GetScanMMapPolicy());
 
       scanner.GotoBegin();
 
@@ -44,7 +44,8 @@ namespace osmscout {
     nodeScanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                      NodeDataFile::NODES_DAT),
                      FileScanner::Sequential,
-                     true);
+                     true,
+                     parameter.GetScanMMapPolicy());
 
     nodeScanner.Read(nodeCount);
 
@@ -78,7 +79,8 @@ namespace osmscout {
     wayScanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                     WayDataFile::WAYS_DAT),
                     FileScanner::Sequential,
-                    true);
+                    true,
+                    parameter.GetScanMMapPolicy());
 
     wayScanner.Read(wayCount);
 
@@ -124,7 +126,8 @@ namespace osmscout {
     areaScanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                      AreaDataFile::AREAS_DAT),
                      FileScanner::Sequential,
-                     true);
+                     true,
+                     parameter.GetScanMMapPolicy());
 
     areaScanner.Read(areaCount);
 
@@ -186,12 +189,13 @@ namespace osmscout {
                   std::to_string(width)+"x"+std::to_string(height));
 
 
-    if (width/8!=0) {
+    // Align to full bytes, also for imports covering less than 8 cells
+    if (width%8!=0) {
       width=(width/8+1)*8;
       maxCell.x=minCell.x+width-1;
     }
 
-    if (height/8!=0) {
+    if (height%8!=0) {
       height=(height/8+1)*8;
       maxCell.y=minCell.y+height-1;
     }
@@ -946,7 +946,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    AreaDataFile::AREAS_DAT),
                    FileScanner::Sequential,
-                   true);
+                   true,
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(areaCount);
 
@@ -1069,7 +1070,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    AreaDataFile::AREAS_DAT),
                    FileScanner::Sequential,
-                   parameter.GetWayDataMemoryMaped());
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(areaCount);
 
@@ -1270,7 +1272,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    NodeDataFile::NODES_DAT),
                    FileScanner::Sequential,
-                   true);
+                   true,
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(nodeCount);
 
@@ -1432,7 +1435,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    AreaDataFile::AREAS_DAT),
                    FileScanner::Sequential,
-                   parameter.GetWayDataMemoryMaped());
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(areaCount);
 
@@ -1546,7 +1550,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    WayDataFile::WAYS_DAT),
                    FileScanner::Sequential,
-                   parameter.GetWayDataMemoryMaped());
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(wayCount);
 
@@ -1776,7 +1781,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    AreaAreaIndexGenerator::AREAADDRESS_DAT),
                    FileScanner::Sequential,
-                   parameter.GetWayDataMemoryMaped());
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(areaCount);
 
@@ -1990,7 +1996,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    SortWayDataGenerator::WAYADDRESS_DAT),
                    FileScanner::Sequential,
-                   parameter.GetWayDataMemoryMaped());
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(wayCount);
 
@@ -2170,7 +2177,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    SortNodeDataGenerator::NODEADDRESS_DAT),
                    FileScanner::Sequential,
-                   true);
+                   true,
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(nodeCount);
 
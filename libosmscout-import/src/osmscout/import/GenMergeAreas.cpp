@@ -580,7 +580,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    MergeAreaDataGenerator::AREAS_TMP),
                    FileScanner::Sequential,
-                   parameter.GetRawWayDataMemoryMaped());
+                   parameter.GetRawWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       if (!ScanAreaNodeIds(progress,
                            *typeConfig,
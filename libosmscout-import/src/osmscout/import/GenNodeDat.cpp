@@ -73,7 +73,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    Preprocess::RAWNODES_DAT),
                    FileScanner::Sequential,
-                   parameter.GetRawNodeDataMemoryMaped());
+                   parameter.GetRawNodeDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(rawNodeCount);
 
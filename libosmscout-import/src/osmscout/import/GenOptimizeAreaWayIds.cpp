@@ -62,7 +62,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    MergeAreasGenerator::AREAS2_TMP),
                    FileScanner::Sequential,
-                   parameter.GetAreaDataMemoryMaped());
+                   parameter.GetAreaDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(dataCount);
 
@@ -133,7 +134,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    WayWayDataGenerator::WAYWAY_TMP),
                    FileScanner::Sequential,
-                   parameter.GetWayDataMemoryMaped());
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(dataCount);
 
@@ -216,7 +218,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    MergeAreasGenerator::AREAS2_TMP),
                    FileScanner::Sequential,
-                   parameter.GetAreaDataMemoryMaped());
+                   parameter.GetAreaDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(areaCount);
 
@@ -287,7 +290,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    WayWayDataGenerator::WAYWAY_TMP),
                    FileScanner::Sequential,
-                   parameter.GetWayDataMemoryMaped());
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(dataCount);
 
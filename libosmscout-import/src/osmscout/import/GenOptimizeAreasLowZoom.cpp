@@ -499,7 +499,8 @@ namespace osmscout
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    AreaDataFile::AREAS_DAT),
                    FileScanner::Sequential,
-                   parameter.GetWayDataMemoryMaped());
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       TypeInfoSet                      typesToProcess(types);
       std::vector<std::list<AreaRef> > allAreas(typeConfig.GetTypeCount());
@@ -618,7 +618,8 @@ namespace osmscout
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    WayDataFile::WAYS_DAT),
                    FileScanner::Sequential,
-                   parameter.GetWayDataMemoryMaped());
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       std::set<TypeInfoRef>           typesToProcess(types);
       std::vector<std::list<WayRef> > allWays(typeConfig.GetTypeCount());
@@ -26,9 +26,9 @@ namespace osmscout {
   const char* RawRelationIndexGenerator::RAWREL_IDX="rawrel.idx";
 
   RawRelationIndexGenerator::RawRelationIndexGenerator()
-   : NumericIndexGenerator<OSMId,RawRelation>("Generating 'rawrel.idx'",
-                                              Preprocess::RAWRELS_DAT,
-                                              RAWREL_IDX)
+   : EytzingerIndexGenerator<OSMId,RawRelation>("Generating 'rawrel.idx'",
+                                                Preprocess::RAWRELS_DAT,
+                                                RAWREL_IDX)
   {
     // no code
   }
@@ -26,9 +26,9 @@ namespace osmscout {
   const char* RawWayIndexGenerator::RAWWAY_IDX="rawway.idx";
 
   RawWayIndexGenerator::RawWayIndexGenerator()
-   : NumericIndexGenerator<OSMId,RawWay>("Generating 'rawway.idx'",
-                                         Preprocess::RAWWAYS_DAT,
-                                         RAWWAY_IDX)
+   : EytzingerIndexGenerator<OSMId,RawWay>("Generating 'rawway.idx'",
+                                           Preprocess::RAWWAYS_DAT,
+                                           RAWWAY_IDX)
   {
     // no code
   }
@@ -1189,7 +1189,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    Preprocess::RAWRELS_DAT),
                    FileScanner::Sequential,
-                   true);
+                   true,
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(rawRelationCount);
 
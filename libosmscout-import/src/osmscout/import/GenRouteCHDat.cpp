@@ -0,0 +1,726 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/import/GenRouteCHDat.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+
+#include <osmscout/ObjectVariantDataFile.h>
+
+#include <osmscout/routing/RouteNode.h>
+#include <osmscout/routing/RoutingService.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+#include <osmscout/util/String.h>
+
+namespace osmscout {
+
+  static const uint32_t NO_NODE=std::numeric_limits<uint32_t>::max();
+
+  /**
+   * Maximum number of nodes settled during a witness search. If the limit is
+   * reached we add a shortcut, even if it might not be necessary.
+   */
+  static const size_t WITNESS_SETTLE_LIMIT=500;
+
+  static std::string VehicleToString(Vehicle vehicle)
+  {
+    switch (vehicle) {
+    case vehicleFoot:
+      return "foot";
+    case vehicleBicycle:
+      return "bicycle";
+    case vehicleCar:
+      return "car";
+    }
+
+    return "???";
+  }
+
+  namespace {
+
+    typedef std::pair<double,uint32_t>                  QueueEntry;
+    typedef std::priority_queue<QueueEntry,
+                                std::vector<QueueEntry>,
+                                std::greater<QueueEntry>> CostQueue;
+
+    /**
+     * Dijkstra search in the remaining (not yet contracted) graph, used to find
+     * witness paths that make a shortcut unnecessary.
+     */
+    class WitnessSearch
+    {
+    private:
+      const RouteCHGenerator::EdgeList& outEdges;
+      const std::vector<bool>&          contracted;
+      std::vector<double>               costs;
+      std::vector<uint32_t>             touched;
+
+    public:
+      WitnessSearch(const RouteCHGenerator::EdgeList& outEdges,
+                    const std::vector<bool>& contracted)
+      : outEdges(outEdges),
+        contracted(contracted),
+        costs(outEdges.size(),
+              std::numeric_limits<double>::infinity())
+      {
+        // no code
+      }
+
+      /**
+       * Search from 'source' ignoring node 'ignore' until all nodes cheaper than
+       * maxCost are settled or the settle limit has been reached.
+       */
+      void Search(uint32_t source,
+                  uint32_t ignore,
+                  double maxCost)
+      {
+        CostQueue queue;
+        size_t    settled=0;
+
+        for (uint32_t node : touched) {
+          costs[node]=std::numeric_limits<double>::infinity();
+        }
+        touched.clear();
+
+        costs[source]=0.0;
+        touched.push_back(source);
+        queue.push(QueueEntry(0.0,source));
+
+        while (!queue.empty() &&
+               settled<WITNESS_SETTLE_LIMIT) {
+          QueueEntry current=queue.top();
+
+          queue.pop();
+
+          if (current.first>costs[current.second]) {
+            continue;
+          }
+
+          if (current.first>maxCost) {
+            break;
+          }
+
+          settled++;
+
+          for (const auto& edge : outEdges[current.second]) {
+            if (edge.node==ignore ||
+                contracted[edge.node]) {
+              continue;
+            }
+
+            double cost=current.first+edge.cost;
+
+            if (cost<costs[edge.node]) {
+              if (costs[edge.node]==std::numeric_limits<double>::infinity()) {
+                touched.push_back(edge.node);
+              }
+
+              costs[edge.node]=cost;
+              queue.push(QueueEntry(cost,edge.node));
+            }
+          }
+        }
+      }
+
+      inline double GetCost(uint32_t node) const
+      {
+        return costs[node];
+      }
+    };
+
+    struct Shortcut
+    {
+      uint32_t from;
+      uint32_t to;
+      double   cost;
+    };
+
+    /**
+     * Collect the shortcuts necessary, if the given node gets contracted
+     */
+    void CollectShortcuts(const RouteCHGenerator::Graph& graph,
+                          const std::vector<bool>& contracted,
+                          WitnessSearch& witnessSearch,
+                          uint32_t node,
+                          std::vector<Shortcut>& shortcuts)
+    {
+      shortcuts.clear();
+
+      for (const auto& inEdge : graph.inEdges[node]) {
+        if (contracted[inEdge.node]) {
+          continue;
+        }
+
+        double maxCost=-1.0;
+
+        for (const auto& outEdge : graph.outEdges[node]) {
+          if (!contracted[outEdge.node] &&
+              outEdge.node!=inEdge.node) {
+            maxCost=std::max(maxCost,inEdge.cost+outEdge.cost);
+          }
+        }
+
+        // No target to reach
+        if (maxCost<0.0) {
+          continue;
+        }
+
+        witnessSearch.Search(inEdge.node,
+                             node,
+                             maxCost);
+
+        for (const auto& outEdge : graph.outEdges[node]) {
+          if (contracted[outEdge.node] ||
+              outEdge.node==inEdge.node) {
+            continue;
+          }
+
+          double cost=inEdge.cost+outEdge.cost;
+
+          if (witnessSearch.GetCost(outEdge.node)>cost) {
+            shortcuts.push_back(Shortcut{inEdge.node,outEdge.node,cost});
+          }
+        }
+      }
+    }
+
+    /**
+     * Add the edge to the list or replace an existing, more expensive edge to
+     * the same node. Returns false, if a cheaper edge already exists.
+     */
+    bool AddEdge(std::vector<RouteCHGenerator::Edge>& edges,
+                 const RouteCHGenerator::Edge& edge)
+    {
+      for (auto& existing : edges) {
+        if (existing.node==edge.node) {
+          if (existing.cost<=edge.cost) {
+            return false;
+          }
+
+          existing=edge;
+
+          return true;
+        }
+      }
+
+      edges.push_back(edge);
+
+      return true;
+    }
+
+    void WriteSpeed(FileWriter& writer,
+                    double speed)
+    {
+      uint64_t speedBits;
+
+      std::memcpy(&speedBits,&speed,sizeof(speedBits));
+      writer.Write(speedBits);
+    }
+
+    void WriteEdges(FileWriter& writer,
+                    const std::vector<RouteCHGenerator::Edge>& edges)
+    {
+      writer.WriteNumber((uint32_t)edges.size());
+
+      for (const auto& edge : edges) {
+        uint64_t costBits;
+
+        writer.WriteNumber(edge.node);
+
+        if (edge.middle==NO_NODE) {
+          writer.WriteNumber((uint32_t)0);
+          writer.WriteNumber(edge.object);
+        }
+        else {
+          writer.WriteNumber(edge.middle+1);
+        }
+
+        std::memcpy(&costBits,&edge.cost,sizeof(costBits));
+        writer.Write(costBits);
+      }
+    }
+  }
+
+  /**
+   * Parametrize the profile for the given vehicle using the speeds of the import
+   * parameter.
+   *
+   * @return
+   *    false, if there is no car speed table
+   */
+  bool RouteCHGenerator::ParametrizeProfile(const TypeConfig& typeConfig,
+                                            const ImportParameter& parameter,
+                                            Vehicle vehicle,
+                                            FastestPathRoutingProfile& profile)
+  {
+    switch (vehicle) {
+    case vehicleFoot:
+      profile.ParametrizeForFoot(typeConfig,
+                                 parameter.GetRouterMaxSpeed(vehicleFoot));
+      break;
+    case vehicleBicycle:
+      profile.ParametrizeForBicycle(typeConfig,
+                                    parameter.GetRouterMaxSpeed(vehicleBicycle));
+      break;
+    case vehicleCar:
+      if (parameter.GetRouterCarSpeedTable().empty()) {
+        return false;
+      }
+
+      profile.ParametrizeForCar(typeConfig,
+                                parameter.GetRouterCarSpeedTable(),
+                                parameter.GetRouterMaxSpeed(vehicleCar));
+      break;
+    }
+
+    return true;
+  }
+
+  void RouteCHGenerator::GetDescription(const ImportParameter& parameter,
+                                        ImportModuleDescription& description) const
+  {
+    description.SetName("RouteCHGenerator");
+    description.SetDescription("Generate contraction hierarchies for routing");
+
+    for (const auto& router : parameter.GetRouter()) {
+      description.AddRequiredFile(router.GetDataFilename());
+      description.AddRequiredFile(router.GetVariantFilename());
+
+      for (Vehicle vehicle : {vehicleFoot, vehicleBicycle, vehicleCar}) {
+        if ((router.GetVehicleMask() & vehicle)!=0) {
+          description.AddProvidedOptionalFile(RoutingService::GetCHFilename(router.GetFilenamebase(),
+                                                                            vehicle));
+        }
+      }
+    }
+  }
+
+  /**
+   * Load all route nodes of the router and build the routing graph for the
+   * given profile. Paths that cannot be used or are restricted are skipped,
+   * for multiple paths between the same nodes only the cheapest one is kept.
+   */
+  bool RouteCHGenerator::LoadGraph(const TypeConfig& typeConfig,
+                                   const ImportParameter& parameter,
+                                   Progress& progress,
+                                   const ImportParameter::Router& router,
+                                   const RoutingProfile& profile,
+                                   Graph& graph)
+  {
+    ObjectVariantDataFile variantDataFile;
+
+    if (!variantDataFile.Load(typeConfig,
+                              AppendFileToDir(parameter.GetDestinationDirectory(),
+                                              router.GetVariantFilename()))) {
+      progress.Error("Cannot load '"+router.GetVariantFilename()+"'");
+      return false;
+    }
+
+    FileScanner                      scanner;
+    std::map<ObjectFileRef,uint32_t> objectIndexMap;
+
+    graph.nodeIds.clear();
+    graph.objects.clear();
+    graph.outEdges.clear();
+    graph.inEdges.clear();
+
+    try {
+      FileOffset indexFileOffset;
+      uint32_t   dataCount;
+      uint32_t   tileMag;
+      FileOffset dataOffset;
+
+      scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
+                                   router.GetDataFilename()),
+                   FileScanner::Sequential,
+                   true,
+                   parameter.GetScanMMapPolicy());
+
+      scanner.Read(indexFileOffset);
+      scanner.Read(dataCount);
+      scanner.Read(tileMag);
+
+      dataOffset=scanner.GetPos();
+
+      // First pass: collect and sort the node ids
+
+      graph.nodeIds.reserve(dataCount);
+
+      for (uint32_t current=1; current<=dataCount; current++) {
+        RouteNode node;
+
+        progress.SetProgress(current,2*dataCount);
+
+        node.Read(scanner);
+
+        graph.nodeIds.push_back(node.GetId());
+      }
+
+      std::sort(graph.nodeIds.begin(),
+                graph.nodeIds.end());
+
+      graph.outEdges.resize(graph.nodeIds.size());
+      graph.inEdges.resize(graph.nodeIds.size());
+
+      // Second pass: build the edges
+
+      scanner.SetPos(dataOffset);
+
+      for (uint32_t current=1; current<=dataCount; current++) {
+        RouteNode node;
+
+        progress.SetProgress(dataCount+current,2*dataCount);
+
+        node.Read(scanner);
+
+        uint32_t from=(uint32_t)(std::lower_bound(graph.nodeIds.begin(),
+                                                  graph.nodeIds.end(),
+                                                  node.GetId())-graph.nodeIds.begin());
+
+        for (size_t i=0; i<node.paths.size(); i++) {
+          const RouteNode::Path& path=node.paths[i];
+
+          if (path.IsRestricted(profile.GetVehicle()) ||
+              !profile.CanUse(node,
+                              variantDataFile.GetData(),
+                              i)) {
+            continue;
+          }
+
+          auto target=std::lower_bound(graph.nodeIds.begin(),
+                                       graph.nodeIds.end(),
+                                       path.id);
+
+          if (target==graph.nodeIds.end() ||
+              *target!=path.id) {
+            continue;
+          }
+
+          uint32_t to=(uint32_t)(target-graph.nodeIds.begin());
+
+          if (to==from) {
+            continue;
+          }
+
+          ObjectFileRef object=node.objects[path.objectIndex].object;
+          auto          objectEntry=objectIndexMap.find(object);
+          uint32_t      objectIndex;
+
+          if (objectEntry==objectIndexMap.end()) {
+            objectIndex=(uint32_t)graph.objects.size();
+            objectIndexMap.insert(std::make_pair(object,objectIndex));
+            graph.objects.push_back(object);
+          }
+          else {
+            objectIndex=objectEntry->second;
+          }
+
+          double cost=profile.GetCosts(node,
+                                       variantDataFile.GetData(),
+                                       i);
+
+          if (AddEdge(graph.outEdges[from],
+                      Edge{to,NO_NODE,objectIndex,cost})) {
+            AddEdge(graph.inEdges[to],
+                    Edge{from,NO_NODE,objectIndex,cost});
+          }
+        }
+      }
+
+      scanner.Close();
+    }
+    catch (IOException& e) {
+      progress.Error(e.GetDescription());
+      scanner.CloseFailsafe();
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Contract all nodes of the graph, ordered by a priority based on the edge
+   * difference, the number of already contracted neighbours and the level of
+   * the node. Priorities are updated lazily.
+   *
+   * Afterwards upEdges contain for each node the outgoing edges to nodes with a
+   * higher rank, downEdges the incoming edges from nodes with a higher rank.
+   */
+  void RouteCHGenerator::Contract(Progress& progress,
+                                  Graph& graph,
+                                  EdgeList& upEdges,
+                                  EdgeList& downEdges)
+  {
+    size_t                nodeCount=graph.nodeIds.size();
+    std::vector<bool>     contracted(nodeCount,false);
+    std::vector<uint32_t> contractedNeighbours(nodeCount,0);
+    std::vector<uint32_t> level(nodeCount,0);
+    std::vector<Shortcut> shortcuts;
+    WitnessSearch         witnessSearch(graph.outEdges,
+                                        contracted);
+    CostQueue             queue;
+    size_t                shortcutCount=0;
+
+    auto priority=[&](uint32_t node) -> double {
+      size_t degree=0;
+
+      CollectShortcuts(graph,
+                       contracted,
+                       witnessSearch,
+                       node,
+                       shortcuts);
+
+      for (const auto& edge : graph.inEdges[node]) {
+        if (!contracted[edge.node]) {
+          degree++;
+        }
+      }
+
+      for (const auto& edge : graph.outEdges[node]) {
+        if (!contracted[edge.node]) {
+          degree++;
+        }
+      }
+
+      return 2.0*((double)shortcuts.size()-(double)degree)+
+             (double)contractedNeighbours[node]+
+             (double)level[node];
+    };
+
+    upEdges.clear();
+    upEdges.resize(nodeCount);
+    downEdges.clear();
+    downEdges.resize(nodeCount);
+
+    progress.SetAction("Calculating node order");
+
+    for (uint32_t node=0; node<nodeCount; node++) {
+      progress.SetProgress((size_t)node,nodeCount);
+
+      queue.push(QueueEntry(priority(node),node));
+    }
+
+    progress.SetAction("Contracting nodes");
+
+    size_t contractedCount=0;
+
+    while (!queue.empty()) {
+      QueueEntry current=queue.top();
+
+      queue.pop();
+
+      uint32_t node=current.second;
+
+      if (contracted[node]) {
+        continue;
+      }
+
+      // Lazy update: If the priority got worse, push it back
+      double currentPriority=priority(node);
+
+      if (!queue.empty() &&
+          currentPriority>queue.top().first) {
+        queue.push(QueueEntry(currentPriority,node));
+        continue;
+      }
+
+      progress.SetProgress(contractedCount,nodeCount);
+
+      // shortcuts are still valid from the priority calculation above
+      for (const auto& shortcut : shortcuts) {
+        if (AddEdge(graph.outEdges[shortcut.from],
+                    Edge{shortcut.to,node,0,shortcut.cost})) {
+          AddEdge(graph.inEdges[shortcut.to],
+                  Edge{shortcut.from,node,0,shortcut.cost});
+          shortcutCount++;
+        }
+      }
+
+      for (const auto& edge : graph.outEdges[node]) {
+        if (!contracted[edge.node]) {
+          upEdges[node].push_back(edge);
+        }
+      }
+
+      for (const auto& edge : graph.inEdges[node]) {
+        if (!contracted[edge.node]) {
+          downEdges[node].push_back(edge);
+        }
+      }
+
+      contracted[node]=true;
+      contractedCount++;
+
+      graph.outEdges[node].clear();
+      graph.outEdges[node].shrink_to_fit();
+      graph.inEdges[node].clear();
+      graph.inEdges[node].shrink_to_fit();
+
+      for (const auto& edges : {&upEdges[node], &downEdges[node]}) {
+        for (const auto& edge : *edges) {
+          contractedNeighbours[edge.node]++;
+          level[edge.node]=std::max(level[edge.node],level[node]+1);
+        }
+      }
+    }
+
+    progress.Info(std::to_string(shortcutCount)+" shortcuts added");
+  }
+
+  /**
+   * Write the hierarchy in the format expected by ContractionHierarchy::Load()
+   */
+  bool RouteCHGenerator::WriteHierarchy(const TypeConfig& typeConfig,
+                                        Progress& progress,
+                                        const std::string& filename,
+                                        const FastestPathRoutingProfile& profile,
+                                        const Graph& graph,
+                                        const EdgeList& upEdges,
+                                        const EdgeList& downEdges)
+  {
+    FileWriter writer;
+
+    try {
+      Id lastId=0;
+
+      writer.Open(filename);
+
+      WriteSpeed(writer,
+                 profile.GetVehicleMaxSpeed());
+
+      writer.WriteNumber((uint32_t)typeConfig.GetTypeCount());
+
+      for (size_t typeIndex=0; typeIndex<typeConfig.GetTypeCount(); typeIndex++) {
+        WriteSpeed(writer,
+                   profile.GetTypeSpeed(typeIndex));
+      }
+
+      writer.Write((uint32_t)graph.nodeIds.size());
+
+      for (Id id : graph.nodeIds) {
+        writer.WriteNumber(id-lastId);
+        lastId=id;
+      }
+
+      writer.Write((uint32_t)graph.objects.size());
+
+      for (const auto& object : graph.objects) {
+        writer.Write(object);
+      }
+
+      for (size_t node=0; node<graph.nodeIds.size(); node++) {
+        WriteEdges(writer,
+                   upEdges[node]);
+        WriteEdges(writer,
+                   downEdges[node]);
+      }
+
+      writer.Close();
+    }
+    catch (IOException& e) {
+      progress.Error(e.GetDescription());
+      writer.CloseFailsafe();
+      return false;
+    }
+
+    return true;
+  }
+
+  bool RouteCHGenerator::Import(const TypeConfigRef& typeConfig,
+                                const ImportParameter& parameter,
+                                Progress& progress)
+  {
+    if (!parameter.GetRouterCH()) {
+      progress.Info("Generation of contraction hierarchies is disabled");
+
+      return true;
+    }
+
+    for (const auto& router : parameter.GetRouter()) {
+      for (Vehicle vehicle : {vehicleFoot, vehicleBicycle, vehicleCar}) {
+        if ((router.GetVehicleMask() & vehicle)==0) {
+          continue;
+        }
+
+        FastestPathRoutingProfile profile(typeConfig);
+        Graph                     graph;
+        EdgeList                  upEdges;
+        EdgeList                  downEdges;
+        std::string               filename=RoutingService::GetCHFilename(router.GetFilenamebase(),
+                                                                         vehicle);
+
+        if (!ParametrizeProfile(*typeConfig,
+                                parameter,
+                                vehicle,
+                                profile)) {
+          progress.Warning("No car speed table set, skipping contraction hierarchy for car");
+          continue;
+        }
+
+        progress.SetAction("Loading routing graph of '"+router.GetDataFilename()+"' for "+VehicleToString(vehicle));
+
+        if (!LoadGraph(*typeConfig,
+                       parameter,
+                       progress,
+                       router,
+                       profile,
+                       graph)) {
+          return false;
+        }
+
+        size_t edgeCount=0;
+
+        for (const auto& edges : graph.outEdges) {
+          edgeCount+=edges.size();
+        }
+
+        progress.Info(std::to_string(graph.nodeIds.size())+" nodes, "+
+                      std::to_string(edgeCount)+" edges");
+
+        Contract(progress,
+                 graph,
+                 upEdges,
+                 downEdges);
+
+        progress.SetAction("Writing '"+filename+"'");
+
+        if (!WriteHierarchy(*typeConfig,
+                            progress,
+                            AppendFileToDir(parameter.GetDestinationDirectory(),
+                                            filename),
+                            profile,
+                            graph,
+                            upEdges,
+                            downEdges)) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+}
@@ -292,7 +292,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    WayWayDataGenerator::TURNRESTR_DAT),
                    FileScanner::Sequential,
-                   true);
+                   true,
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(restrictionCount);
 
@@ -334,7 +335,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    WayDataFile::WAYS_IDMAP),
                    FileScanner::Sequential,
-                   parameter.GetWayDataMemoryMaped());
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(wayCount);
 
@@ -442,7 +444,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    WayWayDataGenerator::TURNRESTR_DAT),
                    FileScanner::Sequential,
-                   true);
+                   true,
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(restrictionCount);
 
@@ -611,7 +614,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    WayDataFile::WAYS_DAT),
                    FileScanner::Sequential,
-                   parameter.GetWayDataMemoryMaped());
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(dataCount);
 
@@ -654,7 +658,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    AreaDataFile::AREAS_DAT),
                    FileScanner::Sequential,
-                   parameter.GetAreaDataMemoryMaped());
+                   parameter.GetAreaDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(dataCount);
 
@@ -727,7 +732,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    WayDataFile::WAYS_DAT),
                    FileScanner::Sequential,
-                   parameter.GetWayDataMemoryMaped());
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(dataCount);
 
@@ -774,7 +780,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    AreaDataFile::AREAS_DAT),
                    FileScanner::Sequential,
-                   parameter.GetAreaDataMemoryMaped());
+                   parameter.GetAreaDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(dataCount);
 
@@ -1457,12 +1464,14 @@ namespace osmscout {
       wayScanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                       WayDataFile::WAYS_DAT),
                       FileScanner::Sequential,
-                      parameter.GetWayDataMemoryMaped());
+                      parameter.GetWayDataMemoryMaped(),
+                      parameter.GetScanMMapPolicy());
 
       areaScanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                        AreaDataFile::AREAS_DAT),
                        FileScanner::Sequential,
-                       parameter.GetAreaDataMemoryMaped());
+                       parameter.GetAreaDataMemoryMaped(),
+                       parameter.GetScanMMapPolicy());
 
       Pixel      currentCell(0,0);
       IndexEntry currentIndex(0);
@@ -0,0 +1,322 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/import/GenRouteGraphDat.h>
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+#include <osmscout/routing/RouteNode.h>
+#include <osmscout/routing/RoutingService.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+
+namespace osmscout {
+
+  namespace {
+
+    uint32_t GetIndex(const std::vector<uint64_t>& objects,
+                      const ObjectFileRef& object)
+    {
+      return (uint32_t)(std::lower_bound(objects.begin(),
+                                         objects.end(),
+                                         RouteGraph::EncodeObject(object))-objects.begin());
+    }
+
+    void WritePadding(FileWriter& writer,
+                      size_t bytes)
+    {
+      for (size_t i=bytes; i%8!=0; i++) {
+        writer.Write((uint8_t)0);
+      }
+    }
+  }
+
+  void RouteGraphGenerator::GetDescription(const ImportParameter& parameter,
+                                           ImportModuleDescription& description) const
+  {
+    description.SetName("RouteGraphGenerator");
+    description.SetDescription("Generate compact routing graph");
+
+    for (const auto& router : parameter.GetRouter()) {
+      description.AddRequiredFile(router.GetDataFilename());
+      description.AddProvidedOptionalFile(RoutingService::GetGraphFilename(router.GetFilenamebase()));
+    }
+  }
+
+  /**
+   * Load all route nodes of the router. The first pass collects the node ids,
+   * the objects and the number of paths and excludes of each node, the second
+   * pass fills the edges and excludes at their final position.
+   */
+  bool RouteGraphGenerator::LoadGraph(const ImportParameter& parameter,
+                                      Progress& progress,
+                                      const ImportParameter::Router& router,
+                                      Graph& graph)
+  {
+    FileScanner scanner;
+
+    graph.nodeIds.clear();
+    graph.objects.clear();
+    graph.edgeOffsets.clear();
+    graph.edges.clear();
+    graph.excludeOffsets.clear();
+    graph.excludes.clear();
+
+    try {
+      FileOffset indexFileOffset;
+      uint32_t   dataCount;
+      uint32_t   tileMag;
+      FileOffset dataOffset;
+
+      // Node id, number of paths, number of excludes
+      std::vector<std::tuple<Id,uint32_t,uint32_t>> nodes;
+
+      scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
+                                   router.GetDataFilename()),
+                   FileScanner::Sequential,
+                   true,
+                   parameter.GetScanMMapPolicy());
+
+      scanner.Read(indexFileOffset);
+      scanner.Read(dataCount);
+      scanner.Read(tileMag);
+
+      dataOffset=scanner.GetPos();
+
+      nodes.reserve(dataCount);
+
+      for (uint32_t current=1; current<=dataCount; current++) {
+        RouteNode node;
+
+        progress.SetProgress(current,2*dataCount);
+
+        node.Read(scanner);
+
+        nodes.emplace_back(node.GetId(),
+                           (uint32_t)node.paths.size(),
+                           (uint32_t)node.excludes.size());
+
+        for (const auto& object : node.objects) {
+          graph.objects.push_back(RouteGraph::EncodeObject(object.object));
+        }
+
+        for (const auto& exclude : node.excludes) {
+          graph.objects.push_back(RouteGraph::EncodeObject(exclude.source));
+        }
+      }
+
+      std::sort(nodes.begin(),
+                nodes.end());
+
+      std::sort(graph.objects.begin(),
+                graph.objects.end());
+      graph.objects.erase(std::unique(graph.objects.begin(),
+                                      graph.objects.end()),
+                          graph.objects.end());
+
+      graph.nodeIds.reserve(nodes.size());
+      graph.edgeOffsets.reserve(nodes.size()+1);
+      graph.excludeOffsets.reserve(nodes.size()+1);
+
+      uint32_t edgeCount=0;
+      uint32_t excludeCount=0;
+
+      for (const auto& node : nodes) {
+        graph.nodeIds.push_back(std::get<0>(node));
+        graph.edgeOffsets.push_back(edgeCount);
+        graph.excludeOffsets.push_back(excludeCount);
+
+        edgeCount+=std::get<1>(node);
+        excludeCount+=std::get<2>(node);
+      }
+
+      graph.edgeOffsets.push_back(edgeCount);
+      graph.excludeOffsets.push_back(excludeCount);
+
+      graph.edges.resize(edgeCount);
+      graph.excludes.resize(excludeCount);
+
+      scanner.SetPos(dataOffset);
+
+      for (uint32_t current=1; current<=dataCount; current++) {
+        RouteNode node;
+
+        progress.SetProgress(dataCount+current,2*dataCount);
+
+        node.Read(scanner);
+
+        size_t   index=std::lower_bound(graph.nodeIds.begin(),
+                                        graph.nodeIds.end(),
+                                        node.GetId())-graph.nodeIds.begin();
+        uint32_t firstEdge=graph.edgeOffsets[index];
+        uint32_t firstExclude=graph.excludeOffsets[index];
+
+        for (size_t i=0; i<node.paths.size(); i++) {
+          const RouteNode::Path&       path=node.paths[i];
+          const RouteNode::ObjectData& object=node.objects[path.objectIndex];
+          RouteGraph::Edge&            edge=graph.edges[firstEdge+i];
+          auto                         target=std::lower_bound(graph.nodeIds.begin(),
+                                                               graph.nodeIds.end(),
+                                                               path.id);
+
+          if (target==graph.nodeIds.end() ||
+              *target!=path.id) {
+            edge.target=RouteGraph::NO_NODE;
+          }
+          else {
+            edge.target=(uint32_t)(target-graph.nodeIds.begin());
+          }
+
+          edge.distance=(uint32_t)std::floor(path.distance.As<Meter>()*100.0+0.5);
+          edge.object=GetIndex(graph.objects,
+                               object.object);
+          edge.objectVariantIndex=object.objectVariantIndex;
+          edge.flags=path.flags;
+          edge.reserved=0;
+        }
+
+        for (size_t i=0; i<node.excludes.size(); i++) {
+          RouteGraph::Exclude& exclude=graph.excludes[firstExclude+i];
+
+          exclude.source=GetIndex(graph.objects,
+                                  node.excludes[i].source);
+          exclude.edge=firstEdge+node.excludes[i].targetIndex;
+        }
+      }
+
+      scanner.Close();
+    }
+    catch (IOException& e) {
+      progress.Error(e.GetDescription());
+      scanner.CloseFailsafe();
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Write the graph in the format expected by RouteGraph::Open()
+   */
+  bool RouteGraphGenerator::WriteGraph(Progress& progress,
+                                       const std::string& filename,
+                                       const Graph& graph)
+  {
+    FileWriter writer;
+
+    try {
+      writer.Open(filename);
+
+      writer.Write((uint32_t)graph.nodeIds.size());
+      writer.Write((uint32_t)graph.edges.size());
+      writer.Write((uint32_t)graph.excludes.size());
+      writer.Write((uint32_t)graph.objects.size());
+
+      for (Id id : graph.nodeIds) {
+        writer.Write(id);
+      }
+
+      for (uint32_t offset : graph.edgeOffsets) {
+        writer.Write(offset);
+      }
+
+      WritePadding(writer,
+                   graph.edgeOffsets.size()*sizeof(uint32_t));
+
+      for (const auto& edge : graph.edges) {
+        writer.Write(edge.target);
+        writer.Write(edge.distance);
+        writer.Write(edge.object);
+        writer.Write(edge.objectVariantIndex);
+        writer.Write(edge.flags);
+        writer.Write(edge.reserved);
+      }
+
+      for (uint32_t offset : graph.excludeOffsets) {
+        writer.Write(offset);
+      }
+
+      WritePadding(writer,
+                   graph.excludeOffsets.size()*sizeof(uint32_t));
+
+      for (const auto& exclude : graph.excludes) {
+        writer.Write(exclude.source);
+        writer.Write(exclude.edge);
+      }
+
+      for (uint64_t object : graph.objects) {
+        writer.Write(object);
+      }
+
+      writer.Close();
+    }
+    catch (IOException& e) {
+      progress.Error(e.GetDescription());
+      writer.CloseFailsafe();
+      return false;
+    }
+
+    return true;
+  }
+
+  bool RouteGraphGenerator::Import(const TypeConfigRef& /*typeConfig*/,
+                                   const ImportParameter& parameter,
+                                   Progress& progress)
+  {
+    if (!parameter.GetRouterGraph()) {
+      progress.Info("Generation of the compact routing graph is disabled");
+
+      return true;
+    }
+
+    for (const auto& router : parameter.GetRouter()) {
+      Graph       graph;
+      std::string filename=RoutingService::GetGraphFilename(router.GetFilenamebase());
+
+      progress.SetAction("Loading routing graph of '"+router.GetDataFilename()+"'");
+
+      if (!LoadGraph(parameter,
+                     progress,
+                     router,
+                     graph)) {
+        return false;
+      }
+
+      progress.Info(std::to_string(graph.nodeIds.size())+" nodes, "+
+                    std::to_string(graph.edges.size())+" edges, "+
+                    std::to_string(graph.excludes.size())+" excludes, "+
+                    std::to_string(graph.objects.size())+" objects");
+
+      progress.SetAction("Writing '"+filename+"'");
+
+      if (!WriteGraph(progress,
+                      AppendFileToDir(parameter.GetDestinationDirectory(),
+                                      filename),
+                      graph)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+}
@@ -0,0 +1,603 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/import/GenRouteLandmarkDat.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+
+#include <osmscout/ObjectVariantDataFile.h>
+
+#include <osmscout/import/GenRouteCHDat.h>
+
+#include <osmscout/routing/LandmarkTable.h>
+#include <osmscout/routing/RouteNode.h>
+#include <osmscout/routing/RoutingService.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+
+namespace osmscout {
+
+  static std::string VehicleToString(Vehicle vehicle)
+  {
+    switch (vehicle) {
+    case vehicleFoot:
+      return "foot";
+    case vehicleBicycle:
+      return "bicycle";
+    case vehicleCar:
+      return "car";
+    }
+
+    return "???";
+  }
+
+  static uint8_t VehicleToPathFlag(Vehicle vehicle)
+  {
+    switch (vehicle) {
+    case vehicleFoot:
+      return RouteNode::usableByFoot;
+    case vehicleBicycle:
+      return RouteNode::usableByBicycle;
+    case vehicleCar:
+      return RouteNode::usableByCar;
+    }
+
+    return 0;
+  }
+
+  static void WriteDouble(FileWriter& writer,
+                          double value)
+  {
+    uint64_t bits;
+
+    std::memcpy(&bits,&value,sizeof(bits));
+    writer.Write(bits);
+  }
+
+  namespace {
+
+    typedef std::pair<double,uint32_t>                  QueueEntry;
+    typedef std::priority_queue<QueueEntry,
+                                std::vector<QueueEntry>,
+                                std::greater<QueueEntry>> CostQueue;
+
+    /**
+     * Calculate the length (or travel time, depending on 'weight') of the shortest
+     * route from the source to all nodes (or from all nodes to the source, if the
+     * incoming edges are passed).
+     */
+    void Dijkstra(const RouteLandmarkGenerator::EdgeList& edges,
+                  double RouteLandmarkGenerator::Edge::* weight,
+                  uint32_t source,
+                  std::vector<double>& lengths)
+    {
+      CostQueue queue;
+
+      lengths.assign(edges.size(),
+                     std::numeric_limits<double>::infinity());
+
+      lengths[source]=0.0;
+      queue.push(QueueEntry(0.0,source));
+
+      while (!queue.empty()) {
+        QueueEntry current=queue.top();
+
+        queue.pop();
+
+        if (current.first>lengths[current.second]) {
+          continue;
+        }
+
+        for (const auto& edge : edges[current.second]) {
+          double length=current.first+edge.*weight;
+
+          if (length<lengths[edge.node]) {
+            lengths[edge.node]=length;
+            queue.push(QueueEntry(length,edge.node));
+          }
+        }
+      }
+    }
+
+    /**
+     * Return the representative of the set the node belongs to, compressing the path
+     */
+    uint32_t FindSet(std::vector<uint32_t>& parents,
+                     uint32_t node)
+    {
+      while (parents[node]!=node) {
+        parents[node]=parents[parents[node]];
+        node=parents[node];
+      }
+
+      return node;
+    }
+
+    /**
+     * Mark all nodes of the largest (weakly) connected part of the graph, landmarks
+     * are only selected from these nodes
+     */
+    void MarkLargestComponent(const RouteLandmarkGenerator::Graph& graph,
+                              std::vector<bool>& candidates)
+    {
+      std::vector<uint32_t> parents(graph.nodeIds.size());
+      std::vector<uint32_t> sizes(graph.nodeIds.size(),0);
+
+      for (uint32_t node=0; node<parents.size(); node++) {
+        parents[node]=node;
+      }
+
+      for (uint32_t node=0; node<parents.size(); node++) {
+        for (const auto& edge : graph.outEdges[node]) {
+          uint32_t a=FindSet(parents,node);
+          uint32_t b=FindSet(parents,edge.node);
+
+          if (a!=b) {
+            parents[b]=a;
+          }
+        }
+      }
+
+      uint32_t largest=0;
+
+      for (uint32_t node=0; node<parents.size(); node++) {
+        uint32_t set=FindSet(parents,node);
+
+        sizes[set]++;
+
+        if (sizes[set]>sizes[largest]) {
+          largest=set;
+        }
+      }
+
+      candidates.resize(parents.size());
+
+      for (uint32_t node=0; node<parents.size(); node++) {
+        candidates[node]=FindSet(parents,node)==largest;
+      }
+    }
+
+    /**
+     * Convert the value to the table unit, rounding down so that the bounds stay valid
+     */
+    uint32_t ToTableValue(double value)
+    {
+      if (std::isinf(value) ||
+          value>=(double)(LandmarkTable::UNREACHABLE-1)) {
+        return LandmarkTable::UNREACHABLE;
+      }
+
+      return (uint32_t)std::floor(value);
+    }
+  }
+
+  void RouteLandmarkGenerator::GetDescription(const ImportParameter& parameter,
+                                              ImportModuleDescription& description) const
+  {
+    description.SetName("RouteLandmarkGenerator");
+    description.SetDescription("Generate landmark distances for routing");
+
+    for (const auto& router : parameter.GetRouter()) {
+      description.AddRequiredFile(router.GetDataFilename());
+      description.AddRequiredFile(router.GetVariantFilename());
+
+      for (Vehicle vehicle : {vehicleFoot, vehicleBicycle, vehicleCar}) {
+        if ((router.GetVehicleMask() & vehicle)!=0) {
+          description.AddProvidedOptionalFile(RoutingService::GetLandmarkFilename(router.GetFilenamebase(),
+                                                                                  vehicle));
+        }
+      }
+    }
+  }
+
+  /**
+   * Load all route nodes of the router and build the routing graph for the
+   * vehicle of the profile. All paths usable by the vehicle are part of the graph,
+   * including restricted ones, since the distances must be a lower bound for
+   * every profile. Travel times are only calculated for paths usable by the profile.
+   */
+  bool RouteLandmarkGenerator::LoadGraph(const TypeConfig& typeConfig,
+                                         const ImportParameter& parameter,
+                                         Progress& progress,
+                                         const ImportParameter::Router& router,
+                                         const FastestPathRoutingProfile& profile,
+                                         Graph& graph)
+  {
+    ObjectVariantDataFile variantDataFile;
+
+    if (!variantDataFile.Load(typeConfig,
+                              AppendFileToDir(parameter.GetDestinationDirectory(),
+                                              router.GetVariantFilename()))) {
+      progress.Error("Cannot load '"+router.GetVariantFilename()+"'");
+      return false;
+    }
+
+    FileScanner scanner;
+    uint8_t     usableFlag=VehicleToPathFlag(profile.GetVehicle());
+
+    graph.nodeIds.clear();
+    graph.outEdges.clear();
+    graph.inEdges.clear();
+
+    try {
+      FileOffset indexFileOffset;
+      uint32_t   dataCount;
+      uint32_t   tileMag;
+      FileOffset dataOffset;
+
+      scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
+                                   router.GetDataFilename()),
+                   FileScanner::Sequential,
+                   true,
+                   parameter.GetScanMMapPolicy());
+
+      scanner.Read(indexFileOffset);
+      scanner.Read(dataCount);
+      scanner.Read(tileMag);
+
+      dataOffset=scanner.GetPos();
+
+      // First pass: collect and sort the node ids
+
+      graph.nodeIds.reserve(dataCount);
+
+      for (uint32_t current=1; current<=dataCount; current++) {
+        RouteNode node;
+
+        progress.SetProgress(current,2*dataCount);
+
+        node.Read(scanner);
+
+        graph.nodeIds.push_back(node.GetId());
+      }
+
+      std::sort(graph.nodeIds.begin(),
+                graph.nodeIds.end());
+
+      graph.outEdges.resize(graph.nodeIds.size());
+      graph.inEdges.resize(graph.nodeIds.size());
+
+      // Second pass: build the edges
+
+      scanner.SetPos(dataOffset);
+
+      for (uint32_t current=1; current<=dataCount; current++) {
+        RouteNode node;
+
+        progress.SetProgress(dataCount+current,2*dataCount);
+
+        node.Read(scanner);
+
+        uint32_t from=(uint32_t)(std::lower_bound(graph.nodeIds.begin(),
+                                                  graph.nodeIds.end(),
+                                                  node.GetId())-graph.nodeIds.begin());
+
+        for (size_t i=0; i<node.paths.size(); i++) {
+          const RouteNode::Path& path=node.paths[i];
+
+          if ((path.flags & usableFlag)==0) {
+            continue;
+          }
+
+          auto target=std::lower_bound(graph.nodeIds.begin(),
+                                       graph.nodeIds.end(),
+                                       path.id);
+
+          if (target==graph.nodeIds.end() ||
+              *target!=path.id) {
+            continue;
+          }
+
+          uint32_t to=(uint32_t)(target-graph.nodeIds.begin());
+
+          if (to==from) {
+            continue;
+          }
+
+          double length=path.distance.AsMeter();
+          double time=std::numeric_limits<double>::infinity();
+
+          if (profile.CanUse(node,
+                             variantDataFile.GetData(),
+                             i)) {
+            time=profile.GetCosts(node,
+                                  variantDataFile.GetData(),
+                                  i);
+          }
+
+          graph.outEdges[from].push_back(Edge{to,length,time});
+          graph.inEdges[to].push_back(Edge{from,length,time});
+        }
+      }
+
+      scanner.Close();
+    }
+    catch (IOException& e) {
+      progress.Error(e.GetDescription());
+      scanner.CloseFailsafe();
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Select the landmarks and calculate the distances from and to each of them.
+   *
+   * Afterwards values contain for each node and landmark the distance from
+   * the landmark to the node and from the node to the landmark in meters,
+   * followed by the travel times in LandmarkTable::TIME_UNITS_PER_HOUR (rounded
+   * down, LandmarkTable::UNREACHABLE if not connected).
+   */
+  void RouteLandmarkGenerator::CalculateDistances(Progress& progress,
+                                                  const Graph& graph,
+                                                  size_t landmarkCount,
+                                                  std::vector<uint32_t>& landmarks,
+                                                  std::vector<uint32_t>& values)
+  {
+    size_t              nodeCount=graph.nodeIds.size();
+    std::vector<bool>   candidates;
+    std::vector<double> separation(nodeCount,
+                                   std::numeric_limits<double>::infinity());
+    std::vector<double> fromLengths;
+    std::vector<double> toLengths;
+    std::vector<double> fromTimes;
+    std::vector<double> toTimes;
+
+    landmarks.clear();
+    values.clear();
+
+    if (nodeCount==0) {
+      return;
+    }
+
+    MarkLargestComponent(graph,
+                         candidates);
+
+    // The first landmark is the node farthest away from some node of the largest component
+    uint32_t start=(uint32_t)(std::find(candidates.begin(),
+                                        candidates.end(),
+                                        true)-candidates.begin());
+
+    Dijkstra(graph.outEdges,
+             &Edge::length,
+             start,
+             fromLengths);
+
+    uint32_t next=start;
+
+    for (uint32_t node=0; node<nodeCount; node++) {
+      if (candidates[node] &&
+          !std::isinf(fromLengths[node]) &&
+          fromLengths[node]>fromLengths[next]) {
+        next=node;
+      }
+    }
+
+    std::vector<std::vector<uint32_t>> landmarkValues;
+
+    while (landmarks.size()<landmarkCount) {
+      progress.SetProgress(landmarks.size(),landmarkCount);
+
+      landmarks.push_back(next);
+
+      Dijkstra(graph.outEdges,
+               &Edge::length,
+               next,
+               fromLengths);
+      Dijkstra(graph.inEdges,
+               &Edge::length,
+               next,
+               toLengths);
+      Dijkstra(graph.outEdges,
+               &Edge::time,
+               next,
+               fromTimes);
+      Dijkstra(graph.inEdges,
+               &Edge::time,
+               next,
+               toTimes);
+
+      landmarkValues.emplace_back(4*nodeCount);
+
+      std::vector<uint32_t>& current=landmarkValues.back();
+
+      for (size_t node=0; node<nodeCount; node++) {
+        current[4*node]=ToTableValue(fromLengths[node]);
+        current[4*node+1]=ToTableValue(toLengths[node]);
+        current[4*node+2]=ToTableValue(fromTimes[node]*LandmarkTable::TIME_UNITS_PER_HOUR);
+        current[4*node+3]=ToTableValue(toTimes[node]*LandmarkTable::TIME_UNITS_PER_HOUR);
+
+        separation[node]=std::min(separation[node],
+                                  std::min(fromLengths[node],
+                                           toLengths[node]));
+      }
+
+      // The next landmark is the candidate farthest away from all landmarks so far,
+      // nodes not connected with any of them are preferred
+      double maxSeparation=0.0;
+
+      for (uint32_t node=0; node<nodeCount; node++) {
+        if (candidates[node] &&
+            separation[node]>maxSeparation) {
+          maxSeparation=separation[node];
+          next=node;
+        }
+      }
+
+      if (maxSeparation==0.0) {
+        break;
+      }
+    }
+
+    // Store node major, so that all values for a node are next to each other
+    values.resize(nodeCount*landmarks.size()*4);
+
+    for (size_t node=0; node<nodeCount; node++) {
+      for (size_t l=0; l<landmarks.size(); l++) {
+        std::copy(landmarkValues[l].begin()+4*node,
+                  landmarkValues[l].begin()+4*node+4,
+                  values.begin()+(node*landmarks.size()+l)*4);
+      }
+    }
+  }
+
+  /**
+   * Write the table in the format expected by LandmarkTable::Load()
+   */
+  bool RouteLandmarkGenerator::WriteTable(const TypeConfig& typeConfig,
+                                          Progress& progress,
+                                          const std::string& filename,
+                                          const FastestPathRoutingProfile& profile,
+                                          const Graph& graph,
+                                          const std::vector<uint32_t>& landmarks,
+                                          const std::vector<uint32_t>& values)
+  {
+    FileWriter writer;
+
+    try {
+      Id lastId=0;
+
+      writer.Open(filename);
+
+      writer.Write((uint32_t)graph.nodeIds.size());
+
+      for (Id id : graph.nodeIds) {
+        writer.WriteNumber(id-lastId);
+        lastId=id;
+      }
+
+      writer.Write((uint32_t)landmarks.size());
+
+      for (uint32_t landmark : landmarks) {
+        writer.WriteNumber(landmark);
+      }
+
+      std::vector<TypeInfoRef> speedTypes;
+
+      for (const auto& type : typeConfig.GetTypes()) {
+        if (profile.GetTypeSpeed(type->GetIndex())>0.0) {
+          speedTypes.push_back(type);
+        }
+      }
+
+      WriteDouble(writer,
+                  profile.GetVehicleMaxSpeed());
+
+      writer.Write((uint32_t)speedTypes.size());
+
+      for (const auto& type : speedTypes) {
+        writer.Write(type->GetName());
+        WriteDouble(writer,
+                    profile.GetTypeSpeed(type->GetIndex()));
+      }
+
+      for (uint32_t value : values) {
+        writer.WriteNumber(value==LandmarkTable::UNREACHABLE ? (uint32_t)0 : value+1);
+      }
+
+      writer.Close();
+    }
+    catch (IOException& e) {
+      progress.Error(e.GetDescription());
+      writer.CloseFailsafe();
+      return false;
+    }
+
+    return true;
+  }
+
+  bool RouteLandmarkGenerator::Import(const TypeConfigRef& typeConfig,
+                                      const ImportParameter& parameter,
+                                      Progress& progress)
+  {
+    if (parameter.GetRouterLandmarks()==0) {
+      progress.Info("Generation of landmark distances is disabled");
+
+      return true;
+    }
+
+    for (const auto& router : parameter.GetRouter()) {
+      for (Vehicle vehicle : {vehicleFoot, vehicleBicycle, vehicleCar}) {
+        if ((router.GetVehicleMask() & vehicle)==0) {
+          continue;
+        }
+
+        FastestPathRoutingProfile profile(typeConfig);
+        Graph                     graph;
+        std::vector<uint32_t>     landmarks;
+        std::vector<uint32_t>     values;
+        std::string               filename=RoutingService::GetLandmarkFilename(router.GetFilenamebase(),
+                                                                               vehicle);
+
+        if (!RouteCHGenerator::ParametrizeProfile(*typeConfig,
+                                                  parameter,
+                                                  vehicle,
+                                                  profile)) {
+          progress.Warning("No car speed table set, skipping landmarks for car");
+          continue;
+        }
+
+        progress.SetAction("Loading routing graph of '"+router.GetDataFilename()+"' for "+VehicleToString(vehicle));
+
+        if (!LoadGraph(*typeConfig,
+                       parameter,
+                       progress,
+                       router,
+                       profile,
+                       graph)) {
+          return false;
+        }
+
+        progress.SetAction("Calculating landmark distances");
+
+        CalculateDistances(progress,
+                           graph,
+                           parameter.GetRouterLandmarks(),
+                           landmarks,
+                           values);
+
+        progress.Info(std::to_string(graph.nodeIds.size())+" nodes, "+
+                      std::to_string(landmarks.size())+" landmarks");
+
+        progress.SetAction("Writing '"+filename+"'");
+
+        if (!WriteTable(*typeConfig,
+                        progress,
+                        AppendFileToDir(parameter.GetDestinationDirectory(),
+                                        filename),
+                        profile,
+                        graph,
+                        landmarks,
+                        values)) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+}
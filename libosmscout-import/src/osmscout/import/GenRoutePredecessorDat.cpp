@@ -0,0 +1,202 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/import/GenRoutePredecessorDat.h>
+
+#include <algorithm>
+
+#include <osmscout/routing/RouteNode.h>
+#include <osmscout/routing/RoutingService.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+
+namespace osmscout {
+
+  void RoutePredecessorGenerator::GetDescription(const ImportParameter& parameter,
+                                                 ImportModuleDescription& description) const
+  {
+    description.SetName("RoutePredecessorGenerator");
+    description.SetDescription("Generate predecessors of the route nodes");
+
+    for (const auto& router : parameter.GetRouter()) {
+      description.AddRequiredFile(router.GetDataFilename());
+      description.AddProvidedOptionalFile(RoutingService::GetPredecessorFilename(router.GetFilenamebase()));
+    }
+  }
+
+  /**
+   * Load all paths of all route nodes of the router and sort them by the route
+   * node they lead to
+   */
+  bool RoutePredecessorGenerator::LoadEntries(const ImportParameter& parameter,
+                                              Progress& progress,
+                                              const ImportParameter::Router& router,
+                                              std::vector<Entry>& entries)
+  {
+    FileScanner scanner;
+
+    entries.clear();
+
+    try {
+      FileOffset indexFileOffset;
+      uint32_t   dataCount;
+      uint32_t   tileMag;
+
+      scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
+                                   router.GetDataFilename()),
+                   FileScanner::Sequential,
+                   true,
+                   parameter.GetScanMMapPolicy());
+
+      scanner.Read(indexFileOffset);
+      scanner.Read(dataCount);
+      scanner.Read(tileMag);
+
+      for (uint32_t current=1; current<=dataCount; current++) {
+        RouteNode node;
+
+        progress.SetProgress(current,dataCount);
+
+        node.Read(scanner);
+
+        for (size_t i=0; i<node.paths.size(); i++) {
+          Entry entry;
+
+          entry.target=node.paths[i].id;
+          entry.source=node.GetId();
+          entry.pathIndex=(uint8_t)i;
+
+          entries.push_back(entry);
+        }
+      }
+
+      scanner.Close();
+    }
+    catch (IOException& e) {
+      progress.Error(e.GetDescription());
+      scanner.CloseFailsafe();
+      return false;
+    }
+
+    std::sort(entries.begin(),
+              entries.end());
+
+    return true;
+  }
+
+  /**
+   * Write the table in the format expected by RoutePredecessorTable::Load()
+   */
+  bool RoutePredecessorGenerator::WriteTable(Progress& progress,
+                                             const std::string& filename,
+                                             const std::vector<Entry>& entries)
+  {
+    FileWriter writer;
+
+    try {
+      uint32_t nodeCount=0;
+
+      for (size_t i=0; i<entries.size(); i++) {
+        if (i==0 ||
+            entries[i].target!=entries[i-1].target) {
+          nodeCount++;
+        }
+      }
+
+      writer.Open(filename);
+
+      writer.Write(nodeCount);
+
+      Id   lastNodeId=0;
+      auto entry=entries.begin();
+
+      while (entry!=entries.end()) {
+        auto end=entry;
+
+        while (end!=entries.end() &&
+               end->target==entry->target) {
+          ++end;
+        }
+
+        writer.WriteNumber(entry->target-lastNodeId);
+        writer.WriteNumber((uint32_t)(end-entry));
+
+        lastNodeId=entry->target;
+
+        Id lastSourceId=0;
+
+        for (; entry!=end; ++entry) {
+          writer.WriteNumber(entry->source-lastSourceId);
+          writer.Write(entry->pathIndex);
+
+          lastSourceId=entry->source;
+        }
+      }
+
+      writer.Close();
+    }
+    catch (IOException& e) {
+      progress.Error(e.GetDescription());
+      writer.CloseFailsafe();
+      return false;
+    }
+
+    return true;
+  }
+
+  bool RoutePredecessorGenerator::Import(const TypeConfigRef& /*typeConfig*/,
+                                         const ImportParameter& parameter,
+                                         Progress& progress)
+  {
+    if (!parameter.GetRouterPredecessors()) {
+      progress.Info("Generation of the route node predecessors is disabled");
+
+      return true;
+    }
+
+    for (const auto& router : parameter.GetRouter()) {
+      std::vector<Entry> entries;
+      std::string        filename=RoutingService::GetPredecessorFilename(router.GetFilenamebase());
+
+      progress.SetAction("Loading paths of '"+router.GetDataFilename()+"'");
+
+      if (!LoadEntries(parameter,
+                       progress,
+                       router,
+                       entries)) {
+        return false;
+      }
+
+      progress.Info(std::to_string(entries.size())+" paths");
+
+      progress.SetAction("Writing '"+filename+"'");
+
+      if (!WriteTable(progress,
+                      AppendFileToDir(parameter.GetDestinationDirectory(),
+                                      filename),
+                      entries)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+}
@@ -0,0 +1,458 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/import/GenRouteSegmentIndex.h>
+
+#include <algorithm>
+#include <utility>
+
+#include <osmscout/AreaDataFile.h>
+#include <osmscout/WayDataFile.h>
+
+#include <osmscout/routing/RouteGraph.h>
+#include <osmscout/routing/RouteNode.h>
+#include <osmscout/routing/RoutingService.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+
+namespace osmscout {
+
+  const uint32_t RouteSegmentIndexGenerator::CELL_SIZE=20000;
+
+  namespace {
+
+    void WritePadding(FileWriter& writer,
+                      size_t bytes)
+    {
+      for (size_t i=bytes; i%8!=0; i++) {
+        writer.Write((uint8_t)0);
+      }
+    }
+
+    uint64_t GetCellKey(const RouteSegmentIndex::Segment& segment,
+                        double cellSize)
+    {
+      return RouteSegmentIndex::GetCellKey(RouteSegmentIndex::GetCellRow(segment.lat[0]*RouteSegmentIndex::COORD_RESOLUTION,
+                                                                         cellSize),
+                                           RouteSegmentIndex::GetCellColumn(segment.lon[0]*RouteSegmentIndex::COORD_RESOLUTION,
+                                                                            cellSize));
+    }
+  }
+
+  void RouteSegmentIndexGenerator::GetDescription(const ImportParameter& parameter,
+                                                  ImportModuleDescription& description) const
+  {
+    description.SetName("RouteSegmentIndexGenerator");
+    description.SetDescription("Generate spatial index of routable segments");
+
+    description.AddRequiredFile(WayDataFile::WAYS_DAT);
+    description.AddRequiredFile(AreaDataFile::AREAS_DAT);
+
+    for (const auto& router : parameter.GetRouter()) {
+      description.AddProvidedOptionalFile(RoutingService::GetSegmentIndexFilename(router.GetFilenamebase()));
+    }
+  }
+
+  /**
+   * Return the vehicles, that can use the object (in any direction), as
+   * RouteNode::Path::flags
+   */
+  uint8_t RouteSegmentIndexGenerator::GetFlags(const AccessFeatureValueReader& accessReader,
+                                               const FeatureValueBuffer& buffer) const
+  {
+    AccessFeatureValue *accessValue=accessReader.GetValue(buffer);
+    AccessFeatureValue access=accessValue!=nullptr ? *accessValue : AccessFeatureValue(buffer.GetType()->GetDefaultAccess());
+    uint8_t            flags=0;
+
+    if (access.CanRouteFoot()) {
+      flags|=RouteNode::usableByFoot;
+    }
+
+    if (access.CanRouteBicycle()) {
+      flags|=RouteNode::usableByBicycle;
+    }
+
+    if (access.CanRouteCar()) {
+      flags|=RouteNode::usableByCar;
+    }
+
+    return flags;
+  }
+
+  /**
+   * Add the segments between the nodes, for a closed ring including the segment
+   * from the last to the first node
+   */
+  void RouteSegmentIndexGenerator::AddSegments(const std::vector<Point>& nodes,
+                                               bool closed,
+                                               const ObjectFileRef& object,
+                                               TypeId type,
+                                               uint8_t flags,
+                                               std::vector<RouteSegmentIndex::Segment>& segments) const
+  {
+    size_t count=closed ? nodes.size() : nodes.size()-1;
+
+    for (size_t i=0; i<count; i++) {
+      const Point&               first=nodes[i];
+      const Point&               second=nodes[(i+1)%nodes.size()];
+      RouteSegmentIndex::Segment segment;
+
+      segment.lat[0]=RouteSegmentIndex::EncodeCoord(first.GetLat());
+      segment.lon[0]=RouteSegmentIndex::EncodeCoord(first.GetLon());
+      segment.lat[1]=RouteSegmentIndex::EncodeCoord(second.GetLat());
+      segment.lon[1]=RouteSegmentIndex::EncodeCoord(second.GetLon());
+      segment.object=RouteGraph::EncodeObject(object);
+      segment.nodeIndex=(uint32_t)i;
+      segment.type=type;
+      segment.flags=flags;
+      segment.reserved=0;
+
+      segments.push_back(segment);
+    }
+  }
+
+  /**
+   * Load the segments of all ways and simple areas, that can be used by at
+   * least one vehicle of the router. Like for the route nodes, ways and areas
+   * without any relevant node are skipped.
+   */
+  bool RouteSegmentIndexGenerator::LoadSegments(const TypeConfig& typeConfig,
+                                                const ImportParameter& parameter,
+                                                Progress& progress,
+                                                const ImportParameter::Router& router,
+                                                std::vector<RouteSegmentIndex::Segment>& segments) const
+  {
+    AccessFeatureValueReader accessReader(typeConfig);
+    uint8_t                  routerFlags=0;
+    FileScanner              scanner;
+
+    if ((router.GetVehicleMask() & vehicleFoot)!=0) {
+      routerFlags|=RouteNode::usableByFoot;
+    }
+
+    if ((router.GetVehicleMask() & vehicleBicycle)!=0) {
+      routerFlags|=RouteNode::usableByBicycle;
+    }
+
+    if ((router.GetVehicleMask() & vehicleCar)!=0) {
+      routerFlags|=RouteNode::usableByCar;
+    }
+
+    auto hasRelevantNode=[](const std::vector<Point>& nodes) {
+      return std::any_of(nodes.begin(),
+                         nodes.end(),
+                         [](const Point& node) {
+                           return node.IsRelevant();
+                         });
+    };
+
+    try {
+      uint32_t wayCount;
+
+      progress.SetAction("Scanning ways");
+
+      scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
+                                   WayDataFile::WAYS_DAT),
+                   FileScanner::Sequential,
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
+
+      scanner.Read(wayCount);
+
+      for (uint32_t w=1; w<=wayCount; w++) {
+        Way way;
+
+        progress.SetProgress(w,wayCount);
+
+        way.Read(typeConfig,
+                 scanner);
+
+        if (way.GetType()->GetIgnore() ||
+            !way.GetType()->CanRoute() ||
+            way.nodes.size()<2 ||
+            !hasRelevantNode(way.nodes)) {
+          continue;
+        }
+
+        uint8_t flags=GetFlags(accessReader,
+                               way.GetFeatureValueBuffer());
+
+        if ((flags & routerFlags)==0) {
+          continue;
+        }
+
+        AddSegments(way.nodes,
+                    false,
+                    way.GetObjectFileRef(),
+                    (TypeId)way.GetType()->GetIndex(),
+                    flags & routerFlags,
+                    segments);
+      }
+
+      scanner.Close();
+
+      uint32_t areaCount;
+
+      progress.SetAction("Scanning areas");
+
+      scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
+                                   AreaDataFile::AREAS_DAT),
+                   FileScanner::Sequential,
+                   parameter.GetAreaDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
+
+      scanner.Read(areaCount);
+
+      for (uint32_t a=1; a<=areaCount; a++) {
+        Area area;
+
+        progress.SetProgress(a,areaCount);
+
+        area.Read(typeConfig,
+                  scanner);
+
+        // The router only uses simple areas, see RoutingProfile::CanUse(const Area&)
+        if (area.rings.size()!=1) {
+          continue;
+        }
+
+        const Area::Ring& ring=area.rings.front();
+
+        if (ring.GetType()->GetIgnore() ||
+            !ring.GetType()->CanRoute() ||
+            ring.nodes.size()<3 ||
+            !hasRelevantNode(ring.nodes)) {
+          continue;
+        }
+
+        uint8_t flags=GetFlags(accessReader,
+                               ring.GetFeatureValueBuffer());
+
+        if ((flags & routerFlags)==0) {
+          continue;
+        }
+
+        AddSegments(ring.nodes,
+                    true,
+                    area.GetObjectFileRef(),
+                    (TypeId)ring.GetType()->GetIndex(),
+                    flags & routerFlags,
+                    segments);
+      }
+
+      scanner.Close();
+    }
+    catch (IOException& e) {
+      progress.Error(e.GetDescription());
+      scanner.CloseFailsafe();
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Order the segments by the cell of their first node (so segments close to each
+   * other are stored close to each other) and assign them to all cells they
+   * cross
+   */
+  void RouteSegmentIndexGenerator::BuildIndex(Progress& progress,
+                                              std::vector<RouteSegmentIndex::Segment>& segments,
+                                              Index& index) const
+  {
+    double cellSize=CELL_SIZE*RouteSegmentIndex::COORD_RESOLUTION;
+
+    progress.SetAction("Sorting segments");
+
+    std::stable_sort(segments.begin(),
+                     segments.end(),
+                     [cellSize](const RouteSegmentIndex::Segment& a,
+                                const RouteSegmentIndex::Segment& b) {
+                       return GetCellKey(a,cellSize)<GetCellKey(b,cellSize);
+                     });
+
+    progress.SetAction("Assigning segments to cells");
+
+    std::vector<std::pair<uint64_t,uint32_t>> cellEntries;
+
+    for (size_t s=0; s<segments.size(); s++) {
+      const RouteSegmentIndex::Segment& segment=segments[s];
+      size_t                            first=segment.lon[0]<=segment.lon[1] ? 0 : 1;
+      size_t                            second=1-first;
+      double                            firstLat=segment.lat[first]*RouteSegmentIndex::COORD_RESOLUTION;
+      double                            firstLon=segment.lon[first]*RouteSegmentIndex::COORD_RESOLUTION;
+      double                            secondLat=segment.lat[second]*RouteSegmentIndex::COORD_RESOLUTION;
+      double                            secondLon=segment.lon[second]*RouteSegmentIndex::COORD_RESOLUTION;
+      int64_t                           firstColumn=RouteSegmentIndex::GetCellColumn(firstLon,cellSize);
+      int64_t                           lastColumn=RouteSegmentIndex::GetCellColumn(secondLon,cellSize);
+
+      progress.SetProgress(s,segments.size());
+
+      // For each column the segment crosses, add all rows between the latitudes at the column borders
+      for (int64_t column=firstColumn; column<=lastColumn; column++) {
+        double startLat=firstLat;
+        double endLat=secondLat;
+
+        if (secondLon>firstLon) {
+          double startLon=std::max(firstLon,column*cellSize-180.0);
+          double endLon=std::min(secondLon,(column+1)*cellSize-180.0);
+
+          startLat=firstLat+(secondLat-firstLat)*(startLon-firstLon)/(secondLon-firstLon);
+          endLat=firstLat+(secondLat-firstLat)*(endLon-firstLon)/(secondLon-firstLon);
+        }
+
+        int64_t firstRow=RouteSegmentIndex::GetCellRow(std::min(startLat,endLat),cellSize);
+        int64_t lastRow=RouteSegmentIndex::GetCellRow(std::max(startLat,endLat),cellSize);
+
+        for (int64_t row=firstRow; row<=lastRow; row++) {
+          cellEntries.emplace_back(RouteSegmentIndex::GetCellKey(row,column),
+                                   (uint32_t)s);
+        }
+      }
+    }
+
+    std::sort(cellEntries.begin(),
+              cellEntries.end());
+
+    index.cellKeys.clear();
+    index.entryOffsets.clear();
+    index.entries.clear();
+
+    index.entries.reserve(cellEntries.size());
+
+    for (const auto& entry : cellEntries) {
+      if (index.cellKeys.empty() ||
+          index.cellKeys.back()!=entry.first) {
+        index.cellKeys.push_back(entry.first);
+        index.entryOffsets.push_back((uint32_t)index.entries.size());
+      }
+
+      index.entries.push_back(entry.second);
+    }
+
+    index.entryOffsets.push_back((uint32_t)index.entries.size());
+    index.segments.swap(segments);
+  }
+
+  /**
+   * Write the index in the format expected by RouteSegmentIndex::Open()
+   */
+  bool RouteSegmentIndexGenerator::WriteIndex(Progress& progress,
+                                              const std::string& filename,
+                                              const Index& index) const
+  {
+    FileWriter writer;
+
+    try {
+      writer.Open(filename);
+
+      writer.Write((uint32_t)index.segments.size());
+      writer.Write((uint32_t)index.cellKeys.size());
+      writer.Write((uint32_t)index.entries.size());
+      writer.Write(CELL_SIZE);
+
+      for (const auto& segment : index.segments) {
+        writer.Write(segment.lat[0]);
+        writer.Write(segment.lat[1]);
+        writer.Write(segment.lon[0]);
+        writer.Write(segment.lon[1]);
+        writer.Write(segment.object);
+        writer.Write(segment.nodeIndex);
+        writer.Write(segment.type);
+        writer.Write(segment.flags);
+        writer.Write(segment.reserved);
+      }
+
+      for (uint64_t key : index.cellKeys) {
+        writer.Write(key);
+      }
+
+      for (uint32_t offset : index.entryOffsets) {
+        writer.Write(offset);
+      }
+
+      WritePadding(writer,
+                   index.entryOffsets.size()*sizeof(uint32_t));
+
+      for (uint32_t entry : index.entries) {
+        writer.Write(entry);
+      }
+
+      WritePadding(writer,
+                   index.entries.size()*sizeof(uint32_t));
+
+      writer.Close();
+    }
+    catch (IOException& e) {
+      progress.Error(e.GetDescription());
+      writer.CloseFailsafe();
+      return false;
+    }
+
+    return true;
+  }
+
+  bool RouteSegmentIndexGenerator::Import(const TypeConfigRef& typeConfig,
+                                          const ImportParameter& parameter,
+                                          Progress& progress)
+  {
+    if (!parameter.GetRouterSegmentIndex()) {
+      progress.Info("Generation of the segment index is disabled");
+
+      return true;
+    }
+
+    for (const auto& router : parameter.GetRouter()) {
+      std::vector<RouteSegmentIndex::Segment> segments;
+      Index                                   index;
+      std::string                             filename=RoutingService::GetSegmentIndexFilename(router.GetFilenamebase());
+
+      progress.SetAction("Loading segments for '"+filename+"'");
+
+      if (!LoadSegments(*typeConfig,
+                        parameter,
+                        progress,
+                        router,
+                        segments)) {
+        return false;
+      }
+
+      BuildIndex(progress,
+                 segments,
+                 index);
+
+      progress.Info(std::to_string(index.segments.size())+" segments, "+
+                    std::to_string(index.cellKeys.size())+" cells, "+
+                    std::to_string(index.entries.size())+" cell entries");
+
+      progress.SetAction("Writing '"+filename+"'");
+
+      if (!WriteIndex(progress,
+                      AppendFileToDir(parameter.GetDestinationDirectory(),
+                                      filename),
+                      index)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+}
@@ -96,7 +96,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    rawFile),
                    FileScanner::Sequential,
-                   true);
+                   true,
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(coastlineCount);
 
@@ -234,7 +235,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    WayDataFile::WAYS_DAT),
                    FileScanner::Sequential,
-                   parameter.GetWayDataMemoryMaped());
+                   parameter.GetWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(wayCount);
 
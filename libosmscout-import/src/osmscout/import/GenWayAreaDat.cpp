@@ -66,7 +66,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    RelAreaDataGenerator::WAYAREABLACK_DAT),
                    FileScanner::Sequential,
-                   true);
+                   true,
+                   parameter.GetScanMMapPolicy());
 
       while (!scanner.IsEOF()) {
         OSMId id;
@@ -279,7 +280,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    Preprocess::RAWWAYS_DAT),
                    FileScanner::Sequential,
-                   parameter.GetRawWayDataMemoryMaped());
+                   parameter.GetRawWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(rawWayCount);
 
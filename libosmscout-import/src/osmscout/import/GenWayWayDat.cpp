@@ -70,7 +70,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    Preprocess::RAWTURNRESTR_DAT),
                    FileScanner::Sequential,
-                   true);
+                   true,
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(restrictionCount);
 
@@ -744,7 +745,8 @@ namespace osmscout {
       scanner.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
                                    Preprocess::RAWWAYS_DAT),
                    FileScanner::Sequential,
-                   parameter.GetRawWayDataMemoryMaped());
+                   parameter.GetRawWayDataMemoryMaped(),
+                   parameter.GetScanMMapPolicy());
 
       scanner.Read(rawWayCount);
 
@@ -70,8 +70,15 @@
 
 // Routing
 #include <osmscout/import/GenRouteDat.h>
+#include <osmscout/import/GenRouteCHDat.h>
+#include <osmscout/import/GenRouteLandmarkDat.h>
+#include <osmscout/import/GenRouteGraphDat.h>
+#include <osmscout/import/GenRoutePredecessorDat.h>
+#include <osmscout/import/GenRouteSegmentIndex.h>
 #include <osmscout/import/GenIntersectionIndex.h>
 
+#include <osmscout/import/GenCompressedDat.h>
+
 #if defined(OSMSCOUT_IMPORT_HAVE_LIB_MARISA)
 #include <osmscout/import/GenTextIndex.h>
 #endif
@@ -84,9 +91,9 @@ namespace osmscout {
 
   static const size_t defaultStartStep=1;
 #if defined(OSMSCOUT_IMPORT_HAVE_LIB_MARISA)
-  static const size_t defaultEndStep=25;
+  static const size_t defaultEndStep=31;
 #else
-  static const size_t defaultEndStep=24;
+  static const size_t defaultEndStep=30;
 #endif
 
   PreprocessorFactory::~PreprocessorFactory()
@@ -107,6 +114,14 @@ namespace osmscout {
      startStep(defaultStartStep),
      endStep(defaultEndStep),
      eco(false),
+     routerCH(false),
+     routerFootMaxSpeed(5.0),
+     routerBicycleMaxSpeed(20.0),
+     routerCarMaxSpeed(160.0),
+     routerLandmarks(0),
+     routerGraph(false),
+     routerPredecessors(false),
+     routerSegmentIndex(false),
      strictAreas(false),
      sortObjects(true),
      sortBlockSize(40000000),
@@ -126,6 +141,9 @@ namespace osmscout {
      areaDataCacheSize(0),
      wayDataMemoryMaped(false),
      wayDataCacheSize(0),
+     compressData(false),
+     compressedBlockSize(DEFAULT_COMPRESSED_BLOCK_SIZE),
+     scanMMapPolicy(MmapPolicy().SetAdvice(MmapPolicy::AdviceSequential)),
      areaAreaIndexMaxMag(17),
      areaNodeMinMag(8),
      areaNodeIndexMinFillRate(0.1),
@@ -202,6 +220,59 @@ namespace osmscout {
     return router;
   }
 
+  bool ImportParameter::GetRouterCH() const
+  {
+    return routerCH;
+  }
+
+  /**
+   * Speed (km/h) by type name used for the car profile of routing data that depends
+   * on the costs of the routing graph (contraction hierarchies, landmarks). If no
+   * speed table is set, no such data is generated for cars.
+   */
+  const std::map<std::string,double>& ImportParameter::GetRouterCarSpeedTable() const
+  {
+    return routerCarSpeedTable;
+  }
+
+  /**
+   * Maximum speed (km/h) of the given vehicle used for the profiles of routing data
+   * that depends on the costs of the routing graph
+   */
+  double ImportParameter::GetRouterMaxSpeed(Vehicle vehicle) const
+  {
+    switch (vehicle) {
+    case vehicleFoot:
+      return routerFootMaxSpeed;
+    case vehicleBicycle:
+      return routerBicycleMaxSpeed;
+    case vehicleCar:
+      return routerCarMaxSpeed;
+    }
+
+    return 0.0;
+  }
+
+  size_t ImportParameter::GetRouterLandmarks() const
+  {
+    return routerLandmarks;
+  }
+
+  bool ImportParameter::GetRouterGraph() const
+  {
+    return routerGraph;
+  }
+
+  bool ImportParameter::GetRouterPredecessors() const
+  {
+    return routerPredecessors;
+  }
+
+  bool ImportParameter::GetRouterSegmentIndex() const
+  {
+    return routerSegmentIndex;
+  }
+
   bool ImportParameter::GetStrictAreas() const
   {
     return strictAreas;
@@ -297,6 +368,25 @@ namespace osmscout {
     return wayDataMemoryMaped;
   }
 
+  bool ImportParameter::GetCompressData() const
+  {
+    return compressData;
+  }
+
+  size_t ImportParameter::GetCompressedBlockSize() const
+  {
+    return compressedBlockSize;
+  }
+
+  /**
+   * Policy for memory mapping of files, that are read sequentially
+   * by the import steps.
+   */
+  const MmapPolicy& ImportParameter::GetScanMMapPolicy() const
+  {
+    return scanMMapPolicy;
+  }
+
   size_t ImportParameter::GetAreaNodeMinMag() const
   {
     return areaNodeMinMag;
@@ -459,6 +549,52 @@ namespace osmscout {
     this->router.push_back(router);
   }
 
+  void ImportParameter::SetRouterCH(bool routerCH)
+  {
+    this->routerCH=routerCH;
+  }
+
+  void ImportParameter::SetRouterCarSpeedTable(const std::map<std::string,double>& routerCarSpeedTable)
+  {
+    this->routerCarSpeedTable=routerCarSpeedTable;
+  }
+
+  void ImportParameter::SetRouterMaxSpeed(Vehicle vehicle,
+                                          double maxSpeed)
+  {
+    switch (vehicle) {
+    case vehicleFoot:
+      routerFootMaxSpeed=maxSpeed;
+      break;
+    case vehicleBicycle:
+      routerBicycleMaxSpeed=maxSpeed;
+      break;
+    case vehicleCar:
+      routerCarMaxSpeed=maxSpeed;
+      break;
+    }
+  }
+
+  void ImportParameter::SetRouterLandmarks(size_t routerLandmarks)
+  {
+    this->routerLandmarks=routerLandmarks;
+  }
+
+  void ImportParameter::SetRouterGraph(bool routerGraph)
+  {
+    this->routerGraph=routerGraph;
+  }
+
+  void ImportParameter::SetRouterPredecessors(bool routerPredecessors)
+  {
+    this->routerPredecessors=routerPredecessors;
+  }
+
+  void ImportParameter::SetRouterSegmentIndex(bool routerSegmentIndex)
+  {
+    this->routerSegmentIndex=routerSegmentIndex;
+  }
+
   void ImportParameter::SetStrictAreas(bool strictAreas)
   {
     this->strictAreas=strictAreas;
@@ -554,6 +690,21 @@ namespace osmscout {
     this->wayDataCacheSize=wayDataCacheSize;
   }
 
+  void ImportParameter::SetCompressData(bool compressData)
+  {
+    this->compressData=compressData;
+  }
+
+  void ImportParameter::SetCompressedBlockSize(size_t compressedBlockSize)
+  {
+    this->compressedBlockSize=compressedBlockSize;
+  }
+
+  void ImportParameter::SetScanMMapPolicy(const MmapPolicy& scanMMapPolicy)
+  {
+    this->scanMMapPolicy=scanMMapPolicy;
+  }
+
   void ImportParameter::SetAreaAreaIndexMaxMag(size_t areaAreaIndexMaxMag)
   {
     this->areaAreaIndexMaxMag=areaAreaIndexMaxMag;
@@ -882,6 +1033,24 @@ namespace osmscout {
     /* 25 */
     modules.push_back(std::make_shared<TextIndexGenerator>());
 #endif
+
+    /* 26 (25 without marisa) */
+    modules.push_back(std::make_shared<CompressedDataGenerator>());
+
+    /* 27 (26 without marisa) */
+    modules.push_back(std::make_shared<RouteCHGenerator>());
+
+    /* 28 (27 without marisa) */
+    modules.push_back(std::make_shared<RouteLandmarkGenerator>());
+
+    /* 29 (28 without marisa) */
+    modules.push_back(std::make_shared<RouteGraphGenerator>());
+
+    /* 30 (29 without marisa) */
+    modules.push_back(std::make_shared<RouteSegmentIndexGenerator>());
+
+    /* 31 (30 without marisa) */
+    modules.push_back(std::make_shared<RoutePredecessorGenerator>());
   }
 
   void Importer::DumpTypeConfigData(const TypeConfig& typeConfig,
@@ -23,10 +23,10 @@ namespace osmscout {
 
   RawRelationIndexedDataFile::RawRelationIndexedDataFile(size_t indexCacheSize,
                                                          size_t dataCacheSize)
-  : IndexedDataFile<OSMId,RawRelation>("rawrels.dat",
-                                       "rawrel.idx",
-                                       indexCacheSize,
-                                       dataCacheSize)
+  : IndexedDataFile<OSMId,RawRelation,EytzingerIndex<OSMId>>("rawrels.dat",
+                                                             "rawrel.idx",
+                                                             indexCacheSize,
+                                                             dataCacheSize)
   {
     // no code
   }
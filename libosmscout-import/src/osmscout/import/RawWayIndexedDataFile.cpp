@@ -23,10 +23,10 @@ namespace osmscout {
 
   RawWayIndexedDataFile::RawWayIndexedDataFile(size_t indexCacheSize,
                                                size_t dataCacheSize)
-  : IndexedDataFile<OSMId,RawWay>("rawways.dat",
-                                  "rawway.idx",
-                                  indexCacheSize,
-                                  dataCacheSize)
+  : IndexedDataFile<OSMId,RawWay,EytzingerIndex<OSMId>>("rawways.dat",
+                                                        "rawway.idx",
+                                                        indexCacheSize,
+                                                        dataCacheSize)
   {
     // no code
   }
@@ -0,0 +1,88 @@
+#ifndef OSMSCOUT_MAP_MAPPAINTERMVT_H
+#define OSMSCOUT_MAP_MAPPAINTERMVT_H
+
+/*
+  This source is part of the libosmscout-map-mvt library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <cstdint>
+#include <vector>
+
+#include <osmscout/MapMVTImportExport.h>
+
+#include <osmscout/MapPainter.h>
+#include <osmscout/MapParameter.h>
+#include <osmscout/StyleConfig.h>
+
+#include <osmscout/util/Projection.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Renderer
+   *
+   * Writes the map data of a tile as Mapbox vector tile (MVT, version 2).
+   *
+   * Each object type becomes a layer named after the type. Only objects that
+   * have a style in the StyleConfig for the magnification of the projection
+   * are written, so the style sheet decides which types are visible at which
+   * zoom level. Geometry is clipped to the tile extent plus a buffer and
+   * quantised to the integer grid of the extent. The features of the
+   * FeatureValueBuffer are written as attributes: labels as string values,
+   * features without value as boolean "true".
+   *
+   * The protobuf encoding is done directly, there is no dependency on a
+   * protobuf library. DrawMap() does not change the painter, so one instance
+   * can be used by multiple threads concurrently.
+   */
+  class OSMSCOUT_MAP_MVT_API MapPainterMVT
+  {
+  private:
+    StyleConfigRef styleConfig;
+    uint32_t       extent;      //!< Width and height of the tile in tile coordinates
+    uint32_t       buffer;      //!< Size of the border around the tile in tile coordinates
+
+  public:
+    explicit MapPainterMVT(const StyleConfigRef& styleConfig);
+
+    void SetExtent(uint32_t extent);
+    void SetBuffer(uint32_t buffer);
+
+    inline uint32_t GetExtent() const
+    {
+      return extent;
+    }
+
+    inline uint32_t GetBuffer() const
+    {
+      return buffer;
+    }
+
+    /**
+     * Encodes the data visible in the tile of the projection and returns the
+     * protobuf encoded tile in tileData. Returns false if drawing was aborted
+     * using the breaker of the MapParameter.
+     */
+    bool DrawMap(const TileProjection& projection,
+                 const MapParameter& parameter,
+                 const MapData& data,
+                 std::vector<char>& tileData) const;
+  };
+}
+
+#endif
@@ -0,0 +1,891 @@
+/*
+  This source is part of the libosmscout-map-mvt library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/MapPainterMVT.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace osmscout {
+
+  namespace {
+
+    // Field numbers and enums of vector_tile.proto (version 2.1)
+    const uint32_t TILE_LAYERS         = 3;
+
+    const uint32_t LAYER_NAME          = 1;
+    const uint32_t LAYER_FEATURES      = 2;
+    const uint32_t LAYER_KEYS          = 3;
+    const uint32_t LAYER_VALUES        = 4;
+    const uint32_t LAYER_EXTENT        = 5;
+    const uint32_t LAYER_VERSION       = 15;
+
+    const uint32_t FEATURE_ID          = 1;
+    const uint32_t FEATURE_TAGS        = 2;
+    const uint32_t FEATURE_TYPE        = 3;
+    const uint32_t FEATURE_GEOMETRY    = 4;
+
+    const uint32_t VALUE_STRING        = 1;
+    const uint32_t VALUE_BOOL          = 7;
+
+    const uint32_t GEOM_POINT          = 1;
+    const uint32_t GEOM_LINESTRING     = 2;
+    const uint32_t GEOM_POLYGON        = 3;
+
+    const uint32_t COMMAND_MOVE_TO     = 1;
+    const uint32_t COMMAND_LINE_TO     = 2;
+    const uint32_t COMMAND_CLOSE_PATH  = 7;
+
+    const uint32_t WIRE_VARINT         = 0;
+    const uint32_t WIRE_LENGTH         = 2;
+
+    /**
+     * Point in tile coordinates
+     */
+    struct TilePoint
+    {
+      int32_t x;
+      int32_t y;
+
+      inline bool operator==(const TilePoint& other) const
+      {
+        return x==other.x && y==other.y;
+      }
+
+      inline bool operator!=(const TilePoint& other) const
+      {
+        return x!=other.x || y!=other.y;
+      }
+    };
+
+    typedef std::vector<TilePoint> TileLine;
+
+    /**
+     * A layer of the tile, collecting the encoded features and the
+     * (deduplicated) keys and values of their attributes
+     */
+    struct Layer
+    {
+      std::string                               name;
+      std::vector<char>                         features;
+      std::vector<std::string>                  keys;
+      std::unordered_map<std::string,uint32_t>  keyIndex;
+      std::vector<std::vector<char>>            values;
+      std::unordered_map<std::string,uint32_t>  valueIndex;
+    };
+
+    /**
+     * Scratch buffers reused for all objects of a tile
+     */
+    struct EncoderState
+    {
+      std::vector<std::unique_ptr<Layer>> layers;      //!< Layers by type index
+      std::vector<Vertex2D>               points;
+      std::vector<Vertex2D>               ring;
+      std::vector<Vertex2D>               clipped;
+      std::vector<TileLine>               lines;
+      std::vector<uint32_t>               tags;
+      std::vector<uint32_t>               geometry;
+      std::vector<char>                   feature;
+    };
+  }
+
+  static void WriteVarint(std::vector<char>& data,
+                          uint64_t value)
+  {
+    while (value>=0x80) {
+      data.push_back((char)((value & 0x7f) | 0x80));
+      value>>=7;
+    }
+
+    data.push_back((char)value);
+  }
+
+  static size_t GetVarintSize(uint64_t value)
+  {
+    size_t size=1;
+
+    while (value>=0x80) {
+      value>>=7;
+      size++;
+    }
+
+    return size;
+  }
+
+  static void WriteKey(std::vector<char>& data,
+                       uint32_t field,
+                       uint32_t wireType)
+  {
+    WriteVarint(data,(field << 3) | wireType);
+  }
+
+  static void WriteUInt(std::vector<char>& data,
+                        uint32_t field,
+                        uint64_t value)
+  {
+    WriteKey(data,field,WIRE_VARINT);
+    WriteVarint(data,value);
+  }
+
+  static void WriteBytes(std::vector<char>& data,
+                         uint32_t field,
+                         const char* bytes,
+                         size_t size)
+  {
+    WriteKey(data,field,WIRE_LENGTH);
+    WriteVarint(data,size);
+    data.insert(data.end(),bytes,bytes+size);
+  }
+
+  static void WritePacked(std::vector<char>& data,
+                          uint32_t field,
+                          const std::vector<uint32_t>& values)
+  {
+    size_t size=0;
+
+    for (uint32_t value : values) {
+      size+=GetVarintSize(value);
+    }
+
+    WriteKey(data,field,WIRE_LENGTH);
+    WriteVarint(data,size);
+
+    for (uint32_t value : values) {
+      WriteVarint(data,value);
+    }
+  }
+
+  static uint32_t GetKey(Layer& layer,
+                         const std::string& key)
+  {
+    auto entry=layer.keyIndex.find(key);
+
+    if (entry!=layer.keyIndex.end()) {
+      return entry->second;
+    }
+
+    uint32_t index=(uint32_t)layer.keys.size();
+
+    layer.keys.push_back(key);
+    layer.keyIndex[key]=index;
+
+    return index;
+  }
+
+  static uint32_t GetStringValue(Layer& layer,
+                                 const std::string& value)
+  {
+    std::string indexKey="s"+value;
+    auto        entry=layer.valueIndex.find(indexKey);
+
+    if (entry!=layer.valueIndex.end()) {
+      return entry->second;
+    }
+
+    uint32_t index=(uint32_t)layer.values.size();
+
+    layer.values.emplace_back();
+    WriteBytes(layer.values.back(),VALUE_STRING,value.data(),value.length());
+    layer.valueIndex[indexKey]=index;
+
+    return index;
+  }
+
+  static uint32_t GetBoolValue(Layer& layer,
+                               bool value)
+  {
+    std::string indexKey=value ? "b1" : "b0";
+    auto        entry=layer.valueIndex.find(indexKey);
+
+    if (entry!=layer.valueIndex.end()) {
+      return entry->second;
+    }
+
+    uint32_t index=(uint32_t)layer.values.size();
+
+    layer.values.emplace_back();
+    WriteUInt(layer.values.back(),VALUE_BOOL,value ? 1 : 0);
+    layer.valueIndex[indexKey]=index;
+
+    return index;
+  }
+
+  static Layer& GetLayer(EncoderState& state,
+                         const TypeInfoRef& type)
+  {
+    std::unique_ptr<Layer>& layer=state.layers[type->GetIndex()];
+
+    if (!layer) {
+      layer.reset(new Layer());
+      layer->name=type->GetName();
+    }
+
+    return *layer;
+  }
+
+  /**
+   * Adds labels as string values and features without value as boolean
+   */
+  static void AddAttributes(Layer& layer,
+                            const FeatureValueBuffer& buffer,
+                            std::vector<uint32_t>& tags)
+  {
+    tags.clear();
+
+    for (const auto& featureInstance : buffer.GetType()->GetFeatures()) {
+      if (!buffer.HasFeature(featureInstance.GetIndex())) {
+        continue;
+      }
+
+      FeatureRef feature=featureInstance.GetFeature();
+
+      if (!feature->HasValue()) {
+        tags.push_back(GetKey(layer,feature->GetName()));
+        tags.push_back(GetBoolValue(layer,true));
+        continue;
+      }
+
+      if (!feature->HasLabel()) {
+        continue;
+      }
+
+      FeatureValue* value=buffer.GetValue(featureInstance.GetIndex());
+      std::string   label=value->GetLabel(0);
+
+      if (label.empty()) {
+        continue;
+      }
+
+      tags.push_back(GetKey(layer,feature->GetName()));
+      tags.push_back(GetStringValue(layer,label));
+    }
+  }
+
+  static void AddFeature(Layer& layer,
+                         uint64_t id,
+                         uint32_t type,
+                         const std::vector<uint32_t>& tags,
+                         const std::vector<uint32_t>& geometry,
+                         std::vector<char>& feature)
+  {
+    feature.clear();
+
+    WriteUInt(feature,FEATURE_ID,id);
+
+    if (!tags.empty()) {
+      WritePacked(feature,FEATURE_TAGS,tags);
+    }
+
+    WriteUInt(feature,FEATURE_TYPE,type);
+    WritePacked(feature,FEATURE_GEOMETRY,geometry);
+
+    WriteBytes(layer.features,LAYER_FEATURES,feature.data(),feature.size());
+  }
+
+  static inline uint32_t Command(uint32_t id,
+                                 uint32_t count)
+  {
+    return (id & 0x7) | (count << 3);
+  }
+
+  static inline uint32_t ZigZag(int32_t value)
+  {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+  }
+
+  /**
+   * Appends the path as MoveTo and LineTo commands, relative to the cursor
+   */
+  static void AddPath(const TileLine& path,
+                      TilePoint& cursor,
+                      std::vector<uint32_t>& geometry)
+  {
+    geometry.push_back(Command(COMMAND_MOVE_TO,1));
+    geometry.push_back(ZigZag(path.front().x-cursor.x));
+    geometry.push_back(ZigZag(path.front().y-cursor.y));
+    cursor=path.front();
+
+    if (path.size()<2) {
+      return;
+    }
+
+    geometry.push_back(Command(COMMAND_LINE_TO,(uint32_t)(path.size()-1)));
+
+    for (size_t i=1; i<path.size(); i++) {
+      geometry.push_back(ZigZag(path[i].x-cursor.x));
+      geometry.push_back(ZigZag(path[i].y-cursor.y));
+      cursor=path[i];
+    }
+  }
+
+  static void TransformPoints(const TileProjection& projection,
+                              double scale,
+                              const std::vector<Point>& nodes,
+                              std::vector<Vertex2D>& points)
+  {
+    points.resize(nodes.size());
+
+    for (size_t i=0; i<nodes.size(); i++) {
+      double x,y;
+
+      projection.GeoToPixel(nodes[i].GetCoord(),x,y);
+      points[i].Set(x*scale,y*scale);
+    }
+  }
+
+  static inline void AddPoint(TileLine& line,
+                              const Vertex2D& point)
+  {
+    TilePoint tilePoint{(int32_t)std::lround(point.GetX()),
+                        (int32_t)std::lround(point.GetY())};
+
+    if (line.empty() ||
+        line.back()!=tilePoint) {
+      line.push_back(tilePoint);
+    }
+  }
+
+  /**
+   * Clips the segment a-b to the box (Liang-Barsky), returning the parameters
+   * of the visible part
+   */
+  static bool ClipSegment(const Vertex2D& a,
+                          const Vertex2D& b,
+                          double min,
+                          double max,
+                          double& t0,
+                          double& t1)
+  {
+    double dx=b.GetX()-a.GetX();
+    double dy=b.GetY()-a.GetY();
+    double p[4]={-dx,dx,-dy,dy};
+    double q[4]={a.GetX()-min,max-a.GetX(),a.GetY()-min,max-a.GetY()};
+
+    t0=0.0;
+    t1=1.0;
+
+    for (size_t i=0; i<4; i++) {
+      if (p[i]==0.0) {
+        if (q[i]<0.0) {
+          return false;
+        }
+
+        continue;
+      }
+
+      double r=q[i]/p[i];
+
+      if (p[i]<0.0) {
+        if (r>t1) {
+          return false;
+        }
+
+        t0=std::max(t0,r);
+      }
+      else {
+        if (r<t0) {
+          return false;
+        }
+
+        t1=std::min(t1,r);
+      }
+    }
+
+    return true;
+  }
+
+  static inline Vertex2D Interpolate(const Vertex2D& a,
+                                     const Vertex2D& b,
+                                     double t)
+  {
+    return Vertex2D(a.GetX()+t*(b.GetX()-a.GetX()),
+                    a.GetY()+t*(b.GetY()-a.GetY()));
+  }
+
+  static void FlushLine(TileLine& line,
+                        std::vector<TileLine>& lines)
+  {
+    if (line.size()>=2) {
+      lines.push_back(line);
+    }
+
+    line.clear();
+  }
+
+  /**
+   * Clips the polyline to the box, the result may consist of multiple lines
+   */
+  static void ClipLine(const std::vector<Vertex2D>& points,
+                       double min,
+                       double max,
+                       std::vector<TileLine>& lines)
+  {
+    TileLine line;
+    bool     open=false; // The last segment ended inside the box
+
+    lines.clear();
+
+    for (size_t i=1; i<points.size(); i++) {
+      double t0,t1;
+
+      if (!ClipSegment(points[i-1],points[i],min,max,t0,t1)) {
+        open=false;
+        continue;
+      }
+
+      if (!open) {
+        FlushLine(line,lines);
+        AddPoint(line,Interpolate(points[i-1],points[i],t0));
+      }
+
+      AddPoint(line,Interpolate(points[i-1],points[i],t1));
+
+      open=t1==1.0;
+    }
+
+    FlushLine(line,lines);
+  }
+
+  /**
+   * One step of Sutherland-Hodgman: clip the ring against one border of the box
+   */
+  static void ClipRingAtBorder(const std::vector<Vertex2D>& in,
+                               std::vector<Vertex2D>& out,
+                               bool vertical,
+                               bool lower,
+                               double border)
+  {
+    out.clear();
+
+    if (in.empty()) {
+      return;
+    }
+
+    auto isInside=[vertical,lower,border](const Vertex2D& point) {
+      double value=vertical ? point.GetX() : point.GetY();
+
+      return lower ? value>=border : value<=border;
+    };
+
+    auto intersect=[vertical,border](const Vertex2D& a,
+                                     const Vertex2D& b) {
+      double t=vertical ? (border-a.GetX())/(b.GetX()-a.GetX())
+                        : (border-a.GetY())/(b.GetY()-a.GetY());
+
+      return Interpolate(a,b,t);
+    };
+
+    Vertex2D previous=in.back();
+    bool     previousInside=isInside(previous);
+
+    for (const auto& current : in) {
+      bool currentInside=isInside(current);
+
+      if (currentInside) {
+        if (!previousInside) {
+          out.push_back(intersect(previous,current));
+        }
+
+        out.push_back(current);
+      }
+      else if (previousInside) {
+        out.push_back(intersect(previous,current));
+      }
+
+      previous=current;
+      previousInside=currentInside;
+    }
+  }
+
+  /**
+   * Clips and quantises the ring and orients it as required by MVT: exterior
+   * rings have a positive area in tile coordinates, interior rings a negative
+   * one. Returns false, if nothing of the ring is left.
+   */
+  static bool ClipRing(EncoderState& state,
+                       double min,
+                       double max,
+                       bool exterior,
+                       TileLine& ring)
+  {
+    double minX=state.points.front().GetX();
+    double maxX=minX;
+    double minY=state.points.front().GetY();
+    double maxY=minY;
+
+    for (const auto& point : state.points) {
+      minX=std::min(minX,point.GetX());
+      maxX=std::max(maxX,point.GetX());
+      minY=std::min(minY,point.GetY());
+      maxY=std::max(maxY,point.GetY());
+    }
+
+    if (maxX<min || minX>max || maxY<min || minY>max) {
+      return false;
+    }
+
+    const std::vector<Vertex2D>* points=&state.points;
+
+    if (minX<min || maxX>max || minY<min || maxY>max) {
+      ClipRingAtBorder(state.points,state.clipped,true,true,min);
+      ClipRingAtBorder(state.clipped,state.ring,true,false,max);
+      ClipRingAtBorder(state.ring,state.clipped,false,true,min);
+      ClipRingAtBorder(state.clipped,state.ring,false,false,max);
+
+      points=&state.ring;
+    }
+
+    ring.clear();
+
+    for (const auto& point : *points) {
+      AddPoint(ring,point);
+    }
+
+    while (ring.size()>1 &&
+           ring.back()==ring.front()) {
+      ring.pop_back();
+    }
+
+    if (ring.size()<3) {
+      return false;
+    }
+
+    int64_t area=0;
+
+    for (size_t i=0; i<ring.size(); i++) {
+      const TilePoint& a=ring[i];
+      const TilePoint& b=ring[(i+1)%ring.size()];
+
+      area+=(int64_t)a.x*b.y-(int64_t)b.x*a.y;
+    }
+
+    if (area==0) {
+      return false;
+    }
+
+    if ((area>0)!=exterior) {
+      std::reverse(ring.begin(),ring.end());
+    }
+
+    return true;
+  }
+
+  static void AddRing(const TileLine& ring,
+                      TilePoint& cursor,
+                      std::vector<uint32_t>& geometry)
+  {
+    AddPath(ring,
+            cursor,
+            geometry);
+    geometry.push_back(Command(COMMAND_CLOSE_PATH,1));
+  }
+
+  MapPainterMVT::MapPainterMVT(const StyleConfigRef& styleConfig)
+  : styleConfig(styleConfig),
+    extent(4096),
+    buffer(64)
+  {
+    // no code
+  }
+
+  void MapPainterMVT::SetExtent(uint32_t extent)
+  {
+    this->extent=extent;
+  }
+
+  void MapPainterMVT::SetBuffer(uint32_t buffer)
+  {
+    this->buffer=buffer;
+  }
+
+  bool MapPainterMVT::DrawMap(const TileProjection& projection,
+                              const MapParameter& parameter,
+                              const MapData& data,
+                              std::vector<char>& tileData) const
+  {
+    EncoderState                state;
+    double                      scale=extent/(double)projection.GetWidth();
+    double                      min=-(double)buffer;
+    double                      max=(double)extent+buffer;
+    std::vector<TextStyleRef>   textStyles;
+    std::vector<LineStyleRef>   lineStyles;
+    std::vector<BorderStyleRef> borderStyles;
+
+    tileData.clear();
+    state.layers.resize(styleConfig->GetTypeConfig()->GetTypes().size());
+
+    //
+    // Nodes
+    //
+
+    auto addNode=[&](const NodeRef& node) {
+      if (node->GetType()->GetIgnore()) {
+        return;
+      }
+
+      styleConfig->GetNodeTextStyles(node->GetFeatureValueBuffer(),
+                                     projection,
+                                     textStyles);
+
+      if (textStyles.empty() &&
+          !styleConfig->GetNodeIconStyle(node->GetFeatureValueBuffer(),
+                                         projection)) {
+        return;
+      }
+
+      double x,y;
+
+      projection.GeoToPixel(node->GetCoords(),x,y);
+
+      Vertex2D point(x*scale,y*scale);
+
+      if (point.GetX()<min || point.GetX()>max ||
+          point.GetY()<min || point.GetY()>max) {
+        return;
+      }
+
+      Layer&    layer=GetLayer(state,node->GetType());
+      TilePoint cursor{0,0};
+
+      state.lines.assign(1,TileLine());
+      AddPoint(state.lines.front(),point);
+
+      state.geometry.clear();
+      AddPath(state.lines.front(),cursor,state.geometry);
+
+      AddAttributes(layer,node->GetFeatureValueBuffer(),state.tags);
+      AddFeature(layer,
+                 node->GetFileOffset(),
+                 GEOM_POINT,
+                 state.tags,
+                 state.geometry,
+                 state.feature);
+    };
+
+    for (const auto& node : data.nodes) {
+      addNode(node);
+    }
+
+    for (const auto& node : data.poiNodes) {
+      addNode(node);
+    }
+
+    if (parameter.IsAborted()) {
+      return false;
+    }
+
+    //
+    // Ways
+    //
+
+    auto addWay=[&](const WayRef& way) {
+      if (way->GetType()->GetIgnore() ||
+          way->nodes.size()<2) {
+        return;
+      }
+
+      styleConfig->GetWayLineStyles(way->GetFeatureValueBuffer(),
+                                    projection,
+                                    lineStyles);
+
+      if (lineStyles.empty() &&
+          !styleConfig->GetWayPathTextStyle(way->GetFeatureValueBuffer(),projection) &&
+          !styleConfig->GetWayPathShieldStyle(way->GetFeatureValueBuffer(),projection) &&
+          !styleConfig->GetWayPathSymbolStyle(way->GetFeatureValueBuffer(),projection)) {
+        return;
+      }
+
+      TransformPoints(projection,
+                      scale,
+                      way->nodes,
+                      state.points);
+      ClipLine(state.points,
+               min,
+               max,
+               state.lines);
+
+      if (state.lines.empty()) {
+        return;
+      }
+
+      Layer&    layer=GetLayer(state,way->GetType());
+      TilePoint cursor{0,0};
+
+      state.geometry.clear();
+
+      for (const auto& line : state.lines) {
+        AddPath(line,cursor,state.geometry);
+      }
+
+      AddAttributes(layer,way->GetFeatureValueBuffer(),state.tags);
+      AddFeature(layer,
+                 way->GetFileOffset(),
+                 GEOM_LINESTRING,
+                 state.tags,
+                 state.geometry,
+                 state.feature);
+    };
+
+    for (const auto& way : data.ways) {
+      addWay(way);
+    }
+
+    for (const auto& way : data.poiWays) {
+      addWay(way);
+    }
+
+    if (parameter.IsAborted()) {
+      return false;
+    }
+
+    //
+    // Areas
+    //
+
+    auto addArea=[&](const AreaRef& area) {
+      TileLine ring;
+
+      for (size_t i=0; i<area->rings.size(); i++) {
+        const Area::Ring& outer=area->rings[i];
+
+        // The master ring has no nodes, untyped inner rings are holes of their outer ring
+        if (outer.IsMasterRing() ||
+            outer.nodes.size()<3 ||
+            (!outer.IsOuterRing() && outer.GetType()->GetIgnore())) {
+          continue;
+        }
+
+        TypeInfoRef               type=outer.IsOuterRing() ? area->GetType() : outer.GetType();
+        const FeatureValueBuffer& buffer=outer.IsOuterRing() ? area->rings.front().GetFeatureValueBuffer() : outer.GetFeatureValueBuffer();
+
+        if (type->GetIgnore()) {
+          continue;
+        }
+
+        styleConfig->GetAreaBorderStyles(type,
+                                         buffer,
+                                         projection,
+                                         borderStyles);
+        styleConfig->GetAreaTextStyles(type,
+                                       buffer,
+                                       projection,
+                                       textStyles);
+
+        if (!styleConfig->GetAreaFillStyle(type,buffer,projection) &&
+            borderStyles.empty() &&
+            textStyles.empty() &&
+            !styleConfig->GetAreaIconStyle(type,buffer,projection)) {
+          continue;
+        }
+
+        TransformPoints(projection,
+                        scale,
+                        outer.nodes,
+                        state.points);
+
+        if (!ClipRing(state,min,max,true,ring)) {
+          continue;
+        }
+
+        TilePoint cursor{0,0};
+
+        state.geometry.clear();
+        AddRing(ring,cursor,state.geometry);
+
+        // Holes directly follow their outer ring
+        for (size_t j=i+1;
+             j<area->rings.size() &&
+             area->rings[j].GetRing()==outer.GetRing()+1 &&
+             area->rings[j].GetType()->GetIgnore();
+             j++) {
+          if (area->rings[j].nodes.size()<3) {
+            continue;
+          }
+
+          TransformPoints(projection,
+                          scale,
+                          area->rings[j].nodes,
+                          state.points);
+
+          if (ClipRing(state,min,max,false,ring)) {
+            AddRing(ring,cursor,state.geometry);
+          }
+        }
+
+        Layer& layer=GetLayer(state,type);
+
+        AddAttributes(layer,buffer,state.tags);
+        AddFeature(layer,
+                   area->GetFileOffset(),
+                   GEOM_POLYGON,
+                   state.tags,
+                   state.geometry,
+                   state.feature);
+      }
+    };
+
+    for (const auto& area : data.areas) {
+      addArea(area);
+    }
+
+    for (const auto& area : data.poiAreas) {
+      addArea(area);
+    }
+
+    if (parameter.IsAborted()) {
+      return false;
+    }
+
+    //
+    // Tile
+    //
+
+    std::vector<char> layerData;
+
+    for (const auto& layer : state.layers) {
+      if (!layer) {
+        continue;
+      }
+
+      layerData.clear();
+
+      WriteUInt(layerData,LAYER_VERSION,2);
+      WriteBytes(layerData,LAYER_NAME,layer->name.data(),layer->name.length());
+      layerData.insert(layerData.end(),layer->features.begin(),layer->features.end());
+
+      for (const auto& key : layer->keys) {
+        WriteBytes(layerData,LAYER_KEYS,key.data(),key.length());
+      }
+
+      for (const auto& value : layer->values) {
+        WriteBytes(layerData,LAYER_VALUES,value.data(),value.size());
+      }
+
+      WriteUInt(layerData,LAYER_EXTENT,extent);
+
+      WriteBytes(tileData,TILE_LAYERS,layerData.data(),layerData.size());
+    }
+
+    return true;
+  }
+}
@@ -23,6 +23,8 @@
 #include <memory>
 #include <set>
 #include <array>
+#include <cstdint>
+#include <vector>
 
 #include <osmscout/MapImportExport.h>
 
@@ -134,6 +136,8 @@ namespace osmscout {
     osmscout::Vertex2D trPosition{0,0}; //!< top-left position after rotation
     double trWidth{0};                  //!< width after rotation
     double trHeight{0};                 //!< height after rotation
+
+    DoubleRectangle boundingBox{0,0,0,0}; //!< bounding box relative to position, before rotation
   };
 
   /**
@@ -195,37 +199,62 @@ namespace osmscout {
     osmscout::PathTextStyleRef style;    //!< Style for drawing
   };
 
-  class Mask
+  /**
+   * Index of the screen areas occupied by already placed labels, used to
+   * detect label collisions.
+   *
+   * The area of the layout viewport is divided into a uniform grid of square
+   * cells. Each cell references the boxes that overlap it, so a collision test
+   * only has to check the boxes in the cells covered by the candidate instead of
+   * scanning all placed labels. Boxes may be rotated (glyphs of contour labels),
+   * collisions between rotated boxes are tested exactly by the separating axis
+   * theorem, not by their axis aligned bounding boxes.
+   *
+   * Boxes completely outside of the area are ignored.
+   */
+  class OSMSCOUT_MAP_API LabelCollisionIndex
   {
   public:
-    Mask(size_t rowSize) : d(rowSize)
+    struct Box
     {
+      DoubleRectangle aabb{0,0,0,0}; //!< Axis aligned bounding box
+      bool            rotated{false};
+      double          centerX{0};    //!< Center of a rotated box
+      double          centerY{0};
+      double          halfWidth{0};  //!< Half of the width of a rotated box along its own x axis
+      double          halfHeight{0}; //!< Half of the height of a rotated box along its own y axis
+      double          cosA{1};       //!< Rotation of the box
+      double          sinA{0};
     };
 
-    Mask(const Mask &m) :
-        d(m.d), cellFrom(m.cellFrom), cellTo(m.cellTo), rowFrom(m.rowFrom), rowTo(m.rowTo)
-    {
-    };
-
-    ~Mask()
-    {
-    }
+  private:
+    DoubleRectangle                    area{0,0,0,0};
+    double                             cellSize{1};
+    int                                columns{0};
+    int                                rows{0};
+    std::vector<Box>                   boxes;
+    std::vector<std::vector<uint32_t>> cells;      //!< Indexes of the boxes overlapping each cell
+    std::vector<uint32_t>              boxStamps;  //!< Last query a box was tested in
+    uint32_t                           queryStamp{0};
 
-    Mask(Mask &&m) = delete;
-    Mask &operator=(const Mask &m) = delete;
-    Mask &operator=(Mask &&m) = delete;
+  private:
+    bool GetCellRange(const DoubleRectangle& rectangle,
+                      int& columnFrom, int& columnTo,
+                      int& rowFrom, int& rowTo) const;
 
-	OSMSCOUT_MAP_API void prepare(const IntRectangle &rect);
+    static bool Intersects(const Box& a, const Box& b);
 
-    inline int64_t size() const
-    { return d.size(); };
+  public:
+    static Box CreateBox(const DoubleRectangle& rectangle);
+    static Box CreateRotatedBox(const DoubleRectangle& rectangle,
+                                const Vertex2D& origin,
+                                double angle);
 
-    std::vector<uint64_t> d;
+    void Reset(const DoubleRectangle& area,
+               double cellSize);
 
-    int cellFrom{0};
-    int cellTo{0};
-    int rowFrom{0};
-    int rowTo{0};
+    bool Intersects(const Box& box);
+    void Insert(const Box& box);
   };
 
   template <class NativeGlyph, class NativeLabel>
@@ -283,6 +312,9 @@ namespace osmscout {
     using LabelPtr = std::shared_ptr<LabelType>;
     using LabelInstanceType = LabelInstance<NativeGlyph, NativeLabel>;
 
+  private:
+    static constexpr double COLLISION_CELL_SIZE = 10.0; //!< Size of the collision index cells in mm
+
   public:
     LabelLayouter(TextLayouter *textLayouter):
         textLayouter(textLayouter),
@@ -315,32 +347,6 @@ namespace osmscout {
       labelInstances.clear();
     }
 
-    inline bool CheckLabelCollision(const std::vector<uint64_t> &canvas,
-                                    const Mask &mask,
-                                    int64_t viewportHeight
-    )
-    {
-      bool collision=false;
-      for (int r=std::max(0,mask.rowFrom); !collision && r<=std::min((int)viewportHeight-1, mask.rowTo); r++){
-        for (int c=std::max(0,mask.cellFrom); !collision && c<=std::min((int)mask.size()-1,mask.cellTo); c++){
-          collision |= (mask.d[c] & canvas[r*mask.size() + c]) != 0;
-        }
-      }
-      return collision;
-    }
-
-    inline void MarkLabelPlace(std::vector<uint64_t> &canvas,
-                               const Mask &mask,
-                               int viewportHeight
-    )
-    {
-      for (int r=std::max(0,mask.rowFrom); r<=std::min((int)viewportHeight-1, mask.rowTo); r++){
-        for (int c=std::max(0,mask.cellFrom); c<=std::min((int)mask.size()-1, mask.cellTo); c++){
-          canvas[r*mask.size() + c] = mask.d[c] | canvas[r*mask.size() + c];
-        }
-      }
-    }
-
     // Something is an overlay, if its alpha is <0.8
     inline bool IsOverlay(const LabelData &labelData)
     {
@@ -350,8 +356,8 @@ namespace osmscout {
     void Layout(const Projection& projection,
                 const MapParameter& parameter)
     {
-      std::vector<ContourLabelType> allSortedContourLabels;
-      std::vector<LabelInstanceType> allSortedLabels;
+      std::vector<ContourLabelType> allContourLabels;
+      std::vector<LabelInstanceType> allLabels;
 
       double iconPadding = projection.ConvertWidthToPixel(parameter.GetIconPadding());
       double labelPadding = projection.ConvertWidthToPixel(parameter.GetLabelPadding());
@@ -359,22 +365,45 @@ namespace osmscout {
       double contourLabelPadding = projection.ConvertWidthToPixel(parameter.GetContourLabelPadding());
       double overlayLabelPadding = projection.ConvertWidthToPixel(parameter.GetOverlayLabelPadding());
 
-      std::swap(allSortedLabels, labelInstances);
-      std::swap(allSortedContourLabels, contourLabelInstances);
+      std::swap(allLabels, labelInstances);
+      std::swap(allContourLabels, contourLabelInstances);
+
+      // sort labels by priority and position (to be deterministic),
+      // just pointers are sorted, moving the labels itself is much more expensive
+      std::vector<LabelInstanceType*> allSortedLabels;
+      std::vector<ContourLabelType*> allSortedContourLabels;
+
+      allSortedLabels.reserve(allLabels.size());
+      for (auto &label : allLabels) {
+        allSortedLabels.push_back(&label);
+      }
+      allSortedContourLabels.reserve(allContourLabels.size());
+      for (auto &label : allContourLabels) {
+        allSortedContourLabels.push_back(&label);
+      }
 
-      // sort labels by priority and position (to be deterministic)
       std::stable_sort(allSortedLabels.begin(),
                        allSortedLabels.end(),
-                       LabelInstanceSorter<NativeGlyph, NativeLabel>);
+                       [](const LabelInstanceType *a, const LabelInstanceType *b) {
+                         return LabelInstanceSorter<NativeGlyph, NativeLabel>(*a, *b);
+                       });
       std::stable_sort(allSortedContourLabels.begin(),
                        allSortedContourLabels.end(),
-                       ContourLabelSorter<NativeGlyph>);
+                       [](const ContourLabelType *a, const ContourLabelType *b) {
+                         return ContourLabelSorter<NativeGlyph>(*a, *b);
+                       });
 
       // compute collisions, hide some labels
-      int64_t rowSize = (layoutViewport.width / 64)+1;
-      std::vector<uint64_t> iconCanvas((size_t)(rowSize*layoutViewport.height));
-      std::vector<uint64_t> labelCanvas((size_t)(rowSize*layoutViewport.height));
-      std::vector<uint64_t> overlayCanvas((size_t)(rowSize*layoutViewport.height));
+      // labels are placed greedy in order of their priority, each placed label is
+      // added to the index immediately and blocks all following candidates
+      double cellSize = projection.ConvertWidthToPixel(COLLISION_CELL_SIZE);
+
+      iconIndex.Reset(layoutViewport, cellSize);
+      labelIndex.Reset(layoutViewport, cellSize);
+      overlayIndex.Reset(layoutViewport, cellSize);
+
+      std::vector<LabelCollisionIndex::Box> boxes;
+      std::vector<LabelCollisionIndex*> indexes;
 
       auto labelIter = allSortedLabels.begin();
       auto contourLabelIter = allSortedContourLabels.begin();
@@ -385,8 +414,8 @@ namespace osmscout {
         auto currentContourLabel = contourLabelIter;
         if (currentLabel != allSortedLabels.end()
             && currentContourLabel != allSortedContourLabels.end()) {
-          if (currentLabel->priority != currentContourLabel->priority) {
-            if (currentLabel->priority < currentContourLabel->priority) {
+          if ((*currentLabel)->priority != (*currentContourLabel)->priority) {
+            if ((*currentLabel)->priority < (*currentContourLabel)->priority) {
               currentContourLabel = allSortedContourLabels.end();
             } else {
               currentLabel = allSortedLabels.end();
@@ -396,16 +425,13 @@ namespace osmscout {
 
         if (currentLabel != allSortedLabels.end()){
 
-          Mask m(rowSize);
-          std::vector<Mask> masks(currentLabel->elements.size(), m);
-          std::vector<std::vector<uint64_t> *> canvases(currentLabel->elements.size(), nullptr);
-
-          std::vector<typename LabelInstance<NativeGlyph, NativeLabel>::Element> visibleElements;
+          LabelInstanceType instanceCopy;
+          instanceCopy.priority = (*currentLabel)->priority;
 
-          for (size_t eli=0; eli < currentLabel->elements.size(); eli++){
-            const typename LabelInstance<NativeGlyph, NativeLabel>::Element& element = currentLabel->elements[eli];
-            Mask& row=masks[eli];
+          boxes.clear();
+          indexes.clear();
 
+          for (typename LabelInstanceType::Element& element : (*currentLabel)->elements){
             double padding;
             if (element.labelData.type==LabelData::Icon || element.labelData.type==LabelData::Symbol) {
               padding = iconPadding;
@@ -417,44 +443,41 @@ namespace osmscout {
               padding = labelPadding;
             }
 
-            IntRectangle rectangle{ (int)std::floor(element.x - layoutViewport.x - padding),
-                                    (int)std::floor(element.y - layoutViewport.y - padding),
-                                    0, 0 };
-            std::vector<uint64_t> *canvas = &labelCanvas;
+            DoubleRectangle rectangle{ element.x - padding,
+                                       element.y - padding,
+                                       0, 0 };
+            LabelCollisionIndex *index = &labelIndex;
             if (element.labelData.type==LabelData::Icon || element.labelData.type==LabelData::Symbol){
-              rectangle.width = std::ceil(element.labelData.iconWidth + 2*padding);
-              rectangle.height = std::ceil(element.labelData.iconHeight + 2*padding);
-              canvas = &iconCanvas;
+              rectangle.width = element.labelData.iconWidth + 2*padding;
+              rectangle.height = element.labelData.iconHeight + 2*padding;
+              index = &iconIndex;
             } else {
 #ifdef DEBUG_LABEL_LAYOUTER
-              std::cout << "Test label prio " << currentLabel->priority << ": " << element.labelData.text << std::endl;
+              std::cout << "Test label prio " << (*currentLabel)->priority << ": " << element.labelData.text << std::endl;
 #endif
 
-              rectangle.width = std::ceil(element.label->width + 2*padding);
-              rectangle.height = std::ceil(element.label->height + 2*padding);
+              rectangle.width = element.label->width + 2*padding;
+              rectangle.height = element.label->height + 2*padding;
 
               if (IsOverlay(element.labelData)){
-                canvas = &overlayCanvas;
+                index = &overlayIndex;
               }
             }
-            row.prepare(rectangle);
-            bool collision = CheckLabelCollision(*canvas, row, layoutViewport.height);
-            if (!collision) {
-              visibleElements.push_back(element);
-              canvases[eli]=canvas;
+
+            LabelCollisionIndex::Box box = LabelCollisionIndex::CreateBox(rectangle);
+            if (!index->Intersects(box)) {
+              instanceCopy.elements.push_back(std::move(element));
+              boxes.push_back(box);
+              indexes.push_back(index);
             }
           }
-          LabelInstanceType instanceCopy;
-          instanceCopy.priority = currentLabel->priority;
-          instanceCopy.elements = visibleElements;
+
           if (!instanceCopy.elements.empty()) {
-            labelInstances.push_back(instanceCopy);
+            labelInstances.push_back(std::move(instanceCopy));
 
-            // mark all labels at once
-            for (size_t eli=0; eli < currentLabel->elements.size(); eli++) {
-              if (canvases[eli] != nullptr) {
-                MarkLabelPlace(*(canvases[eli]), masks[eli], layoutViewport.height);
-              }
+            // mark all labels at once, elements of one instance do not collide with each other
+            for (size_t i=0; i < boxes.size(); i++) {
+              indexes[i]->Insert(boxes[i]);
             }
           }
 
@@ -462,32 +485,34 @@ namespace osmscout {
         }
 
         if (currentContourLabel != allSortedContourLabels.end()){
-          int glyphCnt=currentContourLabel->glyphs.size();
 
 #ifdef DEBUG_LABEL_LAYOUTER
-          std::cout << "Test contour label prio " << currentContourLabel->priority << std::endl;
+          std::cout << "Test contour label prio " << (*currentContourLabel)->priority << std::endl;
 #endif
 
-          Mask m(rowSize);
-          std::vector<Mask> masks(glyphCnt, m);
+          boxes.clear();
           bool collision=false;
-          for (int gi=0; !collision && gi<glyphCnt; gi++) {
-
-            auto glyph=currentContourLabel->glyphs[gi];
-            IntRectangle rect{
-                (int)(glyph.trPosition.GetX() - layoutViewport.x - contourLabelPadding),
-                (int)(glyph.trPosition.GetY() - layoutViewport.y - contourLabelPadding),
-                (int)(glyph.trWidth + 2*contourLabelPadding),
-                (int)(glyph.trHeight + 2*contourLabelPadding)
+          for (const Glyph<NativeGlyph> &glyph : (*currentContourLabel)->glyphs) {
+            DoubleRectangle rectangle{
+                glyph.boundingBox.x - contourLabelPadding,
+                glyph.boundingBox.y - contourLabelPadding,
+                glyph.boundingBox.width + 2*contourLabelPadding,
+                glyph.boundingBox.height + 2*contourLabelPadding
             };
-            masks[gi].prepare(rect);
-            collision |= CheckLabelCollision(labelCanvas, masks[gi], layoutViewport.height);
+            LabelCollisionIndex::Box box = LabelCollisionIndex::CreateRotatedBox(rectangle,
+                                                                                glyph.position,
+                                                                                glyph.angle);
+            if (labelIndex.Intersects(box)) {
+              collision=true;
+              break;
+            }
+            boxes.push_back(box);
           }
           if (!collision) {
-            for (int gi=0; gi<glyphCnt; gi++) {
-              MarkLabelPlace(labelCanvas, masks[gi], layoutViewport.height);
+            for (const auto &box : boxes) {
+              labelIndex.Insert(box);
             }
-            contourLabelInstances.push_back(*currentContourLabel);
+            contourLabelInstances.push_back(std::move(**currentContourLabel));
           }
           contourLabelIter++;
         }
@@ -716,6 +741,7 @@ namespace osmscout {
           glyphCopy.position=osmscout::Vertex2D(point.GetX() - textBaselineOffset * sinA,
                                                 point.GetY() + textBaselineOffset * cosA);
           glyphCopy.angle=angle;
+          glyphCopy.boundingBox=textBoundingBox;
 
           // four coordinates of glyph bounding box; x,y of top-left, top-right, bottom-right, bottom-left
           std::array<double, 4> x{tl.GetX(), tl.GetX() + w, tl.GetX() + w, tl.GetX()};
@@ -771,6 +797,9 @@ namespace osmscout {
     DoubleRectangle visibleViewport;
     DoubleRectangle layoutViewport;
     double layoutOverlap; // overlap ratio used for label layouting
+    LabelCollisionIndex iconIndex;    // placed icons and symbols
+    LabelCollisionIndex labelIndex;   // placed labels and contour label glyphs
+    LabelCollisionIndex overlayIndex; // placed overlay labels
   };
 
 }
@@ -20,7 +20,9 @@
   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 */
 
+#include <functional>
 #include <list>
+#include <memory>
 #include <string>
 
 #include <osmscout/MapImportExport.h>
@@ -264,6 +266,41 @@ namespace osmscout {
       }
     };
 
+  private:
+    /**
+     * Scratch buffers of a thread preparing ways and areas in parallel
+     * (see MapParameter::GetPrepareThreadCount())
+     */
+    struct PrepareWorker
+    {
+      TransBuffer               transBuffer;    //!< Transformed coordinates of the thread
+      std::vector<LineStyleRef> lineStyles;     //!< Temporary storage for StyleConfig return value
+
+      PrepareWorker();
+    };
+
+    /**
+     * Result of preparing a range of consecutive objects in parallel. The indexes
+     * of the transformed coordinates refer to the buffer of the worker, until the chunk is
+     * merged into the data of the painter.
+     */
+    struct PrepareChunk
+    {
+      size_t                   worker;          //!< Index of the worker that prepared the chunk
+      size_t                   coordStart;      //!< Index of the first coordinate of the chunk in the buffer of the worker
+      size_t                   coordCount;      //!< Number of coordinates of the chunk in the buffer of the worker
+      std::list<AreaData>      areaData;
+      std::list<WayData>       wayData;
+      std::list<WayPathData>   wayPathData;
+
+      PrepareChunk();
+    };
+
+    typedef std::function<void(PrepareWorker& worker,
+                               PrepareChunk& chunk,
+                               size_t start,
+                               size_t end)> PrepareFunction;
+
   protected:
     CoordBuffer                  *coordBuffer;      //!< Reference to the coordinate buffer
     TextStyleRef                 debugLabel;
@@ -279,6 +316,8 @@ namespace osmscout {
     std::vector<TextStyleRef>    textStyles;     //!< Temporary storage for StyleConfig return value
     std::vector<LineStyleRef>    lineStyles;     //!< Temporary storage for StyleConfig return value
 
+    std::vector<std::unique_ptr<PrepareWorker>> prepareWorkers; //!< Buffers of the threads preparing ways and areas, kept to avoid reallocation
+
     /**
       Fallback styles in case they are missing for the style sheet
       */
@@ -361,7 +400,11 @@ namespace osmscout {
                         const MapParameter& parameter,
                         const ObjectFileRef& ref,
                         const FeatureValueBuffer& buffer,
-                        const std::vector<Point>& nodes);
+                        const std::vector<Point>& nodes,
+                        TransBuffer& transBuffer,
+                        std::vector<LineStyleRef>& lineStyles,
+                        std::list<WayData>& wayData,
+                        std::list<WayPathData>& wayPathData) const;
 
     void PrepareWays(const StyleConfig& styleConfig,
                      const Projection& projection,
@@ -371,7 +414,9 @@ namespace osmscout {
     void PrepareArea(const StyleConfig& styleConfig,
                      const Projection& projection,
                      const MapParameter& parameter,
-                     const AreaRef &area);
+                     const AreaRef &area,
+                     TransBuffer& transBuffer,
+                     std::list<AreaData>& areaData) const;
 
     void PrepareAreaLabel(const StyleConfig& styleConfig,
                           const Projection& projection,
@@ -383,6 +428,16 @@ namespace osmscout {
                       const MapParameter& parameter,
                       const MapData& data);
 
+    size_t GetPrepareThreadCount(const MapParameter& parameter,
+                                 size_t objectCount) const;
+
+    std::vector<PrepareChunk> PrepareParallel(const MapParameter& parameter,
+                                              size_t objectCount,
+                                              size_t threadCount,
+                                              const PrepareFunction& prepare);
+
+    void MergePrepareChunk(PrepareChunk& chunk);
+
     void RegisterPointWayLabel(const Projection& projection,
                                const MapParameter& parameter,
                                const PathShieldStyleRef& style,
@@ -108,6 +108,8 @@ namespace osmscout {
 
     bool                                showAltLanguage;           //!< if true, display alternative language (needs support by style sheet and import)
 
+    size_t                              prepareThreadCount;        //!< Number of threads for preparing ways and areas (default 1, 0 for the number of hardware threads)
+
     std::vector<FillStyleProcessorRef > fillProcessors;            //!< List of processors for FillStyles for types
 
     BreakerRef                          breaker;                   //!< Breaker to abort processing on external request
@@ -167,6 +169,8 @@ namespace osmscout {
 
     void SetShowAltLanguage(bool showAltLanguage);
 
+    void SetPrepareThreadCount(size_t threadCount);
+
     void RegisterFillStyleProcessor(size_t typeIndex,
                                     const FillStyleProcessorRef& processor);
 
@@ -355,6 +359,20 @@ namespace osmscout {
       return showAltLanguage;
     }
 
+    /**
+     * Number of threads used for preparing (transforming and styling) the ways and areas
+     * of the map data, 1 (the default) for preparing them in the drawing thread, 0 for
+     * the number of hardware threads. The result does not depend on the number of threads.
+     *
+     * If more than one thread is used, the registered fill style processors (see
+     * RegisterFillStyleProcessor()) are called concurrently from the prepare threads
+     * and thus must be thread-safe.
+     */
+    inline size_t GetPrepareThreadCount() const
+    {
+      return prepareThreadCount;
+    }
+
     bool IsAborted() const
     {
       if (breaker) {
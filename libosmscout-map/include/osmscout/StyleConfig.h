@@ -466,59 +466,88 @@ namespace osmscout {
     }
   };
 
-  typedef PartialStyle<LineStyle,LineStyle::Attribute>     LinePartialStyle;
-  typedef ConditionalStyle<LineStyle,LineStyle::Attribute> LineConditionalStyle;
-  typedef StyleSelector<LineStyle,LineStyle::Attribute>    LineStyleSelector;
-  typedef std::list<LineStyleSelector>                     LineStyleSelectorList; //! List of selectors
-  typedef std::vector<std::vector<LineStyleSelectorList> > LineStyleLookupTable;  //!Index selectors by type and level
-
-  typedef PartialStyle<FillStyle,FillStyle::Attribute>     FillPartialStyle;
-  typedef ConditionalStyle<FillStyle,FillStyle::Attribute> FillConditionalStyle;
-  typedef StyleSelector<FillStyle,FillStyle::Attribute>    FillStyleSelector;
-  typedef std::list<FillStyleSelector>                     FillStyleSelectorList; //! List of selectors
-  typedef std::vector<std::vector<FillStyleSelectorList> > FillStyleLookupTable;  //!Index selectors by type and level
-
-  typedef PartialStyle<BorderStyle,BorderStyle::Attribute>     BorderPartialStyle;
-  typedef ConditionalStyle<BorderStyle,BorderStyle::Attribute> BorderConditionalStyle;
-  typedef StyleSelector<BorderStyle,BorderStyle::Attribute>    BorderStyleSelector;
-  typedef std::list<BorderStyleSelector>                       BorderStyleSelectorList; //! List of selectors
-  typedef std::vector<std::vector<BorderStyleSelectorList> >   BorderStyleLookupTable;  //!Index selectors by type and level
-
-  typedef PartialStyle<TextStyle,TextStyle::Attribute>     TextPartialStyle;
-  typedef ConditionalStyle<TextStyle,TextStyle::Attribute> TextConditionalStyle;
-  typedef StyleSelector<TextStyle,TextStyle::Attribute>    TextStyleSelector;
-  typedef std::list<TextStyleSelector>                     TextStyleSelectorList; //! List of selectors
-  typedef std::vector<std::vector<TextStyleSelectorList> > TextStyleLookupTable;  //!Index selectors by type and level
-
-  typedef PartialStyle<ShieldStyle,ShieldStyle::Attribute>     ShieldPartialStyle;
-  typedef ConditionalStyle<ShieldStyle,ShieldStyle::Attribute> ShieldConditionalStyle;
-  typedef StyleSelector<ShieldStyle,ShieldStyle::Attribute>    ShieldStyleSelector;
-  typedef std::list<ShieldStyleSelector>                       ShieldStyleSelectorList; //! List of selectors
-  typedef std::vector<std::vector<ShieldStyleSelectorList> >   ShieldStyleLookupTable;  //!Index selectors by type and level
-
-  typedef PartialStyle<PathShieldStyle,PathShieldStyle::Attribute>     PathShieldPartialStyle;
-  typedef ConditionalStyle<PathShieldStyle,PathShieldStyle::Attribute> PathShieldConditionalStyle;
-  typedef StyleSelector<PathShieldStyle,PathShieldStyle::Attribute>    PathShieldStyleSelector;
-  typedef std::list<PathShieldStyleSelector>                           PathShieldStyleSelectorList; //! List of selectors
-  typedef std::vector<std::vector<PathShieldStyleSelectorList> >       PathShieldStyleLookupTable;  //!Index selectors by type and level
-
-  typedef PartialStyle<PathTextStyle,PathTextStyle::Attribute>     PathTextPartialStyle;
-  typedef ConditionalStyle<PathTextStyle,PathTextStyle::Attribute> PathTextConditionalStyle;
-  typedef StyleSelector<PathTextStyle,PathTextStyle::Attribute>    PathTextStyleSelector;
-  typedef std::list<PathTextStyleSelector>                         PathTextStyleSelectorList; //! List of selectors
-  typedef std::vector<std::vector<PathTextStyleSelectorList> >     PathTextStyleLookupTable;  //!Index selectors by type and level
-
-  typedef PartialStyle<IconStyle,IconStyle::Attribute>     IconPartialStyle;
-  typedef ConditionalStyle<IconStyle,IconStyle::Attribute> IconConditionalStyle;
-  typedef StyleSelector<IconStyle,IconStyle::Attribute>    IconStyleSelector;
-  typedef std::list<IconStyleSelector>                     IconStyleSelectorList; //! List of selectors
-  typedef std::vector<std::vector<IconStyleSelectorList> > IconStyleLookupTable;  //!Index selectors by type and level
-
-  typedef PartialStyle<PathSymbolStyle,PathSymbolStyle::Attribute>     PathSymbolPartialStyle;
-  typedef ConditionalStyle<PathSymbolStyle,PathSymbolStyle::Attribute> PathSymbolConditionalStyle;
-  typedef StyleSelector<PathSymbolStyle,PathSymbolStyle::Attribute>    PathSymbolStyleSelector;
-  typedef std::list<PathSymbolStyleSelector>                           PathSymbolStyleSelectorList; //! List of selectors
-  typedef std::vector<std::vector<PathSymbolStyleSelectorList> >       PathSymbolStyleLookupTable;  //!Index selectors by type and level
+  /**
+   * \ingroup Stylesheet
+   *
+   * All StyleSelectors for one type and one level together with the final
+   * styles composed from them.
+   *
+   * Each selector with criteria has a bit in a mask, in the order of the
+   * selectors. The mask of the selectors matching an object is the index into
+   * composedStyles, which holds the resulting style for each combination of
+   * matching selectors. This way there is no composition of styles during
+   * lookup. composedStyles is empty if there are no selectors or too many
+   * selectors with criteria, styles are then composed during lookup.
+   */
+  template<class S, class A>
+  struct CompiledStyleSelectors
+  {
+    std::list<StyleSelector<S,A> >   selectors;      //!< Selectors in the order of the style sheet
+    std::vector<std::shared_ptr<S> > composedStyles; //!< Resulting style by mask of matching selectors with criteria
+  };
+
+  typedef PartialStyle<LineStyle,LineStyle::Attribute>           LinePartialStyle;
+  typedef ConditionalStyle<LineStyle,LineStyle::Attribute>       LineConditionalStyle;
+  typedef StyleSelector<LineStyle,LineStyle::Attribute>          LineStyleSelector;
+  typedef std::list<LineStyleSelector>                           LineStyleSelectorList;      //! List of selectors
+  typedef CompiledStyleSelectors<LineStyle,LineStyle::Attribute> LineCompiledStyleSelectors; //! Selectors with composed styles
+  typedef std::vector<std::vector<LineCompiledStyleSelectors> >  LineStyleLookupTable;       //!Index selectors by type and level
+
+  typedef PartialStyle<FillStyle,FillStyle::Attribute>           FillPartialStyle;
+  typedef ConditionalStyle<FillStyle,FillStyle::Attribute>       FillConditionalStyle;
+  typedef StyleSelector<FillStyle,FillStyle::Attribute>          FillStyleSelector;
+  typedef std::list<FillStyleSelector>                           FillStyleSelectorList;      //! List of selectors
+  typedef CompiledStyleSelectors<FillStyle,FillStyle::Attribute> FillCompiledStyleSelectors; //! Selectors with composed styles
+  typedef std::vector<std::vector<FillCompiledStyleSelectors> >  FillStyleLookupTable;       //!Index selectors by type and level
+
+  typedef PartialStyle<BorderStyle,BorderStyle::Attribute>           BorderPartialStyle;
+  typedef ConditionalStyle<BorderStyle,BorderStyle::Attribute>       BorderConditionalStyle;
+  typedef StyleSelector<BorderStyle,BorderStyle::Attribute>          BorderStyleSelector;
+  typedef std::list<BorderStyleSelector>                             BorderStyleSelectorList;      //! List of selectors
+  typedef CompiledStyleSelectors<BorderStyle,BorderStyle::Attribute> BorderCompiledStyleSelectors; //! Selectors with composed styles
+  typedef std::vector<std::vector<BorderCompiledStyleSelectors> >    BorderStyleLookupTable;       //!Index selectors by type and level
+
+  typedef PartialStyle<TextStyle,TextStyle::Attribute>           TextPartialStyle;
+  typedef ConditionalStyle<TextStyle,TextStyle::Attribute>       TextConditionalStyle;
+  typedef StyleSelector<TextStyle,TextStyle::Attribute>          TextStyleSelector;
+  typedef std::list<TextStyleSelector>                           TextStyleSelectorList;      //! List of selectors
+  typedef CompiledStyleSelectors<TextStyle,TextStyle::Attribute> TextCompiledStyleSelectors; //! Selectors with composed styles
+  typedef std::vector<std::vector<TextCompiledStyleSelectors> >  TextStyleLookupTable;       //!Index selectors by type and level
+
+  typedef PartialStyle<ShieldStyle,ShieldStyle::Attribute>           ShieldPartialStyle;
+  typedef ConditionalStyle<ShieldStyle,ShieldStyle::Attribute>       ShieldConditionalStyle;
+  typedef StyleSelector<ShieldStyle,ShieldStyle::Attribute>          ShieldStyleSelector;
+  typedef std::list<ShieldStyleSelector>                             ShieldStyleSelectorList;      //! List of selectors
+  typedef CompiledStyleSelectors<ShieldStyle,ShieldStyle::Attribute> ShieldCompiledStyleSelectors; //! Selectors with composed styles
+  typedef std::vector<std::vector<ShieldCompiledStyleSelectors> >    ShieldStyleLookupTable;       //!Index selectors by type and level
+
+  typedef PartialStyle<PathShieldStyle,PathShieldStyle::Attribute>           PathShieldPartialStyle;
+  typedef ConditionalStyle<PathShieldStyle,PathShieldStyle::Attribute>       PathShieldConditionalStyle;
+  typedef StyleSelector<PathShieldStyle,PathShieldStyle::Attribute>          PathShieldStyleSelector;
+  typedef std::list<PathShieldStyleSelector>                                 PathShieldStyleSelectorList;      //! List of selectors
+  typedef CompiledStyleSelectors<PathShieldStyle,PathShieldStyle::Attribute> PathShieldCompiledStyleSelectors; //! Selectors with composed styles
+  typedef std::vector<std::vector<PathShieldCompiledStyleSelectors> >        PathShieldStyleLookupTable;       //!Index selectors by type and level
+
+  typedef PartialStyle<PathTextStyle,PathTextStyle::Attribute>           PathTextPartialStyle;
+  typedef ConditionalStyle<PathTextStyle,PathTextStyle::Attribute>       PathTextConditionalStyle;
+  typedef StyleSelector<PathTextStyle,PathTextStyle::Attribute>          PathTextStyleSelector;
+  typedef std::list<PathTextStyleSelector>                               PathTextStyleSelectorList;      //! List of selectors
+  typedef CompiledStyleSelectors<PathTextStyle,PathTextStyle::Attribute> PathTextCompiledStyleSelectors; //! Selectors with composed styles
+  typedef std::vector<std::vector<PathTextCompiledStyleSelectors> >      PathTextStyleLookupTable;       //!Index selectors by type and level
+
+  typedef PartialStyle<IconStyle,IconStyle::Attribute>           IconPartialStyle;
+  typedef ConditionalStyle<IconStyle,IconStyle::Attribute>       IconConditionalStyle;
+  typedef StyleSelector<IconStyle,IconStyle::Attribute>          IconStyleSelector;
+  typedef std::list<IconStyleSelector>                           IconStyleSelectorList;      //! List of selectors
+  typedef CompiledStyleSelectors<IconStyle,IconStyle::Attribute> IconCompiledStyleSelectors; //! Selectors with composed styles
+  typedef std::vector<std::vector<IconCompiledStyleSelectors> >  IconStyleLookupTable;       //!Index selectors by type and level
+
+  typedef PartialStyle<PathSymbolStyle,PathSymbolStyle::Attribute>           PathSymbolPartialStyle;
+  typedef ConditionalStyle<PathSymbolStyle,PathSymbolStyle::Attribute>       PathSymbolConditionalStyle;
+  typedef StyleSelector<PathSymbolStyle,PathSymbolStyle::Attribute>          PathSymbolStyleSelector;
+  typedef std::list<PathSymbolStyleSelector>                                 PathSymbolStyleSelectorList;      //! List of selectors
+  typedef CompiledStyleSelectors<PathSymbolStyle,PathSymbolStyle::Attribute> PathSymbolCompiledStyleSelectors; //! Selectors with composed styles
+  typedef std::vector<std::vector<PathSymbolCompiledStyleSelectors> >        PathSymbolStyleLookupTable;       //!Index selectors by type and level
 
   /**
    * \ingroup Stylesheet
@@ -607,6 +636,7 @@ namespace osmscout {
     void PostprocessAreas();
     void PostprocessIconId();
     void PostprocessPatternId();
+    void PostprocessComposedStyles();
 
   public:
     explicit StyleConfig(const TypeConfigRef& typeConfig);
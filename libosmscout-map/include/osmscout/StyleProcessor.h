@@ -27,6 +27,14 @@
 #include <osmscout/Styles.h>
 
 namespace osmscout {
+  /**
+   * Modifies the fill style of areas of a given type (see
+   * MapParameter::RegisterFillStyleProcessor()).
+   *
+   * Process() is called concurrently from several threads, if the map data is
+   * prepared in parallel (see MapParameter::GetPrepareThreadCount()), so
+   * implementations must be thread-safe.
+   */
   class OSMSCOUT_MAP_API FillStyleProcessor
   {
   public:
@@ -0,0 +1,363 @@
+#ifndef OSMSCOUT_TILERENDERPIPELINE_H
+#define OSMSCOUT_TILERENDERPIPELINE_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <osmscout/MapImportExport.h>
+
+#include <osmscout/MapParameter.h>
+#include <osmscout/MapPainter.h>
+#include <osmscout/MapService.h>
+#include <osmscout/StyleConfig.h>
+
+#include <osmscout/util/GeoBox.h>
+#include <osmscout/util/Magnification.h>
+#include <osmscout/util/Projection.h>
+#include <osmscout/util/Tiling.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Renderer
+   *
+   * Raster image of a metatile, 8 bit per channel, rows from top to bottom
+   * without padding.
+   */
+  class OSMSCOUT_MAP_API TileBitmap CLASS_FINAL
+  {
+  public:
+    enum PixelFormat
+    {
+      RGB24,  //!< Red, green and blue byte
+      RGBA32  //!< Red, green, blue and alpha byte
+    };
+
+  private:
+    PixelFormat                format;
+    size_t                     width;
+    size_t                     height;
+    std::vector<unsigned char> pixels;
+
+  public:
+    TileBitmap();
+
+    void Resize(PixelFormat format,
+                size_t width,
+                size_t height);
+
+    inline PixelFormat GetPixelFormat() const
+    {
+      return format;
+    }
+
+    inline size_t GetWidth() const
+    {
+      return width;
+    }
+
+    inline size_t GetHeight() const
+    {
+      return height;
+    }
+
+    inline size_t GetBytesPerPixel() const
+    {
+      return format==RGB24 ? 3 : 4;
+    }
+
+    inline size_t GetStride() const
+    {
+      return width*GetBytesPerPixel();
+    }
+
+    inline unsigned char* GetData()
+    {
+      return pixels.data();
+    }
+
+    inline const unsigned char* GetData() const
+    {
+      return pixels.data();
+    }
+
+    inline unsigned char* GetRow(size_t y)
+    {
+      return pixels.data()+y*GetStride();
+    }
+
+    inline const unsigned char* GetRow(size_t y) const
+    {
+      return pixels.data()+y*GetStride();
+    }
+  };
+
+  typedef std::shared_ptr<TileBitmap> TileBitmapRef;
+
+  /**
+   * \ingroup Renderer
+   *
+   * Draws a complete metatile into a bitmap using a concrete rendering backend.
+   * Each worker thread of the TileRenderPipeline uses its own instance.
+   */
+  class OSMSCOUT_MAP_API MetaTileDrawer
+  {
+  public:
+    virtual ~MetaTileDrawer();
+
+    /**
+     * Draw the data into the bitmap. The bitmap has to be resized to the
+     * width and height of the projection.
+     */
+    virtual bool DrawMetaTile(const Projection& projection,
+                              const MapParameter& parameter,
+                              const MapData& data,
+                              TileBitmap& bitmap) = 0;
+  };
+
+  typedef std::shared_ptr<MetaTileDrawer> MetaTileDrawerRef;
+
+  /**
+   * \ingroup Renderer
+   *
+   * Encodes a rectangular part of a metatile bitmap as an image file.
+   * Encode() is called concurrently and thus must be thread-safe.
+   */
+  class OSMSCOUT_MAP_API TileEncoder
+  {
+  public:
+    virtual ~TileEncoder();
+
+    /**
+     * Return the file extension of the encoded images (without ".")
+     */
+    virtual std::string GetFileExtension() const = 0;
+
+    virtual bool Encode(const TileBitmap& bitmap,
+                        size_t x,
+                        size_t y,
+                        size_t width,
+                        size_t height,
+                        std::vector<char>& data) const = 0;
+  };
+
+  typedef std::shared_ptr<TileEncoder> TileEncoderRef;
+
+  /**
+   * \ingroup Renderer
+   *
+   * Encodes tiles as binary portable pixmap (PPM), the alpha channel is dropped.
+   */
+  class OSMSCOUT_MAP_API PPMTileEncoder CLASS_FINAL : public TileEncoder
+  {
+  public:
+    std::string GetFileExtension() const override;
+
+    bool Encode(const TileBitmap& bitmap,
+                size_t x,
+                size_t y,
+                size_t width,
+                size_t height,
+                std::vector<char>& data) const override;
+  };
+
+  /**
+   * \ingroup Renderer
+   *
+   * Receives the encoded tiles of the TileRenderPipeline. StoreTile() is called
+   * concurrently and thus must be thread-safe.
+   */
+  class OSMSCOUT_MAP_API TileSink
+  {
+  public:
+    virtual ~TileSink();
+
+    virtual bool StoreTile(const MagnificationLevel& level,
+                           const OSMTileId& tile,
+                           const std::vector<char>& data) = 0;
+  };
+
+  typedef std::shared_ptr<TileSink> TileSinkRef;
+
+  /**
+   * \ingroup Renderer
+   *
+   * Writes each tile to a file "<level>_<x>_<y>.<extension>" in the given directory.
+   */
+  class OSMSCOUT_MAP_API FileTileSink CLASS_FINAL : public TileSink
+  {
+  private:
+    std::string directory;
+    std::string extension;
+
+  public:
+    FileTileSink(const std::string& directory,
+                 const std::string& extension);
+
+    std::string GetFilename(const MagnificationLevel& level,
+                            const OSMTileId& tile) const;
+
+    bool StoreTile(const MagnificationLevel& level,
+                   const OSMTileId& tile,
+                   const std::vector<char>& data) override;
+  };
+
+  /**
+   * \ingroup Renderer
+   *
+   * Headless rendering of a tile pyramid, as required by a raster tile server.
+   *
+   * The tiles of each zoom level are grouped into metatiles of n x n tiles,
+   * aligned to multiples of n. Each metatile is drawn in one pass: the data
+   * is loaded once for the whole metatile and labels are laid out once, so
+   * there are no cut labels at the borders of tiles within a metatile. The
+   * metatile bitmap is then sliced into tiles, which are encoded and stored
+   * by a pool of encoder threads, while the drawing threads continue with the
+   * next metatile.
+   *
+   * The metatiles of a zoom level are distributed in contiguous blocks to the
+   * drawing threads (for locality of the data cache of the MapService).
+   * A thread that has finished its block steals metatiles from the end of the
+   * block of another thread.
+   *
+   * If a journal file is set, each metatile is appended to it after all of
+   * its tiles have been stored. Metatiles already listed in the journal are
+   * skipped, so an aborted run can be resumed.
+   */
+  class OSMSCOUT_MAP_API TileRenderPipeline CLASS_FINAL
+  {
+  public:
+    typedef std::function<MetaTileDrawerRef()> DrawerFactory;
+
+    /**
+     * Statistics of rendering one zoom level
+     */
+    struct OSMSCOUT_MAP_API LevelStatistics
+    {
+      MagnificationLevel level;
+      size_t             metaTileCount;      //!< Number of metatiles drawn
+      size_t             skippedMetaTiles;   //!< Number of metatiles skipped, because they are in the journal
+      size_t             tileCount;          //!< Number of tiles stored
+      size_t             failedTileCount;    //!< Number of tiles that could not be drawn, encoded or stored
+      double             seconds;            //!< Wall clock time
+      double             loadSeconds;        //!< Time for loading data, summed over all threads
+      double             drawSeconds;        //!< Time for drawing, summed over all threads
+      double             encodeSeconds;      //!< Time for encoding and storing, summed over all threads
+
+      LevelStatistics();
+
+      inline double GetTilesPerSecond() const
+      {
+        return seconds>0.0 ? tileCount/seconds : 0.0;
+      }
+    };
+
+  private:
+    typedef std::tuple<uint32_t,uint32_t,uint32_t> JournalEntry; // level, metatile column, metatile row
+
+    struct MetaTile;
+    struct LevelState;
+
+    MapServiceRef          mapService;
+    StyleConfigRef         styleConfig;
+    DrawerFactory          drawerFactory;
+    TileEncoderRef         encoder;
+    TileSinkRef            sink;
+
+    size_t                 metaTileSize;        //!< Number of tiles in each direction of a metatile
+    size_t                 tileSize;            //!< Width and height of a tile in pixel
+    double                 dpi;
+    size_t                 threadCount;         //!< Number of drawing threads, 0 for the number of hardware threads
+    size_t                 encoderThreadCount;  //!< Number of encoding threads, 0 for the number of hardware threads
+    std::string            journalFilename;
+    MapParameter           mapParameter;
+    AreaSearchParameter    searchParameter;
+
+    std::mutex             journalMutex;
+    std::set<JournalEntry> journal;
+
+  private:
+    bool LoadJournal();
+    bool IsInJournal(const JournalEntry& entry);
+    void AppendToJournal(const JournalEntry& entry);
+
+    bool LoadData(const TileProjection& projection,
+                  MapData& data) const;
+
+    void RenderMetaTile(MetaTileDrawer& drawer,
+                        LevelState& state,
+                        const OSMTileIdBox& metaTile);
+    void EncodeTile(LevelState& state,
+                    const std::shared_ptr<MetaTile>& metaTile,
+                    const OSMTileId& tile);
+
+    bool RenderLevel(const MagnificationLevel& level,
+                     const GeoBox& boundingBox,
+                     size_t threadCount,
+                     LevelStatistics& statistics);
+
+  public:
+    TileRenderPipeline(const MapServiceRef& mapService,
+                       const StyleConfigRef& styleConfig,
+                       const DrawerFactory& drawerFactory,
+                       const TileEncoderRef& encoder,
+                       const TileSinkRef& sink);
+
+    void SetMetaTileSize(size_t metaTileSize);
+    void SetTileSize(size_t tileSize);
+    void SetDPI(double dpi);
+    void SetThreadCount(size_t threadCount);
+    void SetEncoderThreadCount(size_t encoderThreadCount);
+    void SetJournalFilename(const std::string& journalFilename);
+    void SetMapParameter(const MapParameter& mapParameter);
+    void SetAreaSearchParameter(const AreaSearchParameter& searchParameter);
+
+    inline size_t GetMetaTileSize() const
+    {
+      return metaTileSize;
+    }
+
+    inline size_t GetTileSize() const
+    {
+      return tileSize;
+    }
+
+    /**
+     * Render all tiles of the given zoom levels that intersect the bounding box.
+     * Returns false on errors or if rendering was aborted (using the breaker of
+     * the MapParameter), statistics are returned for all levels rendered.
+     */
+    bool Render(const GeoBox& boundingBox,
+                const MagnificationLevel& startLevel,
+                const MagnificationLevel& endLevel,
+                std::vector<LevelStatistics>& statistics);
+  };
+}
+
+#endif
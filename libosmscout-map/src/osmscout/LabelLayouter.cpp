@@ -19,38 +19,197 @@
 
 #include <osmscout/LabelLayouter.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace osmscout {
-  OSMSCOUT_MAP_API void Mask::prepare(const IntRectangle &rect)
+
+  LabelCollisionIndex::Box LabelCollisionIndex::CreateBox(const DoubleRectangle& rectangle)
+  {
+    Box box;
+
+    box.aabb=rectangle;
+
+    return box;
+  }
+
+  /**
+   * Creates a box for the given rectangle relative to origin, rotated
+   * clock-wise by angle (in radians) around origin.
+   */
+  LabelCollisionIndex::Box LabelCollisionIndex::CreateRotatedBox(const DoubleRectangle& rectangle,
+                                                                 const Vertex2D& origin,
+                                                                 double angle)
+  {
+    Box    box;
+    double localCenterX=rectangle.x+rectangle.width/2;
+    double localCenterY=rectangle.y+rectangle.height/2;
+
+    box.rotated=true;
+    box.cosA=std::cos(angle);
+    box.sinA=std::sin(angle);
+    box.halfWidth=rectangle.width/2;
+    box.halfHeight=rectangle.height/2;
+    box.centerX=origin.GetX()+localCenterX*box.cosA-localCenterY*box.sinA;
+    box.centerY=origin.GetY()+localCenterX*box.sinA+localCenterY*box.cosA;
+
+    double extentX=box.halfWidth*std::abs(box.cosA)+box.halfHeight*std::abs(box.sinA);
+    double extentY=box.halfWidth*std::abs(box.sinA)+box.halfHeight*std::abs(box.cosA);
+
+    box.aabb.Set(box.centerX-extentX,
+                 box.centerY-extentY,
+                 2*extentX,
+                 2*extentY);
+
+    return box;
+  }
+
+  /**
+   * Boxes just touching each other do not intersect.
+   */
+  bool LabelCollisionIndex::Intersects(const Box& a, const Box& b)
   {
-    // clear
-    for (int c = std::max(0, cellFrom); c <= std::min((int) d.size() - 1, cellTo); c++) {
-      d[c] = 0;
+    if (a.aabb.x>=b.aabb.x+b.aabb.width ||
+        b.aabb.x>=a.aabb.x+a.aabb.width ||
+        a.aabb.y>=b.aabb.y+b.aabb.height ||
+        b.aabb.y>=a.aabb.y+a.aabb.height) {
+      return false;
     }
 
-    // setup
-    cellFrom = rect.x / 64;
-    uint16_t cellFromBit = rect.x < 0 ? 0 : rect.x % 64;
-    int to = (rect.x + rect.width);
-    if (to < 0 || cellFrom >= (int)d.size())
-      return; // mask is outside viewport, keep it blank
-    cellTo = to / 64;
-    uint16_t cellToBit = (rect.x + rect.width) % 64;
-    if (cellToBit == 0){
-      cellTo --;
+    if (!a.rotated && !b.rotated) {
+      return true;
     }
 
-    rowFrom = rect.y;
-    rowTo = rect.y + rect.height;
+    // Separating axis test, the candidate axes are the edge normals of both boxes.
+    // An axis aligned box is handled as box without rotation.
+    double aCenterX=a.rotated ? a.centerX : a.aabb.x+a.aabb.width/2;
+    double aCenterY=a.rotated ? a.centerY : a.aabb.y+a.aabb.height/2;
+    double aHalfWidth=a.rotated ? a.halfWidth : a.aabb.width/2;
+    double aHalfHeight=a.rotated ? a.halfHeight : a.aabb.height/2;
+    double bCenterX=b.rotated ? b.centerX : b.aabb.x+b.aabb.width/2;
+    double bCenterY=b.rotated ? b.centerY : b.aabb.y+b.aabb.height/2;
+    double bHalfWidth=b.rotated ? b.halfWidth : b.aabb.width/2;
+    double bHalfHeight=b.rotated ? b.halfHeight : b.aabb.height/2;
+    double dx=bCenterX-aCenterX;
+    double dy=bCenterY-aCenterY;
+
+    const std::array<double,4> axisX{a.cosA,-a.sinA,b.cosA,-b.sinA};
+    const std::array<double,4> axisY{a.sinA,a.cosA,b.sinA,b.cosA};
 
-    constexpr uint64_t mask = ~0;
-    for (int c = std::max(0, cellFrom); c <= std::min((int) d.size() - 1, cellTo); c++) {
-      d[c] = mask;
+    for (size_t i=0; i<axisX.size(); i++) {
+      double distance=std::abs(dx*axisX[i]+dy*axisY[i]);
+      double aRadius=aHalfWidth*std::abs(a.cosA*axisX[i]+a.sinA*axisY[i])+
+                     aHalfHeight*std::abs(-a.sinA*axisX[i]+a.cosA*axisY[i]);
+      double bRadius=bHalfWidth*std::abs(b.cosA*axisX[i]+b.sinA*axisY[i])+
+                     bHalfHeight*std::abs(-b.sinA*axisX[i]+b.cosA*axisY[i]);
+
+      if (distance>=aRadius+bRadius) {
+        return false;
+      }
     }
-    if (cellFrom >= 0 && cellFrom < size() && cellFromBit > 0) {
-      d[cellFrom] = mask << cellFromBit;
+
+    return true;
+  }
+
+  /**
+   * Returns the range of cells covered by the rectangle, or false, if the
+   * rectangle is completely outside of the area.
+   */
+  bool LabelCollisionIndex::GetCellRange(const DoubleRectangle& rectangle,
+                                         int& columnFrom, int& columnTo,
+                                         int& rowFrom, int& rowTo) const
+  {
+    if (rectangle.x>=area.x+area.width ||
+        rectangle.y>=area.y+area.height ||
+        rectangle.x+rectangle.width<=area.x ||
+        rectangle.y+rectangle.height<=area.y) {
+      return false;
     }
-    if (cellTo >= 0 && cellTo < size() && cellToBit > 0) {
-      d[cellTo] = d[cellTo] & (mask >> (64 - cellToBit));
+
+    columnFrom=std::max(0,(int)std::floor((rectangle.x-area.x)/cellSize));
+    columnTo=std::min(columns-1,(int)std::floor((rectangle.x+rectangle.width-area.x)/cellSize));
+    rowFrom=std::max(0,(int)std::floor((rectangle.y-area.y)/cellSize));
+    rowTo=std::min(rows-1,(int)std::floor((rectangle.y+rectangle.height-area.y)/cellSize));
+
+    return true;
+  }
+
+  /**
+   * Removes all boxes and sets up the grid for the given area. Allocated
+   * memory is kept for the next layout.
+   */
+  void LabelCollisionIndex::Reset(const DoubleRectangle& area,
+                                  double cellSize)
+  {
+    this->area=area;
+    this->cellSize=std::max(1.0,cellSize);
+
+    columns=std::max(1,(int)std::ceil(area.width/this->cellSize));
+    rows=std::max(1,(int)std::ceil(area.height/this->cellSize));
+
+    boxes.clear();
+    boxStamps.clear();
+    queryStamp=0;
+
+    if (cells.size()>(size_t)(columns*rows)) {
+      cells.resize((size_t)(columns*rows));
+    }
+
+    for (auto& cell : cells) {
+      cell.clear();
+    }
+
+    cells.resize((size_t)(columns*rows));
+  }
+
+  bool LabelCollisionIndex::Intersects(const Box& box)
+  {
+    int columnFrom,columnTo,rowFrom,rowTo;
+
+    if (boxes.empty() ||
+        !GetCellRange(box.aabb,columnFrom,columnTo,rowFrom,rowTo)) {
+      return false;
+    }
+
+    // boxes covering multiple cells are tested only once per query
+    queryStamp++;
+
+    for (int row=rowFrom; row<=rowTo; row++) {
+      for (int column=columnFrom; column<=columnTo; column++) {
+        for (uint32_t index : cells[row*columns+column]) {
+          if (boxStamps[index]==queryStamp) {
+            continue;
+          }
+
+          boxStamps[index]=queryStamp;
+
+          if (Intersects(box,boxes[index])) {
+            return true;
+          }
+        }
+      }
+    }
+
+    return false;
+  }
+
+  void LabelCollisionIndex::Insert(const Box& box)
+  {
+    int columnFrom,columnTo,rowFrom,rowTo;
+
+    if (!GetCellRange(box.aabb,columnFrom,columnTo,rowFrom,rowTo)) {
+      return;
+    }
+
+    uint32_t index=(uint32_t)boxes.size();
+
+    boxes.push_back(box);
+    boxStamps.push_back(0);
+
+    for (int row=rowFrom; row<=rowTo; row++) {
+      for (int column=columnFrom; column<=columnTo; column++) {
+        cells[row*columns+column].push_back(index);
+      }
     }
   }
 }
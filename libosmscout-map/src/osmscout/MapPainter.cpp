@@ -19,7 +19,9 @@
 
 #include <osmscout/MapPainter.h>
 
+#include <atomic>
 #include <limits>
+#include <thread>
 
 #include <osmscout/system/Math.h>
 
@@ -39,6 +41,11 @@
 
 namespace osmscout {
 
+  /**
+   * Number of objects prepared as one unit of work by the threads of the parallel preparation
+   */
+  static const size_t PREPARE_CHUNK_SIZE=500;
+
   static void GetGridPoints(const std::vector<Point>& nodes,
                             double gridSizeHoriz,
                             double gridSizeVert,
@@ -182,6 +189,20 @@ namespace osmscout {
     return true;
   }
 
+  MapPainter::PrepareWorker::PrepareWorker()
+  : transBuffer(new CoordBuffer())
+  {
+    // no code
+  }
+
+  MapPainter::PrepareChunk::PrepareChunk()
+  : worker(0),
+    coordStart(0),
+    coordCount(0)
+  {
+    // no code
+  }
+
   MapPainter::MapPainter(const StyleConfigRef& styleConfig,
                          CoordBuffer *buffer)
   : coordBuffer(buffer),
@@ -1302,7 +1323,9 @@ namespace osmscout {
   void MapPainter::PrepareArea(const StyleConfig& styleConfig,
                                const Projection& projection,
                                const MapParameter& parameter,
-                               const AreaRef &area)
+                               const AreaRef &area,
+                               TransBuffer& transBuffer,
+                               std::list<AreaData>& areaData) const
   {
     std::vector<PolyData> td(area->rings.size());
 
@@ -1438,11 +1461,11 @@ namespace osmscout {
           }
 
           if (offset!=0.0) {
-            coordBuffer->GenerateParallelWay(transStart,
-                                             transEnd,
-                                             offset,
-                                             transStart,
-                                             transEnd);
+            transBuffer.buffer->GenerateParallelWay(transStart,
+                                                    transEnd,
+                                                    offset,
+                                                    transStart,
+                                                    transEnd);
           }
 
           a.ref=area->GetObjectFileRef();
@@ -1468,12 +1491,41 @@ namespace osmscout {
   {
     areaData.clear();
 
+    size_t threadCount=GetPrepareThreadCount(parameter,
+                                             data.areas.size());
+
     //Areas
-    for (const auto& area : data.areas) {
-      PrepareArea(styleConfig,
-                   projection,
-                   parameter,
-                   area);
+    if (threadCount>1) {
+      std::vector<PrepareChunk> chunks=PrepareParallel(parameter,
+                                                       data.areas.size(),
+                                                       threadCount,
+                                                       [this,&styleConfig,&projection,&parameter,&data](PrepareWorker& worker,
+                                                                                                        PrepareChunk& chunk,
+                                                                                                        size_t start,
+                                                                                                        size_t end) {
+        for (size_t i=start; i<end; i++) {
+          PrepareArea(styleConfig,
+                      projection,
+                      parameter,
+                      data.areas[i],
+                      worker.transBuffer,
+                      chunk.areaData);
+        }
+      });
+
+      for (auto& chunk : chunks) {
+        MergePrepareChunk(chunk);
+      }
+    }
+    else {
+      for (const auto& area : data.areas) {
+        PrepareArea(styleConfig,
+                    projection,
+                    parameter,
+                    area,
+                    transBuffer,
+                    areaData);
+      }
     }
 
     areaData.sort(AreaSorter);
@@ -1483,16 +1535,138 @@ namespace osmscout {
       PrepareArea(styleConfig,
                   projection,
                   parameter,
-                  area);
+                  area,
+                  transBuffer,
+                  areaData);
     }
   }
 
+  /**
+   * Return the number of threads to use for preparing the given number of objects
+   */
+  size_t MapPainter::GetPrepareThreadCount(const MapParameter& parameter,
+                                           size_t objectCount) const
+  {
+    size_t threadCount=parameter.GetPrepareThreadCount();
+
+    if (threadCount==0) {
+      threadCount=std::max(std::thread::hardware_concurrency(),1u);
+    }
+
+    // Each thread should at least get one chunk of objects
+    return std::max(std::min(threadCount,objectCount/PREPARE_CHUNK_SIZE),(size_t)1);
+  }
+
+  /**
+   * Prepare the objects in chunks of consecutive objects using the given number of
+   * threads (including the calling thread). Each thread uses its own transformation
+   * buffer, the result of each chunk is collected separately, so that merging the
+   * chunks in order results in the same order as preparing all objects sequentially.
+   */
+  std::vector<MapPainter::PrepareChunk> MapPainter::PrepareParallel(const MapParameter& parameter,
+                                                                    size_t objectCount,
+                                                                    size_t threadCount,
+                                                                    const PrepareFunction& prepare)
+  {
+    size_t                    chunkCount=(objectCount+PREPARE_CHUNK_SIZE-1)/PREPARE_CHUNK_SIZE;
+    std::vector<PrepareChunk> chunks(chunkCount);
+    std::atomic<size_t>       nextChunk(0);
+
+    while (prepareWorkers.size()<threadCount) {
+      prepareWorkers.push_back(std::unique_ptr<PrepareWorker>(new PrepareWorker()));
+    }
+
+    auto worker=[&](size_t workerIndex) {
+      PrepareWorker& data=*prepareWorkers[workerIndex];
+      size_t         index;
+
+      data.transBuffer.Reset();
+
+      while ((index=nextChunk++)<chunkCount) {
+        if (parameter.IsAborted()) {
+          return;
+        }
+
+        PrepareChunk& chunk=chunks[index];
+
+        chunk.worker=workerIndex;
+        chunk.coordStart=data.transBuffer.buffer->GetCoordCount();
+
+        prepare(data,
+                chunk,
+                index*PREPARE_CHUNK_SIZE,
+                std::min((index+1)*PREPARE_CHUNK_SIZE,objectCount));
+
+        chunk.coordCount=data.transBuffer.buffer->GetCoordCount()-chunk.coordStart;
+      }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (size_t i=1; i<threadCount; i++) {
+      threads.emplace_back(worker,i);
+    }
+
+    worker(0);
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    return chunks;
+  }
+
+  /**
+   * Copy the coordinates of the chunk into the coordinate buffer of the painter and
+   * append its data to the data of the painter
+   */
+  void MapPainter::MergePrepareChunk(PrepareChunk& chunk)
+  {
+    if (chunk.coordCount>0) {
+      size_t start=coordBuffer->PushCoords(*prepareWorkers[chunk.worker]->transBuffer.buffer,
+                                           chunk.coordStart,
+                                           chunk.coordCount);
+
+      auto relocate=[&chunk,start](size_t& index) {
+        index=index-chunk.coordStart+start;
+      };
+
+      for (auto& entry : chunk.areaData) {
+        relocate(entry.transStart);
+        relocate(entry.transEnd);
+
+        for (auto& clipping : entry.clippings) {
+          relocate(clipping.transStart);
+          relocate(clipping.transEnd);
+        }
+      }
+
+      for (auto& entry : chunk.wayData) {
+        relocate(entry.transStart);
+        relocate(entry.transEnd);
+      }
+
+      for (auto& entry : chunk.wayPathData) {
+        relocate(entry.transStart);
+        relocate(entry.transEnd);
+      }
+    }
+
+    areaData.splice(areaData.end(),chunk.areaData);
+    wayData.splice(wayData.end(),chunk.wayData);
+    wayPathData.splice(wayPathData.end(),chunk.wayPathData);
+  }
+
   void MapPainter::CalculatePaths(const StyleConfig& styleConfig,
                                   const Projection& projection,
                                   const MapParameter& parameter,
                                   const ObjectFileRef& ref,
                                   const FeatureValueBuffer& buffer,
-                                  const std::vector<Point>& nodes)
+                                  const std::vector<Point>& nodes,
+                                  TransBuffer& transBuffer,
+                                  std::vector<LineStyleRef>& lineStyles,
+                                  std::list<WayData>& wayData,
+                                  std::list<WayPathData>& wayPathData) const
   {
     styleConfig.GetWayLineStyles(buffer,
                                  projection,
@@ -1614,10 +1788,10 @@ namespace osmscout {
       }
 
       if (lineOffset!=0.0) {
-        coordBuffer->GenerateParallelWay(transStart,transEnd,
-                                         lineOffset,
-                                         data.transStart,
-                                         data.transEnd);
+        transBuffer.buffer->GenerateParallelWay(transStart,transEnd,
+                                                lineOffset,
+                                                data.transStart,
+                                                data.transEnd);
       }
       else {
         data.transStart=transStart;
@@ -1645,10 +1819,10 @@ namespace osmscout {
         double  laneOffset=-mainSlotWidth/2.0+lanesSpace;
 
         for (size_t lane=1; lane<lanes; lane++) {
-          coordBuffer->GenerateParallelWay(transStart,transEnd,
-                                           laneOffset,
-                                           data.transStart,
-                                           data.transEnd);
+          transBuffer.buffer->GenerateParallelWay(transStart,transEnd,
+                                                  laneOffset,
+                                                  data.transStart,
+                                                  data.transEnd);
           wayData.push_back(data);
           laneOffset+=lanesSpace;
         }
@@ -1669,19 +1843,65 @@ namespace osmscout {
     wayData.clear();
     wayPathData.clear();
 
-    for (const auto& way : data.ways) {
-      CalculatePaths(styleConfig,
-                     projection,
-                     parameter,
-                     ObjectFileRef(way->GetFileOffset(),
-                                   refWay),
-                     way->GetFeatureValueBuffer(),
-                     way->nodes);
+    size_t threadCount=GetPrepareThreadCount(parameter,
+                                             data.ways.size());
+
+    if (threadCount>1) {
+      std::vector<PrepareChunk> chunks=PrepareParallel(parameter,
+                                                       data.ways.size(),
+                                                       threadCount,
+                                                       [this,&styleConfig,&projection,&parameter,&data](PrepareWorker& worker,
+                                                                                                        PrepareChunk& chunk,
+                                                                                                        size_t start,
+                                                                                                        size_t end) {
+        for (size_t i=start; i<end; i++) {
+          const WayRef& way=data.ways[i];
+
+          CalculatePaths(styleConfig,
+                         projection,
+                         parameter,
+                         ObjectFileRef(way->GetFileOffset(),
+                                       refWay),
+                         way->GetFeatureValueBuffer(),
+                         way->nodes,
+                         worker.transBuffer,
+                         worker.lineStyles,
+                         chunk.wayData,
+                         chunk.wayPathData);
+        }
+      });
 
-      CalculateWayShieldLabels(styleConfig,
-                               projection,
-                               parameter,
-                               *way);
+      for (auto& chunk : chunks) {
+        MergePrepareChunk(chunk);
+      }
+
+      // Labels are registered by the drawing thread, in the same order as without threads
+      for (const auto& way : data.ways) {
+        CalculateWayShieldLabels(styleConfig,
+                                 projection,
+                                 parameter,
+                                 *way);
+      }
+    }
+    else {
+      for (const auto& way : data.ways) {
+        CalculatePaths(styleConfig,
+                       projection,
+                       parameter,
+                       ObjectFileRef(way->GetFileOffset(),
+                                     refWay),
+                       way->GetFeatureValueBuffer(),
+                       way->nodes,
+                       transBuffer,
+                       lineStyles,
+                       wayData,
+                       wayPathData);
+
+        CalculateWayShieldLabels(styleConfig,
+                                 projection,
+                                 parameter,
+                                 *way);
+      }
     }
 
     for (const auto& way : data.poiWays) {
@@ -1691,7 +1911,11 @@ namespace osmscout {
                      ObjectFileRef(way->GetFileOffset(),
                                    refWay),
                      way->GetFeatureValueBuffer(),
-                     way->nodes);
+                     way->nodes,
+                     transBuffer,
+                     lineStyles,
+                     wayData,
+                     wayPathData);
 
       CalculateWayShieldLabels(styleConfig,
                                projection,
@@ -55,7 +55,8 @@ namespace osmscout {
     debugPerformance(false),
     warnObjectCountLimit(0),
     warnCoordCountLimit(0),
-    showAltLanguage(false)
+    showAltLanguage(false),
+    prepareThreadCount(1)
   {
     // no code
   }
@@ -235,6 +236,11 @@ namespace osmscout {
     warnCoordCountLimit=limit;
   }
 
+  void MapParameter::SetPrepareThreadCount(size_t threadCount)
+  {
+    prepareThreadCount=threadCount;
+  }
+
   void MapParameter::SetBreaker(const BreakerRef& breaker)
   {
     this->breaker=breaker;
@@ -435,6 +435,7 @@ namespace osmscout {
         std::vector<AreaRef> areas;
 
         if (!database->GetAreasByBlockSpans(spans,
+                                            boundingBox,
                                             areas)) {
           log.Error() << "Error reading areas in area!";
           return false;
@@ -585,6 +586,7 @@ namespace osmscout {
         std::vector<WayRef> ways;
 
         if (!database->GetWaysByOffset(offsets,
+                                       boundingBox,
                                        ways)) {
           log.Error() << "Error reading ways in area!";
           return false;
@@ -21,6 +21,7 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <set>
 
 #include <sstream>
@@ -540,7 +541,7 @@ namespace osmscout {
   void SortInConditionals(const TypeConfig& typeConfig,
                           const std::list<ConditionalStyle<S,A> >& conditionals,
                           size_t maxLevel,
-                          std::vector<std::vector<std::list<StyleSelector<S,A> > > >& selectors)
+                          std::vector<std::vector<CompiledStyleSelectors<S,A> > >& selectors)
   {
     selectors.resize(typeConfig.GetTypeCount());
 
@@ -560,21 +561,23 @@ namespace osmscout {
         size_t maxLvl=conditional.filter.HasMaxLevel() ? conditional.filter.GetMaxLevel() : maxLevel;
 
         for (size_t level=minLvl; level<=maxLvl; level++) {
-          selectors[type->GetIndex()][level].push_back(selector);
+          selectors[type->GetIndex()][level].selectors.push_back(selector);
         }
       }
     }
 
-    for (auto& selector : selectors) {
-      for (size_t level=0; level<selector.size(); level++) {
-        if (selector[level].size()>=2) {
+    for (auto& typeSelectors : selectors) {
+      for (auto& levelSelectors : typeSelectors) {
+        std::list<StyleSelector<S,A> >& selector=levelSelectors.selectors;
+
+        if (selector.size()>=2) {
           // If two consecutive conditions are equal, one can be removed and the style can get merged
-          typename std::list<StyleSelector<S,A> >::iterator prevSelector=selector[level].begin();
+          typename std::list<StyleSelector<S,A> >::iterator prevSelector=selector.begin();
           typename std::list<StyleSelector<S,A> >::iterator curSelector=prevSelector;
 
           ++curSelector;
 
-          while (curSelector!=selector[level].end()) {
+          while (curSelector!=selector.end()) {
             if (prevSelector->criteria==curSelector->criteria) {
               prevSelector->attributes.insert(curSelector->attributes.begin(),
                                               curSelector->attributes.end());
@@ -582,7 +585,7 @@ namespace osmscout {
               prevSelector->style->CopyAttributes(*curSelector->style,
                                                   curSelector->attributes);
 
-              curSelector=selector[level].erase(curSelector);
+              curSelector=selector.erase(curSelector);
             }
             else {
               prevSelector=curSelector;
@@ -592,9 +595,99 @@ namespace osmscout {
         }
 
         // If there is only one conditional and it is not visible, we can remove it
-        if (selector[level].size()==1 &&
-            !selector[level].front().style->IsVisible()) {
-          selector[level].clear();
+        if (selector.size()==1 &&
+            !selector.front().style->IsVisible()) {
+          selector.clear();
+        }
+      }
+    }
+  }
+
+  /**
+   * Composes the style from the given selectors. The predicate decides for each
+   * selector (in order) if it matches. If only one selector matches, its style is
+   * returned directly, else a new style is composed. Composed styles that are
+   * not visible are dropped.
+   */
+  template <class S, class A, class P>
+  std::shared_ptr<S> ComposeStyle(const std::list<StyleSelector<S,A> >& selectors,
+                                  P matches)
+  {
+    bool               fastpath=false;
+    bool               composed=false;
+    std::shared_ptr<S> style;
+
+    for (const auto& selector : selectors) {
+      if (!matches(selector)) {
+        continue;
+      }
+
+      if (!style) {
+        style=selector.style;
+        fastpath=true;
+
+        continue;
+      }
+
+      if (fastpath) {
+        style=std::make_shared<S>(*style);
+        fastpath=false;
+      }
+
+      style->CopyAttributes(*selector.style,
+                            selector.attributes);
+      composed=true;
+    }
+
+    if (composed &&
+        !style->IsVisible()) {
+      style=nullptr;
+    }
+
+    return style;
+  }
+
+  /**
+   * Maximum number of selectors with criteria per type and level for which all
+   * combinations of matching selectors get composed in advance
+   */
+  static const size_t MAX_COMPOSED_CRITERIA=8;
+
+  template <class S, class A>
+  void ComposeSelectorStyles(std::vector<std::vector<CompiledStyleSelectors<S,A> > >& selectors)
+  {
+    for (auto& typeSelectors : selectors) {
+      for (auto& levelSelectors : typeSelectors) {
+        size_t criteriaCount=std::count_if(levelSelectors.selectors.begin(),
+                                           levelSelectors.selectors.end(),
+                                           [](const StyleSelector<S,A>& selector) -> bool {
+                                             return selector.criteria.HasCriteria();
+                                           });
+
+        levelSelectors.composedStyles.clear();
+
+        if (levelSelectors.selectors.empty() ||
+            criteriaCount>MAX_COMPOSED_CRITERIA) {
+          continue;
+        }
+
+        levelSelectors.composedStyles.resize((size_t)1 << criteriaCount);
+
+        for (size_t mask=0; mask<levelSelectors.composedStyles.size(); mask++) {
+          size_t bit=1;
+
+          levelSelectors.composedStyles[mask]=ComposeStyle(levelSelectors.selectors,
+                                                           [mask,&bit](const StyleSelector<S,A>& selector) -> bool {
+                                                             if (!selector.criteria.HasCriteria()) {
+                                                               return true;
+                                                             }
+
+                                                             bool matches=(mask & bit)!=0;
+
+                                                             bit<<=1;
+
+                                                             return matches;
+                                                           });
         }
       }
     }
@@ -846,7 +939,7 @@ namespace osmscout {
 
     for (auto& typeSelector : areaIconStyleSelectors) {
       for (auto& levelSelector : typeSelector) {
-        for (auto& selector : levelSelector) {
+        for (auto& selector : levelSelector.selectors) {
           if (!selector.style->GetIconName().empty()) {
             auto entry=symbolIdMap.find(selector.style->GetIconName());
 
@@ -867,7 +960,7 @@ namespace osmscout {
 
     for (auto& typeSelector: nodeIconStyleSelectors) {
       for (auto& levelSelector : typeSelector) {
-        for (auto& selector : levelSelector) {
+        for (auto& selector : levelSelector.selectors) {
           if (!selector.style->GetIconName().empty()) {
             auto entry=symbolIdMap.find(selector.style->GetIconName());
 
@@ -894,7 +987,7 @@ namespace osmscout {
 
     for (auto& typeSelector : areaFillStyleSelectors) {
       for (auto& levelSelector: typeSelector) {
-        for (auto& selector : levelSelector) {
+        for (auto& selector : levelSelector.selectors) {
           if (!selector.style->GetPatternName().empty()) {
             auto entry=symbolIdMap.find(selector.style->GetPatternName());
 
@@ -914,6 +1007,37 @@ namespace osmscout {
     }
   }
 
+  void StyleConfig::PostprocessComposedStyles()
+  {
+    for (auto& selectors : nodeTextStyleSelectors) {
+      ComposeSelectorStyles(selectors);
+    }
+
+    ComposeSelectorStyles(nodeIconStyleSelectors);
+
+    for (auto& selectors : wayLineStyleSelectors) {
+      ComposeSelectorStyles(selectors);
+    }
+
+    ComposeSelectorStyles(wayPathTextStyleSelectors);
+    ComposeSelectorStyles(wayPathSymbolStyleSelectors);
+    ComposeSelectorStyles(wayPathShieldStyleSelectors);
+
+    ComposeSelectorStyles(areaFillStyleSelectors);
+
+    for (auto& selectors : areaBorderStyleSelectors) {
+      ComposeSelectorStyles(selectors);
+    }
+
+    for (auto& selectors : areaTextStyleSelectors) {
+      ComposeSelectorStyles(selectors);
+    }
+
+    ComposeSelectorStyles(areaIconStyleSelectors);
+    ComposeSelectorStyles(areaBorderTextStyleSelectors);
+    ComposeSelectorStyles(areaBorderSymbolStyleSelectors);
+  }
+
   void StyleConfig::Postprocess()
   {
     PostprocessNodes();
@@ -922,6 +1046,9 @@ namespace osmscout {
 
     PostprocessIconId();
     PostprocessPatternId();
+
+    // Must be last, composed styles are copies of the selector styles
+    PostprocessComposedStyles();
   }
 
   TypeConfigRef StyleConfig::GetTypeConfig() const
@@ -1070,55 +1197,60 @@ namespace osmscout {
   /**
    * Get the style data based on the given features of an object,
    * a given style (S) and its style attributes (A).
+   *
+   * Only the criteria of the selectors are evaluated, the resulting style
+   * is then looked up in the styles composed during Postprocess().
    */
   template <class S, class A>
   std::shared_ptr<S> GetFeatureStyle(const StyleResolveContext& context,
-                                     const std::vector<std::list<StyleSelector<S,A> > >& styleSelectors,
+                                     const std::vector<CompiledStyleSelectors<S,A> >& styleSelectors,
                                      const FeatureValueBuffer& buffer,
                                      const Projection& projection)
   {
-    bool               fastpath=false;
-    bool               composed=false;
-    size_t             level=projection.GetMagnification().GetLevel();
-    double             meterInPixel=projection.GetMeterInPixel();
-    double             meterInMM=projection.GetMeterInMM();
-    std::shared_ptr<S> style;
+    size_t level=projection.GetMagnification().GetLevel();
 
     if (level>=styleSelectors.size()) {
       level=styleSelectors.size()-1;
     }
 
-    for (const auto& selector : styleSelectors[level]) {
-      if (!selector.criteria.Matches(context,
-                                     buffer,
-                                     meterInPixel,
-                                     meterInMM)) {
-        continue;
-      }
+    const CompiledStyleSelectors<S,A>& levelSelectors=styleSelectors[level];
 
-      if (!style) {
-        style=selector.style;
-        fastpath=true;
+    if (levelSelectors.selectors.empty()) {
+      return nullptr;
+    }
+
+    double meterInPixel=projection.GetMeterInPixel();
+    double meterInMM=projection.GetMeterInMM();
+
+    if (levelSelectors.composedStyles.empty()) {
+      return ComposeStyle(levelSelectors.selectors,
+                          [&context,&buffer,meterInPixel,meterInMM](const StyleSelector<S,A>& selector) -> bool {
+                            return selector.criteria.Matches(context,
+                                                             buffer,
+                                                             meterInPixel,
+                                                             meterInMM);
+                          });
+    }
+
+    size_t mask=0;
+    size_t bit=1;
 
+    for (const auto& selector : levelSelectors.selectors) {
+      if (!selector.criteria.HasCriteria()) {
         continue;
       }
 
-      if (fastpath) {
-        style=std::make_shared<S>(*style);
-        fastpath=false;
+      if (selector.criteria.Matches(context,
+                                    buffer,
+                                    meterInPixel,
+                                    meterInMM)) {
+        mask|=bit;
       }
 
-      style->CopyAttributes(*selector.style,
-                            selector.attributes);
-      composed=true;
-    }
-
-    if (composed &&
-        !style->IsVisible()) {
-      style=nullptr;
+      bit<<=1;
     }
 
-    return style;
+    return levelSelectors.composedStyles[mask];
   }
 
   bool StyleConfig::HasNodeTextStyles(const TypeInfoRef& type,
@@ -1131,7 +1263,7 @@ namespace osmscout {
         level=static_cast<uint32_t>(nodeTextStyleSelector[type->GetIndex()].size()-1);
       }
 
-      if (!nodeTextStyleSelector[type->GetIndex()][level].empty()) {
+      if (!nodeTextStyleSelector[type->GetIndex()][level].selectors.empty()) {
         return true;
       }
     }
@@ -1269,7 +1401,7 @@ namespace osmscout {
         level=static_cast<uint32_t>(areaTextStyleSelector[type->GetIndex()].size()-1);
       }
 
-      if (!areaTextStyleSelector[type->GetIndex()][level].empty()) {
+      if (!areaTextStyleSelector[type->GetIndex()][level].selectors.empty()) {
         return true;
       }
     }
@@ -1420,7 +1552,7 @@ namespace osmscout {
         l=slotEntry[type->GetIndex()].size()-1;
       }
 
-      for (const auto& selector : slotEntry[type->GetIndex()][l]) {
+      for (const auto& selector : slotEntry[type->GetIndex()][l].selectors) {
         selectors.push_back(selector);
       }
     }
@@ -1436,7 +1568,7 @@ namespace osmscout {
       level=areaFillStyleSelectors[type->GetIndex()].size()-1;
     }
 
-    for (const auto& selector : areaFillStyleSelectors[type->GetIndex()][level]) {
+    for (const auto& selector : areaFillStyleSelectors[type->GetIndex()][level].selectors) {
       selectors.push_back(selector);
     }
   }
@@ -1454,7 +1586,7 @@ namespace osmscout {
         l=slotEntry[type->GetIndex()].size()-1;
       }
 
-      for (const auto& selector : slotEntry[type->GetIndex()][l]) {
+      for (const auto& selector : slotEntry[type->GetIndex()][l].selectors) {
         selectors.push_back(selector);
       }
     }
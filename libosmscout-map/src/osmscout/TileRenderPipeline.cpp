@@ -0,0 +1,687 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/TileRenderPipeline.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <thread>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileWriter.h>
+#include <osmscout/util/Logger.h>
+#include <osmscout/util/StopClock.h>
+#include <osmscout/util/WorkQueue.h>
+
+namespace osmscout {
+
+  TileBitmap::TileBitmap()
+  : format(RGBA32),
+    width(0),
+    height(0)
+  {
+    // no code
+  }
+
+  void TileBitmap::Resize(PixelFormat format,
+                          size_t width,
+                          size_t height)
+  {
+    this->format=format;
+    this->width=width;
+    this->height=height;
+
+    pixels.assign(GetStride()*height,0);
+  }
+
+  MetaTileDrawer::~MetaTileDrawer()
+  {
+    // no code
+  }
+
+  TileEncoder::~TileEncoder()
+  {
+    // no code
+  }
+
+  std::string PPMTileEncoder::GetFileExtension() const
+  {
+    return "ppm";
+  }
+
+  bool PPMTileEncoder::Encode(const TileBitmap& bitmap,
+                              size_t x,
+                              size_t y,
+                              size_t width,
+                              size_t height,
+                              std::vector<char>& data) const
+  {
+    if (x+width>bitmap.GetWidth() ||
+        y+height>bitmap.GetHeight()) {
+      log.Error() << "Tile " << x << "," << y << " " << width << "x" << height << " is outside of the bitmap";
+      return false;
+    }
+
+    std::string header="P6 "+std::to_string(width)+" "+std::to_string(height)+" 255\n";
+    size_t      bytesPerPixel=bitmap.GetBytesPerPixel();
+
+    data.clear();
+    data.reserve(header.length()+width*height*3);
+    data.insert(data.end(),header.begin(),header.end());
+
+    for (size_t row=y; row<y+height; row++) {
+      const unsigned char* pixel=bitmap.GetRow(row)+x*bytesPerPixel;
+
+      if (bitmap.GetPixelFormat()==TileBitmap::RGB24) {
+        data.insert(data.end(),pixel,pixel+width*3);
+        continue;
+      }
+
+      for (size_t column=0; column<width; column++) {
+        data.push_back((char)pixel[0]);
+        data.push_back((char)pixel[1]);
+        data.push_back((char)pixel[2]);
+
+        pixel+=bytesPerPixel;
+      }
+    }
+
+    return true;
+  }
+
+  TileSink::~TileSink()
+  {
+    // no code
+  }
+
+  FileTileSink::FileTileSink(const std::string& directory,
+                             const std::string& extension)
+  : directory(directory),
+    extension(extension)
+  {
+    // no code
+  }
+
+  std::string FileTileSink::GetFilename(const MagnificationLevel& level,
+                                        const OSMTileId& tile) const
+  {
+    return AppendFileToDir(directory,
+                           std::to_string(level.Get())+"_"+
+                           std::to_string(tile.GetX())+"_"+
+                           std::to_string(tile.GetY())+"."+extension);
+  }
+
+  bool FileTileSink::StoreTile(const MagnificationLevel& level,
+                               const OSMTileId& tile,
+                               const std::vector<char>& data)
+  {
+    FileWriter writer;
+
+    try {
+      writer.Open(GetFilename(level,tile));
+      writer.Write(data.data(),data.size());
+      writer.Close();
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      writer.CloseFailsafe();
+      return false;
+    }
+
+    return true;
+  }
+
+  TileRenderPipeline::LevelStatistics::LevelStatistics()
+  : metaTileCount(0),
+    skippedMetaTiles(0),
+    tileCount(0),
+    failedTileCount(0),
+    seconds(0.0),
+    loadSeconds(0.0),
+    drawSeconds(0.0),
+    encodeSeconds(0.0)
+  {
+    // no code
+  }
+
+  /**
+   * A drawn metatile, waiting for its tiles to get encoded
+   */
+  struct TileRenderPipeline::MetaTile
+  {
+    OSMTileIdBox        box;
+    JournalEntry        journalEntry;
+    TileBitmapRef       bitmap;
+    std::atomic<size_t> remainingTiles;
+    std::atomic<bool>   failed;
+
+    MetaTile(const OSMTileIdBox& box,
+             const JournalEntry& journalEntry,
+             const TileBitmapRef& bitmap,
+             size_t tileCount)
+    : box(box),
+      journalEntry(journalEntry),
+      bitmap(bitmap),
+      remainingTiles(tileCount),
+      failed(false)
+    {
+      // no code
+    }
+  };
+
+  /**
+   * State shared by all threads while rendering one zoom level
+   */
+  struct TileRenderPipeline::LevelState
+  {
+    /**
+     * Metatiles of a drawing thread. The owner takes them from the front,
+     * other threads steal them from the back.
+     */
+    struct Queue
+    {
+      std::mutex                                       mutex;
+      std::deque<std::pair<OSMTileIdBox,JournalEntry>> metaTiles;
+    };
+
+    MagnificationLevel                  level;
+    Magnification                       magnification;
+    OSMTileIdBox                        tileBox;        //!< The tiles to store
+    std::vector<std::unique_ptr<Queue>> queues;
+    WorkQueue<bool>                     encoderQueue;
+
+    std::mutex                          statisticsMutex;
+    LevelStatistics&                    statistics;
+
+    LevelState(const MagnificationLevel& level,
+               const OSMTileIdBox& tileBox,
+               size_t encoderQueueLimit,
+               LevelStatistics& statistics)
+    : level(level),
+      magnification(level),
+      tileBox(tileBox),
+      encoderQueue(encoderQueueLimit),
+      statistics(statistics)
+    {
+      // no code
+    }
+
+    bool PopMetaTile(size_t worker,
+                     std::pair<OSMTileIdBox,JournalEntry>& metaTile)
+    {
+      {
+        Queue&                      queue=*queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.metaTiles.empty()) {
+          metaTile=queue.metaTiles.front();
+          queue.metaTiles.pop_front();
+
+          return true;
+        }
+      }
+
+      for (size_t i=1; i<queues.size(); i++) {
+        Queue&                      victim=*queues[(worker+i)%queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+
+        if (!victim.metaTiles.empty()) {
+          metaTile=victim.metaTiles.back();
+          victim.metaTiles.pop_back();
+
+          return true;
+        }
+      }
+
+      return false;
+    }
+  };
+
+  TileRenderPipeline::TileRenderPipeline(const MapServiceRef& mapService,
+                                         const StyleConfigRef& styleConfig,
+                                         const DrawerFactory& drawerFactory,
+                                         const TileEncoderRef& encoder,
+                                         const TileSinkRef& sink)
+  : mapService(mapService),
+    styleConfig(styleConfig),
+    drawerFactory(drawerFactory),
+    encoder(encoder),
+    sink(sink),
+    metaTileSize(8),
+    tileSize(256),
+    dpi(96.0),
+    threadCount(0),
+    encoderThreadCount(0)
+  {
+    // no code
+  }
+
+  void TileRenderPipeline::SetMetaTileSize(size_t metaTileSize)
+  {
+    this->metaTileSize=metaTileSize;
+  }
+
+  void TileRenderPipeline::SetTileSize(size_t tileSize)
+  {
+    this->tileSize=tileSize;
+  }
+
+  void TileRenderPipeline::SetDPI(double dpi)
+  {
+    this->dpi=dpi;
+  }
+
+  void TileRenderPipeline::SetThreadCount(size_t threadCount)
+  {
+    this->threadCount=threadCount;
+  }
+
+  void TileRenderPipeline::SetEncoderThreadCount(size_t encoderThreadCount)
+  {
+    this->encoderThreadCount=encoderThreadCount;
+  }
+
+  void TileRenderPipeline::SetJournalFilename(const std::string& journalFilename)
+  {
+    this->journalFilename=journalFilename;
+  }
+
+  void TileRenderPipeline::SetMapParameter(const MapParameter& mapParameter)
+  {
+    this->mapParameter=mapParameter;
+  }
+
+  void TileRenderPipeline::SetAreaSearchParameter(const AreaSearchParameter& searchParameter)
+  {
+    this->searchParameter=searchParameter;
+  }
+
+  bool TileRenderPipeline::LoadJournal()
+  {
+    std::lock_guard<std::mutex> lock(journalMutex);
+
+    journal.clear();
+
+    if (journalFilename.empty() ||
+        !ExistsInFilesystem(journalFilename)) {
+      return true;
+    }
+
+    std::ifstream file(journalFilename);
+
+    if (!file) {
+      log.Error() << "Cannot open journal '" << journalFilename << "'";
+      return false;
+    }
+
+    uint32_t level,column,row;
+
+    while (file >> level >> column >> row) {
+      journal.insert(JournalEntry(level,column,row));
+    }
+
+    if (!file.eof()) {
+      log.Error() << "Cannot parse journal '" << journalFilename << "'";
+      return false;
+    }
+
+    return true;
+  }
+
+  bool TileRenderPipeline::IsInJournal(const JournalEntry& entry)
+  {
+    std::lock_guard<std::mutex> lock(journalMutex);
+
+    return journal.find(entry)!=journal.end();
+  }
+
+  void TileRenderPipeline::AppendToJournal(const JournalEntry& entry)
+  {
+    if (journalFilename.empty()) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(journalMutex);
+    std::ofstream               file(journalFilename,std::ios::app);
+
+    file << std::get<0>(entry) << " " << std::get<1>(entry) << " " << std::get<2>(entry) << std::endl;
+
+    if (!file) {
+      log.Error() << "Cannot write journal '" << journalFilename << "'";
+      return;
+    }
+
+    journal.insert(entry);
+  }
+
+  bool TileRenderPipeline::LoadData(const TileProjection& projection,
+                                    MapData& data) const
+  {
+    std::list<TileRef> tiles;
+
+    mapService->LookupTiles(projection,
+                            tiles);
+
+    if (!mapService->LoadMissingTileData(searchParameter,
+                                         *styleConfig,
+                                         tiles)) {
+      return false;
+    }
+
+    mapService->AddTileDataToMapData(tiles,
+                                     data);
+
+    if (mapParameter.GetRenderSeaLand()) {
+      mapService->GetGroundTiles(projection,
+                                 data.groundTiles);
+    }
+
+    return true;
+  }
+
+  void TileRenderPipeline::RenderMetaTile(MetaTileDrawer& drawer,
+                                          LevelState& state,
+                                          const OSMTileIdBox& box)
+  {
+    JournalEntry           journalEntry(state.level.Get(),
+                                        box.GetMinX()/metaTileSize,
+                                        box.GetMinY()/metaTileSize);
+    std::vector<OSMTileId> tiles;
+
+    for (const auto& tile : box) {
+      if (tile.GetX()>=state.tileBox.GetMinX() &&
+          tile.GetX()<=state.tileBox.GetMaxX() &&
+          tile.GetY()>=state.tileBox.GetMinY() &&
+          tile.GetY()<=state.tileBox.GetMaxY()) {
+        tiles.push_back(tile);
+      }
+    }
+
+    TileProjection projection;
+    MapData        data;
+    TileBitmapRef  bitmap=std::make_shared<TileBitmap>();
+    size_t         width=box.GetWidth()*tileSize;
+    size_t         height=box.GetHeight()*tileSize;
+    bool           success=projection.Set(box,
+                                          state.magnification,
+                                          dpi,
+                                          width,
+                                          height);
+
+    StopClock loadTimer;
+
+    success=success && LoadData(projection,
+                                data);
+
+    loadTimer.Stop();
+
+    StopClock drawTimer;
+
+    success=success && drawer.DrawMetaTile(projection,
+                                           mapParameter,
+                                           data,
+                                           *bitmap);
+
+    drawTimer.Stop();
+
+    if (success &&
+        (bitmap->GetWidth()!=width || bitmap->GetHeight()!=height)) {
+      log.Error() << "Bitmap of metatile " << box.GetDisplayText() << " has wrong size "
+                  << bitmap->GetWidth() << "x" << bitmap->GetHeight();
+      success=false;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(state.statisticsMutex);
+
+      state.statistics.loadSeconds+=loadTimer.GetMilliseconds()/1000.0;
+      state.statistics.drawSeconds+=drawTimer.GetMilliseconds()/1000.0;
+
+      if (success) {
+        state.statistics.metaTileCount++;
+      }
+      else {
+        state.statistics.failedTileCount+=tiles.size();
+      }
+    }
+
+    if (!success) {
+      log.Error() << "Cannot draw metatile " << box.GetDisplayText() << " of level " << state.level.Get();
+      return;
+    }
+
+    std::shared_ptr<MetaTile> metaTile=std::make_shared<MetaTile>(box,
+                                                                  journalEntry,
+                                                                  bitmap,
+                                                                  tiles.size());
+
+    // Release the data, before waiting for the encoders
+    data.ClearDBData();
+
+    for (const auto& tile : tiles) {
+      std::packaged_task<bool()> task([this,&state,metaTile,tile] {
+        EncodeTile(state,
+                   metaTile,
+                   tile);
+
+        return true;
+      });
+
+      state.encoderQueue.PushTask(task);
+    }
+  }
+
+  void TileRenderPipeline::EncodeTile(LevelState& state,
+                                      const std::shared_ptr<MetaTile>& metaTile,
+                                      const OSMTileId& tile)
+  {
+    StopClock         timer;
+    std::vector<char> data;
+    bool              success=encoder->Encode(*metaTile->bitmap,
+                                              (tile.GetX()-metaTile->box.GetMinX())*tileSize,
+                                              (tile.GetY()-metaTile->box.GetMinY())*tileSize,
+                                              tileSize,
+                                              tileSize,
+                                              data) &&
+                              sink->StoreTile(state.level,
+                                              tile,
+                                              data);
+
+    timer.Stop();
+
+    {
+      std::lock_guard<std::mutex> lock(state.statisticsMutex);
+
+      state.statistics.encodeSeconds+=timer.GetMilliseconds()/1000.0;
+
+      if (success) {
+        state.statistics.tileCount++;
+      }
+      else {
+        state.statistics.failedTileCount++;
+      }
+    }
+
+    if (!success) {
+      log.Error() << "Cannot encode or store tile " << tile.GetDisplayText() << " of level " << state.level.Get();
+      metaTile->failed=true;
+    }
+
+    if (metaTile->remainingTiles.fetch_sub(1)==1 &&
+        !metaTile->failed) {
+      AppendToJournal(metaTile->journalEntry);
+    }
+  }
+
+  bool TileRenderPipeline::RenderLevel(const MagnificationLevel& level,
+                                       const GeoBox& boundingBox,
+                                       size_t threadCount,
+                                       LevelStatistics& statistics)
+  {
+    Magnification magnification(level);
+    OSMTileIdBox  tileBox(OSMTileId::GetOSMTile(magnification,
+                                                boundingBox.GetMinCoord()),
+                          OSMTileId::GetOSMTile(magnification,
+                                                boundingBox.GetMaxCoord()));
+    uint32_t      maxTile=(uint32_t)(magnification.GetMagnification()-1);
+    uint32_t      size=(uint32_t)metaTileSize;
+    std::vector<std::pair<OSMTileIdBox,JournalEntry>> metaTiles;
+
+    statistics.level=level;
+
+    for (uint32_t row=tileBox.GetMinY()/size; row<=tileBox.GetMaxY()/size; row++) {
+      for (uint32_t column=tileBox.GetMinX()/size; column<=tileBox.GetMaxX()/size; column++) {
+        JournalEntry journalEntry(level.Get(),column,row);
+
+        if (IsInJournal(journalEntry)) {
+          statistics.skippedMetaTiles++;
+          continue;
+        }
+
+        metaTiles.emplace_back(OSMTileIdBox(OSMTileId(column*size,
+                                                      row*size),
+                                            OSMTileId(std::min(column*size+size-1,maxTile),
+                                                      std::min(row*size+size-1,maxTile))),
+                               journalEntry);
+      }
+    }
+
+    threadCount=std::max(std::min(threadCount,metaTiles.size()),(size_t)1);
+
+    size_t     encoderThreads=encoderThreadCount>0 ? encoderThreadCount : std::max(std::thread::hardware_concurrency(),1u);
+    LevelState state(level,
+                     tileBox,
+                     encoderThreads*metaTileSize*metaTileSize,
+                     statistics);
+
+    // Contiguous blocks of metatiles, so each thread works in its own region of the map
+    size_t blockSize=(metaTiles.size()+threadCount-1)/threadCount;
+
+    for (size_t i=0; i<threadCount; i++) {
+      state.queues.push_back(std::unique_ptr<LevelState::Queue>(new LevelState::Queue()));
+
+      for (size_t m=i*blockSize; m<std::min((i+1)*blockSize,metaTiles.size()); m++) {
+        state.queues.back()->metaTiles.push_back(metaTiles[m]);
+      }
+    }
+
+    StopClock                levelTimer;
+    std::vector<std::thread> encoderWorkers;
+    std::atomic<bool>        drawerFailed(false);
+
+    for (size_t i=0; i<encoderThreads; i++) {
+      encoderWorkers.emplace_back([&state] {
+        std::packaged_task<bool()> task;
+
+        while (state.encoderQueue.PopTask(task)) {
+          task();
+        }
+      });
+    }
+
+    auto worker=[this,&state,&drawerFailed](size_t index) {
+      MetaTileDrawerRef drawer=drawerFactory();
+
+      if (!drawer) {
+        log.Error() << "Cannot create drawer for metatiles";
+        drawerFailed=true;
+        return;
+      }
+
+      std::pair<OSMTileIdBox,JournalEntry> metaTile(OSMTileIdBox(OSMTileId(0,0),OSMTileId(0,0)),
+                                                    JournalEntry(0,0,0));
+
+      while (!mapParameter.IsAborted() &&
+             state.PopMetaTile(index,metaTile)) {
+        RenderMetaTile(*drawer,
+                       state,
+                       metaTile.first);
+      }
+    };
+
+    std::vector<std::thread> workers;
+
+    for (size_t i=1; i<threadCount; i++) {
+      workers.emplace_back(worker,i);
+    }
+
+    worker(0);
+
+    for (auto& thread : workers) {
+      thread.join();
+    }
+
+    state.encoderQueue.Stop();
+
+    for (auto& thread : encoderWorkers) {
+      thread.join();
+    }
+
+    levelTimer.Stop();
+
+    statistics.seconds=levelTimer.GetMilliseconds()/1000.0;
+
+    return !drawerFailed &&
+           !mapParameter.IsAborted() &&
+           statistics.failedTileCount==0;
+  }
+
+  bool TileRenderPipeline::Render(const GeoBox& boundingBox,
+                                  const MagnificationLevel& startLevel,
+                                  const MagnificationLevel& endLevel,
+                                  std::vector<LevelStatistics>& statistics)
+  {
+    statistics.clear();
+
+    if (metaTileSize==0 ||
+        tileSize==0) {
+      log.Error() << "Metatile size and tile size must not be 0";
+      return false;
+    }
+
+    if (!LoadJournal()) {
+      return false;
+    }
+
+    size_t threads=threadCount>0 ? threadCount : std::max(std::thread::hardware_concurrency(),1u);
+    bool   success=true;
+
+    for (MagnificationLevel level=std::min(startLevel,endLevel);
+         level<=std::max(startLevel,endLevel);
+         level++) {
+      statistics.push_back(LevelStatistics());
+
+      if (!RenderLevel(level,
+                       boundingBox,
+                       threads,
+                       statistics.back())) {
+        success=false;
+      }
+
+      if (mapParameter.IsAborted()) {
+        return false;
+      }
+    }
+
+    return success;
+  }
+}
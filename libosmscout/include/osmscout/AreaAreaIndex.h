@@ -28,7 +28,7 @@
 
 #include <osmscout/TypeInfoSet.h>
 
-#include <osmscout/util/Cache.h>
+#include <osmscout/util/ClockCache.h>
 #include <osmscout/util/Geometry.h>
 #include <osmscout/util/FileScanner.h>
 
@@ -63,7 +63,7 @@ namespace osmscout {
       FileOffset data;        //!< The file index at which the data payload starts
     };
 
-    typedef Cache<FileOffset,IndexCell> IndexCache;
+    typedef ClockCache<FileOffset,IndexCell> IndexCache;
 
     struct IndexCacheValueSizer : public IndexCache::ValueSizer
     {
@@ -101,6 +101,7 @@ namespace osmscout {
     uint32_t              maxLevel;       //!< Maximum level in index
     FileOffset            topLevelOffset; //!< File offset of the top level index entry
 
+    IndexCacheValueSizer  indexCacheSizer; //!< Sizer for the entries of the index cache
     mutable IndexCache    indexCache;     //!< Cached map of all index entries by file offset
 
     mutable std::mutex    lookupMutex;
@@ -131,7 +132,9 @@ namespace osmscout {
     virtual ~AreaAreaIndex();
 
     void Close();
-    bool Open(const std::string& path, bool memoryMappedData);
+    bool Open(const std::string& path,
+              bool memoryMappedData,
+              const MmapPolicy& mmapPolicy=MmapPolicy());
 
     inline bool IsOpen() const
     {
@@ -23,6 +23,7 @@
 #include <memory>
 
 #include <osmscout/Area.h>
+#include <osmscout/AreaView.h>
 #include <osmscout/DataFile.h>
 
 namespace osmscout {
@@ -36,10 +37,73 @@ namespace osmscout {
     static const char* AREAS_DAT;
     static const char* AREAS_IDMAP;
 
+  protected:
+    bool ReadBoundingBox(FileScanner& scanner,
+                         GeoBox& boundingBox) const override;
+
   public:
-    AreaDataFile(size_t cacheSize);
+    AreaDataFile(size_t cacheSize,
+                 size_t cacheMemory=0);
+
+    template<typename IteratorIn>
+    bool GetViewsByBlockSpans(IteratorIn begin, IteratorIn end,
+                              std::vector<AreaView>& views,
+                              std::vector<AreaView::Ring>& rings) const;
+
+    bool GetFeatures(const AreaView::Ring& ring,
+                     FeatureValueBuffer& buffer) const;
   };
 
+  /**
+   * Read views of the areas in the given DataBlockSpans and append them to the given vector,
+   * their rings are appended to the given ring vector. The views are not cached and point
+   * into the memory mapping of the data file, so they are only valid as long as the data file
+   * is open and the ring vector is not modified.
+   *
+   * Returns false, if the data file is not memory mapped.
+   *
+   * Method is thread-safe.
+   */
+  template<typename IteratorIn>
+  bool AreaDataFile::GetViewsByBlockSpans(IteratorIn begin, IteratorIn end,
+                                          std::vector<AreaView>& views,
+                                          std::vector<AreaView::Ring>& rings) const
+  {
+    ScannerLease scanner(*this);
+
+    if (!scanner.IsValid()) {
+      return false;
+    }
+
+    if (!(*scanner).IsMemoryMapped()) {
+      log.Error() << "Cannot create area views, '" << GetFilename() << "' is not memory mapped";
+      return false;
+    }
+
+    try {
+      for (IteratorIn spanIter=begin; spanIter!=end; ++spanIter) {
+        if (spanIter->count==0) {
+          continue;
+        }
+
+        (*scanner).SetPos(spanIter->startOffset);
+
+        for (uint32_t i=1; i<=spanIter->count; i++) {
+          views.emplace_back();
+          views.back().Read(*typeConfig,
+                            *scanner,
+                            rings);
+        }
+      }
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      return false;
+    }
+
+    return true;
+  }
+
   typedef std::shared_ptr<AreaDataFile> AreaDataFileRef;
 }
 
@@ -91,7 +91,8 @@ namespace osmscout {
 
     void Close();
     bool Open(const std::string& path,
-              bool memoryMappedData);
+              bool memoryMappedData,
+              const MmapPolicy& mmapPolicy=MmapPolicy());
 
     inline bool IsOpen() const
     {
@@ -0,0 +1,156 @@
+#ifndef OSMSCOUT_AREAVIEW_H
+#define OSMSCOUT_AREAVIEW_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <vector>
+
+#include <osmscout/Area.h>
+#include <osmscout/ObjectRef.h>
+#include <osmscout/PointArrayView.h>
+#include <osmscout/TypeConfig.h>
+
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/GeoBox.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  class AreaDataFile;
+
+  /**
+   * \ingroup Database
+   *
+   * Lightweight, read-only view of an area in the memory mapped 'areas.dat' file.
+   *
+   * In contrast to Area, reading an AreaView does not allocate memory per area: Features
+   * are skipped and only decoded on request (see AreaDataFile::GetFeatures()), the nodes of each ring are a PointArrayView
+   * into the memory mapping and the rings themselves are appended to a ring vector
+   * passed by the caller, which can be shared by all views of one request.
+   *
+   * An AreaView is only valid as long as the AreaDataFile it was read from is open and
+   * the ring vector is neither modified nor destroyed.
+   */
+  class OSMSCOUT_API AreaView CLASS_FINAL
+  {
+  public:
+    /**
+     * View of one ring of the area
+     */
+    class OSMSCOUT_API Ring CLASS_FINAL
+    {
+    private:
+      TypeInfoRef    type;          //!< Type of the ring
+      FileOffset     featureOffset; //!< Offset of the features of this ring
+      uint8_t        ring;          //!< The ring hierarchy number (0...n)
+      bool           firstRing;     //!< First ring of the area, features include the area flags
+
+    public:
+      PointArrayView nodes;         //!< The array of coordinates
+
+    public:
+      Ring();
+
+      inline TypeInfoRef GetType() const
+      {
+        return type;
+      }
+
+      inline uint8_t GetRing() const
+      {
+        return ring;
+      }
+
+      inline bool IsMasterRing() const
+      {
+        return ring==Area::masterRingId;
+      }
+
+      inline bool IsOuterRing() const
+      {
+        return ring==Area::outerRingId;
+      }
+
+      inline GeoBox GetBoundingBox() const
+      {
+        return nodes.GetBoundingBox();
+      }
+
+    private:
+      void ReadFeatures(FileScanner& scanner,
+                        FeatureValueBuffer& buffer) const;
+
+      friend class AreaView;
+      friend class AreaDataFile;
+    };
+
+  private:
+    FileOffset              fileOffset;     //!< Offset into the data file of this area
+    FileOffset              nextFileOffset; //!< Offset after this area
+    const std::vector<Ring> *ringBuffer;    //!< Vector holding the rings of this area
+    size_t                  firstRing;      //!< Index of the first ring of this area in the ring vector
+    size_t                  ringCount;      //!< Number of rings of this area
+
+  public:
+    AreaView();
+
+    inline FileOffset GetFileOffset() const
+    {
+      return fileOffset;
+    }
+
+    inline FileOffset GetNextFileOffset() const
+    {
+      return nextFileOffset;
+    }
+
+    inline ObjectFileRef GetObjectFileRef() const
+    {
+      return {fileOffset,refArea};
+    }
+
+    inline TypeInfoRef GetType() const
+    {
+      return GetRing(0).GetType();
+    }
+
+    inline size_t GetRingCount() const
+    {
+      return ringCount;
+    }
+
+    inline const Ring& GetRing(size_t index) const
+    {
+      return (*ringBuffer)[firstRing+index];
+    }
+
+    GeoBox GetBoundingBox() const;
+
+    void Read(const TypeConfig& typeConfig,
+              FileScanner& scanner,
+              std::vector<Ring>& rings);
+
+    static GeoBox ReadBoundingBox(const TypeConfig& typeConfig,
+                                  FileScanner& scanner);
+  };
+}
+
+#endif
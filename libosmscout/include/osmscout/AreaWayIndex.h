@@ -94,7 +94,8 @@ namespace osmscout {
     void Close();
     bool Open(const TypeConfigRef& typeConfig,
               const std::string& path,
-              bool memoryMappedData);
+              bool memoryMappedData,
+              const MmapPolicy& mmapPolicy=MmapPolicy());
 
     inline bool IsOpen() const
     {
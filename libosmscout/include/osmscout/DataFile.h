@@ -20,16 +20,19 @@
   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 */
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <osmscout/NumericIndex.h>
 #include <osmscout/TypeConfig.h>
 
-#include <osmscout/util/Cache.h>
+#include <osmscout/util/ClockCache.h>
 #include <osmscout/util/FileScanner.h>
 #include <osmscout/util/Logger.h>
 
@@ -67,26 +70,98 @@ namespace osmscout {
    * Access to standard format data files.
    *
    * Allows to load data objects by offset using various standard library data structures.
+   *
+   * Reading is thread-safe and concurrent reads from different threads do not block each
+   * other: Every reading call leases its own FileScanner from a pool of scanners (growing
+   * on demand up to the number of concurrent readers, all sharing the memory mapping of
+   * the data file, if it is memory mapped) and the object cache is split into
+   * a number of shards, each protected by its own mutex, which is only held during the
+   * cache lookup or update - never while reading from the file.
+   *
+   * The object cache (see ShardedCache) is limited by its number of entries and optionally
+   * by the memory of the cached objects.
+   *
+   * Loading a number of objects by offset is done in batches: Offsets of objects not in the
+   * cache are sorted and deduplicated, neighbouring objects (not more than the batch read
+   * window apart) are merged into one range, which is prefetched as a whole (see
+   * FileScanner::Prefetch()), and then the objects are read in file order. The result is
+   * still returned in the order requested by the caller. This turns random seeks into mostly
+   * sequential reads, which especially helps if the data file is not memory mapped.
+   *
+   * Block compressed data files (see BlockCompression) are read transparently. All scanners
+   * of the pool share one cache of decompressed blocks.
    */
   template <class N>
   class DataFile
   {
   public:
     typedef std::shared_ptr<N> ValueType;
-    typedef Cache<FileOffset,std::shared_ptr<N>> ValueCache;
+    typedef ShardedCache<FileOffset,ValueType> ValueCache;
+    typedef typename ValueCache::ValueSizer ValueSizer;
 
-    typedef typename Cache<FileOffset,ValueType>::CacheEntry ValueCacheEntry;
-    typedef typename Cache<FileOffset,ValueType>::CacheRef ValueCacheRef;
+    static const size_t CACHE_SHARD_COUNT=16;                 //!< Number of independently locked cache shards
+    static const size_t DEFAULT_BATCH_READ_WINDOW=64*1024;    //!< Default for the batch read window
+    static const size_t BATCH_READ_TAIL=4096;                 //!< Bytes prefetched behind the last object of a range
+    static const size_t BLOCK_CACHE_SIZE=64;                  //!< Number of decompressed blocks cached for block compressed files
 
   private:
-    std::string         datafile;        //!< Basename part of the data file name
-    std::string         datafilename;    //!< complete filename for data file
+    typedef std::unique_ptr<FileScanner> FileScannerRef;
+    typedef std::pair<FileOffset,size_t> ReadRequest;         //!< Offset of an object and its index in the result
 
-    mutable ValueCache  cache;
+  protected:
+    /**
+     * Exclusive, scoped usage of one FileScanner of the scanner pool
+     */
+    class ScannerLease
+    {
+    private:
+      const DataFile<N>& dataFile;
+      FileScanner*       scanner;
+
+    public:
+      explicit ScannerLease(const DataFile<N>& dataFile)
+      : dataFile(dataFile),
+        scanner(dataFile.AcquireScanner())
+      {
+        // no code
+      }
 
-    mutable FileScanner scanner;         //!< File stream to the data file
+      ScannerLease(const ScannerLease& other) = delete;
+      ScannerLease& operator=(const ScannerLease& other) = delete;
 
-    mutable std::mutex  accessMutex;     //!< Mutex to secure multi-thread access
+      ~ScannerLease()
+      {
+        if (scanner!=nullptr) {
+          dataFile.ReleaseScanner(scanner);
+        }
+      }
+
+      inline bool IsValid() const
+      {
+        return scanner!=nullptr;
+      }
+
+      inline FileScanner& operator*() const
+      {
+        return *scanner;
+      }
+    };
+
+  private:
+    std::string                         datafile;          //!< Basename part of the data file name
+    std::string                         datafilename;      //!< complete filename for data file
+    bool                                memoryMappedData;  //!< Open scanners with mmap support
+    MmapPolicy                          mmapPolicy;        //!< Policy for memory mapping the data file
+    size_t                              batchReadWindow;   //!< Maximum gap between objects merged into one read range, 0 disables batching
+
+    ValueCache                          cache;             //!< Object cache, split into shards
+    BlockDataCacheRef                   blockCache;        //!< Cache of decompressed blocks, if the file is block compressed
+
+    FileScanner                         scanner;           //!< Primary file stream to the data file
+
+    mutable std::mutex                  scannerMutex;      //!< Mutex to secure access to the scanner pool
+    mutable std::vector<FileScannerRef> scannerPool;       //!< Additional scanners, owned by the pool
+    mutable std::vector<FileScanner*>   idleScanners;      //!< Scanners currently not leased by any reader
 
   protected:
     TypeConfigRef       typeConfig;
@@ -100,14 +175,34 @@ namespace osmscout {
                   FileOffset offset,
                   N& data) const;
 
+    void PrefetchBatch(FileScanner& scanner,
+                       const std::vector<ReadRequest>& requests) const;
+    void FilterBatch(FileScanner& scanner,
+                     const GeoBox& boundingBox,
+                     std::vector<ReadRequest>& requests) const;
+    bool ReadDataBatch(FileScanner& scanner,
+                       std::vector<ReadRequest>& requests,
+                       std::vector<ValueType>& data) const;
+
+    FileScanner* AcquireScanner() const;
+    void ReleaseScanner(FileScanner* scanner) const;
+
+  protected:
+    virtual bool ReadBoundingBox(FileScanner& scanner,
+                                 GeoBox& boundingBox) const;
+
   public:
-    DataFile(const std::string& datafile, size_t cacheSize);
+    DataFile(const std::string& datafile,
+             size_t cacheSize,
+             size_t cacheMemory=0,
+             const ValueSizer* cacheSizer=nullptr);
 
     virtual ~DataFile();
 
     bool Open(const TypeConfigRef& typeConfig,
               const std::string& path,
-              bool memoryMappedData);
+              bool memoryMappedData,
+              const MmapPolicy& mmapPolicy=MmapPolicy());
     virtual bool IsOpen() const;
     virtual bool Close();
 
@@ -116,6 +211,28 @@ namespace osmscout {
       return datafilename;
     }
 
+    /**
+     * Returns true, if the data file is memory mapped
+     */
+    inline bool IsMemoryMapped() const
+    {
+      return scanner.IsMemoryMapped();
+    }
+
+    inline CacheStatistics GetCacheStatistics() const
+    {
+      return cache.GetStatistics();
+    }
+
+    void SetBatchReadWindow(size_t batchReadWindow);
+
+    inline size_t GetBatchReadWindow() const
+    {
+      return batchReadWindow;
+    }
+
+    void DumpStatistics() const;
+
     bool GetByOffset(FileOffset offset,
                      ValueType& entry) const;
 
@@ -138,11 +255,31 @@ namespace osmscout {
     template<typename IteratorIn>
     bool GetByBlockSpans(IteratorIn begin, IteratorIn end,
                          std::vector<ValueType>& data) const;
+
+    template<typename IteratorIn>
+    bool GetByBlockSpans(IteratorIn begin, IteratorIn end,
+                         const GeoBox& boundingBox,
+                         std::vector<ValueType>& data) const;
   };
 
+  /**
+   * Create a data file with an object cache of the given number of entries.
+   * If cacheMemory is not 0, the cache is additionally limited by the memory
+   * of the cached objects, as calculated by the given cacheSizer (which must
+   * outlive the data file).
+   */
   template <class N>
-  DataFile<N>::DataFile(const std::string& datafile, size_t cacheSize)
-  : datafile(datafile),cache(cacheSize)
+  DataFile<N>::DataFile(const std::string& datafile,
+                        size_t cacheSize,
+                        size_t cacheMemory,
+                        const ValueSizer* cacheSizer)
+  : datafile(datafile),
+    memoryMappedData(false),
+    batchReadWindow(DEFAULT_BATCH_READ_WINDOW),
+    cache(cacheSize,
+          CACHE_SHARD_COUNT,
+          cacheMemory,
+          cacheSizer)
   {
     // no code
   }
@@ -155,6 +292,34 @@ namespace osmscout {
     }
   }
 
+  /**
+   * Set the maximum gap in bytes between two objects, which are still merged into
+   * one range when reading a batch of objects by offset. Passing 0 disables batched
+   * reading, objects are then read one by one in the order requested.
+   *
+   * Method is NOT thread-safe.
+   */
+  template <class N>
+  void DataFile<N>::SetBatchReadWindow(size_t batchReadWindow)
+  {
+    this->batchReadWindow=batchReadWindow;
+  }
+
+  /**
+   * Dump statistics of the object cache to the debug log.
+   *
+   * Method is thread-safe.
+   */
+  template <class N>
+  void DataFile<N>::DumpStatistics() const
+  {
+    cache.DumpStatistics(datafile.c_str());
+
+    if (blockCache) {
+      blockCache->DumpStatistics((datafile+" blocks").c_str());
+    }
+  }
+
   /**
    * Read one data value from the given file offset.
    *
@@ -203,23 +368,258 @@ namespace osmscout {
   }
 
   /**
-   * Open the index file.
+   * Merge the given (sorted) read requests into ranges, where neighbouring objects are
+   * not more than the batch read window apart, and prefetch each range.
+   *
+   * Method is thread-safe.
+   */
+  template <class N>
+  void DataFile<N>::PrefetchBatch(FileScanner& scanner,
+                                  const std::vector<ReadRequest>& requests) const
+  {
+    if (requests.size()<2) {
+      return;
+    }
+
+    FileOffset rangeStart=requests.front().first;
+    FileOffset rangeEnd=rangeStart;
+
+    for (const auto& request : requests) {
+      if (request.first-rangeEnd>batchReadWindow) {
+        scanner.Prefetch(rangeStart,
+                         (size_t)(rangeEnd-rangeStart)+BATCH_READ_TAIL);
+
+        rangeStart=request.first;
+      }
+
+      rangeEnd=request.first;
+    }
+
+    scanner.Prefetch(rangeStart,
+                     (size_t)(rangeEnd-rangeStart)+BATCH_READ_TAIL);
+  }
+
+  /**
+   * Read the bounding box of the object at the current position of the given, memory
+   * mapped scanner without creating the object, for example using an object view
+   * (see WayView, AreaView). The scanner must be positioned after the object afterwards.
+   *
+   * Returns false, if this is not supported for the objects of the data file. This is
+   * the default.
+   *
+   * @throws IOException
+   */
+  template <class N>
+  bool DataFile<N>::ReadBoundingBox(FileScanner& /*scanner*/,
+                                    GeoBox& /*boundingBox*/) const
+  {
+    return false;
+  }
+
+  /**
+   * Remove the requests for objects not intersecting the given bounding box, if the
+   * data file is memory mapped and the bounding box of the objects can be read without
+   * creating the objects (see ReadBoundingBox()).
+   *
+   * Method is thread-safe.
+   *
+   * @throws IOException
+   */
+  template <class N>
+  void DataFile<N>::FilterBatch(FileScanner& scanner,
+                                const GeoBox& boundingBox,
+                                std::vector<ReadRequest>& requests) const
+  {
+    if (!scanner.IsMemoryMapped()) {
+      return;
+    }
+
+    GeoBox objectBoundingBox;
+    size_t keptCount=0;
+
+    for (const auto& request : requests) {
+      scanner.SetPos(request.first);
+
+      if (!ReadBoundingBox(scanner,
+                           objectBoundingBox)) {
+        return;
+      }
+
+      if (objectBoundingBox.Intersects(boundingBox)) {
+        requests[keptCount]=request;
+        keptCount++;
+      }
+    }
+
+    requests.resize(keptCount);
+  }
+
+  /**
+   * Read the objects for the given requests, store them in the cache and at the requested
+   * index of the data vector. If batching is enabled, requests get sorted
+   * by offset, are prefetched and each offset is only read once. Objects directly
+   * following each other in the file are read without repositioning the scanner.
+   *
+   * Method is thread-safe.
+   */
+  template <class N>
+  bool DataFile<N>::ReadDataBatch(FileScanner& scanner,
+                                  std::vector<ReadRequest>& requests,
+                                  std::vector<ValueType>& data) const
+  {
+    if (batchReadWindow>0) {
+      std::sort(requests.begin(),
+                requests.end());
+
+      PrefetchBatch(scanner,
+                    requests);
+    }
+
+    try {
+      ValueType  value;
+      FileOffset valueOffset=0;
+      FileOffset nextOffset=0;
+
+      for (const auto& request : requests) {
+        if (value &&
+            request.first==valueOffset) {
+          data[request.second]=value;
+          continue;
+        }
+
+        if (!value ||
+            request.first!=nextOffset) {
+          scanner.SetPos(request.first);
+        }
+
+        value=std::make_shared<N>();
+
+        if (!ReadData(*typeConfig,
+                      scanner,
+                      *value)) {
+          log.Error() << "Error while reading data from offset " << request.first << " of file " << datafilename << "!";
+          return false;
+        }
+
+        valueOffset=request.first;
+        nextOffset=scanner.GetPos();
+
+        cache.Put(valueOffset,value);
+        data[request.second]=value;
+      }
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Return a scanner for exclusive use by the calling thread. If all existing
+   * scanners are in use, a new one is opened and added to the pool. If the
+   * primary scanner is memory mapped, new scanners share its mapping.
+   *
+   * Returns nullptr, if no scanner could be opened.
+   *
+   * Method is thread-safe.
+   */
+  template <class N>
+  FileScanner* DataFile<N>::AcquireScanner() const
+  {
+    std::lock_guard<std::mutex> lock(scannerMutex);
+
+    if (!idleScanners.empty()) {
+      FileScanner* result=idleScanners.back();
+
+      idleScanners.pop_back();
+
+      return result;
+    }
+
+    FileScannerRef newScanner(new FileScanner());
+
+    try {
+      newScanner->Open(datafilename,
+                       FileScanner::LowMemRandom,
+                       memoryMappedData && !scanner.IsMemoryMapped(),
+                       mmapPolicy);
+
+      if (scanner.IsMemoryMapped()) {
+        newScanner->ShareMapping(scanner);
+      }
+
+      newScanner->SetBlockCache(blockCache);
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      newScanner->CloseFailsafe();
+      return nullptr;
+    }
+
+    scannerPool.push_back(std::move(newScanner));
+
+    return scannerPool.back().get();
+  }
+
+  /**
+   * Give a scanner back to the pool. Scanners in error state are closed
+   * and dropped instead of being reused. This does not invalidate object views
+   * (see WayView, AreaView), since all scanners share the memory mapping of
+   * the primary scanner.
+   *
+   * Method is thread-safe.
+   */
+  template <class N>
+  void DataFile<N>::ReleaseScanner(FileScanner* scanner) const
+  {
+    std::lock_guard<std::mutex> lock(scannerMutex);
+
+    if (scanner->HasError()) {
+      // The primary scanner stays open, it signals that the data file is available
+      if (scanner==&this->scanner) {
+        return;
+      }
+
+      scanner->CloseFailsafe();
+
+      for (auto iter=scannerPool.begin(); iter!=scannerPool.end(); ++iter) {
+        if (iter->get()==scanner) {
+          scannerPool.erase(iter);
+          break;
+        }
+      }
+
+      return;
+    }
+
+    idleScanners.push_back(scanner);
+  }
+
+  /**
+   * Open the index file. The given MmapPolicy is used for all scanners
+   * of the file, if memoryMappedData is true.
    *
    * Method is NOT thread-safe.
    */
   template <class N>
   bool DataFile<N>::Open(const TypeConfigRef& typeConfig,
                          const std::string& path,
-                         bool memoryMappedData)
+                         bool memoryMappedData,
+                         const MmapPolicy& mmapPolicy)
   {
     this->typeConfig=typeConfig;
+    this->memoryMappedData=memoryMappedData;
+    this->mmapPolicy=mmapPolicy;
 
     datafilename=AppendFileToDir(path,datafile);
 
     try {
       scanner.Open(datafilename,
                    FileScanner::LowMemRandom,
-                   memoryMappedData);
+                   memoryMappedData,
+                   mmapPolicy);
     }
     catch (IOException& e) {
       log.Error() << e.GetDescription();
@@ -227,6 +627,14 @@ namespace osmscout {
       return false;
     }
 
+    if (scanner.IsBlockCompressed()) {
+      blockCache=std::make_shared<BlockDataCache>(BLOCK_CACHE_SIZE,
+                                                  CACHE_SHARD_COUNT);
+      scanner.SetBlockCache(blockCache);
+    }
+
+    idleScanners.push_back(&scanner);
+
     return true;
   }
 
@@ -249,7 +657,27 @@ namespace osmscout {
   template <class N>
   bool DataFile<N>::Close()
   {
+    bool result=true;
+
     typeConfig=nullptr;
+    blockCache=nullptr;
+
+    idleScanners.clear();
+
+    for (auto& pooledScanner : scannerPool) {
+      try  {
+        if (pooledScanner->IsOpen()) {
+          pooledScanner->Close();
+        }
+      }
+      catch (IOException& e) {
+        log.Error() << e.GetDescription();
+        pooledScanner->CloseFailsafe();
+        result=false;
+      }
+    }
+
+    scannerPool.clear();
 
     try  {
       if (scanner.IsOpen()) {
@@ -262,7 +690,7 @@ namespace osmscout {
       return false;
     }
 
-    return true;
+    return result;
   }
 
   /**
@@ -298,36 +726,44 @@ namespace osmscout {
       return true;
     }
 
+    size_t                   firstIndex=data.size();
+    std::vector<ReadRequest> requests;
+
     data.reserve(data.size()+size);
-    std::lock_guard<std::mutex> lock(accessMutex);
 
     for (IteratorIn offsetIter=begin; offsetIter!=end; ++offsetIter) {
-      ValueCacheRef entryRef;
+      ValueType value;
 
-      if (cache.GetEntry(*offsetIter,entryRef)) {
-        data.push_back(entryRef->value);
+      if (!cache.Get(*offsetIter,value)) {
+        requests.push_back(std::make_pair(*offsetIter,data.size()));
       }
-      else {
-        ValueType value=std::make_shared<N>();
 
-        if (!ReadData(*typeConfig,
-                      scanner,
-                      *offsetIter,
-                      *value)) {
-          log.Error() << "Error while reading data from offset " << *offsetIter << " of file " << datafilename << "!";
-          return false;
-        }
+      data.push_back(value);
+    }
 
-        cache.SetEntry(ValueCacheEntry(*offsetIter,value));
-        data.push_back(value);
-      }
+    if (requests.empty()) {
+      return true;
+    }
+
+    ScannerLease lease(*this);
+
+    if (!lease.IsValid() ||
+        !ReadDataBatch(*lease,
+                       requests,
+                       data)) {
+      data.resize(firstIndex);
+      return false;
     }
 
     return true;
   }
 
   /**
-   * Read data values from the given file offsets.
+   * Read data values from the given file offsets, which intersect the given bounding box.
+   *
+   * If the data file is memory mapped and supports it (see ReadBoundingBox()), the bounding
+   * box of objects not in the cache is checked before reading them, so objects outside
+   * the bounding box are neither created nor cached.
    *
    * Method is thread-safe.
    */
@@ -342,32 +778,50 @@ namespace osmscout {
       return true;
     }
 
-    data.reserve(data.size()+size);
-    std::lock_guard<std::mutex> lock(accessMutex);
+    std::vector<ValueType>   values;
+    std::vector<ReadRequest> requests;
+
+    values.reserve(size);
 
     for (IteratorIn offsetIter=begin; offsetIter!=end; ++offsetIter) {
-      ValueType value=std::make_shared<N>();
+      ValueType value;
 
-      ValueCacheRef entryRef;
-      if (cache.GetEntry(*offsetIter,entryRef)){
-        value=entryRef->value;
-      }else{
-        if (!ReadData(*typeConfig,
-                      scanner,
-                      *offsetIter,
-                      *value)) {
-          log.Error() << "Error while reading data from offset " << *offsetIter << " of file " << datafilename << "!";
-          return false;
-        }
+      if (!cache.Get(*offsetIter,value)) {
+        requests.push_back(std::make_pair(*offsetIter,values.size()));
+      }
 
-        cache.SetEntry(ValueCacheEntry(*offsetIter,value));
+      values.push_back(value);
+    }
+
+    if (!requests.empty()) {
+      ScannerLease lease(*this);
+
+      if (!lease.IsValid()) {
+        return false;
       }
 
-      if (!value->Intersects(boundingBox)) {
-        continue;
+      try {
+        FilterBatch(*lease,
+                    boundingBox,
+                    requests);
+      }
+      catch (IOException& e) {
+        log.Error() << e.GetDescription();
+        return false;
       }
 
-      data.push_back(value);
+      if (!ReadDataBatch(*lease,
+                         requests,
+                         values)) {
+        return false;
+      }
+    }
+
+    for (const auto& value : values) {
+      if (value &&
+          value->Intersects(boundingBox)) {
+        data.push_back(value);
+      }
     }
 
     return true;
@@ -413,27 +867,29 @@ namespace osmscout {
   bool DataFile<N>::GetByOffset(FileOffset offset,
                                 ValueType& entry) const
   {
-    std::lock_guard<std::mutex> lock(accessMutex);
+    if (cache.Get(offset,entry)) {
+      return true;
+    }
 
-    ValueCacheRef entryRef;
-    if (cache.GetEntry(offset,entryRef)){
-      entry=entryRef->value;
-    }else{
-      ValueType value=std::make_shared<N>();
+    ScannerLease lease(*this);
 
-      if (!ReadData(*typeConfig,
-                    scanner,
-                    offset,
-                    *value)) {
-        log.Error() << "Error while reading data from offset " << offset << " of file " << datafilename << "!";
-        // TODO: Remove broken entry from cache
-        return false;
-      }
+    if (!lease.IsValid()) {
+      return false;
+    }
+
+    ValueType value=std::make_shared<N>();
 
-      cache.SetEntry(ValueCacheEntry(offset,value));
-      entry=value;
+    if (!ReadData(*typeConfig,
+                  *lease,
+                  offset,
+                  *value)) {
+      log.Error() << "Error while reading data from offset " << offset << " of file " << datafilename << "!";
+      return false;
     }
 
+    cache.Put(offset,value);
+    entry=value;
+
     return true;
   }
 
@@ -450,7 +906,11 @@ namespace osmscout {
       return true;
     }
 
-    std::lock_guard<std::mutex> lock(accessMutex);
+    ScannerLease lease(*this);
+
+    if (!lease.IsValid()) {
+      return false;
+    }
 
     try {
       bool offsetSetup=false;
@@ -459,26 +919,28 @@ namespace osmscout {
       data.reserve(data.size()+span.count);
 
       for (uint32_t i=1; i<=span.count; i++) {
-        ValueCacheRef entryRef;
-        if (cache.GetEntry(offset,entryRef)){
-          data.push_back(entryRef->value);
-          offset=entryRef->value->GetNextFileOffset();
+        ValueType value;
+
+        if (cache.Get(offset,value)) {
+          data.push_back(value);
+          offset=value->GetNextFileOffset();
           offsetSetup=false;
-        }else{
-          if (!offsetSetup){
-            scanner.SetPos(offset);
+        }
+        else {
+          if (!offsetSetup) {
+            (*lease).SetPos(offset);
           }
 
-          ValueType value=std::make_shared<N>();
+          value=std::make_shared<N>();
 
           if (!ReadData(*typeConfig,
-                        scanner,
+                        *lease,
                         *value)) {
             log.Error() << "Error while reading data #" << i << " starting from offset " << span.startOffset << " of file " << datafilename << "!";
             return false;
           }
 
-          cache.SetEntry(ValueCacheEntry(offset,value));
+          cache.Put(offset,value);
           offset=value->GetNextFileOffset();
           offsetSetup=true;
           data.push_back(value);
@@ -511,8 +973,13 @@ namespace osmscout {
 
     data.reserve(data.size()+overallCount);
 
+    ScannerLease lease(*this);
+
+    if (!lease.IsValid()) {
+      return false;
+    }
+
     try {
-      std::lock_guard<std::mutex> lock(accessMutex);
       for (IteratorIn spanIter=begin; spanIter!=end; ++spanIter) {
         if (spanIter->count==0) {
           continue;
@@ -522,27 +989,29 @@ namespace osmscout {
         FileOffset offset=spanIter->startOffset;
 
         for (uint32_t i=1; i<=spanIter->count; i++) {
-          ValueCacheRef entryRef;
-          if (cache.GetEntry(offset,entryRef)){
-            data.push_back(entryRef->value);
-            offset=entryRef->value->GetNextFileOffset();
+          ValueType value;
+
+          if (cache.Get(offset,value)) {
+            data.push_back(value);
+            offset=value->GetNextFileOffset();
             offsetSetup=false;
-          }else{
-            if (!offsetSetup){
-              scanner.SetPos(offset);
+          }
+          else {
+            if (!offsetSetup) {
+              (*lease).SetPos(offset);
             }
 
-            ValueType value=std::make_shared<N>();
+            value=std::make_shared<N>();
 
             if (!ReadData(*typeConfig,
-                          scanner,
+                          *lease,
                           *value)) {
               log.Error() << "Error while reading data #" << i << " starting from offset " << spanIter->startOffset <<
               " of file " << datafilename << "!";
               return false;
             }
 
-            cache.SetEntry(ValueCacheEntry(offset,value));
+            cache.Put(offset,value);
             offset=value->GetNextFileOffset();
             offsetSetup=true;
             data.push_back(value);
@@ -558,26 +1027,135 @@ namespace osmscout {
     return true;
   }
 
+  /**
+   * Read data values from the given DataBlockSpans, which intersect the given bounding box.
+   *
+   * If the data file is memory mapped and supports it (see ReadBoundingBox()), the bounding
+   * box of objects not in the cache is checked before reading them. Objects outside the
+   * bounding box are neither created nor cached.
+   *
+   * Method is thread-safe.
+   */
+  template <class N>
+  template<typename IteratorIn>
+  bool DataFile<N>::GetByBlockSpans(IteratorIn begin, IteratorIn end,
+                                    const GeoBox& boundingBox,
+                                    std::vector<ValueType>& data) const
+  {
+    ScannerLease lease(*this);
+
+    if (!lease.IsValid()) {
+      return false;
+    }
+
+    bool   checkBoundingBox=(*lease).IsMemoryMapped();
+    GeoBox objectBoundingBox;
+
+    try {
+      for (IteratorIn spanIter=begin; spanIter!=end; ++spanIter) {
+        if (spanIter->count==0) {
+          continue;
+        }
+
+        bool offsetSetup=false;
+        FileOffset offset=spanIter->startOffset;
+
+        for (uint32_t i=1; i<=spanIter->count; i++) {
+          ValueType value;
+
+          if (cache.Get(offset,value)) {
+            if (value->Intersects(boundingBox)) {
+              data.push_back(value);
+            }
+
+            offset=value->GetNextFileOffset();
+            offsetSetup=false;
+
+            continue;
+          }
+
+          if (!offsetSetup) {
+            (*lease).SetPos(offset);
+          }
+
+          if (checkBoundingBox) {
+            checkBoundingBox=ReadBoundingBox(*lease,
+                                             objectBoundingBox);
+
+            if (checkBoundingBox &&
+                !objectBoundingBox.Intersects(boundingBox)) {
+              offset=(*lease).GetPos();
+              offsetSetup=true;
+
+              continue;
+            }
+
+            (*lease).SetPos(offset);
+          }
+
+          value=std::make_shared<N>();
+
+          if (!ReadData(*typeConfig,
+                        *lease,
+                        *value)) {
+            log.Error() << "Error while reading data #" << i << " starting from offset " << spanIter->startOffset <<
+            " of file " << datafilename << "!";
+            return false;
+          }
+
+          offset=value->GetNextFileOffset();
+          offsetSetup=true;
+
+          if (value->Intersects(boundingBox)) {
+            cache.Put(value->GetFileOffset(),value);
+            data.push_back(value);
+          }
+        }
+      }
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      return false;
+    }
+
+    return true;
+  }
+
   /**
    * \ingroup Database
    *
    * Extension of DataFile to allow loading data not only by offset but
    * by id using an additional index file, mapping objects id to object
    * file offset.
+   *
+   * The index type IDX is either NumericIndex or EytzingerIndex. The index cache size
+   * is only passed to index types with a page cache (NumericIndex).
    */
-  template <class I, class N>
+  template <class I, class N, class IDX=NumericIndex<I>>
   class IndexedDataFile : public DataFile<N>
   {
   public:
     typedef std::shared_ptr<N> ValueType;
 
   private:
-    typedef NumericIndex<I> DataIndex;
+    typedef IDX DataIndex;
 
   private:
     DataIndex     index;
     TypeConfigRef typeConfig;
 
+  private:
+    IndexedDataFile(const std::string& datafile,
+                    const std::string& indexfile,
+                    size_t indexCacheSize,
+                    size_t dataCacheSize,
+                    std::true_type indexHasCache);
+    IndexedDataFile(const std::string& datafile,
+                    const std::string& indexfile,
+                    size_t indexCacheSize,
+                    size_t dataCacheSize,
+                    std::false_type indexHasCache);
+
   public:
     IndexedDataFile(const std::string& datafile,
                     const std::string& indexfile,
@@ -614,22 +1192,49 @@ namespace osmscout {
 
   };
 
-  template <class I, class N>
-  IndexedDataFile<I,N>::IndexedDataFile(const std::string& datafile,
-                                        const std::string& indexfile,
-                                        size_t indexCacheSize,
-                                        size_t dataCacheSize)
+  template <class I, class N, class IDX>
+  IndexedDataFile<I,N,IDX>::IndexedDataFile(const std::string& datafile,
+                                            const std::string& indexfile,
+                                            size_t indexCacheSize,
+                                            size_t dataCacheSize)
+  : IndexedDataFile(datafile,
+                    indexfile,
+                    indexCacheSize,
+                    dataCacheSize,
+                    typename std::is_constructible<IDX,const std::string&,size_t>::type())
+  {
+    // no code
+  }
+
+  template <class I, class N, class IDX>
+  IndexedDataFile<I,N,IDX>::IndexedDataFile(const std::string& datafile,
+                                            const std::string& indexfile,
+                                            size_t indexCacheSize,
+                                            size_t dataCacheSize,
+                                            std::true_type /*indexHasCache*/)
   : DataFile<N>(datafile,dataCacheSize),
     index(indexfile,indexCacheSize)
   {
     // no code
   }
 
-  template <class I, class N>
-  bool IndexedDataFile<I,N>::Open(const TypeConfigRef& typeConfig,
-                                  const std::string& path,
-                                  bool memoryMapedIndex,
-                                  bool memoryMapedData)
+  template <class I, class N, class IDX>
+  IndexedDataFile<I,N,IDX>::IndexedDataFile(const std::string& datafile,
+                                            const std::string& indexfile,
+                                            size_t /*indexCacheSize*/,
+                                            size_t dataCacheSize,
+                                            std::false_type /*indexHasCache*/)
+  : DataFile<N>(datafile,dataCacheSize),
+    index(indexfile)
+  {
+    // no code
+  }
+
+  template <class I, class N, class IDX>
+  bool IndexedDataFile<I,N,IDX>::Open(const TypeConfigRef& typeConfig,
+                                      const std::string& path,
+                                      bool memoryMapedIndex,
+                                      bool memoryMapedData)
   {
     if (!DataFile<N>::Open(typeConfig,
                            path,
@@ -641,8 +1246,8 @@ namespace osmscout {
                       memoryMapedIndex);
   }
 
-  template <class I, class N>
-  bool IndexedDataFile<I,N>::Close()
+  template <class I, class N, class IDX>
+  bool IndexedDataFile<I,N,IDX>::Close()
   {
     bool result=true;
 
@@ -657,17 +1262,17 @@ namespace osmscout {
     return result;
   }
 
-  template <class I, class N>
-  bool IndexedDataFile<I,N>::IsOpen() const
+  template <class I, class N, class IDX>
+  bool IndexedDataFile<I,N,IDX>::IsOpen() const
   {
     return DataFile<N>::IsOpen() &&
            index.IsOpen();
   }
 
-  template <class I, class N>
+  template <class I, class N, class IDX>
   template<typename IteratorIn>
-  bool IndexedDataFile<I,N>::GetOffsets(IteratorIn begin, IteratorIn end, size_t size,
-                                        std::vector<FileOffset>& offsets) const
+  bool IndexedDataFile<I,N,IDX>::GetOffsets(IteratorIn begin, IteratorIn end, size_t size,
+                                            std::vector<FileOffset>& offsets) const
   {
     return index.GetOffsets(begin,
                            end,
@@ -675,16 +1280,16 @@ namespace osmscout {
                            offsets);
   }
 
-  template <class I, class N>
-  bool IndexedDataFile<I,N>::GetOffset(I id,
-                                       FileOffset& offset) const
+  template <class I, class N, class IDX>
+  bool IndexedDataFile<I,N,IDX>::GetOffset(I id,
+                                           FileOffset& offset) const
   {
     return index.GetOffset(id,offset);
   }
 
-  template <class I, class N>
-  bool IndexedDataFile<I,N>::Get(const std::vector<I>& ids,
-                                 std::vector<ValueType>& data) const
+  template <class I, class N, class IDX>
+  bool IndexedDataFile<I,N,IDX>::Get(const std::vector<I>& ids,
+                                     std::vector<ValueType>& data) const
   {
     std::vector<FileOffset> offsets;
 
@@ -701,9 +1306,9 @@ namespace osmscout {
                                     data);
   }
 
-  template <class I, class N>
-  bool IndexedDataFile<I,N>::Get(const std::list<I>& ids,
-                                 std::vector<ValueType>& data) const
+  template <class I, class N, class IDX>
+  bool IndexedDataFile<I,N,IDX>::Get(const std::list<I>& ids,
+                                     std::vector<ValueType>& data) const
   {
     std::vector<FileOffset> offsets;
 
@@ -720,9 +1325,9 @@ namespace osmscout {
                                     data);
   }
 
-  template <class I, class N>
-  bool IndexedDataFile<I,N>::Get(const std::set<I>& ids,
-                                 std::vector<ValueType>& data) const
+  template <class I, class N, class IDX>
+  bool IndexedDataFile<I,N,IDX>::Get(const std::set<I>& ids,
+                                     std::vector<ValueType>& data) const
   {
     std::vector<FileOffset> offsets;
 
@@ -739,9 +1344,9 @@ namespace osmscout {
                                     data);
   }
 
-  template <class I, class N>
-  bool IndexedDataFile<I,N>::Get(const std::set<I>& ids,
-                                 std::unordered_map<I,ValueType>& data) const
+  template <class I, class N, class IDX>
+  bool IndexedDataFile<I,N,IDX>::Get(const std::set<I>& ids,
+                                     std::unordered_map<I,ValueType>& data) const
   {
     std::vector<FileOffset> offsets;
     std::vector<ValueType>  d;
@@ -767,9 +1372,9 @@ namespace osmscout {
     return true;
   }
 
-  template <class I, class N>
-  bool IndexedDataFile<I,N>::Get(I id,
-                                 ValueType& entry) const
+  template <class I, class N, class IDX>
+  bool IndexedDataFile<I,N,IDX>::Get(I id,
+                                     ValueType& entry) const
   {
     FileOffset offset;
 
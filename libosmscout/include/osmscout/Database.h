@@ -20,10 +20,12 @@
   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 */
 
+#include <future>
 #include <list>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -53,7 +55,11 @@
 
 #include <osmscout/routing/Route.h>
 
+#include <osmscout/util/Breaker.h>
 #include <osmscout/util/GeoBox.h>
+#include <osmscout/util/Magnification.h>
+#include <osmscout/util/MmapPolicy.h>
+#include <osmscout/util/WorkQueue.h>
 
 #include <osmscout/system/Compiler.h>
 
@@ -71,7 +77,11 @@ namespace osmscout {
     instance.
 
     The following attributes are currently available:
-    * cache sizes.
+    * cache sizes (number of entries) and optional memory limits (in bytes) of the way and area caches.
+    * number of threads used for prefetching data in the background (see Database::Prefetch()).
+    * policies for memory mapping data and index files (see MmapPolicy). A policy can be set for
+      all data files, for all index files and for single files (by filename, for example "areas.dat"),
+      with the policy of a single file taking precedence.
     */
   class OSMSCOUT_API DatabaseParameter CLASS_FINAL
   {
@@ -82,12 +92,26 @@ namespace osmscout {
     unsigned long wayDataCacheSize;
     unsigned long areaDataCacheSize;
 
+    unsigned long wayDataCacheMemory;
+    unsigned long areaDataCacheMemory;
+
     bool routerDataMMap;
     bool nodesDataMMap;
     bool areasDataMMap;
     bool waysDataMMap;
     bool optimizeLowZoomMMap;
     bool indexMMap;
+
+    MmapPolicy dataMMapPolicy;
+    MmapPolicy indexMMapPolicy;
+    std::unordered_map<std::string,MmapPolicy> fileMMapPolicies;
+
+    unsigned long prefetchThreadCount;
+
+  private:
+    MmapPolicy GetFileMMapPolicy(const std::string& filename,
+                                 const MmapPolicy& defaultPolicy) const;
+
   public:
     DatabaseParameter();
 
@@ -96,6 +120,9 @@ namespace osmscout {
     void SetWayDataCacheSize(unsigned long  size);
     void SetAreaDataCacheSize(unsigned long  size);
 
+    void SetWayDataCacheMemory(unsigned long memory);
+    void SetAreaDataCacheMemory(unsigned long memory);
+
     void SetRouterDataMMap(bool mmap);
     void SetNodesDataMMap(bool mmap);
     void SetAreasDataMMap(bool mmap);
@@ -103,17 +130,32 @@ namespace osmscout {
     void SetOptimizeLowZoomMMap(bool mmap);
     void SetIndexMMap(bool mmap);
 
+    void SetDataMMapPolicy(const MmapPolicy& policy);
+    void SetIndexMMapPolicy(const MmapPolicy& policy);
+    void SetFileMMapPolicy(const std::string& filename,
+                           const MmapPolicy& policy);
+
+    void SetPrefetchThreadCount(unsigned long threadCount);
+
     unsigned long GetAreaAreaIndexCacheSize() const;
     unsigned long GetNodeDataCacheSize() const;
     unsigned long GetWayDataCacheSize() const;
     unsigned long GetAreaDataCacheSize() const;
 
+    unsigned long GetWayDataCacheMemory() const;
+    unsigned long GetAreaDataCacheMemory() const;
+
     bool GetRouterDataMMap() const;
     bool GetNodesDataMMap() const;
     bool GetAreasDataMMap() const;
     bool GetWaysDataMMap() const;
     bool GetOptimizeLowZoomMMap() const;
     bool GetIndexMMap() const;
+
+    MmapPolicy GetDataMMapPolicy(const std::string& filename) const;
+    MmapPolicy GetIndexMMapPolicy(const std::string& filename) const;
+
+    unsigned long GetPrefetchThreadCount() const;
   };
 
   class Database;
@@ -308,6 +350,21 @@ namespace osmscout {
     mutable OptimizeWaysLowZoomRef  optimizeWaysLowZoom;      //!< Optimized data for low zoom situations
     mutable std::mutex              optimizeWaysMutex;        //!< Mutex to make lazy initialisation of optimized ways index thread-safe
 
+    mutable std::unique_ptr<WorkQueue<bool>> prefetchQueue;   //!< Queue of pending prefetch requests
+    mutable std::vector<std::thread> prefetchThreads;         //!< Threads processing the prefetch requests
+    mutable ThreadedBreaker         prefetchBreaker;          //!< Aborts all prefetch requests on close
+    mutable std::mutex              prefetchMutex;            //!< Mutex to make lazy initialisation of prefetch threads thread-safe
+
+    PageFaultCount                  openPageFaults;           //!< Page faults of the process at the time the database was opened
+
+  private:
+    void PrefetchLoop() const;
+    bool PrefetchData(const GeoBox& boundingBox,
+                      const TypeInfoSet& types,
+                      const Magnification& magnification,
+                      const BreakerRef& breaker) const;
+    void StopPrefetch();
+
   public:
     explicit Database(const DatabaseParameter& parameter);
     virtual ~Database();
@@ -371,12 +428,18 @@ namespace osmscout {
                              std::vector<AreaRef>& area) const;
     bool GetAreasByBlockSpans(const std::vector<DataBlockSpan>& spans,
                               std::vector<AreaRef>& areas) const;
+    bool GetAreasByBlockSpans(const std::vector<DataBlockSpan>& spans,
+                              const GeoBox& boundingBox,
+                              std::vector<AreaRef>& areas) const;
 
 
     bool GetWayByOffset(const FileOffset& offset,
                         WayRef& way) const;
     bool GetWaysByOffset(const std::vector<FileOffset>& offsets,
                          std::vector<WayRef>& ways) const;
+    bool GetWaysByOffset(const std::vector<FileOffset>& offsets,
+                         const GeoBox& boundingBox,
+                         std::vector<WayRef>& ways) const;
     bool GetWaysByOffset(const std::set<FileOffset>& offsets,
                          std::vector<WayRef>& ways) const;
     bool GetWaysByOffset(const std::list<FileOffset>& offsets,
@@ -384,6 +447,11 @@ namespace osmscout {
     bool GetWaysByOffset(const std::set<FileOffset>& offsets,
                          std::unordered_map<FileOffset,WayRef>& dataMap) const;
 
+    std::future<bool> Prefetch(const GeoBox& boundingBox,
+                               const TypeInfoSet& types,
+                               const Magnification& magnification,
+                               const BreakerRef& breaker=nullptr) const;
+
     /**
      * Load nodes of given types with maximum distance to the given coordinate.
      *
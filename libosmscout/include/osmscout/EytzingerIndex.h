@@ -0,0 +1,389 @@
+#ifndef OSMSCOUT_EYTZINGERINDEX_H
+#define OSMSCOUT_EYTZINGERINDEX_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <osmscout/OSMScoutTypes.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/Logger.h>
+
+namespace osmscout {
+
+  /**
+    \ingroup Database
+    Index mapping ids of type <N> (usually Id or OSMId) to file offsets, as an alternative
+    to NumericIndex.
+
+    The sorted ids are stored as an implicit binary search tree in Eytzinger (BFS) order:
+    The children of the entry at (1-based) position k are located at positions 2k and 2k+1.
+    Searching walks down the tree without branches depending on the key comparison and the
+    top levels of the tree stay in the CPU cache. Descendants of an entry are grouped
+    together, so they can be prefetched a few levels ahead.
+
+    Ids and offsets are stored as fixed size values in two separate arrays. If the index
+    file is memory mapped (and the platform is little endian), both arrays are searched
+    in place, else they are loaded into memory on Open(). No page decoding or caching is
+    required, lookups are thread-safe without locking. Thus, in contrast to NumericIndex,
+    there is no cache size.
+
+    File layout (little endian):
+    - Number of entries n (uint32_t)
+    - Size of one id in bytes (uint32_t)
+    - n+1 ids (position 0 is unused), padded to a multiple of 8 bytes
+    - n+1 file offsets (uint64_t, position 0 is unused)
+
+    The index file is generated by EytzingerIndexGenerator.
+    */
+  template <class N>
+  class EytzingerIndex
+  {
+  public:
+    static const size_t HEADER_SIZE=8;     //!< Size of the file header
+    static const size_t BATCH_SIZE=8;      //!< Number of ids looked up in parallel by GetOffsets()
+
+  private:
+    std::string             filepart;      //!< Name of the index file
+    std::string             filename;      //!< Complete file name including directory
+
+    FileScanner             scanner;       //!< FileScanner instance for file access
+
+    size_t                  entryCount;    //!< Number of entries in the index
+    const N*                keys;          //!< Ids in Eytzinger order (1-based)
+    const FileOffset*       offsets;       //!< File offsets in Eytzinger order (1-based)
+    std::vector<N>          keyData;       //!< Ids, if not memory mapped
+    std::vector<FileOffset> offsetData;    //!< File offsets, if not memory mapped
+
+  private:
+    static bool IsLittleEndian();
+
+    static inline void PrefetchKeys(const N* address)
+    {
+#if defined(__GNUC__)
+      __builtin_prefetch(address);
+#else
+      (void)address;
+#endif
+    }
+
+    /**
+     * Return the position of the first entry not less than the searched id, given the position
+     * after walking down the tree beyond the leaves: Remove the trailing right turns and the
+     * final left turn. Returns 0, if there is no such entry.
+     */
+    static inline size_t GetLowerBound(size_t k)
+    {
+#if defined(__GNUC__)
+      return k >> (__builtin_ctzll(~(unsigned long long)k)+1);
+#else
+      while ((k & 1)!=0) {
+        k>>=1;
+      }
+
+      return k >> 1;
+#endif
+    }
+
+    /**
+     * Number of entries (with the given size) that fit into a cache line
+     */
+    static inline size_t GetPrefetchFactor()
+    {
+      return sizeof(N)>=8 ? 8 : 16;
+    }
+
+    inline bool GetOffsetInternal(const N& id,
+                                  FileOffset& offset) const
+    {
+      size_t k=1;
+
+      while (k<=entryCount) {
+        PrefetchKeys(keys+std::min(k*GetPrefetchFactor(),entryCount));
+        k=2*k+(keys[k]<id ? 1 : 0);
+      }
+
+      k=GetLowerBound(k);
+
+      if (k==0 || keys[k]!=id) {
+        return false;
+      }
+
+      offset=offsets[k];
+
+      return true;
+    }
+
+  public:
+    explicit EytzingerIndex(const std::string& filename);
+    virtual ~EytzingerIndex();
+
+    bool Open(const std::string& path,
+              bool memoryMaped);
+    bool Close();
+
+    bool IsOpen() const;
+
+    /**
+     * Returns true, if the index is searched in place in the memory mapped file
+     */
+    inline bool IsMemoryMapped() const
+    {
+      return keys!=NULL && keyData.empty();
+    }
+
+    inline size_t GetEntryCount() const
+    {
+      return entryCount;
+    }
+
+    bool GetOffset(const N& id, FileOffset& offset) const;
+
+    template<typename IteratorIn>
+    bool GetOffsets(IteratorIn begin,
+                    IteratorIn end,
+                    size_t size,
+                    std::vector<FileOffset>& offsets) const;
+
+    void DumpStatistics() const;
+  };
+
+  template <class N>
+  EytzingerIndex<N>::EytzingerIndex(const std::string& filename)
+   : filepart(filename),
+     entryCount(0),
+     keys(NULL),
+     offsets(NULL)
+  {
+    // no code
+  }
+
+  template <class N>
+  EytzingerIndex<N>::~EytzingerIndex()
+  {
+    Close();
+  }
+
+  template <class N>
+  bool EytzingerIndex<N>::IsLittleEndian()
+  {
+    const uint16_t value=1;
+
+    return *reinterpret_cast<const uint8_t*>(&value)==1;
+  }
+
+  template <class N>
+  bool EytzingerIndex<N>::Open(const std::string& path,
+                               bool memoryMaped)
+  {
+    uint32_t entries;
+    uint32_t keySize;
+
+    filename=AppendFileToDir(path,filepart);
+
+    try {
+      scanner.Open(filename,
+                   FileScanner::FastRandom,
+                   memoryMaped);
+
+      scanner.Read(entries);
+      scanner.Read(keySize);
+
+      if (keySize!=sizeof(N)) {
+        log.Error() << "Index file '" << filename << "' has id size " << keySize << ", expected " << sizeof(N);
+        scanner.CloseFailsafe();
+        return false;
+      }
+
+      entryCount=entries;
+
+      size_t keyBytes=(entryCount+1)*sizeof(N);
+      size_t offsetBytes=(entryCount+1)*sizeof(FileOffset);
+
+      keyBytes=(keyBytes+7)/8*8;
+
+      keyData.clear();
+      offsetData.clear();
+
+      if (scanner.IsMemoryMapped() &&
+          IsLittleEndian()) {
+        keys=reinterpret_cast<const N*>(scanner.GetMappedData(HEADER_SIZE,
+                                                              keyBytes));
+        offsets=reinterpret_cast<const FileOffset*>(scanner.GetMappedData(HEADER_SIZE+keyBytes,
+                                                                          offsetBytes));
+      }
+      else {
+        keyData.resize(entryCount+1);
+        offsetData.resize(entryCount+1);
+
+        for (auto& key : keyData) {
+          scanner.Read(key);
+        }
+
+        scanner.SetPos(HEADER_SIZE+keyBytes);
+
+        for (auto& offset : offsetData) {
+          scanner.Read(offset);
+        }
+
+        keys=keyData.data();
+        offsets=offsetData.data();
+      }
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      scanner.CloseFailsafe();
+      keys=NULL;
+      offsets=NULL;
+      return false;
+    }
+
+    return !scanner.HasError();
+  }
+
+  template <class N>
+  bool EytzingerIndex<N>::Close()
+  {
+    keys=NULL;
+    offsets=NULL;
+    keyData.clear();
+    offsetData.clear();
+
+    try {
+      if (scanner.IsOpen()) {
+        scanner.Close();
+      }
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      scanner.CloseFailsafe();
+      return false;
+    }
+
+    return true;
+  }
+
+  template <class N>
+  bool EytzingerIndex<N>::IsOpen() const
+  {
+    return scanner.IsOpen();
+  }
+
+  /**
+   * Return the file offset in the data file for the given object id.
+   *
+   * This method is thread-safe.
+   */
+  template <class N>
+  bool EytzingerIndex<N>::GetOffset(const N& id,
+                                    FileOffset& offset) const
+  {
+    if (keys==NULL) {
+      return false;
+    }
+
+    return GetOffsetInternal(id,
+                             offset);
+  }
+
+  /**
+   * Return the file offsets in the data file for the given object ids. Ids not
+   * found in the index are skipped, the offsets of the other ids are returned in
+   * the order of the ids.
+   *
+   * Ids are looked up in batches of BATCH_SIZE ids walking down the tree in lockstep,
+   * so that the memory accesses of the individual searches overlap. If the ids are
+   * sorted, the searches of a batch share the upper part of their paths.
+   *
+   * This method is thread-safe.
+   */
+  template <class N>
+  template<typename IteratorIn>
+  bool EytzingerIndex<N>::GetOffsets(IteratorIn begin,
+                                     IteratorIn end,
+                                     size_t size,
+                                     std::vector<FileOffset>& offsets) const
+  {
+    offsets.clear();
+    offsets.reserve(size);
+
+    if (this->keys==NULL) {
+      return false;
+    }
+
+    N          ids[BATCH_SIZE];
+    size_t     positions[BATCH_SIZE];
+    IteratorIn idIter=begin;
+
+    while (idIter!=end) {
+      size_t count=0;
+
+      while (count<BATCH_SIZE &&
+             idIter!=end) {
+        ids[count]=*idIter;
+        positions[count]=1;
+        count++;
+        ++idIter;
+      }
+
+      bool active=true;
+
+      while (active) {
+        active=false;
+
+        for (size_t i=0; i<count; i++) {
+          size_t k=positions[i];
+
+          if (k<=entryCount) {
+            PrefetchKeys(keys+std::min(k*GetPrefetchFactor(),entryCount));
+            positions[i]=2*k+(keys[k]<ids[i] ? 1 : 0);
+            active=true;
+          }
+        }
+      }
+
+      for (size_t i=0; i<count; i++) {
+        size_t k=GetLowerBound(positions[i]);
+
+        if (k!=0 && keys[k]==ids[i]) {
+          offsets.push_back(this->offsets[k]);
+        }
+      }
+    }
+
+    return true;
+  }
+
+  template <class N>
+  void EytzingerIndex<N>::DumpStatistics() const
+  {
+    size_t memory=keyData.size()*sizeof(N)+offsetData.size()*sizeof(FileOffset);
+
+    log.Info() << "Index " << filepart << ": " << entryCount << " entries, memory " << memory
+               << (IsMemoryMapped() ? ", memory mapped" : "");
+  }
+}
+
+#endif
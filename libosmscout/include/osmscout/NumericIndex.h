@@ -20,10 +20,11 @@
   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 */
 
+#include <algorithm>
 #include <mutex>
 #include <vector>
 
-#include <osmscout/util/Cache.h>
+#include <osmscout/util/ClockCache.h>
 #include <osmscout/util/File.h>
 #include <osmscout/util/FileScanner.h>
 #include <osmscout/util/Logger.h>
@@ -61,7 +62,7 @@ namespace osmscout {
     };
 
     typedef std::shared_ptr<Page>         PageRef;
-    typedef Cache<N,PageRef>              PageCache;
+    typedef ShardedCache<N,PageRef>       PageCache;
     typedef std::unordered_map<N,PageRef> PageSimpleCache;
 
     /**
@@ -69,7 +70,7 @@ namespace osmscout {
       */
     struct NumericIndexCacheValueSizer : public PageCache::ValueSizer
     {
-      size_t GetSize(const PageRef& value) const
+      size_t GetSize(const PageRef& value) const override
       {
         return sizeof(value)+sizeof(Page)+sizeof(Entry)*value->entries.size();
       }
@@ -82,6 +83,7 @@ namespace osmscout {
     mutable FileScanner                  scanner;             //!< FileScanner instance for file access
 
     size_t                               cacheSize;           //!< Maximum umber of index pages cached
+    size_t                               cacheMemory;         //!< Maximum memory of the cached index pages, 0 to derive it from cacheSize
     uint32_t                             pageSize;            //!< Size of one page as stated by the actual index file
     uint32_t                             levels;              //!< Number of index levels as stated by the actual index file
     std::vector<uint32_t>                pageCounts;          //!< Number of pages per level as stated by the actual index file
@@ -90,18 +92,22 @@ namespace osmscout {
     PageRef                              root;                //!< Reference to the root page
     size_t                               simpleCacheMaxLevel; //!< Maximum level for simple caching
     mutable std::vector<PageSimpleCache> simplePageCache;     //!< Simple map to cache all entries
-    mutable std::vector<PageCache>       pageCaches;          //!< Complex cache with LRU characteristics
+    NumericIndexCacheValueSizer          pageSizer;           //!< Sizer for the pages in the page caches
+    std::vector<PageCache>               pageCaches;          //!< Thread-safe complex cache with CLOCK eviction
 
-    mutable std::mutex                   accessMutex;         //!< Mutex to secure multi-thread access
+    mutable std::mutex                   scannerMutex;        //!< Mutex to secure the scanner and the read buffer
+    mutable std::mutex                   simpleCacheMutex;    //!< Mutex to secure the simple page cache
 
   private:
     size_t GetPageIndex(const Page& page, N id) const;
     void ReadPage(FileOffset offset, PageRef& page) const;
+    size_t GetEstimatedPageMemory() const;
     void InitializeCache();
 
   public:
     NumericIndex(const std::string& filename,
-                 size_t cacheSize);
+                 size_t cacheSize,
+                 size_t cacheMemory=0);
     virtual ~NumericIndex();
 
     bool Open(const std::string& path,
@@ -123,9 +129,11 @@ namespace osmscout {
 
   template <class N>
   NumericIndex<N>::NumericIndex(const std::string& filename,
-                                size_t cacheSize)
+                                size_t cacheSize,
+                                size_t cacheMemory)
    : filepart(filename),
      cacheSize(cacheSize),
+     cacheMemory(cacheMemory),
      pageSize(0),
      levels(0),
      buffer(NULL)
@@ -178,9 +186,16 @@ namespace osmscout {
     return size;
   }
 
+  /**
+   * Read and decode the index page at the given offset.
+   *
+   * Method is thread-safe.
+   */
   template <class N>
   inline void NumericIndex<N>::ReadPage(FileOffset offset, PageRef& page) const
   {
+    std::lock_guard<std::mutex> lock(scannerMutex);
+
     if (!page) {
       page=std::make_shared<Page>();
     }
@@ -231,12 +246,32 @@ namespace osmscout {
     }
   }
 
+  /**
+    Returns the expected memory of a loaded page in the page cache, as accounted by
+    NumericIndexCacheValueSizer (ReadPage() reserves pageSize/4 entries per page) plus the
+    per entry overhead of the cache
+    */
+  template <class N>
+  inline size_t NumericIndex<N>::GetEstimatedPageMemory() const
+  {
+    return sizeof(PageRef)+sizeof(Page)+sizeof(Entry)*(pageSize/4)+
+           ClockCache<N,PageRef>::GetEntryOverhead();
+  }
+
   template <class N>
   void NumericIndex<N>::InitializeCache()
   {
     size_t currentCacheSize=cacheSize; // Available free space in cache
+    size_t currentCacheMemory;         // Available free memory in cache
     size_t requiredCacheSize=0;        // Space needed for caching everything
 
+    if (cacheMemory>0) {
+      currentCacheMemory=cacheMemory;
+    }
+    else {
+      currentCacheMemory=cacheSize*GetEstimatedPageMemory();
+    }
+
     for (const auto count : pageCounts) {
       requiredCacheSize+=count;
     }
@@ -255,15 +290,34 @@ namespace osmscout {
         resultingCacheSize=currentCacheSize;
         currentCacheSize=0;
 
-        pageCaches.push_back(PageCache(resultingCacheSize));
+        // Make sure that the budget is not exhausted after the first page
+        size_t resultingCacheMemory=std::max(currentCacheMemory,
+                                             GetEstimatedPageMemory());
+        currentCacheMemory=0;
+
+        // Shards should hold a few pages each, since the limits are split evenly between them
+        size_t shardCount=std::max((size_t)1,
+                                   std::min({(size_t)16,
+                                             resultingCacheSize/8,
+                                             resultingCacheMemory/(8*GetEstimatedPageMemory())}));
+
+        pageCaches.push_back(PageCache(resultingCacheSize,
+                                       shardCount,
+                                       resultingCacheMemory,
+                                       &pageSizer));
       }
       else {
         resultingCacheSize=pageCounts[level];
         currentCacheSize-=pageCounts[level];
+        currentCacheMemory-=std::min(currentCacheMemory,
+                                     pageCounts[level]*GetEstimatedPageMemory());
 
         simpleCacheMaxLevel=level;
 
-        pageCaches.push_back(PageCache(0));
+        pageCaches.push_back(PageCache(0,
+                                       1,
+                                       0,
+                                       &pageSizer));
       }
     }
   }
@@ -354,8 +408,6 @@ namespace osmscout {
   {
     try
     {
-      std::lock_guard<std::mutex> lock(accessMutex);
-
       //std::cout << "Looking up " << id << " in index...." << std::endl;
 
       size_t                      r=GetPageIndex(*root,id);
@@ -376,31 +428,35 @@ namespace osmscout {
       for (size_t level=0; level+2<=levels; level++) {
         //std::cout << "Level " << level << "/" << levels << std::endl;
         if (level<=simpleCacheMaxLevel) {
-          auto cacheRef=simplePageCache[level].find(startId);
-
-          if (cacheRef==simplePageCache[level].end()) {
-            pageRef=NULL; // Make sure, that we allocate a new page and not reuse an old one
+          {
+            std::lock_guard<std::mutex> lock(simpleCacheMutex);
+            auto                        cacheRef=simplePageCache[level].find(startId);
+
+            if (cacheRef!=simplePageCache[level].end()) {
+              pageRef=cacheRef->second;
+            }
+            else {
+              pageRef=NULL; // Make sure, that we allocate a new page and not reuse an old one
+            }
+          }
 
+          if (!pageRef) {
             ReadPage(offset,pageRef);
 
-            simplePageCache[level].insert(std::make_pair(startId,pageRef));
-          }
-          else {
-            pageRef=cacheRef->second;
+            std::lock_guard<std::mutex> lock(simpleCacheMutex);
+
+            // Another thread may have read the same page in the meantime
+            pageRef=simplePageCache[level].insert(std::make_pair(startId,pageRef)).first->second;
           }
         }
         else {
-          typename PageCache::CacheRef cacheRef;
-
-          if (!pageCaches[level].GetEntry(startId,cacheRef)) {
-            typename PageCache::CacheEntry cacheEntry(startId);
+          if (!pageCaches[level].Get(startId,pageRef)) {
+            pageRef=NULL; // Make sure, that we allocate a new page and not reuse an old one
 
-            cacheRef=pageCaches[level].SetEntry(cacheEntry);
+            ReadPage(offset,pageRef);
 
-            ReadPage(offset,cacheRef->value);
+            pageCaches[level].Put(startId,pageRef);
           }
-
-          pageRef=cacheRef->value;
         }
 
         Page& page=*pageRef;
@@ -462,19 +518,23 @@ namespace osmscout {
   template <class N>
   void NumericIndex<N>::DumpStatistics() const
   {
-    size_t memory=0;
-    size_t pages=0;
+    CacheStatistics statistics;
+    size_t          memory=0;
+    size_t          pages=0;
 
     pages+=1;
     memory+=root->entries.size()*sizeof(Entry);
 
-
     for (size_t i=0; i<pageCaches.size(); i++) {
-      pages+=pageCaches[i].GetSize();
-      memory+=sizeof(pageCaches[i])+pageCaches[i].GetMemory(NumericIndexCacheValueSizer());
+      statistics+=pageCaches[i].GetStatistics();
+      memory+=sizeof(pageCaches[i]);
     }
 
-    log.Info() << "Index " << filepart << ": " << pages << " pages, memory " << memory;
+    pages+=statistics.entries;
+    memory+=statistics.memory;
+
+    log.Info() << "Index " << filepart << ": " << pages << " pages, memory " << memory
+               << ", hit rate " << statistics.GetHitRate()*100 << "%, evictions " << statistics.evictions;
   }
 }
 
@@ -97,7 +97,8 @@ namespace osmscout {
 
     bool Open(const TypeConfigRef& typeConfig,
               const std::string& path,
-              bool memoryMappedData);
+              bool memoryMappedData,
+              const MmapPolicy& mmapPolicy=MmapPolicy());
     bool Close();
 
     bool HasOptimizations(double magnification) const;
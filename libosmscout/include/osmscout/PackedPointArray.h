@@ -0,0 +1,363 @@
+#ifndef OSMSCOUT_PACKEDPOINTARRAY_H
+#define OSMSCOUT_PACKEDPOINTARRAY_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2026  libosmscout contributors
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include <osmscout/CoreImportExport.h>
+
+#include <osmscout/GeoCoord.h>
+#include <osmscout/OSMScoutTypes.h>
+#include <osmscout/Point.h>
+
+#include <osmscout/util/GeoBox.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  class PackedPointArray;
+
+  /**
+   * \ingroup Geometry
+   *
+   * Read-only accessor to one point of a PackedPointArray. It offers the same
+   * getters as Point, so templated geometry algorithms written for Point
+   * (for example CalculateDistancePointToLineSegment()) also work on
+   * packed arrays.
+   */
+  class OSMSCOUT_API PackedPoint CLASS_FINAL
+  {
+  private:
+    const PackedPointArray *array;
+    size_t                 index;
+
+  public:
+    inline PackedPoint(const PackedPointArray& array,
+                       size_t index)
+    : array(&array),
+      index(index)
+    {
+      // no code
+    }
+
+    inline double GetLat() const;
+    inline double GetLon() const;
+    inline GeoCoord GetCoord() const;
+    inline uint8_t GetSerial() const;
+    inline bool IsRelevant() const;
+    inline Id GetId() const;
+  };
+
+  /**
+   * \ingroup Geometry
+   *
+   * Array of points, stored as struct of arrays: lat and lon are stored in
+   * separate arrays as 32 bit fixed point values (in the same resolution as
+   * used in the data files, see latConversionFactor and lonConversionFactor),
+   * serials are stored in an optional third array, which is empty if no point
+   * has a serial.
+   *
+   * Compared to std::vector<Point> (24 bytes per point) a packed array needs
+   * 8 or 9 bytes per point and geometry loops touch fewer cache lines.
+   * Coordinates are quantized to the data file resolution, thus arrays read
+   * from the database are represented without loss.
+   *
+   * Geometry kernels operating directly on packed arrays are available for
+   * point in area tests (IsCoordInArea()) and point to line distance
+   * (CalculateDistancePointToLineSegments()). All other algorithms can use the
+   * PackedPoint accessor via operator[] or iteration.
+   *
+   * There are no TransPolygon overloads: the renderer works on the Point
+   * vectors of Way and Area, and converting to packed arrays first was slower
+   * than transforming the points directly.
+   */
+  class OSMSCOUT_API PackedPointArray CLASS_FINAL
+  {
+  public:
+    /**
+     * Forward iterator, returning a PackedPoint accessor for each point.
+     */
+    class OSMSCOUT_API const_iterator CLASS_FINAL
+    {
+    public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef PackedPoint               value_type;
+      typedef std::ptrdiff_t            difference_type;
+      typedef const PackedPoint*        pointer;
+      typedef PackedPoint               reference;
+
+    private:
+      const PackedPointArray *array;
+      size_t                 index;
+
+    public:
+      inline const_iterator(const PackedPointArray& array,
+                            size_t index)
+      : array(&array),
+        index(index)
+      {
+        // no code
+      }
+
+      inline PackedPoint operator*() const
+      {
+        return PackedPoint(*array,index);
+      }
+
+      inline const_iterator& operator++()
+      {
+        index++;
+
+        return *this;
+      }
+
+      inline bool operator==(const const_iterator& other) const
+      {
+        return index==other.index;
+      }
+
+      inline bool operator!=(const const_iterator& other) const
+      {
+        return index!=other.index;
+      }
+    };
+
+  private:
+    std::vector<int32_t> latValues; //!< Fixed point latitudes
+    std::vector<int32_t> lonValues; //!< Fixed point longitudes
+    std::vector<uint8_t> serials;   //!< Serials, empty if all serials are 0
+
+  public:
+    PackedPointArray();
+    explicit PackedPointArray(const std::vector<Point>& points);
+    explicit PackedPointArray(const std::vector<GeoCoord>& coords);
+
+    void Set(const std::vector<Point>& points);
+    void Set(const std::vector<GeoCoord>& coords);
+    void Resize(size_t count);
+
+    void SetSerial(size_t index,
+                   uint8_t serial);
+
+    void Clear();
+
+    inline size_t size() const
+    {
+      return latValues.size();
+    }
+
+    inline bool empty() const
+    {
+      return latValues.empty();
+    }
+
+    inline size_t GetSize() const
+    {
+      return latValues.size();
+    }
+
+    inline bool IsEmpty() const
+    {
+      return latValues.empty();
+    }
+
+    inline bool HasSerials() const
+    {
+      return !serials.empty();
+    }
+
+    /**
+     * Raw fixed point latitude values, GetSize() entries
+     */
+    inline const int32_t* GetLatValues() const
+    {
+      return latValues.data();
+    }
+
+    inline int32_t* GetLatValues()
+    {
+      return latValues.data();
+    }
+
+    /**
+     * Raw fixed point longitude values, GetSize() entries
+     */
+    inline const int32_t* GetLonValues() const
+    {
+      return lonValues.data();
+    }
+
+    inline int32_t* GetLonValues()
+    {
+      return lonValues.data();
+    }
+
+    inline double GetLat(size_t index) const
+    {
+      return latValues[index]/latConversionFactor-90.0;
+    }
+
+    inline double GetLon(size_t index) const
+    {
+      return lonValues[index]/lonConversionFactor-180.0;
+    }
+
+    inline GeoCoord GetCoord(size_t index) const
+    {
+      return GeoCoord(GetLat(index),
+                      GetLon(index));
+    }
+
+    inline uint8_t GetSerial(size_t index) const
+    {
+      return serials.empty() ? 0 : serials[index];
+    }
+
+    Id GetId(size_t index) const;
+
+    inline Point GetPoint(size_t index) const
+    {
+      return Point(GetSerial(index),
+                   GetCoord(index));
+    }
+
+    inline PackedPoint operator[](size_t index) const
+    {
+      return PackedPoint(*this,index);
+    }
+
+    inline PackedPoint front() const
+    {
+      return PackedPoint(*this,0);
+    }
+
+    inline PackedPoint back() const
+    {
+      return PackedPoint(*this,latValues.size()-1);
+    }
+
+    inline const_iterator begin() const
+    {
+      return const_iterator(*this,0);
+    }
+
+    inline const_iterator end() const
+    {
+      return const_iterator(*this,latValues.size());
+    }
+
+    void GetPoints(std::vector<Point>& points) const;
+    void GetCoords(std::vector<GeoCoord>& coords) const;
+
+    GeoBox GetBoundingBox() const;
+
+    size_t GetMemoryUsage() const;
+
+    /**
+     * Convert a latitude to the fixed point representation
+     */
+    static inline int32_t LatToValue(double lat)
+    {
+      return (int32_t)round((lat+90.0)*latConversionFactor);
+    }
+
+    /**
+     * Convert a longitude to the fixed point representation
+     */
+    static inline int32_t LonToValue(double lon)
+    {
+      return (int32_t)round((lon+180.0)*lonConversionFactor);
+    }
+  };
+
+  inline double PackedPoint::GetLat() const
+  {
+    return array->GetLat(index);
+  }
+
+  inline double PackedPoint::GetLon() const
+  {
+    return array->GetLon(index);
+  }
+
+  inline GeoCoord PackedPoint::GetCoord() const
+  {
+    return array->GetCoord(index);
+  }
+
+  inline uint8_t PackedPoint::GetSerial() const
+  {
+    return array->GetSerial(index);
+  }
+
+  inline bool PackedPoint::IsRelevant() const
+  {
+    return array->GetSerial(index)!=0;
+  }
+
+  inline Id PackedPoint::GetId() const
+  {
+    return array->GetId(index);
+  }
+
+  /**
+   * \ingroup Geometry
+   *
+   * Convert the fixed point coordinates in the range [offset,offset+count[
+   * of the given array to degrees. Uses the bulk conversion of CoordinateDecoding,
+   * the result is identical to PackedPointArray::GetLat() and GetLon().
+   */
+  extern OSMSCOUT_API void ConvertPackedCoords(const PackedPointArray& nodes,
+                                               size_t offset,
+                                               size_t count,
+                                               double* lats,
+                                               double* lons);
+
+  /**
+   * \ingroup Geometry
+   *
+   * Returns true, if point in on the area border or within the area. Same
+   * semantics as IsCoordInArea() for std::vector.
+   */
+  extern OSMSCOUT_API bool IsCoordInArea(const GeoCoord& point,
+                                         const PackedPointArray& nodes);
+
+  template<typename N>
+  inline bool IsCoordInArea(const N& point,
+                            const PackedPointArray& nodes)
+  {
+    return IsCoordInArea(GeoCoord(point.GetLat(),
+                                  point.GetLon()),
+                         nodes);
+  }
+
+  extern OSMSCOUT_API double CalculateDistancePointToLineSegments(const GeoCoord& p,
+                                                                  const PackedPointArray& nodes,
+                                                                  size_t& segment,
+                                                                  GeoCoord& intersection);
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef OSMSCOUT_POINTARRAYVIEW_H
+#define OSMSCOUT_POINTARRAYVIEW_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include <osmscout/GeoCoord.h>
+#include <osmscout/PackedPointArray.h>
+#include <osmscout/Point.h>
+
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/GeoBox.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Geometry
+   *
+   * Read-only view of an array of points, as written by FileWriter::Write(const std::vector<Point>&,bool),
+   * pointing directly into the memory mapped data file.
+   *
+   * Creating the view does not decode any coordinate. Coordinates are decoded on demand
+   * while iterating or in bulk into a buffer passed by the caller. This way geometry
+   * can be processed without allocating memory for every object.
+   *
+   * The view is only valid as long as the memory mapping of the FileScanner it was read
+   * from exists (see FileScanner::ShareMapping()).
+   */
+  class OSMSCOUT_API PointArrayView CLASS_FINAL
+  {
+  private:
+    const uint8_t *coordData;  //!< Start of the coordinate data (first coordinate followed by deltas)
+    const uint8_t *serialData; //!< Start of the serial data or nullptr, if there are no serials
+    uint32_t      nodeCount;   //!< Number of points
+    uint8_t       deltaBytes;  //!< Number of bytes for each lat or lon delta (1, 2 or 3)
+
+  public:
+    /**
+     * Forward iterator, decoding one coordinate after the other.
+     */
+    class OSMSCOUT_API CoordIterator CLASS_FINAL
+    {
+    public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef GeoCoord                  value_type;
+      typedef std::ptrdiff_t            difference_type;
+      typedef const GeoCoord*           pointer;
+      typedef GeoCoord                  reference;
+
+    private:
+      const uint8_t *current;
+      size_t        index;
+      size_t        count;
+      uint8_t       deltaBytes;
+      uint32_t      latValue;
+      uint32_t      lonValue;
+
+    private:
+      void DecodeDelta();
+
+    public:
+      CoordIterator(const PointArrayView& view,
+                    size_t index);
+
+      inline GeoCoord operator*() const
+      {
+        return GeoCoord(latValue/latConversionFactor-90.0,
+                        lonValue/lonConversionFactor-180.0);
+      }
+
+      inline CoordIterator& operator++()
+      {
+        index++;
+
+        if (index<count) {
+          DecodeDelta();
+        }
+
+        return *this;
+      }
+
+      inline bool operator==(const CoordIterator& other) const
+      {
+        return index==other.index;
+      }
+
+      inline bool operator!=(const CoordIterator& other) const
+      {
+        return index!=other.index;
+      }
+    };
+
+  public:
+    PointArrayView();
+
+    inline size_t GetSize() const
+    {
+      return nodeCount;
+    }
+
+    inline bool IsEmpty() const
+    {
+      return nodeCount==0;
+    }
+
+    inline bool HasSerials() const
+    {
+      return serialData!=nullptr;
+    }
+
+    inline CoordIterator begin() const
+    {
+      return CoordIterator(*this,0);
+    }
+
+    inline CoordIterator end() const
+    {
+      return CoordIterator(*this,nodeCount);
+    }
+
+    GeoCoord GetFrontCoord() const;
+
+    void DecodeCoords(GeoCoord* coords) const;
+    void GetCoords(std::vector<GeoCoord>& coords) const;
+    void GetPoints(std::vector<Point>& points) const;
+    void GetPackedPoints(PackedPointArray& points) const;
+
+    GeoBox GetBoundingBox() const;
+
+    void Read(FileScanner& scanner,
+              bool readIds);
+  };
+}
+
+#endif
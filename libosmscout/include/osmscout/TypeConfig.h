@@ -768,6 +768,14 @@ namespace osmscout {
     void Read(FileScanner& scanner,
               bool& specialFlag1,
               bool& specialFlag2);
+
+    static void Skip(const TypeInfoRef& type,
+                     FileScanner& scanner);
+    static void Skip(const TypeInfoRef& type,
+                     FileScanner& scanner,
+                     bool& specialFlag1,
+                     bool& specialFlag2);
+
     void Write(FileWriter& writer) const;
     void Write(FileWriter& writer,
                bool specialFlag) const;
@@ -803,7 +811,7 @@ namespace osmscout {
   // Forward declaration
   class TypeConfig;
 
-  static const uint32_t FILE_FORMAT_VERSION=18;
+  static const uint32_t FILE_FORMAT_VERSION=19;
 
   /**
    * \ingroup type
@@ -93,7 +93,9 @@ namespace osmscout {
     WaterIndex();
     virtual ~WaterIndex();
 
-    bool Open(const std::string& path, bool memoryMappedData);
+    bool Open(const std::string& path,
+              bool memoryMappedData,
+              const MmapPolicy& mmapPolicy=MmapPolicy());
     void Close();
 
     bool GetRegions(const GeoBox& boundingBox,
@@ -24,6 +24,7 @@
 
 #include <osmscout/DataFile.h>
 #include <osmscout/Way.h>
+#include <osmscout/WayView.h>
 
 namespace osmscout {
   /**
@@ -36,10 +37,65 @@ namespace osmscout {
     static const char* WAYS_DAT;
     static const char* WAYS_IDMAP;
 
+  protected:
+    bool ReadBoundingBox(FileScanner& scanner,
+                         GeoBox& boundingBox) const override;
+
   public:
-    WayDataFile(size_t cacheSize);
+    WayDataFile(size_t cacheSize,
+                size_t cacheMemory=0);
+
+    template<typename IteratorIn>
+    bool GetViewsByOffset(IteratorIn begin, IteratorIn end, size_t size,
+                          std::vector<WayView>& views) const;
+
+    bool GetFeatures(const WayView& view,
+                     FeatureValueBuffer& buffer) const;
   };
 
+  /**
+   * Read views of the ways at the given file offsets and append them to the given vector.
+   * The views are not cached and point into the memory mapping of the data file, so
+   * they are only valid as long as the data file is open.
+   *
+   * Returns false, if the data file is not memory mapped.
+   *
+   * Method is thread-safe.
+   */
+  template<typename IteratorIn>
+  bool WayDataFile::GetViewsByOffset(IteratorIn begin, IteratorIn end, size_t size,
+                                     std::vector<WayView>& views) const
+  {
+    ScannerLease scanner(*this);
+
+    if (!scanner.IsValid()) {
+      return false;
+    }
+
+    if (!(*scanner).IsMemoryMapped()) {
+      log.Error() << "Cannot create way views, '" << GetFilename() << "' is not memory mapped";
+      return false;
+    }
+
+    views.reserve(views.size()+size);
+
+    try {
+      for (IteratorIn offsetIter=begin; offsetIter!=end; ++offsetIter) {
+        (*scanner).SetPos(*offsetIter);
+
+        views.emplace_back();
+        views.back().Read(*typeConfig,
+                          *scanner);
+      }
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      return false;
+    }
+
+    return true;
+  }
+
   typedef std::shared_ptr<WayDataFile> WayDataFileRef;
 }
 
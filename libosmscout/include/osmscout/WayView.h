@@ -0,0 +1,102 @@
+#ifndef OSMSCOUT_WAYVIEW_H
+#define OSMSCOUT_WAYVIEW_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/ObjectRef.h>
+#include <osmscout/PointArrayView.h>
+#include <osmscout/TypeConfig.h>
+
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/GeoBox.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  class WayDataFile;
+
+  /**
+   * \ingroup Database
+   *
+   * Lightweight, read-only view of a way in the memory mapped 'ways.dat' file.
+   *
+   * In contrast to Way, reading a WayView does not allocate memory: Features
+   * are skipped and only decoded on request via WayDataFile::GetFeatures() and the nodes
+   * are a PointArrayView into the memory mapping, decoding coordinates on demand.
+   *
+   * A WayView is only valid as long as the WayDataFile it was read from is open.
+   */
+  class OSMSCOUT_API WayView CLASS_FINAL
+  {
+  private:
+    TypeInfoRef    type;           //!< Type of the way
+    FileOffset     fileOffset;     //!< Offset into the data file of this way
+    FileOffset     nextFileOffset; //!< Offset after this way
+    FileOffset     featureOffset;  //!< Offset of the features of this way
+
+  public:
+    PointArrayView nodes;          //!< List of nodes
+
+  public:
+    WayView();
+
+    inline FileOffset GetFileOffset() const
+    {
+      return fileOffset;
+    }
+
+    inline FileOffset GetNextFileOffset() const
+    {
+      return nextFileOffset;
+    }
+
+    inline ObjectFileRef GetObjectFileRef() const
+    {
+      return {fileOffset,refWay};
+    }
+
+    inline TypeInfoRef GetType() const
+    {
+      return type;
+    }
+
+    inline GeoBox GetBoundingBox() const
+    {
+      return nodes.GetBoundingBox();
+    }
+
+    inline bool Intersects(const GeoBox& boundingBox) const
+    {
+      return GetBoundingBox().Intersects(boundingBox);
+    }
+
+    void Read(const TypeConfig& typeConfig,
+              FileScanner& scanner);
+
+  private:
+    void ReadFeatures(FileScanner& scanner,
+                      FeatureValueBuffer& buffer) const;
+
+    friend class WayDataFile;
+  };
+}
+
+#endif
@@ -24,6 +24,7 @@
 #include <functional>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -36,6 +37,9 @@
 #include <osmscout/routing/Route.h>
 #include <osmscout/routing/RouteData.h>
 #include <osmscout/routing/RouteNode.h>
+#include <osmscout/routing/RouteGraph.h>
+#include <osmscout/routing/RoutePredecessorTable.h>
+#include <osmscout/routing/LandmarkTable.h>
 #include <osmscout/routing/RoutingService.h>
 #include <osmscout/routing/MultiDBRoutingState.h>
 
@@ -52,6 +56,157 @@ namespace osmscout {
   protected:
     bool debugPerformance;
 
+    /**
+     * Start or target route node of a bidirectional search
+     */
+    struct BidirectionalTerminal
+    {
+      DBId     id;    //!< Id of the route node
+      GeoCoord coord; //!< Coordinate of the route node
+      double   cost;  //!< Costs from the start position to the route node (zero for target route nodes)
+    };
+
+    /**
+     * Per search state for the lower bounds of the route costs returned by
+     * GetRouteCostBound(). It is part of the search state, so that searches
+     * with different profiles can run at the same time.
+     */
+    struct RouteCostBounds
+    {
+      std::vector<DBId>               targets;   //!< Target route nodes of the A* search for GetRouteCostBound(), empty if disabled
+      std::vector<LandmarkCostBounds> landmarks; //!< Landmark table and time factor by database, see PrepareRouteCostBounds()
+    };
+
+    /**
+     * State of a bidirectional search, that is not part of the open lists and closed sets
+     */
+    struct BidirectionalQuery
+    {
+      Vehicle                            vehicle;
+      std::vector<BidirectionalTerminal> starts;            //!< Start route nodes
+      std::vector<BidirectionalTerminal> targets;           //!< Target route nodes
+      double                             costLimit;         //!< Maximum costs of a route
+      double                             bestCost;          //!< Costs of the cheapest route found so far
+      VNode                              forwardMeeting;    //!< Meeting node of the cheapest route, as reached from the start
+      VNode                              backwardMeeting;   //!< Meeting node of the cheapest route, as reached from the target
+      size_t                             nodesIgnoredCount; //!< Number of paths ignored
+      const RouteCostBounds*             costBounds;        //!< Bounds for GetRouteCostBound(), nullptr if not used
+    };
+
+    /**
+     * Route node next to a target position of a matrix calculation, with the costs,
+     * the length and the travel time from the route node to the target position
+     */
+    struct MatrixTargetNode
+    {
+      size_t   target;   //!< Index of the target position
+      double   cost;
+      Distance distance;
+      double   time;
+    };
+
+    /**
+     * Start and target route nodes of a matrix calculation, shared by all searches
+     */
+    struct MatrixQuery
+    {
+      Vehicle                                    vehicle;
+      std::vector<std::vector<RNode>>            startNodes;      //!< Start route nodes by source, empty if the source could not be resolved
+      std::vector<double>                        costLimits;      //!< Maximum costs of a route by source
+      std::unordered_map<DBId,size_t>            targetNodeIndex; //!< Index in targetNodes by route node
+      std::vector<std::vector<MatrixTargetNode>> targetNodes;     //!< Target positions next to each target route node
+    };
+
+    /**
+     * Search state of a Dijkstra search of a matrix or reachability calculation,
+     * one instance is used by each thread
+     */
+    struct DijkstraSearch
+    {
+      OpenList  openList;
+      OpenMap   openMap;
+      ClosedSet closedSet;
+      ClosedSet closedRestrictedSet;
+    };
+
+    //! Index of the closed state of a graph node reached via usable ways
+    static const size_t GRAPH_ACCESS=0;
+    //! Index of the closed state of a graph node reached via restricted ways
+    static const size_t GRAPH_RESTRICTED=1;
+
+    /**
+     * Search state of a node of the RouteGraph. The open state is only the costs,
+     * the rest is part of the open list entry. A node may be closed twice, once
+     * reached via usable ways and once via restricted ways, like for the route node
+     * based search.
+     */
+    struct GraphNode
+    {
+      double   openCost;        //!< Costs of the open list entry of the node, infinity if not open
+      double   closedCost[2];   //!< Costs, if closed
+      uint32_t closedPrev[2];   //!< Previous node, if closed (RouteGraph::NO_NODE for start nodes)
+      uint32_t closedObject[2]; //!< Object we came from, if closed
+      bool     closed[2];       //!< Closed reached via usable (GRAPH_ACCESS) or restricted (GRAPH_RESTRICTED) ways
+    };
+
+    /**
+     * Entry of the open list of a search on the RouteGraph. There may be outdated
+     * entries for a node, they are skipped, if their costs do not match the
+     * open costs of the node.
+     */
+    struct GraphOpenEntry
+    {
+      double   overallCost;
+      double   currentCost;
+      uint32_t node;
+      uint32_t prev;
+      uint32_t object;
+      bool     access;
+
+      inline bool operator>(const GraphOpenEntry& other) const
+      {
+        return overallCost>other.overallCost;
+      }
+    };
+
+    /**
+     * Search state of a route calculation. Each running calculation uses its own
+     * instance, finished instances are kept, so that subsequent calculations reuse
+     * the allocated memory.
+     */
+    struct RouteSearch
+    {
+      OpenList  openList;                    //!< Sorted list (smallest cost first) of nodes to check
+      OpenMap   openMap;                     //!< Map routing nodes by id to their RNode
+      ClosedSet closedSet;                   //!< Route nodes already handled
+      ClosedSet closedRestrictedSet;         //!< Route nodes already handled, reached via restricted ways
+
+      // Search state of the backward search of the bidirectional A*. The previous node
+      // of a node is the next node on the way to the target, access is false,
+      // if the route from the node to the target only uses restricted ways.
+      OpenList  backwardOpenList;            //!< Sorted list (smallest cost first) of nodes to check
+      OpenMap   backwardOpenMap;             //!< Map routing nodes by id to their RNode
+      ClosedSet backwardClosedSet;           //!< Route nodes already handled
+      ClosedSet backwardClosedRestrictedSet; //!< Route nodes already handled, only restricted ways to the target
+
+      RouteCostBounds costBounds;            //!< Targets and bounds for GetRouteCostBound()
+
+      // Search state of the A* on the RouteGraph, indexed by node
+      std::vector<GraphNode>      graphNodes;     //!< State of all nodes of the graph
+      std::vector<uint32_t>       graphVisited;   //!< Nodes with a modified state, to be reset by the next search
+      std::vector<GraphOpenEntry> graphOpenList;  //!< Binary heap (smallest overall cost first) of open nodes
+    };
+
+  private:
+    std::mutex                                routeSearchMutex; //!< Secures access to routeSearches
+    std::vector<std::unique_ptr<RouteSearch>> routeSearches;    //!< Search states currently not in use
+
+    std::mutex        routeNodeMutex;  //!< Serializes loading of route nodes by the parallel searches of a matrix calculation
+
+  private:
+    std::unique_ptr<RouteSearch> AcquireRouteSearch();
+    void ReleaseRouteSearch(std::unique_ptr<RouteSearch>&& search);
+
   protected:
     virtual Vehicle GetVehicle(const RoutingState& state) = 0;
 
@@ -60,6 +215,10 @@ namespace osmscout {
                         const RouteNode& routeNode,
                         size_t pathIndex) = 0;
 
+    virtual bool CanUse(const RoutingState& state,
+                        DatabaseId database,
+                        const RouteGraph::Edge& edge) = 0;
+
     virtual bool CanUseForward(const RoutingState& state,
                                const DatabaseId& database,
                                const WayRef& way) = 0;
@@ -73,11 +232,25 @@ namespace osmscout {
                             const RouteNode& routeNode,
                             size_t pathIndex) = 0;
 
+    virtual double GetCosts(const RoutingState& state,
+                            DatabaseId database,
+                            const RouteGraph::Edge& edge) = 0;
+
     virtual double GetCosts(const RoutingState& state,
                             DatabaseId database,
                             const WayRef &way,
                             const Distance &wayLength) = 0;
 
+    virtual double GetTime(const RoutingState& state,
+                           DatabaseId database,
+                           const RouteNode& routeNode,
+                           size_t pathIndex) = 0;
+
+    virtual double GetTime(const RoutingState& state,
+                           DatabaseId database,
+                           const WayRef &way,
+                           const Distance &wayLength) = 0;
+
     virtual double GetEstimateCosts(const RoutingState& state,
                                     DatabaseId database,
                                     const Distance &targetDistance) = 0;
@@ -86,6 +259,38 @@ namespace osmscout {
                                 DatabaseId database,
                                 const Distance &targetDistance) = 0;
 
+    /**
+     * Called before a search using GetRouteCostBound() is started, to allow
+     * preparation of the bounds for the current profile. The prepared state
+     * is stored in the passed bounds of the search.
+     */
+    virtual void PrepareRouteCostBounds(const RoutingState& state,
+                                        RouteCostBounds& bounds) = 0;
+
+    /**
+     * Return a lower bound for the costs of any route from route node 'from' to
+     * route node 'to' (for example based on landmark distances), or 0,
+     * if no bound is known.
+     */
+    virtual double GetRouteCostBound(const RoutingState& state,
+                                     const RouteCostBounds& bounds,
+                                     const DBId& from,
+                                     const DBId& to) = 0;
+
+    /**
+     * Return the compact routing graph of the given database, or nullptr,
+     * if it is not available.
+     */
+    virtual const RouteGraph* GetRouteGraph(const RoutingState& state,
+                                            DatabaseId database) = 0;
+
+    /**
+     * Return the predecessors of the route nodes of the given database, or nullptr,
+     * if they are not available.
+     */
+    virtual const RoutePredecessorTable* GetRoutePredecessors(const RoutingState& state,
+                                                              DatabaseId database) = 0;
+
     virtual bool GetRouteNodes(const std::set<DBId> &routeNodeIds,
                                std::unordered_map<DBId,RouteNodeRef> &routeNodeMap) = 0;
 
@@ -151,6 +356,7 @@ namespace osmscout {
                        const RoutePosition& position,
                        GeoCoord& startCoord,
                        const GeoCoord& targetCoord,
+                       const RouteCostBounds& costBounds,
                        RouteNodeRef& forwardRouteNode,
                        RouteNodeRef& backwardRouteNode,
                        RNodeRef& forwardRNode,
@@ -168,6 +374,12 @@ namespace osmscout {
                         RouteNodeRef& forwardNode,
                         RouteNodeRef& backwardNode);
 
+    double GetTargetEstimateCosts(const RoutingState& state,
+                                  const DBId& id,
+                                  const GeoCoord& coord,
+                                  const GeoCoord& targetCoord,
+                                  const RouteCostBounds& costBounds);
+
     bool GetRNode(const RoutingState& state,
                   const RoutePosition& position,
                   const WayRef& way,
@@ -175,6 +387,7 @@ namespace osmscout {
                   const RouteNodeRef& routeNode,
                   const GeoCoord& startCoord,
                   const GeoCoord& targetCoord,
+                  const RouteCostBounds& costBounds,
                   RNodeRef& node);
 
     void AddNodes(RouteData& route,
@@ -190,6 +403,7 @@ namespace osmscout {
                           const RoutePosition& position,
                           GeoCoord& startCoord,
                           const GeoCoord& targetCoord,
+                          const RouteCostBounds& costBounds,
                           RouteNodeRef& forwardRouteNode,
                           RouteNodeRef& backwardRouteNode,
                           RNodeRef& forwardRNode,
@@ -202,7 +416,7 @@ namespace osmscout {
                                   RouteData& route);
 
     virtual bool WalkToOtherDatabases(const RoutingState& state,
-                                      RNodeRef &current,
+                                      RNode &current,
                                       RouteNodeRef &currentRouteNode,
                                       OpenList &openList,
                                       OpenMap &openMap,
@@ -210,7 +424,7 @@ namespace osmscout {
                                       const ClosedSet &closedRestrictedSet);
 
     virtual bool WalkPaths(const RoutingState& state,
-                           RNodeRef &current,
+                           RNode &current,
                            RouteNodeRef &currentRouteNode,
                            OpenList &openList,
                            OpenMap &openMap,
@@ -219,19 +433,96 @@ namespace osmscout {
                            RoutingResult &result,
                            const RoutingParameter& parameter,
                            const GeoCoord &targetCoord,
+                           const RouteCostBounds& costBounds,
                            const Vehicle &vehicle,
                            size_t &nodesIgnoredCount,
                            Distance &currentMaxDistance,
                            const Distance &overallDistance,
                            const double &costLimit);
+    void GetBidirectionalEstimates(const RoutingState& state,
+                                   const DBId& id,
+                                   const GeoCoord& coord,
+                                   const BidirectionalQuery& query,
+                                   double& startEstimate,
+                                   double& targetEstimate);
+
+    void CheckBidirectionalMeeting(const RouteNode& routeNode,
+                                   const RNode& forwardNode,
+                                   const RNode& backwardNode,
+                                   BidirectionalQuery& query);
+
+    bool WalkPathsForward(const RoutingState& state,
+                          RNode& current,
+                          BidirectionalQuery& query,
+                          RouteSearch& search);
+
+    bool WalkPathsBackward(const RoutingState& state,
+                           RNode& current,
+                           BidirectionalQuery& query,
+                           RouteSearch& search);
+
+    RoutingResult CalculateRouteAStar(RoutingState& state,
+                                      const RoutePosition& start,
+                                      const RoutePosition& target,
+                                      const RoutingParameter& parameter,
+                                      RouteSearch& search);
+
+    bool CalculateRouteOnGraph(RoutingState& state,
+                               const RouteGraph& graph,
+                               const RoutePosition& start,
+                               const RoutePosition& target,
+                               const RoutingParameter& parameter,
+                               RouteSearch& search,
+                               RoutingResult& result);
+
+    RoutingResult CalculateRouteBidirectional(RoutingState& state,
+                                              const RoutePosition& start,
+                                              const RoutePosition& target,
+                                              const RoutingParameter& parameter,
+                                              RouteSearch& search);
+
+    bool GetDijkstraStartNodes(const RoutingState& state,
+                               const RoutePosition& position,
+                               GeoCoord& coord,
+                               std::vector<RNode>& nodes);
+
+    bool GetMatrixTargetNodes(const RoutingState& state,
+                              const RoutePosition& position,
+                              size_t target,
+                              GeoCoord& coord,
+                              MatrixQuery& query);
+
+    bool WalkDijkstraPaths(const RoutingState& state,
+                           RNode& current,
+                           const Vehicle& vehicle,
+                           double costLimit,
+                           DijkstraSearch& search);
+
+    bool CalculateMatrixRow(const RoutingState& state,
+                            const MatrixQuery& query,
+                            size_t source,
+                            const RoutingParameter& parameter,
+                            DijkstraSearch& search,
+                            RoutingMatrix& matrix);
+
   public:
     explicit AbstractRoutingService(const RouterParameter& parameter);
     ~AbstractRoutingService() override;
 
-    RoutingResult CalculateRoute(RoutingState& state,
-                                 const RoutePosition& start,
-                                 const RoutePosition& target,
-                                 const RoutingParameter& parameter);
+    virtual RoutingResult CalculateRoute(RoutingState& state,
+                                         const RoutePosition& start,
+                                         const RoutePosition& target,
+                                         const RoutingParameter& parameter);
+
+    RoutingMatrix CalculateMatrix(RoutingState& state,
+                                  const std::vector<RoutePosition>& sources,
+                                  const std::vector<RoutePosition>& targets,
+                                  const RoutingParameter& parameter);
+
+    ReachabilityResult CalculateReachability(RoutingState& state,
+                                             const RoutePosition& start,
+                                             double costLimit,
+                                             const RoutingParameter& parameter);
 
     bool TransformRouteDataToRouteDescription(const RouteData& data,
                                               RouteDescription& description);
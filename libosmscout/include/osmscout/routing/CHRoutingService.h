@@ -0,0 +1,92 @@
+#ifndef OSMSCOUT_CHROUTINGSERVICE_H
+#define OSMSCOUT_CHROUTINGSERVICE_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <osmscout/CoreFeatures.h>
+
+#include <osmscout/routing/ContractionHierarchy.h>
+#include <osmscout/routing/SimpleRoutingService.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Service
+   * \ingroup Routing
+   *
+   * Routing service calculating routes using the contraction hierarchies
+   * generated by the import (see ImportParameter::SetRouterCH()).
+   *
+   * Start and target handling as well as the resulting RouteData are identical
+   * to SimpleRoutingService, only the search between the route nodes next to
+   * start and target is replaced by a query on the contraction hierarchy.
+   *
+   * The service falls back to the A* search of SimpleRoutingService, if
+   * - there is no hierarchy for the vehicle of the given profile,
+   * - the given profile has other costs than the profile used for the
+   *   hierarchy during import (see ContractionHierarchy::IsCompatible()),
+   * - the hierarchy does not contain a route (for example because the target
+   *   can only be reached via restricted ways) or
+   * - the resulting route violates a turn restriction.
+   *
+   * Costs within the hierarchy are calculated during import, the given profile
+   * is only used for the costs from the start and to the target route node.
+   */
+  class OSMSCOUT_API CHRoutingService : public SimpleRoutingService
+  {
+  private:
+    DatabaseRef                           database;     //!< Database object, holding all index and data files
+    std::string                           filenamebase; //!< Common base name for all router files
+    std::map<Vehicle,ContractionHierarchy> hierarchies; //!< Loaded hierarchies by vehicle
+
+  private:
+    bool ViolatesTurnRestrictions(const RoutePosition& start,
+                                  const std::vector<ContractionHierarchy::Step>& steps);
+
+  public:
+    CHRoutingService(const DatabaseRef& database,
+                     const RouterParameter& parameter,
+                     const std::string& filenamebase);
+    ~CHRoutingService() override;
+
+    bool Open() override;
+    void Close() override;
+
+    bool HasContractionHierarchy(Vehicle vehicle) const;
+
+    RoutingResult CalculateRoute(RoutingProfile& profile,
+                                 const RoutePosition& start,
+                                 const RoutePosition& target,
+                                 const RoutingParameter& parameter) override;
+  };
+
+  //! \ingroup Service
+  //! Reference counted reference to an CHRoutingService instance
+  typedef std::shared_ptr<CHRoutingService> CHRoutingServiceRef;
+}
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef OSMSCOUT_CONTRACTIONHIERARCHY_H
+#define OSMSCOUT_CONTRACTIONHIERARCHY_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <osmscout/CoreImportExport.h>
+
+#include <osmscout/ObjectRef.h>
+#include <osmscout/OSMScoutTypes.h>
+
+#include <osmscout/routing/RoutingProfile.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Routing
+   *
+   * Contraction hierarchy of the routing graph for one vehicle, as generated by
+   * the import (see RoutingService::GetCHFilename()).
+   *
+   * All route nodes are ordered by "importance" (rank). For every node only the
+   * edges to nodes with a higher rank are stored, in forward direction ("up")
+   * and in backward direction ("down"). Edges are either original paths of the
+   * routing graph or shortcuts, replacing the two edges via a contracted node
+   * of lower rank.
+   *
+   * A route is calculated by a bidirectional Dijkstra search that only follows
+   * edges to higher ranked nodes, so only a small part of the graph is visited.
+   * Shortcuts in the result are unpacked to the original paths.
+   *
+   * Edge costs are calculated during import using a FastestPathRoutingProfile
+   * parametrized by the import parameter. Its speeds are stored in the file, so
+   * the hierarchy is only used for profiles with the same costs (see
+   * IsCompatible()). Turn restrictions and restricted ("access=destination")
+   * paths are not part of the hierarchy.
+   */
+  class OSMSCOUT_API ContractionHierarchy CLASS_FINAL
+  {
+  public:
+    //! Marker for an invalid node index
+    static const uint32_t NO_NODE;
+
+    /**
+     * Edge to a node with a higher rank
+     */
+    struct Edge
+    {
+      uint32_t target; //!< Index of the node at the other end of the edge
+      uint32_t middle; //!< Index of the contracted node for shortcuts, NO_NODE for original paths
+      uint32_t object; //!< Index of the object (way/area) for original paths
+      double   cost;   //!< Costs of the edge
+    };
+
+    /**
+     * Route node to start from or to end at, with the costs to reach (or leave) it
+     */
+    struct Terminal
+    {
+      Id     id;
+      double cost;
+    };
+
+    /**
+     * One original path of the resulting route
+     */
+    struct Step
+    {
+      Id            from;   //!< Id of the route node the path starts at
+      Id            to;     //!< Id of the route node the path ends at
+      ObjectFileRef object; //!< Object (way/area) the path follows
+    };
+
+  private:
+    std::string                filename;    //!< Name of the file loaded
+    double                     maxSpeed;    //!< Maximum speed of the vehicle of the profile used for the costs
+    std::vector<double>        typeSpeeds;  //!< Speed by type index of the profile used for the costs
+    std::vector<Id>            nodeIds;     //!< Ids of all route nodes, sorted
+    std::vector<uint32_t>      upOffsets;   //!< Index of the first up edge of each node (+1 entry)
+    std::vector<Edge>          upEdges;     //!< Edges to nodes with higher rank, forward direction
+    std::vector<uint32_t>      downOffsets; //!< Index of the first down edge of each node (+1 entry)
+    std::vector<Edge>          downEdges;   //!< Edges from nodes with higher rank, 'target' is the source
+    std::vector<ObjectFileRef> objects;     //!< Objects referenced by the original paths
+
+  private:
+    bool FindEdge(const std::vector<uint32_t>& offsets,
+                  const std::vector<Edge>& edges,
+                  uint32_t node,
+                  uint32_t target,
+                  Edge& edge) const;
+    bool Unpack(uint32_t from,
+                uint32_t to,
+                const Edge& edge,
+                std::vector<Step>& steps) const;
+
+  public:
+    ContractionHierarchy();
+
+    bool Load(const std::string& filename);
+    void Clear();
+
+    inline bool IsLoaded() const
+    {
+      return !nodeIds.empty();
+    }
+
+    inline std::string GetFilename() const
+    {
+      return filename;
+    }
+
+    inline size_t GetNodeCount() const
+    {
+      return nodeIds.size();
+    }
+
+    inline size_t GetEdgeCount() const
+    {
+      return upEdges.size()+downEdges.size();
+    }
+
+    bool IsCompatible(const RoutingProfile& profile) const;
+
+    uint32_t GetNodeIndex(Id id) const;
+
+    bool CalculateRoute(const std::vector<Terminal>& sources,
+                        const std::vector<Terminal>& targets,
+                        std::vector<Step>& steps,
+                        double& cost,
+                        size_t& settledNodeCount) const;
+  };
+}
+
+#endif
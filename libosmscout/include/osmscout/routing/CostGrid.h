@@ -0,0 +1,112 @@
+#ifndef OSMSCOUT_ROUTING_COSTGRID_H
+#define OSMSCOUT_ROUTING_COSTGRID_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <vector>
+
+#include <osmscout/CoreImportExport.h>
+
+#include <osmscout/GeoCoord.h>
+
+#include <osmscout/routing/RoutingService.h>
+
+#include <osmscout/util/Distance.h>
+#include <osmscout/util/GeoBox.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Routing
+   *
+   * Regular grid of cells over a bounding box holding the minimum costs to reach
+   * each cell, as calculated from a ReachabilityResult. The grid can be used to
+   * render a heat map of the costs or to build iso-polygons ("isochrones").
+   *
+   * Each edge between reached route nodes is rasterized, with the costs
+   * interpolated between both ends. Cells not touched by an edge are
+   * unreachable. Edges only partially reachable within the cost limit are
+   * not part of the result and are thus missing at the border.
+   */
+  class OSMSCOUT_API CostGrid CLASS_FINAL
+  {
+  public:
+    //! Costs of a cell that cannot be reached
+    static const double UNREACHABLE;
+
+  private:
+    GeoBox              boundingBox;
+    size_t              columns;
+    size_t              rows;
+    double              cellWidth;  //!< Width of a cell in degrees of longitude
+    double              cellHeight; //!< Height of a cell in degrees of latitude
+    std::vector<double> costs;      //!< Costs of each cell, row by row starting at the south
+
+  private:
+    void AddSegment(const GeoCoord& from,
+                    double fromCost,
+                    const GeoCoord& to,
+                    double toCost);
+
+  public:
+    CostGrid();
+    CostGrid(const GeoBox& boundingBox,
+             size_t columns,
+             size_t rows);
+
+    void Add(const ReachabilityResult& result);
+
+    static CostGrid Create(const ReachabilityResult& result,
+                           const Distance& cellSize);
+
+    inline GeoBox GetBoundingBox() const
+    {
+      return boundingBox;
+    }
+
+    inline size_t GetColumns() const
+    {
+      return columns;
+    }
+
+    inline size_t GetRows() const
+    {
+      return rows;
+    }
+
+    /**
+     * Return the costs of the given cell, UNREACHABLE if not reached
+     */
+    inline double GetCost(size_t column,
+                          size_t row) const
+    {
+      return costs[row*columns+column];
+    }
+
+    GeoBox GetCellBoundingBox(size_t column,
+                              size_t row) const;
+
+    std::vector<std::vector<GeoCoord>> GetIsoPolygons(double costLimit) const;
+  };
+}
+
+#endif
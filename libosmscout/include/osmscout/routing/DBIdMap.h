@@ -0,0 +1,254 @@
+#ifndef OSMSCOUT_ROUTING_DBIDMAP_H
+#define OSMSCOUT_ROUTING_DBIDMAP_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <osmscout/routing/DBFileOffset.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Routing
+   *
+   * Hash map from DBId to a value, using open addressing with linear probing
+   * in one flat array.
+   *
+   * The map is meant to be reused by subsequent routing queries: Clear() is
+   * O(1) and keeps the allocated memory (slots of previous runs are marked
+   * invalid by a generation counter). Entries cannot be removed individually.
+   *
+   * The value type must be default constructible and copy assignable.
+   */
+  template<typename V>
+  class DBIdMap
+  {
+  private:
+    struct Slot
+    {
+      uint32_t generation; //!< Slot is used, if equal to the current generation of the map
+      DBId     key;
+      V        value;
+    };
+
+    static const size_t INITIAL_CAPACITY=1024;
+
+  private:
+    std::vector<Slot> slots;
+    size_t            mask;
+    size_t            size;
+    uint32_t          generation;
+
+  private:
+    static inline size_t Hash(const DBId& key)
+    {
+      uint64_t hash=(key.id ^ (uint64_t(key.database) << 56))*0x9E3779B97F4A7C15ull;
+
+      return size_t(hash ^ (hash >> 29));
+    }
+
+    /**
+     * Return the slot for the given key, either the slot holding the key or the
+     * empty slot where the key would be inserted
+     */
+    inline size_t FindSlot(const DBId& key) const
+    {
+      size_t index=Hash(key) & mask;
+
+      while (slots[index].generation==generation &&
+             slots[index].key!=key) {
+        index=(index+1) & mask;
+      }
+
+      return index;
+    }
+
+    void Rehash(size_t capacity)
+    {
+      std::vector<Slot> oldSlots(capacity);
+
+      oldSlots.swap(slots);
+      mask=capacity-1;
+
+      uint32_t oldGeneration=generation;
+
+      generation=1;
+
+      for (auto& slot : oldSlots) {
+        if (slot.generation==oldGeneration) {
+          Slot& newSlot=slots[FindSlot(slot.key)];
+
+          newSlot.generation=generation;
+          newSlot.key=slot.key;
+          newSlot.value=slot.value;
+        }
+      }
+    }
+
+    inline void Grow()
+    {
+      // Keep the load factor below 1/2
+      if (2*(size+1)>slots.size()) {
+        Rehash(2*slots.size());
+      }
+    }
+
+  public:
+    DBIdMap()
+    : slots(INITIAL_CAPACITY),
+      mask(INITIAL_CAPACITY-1),
+      size(0),
+      generation(1)
+    {
+      // no code
+    }
+
+    /**
+     * Remove all entries, keeping the allocated memory
+     */
+    void Clear()
+    {
+      size=0;
+      generation++;
+
+      // Overflow, we have to reset all slots
+      if (generation==0) {
+        for (auto& slot : slots) {
+          slot.generation=0;
+        }
+
+        generation=1;
+      }
+    }
+
+    /**
+     * Make sure, that the given number of entries can be stored without rehashing
+     */
+    void Reserve(size_t count)
+    {
+      size_t capacity=slots.size();
+
+      while (capacity<2*count) {
+        capacity*=2;
+      }
+
+      if (capacity!=slots.size()) {
+        Rehash(capacity);
+      }
+    }
+
+    inline size_t Size() const
+    {
+      return size;
+    }
+
+    inline bool IsEmpty() const
+    {
+      return size==0;
+    }
+
+    /**
+     * Return a pointer to the value of the given key or nullptr, if the key is
+     * not part of the map
+     */
+    inline const V* Find(const DBId& key) const
+    {
+      const Slot& slot=slots[FindSlot(key)];
+
+      return slot.generation==generation ? &slot.value : nullptr;
+    }
+
+    inline V* Find(const DBId& key)
+    {
+      Slot& slot=slots[FindSlot(key)];
+
+      return slot.generation==generation ? &slot.value : nullptr;
+    }
+
+    inline bool Contains(const DBId& key) const
+    {
+      return Find(key)!=nullptr;
+    }
+
+    /**
+     * Insert the given value, if there is no entry for the key yet.
+     *
+     * @return
+     *    true, if the value was inserted, false if there already was an entry
+     *    (which is left unchanged)
+     */
+    bool Insert(const DBId& key,
+                const V& value)
+    {
+      Grow();
+
+      Slot& slot=slots[FindSlot(key)];
+
+      if (slot.generation==generation) {
+        return false;
+      }
+
+      slot.generation=generation;
+      slot.key=key;
+      slot.value=value;
+      size++;
+
+      return true;
+    }
+
+    /**
+     * Return the value of the given key, inserting a default constructed value
+     * if there is no entry yet
+     */
+    V& operator[](const DBId& key)
+    {
+      Grow();
+
+      Slot& slot=slots[FindSlot(key)];
+
+      if (slot.generation!=generation) {
+        slot.generation=generation;
+        slot.key=key;
+        slot.value=V();
+        size++;
+      }
+
+      return slot.value;
+    }
+
+    /**
+     * Call the given function for all values in the map (in no particular order)
+     */
+    template<typename F>
+    void Visit(F function) const
+    {
+      for (const auto& slot : slots) {
+        if (slot.generation==generation) {
+          function(slot.value);
+        }
+      }
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef OSMSCOUT_ROUTING_LANDMARKTABLE_H
+#define OSMSCOUT_ROUTING_LANDMARKTABLE_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <osmscout/CoreImportExport.h>
+
+#include <osmscout/OSMScoutTypes.h>
+#include <osmscout/TypeConfig.h>
+
+#include <osmscout/routing/RoutingProfile.h>
+
+#include <osmscout/util/Distance.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Routing
+   *
+   * Distances and travel times of all route nodes from and to a small number of
+   * landmarks for one vehicle, as generated by the import (see
+   * RoutingService::GetLandmarkFilename()).
+   *
+   * Using the triangle inequality they give a lower bound for the length and the
+   * travel time of any route between two route nodes (ALT heuristic), that is in
+   * general much better than the estimate based on the spherical distance.
+   *
+   * Distances are based on all paths usable by the vehicle, so they are valid
+   * for every profile. Travel times are calculated using the default
+   * FastestPathRoutingProfile of the vehicle ("reference speeds"). For other
+   * speeds they are scaled by the smallest ratio of reference speed and current
+   * speed over all types (see GetTimeFactor()).
+   */
+  class OSMSCOUT_API LandmarkTable CLASS_FINAL
+  {
+  public:
+    //! Marker for an invalid node index
+    static const uint32_t NO_NODE;
+    //! Marker for a landmark not reachable from or not reaching a node
+    static const uint32_t UNREACHABLE;
+    //! Number of travel time units per hour
+    static const double   TIME_UNITS_PER_HOUR;
+
+  private:
+    std::string           filename;                  //!< Name of the file loaded
+    std::vector<Id>       nodeIds;                   //!< Ids of all route nodes, sorted
+    std::vector<uint32_t> landmarks;                 //!< Node index of each landmark
+    std::vector<uint32_t> values;                    //!< For each node and landmark distance from and to the landmark, followed by the travel time from and to the landmark
+    double                referenceVehicleMaxSpeed;  //!< Maximum speed of the vehicle used for the travel times
+    std::vector<double>   referenceSpeeds;           //!< Speed used for the travel times by type index
+
+  public:
+    LandmarkTable();
+
+    bool Load(const TypeConfig& typeConfig,
+              const std::string& filename);
+    void Clear();
+
+    inline bool IsLoaded() const
+    {
+      return !nodeIds.empty();
+    }
+
+    inline std::string GetFilename() const
+    {
+      return filename;
+    }
+
+    inline size_t GetNodeCount() const
+    {
+      return nodeIds.size();
+    }
+
+    inline size_t GetLandmarkCount() const
+    {
+      return landmarks.size();
+    }
+
+    uint32_t GetNodeIndex(Id id) const;
+
+    double GetTimeFactor(const AbstractRoutingProfile& profile) const;
+
+    void GetLowerBounds(uint32_t from,
+                        uint32_t to,
+                        Distance& distance,
+                        double& time) const;
+  };
+
+  /**
+   * \ingroup Routing
+   *
+   * Landmark table and travel time factor selected for the profile of a single
+   * search (see SimpleRoutingService::GetLandmarkCostBounds()).
+   */
+  struct LandmarkCostBounds
+  {
+    const LandmarkTable* table=nullptr; //!< Landmark table for the vehicle of the profile, or nullptr
+    double               timeFactor=0.0; //!< Factor for the landmark travel times
+  };
+}
+
+#endif
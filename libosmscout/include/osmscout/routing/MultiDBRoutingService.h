@@ -75,11 +75,25 @@ namespace osmscout {
                     const RouteNode& routeNode,
                     size_t pathIndex) override;
 
+    double GetCosts(const MultiDBRoutingState& state,
+                    DatabaseId databaseId,
+                    const RouteGraph::Edge& edge) override;
+
     double GetCosts(const MultiDBRoutingState& state,
                     DatabaseId database,
                     const WayRef &way,
                     const Distance &wayLength) override;
 
+    double GetTime(const MultiDBRoutingState& state,
+                   DatabaseId databaseId,
+                   const RouteNode& routeNode,
+                   size_t pathIndex) override;
+
+    double GetTime(const MultiDBRoutingState& state,
+                   DatabaseId database,
+                   const WayRef &way,
+                   const Distance &wayLength) override;
+
     double GetEstimateCosts(const MultiDBRoutingState& state,
                             DatabaseId database,
                             const Distance &targetDistance) override;
@@ -88,6 +102,20 @@ namespace osmscout {
                         DatabaseId database,
                         const Distance &targetDistance) override;
 
+    void PrepareRouteCostBounds(const MultiDBRoutingState& state,
+                                RouteCostBounds& bounds) override;
+
+    double GetRouteCostBound(const MultiDBRoutingState& state,
+                             const RouteCostBounds& bounds,
+                             const DBId& from,
+                             const DBId& to) override;
+
+    const RouteGraph* GetRouteGraph(const MultiDBRoutingState& state,
+                                    DatabaseId database) override;
+
+    const RoutePredecessorTable* GetRoutePredecessors(const MultiDBRoutingState& state,
+                                                      DatabaseId database) override;
+
     bool GetRouteNodes(const std::set<DBId> &routeNodeIds,
                        std::unordered_map<DBId,RouteNodeRef> &routeNodeMap) override;
 
@@ -117,6 +145,10 @@ namespace osmscout {
                 const RouteNode& routeNode,
                 size_t pathIndex) override;
 
+    bool CanUse(const MultiDBRoutingState& state,
+                DatabaseId databaseId,
+                const RouteGraph::Edge& edge) override;
+
   public:
     MultiDBRoutingService(const RouterParameter& parameter,
                           const std::vector<DatabaseRef> &databases);
@@ -137,6 +169,14 @@ namespace osmscout {
                                  const Distance &radius,
                                  const RoutingParameter& parameter);
 
+    RoutingMatrix CalculateMatrix(const std::vector<RoutePosition>& sources,
+                                  const std::vector<RoutePosition>& targets,
+                                  const RoutingParameter& parameter);
+
+    ReachabilityResult CalculateReachability(const RoutePosition& start,
+                                             double costLimit,
+                                             const RoutingParameter& parameter);
+
     bool TransformRouteDataToRouteDescription(const RouteData& data,
                                               RouteDescription& description);
 
@@ -0,0 +1,251 @@
+#ifndef OSMSCOUT_ROUTING_ROUTEGRAPH_H
+#define OSMSCOUT_ROUTING_ROUTEGRAPH_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <osmscout/CoreImportExport.h>
+
+#include <osmscout/GeoCoord.h>
+#include <osmscout/ObjectRef.h>
+#include <osmscout/OSMScoutTypes.h>
+#include <osmscout/Point.h>
+
+#include <osmscout/routing/RouteNode.h>
+
+#include <osmscout/util/Distance.h>
+#include <osmscout/util/FileScanner.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Routing
+   *
+   * Complete routing graph of a router in a compact, fixed width format, as
+   * generated by the import (see RoutingService::GetGraphFilename()).
+   *
+   * Route nodes are numbered densely in the order of their ids. The paths of all
+   * nodes are stored as compressed sparse rows: the paths of node i are the edges
+   * in the range [GetEdgesBegin(i),GetEdgesEnd(i)), in the same order as in
+   * RouteNode::paths. Turn restrictions (RouteNode::excludes) are stored in a
+   * separate table of the same structure.
+   *
+   * If the file is memory mapped (and the platform is little endian), all arrays
+   * are accessed in place, else they are loaded into memory on Open(). In both
+   * cases no RouteNode objects have to be created and access is thread-safe
+   * without locking.
+   *
+   * File layout (little endian, each section padded to a multiple of 8 bytes):
+   * - Number of nodes n, edges e, excludes x and objects o (uint32_t each)
+   * - n node ids (uint64_t), sorted
+   * - n+1 edge offsets (uint32_t)
+   * - e edges (see Edge)
+   * - n+1 exclude offsets (uint32_t)
+   * - x excludes (see Exclude)
+   * - o object references (uint64_t, file offset*4+type), sorted
+   */
+  class OSMSCOUT_API RouteGraph CLASS_FINAL
+  {
+  public:
+    //! Marker for an invalid node index
+    static const uint32_t NO_NODE;
+
+    //! Marker for an invalid object index
+    static const uint32_t NO_OBJECT;
+
+    //! Size of the file header in bytes
+    static const size_t   HEADER_SIZE;
+
+    /**
+     * Path from a route node to another route node
+     */
+    struct Edge
+    {
+      uint32_t target;             //!< Index of the node at the other end, NO_NODE if not part of the graph
+      uint32_t distance;           //!< Length of the path in cm
+      uint32_t object;             //!< Index of the object (way/area) the path follows
+      uint16_t objectVariantIndex; //!< Index into the object variant data of the router
+      uint8_t  flags;              //!< Same as RouteNode::Path::flags
+      uint8_t  reserved;
+
+      inline Distance GetDistance() const
+      {
+        return Distance::Of<Meter>(distance/100.0);
+      }
+
+      inline bool IsRestricted(Vehicle vehicle) const
+      {
+        switch (vehicle) {
+        case vehicleFoot:
+          return (flags & RouteNode::restrictedForFoot) != 0;
+        case vehicleBicycle:
+          return (flags & RouteNode::restrictedForBicycle) != 0;
+        case vehicleCar:
+          return (flags & RouteNode::restrictedForCar) != 0;
+        }
+
+        return false;
+      }
+    };
+
+    /**
+     * Forbidden turn from an object into the path of the same node
+     */
+    struct Exclude
+    {
+      uint32_t source; //!< Index of the object we come from
+      uint32_t edge;   //!< Index of the edge we are not allowed to take
+    };
+
+  private:
+    std::string           filename;       //!< Name of the file loaded
+    FileScanner           scanner;        //!< Scanner holding the memory mapped file
+    uint32_t              nodeCount;
+    uint32_t              edgeCount;
+    uint32_t              excludeCount;
+    uint32_t              objectCount;
+
+    const Id*             nodeIds;
+    const uint32_t*       edgeOffsets;
+    const Edge*           edges;
+    const uint32_t*       excludeOffsets;
+    const Exclude*        excludes;
+    const uint64_t*       objects;
+
+    // Storage of the arrays, if the file is not memory mapped
+    std::vector<Id>       nodeIdData;
+    std::vector<uint32_t> edgeOffsetData;
+    std::vector<Edge>     edgeData;
+    std::vector<uint32_t> excludeOffsetData;
+    std::vector<Exclude>  excludeData;
+    std::vector<uint64_t> objectData;
+
+  private:
+    static bool IsLittleEndian();
+
+  public:
+    RouteGraph();
+    ~RouteGraph();
+
+    bool Open(const std::string& filename,
+              bool memoryMapped);
+    void Close();
+
+    inline bool IsOpen() const
+    {
+      return nodeIds!=nullptr;
+    }
+
+    /**
+     * Returns true, if the graph is accessed in place in the memory mapped file
+     */
+    inline bool IsMemoryMapped() const
+    {
+      return nodeIds!=nullptr && nodeIdData.empty();
+    }
+
+    inline std::string GetFilename() const
+    {
+      return filename;
+    }
+
+    inline size_t GetNodeCount() const
+    {
+      return nodeCount;
+    }
+
+    inline size_t GetEdgeCount() const
+    {
+      return edgeCount;
+    }
+
+    inline size_t GetExcludeCount() const
+    {
+      return excludeCount;
+    }
+
+    inline size_t GetObjectCount() const
+    {
+      return objectCount;
+    }
+
+    uint32_t GetNodeIndex(Id id) const;
+
+    inline Id GetNodeId(uint32_t node) const
+    {
+      return nodeIds[node];
+    }
+
+    inline GeoCoord GetNodeCoord(uint32_t node) const
+    {
+      return Point::GetCoordFromId(nodeIds[node]);
+    }
+
+    inline uint32_t GetEdgesBegin(uint32_t node) const
+    {
+      return edgeOffsets[node];
+    }
+
+    inline uint32_t GetEdgesEnd(uint32_t node) const
+    {
+      return edgeOffsets[node+1];
+    }
+
+    inline const Edge& GetEdge(uint32_t edge) const
+    {
+      return edges[edge];
+    }
+
+    uint32_t GetObjectIndex(const ObjectFileRef& object) const;
+
+    inline ObjectFileRef GetObject(uint32_t object) const
+    {
+      return ObjectFileRef(objects[object] >> 2,
+                           (RefType)(objects[object] & 0x03));
+    }
+
+    /**
+     * Return true, if we can take the given edge, coming from the object with the
+     * given index (NO_OBJECT, if unknown)
+     */
+    inline bool CanTurn(uint32_t node,
+                        uint32_t sourceObject,
+                        uint32_t edge) const
+    {
+      for (uint32_t e=excludeOffsets[node]; e<excludeOffsets[node+1]; e++) {
+        if (excludes[e].source==sourceObject &&
+            edges[excludes[e].edge].object==edges[edge].object) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    static uint64_t EncodeObject(const ObjectFileRef& object);
+  };
+}
+
+#endif
@@ -151,6 +151,9 @@ namespace osmscout {
     uint8_t AddObject(const ObjectFileRef& object,
                       uint16_t objectVariantIndex);
 
+    bool CanTurn(const ObjectFileRef& source,
+                 const ObjectFileRef& target) const;
+
     void Read(FileScanner& scanner);
     void Read(const TypeConfig& typeConfig,
               FileScanner& scanner);
@@ -21,6 +21,7 @@
 */
 
 #include <map>
+#include <mutex>
 #include <vector>
 
 #include <osmscout/DataFile.h>
@@ -33,6 +34,9 @@
 namespace osmscout {
   /**
    * \ingroup Routing
+   *
+   * Access to the route nodes of a router. Loading route nodes is thread-safe,
+   * all threads share the same cache of loaded index pages.
    */
   class OSMSCOUT_API RouteNodeDataFile CLASS_FINAL
   {
@@ -97,6 +101,8 @@ namespace osmscout {
     bool Get(IteratorIn begin, IteratorIn end, size_t size,
              std::vector<RouteNodeRef>& data) const
     {
+      std::lock_guard<std::mutex> lock(accessMutex);
+
       data.reserve(size);
 
       for (IteratorIn idIter=begin; idIter!=end; ++idIter) {
@@ -130,6 +136,8 @@ namespace osmscout {
     bool Get(IteratorIn begin, IteratorIn end, size_t /*size*/,
              std::unordered_map<Id,RouteNodeRef>& dataMap) const
     {
+      std::lock_guard<std::mutex> lock(accessMutex);
+
       for (IteratorIn idIter=begin; idIter!=end; ++idIter) {
         Id                   id=*idIter;
         ValueCache::CacheRef cacheRef;
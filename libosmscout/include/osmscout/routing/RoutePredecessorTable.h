@@ -0,0 +1,116 @@
+#ifndef OSMSCOUT_ROUTING_ROUTEPREDECESSORTABLE_H
+#define OSMSCOUT_ROUTING_ROUTEPREDECESSORTABLE_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <osmscout/CoreImportExport.h>
+
+#include <osmscout/OSMScoutTypes.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Routing
+   *
+   * Reverse adjacency of the route nodes of a router, as generated by the import
+   * (see RoutingService::GetPredecessorFilename()).
+   *
+   * RouteNode::paths only hold the paths leaving a route node (and not the paths
+   * against the direction of oneways), so the predecessors of a route node cannot
+   * be derived from the route node itself. For each route node the table lists
+   * all route nodes with a path to it, together with the index of that path,
+   * so that the bidirectional search can walk the graph backwards.
+   *
+   * Predecessors are stored as compressed sparse rows: the predecessors of node i
+   * are the entries in the range [GetPredecessorsBegin(i),GetPredecessorsEnd(i)).
+   */
+  class OSMSCOUT_API RoutePredecessorTable CLASS_FINAL
+  {
+  public:
+    //! Marker for an invalid node index
+    static const uint32_t NO_NODE;
+
+    /**
+     * Path of another route node to the route node
+     */
+    struct Predecessor
+    {
+      Id      id;        //!< Id of the predecessor route node
+      uint8_t pathIndex; //!< Index of the path in RouteNode::paths of the predecessor
+    };
+
+  private:
+    std::string              filename;     //!< Name of the file loaded
+    std::vector<Id>          nodeIds;      //!< Ids of all route nodes with predecessors, sorted
+    std::vector<uint32_t>    offsets;      //!< Index of the first predecessor of each node (+1 entry)
+    std::vector<Predecessor> predecessors; //!< Predecessors of all nodes
+
+  public:
+    RoutePredecessorTable();
+
+    bool Load(const std::string& filename);
+    void Clear();
+
+    inline bool IsLoaded() const
+    {
+      return !offsets.empty();
+    }
+
+    inline std::string GetFilename() const
+    {
+      return filename;
+    }
+
+    inline size_t GetNodeCount() const
+    {
+      return nodeIds.size();
+    }
+
+    inline size_t GetPredecessorCount() const
+    {
+      return predecessors.size();
+    }
+
+    uint32_t GetNodeIndex(Id id) const;
+
+    inline uint32_t GetPredecessorsBegin(uint32_t node) const
+    {
+      return offsets[node];
+    }
+
+    inline uint32_t GetPredecessorsEnd(uint32_t node) const
+    {
+      return offsets[node+1];
+    }
+
+    inline const Predecessor& GetPredecessor(uint32_t predecessor) const
+    {
+      return predecessors[predecessor];
+    }
+  };
+}
+
+#endif
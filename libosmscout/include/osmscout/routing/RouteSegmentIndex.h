@@ -0,0 +1,205 @@
+#ifndef OSMSCOUT_ROUTING_ROUTESEGMENTINDEX_H
+#define OSMSCOUT_ROUTING_ROUTESEGMENTINDEX_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <osmscout/CoreImportExport.h>
+
+#include <osmscout/GeoCoord.h>
+#include <osmscout/ObjectRef.h>
+#include <osmscout/OSMScoutTypes.h>
+
+#include <osmscout/util/Distance.h>
+#include <osmscout/util/FileScanner.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Routing
+   *
+   * Spatial index of the segments of all routable ways and areas of a router, as
+   * generated by the import (see RoutingService::GetSegmentIndexFilename()). It
+   * answers nearest neighbour queries ("snap this coordinate to the road
+   * network") without loading any Way or Area object.
+   *
+   * Each segment stores its end points, the object and the index of its first
+   * node, the type of the object and the access flags for all vehicles (same
+   * as RouteNode::Path::flags), so searches can be filtered by vehicle and
+   * routing profile.
+   *
+   * The segments are assigned to the cells of a regular grid in geographic
+   * coordinates, a segment crossing multiple cells is referenced by all of
+   * them. Only cells referencing at least one segment are stored.
+   *
+   * If the file is memory mapped (and the platform is little endian), all arrays
+   * are accessed in place, else they are loaded into memory on Open(). In both
+   * cases the index is thread-safe without locking.
+   *
+   * File layout (little endian, each section padded to a multiple of 8 bytes):
+   * - Number of segments s, cells c and cell entries e, cell size in 1/10^7 degree (uint32_t each)
+   * - s segments (see Segment)
+   * - c cell keys (uint64_t, row << 32 | column), sorted
+   * - c+1 entry offsets (uint32_t)
+   * - e entries (uint32_t, index of the segment)
+   */
+  class OSMSCOUT_API RouteSegmentIndex CLASS_FINAL
+  {
+  public:
+    //! Size of the file header in bytes
+    static const size_t HEADER_SIZE;
+
+    //! Resolution of the stored coordinates, in degree
+    static const double COORD_RESOLUTION;
+
+    /**
+     * Segment between two consecutive nodes of a routable way or area
+     */
+    struct Segment
+    {
+      int32_t  lat[2];    //!< Latitude of the nodes in 1/10^7 degree
+      int32_t  lon[2];    //!< Longitude of the nodes in 1/10^7 degree
+      uint64_t object;    //!< Object reference (file offset*4+type, see RouteGraph::EncodeObject())
+      uint32_t nodeIndex; //!< Index of the first node of the segment within the object
+      TypeId   type;      //!< Type of the object
+      uint8_t  flags;     //!< Access of the object, same as RouteNode::Path::flags
+      uint8_t  reserved;
+
+      inline GeoCoord GetCoord(size_t node) const
+      {
+        return GeoCoord(lat[node]*COORD_RESOLUTION,
+                        lon[node]*COORD_RESOLUTION);
+      }
+
+      inline ObjectFileRef GetObject() const
+      {
+        return ObjectFileRef(object >> 2,
+                             (RefType)(object & 0x03));
+      }
+    };
+
+    /**
+     * Filter of the segments considered by a search
+     */
+    typedef std::function<bool(const Segment&)> SegmentFilter;
+
+    /**
+     * Closest segment of an object found by a search
+     */
+    struct Match
+    {
+      ObjectFileRef object;       //!< The object
+      uint32_t      nodeIndex;    //!< Index of the first node of the closest segment
+      double        fraction;     //!< Position of the closest point on the segment (0.0 first node, 1.0 second node)
+      GeoCoord      closestPoint; //!< The closest point on the segment
+      Distance      distance;     //!< Distance between the search center and the closest point
+      TypeId        type;         //!< Type of the object
+    };
+
+  private:
+    std::string           filename;     //!< Name of the file loaded
+    FileScanner           scanner;      //!< Scanner holding the memory mapped file
+    uint32_t              segmentCount;
+    uint32_t              cellCount;
+    uint32_t              entryCount;
+    double                cellSize;     //!< Width and height of a cell in degree
+
+    const Segment*        segments;
+    const uint64_t*       cellKeys;
+    const uint32_t*       entryOffsets;
+    const uint32_t*       entries;
+
+    // Storage of the arrays, if the file is not memory mapped
+    std::vector<Segment>  segmentData;
+    std::vector<uint64_t> cellKeyData;
+    std::vector<uint32_t> entryOffsetData;
+    std::vector<uint32_t> entryData;
+
+  private:
+    static bool IsLittleEndian();
+
+    bool GetCellEntries(int64_t row,
+                        int64_t column,
+                        uint32_t& begin,
+                        uint32_t& end) const;
+
+  public:
+    RouteSegmentIndex();
+    ~RouteSegmentIndex();
+
+    bool Open(const std::string& filename,
+              bool memoryMapped);
+    void Close();
+
+    inline bool IsOpen() const
+    {
+      return segments!=nullptr;
+    }
+
+    /**
+     * Returns true, if the index is accessed in place in the memory mapped file
+     */
+    inline bool IsMemoryMapped() const
+    {
+      return segments!=nullptr && segmentData.empty();
+    }
+
+    inline std::string GetFilename() const
+    {
+      return filename;
+    }
+
+    inline size_t GetSegmentCount() const
+    {
+      return segmentCount;
+    }
+
+    inline size_t GetCellCount() const
+    {
+      return cellCount;
+    }
+
+    inline double GetCellSize() const
+    {
+      return cellSize;
+    }
+
+    std::vector<Match> GetClosestObjects(const GeoCoord& coord,
+                                         const Distance& maxRadius,
+                                         size_t maxCount,
+                                         const SegmentFilter& filter) const;
+
+    static int32_t EncodeCoord(double value);
+    static uint64_t GetCellKey(int64_t row,
+                               int64_t column);
+    static int64_t GetCellRow(double lat,
+                              double cellSize);
+    static int64_t GetCellColumn(double lon,
+                                 double cellSize);
+  };
+}
+
+#endif
@@ -21,9 +21,11 @@
 */
 
 #include <memory>
+#include <mutex>
 
 #include <osmscout/Database.h>
 #include <osmscout/DataFile.h>
+#include <osmscout/EytzingerIndex.h>
 #include <osmscout/Intersection.h>
 #include <osmscout/ObjectVariantDataFile.h>
 
@@ -36,14 +38,20 @@ namespace osmscout {
    * \ingroup Routing
    *
    * Encapsulation of the routing relevant data files, similar to Database.
+   *
+   * Loading route nodes and junctions is thread-safe.
    */
   class RoutingDatabase CLASS_FINAL
   {
+  private:
+    typedef IndexedDataFile<Id,Intersection,EytzingerIndex<Id>> JunctionDataFile;
+
   private:
     TypeConfigRef                    typeConfig;
     std::string                      path;
     RouteNodeDataFile                routeNodeDataFile;
-    IndexedDataFile<Id,Intersection> junctionDataFile;      //!< Cached access to the 'junctions.dat' file
+    JunctionDataFile                 junctionDataFile;      //!< Cached access to the 'junctions.dat' file
+    std::mutex                       junctionMutex;         //!< Serializes opening, reading and closing of junctionDataFile
     ObjectVariantDataFile            objectVariantDataFile;
 
   public:
@@ -54,6 +54,8 @@ namespace osmscout {
     virtual bool CanUse(const RouteNode& currentNode,
                         const std::vector<ObjectVariantData>& objectVariantData,
                         size_t pathIndex) const = 0;
+    virtual bool CanUse(uint8_t pathFlags,
+                        const ObjectVariantData& objectVariant) const = 0;
     virtual bool CanUse(const Area& area) const = 0;
     virtual bool CanUse(const Way& way) const = 0;
     virtual bool CanUseForward(const Way& way) const = 0;
@@ -62,12 +64,17 @@ namespace osmscout {
     virtual double GetCosts(const RouteNode& currentNode,
                             const std::vector<ObjectVariantData>& objectVariantData,
                             size_t pathIndex) const = 0;
+    virtual double GetCosts(const ObjectVariantData& objectVariant,
+                            const Distance &distance) const = 0;
     virtual double GetCosts(const Area& area,
                             const Distance &distance) const = 0;
     virtual double GetCosts(const Way& way,
                             const Distance &distance) const = 0;
     virtual double GetCosts(const Distance &distance) const = 0;
 
+    virtual double GetTime(const RouteNode& currentNode,
+                           const std::vector<ObjectVariantData>& objectVariantData,
+                           size_t pathIndex) const = 0;
     virtual double GetTime(const Area& area,
                            const Distance &distance) const = 0;
     virtual double GetTime(const Way& way,
@@ -115,6 +122,20 @@ namespace osmscout {
       return vehicle;
     }
 
+    inline double GetVehicleMaxSpeed() const
+    {
+      return vehicleMaxSpeed;
+    }
+
+    /**
+     * Return the speed for objects of the type with the given index, 0 if the type
+     * cannot be used
+     */
+    inline double GetTypeSpeed(size_t typeIndex) const
+    {
+      return typeIndex<speeds.size() ? speeds[typeIndex] : 0.0;
+    }
+
     void SetCostLimitDistance(const Distance &costLimitDistance);
 
     inline Distance GetCostLimitDistance() const
@@ -134,11 +155,34 @@ namespace osmscout {
     bool CanUse(const RouteNode& currentNode,
                 const std::vector<ObjectVariantData>& objectVariantData,
                 size_t pathIndex) const;
+    bool CanUse(uint8_t pathFlags,
+                const ObjectVariantData& objectVariant) const;
     bool CanUse(const Area& area) const;
     bool CanUse(const Way& way) const;
     bool CanUseForward(const Way& way) const;
     bool CanUseBackward(const Way& way) const;
 
+    inline double GetTime(const RouteNode& currentNode,
+                          const std::vector<ObjectVariantData>& objectVariantData,
+                          size_t pathIndex) const
+    {
+      double speed;
+      size_t index=currentNode.paths[pathIndex].objectIndex;
+
+      if (objectVariantData[currentNode.objects[index].objectVariantIndex].maxSpeed>0) {
+        speed=objectVariantData[currentNode.objects[index].objectVariantIndex].maxSpeed;
+      }
+      else {
+        TypeInfoRef type=objectVariantData[currentNode.objects[index].objectVariantIndex].type;
+
+        speed=speeds[type->GetIndex()];
+      }
+
+      speed=std::min(vehicleMaxSpeed,speed);
+
+      return currentNode.paths[pathIndex].distance.As<Kilometer>()/speed;
+    }
+
     inline double GetTime(const Area& area,
                           const Distance &distance) const
     {
@@ -186,6 +230,12 @@ namespace osmscout {
       return currentNode.paths[pathIndex].distance.As<Kilometer>();
     }
 
+    inline double GetCosts(const ObjectVariantData& /*objectVariant*/,
+                           const Distance &distance) const
+    {
+      return distance.As<Kilometer>();
+    }
+
     inline double GetCosts(const Area& /*area*/,
                            const Distance &distance) const
     {
@@ -237,6 +287,23 @@ namespace osmscout {
       return currentNode.paths[pathIndex].distance.As<Kilometer>()/speed;
     }
 
+    inline double GetCosts(const ObjectVariantData& objectVariant,
+                           const Distance &distance) const
+    {
+      double speed;
+
+      if (objectVariant.maxSpeed>0) {
+        speed=objectVariant.maxSpeed;
+      }
+      else {
+        speed=speeds[objectVariant.type->GetIndex()];
+      }
+
+      speed=std::min(vehicleMaxSpeed,speed);
+
+      return distance.As<Kilometer>()/speed;
+    }
+
     inline double GetCosts(const Area& area,
                            const Distance &distance) const
     {
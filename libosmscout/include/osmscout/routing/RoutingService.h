@@ -22,11 +22,13 @@
 
 #include <atomic>
 #include <functional>
+#include <limits>
 #include <list>
 #include <memory>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <osmscout/CoreFeatures.h>
 
@@ -48,6 +50,7 @@
 #include <osmscout/routing/RouteNodeDataFile.h>
 #include <osmscout/routing/RoutingProfile.h>
 #include <osmscout/routing/DBFileOffset.h>
+#include <osmscout/routing/DBIdMap.h>
 
 #include <osmscout/util/Breaker.h>
 #include <osmscout/util/Cache.h>
@@ -159,10 +162,20 @@ namespace osmscout {
   private:
     BreakerRef         breaker;
     RoutingProgressRef progress;
+    bool               bidirectional;
+    bool               useLandmarks;
+    bool               useRouteGraph;
+    size_t             threadCount;
 
   public:
+    RoutingParameter();
+
     void SetBreaker(const BreakerRef& breaker);
     void SetProgress(const RoutingProgressRef& progress);
+    void SetBidirectional(bool bidirectional);
+    void SetUseLandmarks(bool useLandmarks);
+    void SetUseRouteGraph(bool useRouteGraph);
+    void SetThreadCount(size_t threadCount);
 
     inline BreakerRef GetBreaker() const
     {
@@ -173,6 +186,57 @@ namespace osmscout {
     {
       return progress;
     }
+
+    /**
+     * If true, the route is calculated by a bidirectional A* search, expanding
+     * route nodes from the start and from the target. The route has the same costs,
+     * but in general less route nodes have to be loaded.
+     *
+     * The bidirectional search is off by default: it only saves about 30% of the
+     * loaded route nodes for routes crossing a small part of the map and
+     * almost nothing for routes crossing the whole map, while each loaded
+     * route node is more expensive.
+     *
+     * The backward search needs the predecessors of the route nodes generated by
+     * the import (see RoutePredecessorTable). If they are not available for the
+     * start and the target database, a warning is logged and the unidirectional
+     * A* search is used.
+     */
+    inline bool IsBidirectional() const
+    {
+      return bidirectional;
+    }
+
+    /**
+     * If true (the default), the A* estimate uses the landmark distances generated
+     * by the import (ALT heuristic), if available for the vehicle.
+     */
+    inline bool GetUseLandmarks() const
+    {
+      return useLandmarks;
+    }
+
+    /**
+     * If true (the default), the A* search runs on the compact routing graph
+     * generated by the import (see RouteGraph), if available for the database.
+     * The bidirectional search always uses the route nodes.
+     */
+    inline bool GetUseRouteGraph() const
+    {
+      return useRouteGraph;
+    }
+
+    /**
+     * Number of threads used by calculations that can be run in parallel (like
+     * the searches of a matrix calculation or the legs of a route via multiple
+     * points), 0 for the number of hardware threads. The default is 1, so
+     * parallel calculation has to be requested explicitly. Note that the progress
+     * of the legs of a route is only reported, if a single thread is used.
+     */
+    inline size_t GetThreadCount() const
+    {
+      return threadCount;
+    }
   };
 
   /**
@@ -228,6 +292,177 @@ namespace osmscout {
     }
   };
 
+  /**
+   * \ingroup Routing
+   *
+   * Result of a many-to-many routing calculation. For each pair of source and
+   * target it holds the costs, the length and the travel time of the cheapest
+   * route, without the route itself.
+   *
+   * Length and travel time are summed up from the path lengths of the routing
+   * graph, so they may differ slightly from the values calculated for the
+   * RouteDescription of the same route.
+   */
+  class OSMSCOUT_API RoutingMatrix CLASS_FINAL
+  {
+  public:
+    struct Entry
+    {
+      bool     found;    //!< true, if a route was found
+      double   cost;     //!< Costs of the route, as defined by the profile
+      Distance distance; //!< Length of the route
+      double   time;     //!< Travel time in hours
+
+      Entry()
+      : found(false),
+        cost(0.0),
+        time(0.0)
+      {
+        // no code
+      }
+    };
+
+  private:
+    size_t             sourceCount;
+    size_t             targetCount;
+    std::vector<Entry> entries;
+
+  public:
+    RoutingMatrix();
+    RoutingMatrix(size_t sourceCount,
+                  size_t targetCount);
+
+    inline size_t GetSourceCount() const
+    {
+      return sourceCount;
+    }
+
+    inline size_t GetTargetCount() const
+    {
+      return targetCount;
+    }
+
+    inline Entry& Get(size_t source,
+                      size_t target)
+    {
+      return entries[source*targetCount+target];
+    }
+
+    inline const Entry& Get(size_t source,
+                            size_t target) const
+    {
+      return entries[source*targetCount+target];
+    }
+
+    inline bool HasRoute(size_t source,
+                         size_t target) const
+    {
+      return Get(source,target).found;
+    }
+  };
+
+  /**
+   * \ingroup Routing
+   *
+   * Result of a reachability calculation: all route nodes reachable from the start
+   * position within the given cost limit, together with the costs, the length and
+   * the travel time of the cheapest route to each of them.
+   *
+   * The predecessor of each node makes up a tree of cheapest routes rooted at the
+   * start position. Together with the remaining edges between reached nodes it
+   * can be used to rasterize the reachable part of the routing graph (see
+   * CostGrid).
+   */
+  class OSMSCOUT_API ReachabilityResult CLASS_FINAL
+  {
+  public:
+    //! Marker for a node reached directly from the start position
+    static const size_t NO_PREV;
+
+    struct Node
+    {
+      DBId     id;       //!< Id of the route node
+      size_t   prev;     //!< Index of the previous node in the list of nodes or NO_PREV
+      GeoCoord coord;    //!< Coordinate of the route node
+      double   cost;     //!< Costs of the cheapest route, as defined by the profile
+      Distance distance; //!< Length of the cheapest route
+      double   time;     //!< Travel time of the cheapest route in hours
+    };
+
+    /**
+     * Usable path between two reached nodes, that is not part of the tree of
+     * cheapest routes
+     */
+    struct Edge
+    {
+      size_t from; //!< Index of the node the path starts at
+      size_t to;   //!< Index of the node the path ends at
+    };
+
+  private:
+    bool              success;
+    GeoCoord          startCoord;
+    double            costLimit;
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+
+  public:
+    ReachabilityResult();
+
+    inline void SetSuccess(bool success)
+    {
+      this->success=success;
+    }
+
+    inline void SetStartCoord(const GeoCoord& startCoord)
+    {
+      this->startCoord=startCoord;
+    }
+
+    inline void SetCostLimit(double costLimit)
+    {
+      this->costLimit=costLimit;
+    }
+
+    inline void AddNode(const Node& node)
+    {
+      nodes.push_back(node);
+    }
+
+    inline void AddEdge(const Edge& edge)
+    {
+      edges.push_back(edge);
+    }
+
+    inline bool Success() const
+    {
+      return success;
+    }
+
+    inline GeoCoord GetStartCoord() const
+    {
+      return startCoord;
+    }
+
+    inline double GetCostLimit() const
+    {
+      return costLimit;
+    }
+
+    /**
+     * Reached nodes, ordered by increasing costs
+     */
+    inline const std::vector<Node>& GetNodes() const
+    {
+      return nodes;
+    }
+
+    inline const std::vector<Edge>& GetEdges() const
+    {
+      return edges;
+    }
+  };
+
   /**
    * \ingroup Routing
    *
@@ -255,8 +490,15 @@ namespace osmscout {
 
       bool          access;        //!< Flags to signal, if we had access ("access restrictions") to this node
 
+      Distance      distance;      //!< Length of the route up to the current node (only calculated for matrix and reachability searches)
+      double        time;          //!< Travel time up to the current node (only calculated for matrix and reachability searches)
+
+      size_t        openIndex;     //!< Position in the heap of the OpenList
+
       RNode()
-      : id()
+      : id(),
+        time(0),
+        openIndex(std::numeric_limits<size_t>::max())
       {
         // no code
       }
@@ -271,7 +513,9 @@ namespace osmscout {
         currentCost(0),
         estimateCost(0),
         overallCost(0),
-        access(true)
+        access(true),
+        time(0),
+        openIndex(std::numeric_limits<size_t>::max())
       {
         // no code
       }
@@ -287,7 +531,9 @@ namespace osmscout {
         currentCost(0),
         estimateCost(0),
         overallCost(0),
-        access(true)
+        access(true),
+        time(0),
+        openIndex(std::numeric_limits<size_t>::max())
       {
         // no code
       }
@@ -305,20 +551,6 @@ namespace osmscout {
 
     typedef std::shared_ptr<RNode> RNodeRef;
 
-    struct RNodeCostCompare
-    {
-      inline bool operator()(const RNodeRef& a,
-                             const RNodeRef& b) const
-      {
-        if (a->overallCost==b->overallCost) {
-         return a->id<b->id;
-        }
-        else {
-          return a->overallCost<b->overallCost;
-        }
-      }
-    };
-
     /**
      * \ingroup Routing
      *
@@ -349,6 +581,11 @@ namespace osmscout {
         return currentNode==other.currentNode;
       }
 
+      VNode()
+      {
+        // no code
+      }
+
       /**
        * Simple inline constructor for searching for VNodes in the
        * ClosedSet.
@@ -385,23 +622,121 @@ namespace osmscout {
     };
 
     /**
-     * Helper class for calculating hash codes for
-     * VNode instances to make it usable in std::unordered_set.
+     * \ingroup Routing
+     *
+     * The open list of the A* search: A 4-ary heap of RNodes ordered by their
+     * overall costs, that allows updating the costs of nodes already in the list.
+     *
+     * The list also owns the RNodes. They are allocated in chunks, so pointers
+     * stay valid until Clear() is called. The memory is kept and reused by the
+     * next routing query.
      */
-    struct ClosedNodeHasher
+    class OSMSCOUT_API OpenList CLASS_FINAL
     {
-      inline size_t operator()(const VNode& node) const
+    public:
+      //! Value of RNode::openIndex for nodes not in the heap
+      static const size_t NOT_OPEN;
+
+      struct Entry
+      {
+        double overallCost; //!< Copy of the costs of the node, for better locality
+        RNode* node;
+      };
+
+      typedef std::vector<Entry>::const_iterator const_iterator;
+
+    private:
+      static const size_t CHUNK_SIZE=4096;
+
+    private:
+      std::vector<std::unique_ptr<RNode[]>> chunks;    //!< Storage of the RNodes
+      size_t                                nodeCount; //!< Number of RNodes used
+      std::vector<Entry>                    heap;
+
+    private:
+      inline bool IsLess(const Entry& a,
+                         const Entry& b) const
       {
-        return std::hash<Id>()(node.currentNode.id) ^
-               std::hash<DatabaseId>()(node.currentNode.database);
+        if (a.overallCost==b.overallCost) {
+          return a.node->id<b.node->id;
+        }
+
+        return a.overallCost<b.overallCost;
       }
-    };
 
-    typedef std::set<RNodeRef,RNodeCostCompare>           OpenList;
-    typedef std::set<RNodeRef,RNodeCostCompare>::iterator OpenListRef;
+      inline void Place(size_t index,
+                        const Entry& entry)
+      {
+        heap[index]=entry;
+        entry.node->openIndex=index;
+      }
+
+      void SiftUp(size_t index);
+      void SiftDown(size_t index);
+
+    public:
+      OpenList();
+      OpenList(const OpenList& other) = delete;
+      OpenList& operator=(const OpenList& other) = delete;
+
+      void Clear();
+
+      RNode* Insert(const RNode& node);
+      void Update(RNode* node);
+      RNode* Pop();
+
+      /**
+       * Return the node with the lowest costs without removing it from the list
+       */
+      inline const RNode* Top() const
+      {
+        return heap.front().node;
+      }
+
+      inline bool IsEmpty() const
+      {
+        return heap.empty();
+      }
+
+      inline size_t Size() const
+      {
+        return heap.size();
+      }
+
+      inline bool Contains(const RNode* node) const
+      {
+        return node->openIndex!=NOT_OPEN;
+      }
+
+      /**
+       * Return the number of RNodes allocated since the last Clear()
+       */
+      inline size_t GetNodeCount() const
+      {
+        return nodeCount;
+      }
+
+      /**
+       * Return the number of RNodes the list can hold without allocating memory
+       */
+      inline size_t GetNodeCapacity() const
+      {
+        return chunks.size()*CHUNK_SIZE;
+      }
+
+      inline const_iterator begin() const
+      {
+        return heap.begin();
+      }
+
+      inline const_iterator end() const
+      {
+        return heap.end();
+      }
+    };
 
-    typedef std::unordered_map<DBId,OpenListRef>          OpenMap;
-    typedef std::unordered_set<VNode,ClosedNodeHasher>    ClosedSet;
+    typedef DBIdMap<RNode*> OpenMap;
+    typedef DBIdMap<VNode>  ClosedSet;
 
   public:
     //! Relative filename of the intersection data file
@@ -415,6 +750,13 @@ namespace osmscout {
     static std::string GetDataFilename(const std::string& filenamebase);
     static std::string GetData2Filename(const std::string& filenamebase);
     static std::string GetIndexFilename(const std::string& filenamebase);
+    static std::string GetCHFilename(const std::string& filenamebase,
+                                     Vehicle vehicle);
+    static std::string GetLandmarkFilename(const std::string& filenamebase,
+                                           Vehicle vehicle);
+    static std::string GetGraphFilename(const std::string& filenamebase);
+    static std::string GetPredecessorFilename(const std::string& filenamebase);
+    static std::string GetSegmentIndexFilename(const std::string& filenamebase);
 
   public:
     RoutingService();
@@ -23,10 +23,12 @@
 #include <atomic>
 #include <functional>
 #include <list>
+#include <map>
 #include <memory>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <osmscout/CoreFeatures.h>
 
@@ -49,6 +51,10 @@
 #include <osmscout/routing/RoutingProfile.h>
 #include <osmscout/routing/RoutingService.h>
 #include <osmscout/routing/AbstractRoutingService.h>
+#include <osmscout/routing/LandmarkTable.h>
+#include <osmscout/routing/RouteGraph.h>
+#include <osmscout/routing/RoutePredecessorTable.h>
+#include <osmscout/routing/RouteSegmentIndex.h>
 
 #include <osmscout/util/Breaker.h>
 #include <osmscout/util/Cache.h>
@@ -64,6 +70,7 @@ namespace osmscout {
   private:
     ObjectFileRef object;
     Distance      distance;
+    GeoCoord      closestPoint;
     WayRef        way;
     AreaRef       area;
     std::string   name;
@@ -81,6 +88,14 @@ namespace osmscout {
       return distance;
     }
 
+    /**
+     * Returns the point of the object closest to the search center
+     */
+    inline GeoCoord GetClosestPoint() const
+    {
+      return closestPoint;
+    }
+
     inline WayRef GetWay() const
     {
       return way;
@@ -121,10 +136,24 @@ namespace osmscout {
     std::string                          path;                  //!< Path to the directory containing all files
 
     RoutingDatabase                      routingDatabase;       //!< Access to routing data and index files
+    std::map<Vehicle,LandmarkTable>      landmarkTables;        //!< Loaded landmark distances by vehicle
+    RouteGraph                           routeGraph;            //!< Compact routing graph, if available
+    RoutePredecessorTable                predecessorTable;      //!< Predecessors of the route nodes, if available
+    RouteSegmentIndex                    segmentIndex;          //!< Spatial index of the routable segments, if available
 
   private:
     bool HasNodeWithId(const std::vector<Point>& nodes) const;
 
+    RoutePosition GetClosestRoutableWayNode(const GeoCoord& coord,
+                                            const RoutingProfile& profile,
+                                            const std::vector<FileOffset>& wayOffsets) const;
+
+    bool GetClosestRoutableObjectsFromIndex(const GeoCoord& location,
+                                            Vehicle vehicle,
+                                            const Distance &maxRadius,
+                                            size_t maxCount,
+                                            std::vector<ClosestRoutableObjectResult>& results);
+
   protected:
     Vehicle GetVehicle(const RoutingProfile& profile) override;
 
@@ -133,6 +162,10 @@ namespace osmscout {
                 const RouteNode& routeNode,
                 size_t pathIndex) override;
 
+    bool CanUse(const RoutingProfile& profile,
+                DatabaseId database,
+                const RouteGraph::Edge& edge) override;
+
     bool CanUseForward(const RoutingProfile& profile,
                        const DatabaseId& database,
                        const WayRef& way) override;
@@ -146,11 +179,25 @@ namespace osmscout {
                     const RouteNode& routeNode,
                     size_t pathIndex) override;
 
+    double GetCosts(const RoutingProfile& profile,
+                    DatabaseId database,
+                    const RouteGraph::Edge& edge) override;
+
     double GetCosts(const RoutingProfile& profile,
                     DatabaseId database,
                     const WayRef &way,
                     const Distance &wayLength) override;
 
+    double GetTime(const RoutingProfile& profile,
+                   DatabaseId database,
+                   const RouteNode& routeNode,
+                   size_t pathIndex) override;
+
+    double GetTime(const RoutingProfile& profile,
+                   DatabaseId database,
+                   const WayRef &way,
+                   const Distance &wayLength) override;
+
     double GetEstimateCosts(const RoutingProfile& profile,
                             DatabaseId database,
                             const Distance &targetDistance) override;
@@ -159,6 +206,20 @@ namespace osmscout {
                         DatabaseId database,
                         const Distance &targetDistance) override;
 
+    void PrepareRouteCostBounds(const RoutingProfile& profile,
+                                RouteCostBounds& bounds) override;
+
+    double GetRouteCostBound(const RoutingProfile& profile,
+                             const RouteCostBounds& bounds,
+                             const DBId& from,
+                             const DBId& to) override;
+
+    const RouteGraph* GetRouteGraph(const RoutingProfile& profile,
+                                    DatabaseId database) override;
+
+    const RoutePredecessorTable* GetRoutePredecessors(const RoutingProfile& profile,
+                                                      DatabaseId database) override;
+
     bool GetRouteNodes(const std::set<DBId> &routeNodeIds,
                        std::unordered_map<DBId,RouteNodeRef> &routeNodeMap) override;
 
@@ -189,12 +250,23 @@ namespace osmscout {
                          const std::string& filenamebase);
     ~SimpleRoutingService() override;
 
-    bool Open();
+    virtual bool Open();
     bool IsOpen() const;
-    void Close();
+    virtual void Close();
 
     TypeConfigRef GetTypeConfig() const;
 
+    bool HasLandmarks(Vehicle vehicle) const;
+    bool HasRouteGraph() const;
+    bool HasRoutePredecessors() const;
+    bool HasSegmentIndex() const;
+    const RoutePredecessorTable* GetRoutePredecessorTable() const;
+    LandmarkCostBounds GetLandmarkCostBounds(const RoutingProfile& profile) const;
+    double GetLandmarkCostBound(const RoutingProfile& profile,
+                                const LandmarkCostBounds& bounds,
+                                Id from,
+                                Id to) const;
+
     RoutingResult CalculateRouteViaCoords(RoutingProfile& profile,
                                           std::vector<GeoCoord> via,
                                           const Distance &radius,
@@ -208,6 +280,11 @@ namespace osmscout {
                                                          Vehicle vehicle,
                                                          const Distance &maxRadius);
 
+    std::vector<ClosestRoutableObjectResult> GetClosestRoutableObjects(const GeoCoord& location,
+                                                                       Vehicle vehicle,
+                                                                       const Distance &maxRadius,
+                                                                       size_t maxCount);
+
     void DumpStatistics();
   };
 
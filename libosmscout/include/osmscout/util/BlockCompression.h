@@ -0,0 +1,105 @@
+#ifndef OSMSCOUT_UTIL_BLOCKCOMPRESSION_H
+#define OSMSCOUT_UTIL_BLOCKCOMPRESSION_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <osmscout/CoreImportExport.h>
+
+#include <osmscout/OSMScoutTypes.h>
+
+#include <osmscout/util/ClockCache.h>
+
+namespace osmscout {
+
+  /**
+   * \defgroup BlockCompression Block compressed files
+   * \ingroup File
+   *
+   * A block compressed file (format version 2) stores the content of a data file as a
+   * sequence of independently compressed blocks, followed by an index of all blocks.
+   * Blocks are cut at record boundaries only, so every record can be read from exactly
+   * one decompressed block. Offsets in the uncompressed data stay valid (an index pointing
+   * into the original file can be used unchanged), FileScanner maps them to the block
+   * containing them.
+   *
+   * File layout (all numbers little endian, fixed size):
+   * - Header: magic (8 bytes), format version (uint32), nominal block size (uint32),
+   *   size of the uncompressed data (uint64), offset of the block index (uint64)
+   * - The compressed blocks
+   * - Block index: number of blocks (uint32), for every block: uncompressed offset (uint64),
+   *   file offset (uint64), compressed size (uint32), uncompressed size (uint32)
+   *
+   * Blocks are compressed using zlib. If the library was built without zlib support,
+   * block compressed files can neither be written nor read.
+   */
+
+  static const char     BLOCK_COMPRESSION_MAGIC[8]={'O','S','M','S','B','L','K','Z'};
+  static const uint32_t BLOCK_COMPRESSION_VERSION=2;
+  static const size_t   BLOCK_COMPRESSION_HEADER_SIZE=8+4+4+8+8;
+  static const size_t   DEFAULT_COMPRESSED_BLOCK_SIZE=64*1024;
+
+  /**
+   * \ingroup BlockCompression
+   * Index entry of one block of a block compressed file
+   */
+  struct OSMSCOUT_API CompressedBlock
+  {
+    FileOffset logicalOffset;    //!< Offset of the first byte of the block in the uncompressed data
+    FileOffset fileOffset;       //!< Offset of the compressed block in the file
+    uint32_t   compressedSize;   //!< Size of the compressed block
+    uint32_t   uncompressedSize; //!< Size of the block after decompression
+  };
+
+  /**
+   * \ingroup BlockCompression
+   * Decompressed content of a block
+   */
+  typedef std::shared_ptr<const std::vector<char>> BlockDataRef;
+
+  /**
+   * \ingroup BlockCompression
+   * Cache of decompressed blocks, shared by all FileScanner instances reading the same
+   * file. Key is the uncompressed offset of the block.
+   */
+  typedef ShardedCache<FileOffset,BlockDataRef> BlockDataCache;
+  typedef std::shared_ptr<BlockDataCache>       BlockDataCacheRef;
+
+  extern OSMSCOUT_API bool IsBlockCompressionSupported();
+
+  extern OSMSCOUT_API bool CompressBlock(const char* data,
+                                         size_t size,
+                                         std::vector<char>& compressed);
+
+  extern OSMSCOUT_API bool DecompressBlock(const char* compressed,
+                                           size_t compressedSize,
+                                           char* data,
+                                           size_t size);
+
+  extern OSMSCOUT_API void WriteBlockCompressedFile(const std::string& sourceFilename,
+                                                    const std::string& targetFilename,
+                                                    const std::vector<FileOffset>& recordOffsets,
+                                                    size_t blockSize=DEFAULT_COMPRESSED_BLOCK_SIZE);
+}
+
+#endif
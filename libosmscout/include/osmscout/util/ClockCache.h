@@ -0,0 +1,774 @@
+#ifndef OSMSCOUT_CLOCKCACHE_H
+#define OSMSCOUT_CLOCKCACHE_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <osmscout/util/Cache.h>
+#include <osmscout/util/Logger.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Util
+   * Usage statistics of a cache instance.
+   */
+  struct CacheStatistics
+  {
+    size_t entries;    //!< Number of entries currently in the cache
+    size_t memory;     //!< Accounted memory of the current entries (in bytes)
+    size_t hits;       //!< Number of successful lookups
+    size_t misses;     //!< Number of failed lookups
+    size_t insertions; //!< Number of newly inserted entries
+    size_t evictions;  //!< Number of entries evicted because of entry or memory limits
+
+    CacheStatistics()
+    : entries(0),
+      memory(0),
+      hits(0),
+      misses(0),
+      insertions(0),
+      evictions(0)
+    {
+      // no code
+    }
+
+    /**
+     * Ratio of successful lookups in relation to all lookups, in the range [0.0,1.0]
+     */
+    inline double GetHitRate() const
+    {
+      if (hits+misses==0) {
+        return 0.0;
+      }
+
+      return (double)hits/(double)(hits+misses);
+    }
+
+    inline CacheStatistics& operator+=(const CacheStatistics& other)
+    {
+      entries+=other.entries;
+      memory+=other.memory;
+      hits+=other.hits;
+      misses+=other.misses;
+      insertions+=other.insertions;
+      evictions+=other.evictions;
+
+      return *this;
+    }
+  };
+
+  /**
+   * \ingroup Util
+   * Generic cache with CLOCK (second chance) eviction.
+   *
+   * Template parameter class K holds the key value (must be hashable via std::hash),
+   * parameter class V holds the data class that is to be cached.
+   *
+   * * The cache is not threadsafe, see ShardedCache for a thread-safe variant.
+   * * All entries are stored in one contiguous slot array. Lookup is done via an open addressing
+   *   hash table (linear probing) mapping keys to slot indexes, so there is no heap allocation
+   *   per entry and a cache hit just sets the reference bit of the slot.
+   * * New entries start without reference bit, so entries only accessed once are evicted before
+   *   entries that were hit at least once.
+   * * Besides a maximum number of entries, the cache can be limited by the overall memory of
+   *   its entries. The memory of an entry is calculated by the (optional) ValueSizer passed
+   *   plus the fixed overhead of the slot (see GetEntryOverhead()). This way one huge object
+   *   costs more than many small ones. Entries larger than the memory limit are not cached.
+   */
+  template <class K, class V>
+  class ClockCache
+  {
+  public:
+    /**
+     * ValueSizer returns the size (in bytes) of an individual cache value.
+     */
+    typedef typename Cache<K,V>::ValueSizer ValueSizer;
+
+  private:
+    static const uint32_t emptySlot=std::numeric_limits<uint32_t>::max();
+
+    struct Slot
+    {
+      K      key;
+      V      value;
+      size_t memory;     //!< Accounted memory of this entry
+      bool   used;       //!< Slot is in use
+      bool   referenced; //!< Reference bit of the CLOCK algorithm
+    };
+
+  private:
+    size_t                maxSize;    //!< Maximum number of entries
+    size_t                maxMemory;  //!< Maximum accounted memory, 0 means unlimited
+    const ValueSizer      *sizer;     //!< Optional sizer for values, not owned
+    size_t                size;       //!< Current number of entries
+    size_t                memory;     //!< Current accounted memory
+    size_t                hand;       //!< Current position of the CLOCK hand
+    std::vector<Slot>     slots;      //!< Contiguous array of all entry slots
+    std::vector<uint32_t> freeSlots;  //!< Indexes of unused slots within the slot array
+    std::vector<uint32_t> table;      //!< Hash table of slot indexes, size is a power of 2
+    size_t                tableShift; //!< 64 - log2(table.size())
+    CacheStatistics       statistics; //!< Hit, miss and eviction counters
+
+  private:
+    inline size_t GetBucket(const K& key) const
+    {
+      // Fibonacci hashing, spreads sequential keys (offsets, ids) over the whole table
+      return (size_t)(((uint64_t)std::hash<K>()(key)*11400714819323198485ull) >> tableShift);
+    }
+
+    void ResizeTable(size_t tableSize)
+    {
+      size_t bits=0;
+
+      while (((size_t)1 << bits)<tableSize) {
+        bits++;
+      }
+
+      table.assign((size_t)1 << bits,emptySlot);
+      tableShift=64-bits;
+
+      for (size_t i=0; i<slots.size(); i++) {
+        if (slots[i].used) {
+          InsertIntoTable((uint32_t)i);
+        }
+      }
+    }
+
+    void InsertIntoTable(uint32_t slotIndex)
+    {
+      size_t mask=table.size()-1;
+      size_t bucket=GetBucket(slots[slotIndex].key);
+
+      while (table[bucket]!=emptySlot) {
+        bucket=(bucket+1) & mask;
+      }
+
+      table[bucket]=slotIndex;
+    }
+
+    size_t FindBucket(const K& key) const
+    {
+      if (table.empty()) {
+        return table.size();
+      }
+
+      size_t mask=table.size()-1;
+      size_t bucket=GetBucket(key);
+
+      while (table[bucket]!=emptySlot) {
+        if (slots[table[bucket]].key==key) {
+          return bucket;
+        }
+
+        bucket=(bucket+1) & mask;
+      }
+
+      return table.size();
+    }
+
+    /**
+     * Remove the given bucket from the hash table, moving following entries
+     * of the same probe sequence back (no tombstones).
+     */
+    void EraseBucket(size_t bucket)
+    {
+      size_t mask=table.size()-1;
+      size_t hole=bucket;
+      size_t current=(bucket+1) & mask;
+
+      while (table[current]!=emptySlot) {
+        size_t home=GetBucket(slots[table[current]].key);
+
+        // Move the entry to the hole, if the hole lies between its home bucket and its current bucket
+        if (((current-home) & mask)>=((current-hole) & mask)) {
+          table[hole]=table[current];
+          hole=current;
+        }
+
+        current=(current+1) & mask;
+      }
+
+      table[hole]=emptySlot;
+    }
+
+    void ReleaseSlot(uint32_t slotIndex)
+    {
+      Slot& slot=slots[slotIndex];
+
+      memory-=slot.memory;
+      size--;
+
+      slot.used=false;
+      slot.referenced=false;
+      slot.memory=0;
+      slot.value=V();
+
+      freeSlots.push_back(slotIndex);
+    }
+
+    /**
+     * Evict one entry using the CLOCK algorithm. Referenced entries get a second chance
+     * by clearing their reference bit. The entry in the slot keptSlotIndex (if given)
+     * is never evicted.
+     */
+    void EvictOne(uint32_t keptSlotIndex=emptySlot)
+    {
+      while (true) {
+        if (hand>=slots.size()) {
+          hand=0;
+        }
+
+        Slot& slot=slots[hand];
+
+        if (slot.used &&
+            hand!=keptSlotIndex) {
+          if (slot.referenced) {
+            slot.referenced=false;
+          }
+          else {
+            EraseBucket(FindBucket(slot.key));
+            ReleaseSlot((uint32_t)hand);
+            statistics.evictions++;
+            hand++;
+
+            return;
+          }
+        }
+
+        hand++;
+      }
+    }
+
+    inline bool IsOverLimit(size_t additionalEntries,
+                            size_t additionalMemory) const
+    {
+      return size+additionalEntries>maxSize ||
+             (maxMemory>0 && memory+additionalMemory>maxMemory);
+    }
+
+    inline size_t GetEntryMemory(const V& value) const
+    {
+      return GetEntryOverhead()+
+             (sizer!=nullptr ? sizer->GetSize(value) : 0);
+    }
+
+  public:
+    /**
+     * Returns the memory accounted for each entry in addition to the size of its
+     * value (the slot and its hash table index)
+     */
+    static inline size_t GetEntryOverhead()
+    {
+      return sizeof(Slot)+
+             sizeof(uint32_t);
+    }
+
+    /**
+     * Create a new cache object with the given max size (number of entries). Optionally
+     * the cache is also limited by the accounted memory of its values. The sizer, if
+     * given, must live as long as the cache.
+     */
+    explicit ClockCache(size_t maxSize,
+                        size_t maxMemory=0,
+                        const ValueSizer* sizer=nullptr)
+    : maxSize(maxSize),
+      maxMemory(maxMemory),
+      sizer(sizer),
+      size(0),
+      memory(0),
+      hand(0),
+      tableShift(64)
+    {
+      // no code
+    }
+
+    /**
+     * Returns if the cache is active (maxSize > 0)
+     */
+    inline bool IsActive() const
+    {
+      return maxSize>0;
+    }
+
+    /**
+     * Return the value with the given key from the cache by copying it to value.
+     *
+     * If there is no value stored with the given key, false will be
+     * returned and the value will be untouched.
+     */
+    bool Get(const K& key,
+             V& value)
+    {
+      size_t bucket=FindBucket(key);
+
+      if (bucket==table.size()) {
+        statistics.misses++;
+        return false;
+      }
+
+      Slot& slot=slots[table[bucket]];
+
+      slot.referenced=true;
+      value=slot.value;
+      statistics.hits++;
+
+      return true;
+    }
+
+    /**
+     * Return true, if the cache holds a value for the given key. Does not change
+     * the eviction order or statistics.
+     */
+    bool Contains(const K& key) const
+    {
+      return FindBucket(key)!=table.size();
+    }
+
+    /**
+     * Set or update the cache with the given value for the given key.
+     *
+     * If the cache is over its limits afterwards, other entries are evicted. A value,
+     * which alone exceeds the memory limit, is not cached (and an older value for the
+     * same key is removed).
+     */
+    void Put(const K& key,
+             const V& value)
+    {
+      if (!IsActive()) {
+        return;
+      }
+
+      size_t entryMemory=GetEntryMemory(value);
+      size_t bucket=FindBucket(key);
+
+      if (maxMemory>0 &&
+          entryMemory>maxMemory) {
+        if (bucket!=table.size()) {
+          uint32_t slotIndex=table[bucket];
+
+          EraseBucket(bucket);
+          ReleaseSlot(slotIndex);
+        }
+
+        return;
+      }
+
+      if (bucket!=table.size()) {
+        uint32_t slotIndex=table[bucket];
+        Slot&    slot=slots[slotIndex];
+
+        memory-=slot.memory;
+        slot.value=value;
+        slot.memory=entryMemory;
+        slot.referenced=true;
+        memory+=entryMemory;
+
+        // The entry fits into the limits on its own, so evicting the others is enough
+        while (IsOverLimit(0,0)) {
+          EvictOne(slotIndex);
+        }
+
+        return;
+      }
+
+      while (size>0 &&
+             IsOverLimit(1,entryMemory)) {
+        EvictOne();
+      }
+
+      uint32_t slotIndex;
+
+      if (!freeSlots.empty()) {
+        slotIndex=freeSlots.back();
+        freeSlots.pop_back();
+      }
+      else {
+        slotIndex=(uint32_t)slots.size();
+        slots.push_back(Slot());
+      }
+
+      Slot& slot=slots[slotIndex];
+
+      slot.key=key;
+      slot.value=value;
+      slot.memory=entryMemory;
+      slot.used=true;
+      slot.referenced=false;
+
+      size++;
+      memory+=entryMemory;
+      statistics.insertions++;
+
+      // Keep the load factor of the hash table below 0.5
+      if (2*size>table.size()) {
+        ResizeTable(std::max((size_t)16,4*size));
+      }
+      else {
+        InsertIntoTable(slotIndex);
+      }
+    }
+
+    /**
+     * Remove the entry with the given key, if available.
+     */
+    void Remove(const K& key)
+    {
+      size_t bucket=FindBucket(key);
+
+      if (bucket==table.size()) {
+        return;
+      }
+
+      uint32_t slotIndex=table[bucket];
+
+      EraseBucket(bucket);
+      ReleaseSlot(slotIndex);
+    }
+
+    /**
+     * Set a new cache max size, possibly evicting entries
+     * if the new size is smaller than the old one.
+     */
+    void SetMaxSize(size_t maxSize)
+    {
+      this->maxSize=maxSize;
+
+      while (size>0 &&
+             IsOverLimit(0,0)) {
+        EvictOne();
+      }
+    }
+
+    /**
+     * Set a new memory limit (0 means unlimited), possibly evicting entries.
+     */
+    void SetMaxMemory(size_t maxMemory)
+    {
+      this->maxMemory=maxMemory;
+
+      while (size>0 &&
+             IsOverLimit(0,0)) {
+        EvictOne();
+      }
+    }
+
+    /**
+     * Returns the maximum number of entries of the cache
+     */
+    inline size_t GetMaxSize() const
+    {
+      return maxSize;
+    }
+
+    /**
+     * Returns the memory limit of the cache, 0 if unlimited
+     */
+    inline size_t GetMaxMemory() const
+    {
+      return maxMemory;
+    }
+
+    /**
+     * Completely flush the cache removing all entries from it.
+     */
+    void Flush()
+    {
+      slots.clear();
+      freeSlots.clear();
+      table.clear();
+      tableShift=64;
+      size=0;
+      memory=0;
+      hand=0;
+    }
+
+    /**
+     * Returns the current number of entries in the cache.
+     */
+    inline size_t GetSize() const
+    {
+      return size;
+    }
+
+    /**
+     * Returns the accounted memory of all entries
+     */
+    inline size_t GetMemory() const
+    {
+      return memory;
+    }
+
+    CacheStatistics GetStatistics() const
+    {
+      CacheStatistics result=statistics;
+
+      result.entries=size;
+      result.memory=memory;
+
+      return result;
+    }
+
+    void ResetStatistics()
+    {
+      statistics=CacheStatistics();
+    }
+
+    /**
+     * Dump some cache statistics to the debug log.
+     */
+    void DumpStatistics(const char* cacheName) const
+    {
+      CacheStatistics current=GetStatistics();
+
+      log.Debug() << cacheName << " entries: " << current.entries << ", memory " << current.memory
+                  << ", hit rate " << current.GetHitRate()*100 << "%, evictions " << current.evictions;
+    }
+  };
+
+  template <class K, class V>
+  const uint32_t ClockCache<K,V>::emptySlot;
+
+  /**
+   * \ingroup Util
+   * Thread-safe cache, distributing entries by key over a number of ClockCache
+   * instances (shards), each secured by its own mutex. Concurrent accesses only
+   * block each other if they access the same shard at the same time.
+   *
+   * Limits (entries and memory) are distributed evenly over all shards.
+   */
+  template <class K, class V>
+  class ShardedCache
+  {
+  public:
+    typedef typename ClockCache<K,V>::ValueSizer ValueSizer;
+
+  private:
+    struct Shard
+    {
+      std::mutex       mutex;
+      ClockCache<K,V>  cache;
+
+      Shard(size_t maxSize,
+            size_t maxMemory,
+            const ValueSizer* sizer)
+      : cache(maxSize,maxMemory,sizer)
+      {
+        // no code
+      }
+    };
+
+  private:
+    size_t                              maxSize;
+    size_t                              maxMemory;
+    std::vector<std::unique_ptr<Shard>> shards;
+
+  private:
+    inline Shard& GetShard(const K& key) const
+    {
+      uint64_t hash=std::hash<K>()(key);
+
+      // Finalizer of MurmurHash3, decorrelates shard selection from the bucket selection within the shard
+      hash^=hash >> 33;
+      hash*=0xff51afd7ed558ccdull;
+      hash^=hash >> 33;
+
+      return *shards[(size_t)(hash % shards.size())];
+    }
+
+    static inline size_t GetShardLimit(size_t limit,
+                                       size_t shardCount)
+    {
+      if (limit==0) {
+        return 0;
+      }
+
+      return std::max((size_t)1,(limit+shardCount-1)/shardCount);
+    }
+
+  public:
+    explicit ShardedCache(size_t maxSize,
+                          size_t shardCount=16,
+                          size_t maxMemory=0,
+                          const ValueSizer* sizer=nullptr)
+    : maxSize(maxSize),
+      maxMemory(maxMemory)
+    {
+      assert(shardCount>0);
+
+      shards.reserve(shardCount);
+
+      for (size_t i=0; i<shardCount; i++) {
+        shards.push_back(std::unique_ptr<Shard>(new Shard(GetShardLimit(maxSize,shardCount),
+                                                          GetShardLimit(maxMemory,shardCount),
+                                                          sizer)));
+      }
+    }
+
+    inline bool IsActive() const
+    {
+      return maxSize>0;
+    }
+
+    /**
+     * Return the value with the given key by copying it to value.
+     *
+     * Method is thread-safe.
+     */
+    bool Get(const K& key,
+             V& value) const
+    {
+      Shard&                      shard=GetShard(key);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+
+      return shard.cache.Get(key,value);
+    }
+
+    /**
+     * Set or update the cache with the given value for the given key.
+     *
+     * Method is thread-safe.
+     */
+    void Put(const K& key,
+             const V& value) const
+    {
+      Shard&                      shard=GetShard(key);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+
+      shard.cache.Put(key,value);
+    }
+
+    /**
+     * Remove the entry with the given key, if available.
+     *
+     * Method is thread-safe.
+     */
+    void Remove(const K& key) const
+    {
+      Shard&                      shard=GetShard(key);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+
+      shard.cache.Remove(key);
+    }
+
+    /**
+     * Method is thread-safe.
+     */
+    void SetMaxSize(size_t maxSize)
+    {
+      this->maxSize=maxSize;
+
+      for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+
+        shard->cache.SetMaxSize(GetShardLimit(maxSize,shards.size()));
+      }
+    }
+
+    /**
+     * Method is thread-safe.
+     */
+    void SetMaxMemory(size_t maxMemory)
+    {
+      this->maxMemory=maxMemory;
+
+      for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+
+        shard->cache.SetMaxMemory(GetShardLimit(maxMemory,shards.size()));
+      }
+    }
+
+    inline size_t GetMaxSize() const
+    {
+      return maxSize;
+    }
+
+    inline size_t GetMaxMemory() const
+    {
+      return maxMemory;
+    }
+
+    /**
+     * Method is thread-safe.
+     */
+    void Flush() const
+    {
+      for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+
+        shard->cache.Flush();
+      }
+    }
+
+    /**
+     * Return the accumulated statistics of all shards.
+     *
+     * Method is thread-safe.
+     */
+    CacheStatistics GetStatistics() const
+    {
+      CacheStatistics result;
+
+      for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+
+        result+=shard->cache.GetStatistics();
+      }
+
+      return result;
+    }
+
+    /**
+     * Method is thread-safe.
+     */
+    void ResetStatistics() const
+    {
+      for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+
+        shard->cache.ResetStatistics();
+      }
+    }
+
+    /**
+     * Dump some cache statistics to the debug log.
+     *
+     * Method is thread-safe.
+     */
+    void DumpStatistics(const char* cacheName) const
+    {
+      CacheStatistics current=GetStatistics();
+
+      log.Debug() << cacheName << " entries: " << current.entries << ", memory " << current.memory
+                  << ", hit rate " << current.GetHitRate()*100 << "%, evictions " << current.evictions;
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef OSMSCOUT_UTIL_COORDINATEDECODING_H
+#define OSMSCOUT_UTIL_COORDINATEDECODING_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <cstddef>
+#include <cstdint>
+
+#include <osmscout/CoreImportExport.h>
+
+namespace osmscout {
+
+  /**
+   * \defgroup CoordinateDecoding Bulk decoding of coordinate arrays
+   * \ingroup File
+   *
+   * Arrays of points are stored as the first coordinate followed by the lat and lon
+   * deltas of all following coordinates, interleaved, as signed little endian values
+   * of 1, 2 or 3 bytes each (see FileWriter::Write(const std::vector<Point>&,bool)).
+   *
+   * The functions in this group decode a complete array in one pass into separate,
+   * contiguous arrays of lat and lon values. Besides a portable scalar implementation
+   * there are implementations using SSE4.1 and AVX2 on x86 processors. The best
+   * implementation supported by the processor is selected at runtime. All
+   * implementations return exactly the same results.
+   */
+
+  /**
+   * \ingroup CoordinateDecoding
+   * Implementation used for decoding
+   */
+  enum class CoordinateDecoderType
+  {
+    Scalar, //!< Portable implementation, always available
+    SSE41,  //!< x86 SSE4.1 implementation
+    AVX2    //!< x86 AVX2 implementation
+  };
+
+  extern OSMSCOUT_API bool IsCoordinateDecoderSupported(CoordinateDecoderType type);
+  extern OSMSCOUT_API CoordinateDecoderType GetCoordinateDecoderType();
+  extern OSMSCOUT_API const char* GetCoordinateDecoderName(CoordinateDecoderType type);
+
+  extern OSMSCOUT_API void DecodeCoordinateDeltas(CoordinateDecoderType type,
+                                                  const uint8_t* deltas,
+                                                  size_t deltaBytes,
+                                                  size_t count,
+                                                  uint32_t latValue,
+                                                  uint32_t lonValue,
+                                                  uint32_t* latValues,
+                                                  uint32_t* lonValues);
+
+  extern OSMSCOUT_API void ConvertCoordinateValues(CoordinateDecoderType type,
+                                                   const uint32_t* latValues,
+                                                   const uint32_t* lonValues,
+                                                   size_t count,
+                                                   double* lats,
+                                                   double* lons);
+
+  extern OSMSCOUT_API void DecodeCoordinateDeltas(const uint8_t* deltas,
+                                                  size_t deltaBytes,
+                                                  size_t count,
+                                                  uint32_t latValue,
+                                                  uint32_t lonValue,
+                                                  uint32_t* latValues,
+                                                  uint32_t* lonValues);
+
+  extern OSMSCOUT_API void ConvertCoordinateValues(const uint32_t* latValues,
+                                                   const uint32_t* lonValues,
+                                                   size_t count,
+                                                   double* lats,
+                                                   double* lons);
+}
+
+#endif
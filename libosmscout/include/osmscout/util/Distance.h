@@ -80,10 +80,9 @@ namespace osmscout {
       return *this;
     }
 
-    inline Distance(Distance &&d)
-    {
-      std::swap(meters, d.meters);
-    }
+    inline Distance(Distance &&d):
+      meters(d.meters)
+    { }
 
     inline Distance &operator=(Distance &&d)
     {
@@ -33,8 +33,10 @@
 #include <osmscout/Point.h>
 #include <osmscout/OSMScoutTypes.h>
 
+#include <osmscout/util/BlockCompression.h>
 #include <osmscout/util/Exception.h>
 #include <osmscout/util/GeoBox.h>
+#include <osmscout/util/MmapPolicy.h>
 
 #if defined(_WIN32)
   #include <windows.h>
@@ -55,6 +57,12 @@ namespace osmscout {
     mapping the complete file into the memory of the process (without
     allocating real memory) resulting in measurable speed increase because of
     exchanging buffered file access with in memory array access.
+
+    Block compressed files (see BlockCompression) are detected on opening
+    and read transparently: Positions are offsets into the uncompressed data,
+    the block containing the current position is decompressed into memory
+    and accessed like a memory mapped file. Decompressed blocks can be shared
+    between scanners of the same file via an optional BlockDataCache.
     */
   class OSMSCOUT_API FileScanner CLASS_FINAL
   {
@@ -74,6 +82,7 @@ namespace osmscout {
 
     // For mmap usage
     char                 *buffer;        //!< Pointer to the file memory
+    bool                 sharedMapping;  //!< The buffer is the memory mapping of another scanner
     FileOffset           size;           //!< Size of the memory/file
     FileOffset           offset;         //!< Current offset into the file memory
 
@@ -81,6 +90,15 @@ namespace osmscout {
     uint8_t              *byteBuffer;    //!< Temporary buffer for loading of std::vector<GeoCoord>
     size_t               byteBufferSize; //!< Size of the temporary byte buffer
 
+    // For block compressed files
+    bool                         blockCompressed; //!< File is block compressed
+    std::vector<CompressedBlock> blocks;          //!< Index of the compressed blocks
+    size_t                       currentBlock;    //!< Index of the block currently in the buffer
+    FileOffset                   bufferStart;     //!< File offset of the start of the buffer
+    FileOffset                   dataSize;        //!< Size of the uncompressed file content
+    BlockDataRef                 blockData;       //!< The decompressed current block
+    BlockDataCacheRef            blockCache;      //!< Optional cache of decompressed blocks
+
     // For Windows mmap usage
 #if defined(__WIN32__) || defined(WIN32)
     HANDLE       mmfHandle;
@@ -89,6 +107,24 @@ namespace osmscout {
   private:
     void AssureByteBufferSize(size_t size);
     void FreeBuffer();
+    void ApplyMmapPolicy(Mode mode,
+                         const MmapPolicy& mmapPolicy);
+
+    bool OpenBlockCompressed();
+    void LoadBlock(size_t blockIndex);
+
+    /**
+     * In a block compressed file, switch to the next block if the current
+     * block is completely read (reading on sequentially).
+     */
+    inline void AssureBlockData()
+    {
+      if (offset>=size &&
+          blockCompressed &&
+          currentBlock+1<blocks.size()) {
+        LoadBlock(currentBlock+1);
+      }
+    }
 
   public:
     FileScanner();
@@ -96,7 +132,8 @@ namespace osmscout {
 
     void Open(const std::string& filename,
               Mode mode,
-              bool useMmap);
+              bool useMmap,
+              const MmapPolicy& mmapPolicy=MmapPolicy());
     void Close();
     void CloseFailsafe();
 
@@ -112,6 +149,32 @@ namespace osmscout {
       return file==NULL || hasError;
     }
 
+    /**
+     * Returns true, if the file content is accessed via a memory mapping
+     */
+    inline bool IsMemoryMapped() const
+    {
+      return buffer!=NULL && !blockCompressed;
+    }
+
+    /**
+     * Returns true, if the file is block compressed
+     */
+    inline bool IsBlockCompressed() const
+    {
+      return blockCompressed;
+    }
+
+    void SetBlockCache(const BlockDataCacheRef& blockCache);
+    void ShareMapping(const FileScanner& mappedScanner);
+
+    const char* GetMappedData(FileOffset offset,
+                              size_t bytes) const;
+    const char* ReadMappedData(size_t bytes);
+
+    void Prefetch(FileOffset offset,
+                  size_t bytes) const;
+
     std::string GetFilename() const;
 
     void GotoBegin();
@@ -0,0 +1,145 @@
+#ifndef OSMSCOUT_UTIL_MMAPPOLICY_H
+#define OSMSCOUT_UTIL_MMAPPOLICY_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <cstddef>
+
+#include <osmscout/CoreImportExport.h>
+
+namespace osmscout {
+
+  /**
+    \ingroup File
+
+    Policy for memory mapping a file in FileScanner.
+
+    The default policy keeps the existing behaviour: the access advice is
+    derived from the FileScanner::Mode, the file is paged in on demand, is
+    not locked into memory and transparent huge pages are not requested.
+
+    All options are hints. If an option is not supported by the platform it is
+    silently ignored, if it fails (for example because of RLIMIT_MEMLOCK when
+    locking) a warning is logged and the file is still mapped.
+    */
+  class OSMSCOUT_API MmapPolicy
+  {
+  public:
+    enum Advice
+    {
+      AdviceDefault,    //!< Derive advice from the FileScanner::Mode
+      AdviceNormal,     //!< No special treatment (MADV_NORMAL)
+      AdviceRandom,     //!< Random access, disable read ahead (MADV_RANDOM)
+      AdviceSequential, //!< Sequential access, aggressive read ahead (MADV_SEQUENTIAL)
+      AdviceWillNeed    //!< Complete file will be accessed soon (MADV_WILLNEED)
+    };
+
+  private:
+    Advice advice;    //!< Access pattern advice
+    bool   populate;  //!< Read the complete file into the page cache on mapping
+    bool   lock;      //!< Lock the mapping into memory
+    bool   hugePages; //!< Request transparent huge pages for the mapping
+
+  public:
+    MmapPolicy();
+
+    inline MmapPolicy& SetAdvice(Advice advice)
+    {
+      this->advice=advice;
+
+      return *this;
+    }
+
+    inline MmapPolicy& SetPopulate(bool populate)
+    {
+      this->populate=populate;
+
+      return *this;
+    }
+
+    inline MmapPolicy& SetLock(bool lock)
+    {
+      this->lock=lock;
+
+      return *this;
+    }
+
+    inline MmapPolicy& SetHugePages(bool hugePages)
+    {
+      this->hugePages=hugePages;
+
+      return *this;
+    }
+
+    inline Advice GetAdvice() const
+    {
+      return advice;
+    }
+
+    inline bool GetPopulate() const
+    {
+      return populate;
+    }
+
+    inline bool GetLock() const
+    {
+      return lock;
+    }
+
+    inline bool GetHugePages() const
+    {
+      return hugePages;
+    }
+
+    /**
+     * Returns true, if the policy does not differ from the default policy
+     */
+    inline bool IsDefault() const
+    {
+      return advice==AdviceDefault &&
+             !populate &&
+             !lock &&
+             !hugePages;
+    }
+  };
+
+  /**
+    \ingroup File
+
+    Number of page faults of the current process, as reported by the
+    operating system. Memory mapped file access shows up as minor faults
+    (page already in the page cache) or major faults (page had to be read
+    from disk).
+    */
+  struct OSMSCOUT_API PageFaultCount
+  {
+    size_t minorFaults; //!< Faults resolved without I/O
+    size_t majorFaults; //!< Faults that required I/O
+
+    PageFaultCount();
+
+    PageFaultCount operator-(const PageFaultCount& other) const;
+  };
+
+  extern OSMSCOUT_API bool IsPageFaultCountSupported();
+  extern OSMSCOUT_API PageFaultCount GetPageFaultCount();
+}
+
+#endif
@@ -179,7 +179,19 @@ namespace osmscout {
     ~CoordBuffer();
 
     void Reset();
+
+    /**
+     * Return the number of coordinates currently stored in the buffer
+     */
+    inline size_t GetCoordCount() const
+    {
+      return usedPoints;
+    }
+
     size_t PushCoord(double x, double y);
+    size_t PushCoords(const CoordBuffer& other,
+                      size_t start,
+                      size_t count);
     bool GenerateParallelWay(size_t orgStart,
                              size_t orgEnd,
                              double offset,
@@ -36,7 +36,9 @@ namespace osmscout {
   AreaAreaIndex::AreaAreaIndex(size_t cacheSize)
   : maxLevel(0),
     topLevelOffset(0),
-    indexCache(cacheSize)
+    indexCache(cacheSize,
+               0,
+               &indexCacheSizer)
   {
     // no code
   }
@@ -66,24 +68,19 @@ namespace osmscout {
   {
     if (level<maxLevel) {
       std::lock_guard<std::mutex> guard(lookupMutex);
-      IndexCache::CacheRef        cacheRef;
 
 #if defined(ANALYZE_CACHE)
       if (indexCache.GetSize()==indexCache.GetMaxSize()) {
         log.Warn() << "areaarea.index cache of " << indexCache.GetSize() << "/" << indexCache.GetMaxSize()
                    << " is too small";
-        indexCache.DumpStatistics("areaarea.idx",IndexCacheValueSizer());
+        indexCache.DumpStatistics("areaarea.idx");
       }
 #endif
 
-      if (!indexCache.GetEntry(offset,cacheRef)) {
-        IndexCache::CacheEntry cacheEntry(offset);
-
-        cacheRef=indexCache.SetEntry(cacheEntry);
-
+      if (!indexCache.Get(offset,indexCell)) {
         scanner.SetPos(offset);
 
-        for (FileOffset& c : cacheRef->value.children) {
+        for (FileOffset& c : indexCell.children) {
           FileOffset childOffset;
 
           scanner.ReadNumber(childOffset);
@@ -96,12 +93,9 @@ namespace osmscout {
           }
         }
 
-        cacheRef->value.data=scanner.GetPos();
+        indexCell.data=scanner.GetPos();
 
-        indexCell=cacheRef->value;
-      }
-      else {
-        indexCell=cacheRef->value;
+        indexCache.Put(offset,indexCell);
       }
     }
     else {
@@ -226,12 +220,14 @@ namespace osmscout {
     }
   }
 
-  bool AreaAreaIndex::Open(const std::string& path, bool memoryMappedData)
+  bool AreaAreaIndex::Open(const std::string& path,
+                           bool memoryMappedData,
+                           const MmapPolicy& mmapPolicy)
   {
     datafilename=AppendFileToDir(path,AREA_AREA_IDX);
 
     try {
-      scanner.Open(datafilename,FileScanner::FastRandom,memoryMappedData);
+      scanner.Open(datafilename,FileScanner::FastRandom,memoryMappedData,mmapPolicy);
 
       scanner.ReadNumber(maxLevel);
       scanner.ReadFileOffset(topLevelOffset);
@@ -370,6 +366,6 @@ namespace osmscout {
 
   void AreaAreaIndex::DumpStatistics()
   {
-    indexCache.DumpStatistics(AREA_AREA_IDX,IndexCacheValueSizer());
+    indexCache.DumpStatistics(AREA_AREA_IDX);
   }
 }
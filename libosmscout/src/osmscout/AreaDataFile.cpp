@@ -21,12 +21,76 @@
 
 namespace osmscout {
 
+  /**
+   * Accounts the memory of an area including all its rings and their node arrays
+   */
+  class AreaValueSizer : public DataFile<Area>::ValueSizer
+  {
+  public:
+    size_t GetSize(const AreaRef& value) const override
+    {
+      size_t memory=sizeof(Area);
+
+      for (const auto& ring : value->rings) {
+        memory+=sizeof(Area::Ring)+
+                ring.nodes.capacity()*sizeof(Point);
+      }
+
+      return memory;
+    }
+  };
+
+  static const AreaValueSizer areaValueSizer;
+
   const char* AreaDataFile::AREAS_DAT="areas.dat";
   const char* AreaDataFile::AREAS_IDMAP="areas.idmap";
 
-  AreaDataFile::AreaDataFile(size_t cacheSize)
-  : DataFile<Area>(AREAS_DAT, cacheSize)
+  AreaDataFile::AreaDataFile(size_t cacheSize,
+                             size_t cacheMemory)
+  : DataFile<Area>(AREAS_DAT,
+                   cacheSize,
+                   cacheMemory,
+                   &areaValueSizer)
   {
     // no code
   }
+
+  /**
+   * Read the bounding box of the area at the current position (see AreaView::ReadBoundingBox())
+   */
+  bool AreaDataFile::ReadBoundingBox(FileScanner& scanner,
+                                     GeoBox& boundingBox) const
+  {
+    boundingBox=AreaView::ReadBoundingBox(*typeConfig,
+                                          scanner);
+
+    return true;
+  }
+
+  /**
+   * Decode the features of the given ring of a view (read from this data file) into
+   * the given buffer. The features of the area are the features of its first ring.
+   *
+   * Method is thread-safe.
+   */
+  bool AreaDataFile::GetFeatures(const AreaView::Ring& ring,
+                                 FeatureValueBuffer& buffer) const
+  {
+    ScannerLease scanner(*this);
+
+    if (!scanner.IsValid()) {
+      return false;
+    }
+
+    try {
+      ring.ReadFeatures(*scanner,
+                        buffer);
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      return false;
+    }
+
+    return true;
+  }
 }
@@ -80,12 +80,13 @@ namespace osmscout {
   }
 
   bool AreaNodeIndex::Open(const std::string& path,
-                           bool memoryMappedData)
+                           bool memoryMappedData,
+                           const MmapPolicy& mmapPolicy)
   {
     datafilename=AppendFileToDir(path,AREA_NODE_IDX);
 
     try {
-      scanner.Open(datafilename,FileScanner::FastRandom,memoryMappedData);
+      scanner.Open(datafilename,FileScanner::FastRandom,memoryMappedData,mmapPolicy);
 
       uint32_t indexEntries;
 
@@ -244,6 +245,12 @@ namespace osmscout {
           continue;
         }
 
+        // The index only has entries up to the last type with nodes
+        if (type->GetNodeId()>=nodeTypeData.size()) {
+          loadedTypes.Set(type);
+          continue;
+        }
+
         if (!GetOffsets(nodeTypeData[type->GetNodeId()],
                         boundingBox,
                         offsets)) {
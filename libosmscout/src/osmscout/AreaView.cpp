@@ -0,0 +1,238 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/AreaView.h>
+
+namespace osmscout {
+
+  AreaView::Ring::Ring()
+  : featureOffset(0),
+    ring(0),
+    firstRing(false)
+  {
+    // no code
+  }
+
+  /**
+   * Decode the features of the ring into the given buffer, using the given scanner
+   * (which must be opened on the file the view was read from).
+   *
+   * @throws IOException
+   */
+  void AreaView::Ring::ReadFeatures(FileScanner& scanner,
+                                    FeatureValueBuffer& buffer) const
+  {
+    buffer.SetType(type);
+
+    if (!firstRing &&
+        type->GetAreaId()==typeIgnore) {
+      return;
+    }
+
+    scanner.SetPos(featureOffset);
+
+    if (firstRing) {
+      bool multipleRings;
+      bool hasMaster;
+
+      buffer.Read(scanner,
+                  multipleRings,
+                  hasMaster);
+    }
+    else {
+      buffer.Read(scanner);
+    }
+  }
+
+  AreaView::AreaView()
+  : fileOffset(0),
+    nextFileOffset(0),
+    ringBuffer(nullptr),
+    firstRing(0),
+    ringCount(0)
+  {
+    // no code
+  }
+
+  /**
+   * Returns the bounding box of all outer rings of the area.
+   */
+  GeoBox AreaView::GetBoundingBox() const
+  {
+    GeoBox boundingBox;
+
+    for (size_t i=0; i<ringCount; i++) {
+      const Ring& ring=GetRing(i);
+
+      if (ring.IsOuterRing()) {
+        if (!boundingBox.IsValid()) {
+          boundingBox=ring.GetBoundingBox();
+        }
+        else {
+          boundingBox.Include(ring.GetBoundingBox());
+        }
+      }
+    }
+
+    return boundingBox;
+  }
+
+  /**
+   * Read the view from the given, memory mapped FileScanner. The rings of the area are
+   * appended to the given ring vector. The scanner is positioned after the area afterwards.
+   *
+   * @throws IOException
+   */
+  void AreaView::Read(const TypeConfig& typeConfig,
+                      FileScanner& scanner,
+                      std::vector<Ring>& rings)
+  {
+    TypeId   ringType;
+    bool     multipleRings;
+    bool     hasMaster;
+    uint32_t count=1;
+    Ring     masterRing;
+
+    fileOffset=scanner.GetPos();
+
+    scanner.ReadTypeId(ringType,
+                       typeConfig.GetAreaTypeIdBytes());
+
+    masterRing.type=typeConfig.GetAreaTypeInfo(ringType);
+    masterRing.featureOffset=scanner.GetPos();
+
+    FeatureValueBuffer::Skip(masterRing.type,
+                             scanner,
+                             multipleRings,
+                             hasMaster);
+
+    if (multipleRings) {
+      scanner.ReadNumber(count);
+
+      count++;
+    }
+
+    masterRing.ring=hasMaster ? Area::masterRingId : Area::outerRingId;
+    masterRing.firstRing=true;
+
+    masterRing.nodes.Read(scanner,
+                          masterRing.type->CanRoute());
+
+    ringBuffer=&rings;
+    firstRing=rings.size();
+    ringCount=count;
+
+    rings.push_back(masterRing);
+
+    for (size_t i=1; i<count; i++) {
+      Ring ring;
+
+      scanner.ReadTypeId(ringType,
+                         typeConfig.GetAreaTypeIdBytes());
+
+      ring.type=typeConfig.GetAreaTypeInfo(ringType);
+      ring.featureOffset=scanner.GetPos();
+
+      if (ring.type->GetAreaId()!=typeIgnore) {
+        FeatureValueBuffer::Skip(ring.type,
+                                 scanner);
+      }
+
+      scanner.Read(ring.ring);
+      ring.nodes.Read(scanner,
+                      ring.type->GetAreaId()!=typeIgnore &&
+                      ring.type->CanRoute());
+
+      rings.push_back(ring);
+    }
+
+    nextFileOffset=scanner.GetPos();
+  }
+
+  /**
+   * Read the bounding box of all outer rings of the area at the current position of the
+   * given, memory mapped FileScanner, without creating a view or storing its rings. The
+   * scanner is positioned after the area afterwards.
+   *
+   * @throws IOException
+   */
+  GeoBox AreaView::ReadBoundingBox(const TypeConfig& typeConfig,
+                                   FileScanner& scanner)
+  {
+    TypeId         ringType;
+    TypeInfoRef    type;
+    bool           multipleRings;
+    bool           hasMaster;
+    uint32_t       count=1;
+    uint8_t        ring;
+    PointArrayView nodes;
+    GeoBox         boundingBox;
+
+    scanner.ReadTypeId(ringType,
+                       typeConfig.GetAreaTypeIdBytes());
+
+    type=typeConfig.GetAreaTypeInfo(ringType);
+
+    FeatureValueBuffer::Skip(type,
+                             scanner,
+                             multipleRings,
+                             hasMaster);
+
+    if (multipleRings) {
+      scanner.ReadNumber(count);
+
+      count++;
+    }
+
+    nodes.Read(scanner,
+               type->CanRoute());
+
+    if (!hasMaster) {
+      boundingBox=nodes.GetBoundingBox();
+    }
+
+    for (size_t i=1; i<count; i++) {
+      scanner.ReadTypeId(ringType,
+                         typeConfig.GetAreaTypeIdBytes());
+
+      type=typeConfig.GetAreaTypeInfo(ringType);
+
+      if (type->GetAreaId()!=typeIgnore) {
+        FeatureValueBuffer::Skip(type,
+                                 scanner);
+      }
+
+      scanner.Read(ring);
+      nodes.Read(scanner,
+                 type->GetAreaId()!=typeIgnore &&
+                 type->CanRoute());
+
+      if (ring==Area::outerRingId) {
+        if (!boundingBox.IsValid()) {
+          boundingBox=nodes.GetBoundingBox();
+        }
+        else {
+          boundingBox.Include(nodes.GetBoundingBox());
+        }
+      }
+    }
+
+    return boundingBox;
+  }
+}
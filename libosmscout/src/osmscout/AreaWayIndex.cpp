@@ -85,12 +85,13 @@ namespace osmscout {
 
   bool AreaWayIndex::Open(const TypeConfigRef& typeConfig,
                           const std::string& path,
-                          bool memoryMappedData)
+                          bool memoryMappedData,
+                          const MmapPolicy& mmapPolicy)
   {
     datafilename=AppendFileToDir(path,AREA_WAY_IDX);
 
     try {
-      scanner.Open(datafilename,FileScanner::FastRandom,memoryMappedData);
+      scanner.Open(datafilename,FileScanner::FastRandom,memoryMappedData,mmapPolicy);
 
       uint32_t indexEntries;
 
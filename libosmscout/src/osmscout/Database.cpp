@@ -20,6 +20,7 @@
 #include <osmscout/Database.h>
 
 #include <algorithm>
+#include <functional>
 
 #if _OPENMP
 #include <omp.h>
@@ -34,17 +35,46 @@
 
 namespace osmscout {
 
+  /**
+   * Return the box enclosing the circle around the location. GeoBox::BoxByCenterAndRadius()
+   * uses the radius as distance to the corners, so its box is inscribed into the circle.
+   */
+  static GeoBox GetRadiusBox(const GeoCoord& location,
+                             const Distance& radius)
+  {
+    return GeoBox::BoxByCenterAndRadius(location,
+                                        radius*std::sqrt(2.0));
+  }
+
+  /**
+   * Return false, if the line segment is completely outside of the box. Segments
+   * outside of the box around the search radius cannot be closer than the radius,
+   * so the expensive distance calculation can be skipped.
+   */
+  static bool IsSegmentInBox(const GeoBox& box,
+                             const GeoCoord& a,
+                             const GeoCoord& b)
+  {
+    return !(std::max(a.GetLat(),b.GetLat())<box.GetMinLat() ||
+             std::min(a.GetLat(),b.GetLat())>box.GetMaxLat() ||
+             std::max(a.GetLon(),b.GetLon())<box.GetMinLon() ||
+             std::min(a.GetLon(),b.GetLon())>box.GetMaxLon());
+  }
+
   DatabaseParameter::DatabaseParameter()
   : areaAreaIndexCacheSize(5000),
     nodeDataCacheSize(5000),
     wayDataCacheSize(10000),
     areaDataCacheSize(5000),
+    wayDataCacheMemory(0),
+    areaDataCacheMemory(0),
     routerDataMMap(true),
     nodesDataMMap(true),
     areasDataMMap(true),
     waysDataMMap(true),
     optimizeLowZoomMMap(true),
-    indexMMap(true)
+    indexMMap(true),
+    prefetchThreadCount(2)
   {
     // no code
   }
@@ -69,6 +99,16 @@ namespace osmscout {
     this->areaDataCacheSize=size;
   }
 
+  void DatabaseParameter::SetWayDataCacheMemory(unsigned long memory)
+  {
+    this->wayDataCacheMemory=memory;
+  }
+
+  void DatabaseParameter::SetAreaDataCacheMemory(unsigned long memory)
+  {
+    this->areaDataCacheMemory=memory;
+  }
+
   void DatabaseParameter::SetRouterDataMMap(bool mmap)
   {
     routerDataMMap=mmap;
@@ -99,6 +139,32 @@ namespace osmscout {
     indexMMap=mmap;
   }
 
+  void DatabaseParameter::SetDataMMapPolicy(const MmapPolicy& policy)
+  {
+    dataMMapPolicy=policy;
+  }
+
+  void DatabaseParameter::SetIndexMMapPolicy(const MmapPolicy& policy)
+  {
+    indexMMapPolicy=policy;
+  }
+
+  /**
+   * Set the policy for the memory mapping of the given file (for example
+   * "nodes.dat" or "areaway.idx"), overwriting the policy for data files
+   * or index files.
+   */
+  void DatabaseParameter::SetFileMMapPolicy(const std::string& filename,
+                                            const MmapPolicy& policy)
+  {
+    fileMMapPolicies[filename]=policy;
+  }
+
+  void DatabaseParameter::SetPrefetchThreadCount(unsigned long threadCount)
+  {
+    this->prefetchThreadCount=threadCount;
+  }
+
   unsigned long DatabaseParameter::GetAreaAreaIndexCacheSize() const
   {
     return areaAreaIndexCacheSize;
@@ -119,6 +185,16 @@ namespace osmscout {
     return areaDataCacheSize;
   }
 
+  unsigned long DatabaseParameter::GetWayDataCacheMemory() const
+  {
+    return wayDataCacheMemory;
+  }
+
+  unsigned long DatabaseParameter::GetAreaDataCacheMemory() const
+  {
+    return areaDataCacheMemory;
+  }
+
   bool DatabaseParameter::GetRouterDataMMap() const
   {
     return routerDataMMap;
@@ -149,6 +225,41 @@ namespace osmscout {
     return indexMMap;
   }
 
+  MmapPolicy DatabaseParameter::GetFileMMapPolicy(const std::string& filename,
+                                                 const MmapPolicy& defaultPolicy) const
+  {
+    auto entry=fileMMapPolicies.find(filename);
+
+    if (entry!=fileMMapPolicies.end()) {
+      return entry->second;
+    }
+
+    return defaultPolicy;
+  }
+
+  /**
+   * Return the policy for memory mapping the given data file
+   */
+  MmapPolicy DatabaseParameter::GetDataMMapPolicy(const std::string& filename) const
+  {
+    return GetFileMMapPolicy(filename,
+                             dataMMapPolicy);
+  }
+
+  /**
+   * Return the policy for memory mapping the given index file
+   */
+  MmapPolicy DatabaseParameter::GetIndexMMapPolicy(const std::string& filename) const
+  {
+    return GetFileMMapPolicy(filename,
+                             indexMMapPolicy);
+  }
+
+  unsigned long DatabaseParameter::GetPrefetchThreadCount() const
+  {
+    return prefetchThreadCount;
+  }
+
   NodeRegionSearchResultEntry::NodeRegionSearchResultEntry(const NodeRef &node,
                                                            const Distance &distance)
   : node(node),
@@ -205,6 +316,8 @@ namespace osmscout {
       return false;
     }
 
+    openPageFaults=GetPageFaultCount();
+
     isOpen=true;
 
     return true;
@@ -217,6 +330,8 @@ namespace osmscout {
 
   void Database::Close()
   {
+    StopPrefetch();
+
     boundingBoxDataFile=nullptr;
 
     if (nodeDataFile &&
@@ -329,7 +444,8 @@ namespace osmscout {
 
       if (!nodeDataFile->Open(typeConfig,
                               path,
-                              parameter.GetNodesDataMMap())) {
+                              parameter.GetNodesDataMMap(),
+                              parameter.GetDataMMapPolicy(NodeDataFile::NODES_DAT))) {
         log.Error() << "Cannot open 'nodes.dat'!";
         return nullptr;
       }
@@ -351,7 +467,8 @@ namespace osmscout {
     }
 
     if (!areaDataFile) {
-      areaDataFile=std::make_shared<AreaDataFile>(parameter.GetAreaDataCacheSize());
+      areaDataFile=std::make_shared<AreaDataFile>(parameter.GetAreaDataCacheSize(),
+                                                    parameter.GetAreaDataCacheMemory());
     }
 
     if (!areaDataFile->IsOpen()) {
@@ -359,7 +476,8 @@ namespace osmscout {
 
       if (!areaDataFile->Open(typeConfig,
                               path,
-                              parameter.GetAreasDataMMap())) {
+                              parameter.GetAreasDataMMap(),
+                              parameter.GetDataMMapPolicy(AreaDataFile::AREAS_DAT))) {
         log.Error() << "Cannot open 'areas.dat'!";
         return nullptr;
       }
@@ -381,7 +499,8 @@ namespace osmscout {
     }
 
     if (!wayDataFile) {
-      wayDataFile=std::make_shared<WayDataFile>(parameter.GetWayDataCacheSize());
+      wayDataFile=std::make_shared<WayDataFile>(parameter.GetWayDataCacheSize(),
+                                                  parameter.GetWayDataCacheMemory());
     }
 
     if (!wayDataFile->IsOpen()) {
@@ -389,7 +508,8 @@ namespace osmscout {
 
       if (!wayDataFile->Open(typeConfig,
                              path,
-                             parameter.GetWaysDataMMap())) {
+                             parameter.GetWaysDataMMap(),
+                             parameter.GetDataMMapPolicy(WayDataFile::WAYS_DAT))) {
         log.Error() << "Cannot open 'ways.dat'!";
         return nullptr;
       }
@@ -415,7 +535,9 @@ namespace osmscout {
 
       StopClock timer;
 
-      if (!areaNodeIndex->Open(path, parameter.GetIndexMMap())) {
+      if (!areaNodeIndex->Open(path,
+                               parameter.GetIndexMMap(),
+                               parameter.GetIndexMMapPolicy(AreaNodeIndex::AREA_NODE_IDX))) {
         log.Error() << "Cannot load area node index!";
         areaNodeIndex=nullptr;
 
@@ -443,7 +565,9 @@ namespace osmscout {
 
       StopClock timer;
 
-      if (!areaAreaIndex->Open(path, parameter.GetIndexMMap())) {
+      if (!areaAreaIndex->Open(path,
+                               parameter.GetIndexMMap(),
+                               parameter.GetIndexMMapPolicy(AreaAreaIndex::AREA_AREA_IDX))) {
         log.Error() << "Cannot load area area index!";
         areaAreaIndex=nullptr;
 
@@ -473,7 +597,8 @@ namespace osmscout {
 
       if (!areaWayIndex->Open(typeConfig,
                               path,
-                              parameter.GetIndexMMap())) {
+                              parameter.GetIndexMMap(),
+                              parameter.GetIndexMMapPolicy(AreaWayIndex::AREA_WAY_IDX))) {
         log.Error() << "Cannot load area way index!";
         areaWayIndex=nullptr;
 
@@ -529,7 +654,9 @@ namespace osmscout {
 
       StopClock timer;
 
-      if (!waterIndex->Open(path, parameter.GetIndexMMap())) {
+      if (!waterIndex->Open(path,
+                            parameter.GetIndexMMap(),
+                            parameter.GetIndexMMapPolicy(WaterIndex::WATER_IDX))) {
         log.Error() << "Cannot load water index!";
         waterIndex=nullptr;
 
@@ -559,7 +686,8 @@ namespace osmscout {
 
       if (!optimizeAreasLowZoom->Open(typeConfig,
                                       path,
-                                      parameter.GetOptimizeLowZoomMMap())) {
+                                      parameter.GetOptimizeLowZoomMMap(),
+                                      parameter.GetDataMMapPolicy(OptimizeAreasLowZoom::FILE_AREASOPT_DAT))) {
         log.Error() << "Cannot load optimize areas low zoom index!";
         optimizeAreasLowZoom=nullptr;
 
@@ -586,7 +714,8 @@ namespace osmscout {
 
       if (!optimizeWaysLowZoom->Open(typeConfig,
                                      path,
-                                     parameter.GetOptimizeLowZoomMMap())) {
+                                     parameter.GetOptimizeLowZoomMMap(),
+                                     parameter.GetDataMMapPolicy(OptimizeWaysLowZoom::FILE_WAYSOPT_DAT))) {
         log.Error() << "Cannot load optimize areas low zoom index!";
         optimizeWaysLowZoom=nullptr;
 
@@ -885,6 +1014,27 @@ namespace osmscout {
                                          areas);
   }
 
+  /**
+   * Load the areas in the given spans, which intersect the given bounding box.
+   * If the data file is memory mapped, areas outside the bounding box are
+   * skipped without loading them.
+   */
+  bool Database::GetAreasByBlockSpans(const std::vector<DataBlockSpan>& spans,
+                                      const GeoBox& boundingBox,
+                                      std::vector<AreaRef>& areas) const
+  {
+    AreaDataFileRef areaDataFile=GetAreaDataFile();
+
+    if (!areaDataFile) {
+      return false;
+    }
+
+    return areaDataFile->GetByBlockSpans(spans.begin(),
+                                         spans.end(),
+                                         boundingBox,
+                                         areas);
+  }
+
   bool Database::GetWayByOffset(const FileOffset& offset,
                                 WayRef& way) const
   {
@@ -925,6 +1075,38 @@ namespace osmscout {
     return result;
   }
 
+  /**
+   * Load the ways at the given offsets, which intersect the given bounding box.
+   * If the data file is memory mapped, ways outside the bounding box are
+   * skipped without loading them.
+   */
+  bool Database::GetWaysByOffset(const std::vector<FileOffset>& offsets,
+                                 const GeoBox& boundingBox,
+                                 std::vector<WayRef>& ways) const
+  {
+    WayDataFileRef wayDataFile=GetWayDataFile();
+
+    if (!wayDataFile) {
+      return false;
+    }
+
+    StopClock time;
+
+    bool result=wayDataFile->GetByOffset(offsets.begin(),
+                                         offsets.end(),
+                                         offsets.size(),
+                                         boundingBox,
+                                         ways);
+
+    time.Stop();
+
+    if (time.GetMilliseconds()>100) {
+      log.Warn() << "Retrieving " << ways.size() << " ways by offset took " << time.ResultString();
+    }
+
+    return result;
+  }
+
   bool Database::GetWaysByOffset(const std::set<FileOffset>& offsets,
                                  std::vector<WayRef>& ways) const
   {
@@ -988,8 +1170,276 @@ namespace osmscout {
     return result;
   }
 
+  /**
+   * Load the data of the given types in the given area in the background, to warm
+   * the page cache of the operating system and the object caches of the data files,
+   * so that a later, synchronous request for the same data (e.g. after the user panned
+   * the map in the given direction or for tiles along a route) does not block on disk I/O.
+   *
+   * Requests are queued and processed by a fixed number of threads (see
+   * DatabaseParameter::SetPrefetchThreadCount()). Outdated requests can be canceled
+   * via the given breaker, all pending requests are canceled on Close().
+   *
+   * Method is thread-safe.
+   *
+   * @param boundingBox
+   *    Area to prefetch
+   * @param types
+   *    Types to prefetch (node, way and area types)
+   * @param magnification
+   *    Magnification the data will be requested with (influences the area levels loaded and
+   *    the usage of low zoom optimizations)
+   * @param breaker
+   *    Optional breaker to cancel the request
+   * @return
+   *    Future signaling the end of the request, the result is false, if the request was
+   *    canceled or failed
+   */
+  std::future<bool> Database::Prefetch(const GeoBox& boundingBox,
+                                       const TypeInfoSet& types,
+                                       const Magnification& magnification,
+                                       const BreakerRef& breaker) const
+  {
+    std::packaged_task<bool()> task(std::bind(&Database::PrefetchData,
+                                              this,
+                                              boundingBox,
+                                              types,
+                                              magnification,
+                                              breaker));
+    std::future<bool>          result=task.get_future();
+
+    std::lock_guard<std::mutex> guard(prefetchMutex);
+
+    if (!IsOpen()) {
+      log.Error() << "Cannot prefetch data, database is not open";
+
+      std::promise<bool> failure;
+
+      failure.set_value(false);
+
+      return failure.get_future();
+    }
+
+    if (!prefetchQueue) {
+      prefetchQueue.reset(new WorkQueue<bool>());
+
+      for (unsigned long i=0; i<std::max(parameter.GetPrefetchThreadCount(),1ul); i++) {
+        prefetchThreads.push_back(std::thread(&Database::PrefetchLoop,this));
+      }
+    }
+
+    prefetchQueue->PushTask(task);
+
+    return result;
+  }
+
+  void Database::PrefetchLoop() const
+  {
+    std::packaged_task<bool()> task;
+
+    while (prefetchQueue->PopTask(task)) {
+      task();
+    }
+  }
+
+  /**
+   * Stop all prefetch threads. Pending requests are canceled.
+   */
+  void Database::StopPrefetch()
+  {
+    std::lock_guard<std::mutex> guard(prefetchMutex);
+
+    if (!prefetchQueue) {
+      return;
+    }
+
+    prefetchBreaker.Break();
+    prefetchQueue->Stop();
+
+    for (auto& thread : prefetchThreads) {
+      thread.join();
+    }
+
+    prefetchThreads.clear();
+    prefetchQueue.reset();
+    prefetchBreaker.Reset();
+  }
+
+  /**
+   * Resolve the index offsets of the objects of the given types in the given area
+   * and load them via the data files. Objects are loaded in chunks, so that a
+   * request can be canceled in between.
+   */
+  bool Database::PrefetchData(const GeoBox& boundingBox,
+                              const TypeInfoSet& types,
+                              const Magnification& magnification,
+                              const BreakerRef& breaker) const
+  {
+    static const size_t chunkSize=1000;
+
+    auto isAborted=[this,&breaker]() {
+      return prefetchBreaker.IsAborted() ||
+             (breaker && breaker->IsAborted());
+    };
+
+    if (isAborted()) {
+      return false;
+    }
+
+    TypeInfoSet nodeTypes(typeConfig->GetNodeTypes());
+    TypeInfoSet wayTypes(typeConfig->GetWayTypes());
+    TypeInfoSet areaTypes(typeConfig->GetAreaTypes());
+    TypeInfoSet loadedTypes;
+
+    nodeTypes.Intersection(types);
+    wayTypes.Intersection(types);
+    areaTypes.Intersection(types);
+
+    // Types handled by low zoom optimizations are not loaded from the data files
+    OptimizeWaysLowZoomRef optimizeWaysLowZoom=GetOptimizeWaysLowZoom();
+
+    if (!wayTypes.Empty() &&
+        optimizeWaysLowZoom &&
+        optimizeWaysLowZoom->HasOptimizations(magnification.GetMagnification())) {
+      TypeInfoSet optimizedTypes;
+
+      optimizeWaysLowZoom->GetTypes(magnification,
+                                    wayTypes,
+                                    optimizedTypes);
+
+      wayTypes.Remove(optimizedTypes);
+    }
+
+    OptimizeAreasLowZoomRef optimizeAreasLowZoom=GetOptimizeAreasLowZoom();
+
+    if (!areaTypes.Empty() &&
+        optimizeAreasLowZoom &&
+        optimizeAreasLowZoom->HasOptimizations(magnification.GetMagnification())) {
+      TypeInfoSet optimizedTypes;
+
+      optimizeAreasLowZoom->GetTypes(magnification,
+                                     areaTypes,
+                                     optimizedTypes);
+
+      areaTypes.Remove(optimizedTypes);
+    }
+
+    if (!nodeTypes.Empty()) {
+      AreaNodeIndexRef        areaNodeIndex=GetAreaNodeIndex();
+      NodeDataFileRef         nodeDataFile=GetNodeDataFile();
+      std::vector<FileOffset> offsets;
+
+      if (!areaNodeIndex ||
+          !nodeDataFile ||
+          !areaNodeIndex->GetOffsets(boundingBox,
+                                     nodeTypes,
+                                     offsets,
+                                     loadedTypes)) {
+        log.Error() << "Error prefetching nodes";
+        return false;
+      }
+
+      for (size_t start=0; start<offsets.size(); start+=chunkSize) {
+        size_t               end=std::min(start+chunkSize,offsets.size());
+        std::vector<NodeRef> nodes;
+
+        if (isAborted() ||
+            !nodeDataFile->GetByOffset(offsets.begin()+start,
+                                       offsets.begin()+end,
+                                       end-start,
+                                       nodes)) {
+          return false;
+        }
+      }
+    }
+
+    if (!wayTypes.Empty()) {
+      AreaWayIndexRef         areaWayIndex=GetAreaWayIndex();
+      WayDataFileRef          wayDataFile=GetWayDataFile();
+      std::vector<FileOffset> offsets;
+
+      if (isAborted()) {
+        return false;
+      }
+
+      if (!areaWayIndex ||
+          !wayDataFile ||
+          !areaWayIndex->GetOffsets(boundingBox,
+                                    wayTypes,
+                                    offsets,
+                                    loadedTypes)) {
+        log.Error() << "Error prefetching ways";
+        return false;
+      }
+
+      for (size_t start=0; start<offsets.size(); start+=chunkSize) {
+        size_t              end=std::min(start+chunkSize,offsets.size());
+        std::vector<WayRef> ways;
+
+        if (isAborted() ||
+            !wayDataFile->GetByOffset(offsets.begin()+start,
+                                      offsets.begin()+end,
+                                      end-start,
+                                      ways)) {
+          return false;
+        }
+      }
+    }
+
+    if (!areaTypes.Empty()) {
+      AreaAreaIndexRef           areaAreaIndex=GetAreaAreaIndex();
+      AreaDataFileRef            areaDataFile=GetAreaDataFile();
+      std::vector<DataBlockSpan> spans;
+
+      if (isAborted()) {
+        return false;
+      }
+
+      // Same maximum area level as the default of the MapService
+      if (!areaAreaIndex ||
+          !areaDataFile ||
+          !areaAreaIndex->GetAreasInArea(*typeConfig,
+                                         boundingBox,
+                                         magnification.GetLevel()+4,
+                                         areaTypes,
+                                         spans,
+                                         loadedTypes)) {
+        log.Error() << "Error prefetching areas";
+        return false;
+      }
+
+      std::sort(spans.begin(),spans.end());
+
+      for (size_t start=0; start<spans.size(); start+=chunkSize) {
+        size_t               end=std::min(start+chunkSize,spans.size());
+        std::vector<AreaRef> areas;
+
+        if (isAborted() ||
+            !areaDataFile->GetByBlockSpans(spans.begin()+start,
+                                           spans.begin()+end,
+                                           areas)) {
+          return false;
+        }
+      }
+    }
+
+    return !isAborted();
+  }
+
   void Database::DumpStatistics()
   {
+    if (nodeDataFile) {
+      nodeDataFile->DumpStatistics();
+    }
+
+    if (areaDataFile) {
+      areaDataFile->DumpStatistics();
+    }
+
+    if (wayDataFile) {
+      wayDataFile->DumpStatistics();
+    }
+
     if (areaAreaIndex) {
       areaAreaIndex->DumpStatistics();
     }
@@ -1001,6 +1451,13 @@ namespace osmscout {
     if (waterIndex) {
       waterIndex->DumpStatistics();
     }
+
+    if (IsPageFaultCountSupported()) {
+      PageFaultCount pageFaults=GetPageFaultCount()-openPageFaults;
+
+      // Process wide, contains page faults not caused by the database, too
+      log.Debug() << "Page faults since open: " << pageFaults.minorFaults << " minor, " << pageFaults.majorFaults << " major";
+    }
   }
 
   NodeRegionSearchResult Database::LoadNodesInRadius(const GeoCoord& location,
@@ -1014,8 +1471,8 @@ namespace osmscout {
     }
 
     NodeRegionSearchResult  result;
-    GeoBox                  box=GeoBox::BoxByCenterAndRadius(location,
-                                                             maxDistance);
+    GeoBox                  box=GetRadiusBox(location,
+                                             maxDistance);
     std::vector<FileOffset> offsets;
     TypeInfoSet             loadedAddressTypes;
 
@@ -1066,8 +1523,8 @@ namespace osmscout {
     }
 
     WayRegionSearchResult   result;
-    GeoBox                  box=GeoBox::BoxByCenterAndRadius(location,
-                                                             maxDistance);
+    GeoBox                  box=GetRadiusBox(location,
+                                             maxDistance);
     std::vector<FileOffset> offsets;
     TypeInfoSet             loadedAddressTypes;
 
@@ -1108,6 +1565,10 @@ namespace osmscout {
         a=way->nodes[i-1].GetCoord();
         b=way->nodes[i].GetCoord();
 
+        if (!IsSegmentInBox(box,a,b)) {
+          continue;
+        }
+
         double newDistance=CalculateDistancePointToLineSegment(location,
                                                                a,
                                                                b,
@@ -1147,8 +1608,8 @@ namespace osmscout {
     }
 
     AreaRegionSearchResult     result;
-    GeoBox                     box=GeoBox::BoxByCenterAndRadius(location,
-                                                                maxDistance);
+    GeoBox                     box=GetRadiusBox(location,
+                                                maxDistance);
     std::vector<DataBlockSpan> areaSpans;
     TypeInfoSet                loadedTypes;
 
@@ -1213,6 +1674,10 @@ namespace osmscout {
               b=ring.nodes[i].GetCoord();
             }
 
+            if (!IsSegmentInBox(box,a,b)) {
+              continue;
+            }
+
             double newDistance=CalculateDistancePointToLineSegment(location,
                                                                    a,
                                                                    b,
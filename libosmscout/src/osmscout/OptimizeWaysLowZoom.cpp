@@ -74,13 +74,14 @@ namespace osmscout
 
   bool OptimizeWaysLowZoom::Open(const TypeConfigRef& typeConfig,
                                  const std::string& path,
-                                 bool memoryMappedData)
+                                 bool memoryMappedData,
+                                 const MmapPolicy& mmapPolicy)
   {
     this->typeConfig=typeConfig;
     datafilename=AppendFileToDir(path,FILE_WAYSOPT_DAT);
 
     try {
-      scanner.Open(datafilename,FileScanner::LowMemRandom,memoryMappedData);
+      scanner.Open(datafilename,FileScanner::LowMemRandom,memoryMappedData,mmapPolicy);
 
       FileOffset indexOffset;
 
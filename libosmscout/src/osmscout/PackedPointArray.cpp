@@ -0,0 +1,331 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2026  libosmscout contributors
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/PackedPointArray.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <osmscout/util/CoordinateDecoding.h>
+
+namespace osmscout {
+
+  /**
+   * Number of coordinates converted to degrees in one go by the geometry kernels
+   */
+  static const size_t CHUNK_SIZE=256;
+
+  PackedPointArray::PackedPointArray()
+  {
+    // no code
+  }
+
+  PackedPointArray::PackedPointArray(const std::vector<Point>& points)
+  {
+    Set(points);
+  }
+
+  PackedPointArray::PackedPointArray(const std::vector<GeoCoord>& coords)
+  {
+    Set(coords);
+  }
+
+  /**
+   * Initialize the array from the given points. The serial array is only
+   * allocated, if at least one point has a serial.
+   */
+  void PackedPointArray::Set(const std::vector<Point>& points)
+  {
+    latValues.resize(points.size());
+    lonValues.resize(points.size());
+    serials.clear();
+
+    for (size_t i=0; i<points.size(); i++) {
+      latValues[i]=LatToValue(points[i].GetLat());
+      lonValues[i]=LonToValue(points[i].GetLon());
+
+      if (points[i].GetSerial()!=0) {
+        if (serials.empty()) {
+          serials.resize(points.size(),0);
+        }
+
+        serials[i]=points[i].GetSerial();
+      }
+    }
+  }
+
+  void PackedPointArray::Set(const std::vector<GeoCoord>& coords)
+  {
+    latValues.resize(coords.size());
+    lonValues.resize(coords.size());
+    serials.clear();
+
+    for (size_t i=0; i<coords.size(); i++) {
+      latValues[i]=LatToValue(coords[i].GetLat());
+      lonValues[i]=LonToValue(coords[i].GetLon());
+    }
+  }
+
+  /**
+   * Resize the array to the given number of points and remove all serials.
+   * The fixed point values can then be filled directly (see GetLatValues()
+   * and GetLonValues()).
+   */
+  void PackedPointArray::Resize(size_t count)
+  {
+    latValues.resize(count);
+    lonValues.resize(count);
+    serials.clear();
+  }
+
+  void PackedPointArray::SetSerial(size_t index,
+                                   uint8_t serial)
+  {
+    if (serials.empty()) {
+      if (serial==0) {
+        return;
+      }
+
+      serials.resize(latValues.size(),0);
+    }
+
+    serials[index]=serial;
+  }
+
+  void PackedPointArray::Clear()
+  {
+    latValues.clear();
+    lonValues.clear();
+    serials.clear();
+  }
+
+  /**
+   * Returns the same id as Point::GetId() for the point at the given index,
+   * without converting the coordinate back to fixed point values.
+   */
+  Id PackedPointArray::GetId(size_t index) const
+  {
+    uint64_t latValue=(uint32_t)latValues[index];
+    uint64_t lonValue=(uint32_t)lonValues[index];
+    Id       id;
+
+    id=((latValue & 0x000000ff) <<  8)+  // 0 => 8
+       ((lonValue & 0x000000ff) <<  0)+  // 0 => 0
+       ((latValue & 0x0000ff00) << 16)+  // 8 => 24
+       ((lonValue & 0x0000ff00) <<  8)+  // 8 => 16
+       ((latValue & 0x00ff0000) << 24)+  // 16 => 40
+       ((lonValue & 0x00ff0000) << 16)+  // 16 => 32
+       ((latValue & 0x07000000) << 27)+  // 24 => 51
+       ((lonValue & 0x07000000) << 24);  // 24 => 48
+
+    id=id << 8;
+
+    id|=GetSerial(index);
+
+    return id;
+  }
+
+  void PackedPointArray::GetPoints(std::vector<Point>& points) const
+  {
+    points.resize(latValues.size());
+
+    for (size_t i=0; i<latValues.size(); i++) {
+      points[i].Set(GetSerial(i),
+                    GetCoord(i));
+    }
+  }
+
+  void PackedPointArray::GetCoords(std::vector<GeoCoord>& coords) const
+  {
+    coords.resize(latValues.size());
+
+    for (size_t i=0; i<latValues.size(); i++) {
+      coords[i]=GetCoord(i);
+    }
+  }
+
+  /**
+   * Bounding box of all points. Min and max are calculated on the fixed point
+   * values and only the result is converted to degrees.
+   */
+  GeoBox PackedPointArray::GetBoundingBox() const
+  {
+    if (latValues.empty()) {
+      return GeoBox();
+    }
+
+    auto latRange=std::minmax_element(latValues.begin(),latValues.end());
+    auto lonRange=std::minmax_element(lonValues.begin(),lonValues.end());
+
+    return GeoBox(GeoCoord(*latRange.first/latConversionFactor-90.0,
+                           *lonRange.first/lonConversionFactor-180.0),
+                  GeoCoord(*latRange.second/latConversionFactor-90.0,
+                           *lonRange.second/lonConversionFactor-180.0));
+  }
+
+  /**
+   * Return the number of bytes allocated for the array, including the object itself
+   */
+  size_t PackedPointArray::GetMemoryUsage() const
+  {
+    return sizeof(PackedPointArray)+
+           latValues.capacity()*sizeof(int32_t)+
+           lonValues.capacity()*sizeof(int32_t)+
+           serials.capacity()*sizeof(uint8_t);
+  }
+
+  void ConvertPackedCoords(const PackedPointArray& nodes,
+                           size_t offset,
+                           size_t count,
+                           double* lats,
+                           double* lons)
+  {
+    // Fixed point values are never negative, so they can be read as unsigned values
+    ConvertCoordinateValues(reinterpret_cast<const uint32_t*>(nodes.GetLatValues()+offset),
+                            reinterpret_cast<const uint32_t*>(nodes.GetLonValues()+offset),
+                            count,
+                            lats,
+                            lons);
+  }
+
+  bool IsCoordInArea(const GeoCoord& point,
+                     const PackedPointArray& nodes)
+  {
+    if (nodes.empty()) {
+      return false;
+    }
+
+    double lats[CHUNK_SIZE+1];
+    double lons[CHUNK_SIZE+1];
+    double pointLat=point.GetLat();
+    double pointLon=point.GetLon();
+    bool   c=false;
+
+    // Slot 0 always holds the predecessor of the first point of the chunk,
+    // starting with the last point of the ring
+    ConvertPackedCoords(nodes,nodes.size()-1,1,lats,lons);
+
+    for (size_t offset=0; offset<nodes.size(); offset+=CHUNK_SIZE) {
+      size_t count=std::min(CHUNK_SIZE,nodes.size()-offset);
+
+      ConvertPackedCoords(nodes,offset,count,lats+1,lons+1);
+
+      for (size_t i=1; i<=count; i++) {
+        size_t j=i-1;
+
+        if (pointLat==lats[i] &&
+            pointLon==lons[i]) {
+          return true;
+        }
+
+        if ((((lats[i]<=pointLat) && (pointLat<lats[j])) ||
+             ((lats[j]<=pointLat) && (pointLat<lats[i]))) &&
+            (pointLon<(lons[j]-lons[i])*(pointLat-lats[i])/(lats[j]-lats[i])+lons[i])) {
+          c=!c;
+        }
+      }
+
+      lats[0]=lats[count];
+      lons[0]=lons[count];
+    }
+
+    return c;
+  }
+
+  /**
+   * Calculates the minimum distance between the point p and the polyline defined by the
+   * given points. The result is identical to calling CalculateDistancePointToLineSegment()
+   * for each segment and taking the minimum.
+   *
+   * @param p
+   *    The point in distance to the polyline
+   * @param nodes
+   *    The points of the polyline
+   * @param segment
+   *    Index of the start point of the closest segment
+   * @param intersection
+   *    The point on the closest segment that is closest to 'p'
+   * @return
+   *    The distance or infinity, if there is no segment with a length greater than 0
+   */
+  double CalculateDistancePointToLineSegments(const GeoCoord& p,
+                                              const PackedPointArray& nodes,
+                                              size_t& segment,
+                                              GeoCoord& intersection)
+  {
+    double minDistance=std::numeric_limits<double>::infinity();
+
+    if (nodes.size()<2) {
+      return minDistance;
+    }
+
+    double lats[CHUNK_SIZE+1];
+    double lons[CHUNK_SIZE+1];
+    double pLat=p.GetLat();
+    double pLon=p.GetLon();
+
+    ConvertPackedCoords(nodes,0,1,lats,lons);
+
+    for (size_t offset=1; offset<nodes.size(); offset+=CHUNK_SIZE) {
+      size_t count=std::min(CHUNK_SIZE,nodes.size()-offset);
+
+      ConvertPackedCoords(nodes,offset,count,lats+1,lons+1);
+
+      for (size_t i=1; i<=count; i++) {
+        double xdelta=lons[i]-lons[i-1];
+        double ydelta=lats[i]-lats[i-1];
+
+        if (xdelta==0 && ydelta==0) {
+          continue;
+        }
+
+        double u=((pLon-lons[i-1])*xdelta+(pLat-lats[i-1])*ydelta)/(xdelta*xdelta+ydelta*ydelta);
+        double cx,cy;
+
+        if (u<0) {
+          cx=lons[i-1];
+          cy=lats[i-1];
+        }
+        else if (u>1) {
+          cx=lons[i];
+          cy=lats[i];
+        }
+        else {
+          cx=lons[i-1]+u*xdelta;
+          cy=lats[i-1]+u*ydelta;
+        }
+
+        double dx=cx-pLon;
+        double dy=cy-pLat;
+        double distance=sqrt(dx*dx+dy*dy);
+
+        if (distance<minDistance) {
+          minDistance=distance;
+          segment=offset+i-2;
+          intersection.Set(cy,cx);
+        }
+      }
+
+      lats[0]=lats[count];
+      lons[0]=lons[count];
+    }
+
+    return minDistance;
+  }
+}
@@ -0,0 +1,411 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/PointArrayView.h>
+
+#include <algorithm>
+
+#include <osmscout/util/CoordinateDecoding.h>
+
+namespace osmscout {
+
+  static inline void DecodeFirstCoord(const uint8_t* data,
+                                      uint32_t& latValue,
+                                      uint32_t& lonValue)
+  {
+    latValue=  ((uint32_t) data[0] <<  0)
+             | ((uint32_t) data[1] <<  8)
+             | ((uint32_t) data[2] << 16)
+             | ((uint32_t) (data[6] & 0x0f) << 24);
+
+    lonValue=  ((uint32_t) data[3] <<  0)
+             | ((uint32_t) data[4] <<  8)
+             | ((uint32_t) data[5] << 16)
+             | ((uint32_t) (data[6] & 0xf0) << 20);
+  }
+
+  /**
+   * Decode one signed, little endian encoded delta value of the given byte size
+   */
+  static inline int32_t DecodeDeltaValue(const uint8_t* data,
+                                         uint8_t bytes)
+  {
+    if (bytes==1) {
+      return (int8_t)data[0];
+    }
+
+    if (bytes==2) {
+      uint32_t value=data[0] | (data[1] << 8);
+
+      if (value & 0x8000) {
+        return (int32_t)(value | 0xffff0000);
+      }
+
+      return (int32_t)value;
+    }
+
+    uint32_t value=data[0] | (data[1] << 8) | (data[2] << 16);
+
+    if (value & 0x800000) {
+      return (int32_t)(value | 0xff000000);
+    }
+
+    return (int32_t)value;
+  }
+
+  PointArrayView::CoordIterator::CoordIterator(const PointArrayView& view,
+                                               size_t index)
+  : current(view.coordData),
+    index(index),
+    count(view.nodeCount),
+    deltaBytes(view.deltaBytes),
+    latValue(0),
+    lonValue(0)
+  {
+    if (index==0 && count>0) {
+      DecodeFirstCoord(current,
+                       latValue,
+                       lonValue);
+
+      current+=coordByteSize;
+    }
+  }
+
+  void PointArrayView::CoordIterator::DecodeDelta()
+  {
+    latValue+=DecodeDeltaValue(current,deltaBytes);
+    lonValue+=DecodeDeltaValue(current+deltaBytes,deltaBytes);
+
+    current+=2*deltaBytes;
+  }
+
+  PointArrayView::PointArrayView()
+  : coordData(nullptr),
+    serialData(nullptr),
+    nodeCount(0),
+    deltaBytes(1)
+  {
+    // no code
+  }
+
+  /**
+   * Return the first coordinate. The view must not be empty.
+   */
+  GeoCoord PointArrayView::GetFrontCoord() const
+  {
+    return *begin();
+  }
+
+  /**
+   * Decode all coordinates into the given buffer, which must have
+   * room for at least GetSize() entries.
+   */
+  void PointArrayView::DecodeCoords(GeoCoord* coords) const
+  {
+    if (nodeCount==0) {
+      return;
+    }
+
+    uint32_t       latValue;
+    uint32_t       lonValue;
+    const uint8_t* current=coordData+coordByteSize;
+
+    DecodeFirstCoord(coordData,
+                     latValue,
+                     lonValue);
+
+    coords[0].Set(latValue/latConversionFactor-90.0,
+                  lonValue/lonConversionFactor-180.0);
+
+    for (size_t i=1; i<nodeCount; i++) {
+      latValue+=DecodeDeltaValue(current,deltaBytes);
+      lonValue+=DecodeDeltaValue(current+deltaBytes,deltaBytes);
+
+      current+=2*deltaBytes;
+
+      coords[i].Set(latValue/latConversionFactor-90.0,
+                    lonValue/lonConversionFactor-180.0);
+    }
+  }
+
+  /**
+   * Decode all coordinates into the given vector. The vector is resized,
+   * so reusing the same vector for multiple views does not allocate memory
+   * once it has reached its maximum size.
+   */
+  void PointArrayView::GetCoords(std::vector<GeoCoord>& coords) const
+  {
+    coords.resize(nodeCount);
+
+    if (nodeCount>0) {
+      DecodeCoords(coords.data());
+    }
+  }
+
+  /**
+   * Decode all coordinates and serials into the given vector, resulting in the
+   * same points as FileScanner::Read(std::vector<Point>&,bool).
+   */
+  void PointArrayView::GetPoints(std::vector<Point>& points) const
+  {
+    points.resize(nodeCount);
+
+    size_t idx=0;
+
+    for (const auto coord : *this) {
+      points[idx].Set(0,coord);
+      idx++;
+    }
+
+    if (serialData==nullptr) {
+      return;
+    }
+
+    const uint8_t* current=serialData;
+    size_t         idCurrent=0;
+
+    while (idCurrent<nodeCount) {
+      uint8_t bitset=*current;
+      size_t  bitmask=1;
+
+      current++;
+
+      for (size_t i=0; i<8 && idCurrent<nodeCount; i++) {
+        if (bitset & bitmask) {
+          points[idCurrent].SetSerial(*current);
+          current++;
+        }
+
+        bitmask*=2;
+        idCurrent++;
+      }
+    }
+  }
+
+  /**
+   * Decode all coordinates and serials into the given packed array. Deltas are
+   * summed up directly into the fixed point arrays, without converting
+   * coordinates to degrees.
+   */
+  void PointArrayView::GetPackedPoints(PackedPointArray& points) const
+  {
+    points.Resize(nodeCount);
+
+    if (nodeCount==0) {
+      return;
+    }
+
+    uint32_t* latValues=reinterpret_cast<uint32_t*>(points.GetLatValues());
+    uint32_t* lonValues=reinterpret_cast<uint32_t*>(points.GetLonValues());
+
+    DecodeFirstCoord(coordData,
+                     latValues[0],
+                     lonValues[0]);
+
+    DecodeCoordinateDeltas(coordData+coordByteSize,
+                           deltaBytes,
+                           nodeCount-1,
+                           latValues[0],
+                           lonValues[0],
+                           latValues+1,
+                           lonValues+1);
+
+    if (serialData==nullptr) {
+      return;
+    }
+
+    const uint8_t* current=serialData;
+    size_t         idCurrent=0;
+
+    while (idCurrent<nodeCount) {
+      uint8_t bitset=*current;
+      size_t  bitmask=1;
+
+      current++;
+
+      for (size_t i=0; i<8 && idCurrent<nodeCount; i++) {
+        if (bitset & bitmask) {
+          points.SetSerial(idCurrent,*current);
+          current++;
+        }
+
+        bitmask*=2;
+        idCurrent++;
+      }
+    }
+  }
+
+  /**
+   * Return the bounding box of all coordinates. Minimum and maximum are
+   * calculated on the fixed point values, so coordinates are only converted to
+   * degrees once for the result.
+   */
+  GeoBox PointArrayView::GetBoundingBox() const
+  {
+    if (nodeCount==0) {
+      return GeoBox();
+    }
+
+    uint32_t latValue;
+    uint32_t lonValue;
+
+    DecodeFirstCoord(coordData,
+                     latValue,
+                     lonValue);
+
+    uint32_t       minLat=latValue;
+    uint32_t       maxLat=latValue;
+    uint32_t       minLon=lonValue;
+    uint32_t       maxLon=lonValue;
+    const uint8_t* current=coordData+coordByteSize;
+
+    for (size_t i=1; i<nodeCount; i++) {
+      latValue+=DecodeDeltaValue(current,deltaBytes);
+      lonValue+=DecodeDeltaValue(current+deltaBytes,deltaBytes);
+
+      current+=2*deltaBytes;
+
+      minLat=std::min(minLat,latValue);
+      maxLat=std::max(maxLat,latValue);
+      minLon=std::min(minLon,lonValue);
+      maxLon=std::max(maxLon,lonValue);
+    }
+
+    return GeoBox(GeoCoord(minLat/latConversionFactor-90.0,
+                           minLon/lonConversionFactor-180.0),
+                  GeoCoord(maxLat/latConversionFactor-90.0,
+                           maxLon/lonConversionFactor-180.0));
+  }
+
+  /**
+   * Initialize the view from the current position of the given, memory mapped FileScanner.
+   * The header of the point array is parsed and the scanner is positioned after the
+   * point array, coordinates are not decoded.
+   *
+   * @throws IOException if the FileScanner is not memory mapped or on read errors
+   */
+  void PointArrayView::Read(FileScanner& scanner,
+                            bool readIds)
+  {
+    uint8_t sizeByte;
+    size_t  coordBitSize;
+    bool    hasNodes;
+    size_t  count;
+
+    coordData=nullptr;
+    serialData=nullptr;
+    nodeCount=0;
+
+    scanner.Read(sizeByte);
+
+    if (sizeByte==0) {
+      return;
+    }
+
+    if ((sizeByte & 0x03) == 0) {
+      coordBitSize=16;
+    }
+    else if ((sizeByte & 0x03) == 1) {
+      coordBitSize=32;
+    }
+    else {
+      coordBitSize=48;
+    }
+
+    if (readIds) {
+      hasNodes=(sizeByte & 0x04)!=0;
+      count=(sizeByte & 0x78) >> 3;
+
+      if ((sizeByte & 0x80) != 0) {
+        scanner.Read(sizeByte);
+
+        count|=(sizeByte & 0x7f) << 4;
+
+        if ((sizeByte & 0x80) != 0) {
+          scanner.Read(sizeByte);
+
+          count|=(sizeByte & 0x7f) << 11;
+
+          if ((sizeByte & 0x80) != 0) {
+            scanner.Read(sizeByte);
+
+            count|=sizeByte << 18;
+          }
+        }
+      }
+    }
+    else {
+      hasNodes=false;
+      count=(sizeByte & 0x7c) >> 2;
+
+      if ((sizeByte & 0x80) != 0) {
+        scanner.Read(sizeByte);
+
+        count|=(sizeByte & 0x7f) << 5;
+
+        if ((sizeByte & 0x80) != 0) {
+          scanner.Read(sizeByte);
+
+          count|=(sizeByte & 0x7f) << 12;
+
+          if ((sizeByte & 0x80) != 0) {
+            scanner.Read(sizeByte);
+
+            count|=sizeByte << 19;
+          }
+        }
+      }
+    }
+
+    if (count==0) {
+      return;
+    }
+
+    size_t coordBytes=coordByteSize+(count-1)*coordBitSize/8;
+
+    coordData=reinterpret_cast<const uint8_t*>(scanner.ReadMappedData(coordBytes));
+    nodeCount=(uint32_t)count;
+    deltaBytes=(uint8_t)(coordBitSize/16);
+
+    if (hasNodes) {
+      FileOffset serialOffset=scanner.GetPos();
+      size_t     idCurrent=0;
+
+      while (idCurrent<count) {
+        uint8_t bitset;
+        size_t  serialCount=0;
+
+        scanner.Read(bitset);
+
+        for (size_t i=0; i<8 && idCurrent<count; i++) {
+          if (bitset & (1u << i)) {
+            serialCount++;
+          }
+
+          idCurrent++;
+        }
+
+        scanner.ReadMappedData(serialCount);
+      }
+
+      serialData=reinterpret_cast<const uint8_t*>(scanner.GetMappedData(serialOffset,
+                                                                        scanner.GetPos()-serialOffset));
+    }
+  }
+}
@@ -20,6 +20,7 @@
 #include <osmscout/TypeConfig.h>
 
 #include <algorithm>
+#include <memory>
 
 #include <osmscout/TypeFeatures.h>
 
@@ -525,6 +526,123 @@ namespace osmscout {
     }
   }
 
+  /**
+   * Skip the values of all features set in the given feature bits, without storing them.
+   *
+   * @throws IOException
+   */
+  static void SkipFeatureValues(const TypeInfo& type,
+                                const uint8_t* featureBits,
+                                FileScanner& scanner)
+  {
+    // Most feature values are small, so we try to avoid allocating memory for them
+    alignas(std::max_align_t) char localBuffer[256];
+    std::unique_ptr<char[]>        heapBuffer;
+
+    for (const auto &feature : type.GetFeatures()) {
+      size_t featureBit=feature.GetFeatureBit();
+
+      if ((featureBits[featureBit/8] & (1u << featureBit%8))==0 ||
+          !feature.GetFeature()->HasValue()) {
+        continue;
+      }
+
+      void* buffer=localBuffer;
+
+      if (feature.GetFeature()->GetValueSize()>sizeof(localBuffer)) {
+        heapBuffer.reset(new char[feature.GetFeature()->GetValueSize()]);
+        buffer=heapBuffer.get();
+      }
+
+      FeatureValue* value=feature.GetFeature()->AllocateValue(buffer);
+
+      try {
+        value->Read(scanner);
+      }
+      catch (IOException& e) {
+        value->~FeatureValue();
+        throw;
+      }
+
+      value->~FeatureValue();
+    }
+  }
+
+  /**
+   * Skips a FeatureValueBuffer of the given type as written by Write(FileWriter&)
+   * without allocating the buffer or its values.
+   *
+   * @throws IOException
+   */
+  void FeatureValueBuffer::Skip(const TypeInfoRef& type,
+                                FileScanner& scanner)
+  {
+    uint8_t featureBits[16];
+
+    if (type->GetFeatureMaskBytes()>sizeof(featureBits)) {
+      FeatureValueBuffer buffer;
+
+      buffer.SetType(type);
+      buffer.Read(scanner);
+
+      return;
+    }
+
+    for (size_t i=0; i<type->GetFeatureMaskBytes(); i++) {
+      scanner.Read(featureBits[i]);
+    }
+
+    SkipFeatureValues(*type,
+                      featureBits,
+                      scanner);
+  }
+
+  /**
+   * Skips a FeatureValueBuffer of the given type as written by Write(FileWriter&,bool,bool)
+   * without allocating the buffer or its values. The special flags are returned.
+   *
+   * @throws IOException
+   */
+  void FeatureValueBuffer::Skip(const TypeInfoRef& type,
+                                FileScanner& scanner,
+                                bool& specialFlag1,
+                                bool& specialFlag2)
+  {
+    uint8_t featureBits[16];
+
+    if (type->GetFeatureMaskBytes()>sizeof(featureBits)) {
+      FeatureValueBuffer buffer;
+
+      buffer.SetType(type);
+      buffer.Read(scanner,
+                  specialFlag1,
+                  specialFlag2);
+
+      return;
+    }
+
+    for (size_t i=0; i<type->GetFeatureMaskBytes(); i++) {
+      scanner.Read(featureBits[i]);
+    }
+
+    if (BitsToBytes(type->GetFeatureCount())==BitsToBytes(type->GetFeatureCount()+2)) {
+      specialFlag1=(featureBits[type->GetFeatureMaskBytes()-1] & 0x80)!=0;
+      specialFlag2=(featureBits[type->GetFeatureMaskBytes()-1] & 0x40)!=0;
+    }
+    else {
+      uint8_t addByte;
+
+      scanner.Read(addByte);
+
+      specialFlag1=(addByte & 0x80)!=0;
+      specialFlag2=(addByte & 0x40)!=0;
+    }
+
+    SkipFeatureValues(*type,
+                      featureBits,
+                      scanner);
+  }
+
   /**
    * Writes the FeatureValueBuffer to the given FileWriter.
    *
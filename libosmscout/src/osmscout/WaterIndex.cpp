@@ -41,12 +41,14 @@ namespace osmscout {
     Close();
   }
 
-  bool WaterIndex::Open(const std::string& path, bool memoryMappedData)
+  bool WaterIndex::Open(const std::string& path,
+                        bool memoryMappedData,
+                        const MmapPolicy& mmapPolicy)
   {
     datafilename=AppendFileToDir(path,WATER_IDX);
 
     try {
-      scanner.Open(datafilename,FileScanner::FastRandom,memoryMappedData);
+      scanner.Open(datafilename,FileScanner::FastRandom,memoryMappedData,mmapPolicy);
 
       scanner.ReadNumber(waterIndexMinMag);
       scanner.ReadNumber(waterIndexMaxMag);
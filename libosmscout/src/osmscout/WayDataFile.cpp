@@ -21,12 +21,75 @@
 
 namespace osmscout {
 
+  /**
+   * Accounts the memory of a way including its node array
+   */
+  class WayValueSizer : public DataFile<Way>::ValueSizer
+  {
+  public:
+    size_t GetSize(const WayRef& value) const override
+    {
+      return sizeof(Way)+
+             value->nodes.capacity()*sizeof(Point);
+    }
+  };
+
+  static const WayValueSizer wayValueSizer;
+
   const char* WayDataFile::WAYS_DAT="ways.dat";
   const char* WayDataFile::WAYS_IDMAP="ways.idmap";
 
-  WayDataFile::WayDataFile(size_t cacheSize)
-  : DataFile<Way>(WAYS_DAT,cacheSize)
+  WayDataFile::WayDataFile(size_t cacheSize,
+                           size_t cacheMemory)
+  : DataFile<Way>(WAYS_DAT,
+                  cacheSize,
+                  cacheMemory,
+                  &wayValueSizer)
   {
     // no code
   }
+
+  /**
+   * Read the bounding box of the way at the current position via a WayView
+   */
+  bool WayDataFile::ReadBoundingBox(FileScanner& scanner,
+                                    GeoBox& boundingBox) const
+  {
+    WayView view;
+
+    view.Read(*typeConfig,
+              scanner);
+
+    boundingBox=view.GetBoundingBox();
+
+    return true;
+  }
+
+  /**
+   * Decode the features of the given view (read from this data file) into the given
+   * buffer. The buffer can be reused for multiple views, so decoding does not
+   * allocate memory for most ways.
+   *
+   * Method is thread-safe.
+   */
+  bool WayDataFile::GetFeatures(const WayView& view,
+                                FeatureValueBuffer& buffer) const
+  {
+    ScannerLease scanner(*this);
+
+    if (!scanner.IsValid()) {
+      return false;
+    }
+
+    try {
+      view.ReadFeatures(*scanner,
+                        buffer);
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      return false;
+    }
+
+    return true;
+  }
 }
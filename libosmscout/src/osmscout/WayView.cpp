@@ -0,0 +1,76 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/WayView.h>
+
+namespace osmscout {
+
+  WayView::WayView()
+  : fileOffset(0),
+    nextFileOffset(0),
+    featureOffset(0)
+  {
+    // no code
+  }
+
+  /**
+   * Decode the features of the way into the given buffer, using the given scanner
+   * (which must be opened on the file the view was read from).
+   *
+   * @throws IOException
+   */
+  void WayView::ReadFeatures(FileScanner& scanner,
+                             FeatureValueBuffer& buffer) const
+  {
+    scanner.SetPos(featureOffset);
+
+    buffer.SetType(type);
+    buffer.Read(scanner);
+  }
+
+  /**
+   * Read the view from the given, memory mapped FileScanner. The scanner is
+   * positioned after the way afterwards.
+   *
+   * @throws IOException
+   */
+  void WayView::Read(const TypeConfig& typeConfig,
+                     FileScanner& scanner)
+  {
+    TypeId typeId;
+
+    fileOffset=scanner.GetPos();
+
+    scanner.ReadTypeId(typeId,
+                       typeConfig.GetWayTypeIdBytes());
+
+    type=typeConfig.GetWayTypeInfo(typeId);
+
+    featureOffset=scanner.GetPos();
+
+    FeatureValueBuffer::Skip(type,
+                             scanner);
+
+    nodes.Read(scanner,
+               type->CanRoute() ||
+               type->GetOptimizeLowZoom());
+
+    nextFileOffset=scanner.GetPos();
+  }
+}
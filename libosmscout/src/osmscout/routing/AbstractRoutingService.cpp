@@ -19,6 +19,9 @@
 */
 
 #include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
 
 #include <osmscout/routing/RoutingService.h>
 #include <osmscout/routing/RoutingProfile.h>
@@ -56,12 +59,12 @@ namespace osmscout {
                                                                      const ClosedSet& closedRestrictedSet,
                                                                      std::list<VNode>& nodes)
   {
-    bool restricted=false;
-    auto current=closedSet.find(VNode(finalRouteNode));
+    bool         restricted=false;
+    const VNode* current=closedSet.Find(finalRouteNode);
 
-    if (current==closedSet.end()){
-      current=closedRestrictedSet.find(VNode(finalRouteNode));
-      assert(current!=closedSet.end());
+    if (current==nullptr){
+      current=closedRestrictedSet.Find(finalRouteNode);
+      assert(current!=nullptr);
       restricted=true;
     }
 
@@ -69,19 +72,19 @@ namespace osmscout {
 #if defined(DEBUG_ROUTING)
       std::cout << "Chain item " << current->currentNode << " -> " << current->previousNode << std::endl;
 #endif
-      ClosedSet::const_iterator prev;
+      const VNode* prev;
       if (!restricted){
-        prev=closedSet.find(VNode(current->previousNode));
-        if (prev==closedSet.end()){
-          prev=closedRestrictedSet.find(VNode(current->previousNode));
-          assert(prev!=closedRestrictedSet.end());
+        prev=closedSet.Find(current->previousNode);
+        if (prev==nullptr){
+          prev=closedRestrictedSet.Find(current->previousNode);
+          assert(prev!=nullptr);
           restricted=true;
         }
       }else{
-        prev=closedRestrictedSet.find(VNode(current->previousNode));
-        if (prev==closedRestrictedSet.end()){
-          prev=closedSet.find(VNode(current->previousNode));
-          assert(prev!=closedSet.end());
+        prev=closedRestrictedSet.Find(current->previousNode);
+        if (prev==nullptr){
+          prev=closedSet.Find(current->previousNode);
+          assert(prev!=nullptr);
           restricted=false;
         }
       }
@@ -220,6 +223,42 @@ namespace osmscout {
     }
   }
 
+  /**
+   * Return the estimated costs from the given route node to the target. These are
+   * the costs for the spherical distance to the target coordinate or - if larger -
+   * the lower bound for the costs to the nearest target route node (costBounds.targets)
+   * as returned by GetRouteCostBound().
+   */
+  template <class RoutingState>
+  double AbstractRoutingService<RoutingState>::GetTargetEstimateCosts(const RoutingState& state,
+                                                                      const DBId& id,
+                                                                      const GeoCoord& coord,
+                                                                      const GeoCoord& targetCoord,
+                                                                      const RouteCostBounds& costBounds)
+  {
+    double estimate=GetEstimateCosts(state,
+                                     id.database,
+                                     GetSphericalDistance(coord,
+                                                          targetCoord));
+
+    if (costBounds.targets.empty()) {
+      return estimate;
+    }
+
+    double bound=std::numeric_limits<double>::max();
+
+    for (const auto& target : costBounds.targets) {
+      bound=std::min(bound,
+                     GetRouteCostBound(state,
+                                       costBounds,
+                                       id,
+                                       target));
+    }
+
+    return std::max(estimate,
+                    bound);
+  }
+
   template <class RoutingState>
   bool AbstractRoutingService<RoutingState>::GetRNode(const RoutingState& state,
                                                       const RoutePosition& position,
@@ -228,6 +267,7 @@ namespace osmscout {
                                                       const RouteNodeRef& routeNode,
                                                       const GeoCoord& startCoord,
                                                       const GeoCoord& targetCoord,
+                                                      const RouteCostBounds& costBounds,
                                                       RNodeRef& node)
   {
     node=std::make_shared<RNode>(DBId(position.GetDatabaseId(),routeNode->GetId()),
@@ -239,10 +279,11 @@ namespace osmscout {
                                way,
                                GetSphericalDistance(startCoord,
                                                     way->nodes[routeNodeIndex].GetCoord()));
-    node->estimateCost=GetEstimateCosts(state,
-                                        position.GetDatabaseId(),
-                                        GetSphericalDistance(way->nodes[routeNodeIndex].GetCoord(),
-                                                             targetCoord));
+    node->estimateCost=GetTargetEstimateCosts(state,
+                                              node->id,
+                                              way->nodes[routeNodeIndex].GetCoord(),
+                                              targetCoord,
+                                              costBounds);
 
     node->overallCost=node->currentCost+node->estimateCost;
 
@@ -262,6 +303,8 @@ namespace osmscout {
    *    The coordinate of the start position
    * @param targetCoord
    *    The coordinate of the target position
+   * @param costBounds
+   *    Target route nodes and bounds for the estimate (see GetTargetEstimateCosts())
    * @param forwardRouteNode
    *    Optional route node in the forward direction
    * @param backwardRouteNode
@@ -278,6 +321,7 @@ namespace osmscout {
                                                               const RoutePosition& position,
                                                               GeoCoord& startCoord,
                                                               const GeoCoord& targetCoord,
+                                                              const RouteCostBounds& costBounds,
                                                               RouteNodeRef& forwardRouteNode,
                                                               RouteNodeRef& backwardRouteNode,
                                                               RNodeRef& forwardRNode,
@@ -341,6 +385,7 @@ namespace osmscout {
                   forwardRouteNode,
                   startCoord,
                   targetCoord,
+                  costBounds,
                   forwardRNode)) {
       return false;
     }
@@ -353,6 +398,7 @@ namespace osmscout {
                   backwardRouteNode,
                   startCoord,
                   targetCoord,
+                  costBounds,
                   backwardRNode)) {
       return false;
     }
@@ -373,6 +419,8 @@ namespace osmscout {
    *    The coordinate of the start position
    * @param targetCoord
    *    The coordinate of the target position
+   * @param costBounds
+   *    Target route nodes and bounds for the estimate (see GetTargetEstimateCosts())
    * @param forwardRouteNode
    *    Optional route node in the forward direction
    * @param backwardRouteNode
@@ -389,6 +437,7 @@ namespace osmscout {
                                                            const RoutePosition& position,
                                                            GeoCoord& startCoord,
                                                            const GeoCoord& targetCoord,
+                                                           const RouteCostBounds& costBounds,
                                                            RouteNodeRef& forwardRouteNode,
                                                            RouteNodeRef& backwardRouteNode,
                                                            RNodeRef& forwardRNode,
@@ -399,6 +448,7 @@ namespace osmscout {
                               position,
                               startCoord,
                               targetCoord,
+                              costBounds,
                               forwardRouteNode,
                               backwardRouteNode,
                               forwardRNode,
@@ -521,7 +571,7 @@ namespace osmscout {
 
   template <class RoutingState>
   bool AbstractRoutingService<RoutingState>::WalkToOtherDatabases(const RoutingState& state,
-                                                                  RNodeRef &current,
+                                                                  RNode &current,
                                                                   RouteNodeRef &currentRouteNode,
                                                                   OpenList &openList,
                                                                   OpenMap &openMap,
@@ -530,38 +580,38 @@ namespace osmscout {
   {
     // add twin nodes to nextNode from other databases to open list
     std::vector<DBId> twins=GetNodeTwins(state,
-                                         current->id.database,
+                                         current.id.database,
                                          currentRouteNode->GetId());
     for (const auto& twin : twins) {
-      if ((current->access &&
-           closedSet.find(VNode(twin))!=closedSet.end()) ||
-          (!current->access &&
-            closedRestrictedSet.find(VNode(twin))!=closedRestrictedSet.end())){
+      if ((current.access &&
+           closedSet.Contains(twin)) ||
+          (!current.access &&
+            closedRestrictedSet.Contains(twin))){
 #if defined(DEBUG_ROUTING)
         std::cout << "Twin node " << twin << " is closed already, ignore it" << std::endl;
 #endif
         continue;
       }
 
-      auto twinIt=openMap.find(twin);
+      RNode** twinEntry=openMap.Find(twin);
 
-      if (twinIt!=openMap.end()){
-        RNodeRef rn=(*twinIt->second);
-        if (rn->currentCost > current->currentCost) {
+      if (twinEntry!=nullptr &&
+          openList.Contains(*twinEntry)){
+        RNode* rn=*twinEntry;
+        if (rn->currentCost > current.currentCost) {
           // this is cheaper path to twin
 
-          rn->prev=current->id;
+          rn->prev=current.id;
           //rn->object=node->objects.begin()->object, /*TODO: how to find correct way from other DB?*/
 
-          rn->currentCost=current->currentCost;
-          rn->estimateCost=current->estimateCost;
-          rn->overallCost=current->overallCost;
-          rn->access=current->access;
+          rn->currentCost=current.currentCost;
+          rn->estimateCost=current.estimateCost;
+          rn->overallCost=current.overallCost;
+          rn->distance=current.distance;
+          rn->time=current.time;
+          rn->access=current.access;
 
-          openList.erase(twinIt->second);
-
-          std::pair<OpenListRef,bool> insertResult=openList.insert(rn);
-          twinIt->second=insertResult.first;
+          openList.Update(rn);
 
 #if defined(DEBUG_ROUTING)
           std::cout << "Better transition from " << rn->prev << " to " << rn->id << std::endl;
@@ -573,22 +623,23 @@ namespace osmscout {
         if (!GetRouteNode(twin,node)){
           return false;
         }
-        RNodeRef rn=std::make_shared<RNode>(twin,
-                                            node,
-                                            //node->objects.begin()->object, /*TODO: how to find correct way from other DB?*/
-                                            ObjectFileRef(), // TODO: have to be valid Object here?
-                                            /*prev*/current->id);
+        RNode rn(twin,
+                 node,
+                 //node->objects.begin()->object, /*TODO: how to find correct way from other DB?*/
+                 ObjectFileRef(), // TODO: have to be valid Object here?
+                 /*prev*/current.id);
 
-        rn->currentCost=current->currentCost;
-        rn->estimateCost=current->estimateCost;
-        rn->overallCost=current->overallCost;
-        rn->access=current->access;
+        rn.currentCost=current.currentCost;
+        rn.estimateCost=current.estimateCost;
+        rn.overallCost=current.overallCost;
+        rn.distance=current.distance;
+        rn.time=current.time;
+        rn.access=current.access;
 
-        std::pair<OpenListRef,bool> insertResult=openList.insert(rn);
-        openMap[rn->id]=insertResult.first;
+        openMap[rn.id]=openList.Insert(rn);
 
 #if defined(DEBUG_ROUTING)
-        std::cout << "Transition from " << rn->prev << " to " << rn->id << std::endl;
+        std::cout << "Transition from " << rn.prev << " to " << rn.id << std::endl;
 #endif
       }
     }
@@ -597,7 +648,7 @@ namespace osmscout {
 
   template <class RoutingState>
   bool AbstractRoutingService<RoutingState>::WalkPaths(const RoutingState &state,
-                                                       RNodeRef &current,
+                                                       RNode &current,
                                                        RouteNodeRef &currentRouteNode,
                                                        OpenList &openList,
                                                        OpenMap &openMap,
@@ -606,16 +657,17 @@ namespace osmscout {
                                                        RoutingResult &result,
                                                        const RoutingParameter& parameter,
                                                        const GeoCoord &targetCoord,
+                                                       const RouteCostBounds& costBounds,
                                                        const Vehicle &vehicle,
                                                        size_t &nodesIgnoredCount,
                                                        Distance &currentMaxDistance,
                                                        const Distance &overallDistance,
                                                        const double &costLimit)
   {
-    DatabaseId dbId=current->id.database;
+    DatabaseId dbId=current.id.database;
     size_t i=0;
     for (const auto& path : currentRouteNode->paths) {
-      if (path.id==current->prev.id) {
+      if (path.id==current.prev.id) {
 #if defined(DEBUG_ROUTING)
         std::cout << "  Skipping route";
         std::cout << " to " << path.id;
@@ -628,7 +680,7 @@ namespace osmscout {
         continue;
       }
 
-      if (!current->access &&
+      if (!current.access &&
           !path.IsRestricted(vehicle)) {
 #if defined(DEBUG_ROUTING)
         std::cout << "  Skipping route";
@@ -657,10 +709,10 @@ namespace osmscout {
         continue;
       }
 
-      if ((current->access &&
-           closedSet.find(VNode(DBId(dbId,path.id)))!=closedSet.end()) ||
-          (!current->access &&
-           closedRestrictedSet.find(VNode(DBId(dbId,path.id)))!=closedRestrictedSet.end())) {
+      if ((current.access &&
+           closedSet.Contains(DBId(dbId,path.id))) ||
+          (!current.access &&
+           closedRestrictedSet.Contains(DBId(dbId,path.id)))) {
 #if defined(DEBUG_ROUTING)
         std::cout << "  Skipping route";
         std::cout << " to " << dbId << " / " << path.id;
@@ -672,45 +724,40 @@ namespace osmscout {
         continue;
       }
 
-      if (!currentRouteNode->excludes.empty()) {
-        bool canTurnedInto=true;
-
-        for (const auto& exclude : currentRouteNode->excludes) {
-          if (exclude.source==current->object &&
-              currentRouteNode->objects[exclude.targetIndex].object==currentRouteNode->objects[path.objectIndex].object) {
+      if (!currentRouteNode->CanTurn(current.object,
+                                     currentRouteNode->objects[path.objectIndex].object)) {
 #if defined(DEBUG_ROUTING)
-            std::cout << "  Skipping route";
-            std::cout << " to " << dbId << " / " << path.id;
-            std::cout << " (" << currentRouteNode->objects[path.objectIndex].object.GetName() << ")";
-            std::cout << " => turn not allowed" << std::endl;
+        std::cout << "  Skipping route";
+        std::cout << " to " << dbId << " / " << path.id;
+        std::cout << " (" << currentRouteNode->objects[path.objectIndex].object.GetName() << ")";
+        std::cout << " => turn not allowed" << std::endl;
 #endif
-            canTurnedInto=false;
-            break;
-          }
-        }
-
-        if (!canTurnedInto) {
-          nodesIgnoredCount++;
-          i++;
+        nodesIgnoredCount++;
+        i++;
 
-          continue;
-        }
+        continue;
       }
 
-      double currentCost=current->currentCost+GetCosts(state,dbId,*currentRouteNode,i);
+      double currentCost=current.currentCost+GetCosts(state,dbId,*currentRouteNode,i);
 
-      auto openEntry=openMap.find(DBId(current->id.database,
-                                       path.id));
+      RNode** openMapEntry=openMap.Find(DBId(current.id.database,
+                                             path.id));
+      RNode*  openEntry=nullptr;
+
+      if (openMapEntry!=nullptr &&
+          openList.Contains(*openMapEntry)) {
+        openEntry=*openMapEntry;
+      }
 
       // Check, if we already have a cheaper path to the new node. If yes, do not put the new path
       // into the open list
-      if (openEntry!=openMap.end() &&
-          (*openEntry->second)->currentCost<=currentCost) {
+      if (openEntry!=nullptr &&
+          openEntry->currentCost<=currentCost) {
 #if defined(DEBUG_ROUTING)
         std::cout << "  Skipping route";
         std::cout << " to " << dbId << " / " << path.id;
         std::cout << " (" << currentRouteNode->objects[path.objectIndex].object.GetName() << ")";
-        std::cout << " => cheaper route exists " << currentCost << "<=>" << (*openEntry->second)->object.GetName() << " " << (*openEntry->second)->node->GetId() << " " << (*openEntry->second)->currentCost << std::endl;
+        std::cout << " => cheaper route exists " << currentCost << "<=>" << openEntry->object.GetName() << " " << openEntry->node->GetId() << " " << openEntry->currentCost << std::endl;
 #endif
         i++;
 
@@ -719,10 +766,10 @@ namespace osmscout {
 
       RouteNodeRef nextNode;
 
-      if (openEntry!=openMap.end()) {
-        nextNode=(*openEntry->second)->node;
+      if (openEntry!=nullptr) {
+        nextNode=openEntry->node;
       }
-      else if (!GetRouteNode(DBId(current->id.database,
+      else if (!GetRouteNode(DBId(current.id.database,
                                   path.id),
                              nextNode)) {
         log.Error() << "Cannot load route node with id " << path.id;
@@ -735,8 +782,14 @@ namespace osmscout {
       currentMaxDistance=Distance::Max(currentMaxDistance,overallDistance-distanceToTarget);
       result.SetCurrentMaxDistance(currentMaxDistance);
 
-      // Estimate costs for the rest of the distance to the target
-      double estimateCost=GetEstimateCosts(state,dbId,distanceToTarget);
+      // Estimate costs for the rest of the distance to the target, the estimate
+      // only depends on the node, so we can reuse it for nodes already open
+      double estimateCost=openEntry!=nullptr ? openEntry->estimateCost : GetTargetEstimateCosts(state,
+                                                                                               DBId(dbId,
+                                                                                                    path.id),
+                                                                                               nextNode->GetCoord(),
+                                                                                               targetCoord,
+                                                                                               costBounds);
       double overallCost=currentCost+estimateCost;
 
       if (overallCost>costLimit) {
@@ -759,10 +812,10 @@ namespace osmscout {
 
       // If we already have the node in the open list, but the new path is cheaper (as tested above),
       // update the existing entry
-      if (openEntry!=openMap.end()) {
-        RNodeRef node=*openEntry->second;
+      if (openEntry!=nullptr) {
+        RNode* node=openEntry;
 
-        node->prev=current->id;
+        node->prev=current.id;
         node->object=currentRouteNode->objects[path.objectIndex].object;
 
         node->currentCost=currentCost;
@@ -771,33 +824,29 @@ namespace osmscout {
         node->access=!currentRouteNode->paths[i].IsRestricted(vehicle);
 
 #if defined(DEBUG_ROUTING)
-        std::cout << "  Updating route " << current->id << " via " << node->object.GetTypeName() << " " << node->object.GetFileOffset() << " " << currentCost << " " << estimateCost << " " << overallCost << " " << currentRouteNode->GetId() << std::endl;
+        std::cout << "  Updating route " << current.id << " via " << node->object.GetTypeName() << " " << node->object.GetFileOffset() << " " << currentCost << " " << estimateCost << " " << overallCost << " " << currentRouteNode->GetId() << std::endl;
 #endif
 
-        openList.erase(openEntry->second);
-
-        std::pair<OpenListRef,bool> insertResult=openList.insert(node);
-        openEntry->second=insertResult.first;
+        openList.Update(node);
       }
       else {
-        RNodeRef node=std::make_shared<RNode>(DBId(dbId,path.id),
-                                              nextNode,
-                                              currentRouteNode->objects[path.objectIndex].object,
-                                              current->id);
+        RNode node(DBId(dbId,path.id),
+                   nextNode,
+                   currentRouteNode->objects[path.objectIndex].object,
+                   current.id);
 
-        node->currentCost=currentCost;
-        node->estimateCost=estimateCost;
-        node->overallCost=overallCost;
-        node->access=!path.IsRestricted(vehicle);
+        node.currentCost=currentCost;
+        node.estimateCost=estimateCost;
+        node.overallCost=overallCost;
+        node.access=!path.IsRestricted(vehicle);
 
 #if defined(DEBUG_ROUTING)
         std::cout << "  Inserting route to " << path.id;
-        std::cout <<  " (" << node->object.GetTypeName() << " " << node->object.GetFileOffset() << ")";
+        std::cout <<  " (" << node.object.GetTypeName() << " " << node.object.GetFileOffset() << ")";
         std::cout << " " << currentCost << " " << estimateCost << " " << overallCost << " " << currentRouteNode->GetId() << std::endl;
 #endif
 
-        std::pair<OpenListRef,bool> insertResult=openList.insert(node);
-        openMap[node->id]=insertResult.first;
+        openMap[node.id]=openList.Insert(node);
       }
 
       i++;
@@ -806,27 +855,474 @@ namespace osmscout {
     return true;
   }
 
+  /**
+   * Calculate a route using an A* search on the compact routing graph. The
+   * search follows the same rules as the search on the route nodes, but works
+   * on node indexes and fixed width edges without loading any RouteNode (only
+   * the route nodes next to start and target are loaded to find the entry
+   * points into the graph).
+   *
+   * Returns false, if the graph cannot be used for the given start and target,
+   * in this case the caller should fall back to the search on the route nodes.
+   */
+  template <class RoutingState>
+  bool AbstractRoutingService<RoutingState>::CalculateRouteOnGraph(RoutingState& state,
+                                                                   const RouteGraph& graph,
+                                                                   const RoutePosition& start,
+                                                                   const RoutePosition& target,
+                                                                   const RoutingParameter& parameter,
+                                                                   RouteSearch& search,
+                                                                   RoutingResult& result)
+  {
+    DatabaseId   dbId=start.GetDatabaseId();
+    Vehicle      vehicle=GetVehicle(state);
+    RouteNodeRef startForwardRouteNode;
+    RouteNodeRef startBackwardRouteNode;
+    RNodeRef     startForwardNode;
+    RNodeRef     startBackwardNode;
+    RouteNodeRef targetForwardRouteNode;
+    RouteNodeRef targetBackwardRouteNode;
+    GeoCoord     startCoord;
+    GeoCoord     targetCoord;
+    size_t       nodesLoadedCount=0;
+    size_t       nodesIgnoredCount=0;
+    size_t       maxOpenList=0;
+
+    search.costBounds.targets.clear();
+
+    if (!GetTargetNodes(state,
+                        target,
+                        targetCoord,
+                        targetForwardRouteNode,
+                        targetBackwardRouteNode)) {
+      return true;
+    }
+
+    if (parameter.GetUseLandmarks()) {
+      for (const auto& targetNode : {targetForwardRouteNode,targetBackwardRouteNode}) {
+        if (targetNode) {
+          search.costBounds.targets.push_back(DBId(dbId,
+                                                targetNode->GetId()));
+        }
+      }
+    }
+
+    if (!GetStartNodes(state,
+                       start,
+                       startCoord,
+                       targetCoord,
+                       search.costBounds,
+                       startForwardRouteNode,
+                       startBackwardRouteNode,
+                       startForwardNode,
+                       startBackwardNode)) {
+      return true;
+    }
+
+    uint32_t targetForward=targetForwardRouteNode ? graph.GetNodeIndex(targetForwardRouteNode->GetId()) : RouteGraph::NO_NODE;
+    uint32_t targetBackward=targetBackwardRouteNode ? graph.GetNodeIndex(targetBackwardRouteNode->GetId()) : RouteGraph::NO_NODE;
+
+    if ((targetForwardRouteNode && targetForward==RouteGraph::NO_NODE) ||
+        (targetBackwardRouteNode && targetBackward==RouteGraph::NO_NODE)) {
+      log.Warn() << "Target route nodes are not part of the routing graph '" << graph.GetFilename() << "'";
+      return false;
+    }
+
+    // Reset the state of the last search, keeping the allocated memory
+
+    if (search.graphNodes.size()!=graph.GetNodeCount()) {
+      search.graphNodes.assign(graph.GetNodeCount(),
+                               GraphNode{std::numeric_limits<double>::infinity(),
+                                         {0.0,0.0},
+                                         {RouteGraph::NO_NODE,RouteGraph::NO_NODE},
+                                         {RouteGraph::NO_OBJECT,RouteGraph::NO_OBJECT},
+                                         {false,false}});
+    }
+    else {
+      for (uint32_t node : search.graphVisited) {
+        search.graphNodes[node].openCost=std::numeric_limits<double>::infinity();
+        search.graphNodes[node].closed[GRAPH_ACCESS]=false;
+        search.graphNodes[node].closed[GRAPH_RESTRICTED]=false;
+      }
+    }
+
+    search.graphVisited.clear();
+    search.graphOpenList.clear();
+
+    auto push=[&search](const GraphOpenEntry& entry) {
+      GraphNode& node=search.graphNodes[entry.node];
+
+      if (node.openCost==std::numeric_limits<double>::infinity() &&
+          !node.closed[GRAPH_ACCESS] &&
+          !node.closed[GRAPH_RESTRICTED]) {
+        search.graphVisited.push_back(entry.node);
+      }
+
+      node.openCost=entry.currentCost;
+
+      search.graphOpenList.push_back(entry);
+      std::push_heap(search.graphOpenList.begin(),
+                     search.graphOpenList.end(),
+                     std::greater<GraphOpenEntry>());
+    };
+
+    for (const auto& startNode : {startForwardNode,startBackwardNode}) {
+      if (!startNode) {
+        continue;
+      }
+
+      uint32_t node=graph.GetNodeIndex(startNode->id.id);
+
+      if (node==RouteGraph::NO_NODE) {
+        log.Warn() << "Start route nodes are not part of the routing graph '" << graph.GetFilename() << "'";
+        return false;
+      }
+
+      if (startNode->currentCost<search.graphNodes[node].openCost) {
+        push(GraphOpenEntry{startNode->overallCost,
+                            startNode->currentCost,
+                            node,
+                            RouteGraph::NO_NODE,
+                            graph.GetObjectIndex(startNode->object),
+                            startNode->access});
+      }
+    }
+
+    Distance currentMaxDistance;
+    Distance overallDistance=GetSphericalDistance(startCoord,
+                                                  targetCoord);
+    double   costLimit=GetCostLimit(state,dbId,overallDistance);
+    StopClock clock;
+    bool     targetForwardFound=!targetForwardRouteNode;
+    bool     targetBackwardFound=!targetBackwardRouteNode;
+    uint32_t targetFinalNode=RouteGraph::NO_NODE;
+    size_t   targetFinalState=GRAPH_ACCESS;
+    double   targetFinalCost=std::numeric_limits<double>::max();
+
+    result.SetOverallDistance(overallDistance);
+    result.SetCurrentMaxDistance(currentMaxDistance);
+
+    while (!search.graphOpenList.empty() &&
+           !(targetForwardFound && targetBackwardFound)) {
+      if (parameter.GetBreaker() &&
+          parameter.GetBreaker()->IsAborted()) {
+        return true;
+      }
+
+      std::pop_heap(search.graphOpenList.begin(),
+                    search.graphOpenList.end(),
+                    std::greater<GraphOpenEntry>());
+
+      GraphOpenEntry current=search.graphOpenList.back();
+      GraphNode&     currentNode=search.graphNodes[current.node];
+      size_t         currentState=current.access ? GRAPH_ACCESS : GRAPH_RESTRICTED;
+
+      search.graphOpenList.pop_back();
+
+      if (current.currentCost!=currentNode.openCost ||
+          currentNode.closed[currentState]) {
+        // Outdated entry
+        continue;
+      }
+
+      nodesLoadedCount++;
+
+      for (uint32_t e=graph.GetEdgesBegin(current.node); e<graph.GetEdgesEnd(current.node); e++) {
+        const RouteGraph::Edge& edge=graph.GetEdge(e);
+
+        if (edge.target==current.prev ||
+            edge.target==RouteGraph::NO_NODE) {
+          nodesIgnoredCount++;
+          continue;
+        }
+
+        bool restricted=edge.IsRestricted(vehicle);
+
+        if (!current.access &&
+            !restricted) {
+          // Moving from non-accessible way back to accessible way
+          nodesIgnoredCount++;
+          continue;
+        }
+
+        if (!CanUse(state,
+                    dbId,
+                    edge)) {
+          nodesIgnoredCount++;
+          continue;
+        }
+
+        const GraphNode& nextNode=search.graphNodes[edge.target];
+
+        if (nextNode.closed[currentState]) {
+          continue;
+        }
+
+        if (!graph.CanTurn(current.node,
+                           current.object,
+                           e)) {
+          nodesIgnoredCount++;
+          continue;
+        }
+
+        double currentCost=current.currentCost+GetCosts(state,dbId,edge);
+
+        // Check, if we already have a cheaper path to the node
+        if (nextNode.openCost<=currentCost) {
+          continue;
+        }
+
+        GeoCoord coord=graph.GetNodeCoord(edge.target);
+        Distance distanceToTarget=GetSphericalDistance(coord,
+                                                       targetCoord);
+
+        currentMaxDistance=Distance::Max(currentMaxDistance,overallDistance-distanceToTarget);
+        result.SetCurrentMaxDistance(currentMaxDistance);
+
+        double estimateCost=GetTargetEstimateCosts(state,
+                                                   DBId(dbId,
+                                                        graph.GetNodeId(edge.target)),
+                                                   coord,
+                                                   targetCoord,
+                                                   search.costBounds);
+        double overallCost=currentCost+estimateCost;
+
+        if (overallCost>costLimit) {
+          nodesIgnoredCount++;
+          continue;
+        }
+
+        if (parameter.GetProgress()) {
+          parameter.GetProgress()->Progress(currentMaxDistance,overallDistance);
+        }
+
+        push(GraphOpenEntry{overallCost,
+                            currentCost,
+                            edge.target,
+                            current.node,
+                            edge.object,
+                            !restricted});
+      }
+
+      currentNode.openCost=std::numeric_limits<double>::infinity();
+      currentNode.closed[currentState]=true;
+      currentNode.closedCost[currentState]=current.currentCost;
+      currentNode.closedPrev[currentState]=current.prev;
+      currentNode.closedObject[currentState]=current.object;
+
+      maxOpenList=std::max(maxOpenList,search.graphOpenList.size());
+
+      for (uint32_t targetNode : {targetForward,targetBackward}) {
+        if (current.node==targetNode &&
+            current.currentCost<targetFinalCost) {
+          targetFinalNode=targetNode;
+          targetFinalState=currentState;
+          targetFinalCost=current.currentCost;
+        }
+      }
+
+      targetForwardFound=targetForwardFound || current.node==targetForward;
+      targetBackwardFound=targetBackwardFound || current.node==targetBackward;
+    }
+
+    clock.Stop();
+
+    if (debugPerformance) {
+      std::cout << "Graph:               " << graph.GetNodeCount() << " nodes, " << graph.GetEdgeCount() << " edges";
+      if (graph.IsMemoryMapped()) {
+        std::cout << ", memory mapped";
+      }
+      std::cout << std::endl;
+      std::cout << "Time:                " << clock << std::endl;
+      std::cout << "Air-line distance:   " << std::fixed << std::setprecision(1) << overallDistance.As<Kilometer>() << "km" << std::endl;
+      if (targetFinalNode!=RouteGraph::NO_NODE) {
+        std::cout << "Actual cost:         " << targetFinalCost << std::endl;
+      }
+      std::cout << "Cost limit:          " << costLimit << std::endl;
+      std::cout << "Graph nodes visited: " << nodesLoadedCount << std::endl;
+      std::cout << "Graph nodes ignored: " << nodesIgnoredCount << std::endl;
+      std::cout << "Max. OpenList size:  " << maxOpenList << std::endl;
+      if (clock.GetMilliseconds()>0.0) {
+        std::cout << "Graph nodes/s:       " << std::setprecision(0) << nodesLoadedCount*1000.0/clock.GetMilliseconds() << std::endl;
+      }
+    }
+
+    if (targetFinalNode==RouteGraph::NO_NODE) {
+      log.Warn() << "No route found!";
+
+      return true;
+    }
+
+    // Follow the previous nodes back to the start, switching between the nodes closed
+    // via usable and via restricted ways like ResolveRNodeChainToList()
+
+    std::list<VNode> nodes;
+    uint32_t         node=targetFinalNode;
+    size_t           nodeState=targetFinalState;
+
+    while (true) {
+      const GraphNode& current=search.graphNodes[node];
+      uint32_t         prev=current.closedPrev[nodeState];
+      ObjectFileRef    object=current.closedObject[nodeState]!=RouteGraph::NO_OBJECT ? graph.GetObject(current.closedObject[nodeState]) : start.GetObjectFileRef();
+
+      if (prev==RouteGraph::NO_NODE) {
+        nodes.push_front(VNode(DBId(dbId,graph.GetNodeId(node)),
+                               object,
+                               DBId()));
+        break;
+      }
+
+      nodes.push_front(VNode(DBId(dbId,graph.GetNodeId(node)),
+                             object,
+                             DBId(dbId,graph.GetNodeId(prev))));
+
+      if (!search.graphNodes[prev].closed[nodeState]) {
+        nodeState=nodeState==GRAPH_ACCESS ? GRAPH_RESTRICTED : GRAPH_ACCESS;
+      }
+
+      assert(search.graphNodes[prev].closed[nodeState]);
+
+      node=prev;
+    }
+
+    if (parameter.GetBreaker() &&
+        parameter.GetBreaker()->IsAborted()) {
+      return true;
+    }
+
+    if (!ResolveRNodesToRouteData(state,
+                                  nodes,
+                                  start,
+                                  target,
+                                  result.GetRoute())) {
+      return true;
+    }
+
+    ResolveRouteDataJunctions(result.GetRoute());
+
+    return true;
+  }
+
+  /**
+   * Return an unused search state, reusing the memory of a previous search if possible
+   */
+  template <class RoutingState>
+  std::unique_ptr<typename AbstractRoutingService<RoutingState>::RouteSearch> AbstractRoutingService<RoutingState>::AcquireRouteSearch()
+  {
+    std::lock_guard<std::mutex> guard(routeSearchMutex);
+
+    if (routeSearches.empty()) {
+      return std::unique_ptr<RouteSearch>(new RouteSearch());
+    }
+
+    std::unique_ptr<RouteSearch> search=std::move(routeSearches.back());
+
+    routeSearches.pop_back();
+
+    return search;
+  }
+
+  /**
+   * Return a search state acquired by AcquireRouteSearch(), so that it can be reused
+   */
+  template <class RoutingState>
+  void AbstractRoutingService<RoutingState>::ReleaseRouteSearch(std::unique_ptr<RouteSearch>&& search)
+  {
+    std::lock_guard<std::mutex> guard(routeSearchMutex);
+
+    routeSearches.push_back(std::move(search));
+  }
+
   /**
    * Calculate a route
    *
+   * The method may be called concurrently from multiple threads for the same state,
+   * each calculation uses its own search state.
+   *
    * @param state
    *    State to use
    * @param start
    *    Start of the route
    * @param target
    *    Target of teh route
-   * @param progress
-   *    Optional callback for handling routing progress
-   * @param route
-   *    The route object holding the resulting route on success
+   * @param parameter
+   *    A RoutingParamater object
    * @return
-   *    True, if the engine was able to find a route, else false
+   *    A RoutingResult object
    */
   template <class RoutingState>
   RoutingResult AbstractRoutingService<RoutingState>::CalculateRoute(RoutingState& state,
                                                                      const RoutePosition& start,
                                                                      const RoutePosition& target,
                                                                      const RoutingParameter& parameter)
+  {
+    std::unique_ptr<RouteSearch> search=AcquireRouteSearch();
+    RoutingResult                result;
+
+    search->costBounds.landmarks.clear();
+
+    if (parameter.GetUseLandmarks()) {
+      PrepareRouteCostBounds(state,
+                             search->costBounds);
+    }
+
+    bool bidirectional=parameter.IsBidirectional();
+
+    if (bidirectional &&
+        (GetRoutePredecessors(state,
+                              start.GetDatabaseId())==nullptr ||
+         GetRoutePredecessors(state,
+                              target.GetDatabaseId())==nullptr)) {
+      log.Warn() << "No route node predecessors available (import with '--routerPredecessors true'), falling back to unidirectional A* search";
+      bidirectional=false;
+    }
+
+    if (bidirectional) {
+      result=CalculateRouteBidirectional(state,
+                                         start,
+                                         target,
+                                         parameter,
+                                         *search);
+    }
+    else {
+      const RouteGraph* graph=nullptr;
+
+      if (parameter.GetUseRouteGraph() &&
+          start.GetDatabaseId()==target.GetDatabaseId()) {
+        graph=GetRouteGraph(state,
+                            start.GetDatabaseId());
+      }
+
+      if (graph==nullptr ||
+          !CalculateRouteOnGraph(state,
+                                 *graph,
+                                 start,
+                                 target,
+                                 parameter,
+                                 *search,
+                                 result)) {
+        result=CalculateRouteAStar(state,
+                                   start,
+                                   target,
+                                   parameter,
+                                   *search);
+      }
+    }
+
+    ReleaseRouteSearch(std::move(search));
+
+    return result;
+  }
+
+  /**
+   * Calculate a route using an A* search on the route nodes
+   */
+  template <class RoutingState>
+  RoutingResult AbstractRoutingService<RoutingState>::CalculateRouteAStar(RoutingState& state,
+                                                                          const RoutePosition& start,
+                                                                          const RoutePosition& target,
+                                                                          const RoutingParameter& parameter,
+                                                                          RouteSearch& search)
   {
     RoutingResult            result;
     Vehicle                  vehicle=GetVehicle(state);
@@ -841,26 +1337,22 @@ namespace osmscout {
     RouteNodeRef             targetForwardRouteNode;
     RouteNodeRef             targetBackwardRouteNode;
 
-    // Sorted list (smallest cost first) of ways to check (we are using a std::set)
-    OpenList                 openList;
-    // Map routing nodes by id
-    OpenMap                  openMap;
-
-    // Restricted way (access=destination) is a way that may be used just
-    // in case when target is on this way. Some routing nodes may be accessed
-    // from two different ways - one without any access restriction (closedSet)
-    // and second with restriction (closedRestrictedSet)
-    ClosedSet                closedSet;
-    ClosedSet                closedRestrictedSet;
-
     size_t                   nodesLoadedCount=0;
     size_t                   nodesIgnoredCount=0;
     size_t                   maxOpenList=0;
     size_t                   maxClosedSet=0;
+    size_t                   nodeCapacity=search.openList.GetNodeCapacity();
 
-    openMap.reserve(10000);
-    closedSet.reserve(300000);
-    closedRestrictedSet.reserve(10000);
+    // The open list and closed sets are part of the search state, so that their memory is reused.
+    // Restricted way (access=destination) is a way that may be used just
+    // in case when target is on this way. Some routing nodes may be accessed
+    // from two different ways - one without any access restriction (closedSet)
+    // and second with restriction (closedRestrictedSet)
+    search.openList.Clear();
+    search.openMap.Clear();
+    search.closedSet.Clear();
+    search.closedRestrictedSet.Clear();
+    search.costBounds.targets.clear();
 
     if (!GetTargetNodes(state,
                         target,
@@ -870,10 +1362,20 @@ namespace osmscout {
       return result;
     }
 
+    if (parameter.GetUseLandmarks()) {
+      for (const auto& targetNode : {targetForwardRouteNode,targetBackwardRouteNode}) {
+        if (targetNode) {
+          search.costBounds.targets.push_back(DBId(target.GetDatabaseId(),
+                                                targetNode->GetId()));
+        }
+      }
+    }
+
     if (!GetStartNodes(state,
                        start,
                        startCoord,
                        targetCoord,
+                       search.costBounds,
                        startForwardRouteNode,
                        startBackwardRouteNode,
                        startForwardNode,
@@ -906,15 +1408,11 @@ namespace osmscout {
     }
 
     if (startForwardNode) {
-      std::pair<OpenListRef,bool> insertResult=openList.insert(startForwardNode);
-
-      openMap[startForwardNode->id]=insertResult.first;
+      search.openMap[startForwardNode->id]=search.openList.Insert(*startForwardNode);
     }
 
     if (startBackwardNode) {
-      std::pair<OpenListRef,bool> insertResult=openList.insert(startBackwardNode);
-
-      openMap[startBackwardNode->id]=insertResult.first;
+      search.openMap[startBackwardNode->id]=search.openList.Insert(*startBackwardNode);
     }
 
 
@@ -928,13 +1426,13 @@ namespace osmscout {
     result.SetCurrentMaxDistance(currentMaxDistance);
 
     StopClock    clock;
-    RNodeRef     current;
+    RNode*       current;
     RouteNodeRef currentRouteNode;
     DatabaseId   dbId;
     bool         targetForwardFound=targetForwardRouteNode ? false : true;
     bool         targetBackwardFound=targetBackwardRouteNode ? false : true;
-    RNodeRef     targetForwardFinalNode;
-    RNodeRef     targetBackwardFinalNode;
+    RNode*       targetForwardFinalNode=nullptr;
+    RNode*       targetBackwardFinalNode=nullptr;
 
     do {
       //
@@ -946,10 +1444,7 @@ namespace osmscout {
         return result;
       }
 
-      current=*openList.begin();
-
-      openMap.erase(current->id);
-      openList.erase(openList.begin());
+      current=search.openList.Pop();
 
       currentRouteNode=current->node;
       dbId=current->id.database;
@@ -965,15 +1460,16 @@ namespace osmscout {
 #endif
 
       if (!WalkPaths(state,
-                     current,
+                     *current,
                      currentRouteNode,
-                     openList,
-                     openMap,
-                     closedSet,
-                     closedRestrictedSet,
+                     search.openList,
+                     search.openMap,
+                     search.closedSet,
+                     search.closedRestrictedSet,
                      result,
                      parameter,
                      targetCoord,
+                     search.costBounds,
                      vehicle,
                      nodesIgnoredCount,
                      currentMaxDistance,
@@ -990,12 +1486,12 @@ namespace osmscout {
       //
 
       if (!WalkToOtherDatabases(state,
-                                current,
+                                *current,
                                 currentRouteNode,
-                                openList,
-                                openMap,
-                                closedSet,
-                                closedRestrictedSet)) {
+                                search.openList,
+                                search.openMap,
+                                search.closedSet,
+                                search.closedRestrictedSet)) {
         log.Error() << "Failed to walk to other databases from " << dbId << " / " << currentRouteNode->GetFileOffset();
         return result;
       }
@@ -1008,23 +1504,25 @@ namespace osmscout {
         std::cout << "Closing " << current->id << " (previous " << current->prev << ")" << std::endl;
 #endif
       if (current->access) {
-        closedSet.insert(VNode(current->id,
-                               current->object,
-                               current->prev));
+        search.closedSet.Insert(current->id,
+                                VNode(current->id,
+                                      current->object,
+                                      current->prev));
       }
       else {
-        closedRestrictedSet.insert(VNode(current->id,
-                                         current->object,
-                                         current->prev));
+        search.closedRestrictedSet.Insert(current->id,
+                                          VNode(current->id,
+                                                current->object,
+                                                current->prev));
       }
 
       current->node=nullptr;
 
-      maxOpenList=std::max(maxOpenList,openMap.size());
-      maxClosedSet=std::max(maxClosedSet,closedSet.size()+closedRestrictedSet.size());
+      maxOpenList=std::max(maxOpenList,search.openList.Size());
+      maxClosedSet=std::max(maxClosedSet,search.closedSet.Size()+search.closedRestrictedSet.Size());
 
 #if defined(DEBUG_ROUTING)
-      if (openList.empty()) {
+      if (search.openList.IsEmpty()) {
         std::cout << "No more alternatives, stopping" << std::endl;
       }
 
@@ -1057,16 +1555,16 @@ namespace osmscout {
         }
       }
 
-    } while (!openList.empty() && !(targetForwardFound && targetBackwardFound));
+    } while (!search.openList.IsEmpty() && !(targetForwardFound && targetBackwardFound));
 
     // If we have keep the last node open because of access violations, add it
     // after routing is done
-    if (closedSet.find(VNode(current->id))==closedSet.end()) {
-      closedSet.insert(VNode(current->id,
-                             current->object,
-                             current->prev));
-    }
-    RNodeRef  targetFinalNode;
+    search.closedSet.Insert(current->id,
+                            VNode(current->id,
+                                  current->object,
+                                  current->prev));
+
+    RNode*    targetFinalNode=nullptr;
 
     if (targetBackwardFinalNode && targetForwardFinalNode) {
       if (targetForwardFinalNode->currentCost<=targetBackwardFinalNode->currentCost) {
@@ -1136,14 +1634,25 @@ namespace osmscout {
       std::cout << "Route nodes ignored: " << nodesIgnoredCount << std::endl;
       std::cout << "Max. OpenList size:  " << maxOpenList << std::endl;
       std::cout << "Max. ClosedSet size: " << maxClosedSet << std::endl;
+      std::cout << "RNodes allocated:    " << search.openList.GetNodeCount() << " (" << (search.openList.GetNodeCapacity()-nodeCapacity) << " new)" << std::endl;
+      if (clock.GetMilliseconds()>0.0) {
+        std::cout << "Route nodes/s:       " << std::setprecision(0) << nodesLoadedCount*1000.0/clock.GetMilliseconds() << std::endl;
+      }
     }
 
     if (!targetFinalNode) {
       log.Warn() << "No route found!";
 
+      search.openList.Clear();
+
       return result;
     }
 
+    DBId targetFinalNodeId=targetFinalNode->id;
+
+    // Release the route nodes referenced by the RNodes
+    search.openList.Clear();
+
     std::list<VNode> nodes;
 
     if (parameter.GetBreaker() &&
@@ -1151,9 +1660,9 @@ namespace osmscout {
       return result;
     }
 
-    ResolveRNodeChainToList(targetFinalNode->id,
-                            closedSet,
-                            closedRestrictedSet,
+    ResolveRNodeChainToList(targetFinalNodeId,
+                            search.closedSet,
+                            search.closedRestrictedSet,
                             nodes);
 
 #if defined(DEBUG_ROUTING)
@@ -1182,395 +1691,1804 @@ namespace osmscout {
     return result;
   }
 
+  /**
+   * Calculate lower bounds for the costs from the start route nodes to the given
+   * coordinate and from the coordinate to the target route nodes.
+   *
+   * The bidirectional search uses the average of both as potential (A* estimate), which is
+   * consistent for the forward and the backward search at the same time.
+   */
   template <class RoutingState>
-  void AbstractRoutingService<RoutingState>::AddNodes(RouteData& route,
-                                                      DatabaseId database,
-                                                      Id startNodeId,
-                                                      size_t startNodeIndex,
-                                                      const ObjectFileRef& object,
-                                                      size_t idCount,
-                                                      bool oneway,
-                                                      size_t targetNodeIndex)
+  void AbstractRoutingService<RoutingState>::GetBidirectionalEstimates(const RoutingState& state,
+                                                                       const DBId& id,
+                                                                       const GeoCoord& coord,
+                                                                       const BidirectionalQuery& query,
+                                                                       double& startEstimate,
+                                                                       double& targetEstimate)
   {
-    assert(startNodeIndex<idCount);
-    assert(targetNodeIndex<idCount);
+    startEstimate=std::numeric_limits<double>::max();
+    targetEstimate=std::numeric_limits<double>::max();
+
+    for (const auto& startNode : query.starts) {
+      double estimate=GetEstimateCosts(state,
+                                       id.database,
+                                       GetSphericalDistance(startNode.coord,
+                                                            coord));
+
+      if (query.costBounds!=nullptr) {
+        estimate=std::max(estimate,
+                          GetRouteCostBound(state,
+                                            *query.costBounds,
+                                            startNode.id,
+                                            id));
+      }
 
-    if (std::max(startNodeIndex,targetNodeIndex)-std::min(startNodeIndex,targetNodeIndex)==1) {
-      // From one node to the neighbour node (+1 or -1)
-      route.AddEntry(database,
-                     startNodeId,
-                     startNodeIndex,
-                     object,
-                     targetNodeIndex);
+      startEstimate=std::min(startEstimate,
+                             startNode.cost+estimate);
     }
-    else if (startNodeIndex<targetNodeIndex) {
-      // Following the way
-      route.AddEntry(database,
-                     startNodeId,
-                     startNodeIndex,
-                     object,
-                     startNodeIndex+1);
 
-      for (size_t i=startNodeIndex+1; i<targetNodeIndex-1; i++) {
-        route.AddEntry(database,
-                       0,
-                       i,
-                       object,
-                       i+1);
+    for (const auto& targetNode : query.targets) {
+      double estimate=GetEstimateCosts(state,
+                                       id.database,
+                                       GetSphericalDistance(coord,
+                                                            targetNode.coord));
+
+      if (query.costBounds!=nullptr) {
+        estimate=std::max(estimate,
+                          GetRouteCostBound(state,
+                                            *query.costBounds,
+                                            id,
+                                            targetNode.id));
       }
 
-      route.AddEntry(database,
-                     0,
-                     targetNodeIndex-1,
-                     object,
-                     targetNodeIndex);
+      targetEstimate=std::min(targetEstimate,
+                              targetNode.cost+estimate);
     }
-    else if (oneway) {
-      // startNodeIndex>tragetNodeIndex, but this is a oneway we assume
-      // that the way is either an area or is a roundabound
-      // TODO: proof this using the right assertions or checks
-      size_t pos=startNodeIndex+1;
-      size_t next;
+  }
 
-      if (pos>=idCount) {
-        pos=0;
+  /**
+   * Check, if the route via the given route node, reached by the forward and the backward
+   * search, is valid and cheaper than the best route found so far.
+   */
+  template <class RoutingState>
+  void AbstractRoutingService<RoutingState>::CheckBidirectionalMeeting(const RouteNode& routeNode,
+                                                                       const RNode& forwardNode,
+                                                                       const RNode& backwardNode,
+                                                                       BidirectionalQuery& query)
+  {
+    double cost=forwardNode.currentCost+backwardNode.currentCost;
+
+    if (cost>=query.bestCost) {
+      return;
+    }
+
+    // After entering a restricted way, we cannot continue on a way without restrictions
+    if (!forwardNode.access &&
+        backwardNode.access) {
+      return;
+    }
+
+    // Going back to the previous route node
+    if (forwardNode.prev.IsValid() &&
+        forwardNode.prev==backwardNode.prev) {
+      return;
+    }
+
+    if (!routeNode.CanTurn(forwardNode.object,
+                           backwardNode.object)) {
+      return;
+    }
+
+#if defined(DEBUG_ROUTING)
+    std::cout << "Meeting at " << forwardNode.id << " " << cost << std::endl;
+#endif
+
+    query.bestCost=cost;
+    query.forwardMeeting=VNode(forwardNode.id,
+                               forwardNode.object,
+                               forwardNode.prev);
+    query.backwardMeeting=VNode(backwardNode.id,
+                                backwardNode.object,
+                                backwardNode.prev);
+  }
+
+  /**
+   * Expand the given node of the forward search of the bidirectional A*
+   */
+  template <class RoutingState>
+  bool AbstractRoutingService<RoutingState>::WalkPathsForward(const RoutingState& state,
+                                                              RNode& current,
+                                                              BidirectionalQuery& query,
+                                                              RouteSearch& search)
+  {
+    const RouteNode& currentRouteNode=*current.node;
+    DatabaseId       dbId=current.id.database;
+
+    for (size_t i=0; i<currentRouteNode.paths.size(); i++) {
+      const RouteNode::Path& path=currentRouteNode.paths[i];
+      DBId                   pathId(dbId,path.id);
+      const ObjectFileRef&   object=currentRouteNode.objects[path.objectIndex].object;
+
+      if (path.id==current.prev.id ||
+          (!current.access &&
+           !path.IsRestricted(query.vehicle)) ||
+          !CanUse(state,
+                  dbId,
+                  currentRouteNode,
+                  i) ||
+          !currentRouteNode.CanTurn(current.object,
+                                    object)) {
+        query.nodesIgnoredCount++;
+        continue;
       }
 
-      next=pos+1;
-      if (next>=idCount) {
-        next=0;
+      if ((current.access &&
+           search.closedSet.Contains(pathId)) ||
+          (!current.access &&
+           search.closedRestrictedSet.Contains(pathId))) {
+        continue;
       }
 
-      route.AddEntry(database,
-                     startNodeId,
-                     startNodeIndex,
-                     object,
-                     pos);
+      double  currentCost=current.currentCost+GetCosts(state,dbId,currentRouteNode,i);
+      RNode** openMapEntry=search.openMap.Find(pathId);
+      RNode*  openEntry=nullptr;
 
-      while (next!=targetNodeIndex) {
-        route.AddEntry(database,
-                       0,
-                       pos,
-                       object,
-                       next);
+      if (openMapEntry!=nullptr &&
+          search.openList.Contains(*openMapEntry)) {
+        openEntry=*openMapEntry;
+      }
 
-        pos++;
-        if (pos>=idCount) {
-          pos=0;
-        }
+      if (openEntry!=nullptr &&
+          openEntry->currentCost<=currentCost) {
+        continue;
+      }
 
-        next=pos+1;
-        if (next>=idCount) {
-          next=0;
-        }
+      RouteNodeRef nextNode;
+
+      if (openEntry!=nullptr) {
+        nextNode=openEntry->node;
+      }
+      else if (!GetRouteNode(pathId,
+                             nextNode)) {
+        log.Error() << "Cannot load route node with id " << path.id;
+        return false;
       }
 
-      route.AddEntry(database,
-                     0,
-                     pos,
-                     object,
-                     targetNodeIndex);
-    }
-    else {
-      // We follow the way in the opposite direction
-      route.AddEntry(database,
-                     startNodeId,
-                     startNodeIndex,
-                     object,
-                     startNodeIndex-1);
+      double startEstimate;
+      double targetEstimate;
 
-      for (long i=(long)startNodeIndex-1; i>(long)targetNodeIndex+1; i--) {
-        route.AddEntry(database,
-                       0,
-                       (size_t)i,
-                       object,
-                       (size_t)i-1);
+      GetBidirectionalEstimates(state,
+                                pathId,
+                                nextNode->GetCoord(),
+                                query,
+                                startEstimate,
+                                targetEstimate);
+
+      if (currentCost+targetEstimate>query.costLimit) {
+        query.nodesIgnoredCount++;
+        continue;
       }
 
-      route.AddEntry(database,
-                     0,
-                     targetNodeIndex+1,
-                     object,
-                     targetNodeIndex);
-    }
-  }
+      RNode* node;
 
-  template <class RoutingState>
-  bool AbstractRoutingService<RoutingState>::ResolveRNodesToRouteData(const RoutingState& state,
-                                                                      const std::list<VNode>& nodes,
-                                                                      const RoutePosition& start,
-                                                                      const RoutePosition& target,
-                                                                      RouteData& route)
-  {
-    std::set<DBId>                                routeNodeIds;
-    std::set<DBFileOffset>                        wayOffsets;
-    std::set<DBFileOffset>                        areaOffsets;
+      if (openEntry!=nullptr) {
+        node=openEntry;
 
-    std::unordered_map<DBId,RouteNodeRef>         routeNodeMap;
-    std::unordered_map<DBFileOffset,AreaRef>      areaMap;
-    std::unordered_map<DBFileOffset,WayRef>       wayMap;
+        node->prev=current.id;
+        node->object=object;
+        node->currentCost=currentCost;
+        node->estimateCost=(targetEstimate-startEstimate)/2;
+        node->overallCost=node->currentCost+node->estimateCost;
+        node->access=!path.IsRestricted(query.vehicle);
 
-    std::vector<Point>                            *ids=nullptr;
-    bool                                          oneway=false;
+        search.openList.Update(node);
+      }
+      else {
+        RNode newNode(pathId,
+                      nextNode,
+                      object,
+                      current.id);
+
+        newNode.currentCost=currentCost;
+        newNode.estimateCost=(targetEstimate-startEstimate)/2;
+        newNode.overallCost=newNode.currentCost+newNode.estimateCost;
+        newNode.access=!path.IsRestricted(query.vehicle);
+
+        node=search.openList.Insert(newNode);
+        search.openMap[pathId]=node;
+      }
 
-    // Collect all route node file offsets on the path and also
-    // all area/way file offsets on the path
-    for (const auto& node : nodes) {
-      routeNodeIds.insert(node.currentNode);
-      DatabaseId dbId=node.currentNode.database;
+      RNode** backwardEntry=search.backwardOpenMap.Find(pathId);
 
-      if (node.object.Valid()) {
-        switch (node.object.GetType()) {
-        case refArea:
-          areaOffsets.insert(DBFileOffset(dbId,node.object.GetFileOffset()));
-          break;
-        case refWay:
-          wayOffsets.insert(DBFileOffset(dbId,node.object.GetFileOffset()));
-          break;
-        default:
-          assert(false);
-          break;
-        }
+      if (backwardEntry!=nullptr) {
+        CheckBidirectionalMeeting(*nextNode,
+                                  *node,
+                                  **backwardEntry,
+                                  query);
       }
     }
 
-    // Collect area/way file offset for the
-    // target object (not traversed by above loop)
-    switch (target.GetObjectFileRef().GetType()) {
-    case refArea:
-      areaOffsets.insert(DBFileOffset(target.GetDatabaseId(),
-                                      target.GetObjectFileRef().GetFileOffset()));
-      break;
-    case refWay:
-      wayOffsets.insert(DBFileOffset(target.GetDatabaseId(),
-                                     target.GetObjectFileRef().GetFileOffset()));
-      break;
-    default:
-      assert(false);
-      break;
-    }
+    return true;
+  }
 
-    //
-    // Load data
-    //
+  /**
+   * Expand the given node of the backward search of the bidirectional A*. The
+   * predecessors of the route node are taken from the RoutePredecessorTable,
+   * usability and costs from their path to the current node.
+   */
+  template <class RoutingState>
+  bool AbstractRoutingService<RoutingState>::WalkPathsBackward(const RoutingState& state,
+                                                               RNode& current,
+                                                               BidirectionalQuery& query,
+                                                               RouteSearch& search)
+  {
+    const RouteNode&             currentRouteNode=*current.node;
+    DatabaseId                   dbId=current.id.database;
+    const RoutePredecessorTable* predecessors=GetRoutePredecessors(state,
+                                                                   dbId);
 
-    if (!GetRouteNodes(routeNodeIds,
-                       routeNodeMap)) {
-      log.Error() << "Cannot load route nodes";
+    if (predecessors==nullptr) {
+      log.Error() << "No route node predecessors for database " << dbId;
       return false;
     }
 
-    if (!GetAreasByOffset(areaOffsets,
-                          areaMap)) {
-      log.Error() << "Cannot load areas";
-      return false;
-    }
+    uint32_t nodeIndex=predecessors->GetNodeIndex(current.id.id);
 
-    if (!GetWaysByOffset(wayOffsets,
-                         wayMap)) {
-      log.Error() << "Cannot load ways";
-      return false;
+    if (nodeIndex==RoutePredecessorTable::NO_NODE) {
+      return true;
     }
 
-    assert(start.GetObjectFileRef().GetType()==refArea ||
-           start.GetObjectFileRef().GetType()==refWay);
+    for (uint32_t p=predecessors->GetPredecessorsBegin(nodeIndex);
+         p<predecessors->GetPredecessorsEnd(nodeIndex);
+         p++) {
+      const RoutePredecessorTable::Predecessor& predecessor=predecessors->GetPredecessor(p);
+      DBId                                      pathId(dbId,predecessor.id);
 
-    if (start.GetObjectFileRef().GetType()==refArea) {
-      std::unordered_map<DBFileOffset,AreaRef>::const_iterator entry=areaMap
-        .find(DBFileOffset(start.GetDatabaseId(),start.GetObjectFileRef().GetFileOffset()));
+      if (predecessor.id==current.prev.id) {
+        query.nodesIgnoredCount++;
+        continue;
+      }
 
-      assert(entry!=areaMap.end());
+      // In the backward search a node without access (restricted predecessors still
+      // allowed) is less constrained than a node with access. Since it was closed with
+      // lower costs, it also dominates the node with access. Closing the node a second
+      // time would allow cycles in the chain of previous nodes (see ResolveRNodeChainToList()).
+      if (search.backwardClosedRestrictedSet.Contains(pathId)) {
+        continue;
+      }
 
-      ids=&entry->second->rings.front().nodes;
-      oneway=false;
-    }
-    else if (start.GetObjectFileRef().GetType()==refWay) {
-      std::unordered_map<DBFileOffset,WayRef>::const_iterator entry=wayMap
-        .find(DBFileOffset(start.GetDatabaseId(),start.GetObjectFileRef().GetFileOffset()));
+      RNode** openMapEntry=search.backwardOpenMap.Find(pathId);
+      RNode*  openEntry=nullptr;
 
-      assert(entry!=wayMap.end());
+      if (openMapEntry!=nullptr &&
+          search.backwardOpenList.Contains(*openMapEntry)) {
+        openEntry=*openMapEntry;
+      }
 
-      ids=&entry->second->nodes;
-      oneway=!CanUseBackward(state,entry->first.database,entry->second);
-    }
+      RouteNodeRef prevNode;
 
-    if (nodes.empty()) {
-      // We assume that startNode and targetNode are on the same area/way (with no routing node in between)
-      assert(start.GetObjectFileRef()==target.GetObjectFileRef());
+      if (openEntry!=nullptr) {
+        prevNode=openEntry->node;
+      }
+      else if (!GetRouteNode(pathId,
+                             prevNode)) {
+        log.Error() << "Cannot load route node with id " << predecessor.id;
+        return false;
+      }
 
-      AddNodes(route,
-               start.GetDatabaseId(),
-               (*ids)[start.GetNodeIndex()].GetId(),
-               start.GetNodeIndex(),
-               start.GetObjectFileRef(),
-               ids->size(),
-               oneway,
-               target.GetNodeIndex());
+      if (predecessor.pathIndex>=prevNode->paths.size() ||
+          prevNode->paths[predecessor.pathIndex].id!=current.id.id) {
+        log.Error() << "Route node predecessors do not match route node with id " << predecessor.id;
+        return false;
+      }
 
-      route.AddEntry(target.GetDatabaseId(),
-                     0,
-                     target.GetNodeIndex(),
-                     ObjectFileRef(),
-                     0);
-      return true;
+      const RouteNode::Path& prevPath=prevNode->paths[predecessor.pathIndex];
+      const ObjectFileRef&   object=prevNode->objects[prevPath.objectIndex].object;
+
+      if (!prevPath.IsRestricted(query.vehicle) &&
+          search.backwardClosedSet.Contains(pathId)) {
+        continue;
+      }
+
+      if ((current.access &&
+           prevPath.IsRestricted(query.vehicle)) ||
+          !CanUse(state,
+                  dbId,
+                  *prevNode,
+                  predecessor.pathIndex) ||
+          !currentRouteNode.CanTurn(object,
+                                    current.object)) {
+        query.nodesIgnoredCount++;
+        continue;
+      }
+
+      double currentCost=current.currentCost+GetCosts(state,dbId,*prevNode,predecessor.pathIndex);
+
+      if (openEntry!=nullptr &&
+          openEntry->currentCost<=currentCost) {
+        continue;
+      }
+
+      double startEstimate;
+      double targetEstimate;
+
+      GetBidirectionalEstimates(state,
+                                pathId,
+                                prevNode->GetCoord(),
+                                query,
+                                startEstimate,
+                                targetEstimate);
+
+      if (currentCost+startEstimate>query.costLimit) {
+        query.nodesIgnoredCount++;
+        continue;
+      }
+
+      RNode* node;
+
+      if (openEntry!=nullptr) {
+        node=openEntry;
+
+        node->prev=current.id;
+        node->object=object;
+        node->currentCost=currentCost;
+        node->estimateCost=(startEstimate-targetEstimate)/2;
+        node->overallCost=node->currentCost+node->estimateCost;
+        node->access=!prevPath.IsRestricted(query.vehicle);
+
+        search.backwardOpenList.Update(node);
+      }
+      else {
+        RNode newNode(pathId,
+                      prevNode,
+                      object,
+                      current.id);
+
+        newNode.currentCost=currentCost;
+        newNode.estimateCost=(startEstimate-targetEstimate)/2;
+        newNode.overallCost=newNode.currentCost+newNode.estimateCost;
+        newNode.access=!prevPath.IsRestricted(query.vehicle);
+
+        node=search.backwardOpenList.Insert(newNode);
+        search.backwardOpenMap[pathId]=node;
+      }
+
+      RNode** forwardEntry=search.openMap.Find(pathId);
+
+      if (forwardEntry!=nullptr) {
+        CheckBidirectionalMeeting(*prevNode,
+                                  **forwardEntry,
+                                  *node,
+                                  query);
+      }
     }
 
-    auto entry=routeNodeMap.find(nodes.front().currentNode);
-    if (entry==routeNodeMap.end()){
-      log.Error() << "Can't found route node " << nodes.front().currentNode.database <<
-        ", " << nodes.front().currentNode.id;
-      return false;
+    return true;
+  }
+
+  /**
+   * Calculate a route using a bidirectional A* search. A forward search starts at
+   * the start route nodes, a backward search at the target route nodes. Both use
+   * the average of the estimates to the target and from the start as potential.
+   * The search stops, if the sum of the minimum costs of both open lists is
+   * not smaller than the costs of the best route found, which then is optimal.
+   *
+   * @param state
+   *    State to use
+   * @param start
+   *    Start of the route
+   * @param target
+   *    Target of the route
+   * @param parameter
+   *    A RoutingParamater object
+   * @return
+   *    A RoutingResult object
+   */
+  template <class RoutingState>
+  RoutingResult AbstractRoutingService<RoutingState>::CalculateRouteBidirectional(RoutingState& state,
+                                                                                  const RoutePosition& start,
+                                                                                  const RoutePosition& target,
+                                                                                  const RoutingParameter& parameter,
+                                                                                  RouteSearch& search)
+  {
+    RoutingResult      result;
+    BidirectionalQuery query;
+    RouteNodeRef       startForwardRouteNode;
+    RouteNodeRef       startBackwardRouteNode;
+    RNodeRef           startForwardNode;
+    RNodeRef           startBackwardNode;
+
+    GeoCoord           startCoord;
+    GeoCoord           targetCoord;
+
+    RouteNodeRef       targetForwardRouteNode;
+    RouteNodeRef       targetBackwardRouteNode;
+
+    size_t             forwardNodesLoadedCount=0;
+    size_t             backwardNodesLoadedCount=0;
+    size_t             maxOpenList=0;
+    size_t             maxClosedSet=0;
+
+    search.openList.Clear();
+    search.openMap.Clear();
+    search.closedSet.Clear();
+    search.closedRestrictedSet.Clear();
+    search.backwardOpenList.Clear();
+    search.backwardOpenMap.Clear();
+    search.backwardClosedSet.Clear();
+    search.backwardClosedRestrictedSet.Clear();
+    search.costBounds.targets.clear();
+
+    if (!GetTargetNodes(state,
+                        target,
+                        targetCoord,
+                        targetForwardRouteNode,
+                        targetBackwardRouteNode)) {
+      return result;
     }
-    RouteNodeRef initialNode=entry->second;
 
-    //
-    // Add The path from the start node to the first routing node
-    //
-    if ((*ids)[start.GetNodeIndex()].GetId()!=initialNode->GetId()) {
-      size_t routeNodeIndex=0;
+    if (!GetStartNodes(state,
+                       start,
+                       startCoord,
+                       targetCoord,
+                       search.costBounds,
+                       startForwardRouteNode,
+                       startBackwardRouteNode,
+                       startForwardNode,
+                       startBackwardNode)) {
+      return result;
+    }
 
-      while ((*ids)[routeNodeIndex].GetId()!=initialNode->GetId() &&
-          routeNodeIndex<ids->size()) {
-        routeNodeIndex++;
+    if (parameter.GetBreaker() &&
+        parameter.GetBreaker()->IsAborted()) {
+      return result;
+    }
+
+    Distance overallDistance=GetSphericalDistance(startCoord,
+                                                  targetCoord);
+
+    query.vehicle=GetVehicle(state);
+    query.costLimit=GetCostLimit(state,start.GetDatabaseId(),overallDistance);
+    query.bestCost=std::numeric_limits<double>::infinity();
+    query.nodesIgnoredCount=0;
+    query.costBounds=parameter.GetUseLandmarks() ? &search.costBounds : nullptr;
+
+    for (const auto& startNode : {startForwardNode,startBackwardNode}) {
+      if (startNode) {
+        query.starts.push_back(BidirectionalTerminal{startNode->id,
+                                                     startNode->node->GetCoord(),
+                                                     startNode->currentCost});
       }
-      assert(routeNodeIndex<ids->size());
+    }
 
-      // Start node to initial route node
-      AddNodes(route,
-               start.GetDatabaseId(),
-               (*ids)[start.GetNodeIndex()].GetId(),
-               start.GetNodeIndex(),
-               start.GetObjectFileRef(),
-               ids->size(),
-               oneway,
-               routeNodeIndex);
+    // Like the A* search we do not add costs for the way from the last route node to the target
+    for (const auto& targetNode : {targetForwardRouteNode,targetBackwardRouteNode}) {
+      if (targetNode) {
+        query.targets.push_back(BidirectionalTerminal{DBId(target.GetDatabaseId(),
+                                                           targetNode->GetId()),
+                                                      targetNode->GetCoord(),
+                                                      0.0});
+      }
     }
 
-    //
-    // Walk the routing path from route node to the next route node
-    // and build entries.
-    //
-    for (auto n=nodes.begin();
-        n!=nodes.end();
-        n++) {
-      auto nn=n;
+    for (const auto& startNode : {startForwardNode,startBackwardNode}) {
+      if (startNode) {
+        RNode  node(*startNode);
+        double startEstimate;
+        double targetEstimate;
 
-      nn++;
+        GetBidirectionalEstimates(state,
+                                  node.id,
+                                  node.node->GetCoord(),
+                                  query,
+                                  startEstimate,
+                                  targetEstimate);
 
-      RouteNodeRef node=routeNodeMap.find(n->currentNode)->second;
+        node.estimateCost=(targetEstimate-startEstimate)/2;
+        node.overallCost=node.currentCost+node.estimateCost;
 
-      //
-      // The path from the last routing node to the target node and the
-      // target node itself
-      //
-      if (nn==nodes.end()) {
-        assert(target.GetObjectFileRef().GetType()==refArea ||
-               target.GetObjectFileRef().GetType()==refWay);
+        search.openMap[node.id]=search.openList.Insert(node);
+      }
+    }
 
-        if (target.GetObjectFileRef().GetType()==refArea) {
-          std::unordered_map<DBFileOffset,AreaRef>::const_iterator areaEntry=areaMap
-            .find(DBFileOffset(target.GetDatabaseId(),target.GetObjectFileRef().GetFileOffset()));
+    for (const auto& targetNode : {targetForwardRouteNode,targetBackwardRouteNode}) {
+      if (targetNode) {
+        RNode  node(DBId(target.GetDatabaseId(),
+                         targetNode->GetId()),
+                    targetNode,
+                    ObjectFileRef());
+        double startEstimate;
+        double targetEstimate;
+
+        GetBidirectionalEstimates(state,
+                                  node.id,
+                                  targetNode->GetCoord(),
+                                  query,
+                                  startEstimate,
+                                  targetEstimate);
+
+        node.estimateCost=(startEstimate-targetEstimate)/2;
+        node.overallCost=node.currentCost+node.estimateCost;
+        node.access=false;
+
+        RNode*  backwardNode=search.backwardOpenList.Insert(node);
+        RNode** forwardEntry=search.openMap.Find(node.id);
+
+        search.backwardOpenMap[node.id]=backwardNode;
+
+        if (forwardEntry!=nullptr) {
+          CheckBidirectionalMeeting(*targetNode,
+                                    **forwardEntry,
+                                    *backwardNode,
+                                    query);
+        }
+      }
+    }
 
-          assert(areaEntry!=areaMap.end());
+    Distance forwardMaxDistance;
+    Distance backwardMaxDistance;
 
-          ids=&areaEntry->second->rings.front().nodes;
-          oneway=false;
+    result.SetOverallDistance(overallDistance);
+    result.SetCurrentMaxDistance(Distance());
+
+    StopClock clock;
+
+    while (!search.openList.IsEmpty() &&
+           !search.backwardOpenList.IsEmpty()) {
+      if (parameter.GetBreaker() &&
+          parameter.GetBreaker()->IsAborted()) {
+        return result;
+      }
+
+      // Every route not found yet is at least as expensive as the sum of the minimum
+      // (reduced) costs of both open lists
+      if (search.openList.Top()->overallCost+search.backwardOpenList.Top()->overallCost>=query.bestCost) {
+        break;
+      }
+
+      // Expand the search with the lower minimum costs
+      bool   forward=search.openList.Top()->overallCost<=search.backwardOpenList.Top()->overallCost;
+      RNode* current=forward ? search.openList.Pop() : search.backwardOpenList.Pop();
+
+#if defined(DEBUG_ROUTING)
+      std::cout << "Analysing " << (forward ? "follower" : "predecessor") << " of node " << current->id;
+      std::cout << " " << current->currentCost << " " << current->estimateCost << " " << current->overallCost << std::endl;
+#endif
+
+      if (forward) {
+        forwardNodesLoadedCount++;
+
+        RNode** backwardEntry=search.backwardOpenMap.Find(current->id);
+
+        if (backwardEntry!=nullptr) {
+          CheckBidirectionalMeeting(*current->node,
+                                    *current,
+                                    **backwardEntry,
+                                    query);
         }
-        else if (target.GetObjectFileRef().GetType()==refWay) {
-          std::unordered_map<DBFileOffset,WayRef>::const_iterator wayEntry=wayMap
-            .find(DBFileOffset(target.GetDatabaseId(),target.GetObjectFileRef().GetFileOffset()));
 
-          assert(wayEntry!=wayMap.end());
+        if (!WalkPathsForward(state,
+                              *current,
+                              query,
+                              search)) {
+          log.Error() << "Failed to walk paths from " << current->id.database << " / " << current->id.id;
+          return result;
+        }
 
-          ids=&wayEntry->second->nodes;
-          oneway=!CanUseBackward(state,wayEntry->first.database,wayEntry->second);
+        if (!WalkToOtherDatabases(state,
+                                  *current,
+                                  current->node,
+                                  search.openList,
+                                  search.openMap,
+                                  search.closedSet,
+                                  search.closedRestrictedSet)) {
+          log.Error() << "Failed to walk to other databases from " << current->id.database << " / " << current->id.id;
+          return result;
         }
 
-        size_t currentNodeIndex=0;
+        if (current->access) {
+          search.closedSet.Insert(current->id,
+                                  VNode(current->id,
+                                        current->object,
+                                        current->prev));
+        }
+        else {
+          search.closedRestrictedSet.Insert(current->id,
+                                            VNode(current->id,
+                                                  current->object,
+                                                  current->prev));
+        }
 
-        while ((*ids)[currentNodeIndex].GetId()!=node->GetId() &&
-            currentNodeIndex<ids->size()) {
-          currentNodeIndex++;
+        forwardMaxDistance=Distance::Max(forwardMaxDistance,
+                                         overallDistance-GetSphericalDistance(current->node->GetCoord(),
+                                                                              targetCoord));
+      }
+      else {
+        backwardNodesLoadedCount++;
+
+        RNode** forwardEntry=search.openMap.Find(current->id);
+
+        if (forwardEntry!=nullptr) {
+          CheckBidirectionalMeeting(*current->node,
+                                    **forwardEntry,
+                                    *current,
+                                    query);
         }
-        assert(currentNodeIndex<ids->size());
 
-        if (currentNodeIndex!=target.GetNodeIndex()) {
-          AddNodes(route,
-                   target.GetDatabaseId(),
-                   (*ids)[currentNodeIndex].GetId(),
-                   currentNodeIndex,
-                   target.GetObjectFileRef(),
-                   ids->size(),
-                   oneway,
-                   target.GetNodeIndex());
+        if (!WalkPathsBackward(state,
+                               *current,
+                               query,
+                               search)) {
+          log.Error() << "Failed to walk paths from " << current->id.database << " / " << current->id.id;
+          return result;
         }
 
-        route.AddEntry(target.GetDatabaseId(),
-                       0,
-                       target.GetNodeIndex(),
-                       ObjectFileRef(),
-                       0);
+        if (!WalkToOtherDatabases(state,
+                                  *current,
+                                  current->node,
+                                  search.backwardOpenList,
+                                  search.backwardOpenMap,
+                                  search.backwardClosedSet,
+                                  search.backwardClosedRestrictedSet)) {
+          log.Error() << "Failed to walk to other databases from " << current->id.database << " / " << current->id.id;
+          return result;
+        }
 
-        break;
+        if (current->access) {
+          search.backwardClosedSet.Insert(current->id,
+                                          VNode(current->id,
+                                                current->object,
+                                                current->prev));
+        }
+        else {
+          search.backwardClosedRestrictedSet.Insert(current->id,
+                                                    VNode(current->id,
+                                                          current->object,
+                                                          current->prev));
+        }
+
+        backwardMaxDistance=Distance::Max(backwardMaxDistance,
+                                          overallDistance-GetSphericalDistance(startCoord,
+                                                                               current->node->GetCoord()));
       }
 
-      RouteNodeRef nextNode=routeNodeMap.find(nn->currentNode)->second;
+      current->node=nullptr;
 
-      if (n->currentNode.database!=nn->currentNode.database &&
-          node->GetId()==nextNode->GetId()){
-        // there is no way between database transition nodes
-        continue;
+      result.SetCurrentMaxDistance(Distance::Min(overallDistance,
+                                                 forwardMaxDistance+backwardMaxDistance));
+
+      if (parameter.GetProgress()) {
+        parameter.GetProgress()->Progress(result.GetCurrentMaxDistance(),
+                                          overallDistance);
       }
 
-      assert(nn->object.GetType()==refArea ||
-             nn->object.GetType()==refWay);
+      maxOpenList=std::max(maxOpenList,search.openList.Size()+search.backwardOpenList.Size());
+      maxClosedSet=std::max(maxClosedSet,
+                            search.closedSet.Size()+search.closedRestrictedSet.Size()+
+                            search.backwardClosedSet.Size()+search.backwardClosedRestrictedSet.Size());
+    }
 
-      if (nn->object.GetType()==refArea) {
-        std::unordered_map<DBFileOffset,AreaRef>::const_iterator areaEntry=areaMap
-          .find(DBFileOffset(nn->currentNode.database,nn->object.GetFileOffset()));
+    clock.Stop();
 
-        assert(areaEntry!=areaMap.end());
+    bool found=query.bestCost<std::numeric_limits<double>::infinity();
 
-        ids=&areaEntry->second->rings.front().nodes;
-        oneway=false;
+    if (debugPerformance) {
+      std::cout << "From:                " << startCoord.GetDisplayText() << " " << start.GetObjectFileRef().GetName() << std::endl;
+      std::cout << "To:                  " << targetCoord.GetDisplayText() << " " << target.GetObjectFileRef().GetName() << std::endl;
+      std::cout << "Time (bidir.):       " << clock << std::endl;
+      std::cout << "Air-line distance:   " << std::fixed << std::setprecision(1) << overallDistance.As<Kilometer>() << "km" << std::endl;
+      if (found) {
+        std::cout << "Actual cost:         " << query.bestCost << std::endl;
       }
-      else if (nn->object.GetType()==refWay) {
-        std::unordered_map<DBFileOffset,WayRef>::const_iterator wayEntry=wayMap
-          .find(DBFileOffset(nn->currentNode.database,nn->object.GetFileOffset()));
+      std::cout << "Cost limit:          " << query.costLimit << std::endl;
+      std::cout << "Route nodes loaded:  " << forwardNodesLoadedCount+backwardNodesLoadedCount << " (forward " << forwardNodesLoadedCount << ", backward " << backwardNodesLoadedCount << ")" << std::endl;
+      std::cout << "Route nodes ignored: " << query.nodesIgnoredCount << std::endl;
+      std::cout << "Max. OpenList size:  " << maxOpenList << std::endl;
+      std::cout << "Max. ClosedSet size: " << maxClosedSet << std::endl;
+    }
 
-        assert(wayEntry!=wayMap.end());
+    // Release the route nodes referenced by the RNodes
+    search.openList.Clear();
+    search.backwardOpenList.Clear();
 
-        ids=&wayEntry->second->nodes;
-        oneway=!CanUseBackward(state,wayEntry->first.database,wayEntry->second);
-      }
+    if (!found) {
+      log.Warn() << "No route found!";
 
-      size_t currentNodeIndex=0;
+      return result;
+    }
 
-      while ((*ids)[currentNodeIndex].GetId()!=node->GetId() &&
-          currentNodeIndex<ids->size()) {
-        currentNodeIndex++;
-      }
-      assert(currentNodeIndex<ids->size());
+    if (parameter.GetBreaker() &&
+      parameter.GetBreaker()->IsAborted()) {
+      return result;
+    }
 
-      size_t nextNodeIndex=0;
+    // Route from the start to the meeting node...
+    std::list<VNode> nodes;
 
-      while ((*ids)[nextNodeIndex].GetId()!=nextNode->GetId() &&
-          nextNodeIndex<ids->size()) {
-        nextNodeIndex++;
+    if (query.forwardMeeting.previousNode.IsValid()) {
+      ResolveRNodeChainToList(query.forwardMeeting.previousNode,
+                              search.closedSet,
+                              search.closedRestrictedSet,
+                              nodes);
+    }
+
+    nodes.push_back(query.forwardMeeting);
+
+    // ...and from the meeting node to the target, turning the backward chain around
+    if (query.backwardMeeting.previousNode.IsValid()) {
+      std::list<VNode> backwardNodes;
+      DBId             previousNode=query.backwardMeeting.currentNode;
+      ObjectFileRef    object=query.backwardMeeting.object;
+
+      ResolveRNodeChainToList(query.backwardMeeting.previousNode,
+                              search.backwardClosedSet,
+                              search.backwardClosedRestrictedSet,
+                              backwardNodes);
+
+      for (auto node=backwardNodes.rbegin(); node!=backwardNodes.rend(); ++node) {
+        nodes.push_back(VNode(node->currentNode,
+                              object,
+                              previousNode));
+
+        previousNode=node->currentNode;
+        object=node->object;
       }
-      assert(nextNodeIndex<ids->size());
+    }
 
-      AddNodes(route,
-               nn->currentNode.database,
-               (*ids)[currentNodeIndex].GetId(),
-               currentNodeIndex,
-               nn->object,
-               ids->size(),
-               oneway,
-               nextNodeIndex);
+#if defined(DEBUG_ROUTING)
+    std::cout << "VNode List:" << std::endl;
+    for (const auto& node : nodes) {
+      std::cout << node.object.GetName() << " " << node.currentNode.database << "/" << node.currentNode.id << std::endl;
     }
+#endif
 
-    return true;
+    if (!ResolveRNodesToRouteData(state,
+                                  nodes,
+                                  start,
+                                  target,
+                                  result.GetRoute())) {
+      return result;
+    }
+
+    ResolveRouteDataJunctions(result.GetRoute());
+
+    return result;
+  }
+
+  template <class RoutingState>
+  void AbstractRoutingService<RoutingState>::AddNodes(RouteData& route,
+                                                      DatabaseId database,
+                                                      Id startNodeId,
+                                                      size_t startNodeIndex,
+                                                      const ObjectFileRef& object,
+                                                      size_t idCount,
+                                                      bool oneway,
+                                                      size_t targetNodeIndex)
+  {
+    assert(startNodeIndex<idCount);
+    assert(targetNodeIndex<idCount);
+
+    if (std::max(startNodeIndex,targetNodeIndex)-std::min(startNodeIndex,targetNodeIndex)==1) {
+      // From one node to the neighbour node (+1 or -1)
+      route.AddEntry(database,
+                     startNodeId,
+                     startNodeIndex,
+                     object,
+                     targetNodeIndex);
+    }
+    else if (startNodeIndex<targetNodeIndex) {
+      // Following the way
+      route.AddEntry(database,
+                     startNodeId,
+                     startNodeIndex,
+                     object,
+                     startNodeIndex+1);
+
+      for (size_t i=startNodeIndex+1; i<targetNodeIndex-1; i++) {
+        route.AddEntry(database,
+                       0,
+                       i,
+                       object,
+                       i+1);
+      }
+
+      route.AddEntry(database,
+                     0,
+                     targetNodeIndex-1,
+                     object,
+                     targetNodeIndex);
+    }
+    else if (oneway) {
+      // startNodeIndex>tragetNodeIndex, but this is a oneway we assume
+      // that the way is either an area or is a roundabound
+      // TODO: proof this using the right assertions or checks
+      size_t pos=startNodeIndex+1;
+      size_t next;
+
+      if (pos>=idCount) {
+        pos=0;
+      }
+
+      next=pos+1;
+      if (next>=idCount) {
+        next=0;
+      }
+
+      route.AddEntry(database,
+                     startNodeId,
+                     startNodeIndex,
+                     object,
+                     pos);
+
+      while (next!=targetNodeIndex) {
+        route.AddEntry(database,
+                       0,
+                       pos,
+                       object,
+                       next);
+
+        pos++;
+        if (pos>=idCount) {
+          pos=0;
+        }
+
+        next=pos+1;
+        if (next>=idCount) {
+          next=0;
+        }
+      }
+
+      route.AddEntry(database,
+                     0,
+                     pos,
+                     object,
+                     targetNodeIndex);
+    }
+    else {
+      // We follow the way in the opposite direction
+      route.AddEntry(database,
+                     startNodeId,
+                     startNodeIndex,
+                     object,
+                     startNodeIndex-1);
+
+      for (long i=(long)startNodeIndex-1; i>(long)targetNodeIndex+1; i--) {
+        route.AddEntry(database,
+                       0,
+                       (size_t)i,
+                       object,
+                       (size_t)i-1);
+      }
+
+      route.AddEntry(database,
+                     0,
+                     targetNodeIndex+1,
+                     object,
+                     targetNodeIndex);
+    }
+  }
+
+  template <class RoutingState>
+  bool AbstractRoutingService<RoutingState>::ResolveRNodesToRouteData(const RoutingState& state,
+                                                                      const std::list<VNode>& nodes,
+                                                                      const RoutePosition& start,
+                                                                      const RoutePosition& target,
+                                                                      RouteData& route)
+  {
+    std::set<DBId>                                routeNodeIds;
+    std::set<DBFileOffset>                        wayOffsets;
+    std::set<DBFileOffset>                        areaOffsets;
+
+    std::unordered_map<DBId,RouteNodeRef>         routeNodeMap;
+    std::unordered_map<DBFileOffset,AreaRef>      areaMap;
+    std::unordered_map<DBFileOffset,WayRef>       wayMap;
+
+    std::vector<Point>                            *ids=nullptr;
+    bool                                          oneway=false;
+
+    // Collect all route node file offsets on the path and also
+    // all area/way file offsets on the path
+    for (const auto& node : nodes) {
+      routeNodeIds.insert(node.currentNode);
+      DatabaseId dbId=node.currentNode.database;
+
+      if (node.object.Valid()) {
+        switch (node.object.GetType()) {
+        case refArea:
+          areaOffsets.insert(DBFileOffset(dbId,node.object.GetFileOffset()));
+          break;
+        case refWay:
+          wayOffsets.insert(DBFileOffset(dbId,node.object.GetFileOffset()));
+          break;
+        default:
+          assert(false);
+          break;
+        }
+      }
+    }
+
+    // Collect area/way file offset for the
+    // target object (not traversed by above loop)
+    switch (target.GetObjectFileRef().GetType()) {
+    case refArea:
+      areaOffsets.insert(DBFileOffset(target.GetDatabaseId(),
+                                      target.GetObjectFileRef().GetFileOffset()));
+      break;
+    case refWay:
+      wayOffsets.insert(DBFileOffset(target.GetDatabaseId(),
+                                     target.GetObjectFileRef().GetFileOffset()));
+      break;
+    default:
+      assert(false);
+      break;
+    }
+
+    //
+    // Load data
+    //
+
+    if (!GetRouteNodes(routeNodeIds,
+                       routeNodeMap)) {
+      log.Error() << "Cannot load route nodes";
+      return false;
+    }
+
+    if (!GetAreasByOffset(areaOffsets,
+                          areaMap)) {
+      log.Error() << "Cannot load areas";
+      return false;
+    }
+
+    if (!GetWaysByOffset(wayOffsets,
+                         wayMap)) {
+      log.Error() << "Cannot load ways";
+      return false;
+    }
+
+    assert(start.GetObjectFileRef().GetType()==refArea ||
+           start.GetObjectFileRef().GetType()==refWay);
+
+    if (start.GetObjectFileRef().GetType()==refArea) {
+      std::unordered_map<DBFileOffset,AreaRef>::const_iterator entry=areaMap
+        .find(DBFileOffset(start.GetDatabaseId(),start.GetObjectFileRef().GetFileOffset()));
+
+      assert(entry!=areaMap.end());
+
+      ids=&entry->second->rings.front().nodes;
+      oneway=false;
+    }
+    else if (start.GetObjectFileRef().GetType()==refWay) {
+      std::unordered_map<DBFileOffset,WayRef>::const_iterator entry=wayMap
+        .find(DBFileOffset(start.GetDatabaseId(),start.GetObjectFileRef().GetFileOffset()));
+
+      assert(entry!=wayMap.end());
+
+      ids=&entry->second->nodes;
+      oneway=!CanUseBackward(state,entry->first.database,entry->second);
+    }
+
+    if (nodes.empty()) {
+      // We assume that startNode and targetNode are on the same area/way (with no routing node in between)
+      assert(start.GetObjectFileRef()==target.GetObjectFileRef());
+
+      AddNodes(route,
+               start.GetDatabaseId(),
+               (*ids)[start.GetNodeIndex()].GetId(),
+               start.GetNodeIndex(),
+               start.GetObjectFileRef(),
+               ids->size(),
+               oneway,
+               target.GetNodeIndex());
+
+      route.AddEntry(target.GetDatabaseId(),
+                     0,
+                     target.GetNodeIndex(),
+                     ObjectFileRef(),
+                     0);
+      return true;
+    }
+
+    auto entry=routeNodeMap.find(nodes.front().currentNode);
+    if (entry==routeNodeMap.end()){
+      log.Error() << "Can't found route node " << nodes.front().currentNode.database <<
+        ", " << nodes.front().currentNode.id;
+      return false;
+    }
+    RouteNodeRef initialNode=entry->second;
+
+    //
+    // Add The path from the start node to the first routing node
+    //
+    if ((*ids)[start.GetNodeIndex()].GetId()!=initialNode->GetId()) {
+      size_t routeNodeIndex=0;
+
+      while ((*ids)[routeNodeIndex].GetId()!=initialNode->GetId() &&
+          routeNodeIndex<ids->size()) {
+        routeNodeIndex++;
+      }
+      assert(routeNodeIndex<ids->size());
+
+      // Start node to initial route node
+      AddNodes(route,
+               start.GetDatabaseId(),
+               (*ids)[start.GetNodeIndex()].GetId(),
+               start.GetNodeIndex(),
+               start.GetObjectFileRef(),
+               ids->size(),
+               oneway,
+               routeNodeIndex);
+    }
+
+    //
+    // Walk the routing path from route node to the next route node
+    // and build entries.
+    //
+    for (auto n=nodes.begin();
+        n!=nodes.end();
+        n++) {
+      auto nn=n;
+
+      nn++;
+
+      RouteNodeRef node=routeNodeMap.find(n->currentNode)->second;
+
+      //
+      // The path from the last routing node to the target node and the
+      // target node itself
+      //
+      if (nn==nodes.end()) {
+        assert(target.GetObjectFileRef().GetType()==refArea ||
+               target.GetObjectFileRef().GetType()==refWay);
+
+        if (target.GetObjectFileRef().GetType()==refArea) {
+          std::unordered_map<DBFileOffset,AreaRef>::const_iterator areaEntry=areaMap
+            .find(DBFileOffset(target.GetDatabaseId(),target.GetObjectFileRef().GetFileOffset()));
+
+          assert(areaEntry!=areaMap.end());
+
+          ids=&areaEntry->second->rings.front().nodes;
+          oneway=false;
+        }
+        else if (target.GetObjectFileRef().GetType()==refWay) {
+          std::unordered_map<DBFileOffset,WayRef>::const_iterator wayEntry=wayMap
+            .find(DBFileOffset(target.GetDatabaseId(),target.GetObjectFileRef().GetFileOffset()));
+
+          assert(wayEntry!=wayMap.end());
+
+          ids=&wayEntry->second->nodes;
+          oneway=!CanUseBackward(state,wayEntry->first.database,wayEntry->second);
+        }
+
+        size_t currentNodeIndex=0;
+
+        while ((*ids)[currentNodeIndex].GetId()!=node->GetId() &&
+            currentNodeIndex<ids->size()) {
+          currentNodeIndex++;
+        }
+        assert(currentNodeIndex<ids->size());
+
+        if (currentNodeIndex!=target.GetNodeIndex()) {
+          AddNodes(route,
+                   target.GetDatabaseId(),
+                   (*ids)[currentNodeIndex].GetId(),
+                   currentNodeIndex,
+                   target.GetObjectFileRef(),
+                   ids->size(),
+                   oneway,
+                   target.GetNodeIndex());
+        }
+
+        route.AddEntry(target.GetDatabaseId(),
+                       0,
+                       target.GetNodeIndex(),
+                       ObjectFileRef(),
+                       0);
+
+        break;
+      }
+
+      RouteNodeRef nextNode=routeNodeMap.find(nn->currentNode)->second;
+
+      if (n->currentNode.database!=nn->currentNode.database &&
+          node->GetId()==nextNode->GetId()){
+        // there is no way between database transition nodes
+        continue;
+      }
+
+      assert(nn->object.GetType()==refArea ||
+             nn->object.GetType()==refWay);
+
+      if (nn->object.GetType()==refArea) {
+        std::unordered_map<DBFileOffset,AreaRef>::const_iterator areaEntry=areaMap
+          .find(DBFileOffset(nn->currentNode.database,nn->object.GetFileOffset()));
+
+        assert(areaEntry!=areaMap.end());
+
+        ids=&areaEntry->second->rings.front().nodes;
+        oneway=false;
+      }
+      else if (nn->object.GetType()==refWay) {
+        std::unordered_map<DBFileOffset,WayRef>::const_iterator wayEntry=wayMap
+          .find(DBFileOffset(nn->currentNode.database,nn->object.GetFileOffset()));
+
+        assert(wayEntry!=wayMap.end());
+
+        ids=&wayEntry->second->nodes;
+        oneway=!CanUseBackward(state,wayEntry->first.database,wayEntry->second);
+      }
+
+      size_t currentNodeIndex=0;
+
+      while ((*ids)[currentNodeIndex].GetId()!=node->GetId() &&
+          currentNodeIndex<ids->size()) {
+        currentNodeIndex++;
+      }
+      assert(currentNodeIndex<ids->size());
+
+      size_t nextNodeIndex=0;
+
+      while ((*ids)[nextNodeIndex].GetId()!=nextNode->GetId() &&
+          nextNodeIndex<ids->size()) {
+        nextNodeIndex++;
+      }
+      assert(nextNodeIndex<ids->size());
+
+      AddNodes(route,
+               nn->currentNode.database,
+               (*ids)[currentNodeIndex].GetId(),
+               currentNodeIndex,
+               nn->object,
+               ids->size(),
+               oneway,
+               nextNodeIndex);
+    }
+
+    return true;
+  }
+
+  /**
+   * Resolve the start position of a matrix or reachability calculation to its
+   * start route nodes. The RNodes hold the costs, the length and the travel time
+   * from the start position to the route node.
+   */
+  template <class RoutingState>
+  bool AbstractRoutingService<RoutingState>::GetDijkstraStartNodes(const RoutingState& state,
+                                                                   const RoutePosition& position,
+                                                                   GeoCoord& coord,
+                                                                   std::vector<RNode>& nodes)
+  {
+    RouteNodeRef forwardRouteNode;
+    RouteNodeRef backwardRouteNode;
+    RNodeRef     forwardNode;
+    RNodeRef     backwardNode;
+    WayRef       way;
+
+    if (!GetStartNodes(state,
+                       position,
+                       coord,
+                       coord,
+                       RouteCostBounds(),
+                       forwardRouteNode,
+                       backwardRouteNode,
+                       forwardNode,
+                       backwardNode)) {
+      return false;
+    }
+
+    if (!GetWayByOffset(DBFileOffset(position.GetDatabaseId(),
+                                     position.GetObjectFileRef().GetFileOffset()),
+                        way)) {
+      log.Error() << "Cannot get start way!";
+      return false;
+    }
+
+    for (const auto& startNode : {forwardNode,backwardNode}) {
+      if (!startNode) {
+        continue;
+      }
+
+      RNode node(*startNode);
+
+      node.estimateCost=0.0;
+      node.overallCost=node.currentCost;
+      node.distance=GetSphericalDistance(coord,
+                                         node.node->GetCoord());
+      node.time=GetTime(state,
+                        position.GetDatabaseId(),
+                        way,
+                        node.distance);
+
+      nodes.push_back(node);
+    }
+
+    return true;
+  }
+
+  /**
+   * Resolve the target position of a matrix calculation to its target route nodes
+   * and add them to the query.
+   */
+  template <class RoutingState>
+  bool AbstractRoutingService<RoutingState>::GetMatrixTargetNodes(const RoutingState& state,
+                                                                  const RoutePosition& position,
+                                                                  size_t target,
+                                                                  GeoCoord& coord,
+                                                                  MatrixQuery& query)
+  {
+    RouteNodeRef forwardNode;
+    RouteNodeRef backwardNode;
+    WayRef       way;
+
+    if (!GetTargetNodes(state,
+                        position,
+                        coord,
+                        forwardNode,
+                        backwardNode)) {
+      return false;
+    }
+
+    if (!GetWayByOffset(DBFileOffset(position.GetDatabaseId(),
+                                     position.GetObjectFileRef().GetFileOffset()),
+                        way)) {
+      log.Error() << "Cannot get end way!";
+      return false;
+    }
+
+    for (const auto& targetNode : {forwardNode,backwardNode}) {
+      if (!targetNode) {
+        continue;
+      }
+
+      DBId     id(position.GetDatabaseId(),
+                  targetNode->GetId());
+      Distance distance=GetSphericalDistance(targetNode->GetCoord(),
+                                             coord);
+      auto     entry=query.targetNodeIndex.find(id);
+      size_t   index;
+
+      if (entry!=query.targetNodeIndex.end()) {
+        index=entry->second;
+      }
+      else {
+        index=query.targetNodes.size();
+        query.targetNodeIndex[id]=index;
+        query.targetNodes.emplace_back();
+      }
+
+      query.targetNodes[index].push_back(MatrixTargetNode{target,
+                                                          GetCosts(state,
+                                                                   position.GetDatabaseId(),
+                                                                   way,
+                                                                   distance),
+                                                          distance,
+                                                          GetTime(state,
+                                                                  position.GetDatabaseId(),
+                                                                  way,
+                                                                  distance)});
+    }
+
+    return true;
+  }
+
+  /**
+   * Walk all paths of the current node of a matrix or reachability search. Same as
+   * WalkPaths(), but without an estimate and with calculation of the length and
+   * travel time.
+   */
+  template <class RoutingState>
+  bool AbstractRoutingService<RoutingState>::WalkDijkstraPaths(const RoutingState& state,
+                                                               RNode& current,
+                                                               const Vehicle& vehicle,
+                                                               double costLimit,
+                                                               DijkstraSearch& search)
+  {
+    DatabaseId   dbId=current.id.database;
+    RouteNodeRef currentRouteNode=current.node;
+
+    for (size_t i=0; i<currentRouteNode->paths.size(); i++) {
+      const RouteNode::Path& path=currentRouteNode->paths[i];
+
+      if (path.id==current.prev.id) {
+        continue;
+      }
+
+      if (!current.access &&
+          !path.IsRestricted(vehicle)) {
+        continue;
+      }
+
+      if (!CanUse(state,
+                  dbId,
+                  *currentRouteNode,
+                  i)) {
+        continue;
+      }
+
+      DBId id(dbId,
+              path.id);
+
+      if ((current.access &&
+           search.closedSet.Contains(id)) ||
+          (!current.access &&
+           search.closedRestrictedSet.Contains(id))) {
+        continue;
+      }
+
+      if (!currentRouteNode->CanTurn(current.object,
+                                     currentRouteNode->objects[path.objectIndex].object)) {
+        continue;
+      }
+
+      double currentCost=current.currentCost+GetCosts(state,dbId,*currentRouteNode,i);
+
+      if (currentCost>costLimit) {
+        continue;
+      }
+
+      RNode** openMapEntry=search.openMap.Find(id);
+      RNode*  openEntry=nullptr;
+
+      if (openMapEntry!=nullptr &&
+          search.openList.Contains(*openMapEntry)) {
+        openEntry=*openMapEntry;
+      }
+
+      if (openEntry!=nullptr &&
+          openEntry->currentCost<=currentCost) {
+        continue;
+      }
+
+      Distance distance=current.distance+path.distance;
+      double   time=current.time+GetTime(state,dbId,*currentRouteNode,i);
+
+      if (openEntry!=nullptr) {
+        openEntry->prev=current.id;
+        openEntry->object=currentRouteNode->objects[path.objectIndex].object;
+        openEntry->currentCost=currentCost;
+        openEntry->overallCost=currentCost;
+        openEntry->access=!path.IsRestricted(vehicle);
+        openEntry->distance=distance;
+        openEntry->time=time;
+
+        search.openList.Update(openEntry);
+      }
+      else {
+        RouteNodeRef nextNode;
+
+        {
+          std::lock_guard<std::mutex> guard(routeNodeMutex);
+
+          if (!GetRouteNode(id,
+                            nextNode)) {
+            log.Error() << "Cannot load route node with id " << path.id;
+            return false;
+          }
+        }
+
+        RNode node(id,
+                   nextNode,
+                   currentRouteNode->objects[path.objectIndex].object,
+                   current.id);
+
+        node.currentCost=currentCost;
+        node.overallCost=currentCost;
+        node.access=!path.IsRestricted(vehicle);
+        node.distance=distance;
+        node.time=time;
+
+        search.openMap[node.id]=search.openList.Insert(node);
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Calculate the routes from the given source to all targets of the matrix by a
+   * single Dijkstra search, that stops after all target route nodes have been
+   * reached or the cost limit of the source has been exceeded.
+   */
+  template <class RoutingState>
+  bool AbstractRoutingService<RoutingState>::CalculateMatrixRow(const RoutingState& state,
+                                                                const MatrixQuery& query,
+                                                                size_t source,
+                                                                const RoutingParameter& parameter,
+                                                                DijkstraSearch& search,
+                                                                RoutingMatrix& matrix)
+  {
+    std::vector<bool> reached(query.targetNodes.size(),false);
+    size_t            remaining=query.targetNodes.size();
+    double            costLimit=query.costLimits[source];
+
+    search.openList.Clear();
+    search.openMap.Clear();
+    search.closedSet.Clear();
+    search.closedRestrictedSet.Clear();
+
+    for (const auto& startNode : query.startNodes[source]) {
+      search.openMap[startNode.id]=search.openList.Insert(startNode);
+    }
+
+    while (!search.openList.IsEmpty() &&
+           remaining>0) {
+      if (parameter.GetBreaker() &&
+          parameter.GetBreaker()->IsAborted()) {
+        return false;
+      }
+
+      RNode* current=search.openList.Pop();
+
+      if (current->currentCost>costLimit) {
+        break;
+      }
+
+      auto targetEntry=query.targetNodeIndex.find(current->id);
+
+      if (targetEntry!=query.targetNodeIndex.end()) {
+        if (!reached[targetEntry->second]) {
+          reached[targetEntry->second]=true;
+          remaining--;
+        }
+
+        for (const auto& targetNode : query.targetNodes[targetEntry->second]) {
+          RoutingMatrix::Entry& entry=matrix.Get(source,
+                                                 targetNode.target);
+          double                cost=current->currentCost+targetNode.cost;
+
+          if (!entry.found ||
+              cost<entry.cost) {
+            entry.found=true;
+            entry.cost=cost;
+            entry.distance=current->distance+targetNode.distance;
+            entry.time=current->time+targetNode.time;
+          }
+        }
+      }
+
+      if (!WalkDijkstraPaths(state,
+                             *current,
+                             query.vehicle,
+                             costLimit,
+                             search)) {
+        return false;
+      }
+
+      {
+        std::lock_guard<std::mutex> guard(routeNodeMutex);
+
+        if (!WalkToOtherDatabases(state,
+                                  *current,
+                                  current->node,
+                                  search.openList,
+                                  search.openMap,
+                                  search.closedSet,
+                                  search.closedRestrictedSet)) {
+          return false;
+        }
+      }
+
+      if (current->access) {
+        search.closedSet.Insert(current->id,
+                                VNode(current->id,
+                                      current->object,
+                                      current->prev));
+      }
+      else {
+        search.closedRestrictedSet.Insert(current->id,
+                                          VNode(current->id,
+                                                current->object,
+                                                current->prev));
+      }
+
+      current->node=nullptr;
+    }
+
+    return true;
+  }
+
+  /**
+   * Calculate the costs, the length and the travel time of the cheapest route
+   * from each source to each target ("many-to-many"), without calculating the
+   * routes themselves.
+   *
+   * All positions are resolved to their route nodes only once. Then for each
+   * source a single search is run, that stops after all targets have been reached.
+   * The searches are distributed over RoutingParameter::GetThreadCount() threads,
+   * sharing the route node cache of the router.
+   *
+   * @param state
+   *    State to use
+   * @param sources
+   *    Start positions
+   * @param targets
+   *    Target positions
+   * @param parameter
+   *    Routing parameter
+   * @return
+   *    The matrix, an entry is marked as not found, if there is no route, the
+   *    positions cannot be resolved, or the calculation has been aborted
+   */
+  template <class RoutingState>
+  RoutingMatrix AbstractRoutingService<RoutingState>::CalculateMatrix(RoutingState& state,
+                                                                      const std::vector<RoutePosition>& sources,
+                                                                      const std::vector<RoutePosition>& targets,
+                                                                      const RoutingParameter& parameter)
+  {
+    RoutingMatrix         matrix(sources.size(),
+                                 targets.size());
+    MatrixQuery           query;
+    std::vector<GeoCoord> targetCoords;
+    StopClock             clock;
+
+    query.vehicle=GetVehicle(state);
+
+    for (size_t target=0; target<targets.size(); target++) {
+      GeoCoord coord;
+
+      if (targets[target].IsValid() &&
+          GetMatrixTargetNodes(state,
+                               targets[target],
+                               target,
+                               coord,
+                               query)) {
+        targetCoords.push_back(coord);
+      }
+    }
+
+    query.startNodes.resize(sources.size());
+    query.costLimits.resize(sources.size(),0.0);
+
+    for (size_t source=0; source<sources.size(); source++) {
+      GeoCoord coord;
+
+      if (!sources[source].IsValid() ||
+          !GetDijkstraStartNodes(state,
+                               sources[source],
+                               coord,
+                               query.startNodes[source])) {
+        query.startNodes[source].clear();
+        continue;
+      }
+
+      Distance maxDistance;
+
+      for (const auto& targetCoord : targetCoords) {
+        maxDistance=Distance::Max(maxDistance,
+                                  GetSphericalDistance(coord,
+                                                       targetCoord));
+      }
+
+      query.costLimits[source]=GetCostLimit(state,
+                                            sources[source].GetDatabaseId(),
+                                            maxDistance);
+    }
+
+    size_t threadCount=parameter.GetThreadCount();
+
+    if (threadCount==0) {
+      threadCount=std::max(std::thread::hardware_concurrency(),1u);
+    }
+
+    threadCount=std::max(std::min(threadCount,sources.size()),(size_t)1);
+
+    std::atomic<size_t> nextSource(0);
+
+    auto worker=[&]() {
+      DijkstraSearch search;
+      size_t         source;
+
+      while ((source=nextSource++)<sources.size()) {
+        if (query.startNodes[source].empty()) {
+          continue;
+        }
+
+        if (!CalculateMatrixRow(state,
+                                query,
+                                source,
+                                parameter,
+                                search,
+                                matrix)) {
+          return;
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (size_t i=1; i<threadCount; i++) {
+      threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    // Routes from a position to itself
+    for (size_t source=0; source<sources.size(); source++) {
+      for (size_t target=0; target<targets.size(); target++) {
+        if (!query.startNodes[source].empty() &&
+            sources[source].GetDatabaseId()==targets[target].GetDatabaseId() &&
+            sources[source].GetObjectFileRef()==targets[target].GetObjectFileRef() &&
+            sources[source].GetNodeIndex()==targets[target].GetNodeIndex()) {
+          matrix.Get(source,target)=RoutingMatrix::Entry();
+          matrix.Get(source,target).found=true;
+        }
+      }
+    }
+
+    clock.Stop();
+
+    if (debugPerformance) {
+      std::cout << "Matrix:              " << sources.size() << "x" << targets.size() << ", " << threadCount << " thread(s)" << std::endl;
+      std::cout << "Target route nodes:  " << query.targetNodes.size() << std::endl;
+      std::cout << "Time:                " << clock << std::endl;
+    }
+
+    return matrix;
+  }
+
+  /**
+   * Calculate all route nodes reachable from the start position with costs up to
+   * the given limit ("isochrone"), using a Dijkstra search bounded by the cost
+   * limit. Turn and access restrictions are handled the same way as for
+   * CalculateRoute().
+   *
+   * @param state
+   *    State to use
+   * @param start
+   *    Start position
+   * @param costLimit
+   *    Maximum costs of a route, as defined by the profile (for example hours for
+   *    a FastestPathRoutingProfile)
+   * @param parameter
+   *    Routing parameter, the calculation can be aborted by the Breaker
+   * @return
+   *    The reached route nodes, ordered by increasing costs. The result is not
+   *    successful, if the start position cannot be resolved or the calculation
+   *    has been aborted.
+   */
+  template <class RoutingState>
+  ReachabilityResult AbstractRoutingService<RoutingState>::CalculateReachability(RoutingState& state,
+                                                                                 const RoutePosition& start,
+                                                                                 double costLimit,
+                                                                                 const RoutingParameter& parameter)
+  {
+    ReachabilityResult                   result;
+    DijkstraSearch                       search;
+    std::vector<RNode>                   startNodes;
+    std::unordered_map<DBId,size_t>      nodeIndex;
+    std::unordered_multimap<DBId,size_t> pendingEdges; // Paths from reached nodes to nodes not reached yet
+    GeoCoord                             startCoord;
+    Vehicle                              vehicle=GetVehicle(state);
+    StopClock                            clock;
+
+    result.SetCostLimit(costLimit);
+
+    if (!start.IsValid() ||
+        !GetDijkstraStartNodes(state,
+                               start,
+                               startCoord,
+                               startNodes)) {
+      return result;
+    }
+
+    result.SetStartCoord(startCoord);
+
+    for (const auto& startNode : startNodes) {
+      if (startNode.currentCost<=costLimit) {
+        search.openMap[startNode.id]=search.openList.Insert(startNode);
+      }
+    }
+
+    while (!search.openList.IsEmpty()) {
+      if (parameter.GetBreaker() &&
+          parameter.GetBreaker()->IsAborted()) {
+        return result;
+      }
+
+      RNode* current=search.openList.Pop();
+
+      // A node may be reached a second time via a path with access restrictions
+      if (nodeIndex.find(current->id)==nodeIndex.end()) {
+        auto   prevEntry=nodeIndex.find(current->prev);
+        size_t index=result.GetNodes().size();
+        size_t prev=prevEntry!=nodeIndex.end() ? prevEntry->second : ReachabilityResult::NO_PREV;
+
+        nodeIndex[current->id]=index;
+
+        result.AddNode(ReachabilityResult::Node{current->id,
+                                                prev,
+                                                current->node->GetCoord(),
+                                                current->currentCost,
+                                                current->distance,
+                                                current->time});
+
+        // Collect the paths between reached nodes, that are not part of the tree
+        std::unordered_set<size_t> connected;
+
+        connected.insert(prev);
+
+        for (size_t i=0; i<current->node->paths.size(); i++) {
+          if (!CanUse(state,
+                      current->id.database,
+                      *current->node,
+                      i)) {
+            continue;
+          }
+
+          DBId id(current->id.database,
+                  current->node->paths[i].id);
+          auto other=nodeIndex.find(id);
+
+          if (other==nodeIndex.end()) {
+            pendingEdges.insert(std::make_pair(id,index));
+          }
+          else if (connected.insert(other->second).second) {
+            result.AddEdge(ReachabilityResult::Edge{index,
+                                                    other->second});
+          }
+        }
+
+        auto pending=pendingEdges.equal_range(current->id);
+
+        for (auto entry=pending.first; entry!=pending.second; ++entry) {
+          if (connected.insert(entry->second).second) {
+            result.AddEdge(ReachabilityResult::Edge{entry->second,
+                                                    index});
+          }
+        }
+
+        pendingEdges.erase(pending.first,
+                           pending.second);
+      }
+
+      if (!WalkDijkstraPaths(state,
+                             *current,
+                             vehicle,
+                             costLimit,
+                             search)) {
+        return result;
+      }
+
+      if (!WalkToOtherDatabases(state,
+                                *current,
+                                current->node,
+                                search.openList,
+                                search.openMap,
+                                search.closedSet,
+                                search.closedRestrictedSet)) {
+        return result;
+      }
+
+      if (current->access) {
+        search.closedSet.Insert(current->id,
+                                VNode(current->id,
+                                      current->object,
+                                      current->prev));
+      }
+      else {
+        search.closedRestrictedSet.Insert(current->id,
+                                          VNode(current->id,
+                                                current->object,
+                                                current->prev));
+      }
+
+      current->node=nullptr;
+    }
+
+    result.SetSuccess(true);
+
+    clock.Stop();
+
+    if (debugPerformance) {
+      std::cout << "Reachability:        " << start.GetObjectFileRef().GetName() << "[" << start.GetNodeIndex() << "] " << costLimit << std::endl;
+      std::cout << "Route nodes reached: " << result.GetNodes().size() << std::endl;
+      std::cout << "Time:                " << clock << std::endl;
+    }
+
+    return result;
   }
 
   /**
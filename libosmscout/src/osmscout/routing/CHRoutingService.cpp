@@ -0,0 +1,351 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/routing/CHRoutingService.h>
+
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/Geometry.h>
+#include <osmscout/util/Logger.h>
+#include <osmscout/util/StopClock.h>
+
+namespace osmscout {
+
+  /**
+   * Create a new instance of the routing service.
+   *
+   * @param database
+   *    A valid reference to a database instance
+   * @param parameter
+   *    An instance to the parameter object holding further paramterization
+   * @param filenamebase
+   *    Base name of the router files
+   */
+  CHRoutingService::CHRoutingService(const DatabaseRef& database,
+                                     const RouterParameter& parameter,
+                                     const std::string& filenamebase)
+  : SimpleRoutingService(database,
+                         parameter,
+                         filenamebase),
+    database(database),
+    filenamebase(filenamebase)
+  {
+    // no code
+  }
+
+  CHRoutingService::~CHRoutingService()
+  {
+    // no code
+  }
+
+  /**
+   * Opens the routing service and loads the contraction hierarchies of all
+   * vehicles available.
+   *
+   * @return
+   *    false on error, else true
+   */
+  bool CHRoutingService::Open()
+  {
+    if (!SimpleRoutingService::Open()) {
+      return false;
+    }
+
+    for (Vehicle vehicle : {vehicleFoot, vehicleBicycle, vehicleCar}) {
+      std::string filename=AppendFileToDir(database->GetPath(),
+                                           RoutingService::GetCHFilename(filenamebase,
+                                                                         vehicle));
+
+      if (!ExistsInFilesystem(filename)) {
+        continue;
+      }
+
+      if (!hierarchies[vehicle].Load(filename)) {
+        log.Error() << "Cannot load contraction hierarchy '" << filename << "'";
+        hierarchies.erase(vehicle);
+        continue;
+      }
+
+      log.Debug() << "Loaded contraction hierarchy '" << filename << "', "
+                  << hierarchies[vehicle].GetNodeCount() << " nodes, "
+                  << hierarchies[vehicle].GetEdgeCount() << " edges";
+    }
+
+    if (hierarchies.empty()) {
+      log.Warn() << "No contraction hierarchies found, routing falls back to A*";
+    }
+
+    return true;
+  }
+
+  /**
+   * Close the routing service
+   */
+  void CHRoutingService::Close()
+  {
+    hierarchies.clear();
+
+    SimpleRoutingService::Close();
+  }
+
+  /**
+   * Returns true, if a contraction hierarchy for the given vehicle has been loaded
+   */
+  bool CHRoutingService::HasContractionHierarchy(Vehicle vehicle) const
+  {
+    return hierarchies.find(vehicle)!=hierarchies.end();
+  }
+
+  /**
+   * The hierarchy does not know about turn restrictions, so check the route
+   * against the excludes of the route nodes passed.
+   */
+  bool CHRoutingService::ViolatesTurnRestrictions(const RoutePosition& start,
+                                                  const std::vector<ContractionHierarchy::Step>& steps)
+  {
+    std::set<DBId>                        routeNodeIds;
+    std::unordered_map<DBId,RouteNodeRef> routeNodeMap;
+
+    for (const auto& step : steps) {
+      routeNodeIds.insert(DBId(start.GetDatabaseId(),
+                               step.from));
+    }
+
+    if (!GetRouteNodes(routeNodeIds,
+                       routeNodeMap)) {
+      log.Error() << "Cannot load route nodes";
+      return true;
+    }
+
+    ObjectFileRef incoming=start.GetObjectFileRef();
+
+    for (const auto& step : steps) {
+      auto entry=routeNodeMap.find(DBId(start.GetDatabaseId(),
+                                        step.from));
+
+      if (entry==routeNodeMap.end()) {
+        return true;
+      }
+
+      if (!entry->second->CanTurn(incoming,
+                                  step.object)) {
+        return true;
+      }
+
+      incoming=step.object;
+    }
+
+    return false;
+  }
+
+  /**
+   * Calculate a route using the contraction hierarchy for the vehicle of the
+   * given profile. See the class description for the cases, where the A*
+   * search of SimpleRoutingService is used instead.
+   *
+   * @param profile
+   *    Profile to use
+   * @param start
+   *    Start of the route
+   * @param target
+   *    Target of the route
+   * @param parameter
+   *    A RoutingParamater object
+   * @return
+   *    A RoutingResult object
+   */
+  RoutingResult CHRoutingService::CalculateRoute(RoutingProfile& profile,
+                                                 const RoutePosition& start,
+                                                 const RoutePosition& target,
+                                                 const RoutingParameter& parameter)
+  {
+    auto hierarchy=hierarchies.find(profile.GetVehicle());
+
+    if (hierarchy==hierarchies.end() ||
+        !hierarchy->second.IsCompatible(profile)) {
+      return SimpleRoutingService::CalculateRoute(profile,
+                                                  start,
+                                                  target,
+                                                  parameter);
+    }
+
+    RoutingResult result;
+    StopClock     clock;
+    RouteNodeRef  startForwardRouteNode;
+    RouteNodeRef  startBackwardRouteNode;
+    RNodeRef      startForwardNode;
+    RNodeRef      startBackwardNode;
+    GeoCoord      startCoord;
+    GeoCoord      targetCoord;
+    RouteNodeRef  targetForwardRouteNode;
+    RouteNodeRef  targetBackwardRouteNode;
+
+    if (!GetTargetNodes(profile,
+                        target,
+                        targetCoord,
+                        targetForwardRouteNode,
+                        targetBackwardRouteNode)) {
+      return result;
+    }
+
+    if (!GetStartNodes(profile,
+                       start,
+                       startCoord,
+                       targetCoord,
+                       RouteCostBounds(),
+                       startForwardRouteNode,
+                       startBackwardRouteNode,
+                       startForwardNode,
+                       startBackwardNode)) {
+      return result;
+    }
+
+    if (parameter.GetBreaker() &&
+        parameter.GetBreaker()->IsAborted()) {
+      return result;
+    }
+
+    std::vector<ContractionHierarchy::Terminal> sources;
+    std::vector<ContractionHierarchy::Terminal> targets;
+
+    if (startForwardNode) {
+      sources.push_back(ContractionHierarchy::Terminal{startForwardNode->id.id,
+                                                       startForwardNode->currentCost});
+    }
+
+    if (startBackwardNode) {
+      sources.push_back(ContractionHierarchy::Terminal{startBackwardNode->id.id,
+                                                       startBackwardNode->currentCost});
+    }
+
+    // Like the A* search we do not add costs for the way from the last route node to the target
+    if (targetForwardRouteNode) {
+      targets.push_back(ContractionHierarchy::Terminal{targetForwardRouteNode->GetId(),
+                                                       0.0});
+    }
+
+    if (targetBackwardRouteNode) {
+      targets.push_back(ContractionHierarchy::Terminal{targetBackwardRouteNode->GetId(),
+                                                       0.0});
+    }
+
+    std::vector<ContractionHierarchy::Step> steps;
+    double                                  cost=0.0;
+    size_t                                  settledNodeCount=0;
+    bool                                    found=hierarchy->second.CalculateRoute(sources,
+                                                                                   targets,
+                                                                                   steps,
+                                                                                   cost,
+                                                                                   settledNodeCount);
+
+    clock.Stop();
+
+    Distance overallDistance=GetSphericalDistance(startCoord,
+                                                  targetCoord);
+
+    result.SetOverallDistance(overallDistance);
+    result.SetCurrentMaxDistance(overallDistance);
+
+    if (debugPerformance) {
+      std::cout << "From:                " << startCoord.GetDisplayText() << " " << start.GetObjectFileRef().GetName() << std::endl;
+      std::cout << "To:                  " << targetCoord.GetDisplayText() << " " << target.GetObjectFileRef().GetName() << std::endl;
+      std::cout << "Time (CH):           " << clock << std::endl;
+      std::cout << "Air-line distance:   " << std::fixed << std::setprecision(1) << overallDistance.As<Kilometer>() << "km" << std::endl;
+      if (found) {
+        std::cout << "Actual cost:         " << cost << std::endl;
+      }
+      std::cout << "Route nodes settled: " << settledNodeCount << std::endl;
+      std::cout << "Paths in route:      " << steps.size() << std::endl;
+    }
+
+    if (!found) {
+      log.Info() << "No route found in contraction hierarchy, using A*";
+
+      return SimpleRoutingService::CalculateRoute(profile,
+                                                  start,
+                                                  target,
+                                                  parameter);
+    }
+
+    if (ViolatesTurnRestrictions(start,
+                                 steps)) {
+      log.Info() << "Route of contraction hierarchy violates turn restrictions, using A*";
+
+      return SimpleRoutingService::CalculateRoute(profile,
+                                                  start,
+                                                  target,
+                                                  parameter);
+    }
+
+    Id firstNodeId;
+
+    if (!steps.empty()) {
+      firstNodeId=steps.front().from;
+    }
+    else {
+      // Start and target route node are the same, take the cheapest one
+      double minCost=std::numeric_limits<double>::infinity();
+
+      firstNodeId=sources.front().id;
+
+      for (const auto& source : sources) {
+        for (const auto& targetNode : targets) {
+          if (source.id==targetNode.id &&
+              source.cost+targetNode.cost<minCost) {
+            minCost=source.cost+targetNode.cost;
+            firstNodeId=source.id;
+          }
+        }
+      }
+    }
+
+    std::list<VNode> nodes;
+    DatabaseId       dbId=start.GetDatabaseId();
+
+    nodes.push_back(VNode(DBId(dbId,firstNodeId),
+                          start.GetObjectFileRef(),
+                          DBId()));
+
+    for (const auto& step : steps) {
+      nodes.push_back(VNode(DBId(dbId,step.to),
+                            step.object,
+                            DBId(dbId,step.from)));
+    }
+
+    if (parameter.GetBreaker() &&
+        parameter.GetBreaker()->IsAborted()) {
+      return result;
+    }
+
+    if (!ResolveRNodesToRouteData(profile,
+                                  nodes,
+                                  start,
+                                  target,
+                                  result.GetRoute())) {
+      return result;
+    }
+
+    ResolveRouteDataJunctions(result.GetRoute());
+
+    return result;
+  }
+}
@@ -0,0 +1,491 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/routing/ContractionHierarchy.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/Logger.h>
+
+namespace osmscout {
+
+  const uint32_t ContractionHierarchy::NO_NODE=std::numeric_limits<uint32_t>::max();
+
+  namespace {
+
+    /**
+     * Search state of a node visited in one direction of the query
+     */
+    struct Label
+    {
+      double   cost;
+      uint32_t parent; //!< Node we came from, NO_NODE for start nodes
+      uint32_t edge;   //!< Index of the edge used to get here
+    };
+
+    typedef std::unordered_map<uint32_t,Label>          LabelMap;
+    typedef std::pair<double,uint32_t>                  QueueEntry;
+    typedef std::priority_queue<QueueEntry,
+                                std::vector<QueueEntry>,
+                                std::greater<QueueEntry>> Queue;
+
+    double ReadSpeed(FileScanner& scanner)
+    {
+      uint64_t speedBits;
+      double   speed;
+
+      scanner.Read(speedBits);
+      std::memcpy(&speed,&speedBits,sizeof(speed));
+
+      return speed;
+    }
+
+    void ReadEdges(FileScanner& scanner,
+                   std::vector<uint32_t>& offsets,
+                   std::vector<ContractionHierarchy::Edge>& edges)
+    {
+      uint32_t edgeCount;
+
+      scanner.ReadNumber(edgeCount);
+
+      offsets.push_back((uint32_t)edges.size());
+
+      for (uint32_t i=0; i<edgeCount; i++) {
+        ContractionHierarchy::Edge edge;
+        uint32_t                   middle;
+        uint64_t                   costBits;
+
+        scanner.ReadNumber(edge.target);
+        scanner.ReadNumber(middle);
+
+        if (middle==0) {
+          edge.middle=ContractionHierarchy::NO_NODE;
+          scanner.ReadNumber(edge.object);
+        }
+        else {
+          edge.middle=middle-1;
+          edge.object=0;
+        }
+
+        scanner.Read(costBits);
+        std::memcpy(&edge.cost,&costBits,sizeof(edge.cost));
+
+        edges.push_back(edge);
+      }
+    }
+
+    void Relax(Queue& queue,
+               LabelMap& labels,
+               const std::vector<uint32_t>& offsets,
+               const std::vector<ContractionHierarchy::Edge>& edges,
+               uint32_t node,
+               double cost)
+    {
+      for (uint32_t e=offsets[node]; e<offsets[node+1]; e++) {
+        const ContractionHierarchy::Edge& edge=edges[e];
+        double                            targetCost=cost+edge.cost;
+        auto                              entry=labels.find(edge.target);
+
+        if (entry==labels.end()) {
+          labels.insert(std::make_pair(edge.target,Label{targetCost,node,e}));
+          queue.push(QueueEntry(targetCost,edge.target));
+        }
+        else if (targetCost<entry->second.cost) {
+          entry->second=Label{targetCost,node,e};
+          queue.push(QueueEntry(targetCost,edge.target));
+        }
+      }
+    }
+  }
+
+  ContractionHierarchy::ContractionHierarchy()
+  : maxSpeed(0.0)
+  {
+    // no code
+  }
+
+  /**
+   * Load the hierarchy from the given file. The complete hierarchy is held in memory.
+   *
+   * File format:
+   * - Maximum speed of the vehicle of the profile (raw double value)
+   * - Number of types, followed by the speed of the profile for each type (raw
+   *   double values)
+   * - Number of nodes
+   * - Node ids (sorted, delta encoded)
+   * - Number of objects, followed by the object references
+   * - For each node the up edges followed by the down edges. Each list is
+   *   prefixed by its size, each edge consists of the target node index, the
+   *   index of the middle node+1 (0 for original paths), the object index (only
+   *   for original paths) and the costs (raw double value)
+   */
+  bool ContractionHierarchy::Load(const std::string& filename)
+  {
+    FileScanner scanner;
+
+    Clear();
+
+    this->filename=filename;
+
+    try {
+      uint32_t typeCount;
+      uint32_t nodeCount;
+      uint32_t objectCount;
+      Id       id=0;
+
+      scanner.Open(filename,
+                   FileScanner::Sequential,
+                   true);
+
+      maxSpeed=ReadSpeed(scanner);
+
+      scanner.ReadNumber(typeCount);
+
+      typeSpeeds.resize(typeCount);
+
+      for (auto& speed : typeSpeeds) {
+        speed=ReadSpeed(scanner);
+      }
+
+      scanner.Read(nodeCount);
+
+      nodeIds.reserve(nodeCount);
+
+      for (uint32_t i=0; i<nodeCount; i++) {
+        Id delta;
+
+        scanner.ReadNumber(delta);
+
+        id+=delta;
+        nodeIds.push_back(id);
+      }
+
+      scanner.Read(objectCount);
+
+      objects.resize(objectCount);
+
+      for (auto& object : objects) {
+        scanner.Read(object);
+      }
+
+      upOffsets.reserve(nodeCount+1);
+      downOffsets.reserve(nodeCount+1);
+
+      for (uint32_t i=0; i<nodeCount; i++) {
+        ReadEdges(scanner,
+                  upOffsets,
+                  upEdges);
+        ReadEdges(scanner,
+                  downOffsets,
+                  downEdges);
+      }
+
+      upOffsets.push_back((uint32_t)upEdges.size());
+      downOffsets.push_back((uint32_t)downEdges.size());
+
+      scanner.Close();
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      scanner.CloseFailsafe();
+      Clear();
+
+      return false;
+    }
+
+    return true;
+  }
+
+  void ContractionHierarchy::Clear()
+  {
+    filename.clear();
+    maxSpeed=0.0;
+    typeSpeeds.clear();
+    nodeIds.clear();
+    upOffsets.clear();
+    upEdges.clear();
+    downOffsets.clear();
+    downEdges.clear();
+    objects.clear();
+  }
+
+  /**
+   * Return true, if the given profile has the same costs as the profile used to
+   * calculate the hierarchy, else routes of the hierarchy may not be the
+   * cheapest routes for the profile.
+   */
+  bool ContractionHierarchy::IsCompatible(const RoutingProfile& profile) const
+  {
+    const FastestPathRoutingProfile* fastestProfile=dynamic_cast<const FastestPathRoutingProfile*>(&profile);
+
+    if (fastestProfile==nullptr ||
+        fastestProfile->GetVehicleMaxSpeed()!=maxSpeed) {
+      return false;
+    }
+
+    for (size_t typeIndex=0; typeIndex<typeSpeeds.size(); typeIndex++) {
+      if (fastestProfile->GetTypeSpeed(typeIndex)!=typeSpeeds[typeIndex]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Return the index of the node with the given id or NO_NODE, if the node is
+   * not part of the hierarchy.
+   */
+  uint32_t ContractionHierarchy::GetNodeIndex(Id id) const
+  {
+    auto entry=std::lower_bound(nodeIds.begin(),
+                                nodeIds.end(),
+                                id);
+
+    if (entry==nodeIds.end() ||
+        *entry!=id) {
+      return NO_NODE;
+    }
+
+    return (uint32_t)(entry-nodeIds.begin());
+  }
+
+  bool ContractionHierarchy::FindEdge(const std::vector<uint32_t>& offsets,
+                                      const std::vector<Edge>& edges,
+                                      uint32_t node,
+                                      uint32_t target,
+                                      Edge& edge) const
+  {
+    bool found=false;
+
+    for (uint32_t e=offsets[node]; e<offsets[node+1]; e++) {
+      if (edges[e].target==target &&
+          (!found || edges[e].cost<edge.cost)) {
+        edge=edges[e];
+        found=true;
+      }
+    }
+
+    return found;
+  }
+
+  /**
+   * Append the original paths of the given edge from 'from' to 'to' to the list
+   * of steps. A shortcut via the middle node m is replaced by the edge from 'from'
+   * to m (stored as down edge of m) and the edge from m to 'to' (stored as up edge
+   * of m), recursively.
+   */
+  bool ContractionHierarchy::Unpack(uint32_t from,
+                                    uint32_t to,
+                                    const Edge& edge,
+                                    std::vector<Step>& steps) const
+  {
+    if (edge.middle==NO_NODE) {
+      steps.push_back(Step{nodeIds[from],
+                           nodeIds[to],
+                           objects[edge.object]});
+
+      return true;
+    }
+
+    Edge first;
+    Edge second;
+
+    if (!FindEdge(downOffsets,
+                  downEdges,
+                  edge.middle,
+                  from,
+                  first) ||
+        !FindEdge(upOffsets,
+                  upEdges,
+                  edge.middle,
+                  to,
+                  second)) {
+      log.Error() << "Cannot unpack shortcut " << nodeIds[from] << " => " << nodeIds[to] << " in '" << filename << "'";
+      return false;
+    }
+
+    return Unpack(from,edge.middle,first,steps) &&
+           Unpack(edge.middle,to,second,steps);
+  }
+
+  /**
+   * Calculate the cheapest route from one of the sources to one of the targets.
+   *
+   * @param sources
+   *    Route nodes to start from, with their initial costs
+   * @param targets
+   *    Route nodes to end at, with the costs to get from them to the actual target
+   * @param steps
+   *    The original paths of the route on success, empty if source and target
+   *    are the same route node
+   * @param cost
+   *    Overall costs of the route, including the initial and final costs
+   * @param settledNodeCount
+   *    Number of nodes visited by the search
+   * @return
+   *    True, if a route was found, else false
+   */
+  bool ContractionHierarchy::CalculateRoute(const std::vector<Terminal>& sources,
+                                            const std::vector<Terminal>& targets,
+                                            std::vector<Step>& steps,
+                                            double& cost,
+                                            size_t& settledNodeCount) const
+  {
+    LabelMap forwardLabels;
+    LabelMap backwardLabels;
+    Queue    forwardQueue;
+    Queue    backwardQueue;
+    double   bestCost=std::numeric_limits<double>::infinity();
+    uint32_t meetingNode=NO_NODE;
+
+    steps.clear();
+    settledNodeCount=0;
+
+    for (const auto& source : sources) {
+      uint32_t node=GetNodeIndex(source.id);
+
+      if (node==NO_NODE) {
+        continue;
+      }
+
+      auto entry=forwardLabels.find(node);
+
+      if (entry==forwardLabels.end() ||
+          source.cost<entry->second.cost) {
+        forwardLabels[node]=Label{source.cost,NO_NODE,0};
+        forwardQueue.push(QueueEntry(source.cost,node));
+      }
+    }
+
+    for (const auto& target : targets) {
+      uint32_t node=GetNodeIndex(target.id);
+
+      if (node==NO_NODE) {
+        continue;
+      }
+
+      auto entry=backwardLabels.find(node);
+
+      if (entry==backwardLabels.end() ||
+          target.cost<entry->second.cost) {
+        backwardLabels[node]=Label{target.cost,NO_NODE,0};
+        backwardQueue.push(QueueEntry(target.cost,node));
+      }
+    }
+
+    while (!forwardQueue.empty() ||
+           !backwardQueue.empty()) {
+      double forwardMin=forwardQueue.empty() ? std::numeric_limits<double>::infinity() : forwardQueue.top().first;
+      double backwardMin=backwardQueue.empty() ? std::numeric_limits<double>::infinity() : backwardQueue.top().first;
+
+      // No cheaper route possible in both directions
+      if (std::min(forwardMin,backwardMin)>=bestCost) {
+        break;
+      }
+
+      bool      forward=forwardMin<=backwardMin;
+      Queue&    queue=forward ? forwardQueue : backwardQueue;
+      LabelMap& labels=forward ? forwardLabels : backwardLabels;
+      LabelMap& otherLabels=forward ? backwardLabels : forwardLabels;
+
+      QueueEntry current=queue.top();
+
+      queue.pop();
+
+      // Outdated queue entry
+      if (current.first>labels[current.second].cost) {
+        continue;
+      }
+
+      settledNodeCount++;
+
+      auto other=otherLabels.find(current.second);
+
+      if (other!=otherLabels.end() &&
+          current.first+other->second.cost<bestCost) {
+        bestCost=current.first+other->second.cost;
+        meetingNode=current.second;
+      }
+
+      if (forward) {
+        Relax(queue,
+              labels,
+              upOffsets,
+              upEdges,
+              current.second,
+              current.first);
+      }
+      else {
+        Relax(queue,
+              labels,
+              downOffsets,
+              downEdges,
+              current.second,
+              current.first);
+      }
+    }
+
+    if (meetingNode==NO_NODE) {
+      return false;
+    }
+
+    cost=bestCost;
+
+    // Forward part, collected from the meeting node back to the source
+    std::vector<std::pair<uint32_t,uint32_t>> forwardPath;
+    uint32_t                                  node=meetingNode;
+
+    while (forwardLabels[node].parent!=NO_NODE) {
+      const Label& label=forwardLabels[node];
+
+      forwardPath.emplace_back(label.parent,label.edge);
+      node=label.parent;
+    }
+
+    for (auto entry=forwardPath.rbegin(); entry!=forwardPath.rend(); ++entry) {
+      const Edge& edge=upEdges[entry->second];
+
+      if (!Unpack(entry->first,edge.target,edge,steps)) {
+        return false;
+      }
+    }
+
+    // Backward part, from the meeting node to the target
+    node=meetingNode;
+
+    while (backwardLabels[node].parent!=NO_NODE) {
+      const Label& label=backwardLabels[node];
+
+      if (!Unpack(node,label.parent,downEdges[label.edge],steps)) {
+        return false;
+      }
+
+      node=label.parent;
+    }
+
+    return true;
+  }
+}
@@ -0,0 +1,329 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/routing/CostGrid.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+#include <osmscout/util/Geometry.h>
+
+#include <osmscout/system/Math.h>
+
+namespace osmscout {
+
+  const double CostGrid::UNREACHABLE=std::numeric_limits<double>::infinity();
+
+  namespace {
+
+    /**
+     * Directed edge between two corners of the grid, with the reached cells on
+     * its left side
+     */
+    struct BorderEdge
+    {
+      size_t from;
+      size_t to;
+      int    dx;
+      int    dy;
+      bool   used;
+    };
+  }
+
+  CostGrid::CostGrid()
+  : columns(0),
+    rows(0),
+    cellWidth(0.0),
+    cellHeight(0.0)
+  {
+    // no code
+  }
+
+  CostGrid::CostGrid(const GeoBox& boundingBox,
+                     size_t columns,
+                     size_t rows)
+  : boundingBox(boundingBox),
+    columns(columns),
+    rows(rows),
+    cellWidth(columns>0 ? boundingBox.GetWidth()/columns : 0.0),
+    cellHeight(rows>0 ? boundingBox.GetHeight()/rows : 0.0),
+    costs(columns*rows,UNREACHABLE)
+  {
+    // no code
+  }
+
+  /**
+   * Rasterize the segment, the costs are interpolated linearly between both ends
+   */
+  void CostGrid::AddSegment(const GeoCoord& from,
+                            double fromCost,
+                            const GeoCoord& to,
+                            double toCost)
+  {
+    double x1=(from.GetLon()-boundingBox.GetMinLon())/cellWidth;
+    double y1=(from.GetLat()-boundingBox.GetMinLat())/cellHeight;
+    double x2=(to.GetLon()-boundingBox.GetMinLon())/cellWidth;
+    double y2=(to.GetLat()-boundingBox.GetMinLat())/cellHeight;
+    size_t steps=(size_t)std::ceil(2.0*std::max(std::abs(x2-x1),
+                                                std::abs(y2-y1)))+1;
+
+    for (size_t i=0; i<=steps; i++) {
+      double t=(double)i/steps;
+      double x=x1+(x2-x1)*t;
+      double y=y1+(y2-y1)*t;
+
+      if (x<0.0 || y<0.0 ||
+          x>=columns || y>=rows) {
+        continue;
+      }
+
+      double& cost=costs[(size_t)y*columns+(size_t)x];
+
+      cost=std::min(cost,
+                    fromCost+(toCost-fromCost)*t);
+    }
+  }
+
+  /**
+   * Add the edges of the tree of cheapest routes and all other edges between
+   * reached nodes of the given result to the grid
+   */
+  void CostGrid::Add(const ReachabilityResult& result)
+  {
+    if (columns==0 ||
+        rows==0) {
+      return;
+    }
+
+    const std::vector<ReachabilityResult::Node>& nodes=result.GetNodes();
+
+    for (const auto& node : nodes) {
+      if (node.prev==ReachabilityResult::NO_PREV) {
+        AddSegment(result.GetStartCoord(),
+                   0.0,
+                   node.coord,
+                   node.cost);
+      }
+      else {
+        AddSegment(nodes[node.prev].coord,
+                   nodes[node.prev].cost,
+                   node.coord,
+                   node.cost);
+      }
+    }
+
+    for (const auto& edge : result.GetEdges()) {
+      AddSegment(nodes[edge.from].coord,
+                 nodes[edge.from].cost,
+                 nodes[edge.to].coord,
+                 nodes[edge.to].cost);
+    }
+  }
+
+  /**
+   * Create a grid with cells of (roughly) the given size covering all nodes of the
+   * result and add the result to it.
+   */
+  CostGrid CostGrid::Create(const ReachabilityResult& result,
+                            const Distance& cellSize)
+  {
+    if (!result.Success() ||
+        cellSize.AsMeter()<=0.0) {
+      return CostGrid();
+    }
+
+    double minLat=result.GetStartCoord().GetLat();
+    double maxLat=minLat;
+    double minLon=result.GetStartCoord().GetLon();
+    double maxLon=minLon;
+
+    for (const auto& node : result.GetNodes()) {
+      minLat=std::min(minLat,node.coord.GetLat());
+      maxLat=std::max(maxLat,node.coord.GetLat());
+      minLon=std::min(minLon,node.coord.GetLon());
+      maxLon=std::max(maxLon,node.coord.GetLon());
+    }
+
+    // Length of one degree of latitude, the length of one degree of
+    // longitude depends on the latitude
+    double metersPerDegree=GetSphericalDistance(GeoCoord(0.0,0.0),
+                                                GeoCoord(1.0,0.0)).AsMeter();
+    double cellHeight=cellSize.AsMeter()/metersPerDegree;
+    double cellWidth=cellHeight/std::max(std::cos(((minLat+maxLat)/2.0)*M_PI/180.0),0.01);
+
+    // Keep one unreachable cell at each border
+    size_t columns=(size_t)std::floor((maxLon-minLon)/cellWidth)+3;
+    size_t rows=(size_t)std::floor((maxLat-minLat)/cellHeight)+3;
+
+    CostGrid grid(GeoBox(GeoCoord(minLat-cellHeight,
+                                  minLon-cellWidth),
+                         GeoCoord(minLat+(rows-1)*cellHeight,
+                                  minLon+(columns-1)*cellWidth)),
+                  columns,
+                  rows);
+
+    grid.Add(result);
+
+    return grid;
+  }
+
+  GeoBox CostGrid::GetCellBoundingBox(size_t column,
+                                      size_t row) const
+  {
+    return GeoBox(GeoCoord(boundingBox.GetMinLat()+row*cellHeight,
+                           boundingBox.GetMinLon()+column*cellWidth),
+                  GeoCoord(boundingBox.GetMinLat()+(row+1)*cellHeight,
+                           boundingBox.GetMinLon()+(column+1)*cellWidth));
+  }
+
+  /**
+   * Return the borders of all areas of cells with costs up to the given limit.
+   *
+   * Outer borders are returned counter clockwise, borders of holes clockwise.
+   * Cells touching only at a corner belong to different areas.
+   */
+  std::vector<std::vector<GeoCoord>> CostGrid::GetIsoPolygons(double costLimit) const
+  {
+    std::vector<std::vector<GeoCoord>>             polygons;
+    std::vector<BorderEdge>                        edges;
+    std::unordered_map<size_t,std::vector<size_t>> outgoing;
+    size_t                                         corners=columns+1;
+
+    auto isInside=[this,costLimit](long column, long row) {
+      return column>=0 && row>=0 &&
+             column<(long)columns && row<(long)rows &&
+             GetCost((size_t)column,(size_t)row)<=costLimit;
+    };
+
+    auto addEdge=[&](size_t x, size_t y, int dx, int dy) {
+      size_t from=y*corners+x;
+
+      outgoing[from].push_back(edges.size());
+      edges.push_back(BorderEdge{from,
+                                 (size_t)(((long)y+dy)*(long)corners+(long)x+dx),
+                                 dx,
+                                 dy,
+                                 false});
+    };
+
+    for (size_t row=0; row<rows; row++) {
+      for (size_t column=0; column<columns; column++) {
+        if (!isInside(column,row)) {
+          continue;
+        }
+
+        if (!isInside(column,(long)row-1)) {
+          addEdge(column,row,1,0);
+        }
+
+        if (!isInside(column+1,row)) {
+          addEdge(column+1,row,0,1);
+        }
+
+        if (!isInside(column,row+1)) {
+          addEdge(column+1,row+1,-1,0);
+        }
+
+        if (!isInside((long)column-1,row)) {
+          addEdge(column,row+1,0,-1);
+        }
+      }
+    }
+
+    for (size_t startEdge=0; startEdge<edges.size(); startEdge++) {
+      if (edges[startEdge].used) {
+        continue;
+      }
+
+      std::vector<size_t> ring;
+      size_t              current=startEdge;
+
+      while (true) {
+        edges[current].used=true;
+        ring.push_back(current);
+
+        if (edges[current].to==edges[startEdge].from) {
+          break;
+        }
+
+        // At corners touched by two areas prefer the left turn, then
+        // straight on, to stay at the border of the same area
+        int    leftDx=-edges[current].dy;
+        int    leftDy=edges[current].dx;
+        size_t next=std::numeric_limits<size_t>::max();
+        int    nextRank=3;
+
+        for (size_t candidate : outgoing[edges[current].to]) {
+          if (edges[candidate].used) {
+            continue;
+          }
+
+          int rank;
+
+          if (edges[candidate].dx==leftDx &&
+              edges[candidate].dy==leftDy) {
+            rank=0;
+          }
+          else if (edges[candidate].dx==edges[current].dx &&
+                   edges[candidate].dy==edges[current].dy) {
+            rank=1;
+          }
+          else {
+            rank=2;
+          }
+
+          if (rank<nextRank) {
+            next=candidate;
+            nextRank=rank;
+          }
+        }
+
+        if (next==std::numeric_limits<size_t>::max()) {
+          break;
+        }
+
+        current=next;
+      }
+
+      std::vector<GeoCoord> polygon;
+
+      // Only keep the corners where the direction changes
+      for (size_t i=0; i<ring.size(); i++) {
+        const BorderEdge& edge=edges[ring[i]];
+        const BorderEdge& prev=edges[ring[(i+ring.size()-1)%ring.size()]];
+
+        if (edge.dx==prev.dx &&
+            edge.dy==prev.dy) {
+          continue;
+        }
+
+        polygon.emplace_back(boundingBox.GetMinLat()+(edge.from/corners)*cellHeight,
+                             boundingBox.GetMinLon()+(edge.from%corners)*cellWidth);
+      }
+
+      if (polygon.size()>=3) {
+        polygons.push_back(polygon);
+      }
+    }
+
+    return polygons;
+  }
+}
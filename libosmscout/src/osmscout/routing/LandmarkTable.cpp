@@ -0,0 +1,258 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/routing/LandmarkTable.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/Logger.h>
+
+namespace osmscout {
+
+  const uint32_t LandmarkTable::NO_NODE=std::numeric_limits<uint32_t>::max();
+  const uint32_t LandmarkTable::UNREACHABLE=std::numeric_limits<uint32_t>::max();
+  const double   LandmarkTable::TIME_UNITS_PER_HOUR=3600000.0;
+
+  namespace {
+
+    double ReadDouble(FileScanner& scanner)
+    {
+      uint64_t bits;
+      double   value;
+
+      scanner.Read(bits);
+      std::memcpy(&value,&bits,sizeof(value));
+
+      return value;
+    }
+
+    /**
+     * Update the bound by the difference of both values, if both are valid and
+     * the difference is positive
+     */
+    inline void UpdateBound(uint32_t& bound,
+                            uint32_t larger,
+                            uint32_t smaller)
+    {
+      if (larger!=LandmarkTable::UNREACHABLE &&
+          smaller!=LandmarkTable::UNREACHABLE &&
+          larger>smaller) {
+        bound=std::max(bound,larger-smaller);
+      }
+    }
+  }
+
+  LandmarkTable::LandmarkTable()
+  : referenceVehicleMaxSpeed(0.0)
+  {
+    // no code
+  }
+
+  /**
+   * Load the table from the given file. The complete table is held in memory.
+   *
+   * File format:
+   * - Number of nodes
+   * - Node ids (sorted, delta encoded)
+   * - Number of landmarks, followed by the node index of each landmark
+   * - Reference maximum speed of the vehicle (raw double value)
+   * - Number of reference speeds, followed by type name and speed (raw double value)
+   *   for each type with a speed
+   * - For each node and each landmark the distance from the landmark to the node
+   *   and from the node to the landmark in meters, followed by the travel times
+   *   in TIME_UNITS_PER_HOUR, all +1 (0 if unreachable)
+   */
+  bool LandmarkTable::Load(const TypeConfig& typeConfig,
+                           const std::string& filename)
+  {
+    FileScanner scanner;
+
+    Clear();
+
+    this->filename=filename;
+
+    try {
+      uint32_t nodeCount;
+      uint32_t landmarkCount;
+      uint32_t speedCount;
+      Id       id=0;
+
+      scanner.Open(filename,
+                   FileScanner::Sequential,
+                   true);
+
+      scanner.Read(nodeCount);
+
+      nodeIds.reserve(nodeCount);
+
+      for (uint32_t i=0; i<nodeCount; i++) {
+        Id delta;
+
+        scanner.ReadNumber(delta);
+
+        id+=delta;
+        nodeIds.push_back(id);
+      }
+
+      scanner.Read(landmarkCount);
+
+      landmarks.resize(landmarkCount);
+
+      for (auto& landmark : landmarks) {
+        scanner.ReadNumber(landmark);
+      }
+
+      referenceVehicleMaxSpeed=ReadDouble(scanner);
+      referenceSpeeds.assign(typeConfig.GetTypeCount(),0.0);
+
+      scanner.Read(speedCount);
+
+      for (uint32_t i=0; i<speedCount; i++) {
+        std::string typeName;
+
+        scanner.Read(typeName);
+
+        double      speed=ReadDouble(scanner);
+        TypeInfoRef type=typeConfig.GetTypeInfo(typeName);
+
+        if (type) {
+          referenceSpeeds[type->GetIndex()]=speed;
+        }
+      }
+
+      values.resize((size_t)nodeCount*landmarkCount*4);
+
+      for (auto& value : values) {
+        uint32_t number;
+
+        scanner.ReadNumber(number);
+
+        value=number==0 ? UNREACHABLE : number-1;
+      }
+
+      scanner.Close();
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      scanner.CloseFailsafe();
+      Clear();
+
+      return false;
+    }
+
+    return true;
+  }
+
+  void LandmarkTable::Clear()
+  {
+    filename.clear();
+    nodeIds.clear();
+    landmarks.clear();
+    values.clear();
+    referenceVehicleMaxSpeed=0.0;
+    referenceSpeeds.clear();
+  }
+
+  /**
+   * Return the index of the node with the given id or NO_NODE, if the node is
+   * not part of the table.
+   */
+  uint32_t LandmarkTable::GetNodeIndex(Id id) const
+  {
+    auto entry=std::lower_bound(nodeIds.begin(),
+                                nodeIds.end(),
+                                id);
+
+    if (entry==nodeIds.end() ||
+        *entry!=id) {
+      return NO_NODE;
+    }
+
+    return (uint32_t)(entry-nodeIds.begin());
+  }
+
+  /**
+   * Return the factor the travel times have to be multiplied with to get a lower
+   * bound for the costs of a FastestPathRoutingProfile with the speeds of the given
+   * profile. The costs of a path are its length divided by
+   * min(vehicle max speed, type speed or max speed of the way), so the factor is the
+   * smallest ratio of reference and current speed. If the profile can use a type
+   * not used for the travel times, the factor is 0.
+   */
+  double LandmarkTable::GetTimeFactor(const AbstractRoutingProfile& profile) const
+  {
+    if (profile.GetVehicleMaxSpeed()<=0.0) {
+      return 0.0;
+    }
+
+    double factor=std::min(1.0,
+                           referenceVehicleMaxSpeed/profile.GetVehicleMaxSpeed());
+
+    for (size_t typeIndex=0; typeIndex<referenceSpeeds.size(); typeIndex++) {
+      double speed=profile.GetTypeSpeed(typeIndex);
+
+      if (speed<=0.0) {
+        continue;
+      }
+
+      if (referenceSpeeds[typeIndex]<=0.0) {
+        return 0.0;
+      }
+
+      factor=std::min(factor,
+                      referenceSpeeds[typeIndex]/speed);
+    }
+
+    return factor;
+  }
+
+  /**
+   * Return lower bounds for the length (distance) and the travel time at
+   * reference speeds (time, in hours) of any route from the node 'from' to the
+   * node 'to'. Each is the maximum over all landmarks L of d(L,to)-d(L,from)
+   * and d(from,L)-d(to,L).
+   *
+   * Landmarks not connected with both nodes are ignored. Since values are
+   * rounded down, one unit is subtracted from the result.
+   */
+  void LandmarkTable::GetLowerBounds(uint32_t from,
+                                     uint32_t to,
+                                     Distance& distance,
+                                     double& time) const
+  {
+    size_t          landmarkCount=landmarks.size();
+    const uint32_t* fromValues=&values[(size_t)from*landmarkCount*4];
+    const uint32_t* toValues=&values[(size_t)to*landmarkCount*4];
+    uint32_t        distanceBound=0;
+    uint32_t        timeBound=0;
+
+    for (size_t l=0; l<4*landmarkCount; l+=4) {
+      UpdateBound(distanceBound,toValues[l],fromValues[l]);
+      UpdateBound(distanceBound,fromValues[l+1],toValues[l+1]);
+      UpdateBound(timeBound,toValues[l+2],fromValues[l+2]);
+      UpdateBound(timeBound,fromValues[l+3],toValues[l+3]);
+    }
+
+    distance=distanceBound>1 ? Distance::Of<Meter>(distanceBound-1) : Distance();
+    time=timeBound>1 ? (timeBound-1)/TIME_UNITS_PER_HOUR : 0.0;
+  }
+}
@@ -174,6 +174,15 @@ namespace osmscout {
                                                  pathIndex);
   }
 
+  double MultiDBRoutingService::GetCosts(const MultiDBRoutingState& /*state*/,
+                                         const DatabaseId databaseId,
+                                         const RouteGraph::Edge& edge)
+  {
+    assert(handles.size()>databaseId);
+    return handles[databaseId].profile->GetCosts(handles[databaseId].routingDatabase->GetObjectVariantData()[edge.objectVariantIndex],
+                                                 edge.GetDistance());
+  }
+
   double MultiDBRoutingService::GetCosts(const MultiDBRoutingState& /*state*/,
                                          const DatabaseId database,
                                          const WayRef &way,
@@ -183,6 +192,26 @@ namespace osmscout {
     return handles[database].profile->GetCosts(*way,wayLength);
   }
 
+  double MultiDBRoutingService::GetTime(const MultiDBRoutingState& /*state*/,
+                                        const DatabaseId databaseId,
+                                        const RouteNode& routeNode,
+                                        size_t pathIndex)
+  {
+    assert(handles.size()>databaseId);
+    return handles[databaseId].profile->GetTime(routeNode,
+                                                handles[databaseId].routingDatabase->GetObjectVariantData(),
+                                                pathIndex);
+  }
+
+  double MultiDBRoutingService::GetTime(const MultiDBRoutingState& /*state*/,
+                                        const DatabaseId database,
+                                        const WayRef &way,
+                                        const Distance &wayLength)
+  {
+    assert(handles.size()>database);
+    return handles[database].profile->GetTime(*way,wayLength);
+  }
+
   double MultiDBRoutingService::GetEstimateCosts(const MultiDBRoutingState& /*state*/,
                                                  const DatabaseId database,
                                                  const Distance &targetDistance)
@@ -200,6 +229,53 @@ namespace osmscout {
     return profile->GetCosts(profile->GetCostLimitDistance()) + profile->GetCosts(targetDistance) * profile->GetCostLimitFactor();
   }
 
+  void MultiDBRoutingService::PrepareRouteCostBounds(const MultiDBRoutingState& /*state*/,
+                                                     RouteCostBounds& bounds)
+  {
+    bounds.landmarks.clear();
+
+    for (const auto& handle : handles) {
+      bounds.landmarks.push_back(handle.router->GetLandmarkCostBounds(*handle.profile));
+    }
+  }
+
+  /**
+   * Landmark distances are only available within one database
+   */
+  double MultiDBRoutingService::GetRouteCostBound(const MultiDBRoutingState& /*state*/,
+                                                  const RouteCostBounds& bounds,
+                                                  const DBId& from,
+                                                  const DBId& to)
+  {
+    if (from.database!=to.database ||
+        from.database>=bounds.landmarks.size()) {
+      return 0.0;
+    }
+
+    assert(handles.size()>from.database);
+    return handles[from.database].router->GetLandmarkCostBound(*handles[from.database].profile,
+                                                               bounds.landmarks[from.database],
+                                                               from.id,
+                                                               to.id);
+  }
+
+  /**
+   * Routes across databases need the route node twins of all databases, so the
+   * compact routing graph is not used.
+   */
+  const RouteGraph* MultiDBRoutingService::GetRouteGraph(const MultiDBRoutingState& /*state*/,
+                                                         DatabaseId /*database*/)
+  {
+    return nullptr;
+  }
+
+  const RoutePredecessorTable* MultiDBRoutingService::GetRoutePredecessors(const MultiDBRoutingState& /*state*/,
+                                                                           DatabaseId database)
+  {
+    assert(handles.size()>database);
+    return handles[database].router->GetRoutePredecessorTable();
+  }
+
   bool MultiDBRoutingService::CanUse(const MultiDBRoutingState& /*state*/,
                                      const DatabaseId databaseId,
                                      const RouteNode& routeNode,
@@ -211,6 +287,14 @@ namespace osmscout {
                                                pathIndex);
   }
 
+  bool MultiDBRoutingService::CanUse(const MultiDBRoutingState& /*state*/,
+                                     const DatabaseId databaseId,
+                                     const RouteGraph::Edge& edge)
+  {
+    return handles[databaseId].profile->CanUse(edge.flags,
+                                               handles[databaseId].routingDatabase->GetObjectVariantData()[edge.objectVariantIndex]);
+  }
+
   bool MultiDBRoutingService::GetRouteNodes(const std::set<DBId> &routeNodeIds,
                                             std::unordered_map<DBId,RouteNodeRef> &routeNodeMap)
   {
@@ -453,6 +537,86 @@ namespace osmscout {
       return result;
     }
 
+  /**
+   * Calculate the costs, the length and the travel time of the cheapest route
+   * from each source to each target, see AbstractRoutingService::CalculateMatrix().
+   * If all positions are in the same database, the matrix is calculated by the
+   * router of this database.
+   */
+  RoutingMatrix MultiDBRoutingService::CalculateMatrix(const std::vector<RoutePosition>& sources,
+                                                       const std::vector<RoutePosition>& targets,
+                                                       const RoutingParameter& parameter)
+  {
+    std::set<DatabaseId> databases;
+
+    for (const auto& position : sources) {
+      if (position.IsValid()) {
+        databases.insert(position.GetDatabaseId());
+      }
+    }
+
+    for (const auto& position : targets) {
+      if (position.IsValid()) {
+        databases.insert(position.GetDatabaseId());
+      }
+    }
+
+    for (DatabaseId dbId : databases) {
+      if (dbId>=handles.size() ||
+          !handles[dbId].database) {
+        log.Error() << "Can't find database " << dbId;
+        return RoutingMatrix(sources.size(),
+                             targets.size());
+      }
+    }
+
+    if (databases.empty()) {
+      return RoutingMatrix(sources.size(),
+                           targets.size());
+    }
+
+    if (databases.size()==1) {
+      DatabaseId dbId=*databases.begin();
+
+      return handles[dbId].router->CalculateMatrix(*handles[dbId].profile,
+                                                   sources,
+                                                   targets,
+                                                   parameter);
+    }
+
+    MultiDBRoutingState state;
+    return AbstractRoutingService<MultiDBRoutingState>::CalculateMatrix(state,
+                                                                        sources,
+                                                                        targets,
+                                                                        parameter);
+  }
+
+  /**
+   * Calculate all route nodes reachable from the start position with costs up to
+   * the given limit, see AbstractRoutingService::CalculateReachability(). The
+   * search continues into other databases.
+   */
+  ReachabilityResult MultiDBRoutingService::CalculateReachability(const RoutePosition& start,
+                                                                  double costLimit,
+                                                                  const RoutingParameter& parameter)
+  {
+    if (!start.IsValid()) {
+      return ReachabilityResult();
+    }
+
+    if (start.GetDatabaseId()>=handles.size() ||
+        !handles[start.GetDatabaseId()].database) {
+      log.Error() << "Can't find database " << start.GetDatabaseId();
+      return ReachabilityResult();
+    }
+
+    MultiDBRoutingState state;
+    return AbstractRoutingService<MultiDBRoutingState>::CalculateReachability(state,
+                                                                              start,
+                                                                              costLimit,
+                                                                              parameter);
+  }
+
   bool MultiDBRoutingService::PostProcessRouteDescription(RouteDescription &description,
                                                           const std::list<RoutePostprocessor::PostprocessorRef> &postprocessors)
   {
@@ -0,0 +1,270 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/routing/RouteGraph.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <osmscout/util/Logger.h>
+
+namespace osmscout {
+
+  const uint32_t RouteGraph::NO_NODE=std::numeric_limits<uint32_t>::max();
+  const uint32_t RouteGraph::NO_OBJECT=std::numeric_limits<uint32_t>::max();
+  const size_t   RouteGraph::HEADER_SIZE=4*sizeof(uint32_t);
+
+  static_assert(sizeof(RouteGraph::Edge)==16,"RouteGraph::Edge must match the file layout");
+  static_assert(sizeof(RouteGraph::Exclude)==8,"RouteGraph::Exclude must match the file layout");
+
+  namespace {
+
+    inline size_t Pad(size_t bytes)
+    {
+      return (bytes+7)/8*8;
+    }
+  }
+
+  RouteGraph::RouteGraph()
+  : nodeCount(0),
+    edgeCount(0),
+    excludeCount(0),
+    objectCount(0),
+    nodeIds(nullptr),
+    edgeOffsets(nullptr),
+    edges(nullptr),
+    excludeOffsets(nullptr),
+    excludes(nullptr),
+    objects(nullptr)
+  {
+    // no code
+  }
+
+  RouteGraph::~RouteGraph()
+  {
+    Close();
+  }
+
+  bool RouteGraph::IsLittleEndian()
+  {
+    const uint16_t value=1;
+
+    return *reinterpret_cast<const uint8_t*>(&value)==1;
+  }
+
+  /**
+   * Open the graph. If memoryMapped is true and the file can be mapped, the graph
+   * is accessed in place, else it is completely loaded into memory.
+   */
+  bool RouteGraph::Open(const std::string& filename,
+                        bool memoryMapped)
+  {
+    Close();
+
+    this->filename=filename;
+
+    try {
+      scanner.Open(filename,
+                   FileScanner::FastRandom,
+                   memoryMapped);
+
+      scanner.Read(nodeCount);
+      scanner.Read(edgeCount);
+      scanner.Read(excludeCount);
+      scanner.Read(objectCount);
+
+      size_t nodeIdBytes=Pad(nodeCount*sizeof(Id));
+      size_t edgeOffsetBytes=Pad((nodeCount+1)*sizeof(uint32_t));
+      size_t edgeBytes=Pad(edgeCount*sizeof(Edge));
+      size_t excludeOffsetBytes=Pad((nodeCount+1)*sizeof(uint32_t));
+      size_t excludeBytes=Pad(excludeCount*sizeof(Exclude));
+      size_t objectBytes=Pad(objectCount*sizeof(uint64_t));
+
+      FileOffset nodeIdOffset=HEADER_SIZE;
+      FileOffset edgeOffsetOffset=nodeIdOffset+nodeIdBytes;
+      FileOffset edgeOffset=edgeOffsetOffset+edgeOffsetBytes;
+      FileOffset excludeOffsetOffset=edgeOffset+edgeBytes;
+      FileOffset excludeOffset=excludeOffsetOffset+excludeOffsetBytes;
+      FileOffset objectOffset=excludeOffset+excludeBytes;
+
+      if (scanner.IsMemoryMapped() &&
+          IsLittleEndian()) {
+        nodeIds=reinterpret_cast<const Id*>(scanner.GetMappedData(nodeIdOffset,
+                                                                  nodeIdBytes));
+        edgeOffsets=reinterpret_cast<const uint32_t*>(scanner.GetMappedData(edgeOffsetOffset,
+                                                                            edgeOffsetBytes));
+        edges=reinterpret_cast<const Edge*>(scanner.GetMappedData(edgeOffset,
+                                                                  edgeBytes));
+        excludeOffsets=reinterpret_cast<const uint32_t*>(scanner.GetMappedData(excludeOffsetOffset,
+                                                                               excludeOffsetBytes));
+        excludes=reinterpret_cast<const Exclude*>(scanner.GetMappedData(excludeOffset,
+                                                                        excludeBytes));
+        objects=reinterpret_cast<const uint64_t*>(scanner.GetMappedData(objectOffset,
+                                                                        objectBytes));
+      }
+      else {
+        nodeIdData.resize(nodeCount);
+        edgeOffsetData.resize(nodeCount+1);
+        edgeData.resize(edgeCount);
+        excludeOffsetData.resize(nodeCount+1);
+        excludeData.resize(excludeCount);
+        objectData.resize(objectCount);
+
+        scanner.SetPos(nodeIdOffset);
+
+        for (auto& id : nodeIdData) {
+          scanner.Read(id);
+        }
+
+        scanner.SetPos(edgeOffsetOffset);
+
+        for (auto& offset : edgeOffsetData) {
+          scanner.Read(offset);
+        }
+
+        scanner.SetPos(edgeOffset);
+
+        for (auto& edge : edgeData) {
+          scanner.Read(edge.target);
+          scanner.Read(edge.distance);
+          scanner.Read(edge.object);
+          scanner.Read(edge.objectVariantIndex);
+          scanner.Read(edge.flags);
+          scanner.Read(edge.reserved);
+        }
+
+        scanner.SetPos(excludeOffsetOffset);
+
+        for (auto& offset : excludeOffsetData) {
+          scanner.Read(offset);
+        }
+
+        scanner.SetPos(excludeOffset);
+
+        for (auto& exclude : excludeData) {
+          scanner.Read(exclude.source);
+          scanner.Read(exclude.edge);
+        }
+
+        scanner.SetPos(objectOffset);
+
+        for (auto& object : objectData) {
+          scanner.Read(object);
+        }
+
+        scanner.Close();
+
+        nodeIds=nodeIdData.data();
+        edgeOffsets=edgeOffsetData.data();
+        edges=edgeData.data();
+        excludeOffsets=excludeOffsetData.data();
+        excludes=excludeData.data();
+        objects=objectData.data();
+      }
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      scanner.CloseFailsafe();
+      Close();
+
+      return false;
+    }
+
+    return true;
+  }
+
+  void RouteGraph::Close()
+  {
+    nodeIds=nullptr;
+    edgeOffsets=nullptr;
+    edges=nullptr;
+    excludeOffsets=nullptr;
+    excludes=nullptr;
+    objects=nullptr;
+
+    nodeCount=0;
+    edgeCount=0;
+    excludeCount=0;
+    objectCount=0;
+
+    nodeIdData.clear();
+    edgeOffsetData.clear();
+    edgeData.clear();
+    excludeOffsetData.clear();
+    excludeData.clear();
+    objectData.clear();
+
+    try {
+      if (scanner.IsOpen()) {
+        scanner.Close();
+      }
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      scanner.CloseFailsafe();
+    }
+  }
+
+  /**
+   * Return the index of the node with the given id, or NO_NODE if the node is not
+   * part of the graph
+   */
+  uint32_t RouteGraph::GetNodeIndex(Id id) const
+  {
+    const Id* end=nodeIds+nodeCount;
+    const Id* entry=std::lower_bound(nodeIds,
+                                     end,
+                                     id);
+
+    if (entry==end ||
+        *entry!=id) {
+      return NO_NODE;
+    }
+
+    return (uint32_t)(entry-nodeIds);
+  }
+
+  /**
+   * Return the index of the given object, or NO_OBJECT if the object is not
+   * referenced by the graph
+   */
+  uint32_t RouteGraph::GetObjectIndex(const ObjectFileRef& object) const
+  {
+    uint64_t        value=EncodeObject(object);
+    const uint64_t* end=objects+objectCount;
+    const uint64_t* entry=std::lower_bound(objects,
+                                           end,
+                                           value);
+
+    if (entry==end ||
+        *entry!=value) {
+      return NO_OBJECT;
+    }
+
+    return (uint32_t)(entry-objects);
+  }
+
+  /**
+   * Return the value an object reference is stored as
+   */
+  uint64_t RouteGraph::EncodeObject(const ObjectFileRef& object)
+  {
+    return (object.GetFileOffset() << 2)+(uint64_t)object.GetType();
+  }
+}
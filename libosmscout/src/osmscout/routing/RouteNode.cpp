@@ -94,6 +94,23 @@ namespace osmscout {
     return (uint8_t)index;
   }
 
+  /**
+   * Return false, if a turn restriction forbids to leave this route node via the
+   * target object, if the route node was reached via the source object.
+   */
+  bool RouteNode::CanTurn(const ObjectFileRef& source,
+                          const ObjectFileRef& target) const
+  {
+    for (const auto& exclude : excludes) {
+      if (exclude.source==source &&
+          objects[paths[exclude.targetIndex].objectIndex].object==target) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
 
   /**
    * Read data from the given FileScanner
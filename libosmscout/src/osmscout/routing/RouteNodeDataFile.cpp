@@ -181,7 +181,8 @@ namespace osmscout {
                               RouteNodeRef& node) const
   {
     //std::cout << "Loading RouteNode " << id << "..." << std::endl;
-    ValueCache::CacheRef cacheRef;
+    std::lock_guard<std::mutex> lock(accessMutex);
+    ValueCache::CacheRef        cacheRef;
 
     GeoCoord coord=Point::GetCoordFromId(id);
     TileId   tile=TileId::GetTile(magnification,coord);
@@ -0,0 +1,135 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/routing/RoutePredecessorTable.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/Logger.h>
+
+namespace osmscout {
+
+  const uint32_t RoutePredecessorTable::NO_NODE=std::numeric_limits<uint32_t>::max();
+
+  RoutePredecessorTable::RoutePredecessorTable()
+  {
+    // no code
+  }
+
+  /**
+   * Load the table from the given file. The complete table is held in memory.
+   *
+   * File format:
+   * - Number of nodes
+   * - For each node (sorted by id):
+   *   - Node id (delta encoded)
+   *   - Number of predecessors
+   *   - For each predecessor (sorted by id) the id of the predecessor (delta
+   *     encoded, starting with 0 for each node) and the index of its path to
+   *     the node (uint8_t)
+   */
+  bool RoutePredecessorTable::Load(const std::string& filename)
+  {
+    FileScanner scanner;
+
+    Clear();
+
+    this->filename=filename;
+
+    try {
+      uint32_t nodeCount;
+      Id       id=0;
+
+      scanner.Open(filename,
+                   FileScanner::Sequential,
+                   true);
+
+      scanner.Read(nodeCount);
+
+      nodeIds.reserve(nodeCount);
+      offsets.reserve(nodeCount+1);
+
+      for (uint32_t i=0; i<nodeCount; i++) {
+        Id       delta;
+        uint32_t predecessorCount;
+        Id       predecessorId=0;
+
+        scanner.ReadNumber(delta);
+        scanner.ReadNumber(predecessorCount);
+
+        id+=delta;
+        nodeIds.push_back(id);
+        offsets.push_back((uint32_t)predecessors.size());
+
+        for (uint32_t p=0; p<predecessorCount; p++) {
+          Predecessor predecessor;
+
+          scanner.ReadNumber(delta);
+          scanner.Read(predecessor.pathIndex);
+
+          predecessorId+=delta;
+          predecessor.id=predecessorId;
+
+          predecessors.push_back(predecessor);
+        }
+      }
+
+      offsets.push_back((uint32_t)predecessors.size());
+
+      scanner.Close();
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      scanner.CloseFailsafe();
+      Clear();
+
+      return false;
+    }
+
+    return true;
+  }
+
+  void RoutePredecessorTable::Clear()
+  {
+    filename.clear();
+    nodeIds.clear();
+    offsets.clear();
+    predecessors.clear();
+  }
+
+  /**
+   * Return the index of the node with the given id or NO_NODE, if the node is
+   * not part of the table (because no path leads to it).
+   */
+  uint32_t RoutePredecessorTable::GetNodeIndex(Id id) const
+  {
+    auto entry=std::lower_bound(nodeIds.begin(),
+                                nodeIds.end(),
+                                id);
+
+    if (entry==nodeIds.end() ||
+        *entry!=id) {
+      return NO_NODE;
+    }
+
+    return (uint32_t)(entry-nodeIds.begin());
+  }
+}
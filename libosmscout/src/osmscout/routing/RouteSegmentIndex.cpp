@@ -0,0 +1,444 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/routing/RouteSegmentIndex.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <osmscout/util/Geometry.h>
+#include <osmscout/util/Logger.h>
+
+namespace osmscout {
+
+  const size_t RouteSegmentIndex::HEADER_SIZE=4*sizeof(uint32_t);
+  const double RouteSegmentIndex::COORD_RESOLUTION=1.0/10000000.0;
+
+  static_assert(sizeof(RouteSegmentIndex::Segment)==32,"RouteSegmentIndex::Segment must match the file layout");
+
+  namespace {
+
+    //! Length of one degree latitude on a sphere of the mean earth radius, in meter
+    const double METERS_PER_DEGREE=111194.93;
+
+    inline size_t Pad(size_t bytes)
+    {
+      return (bytes+7)/8*8;
+    }
+
+    /**
+     * Segment within the search radius, the distances are approximated by
+     * projecting the coordinates onto a plane at the search center
+     */
+    struct Candidate
+    {
+      double   distance;
+      double   fraction;
+      uint32_t segment;
+    };
+  }
+
+  RouteSegmentIndex::RouteSegmentIndex()
+  : segmentCount(0),
+    cellCount(0),
+    entryCount(0),
+    cellSize(0.0),
+    segments(nullptr),
+    cellKeys(nullptr),
+    entryOffsets(nullptr),
+    entries(nullptr)
+  {
+    // no code
+  }
+
+  RouteSegmentIndex::~RouteSegmentIndex()
+  {
+    Close();
+  }
+
+  bool RouteSegmentIndex::IsLittleEndian()
+  {
+    const uint16_t value=1;
+
+    return *reinterpret_cast<const uint8_t*>(&value)==1;
+  }
+
+  /**
+   * Open the index. If memoryMapped is true and the file can be mapped, the index
+   * is accessed in place, else it is completely loaded into memory.
+   */
+  bool RouteSegmentIndex::Open(const std::string& filename,
+                               bool memoryMapped)
+  {
+    Close();
+
+    this->filename=filename;
+
+    try {
+      uint32_t cellSizeValue;
+
+      scanner.Open(filename,
+                   FileScanner::FastRandom,
+                   memoryMapped);
+
+      scanner.Read(segmentCount);
+      scanner.Read(cellCount);
+      scanner.Read(entryCount);
+      scanner.Read(cellSizeValue);
+
+      cellSize=cellSizeValue*COORD_RESOLUTION;
+
+      if (cellSizeValue==0) {
+        throw IOException(filename,"Cannot open file","Invalid cell size");
+      }
+
+      size_t segmentBytes=Pad(segmentCount*sizeof(Segment));
+      size_t cellKeyBytes=Pad(cellCount*sizeof(uint64_t));
+      size_t entryOffsetBytes=Pad((cellCount+1)*sizeof(uint32_t));
+      size_t entryBytes=Pad(entryCount*sizeof(uint32_t));
+
+      FileOffset segmentOffset=HEADER_SIZE;
+      FileOffset cellKeyOffset=segmentOffset+segmentBytes;
+      FileOffset entryOffsetOffset=cellKeyOffset+cellKeyBytes;
+      FileOffset entryOffset=entryOffsetOffset+entryOffsetBytes;
+
+      if (scanner.IsMemoryMapped() &&
+          IsLittleEndian()) {
+        segments=reinterpret_cast<const Segment*>(scanner.GetMappedData(segmentOffset,
+                                                                        segmentBytes));
+        cellKeys=reinterpret_cast<const uint64_t*>(scanner.GetMappedData(cellKeyOffset,
+                                                                         cellKeyBytes));
+        entryOffsets=reinterpret_cast<const uint32_t*>(scanner.GetMappedData(entryOffsetOffset,
+                                                                             entryOffsetBytes));
+        entries=reinterpret_cast<const uint32_t*>(scanner.GetMappedData(entryOffset,
+                                                                        entryBytes));
+      }
+      else {
+        segmentData.resize(segmentCount);
+        cellKeyData.resize(cellCount);
+        entryOffsetData.resize(cellCount+1);
+        entryData.resize(entryCount);
+
+        scanner.SetPos(segmentOffset);
+
+        for (auto& segment : segmentData) {
+          scanner.Read(segment.lat[0]);
+          scanner.Read(segment.lat[1]);
+          scanner.Read(segment.lon[0]);
+          scanner.Read(segment.lon[1]);
+          scanner.Read(segment.object);
+          scanner.Read(segment.nodeIndex);
+          scanner.Read(segment.type);
+          scanner.Read(segment.flags);
+          scanner.Read(segment.reserved);
+        }
+
+        scanner.SetPos(cellKeyOffset);
+
+        for (auto& key : cellKeyData) {
+          scanner.Read(key);
+        }
+
+        scanner.SetPos(entryOffsetOffset);
+
+        for (auto& offset : entryOffsetData) {
+          scanner.Read(offset);
+        }
+
+        scanner.SetPos(entryOffset);
+
+        for (auto& entry : entryData) {
+          scanner.Read(entry);
+        }
+
+        scanner.Close();
+
+        segments=segmentData.data();
+        cellKeys=cellKeyData.data();
+        entryOffsets=entryOffsetData.data();
+        entries=entryData.data();
+      }
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      scanner.CloseFailsafe();
+      Close();
+
+      return false;
+    }
+
+    return true;
+  }
+
+  void RouteSegmentIndex::Close()
+  {
+    segments=nullptr;
+    cellKeys=nullptr;
+    entryOffsets=nullptr;
+    entries=nullptr;
+
+    segmentCount=0;
+    cellCount=0;
+    entryCount=0;
+    cellSize=0.0;
+
+    segmentData.clear();
+    cellKeyData.clear();
+    entryOffsetData.clear();
+    entryData.clear();
+
+    try {
+      if (scanner.IsOpen()) {
+        scanner.Close();
+      }
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      scanner.CloseFailsafe();
+    }
+  }
+
+  /**
+   * Return the range of entries of the given cell, false if the cell does not
+   * reference any segment
+   */
+  bool RouteSegmentIndex::GetCellEntries(int64_t row,
+                                         int64_t column,
+                                         uint32_t& begin,
+                                         uint32_t& end) const
+  {
+    if (row<0 ||
+        column<0) {
+      return false;
+    }
+
+    uint64_t        key=GetCellKey(row,column);
+    const uint64_t* last=cellKeys+cellCount;
+    const uint64_t* cell=std::lower_bound(cellKeys,
+                                          last,
+                                          key);
+
+    if (cell==last ||
+        *cell!=key) {
+      return false;
+    }
+
+    begin=entryOffsets[cell-cellKeys];
+    end=entryOffsets[cell-cellKeys+1];
+
+    return true;
+  }
+
+  /**
+   * Return the objects closest to the given coordinate, ordered by increasing
+   * distance, each with its closest segment.
+   *
+   * The cells are visited in rings of growing size around the cell of the
+   * search center. The search stops as soon as maxCount objects have been found,
+   * that are closer than any segment in the cells not visited yet, or if the
+   * remaining cells are outside of the search radius.
+   *
+   * @param coord
+   *    Center of the search
+   * @param maxRadius
+   *    Maximum distance of the objects
+   * @param maxCount
+   *    Maximum number of objects to return
+   * @param filter
+   *    Only segments, the filter returns true for, are considered
+   * @return
+   *    Up to maxCount objects, the closest object first
+   */
+  std::vector<RouteSegmentIndex::Match> RouteSegmentIndex::GetClosestObjects(const GeoCoord& coord,
+                                                                             const Distance& maxRadius,
+                                                                             size_t maxCount,
+                                                                             const SegmentFilter& filter) const
+  {
+    std::vector<Match> matches;
+
+    if (!IsOpen() ||
+        maxCount==0) {
+      return matches;
+    }
+
+    double                 lat=coord.GetLat();
+    double                 lon=coord.GetLon();
+    double                 lonFactor=std::cos(DegToRad(lat))*METERS_PER_DEGREE;
+    double                 radius=maxRadius.As<Meter>();
+    int64_t                centerRow=GetCellRow(lat,cellSize);
+    int64_t                centerColumn=GetCellColumn(lon,cellSize);
+    double                 latCellMeters=cellSize*METERS_PER_DEGREE;
+    std::vector<Candidate> candidates;
+    std::vector<uint64_t>  objects;
+
+    auto visitCell=[&](int64_t row,
+                       int64_t column) {
+      uint32_t begin;
+      uint32_t end;
+
+      if (!GetCellEntries(row,column,begin,end)) {
+        return;
+      }
+
+      for (uint32_t e=begin; e<end; e++) {
+        const Segment& segment=segments[entries[e]];
+
+        if (!filter(segment)) {
+          continue;
+        }
+
+        double ax=(segment.lon[0]*COORD_RESOLUTION-lon)*lonFactor;
+        double ay=(segment.lat[0]*COORD_RESOLUTION-lat)*METERS_PER_DEGREE;
+        double dx=(segment.lon[1]*COORD_RESOLUTION-lon)*lonFactor-ax;
+        double dy=(segment.lat[1]*COORD_RESOLUTION-lat)*METERS_PER_DEGREE-ay;
+        double length=dx*dx+dy*dy;
+        double fraction=0.0;
+
+        if (length>0.0) {
+          fraction=std::max(0.0,std::min(1.0,-(ax*dx+ay*dy)/length));
+        }
+
+        double px=ax+fraction*dx;
+        double py=ay+fraction*dy;
+        double distance=std::sqrt(px*px+py*py);
+
+        if (distance<=radius) {
+          candidates.push_back(Candidate{distance,fraction,entries[e]});
+        }
+      }
+    };
+
+    // Returns true, if maxCount objects are at most bound meters away
+    auto isComplete=[&](double bound) {
+      objects.clear();
+
+      for (const auto& candidate : candidates) {
+        if (candidate.distance>bound) {
+          break;
+        }
+
+        uint64_t object=segments[candidate.segment].object;
+
+        if (std::find(objects.begin(),objects.end(),object)==objects.end()) {
+          objects.push_back(object);
+
+          if (objects.size()>=maxCount) {
+            return true;
+          }
+        }
+      }
+
+      return false;
+    };
+
+    for (int64_t ring=0; ; ring++) {
+      if (ring==0) {
+        visitCell(centerRow,centerColumn);
+      }
+      else {
+        for (int64_t column=centerColumn-ring; column<=centerColumn+ring; column++) {
+          visitCell(centerRow-ring,column);
+          visitCell(centerRow+ring,column);
+        }
+
+        for (int64_t row=centerRow-ring+1; row<=centerRow+ring-1; row++) {
+          visitCell(row,centerColumn-ring);
+          visitCell(row,centerColumn+ring);
+        }
+      }
+
+      std::sort(candidates.begin(),
+                candidates.end(),
+                [](const Candidate& a,
+                   const Candidate& b) {
+                  return a.distance<b.distance;
+                });
+
+      // Minimum distance of all segments in cells outside of the rings visited so far
+      double maxLat=std::min(std::fabs(lat)+(ring+1)*cellSize,90.0);
+      double lonCellMeters=cellSize*std::cos(DegToRad(maxLat))*METERS_PER_DEGREE;
+      double bound=ring*std::min(latCellMeters,lonCellMeters);
+
+      if (bound>radius ||
+          isComplete(bound) ||
+          ring>GetCellColumn(180.0,cellSize)) {
+        break;
+      }
+    }
+
+    objects.clear();
+
+    for (const auto& candidate : candidates) {
+      const Segment& segment=segments[candidate.segment];
+
+      if (std::find(objects.begin(),objects.end(),segment.object)!=objects.end()) {
+        continue;
+      }
+
+      objects.push_back(segment.object);
+
+      Match    match;
+      GeoCoord first=segment.GetCoord(0);
+      GeoCoord second=segment.GetCoord(1);
+
+      match.object=segment.GetObject();
+      match.nodeIndex=segment.nodeIndex;
+      match.fraction=candidate.fraction;
+      match.closestPoint=GeoCoord(first.GetLat()+(second.GetLat()-first.GetLat())*candidate.fraction,
+                                  first.GetLon()+(second.GetLon()-first.GetLon())*candidate.fraction);
+      match.distance=GetEllipsoidalDistance(coord,
+                                            match.closestPoint);
+      match.type=segment.type;
+
+      matches.push_back(match);
+
+      if (matches.size()>=maxCount) {
+        break;
+      }
+    }
+
+    return matches;
+  }
+
+  /**
+   * Return the value a coordinate is stored as
+   */
+  int32_t RouteSegmentIndex::EncodeCoord(double value)
+  {
+    return (int32_t)std::lround(value/COORD_RESOLUTION);
+  }
+
+  uint64_t RouteSegmentIndex::GetCellKey(int64_t row,
+                                         int64_t column)
+  {
+    return ((uint64_t)row << 32) | (uint64_t)column;
+  }
+
+  int64_t RouteSegmentIndex::GetCellRow(double lat,
+                                        double cellSize)
+  {
+    return (int64_t)std::floor((lat+90.0)/cellSize);
+  }
+
+  int64_t RouteSegmentIndex::GetCellColumn(double lon,
+                                           double cellSize)
+  {
+    return (int64_t)std::floor((lon+180.0)/cellSize);
+  }
+}
@@ -28,8 +28,8 @@ namespace osmscout {
     routeNodeDataFile(RoutingService::GetDataFilename(osmscout::RoutingService::DEFAULT_FILENAME_BASE),1000),
     junctionDataFile(RoutingService::FILENAME_INTERSECTIONS_DAT,
                      RoutingService::FILENAME_INTERSECTIONS_IDX,
-                     /*indexCacheSize*/
-                     10000,
+                     /*indexCacheSize, unused*/
+                     0,
                      /*dataCacheSize*/
                      1000)
   {
@@ -64,6 +64,8 @@ namespace osmscout {
   bool RoutingDatabase::GetJunctions(const std::set<Id>& ids,
                                      std::vector<JunctionRef>& junctions)
   {
+    std::lock_guard<std::mutex> lock(junctionMutex);
+
     if (!junctionDataFile.IsOpen()) {
       if (!junctionDataFile.Open(typeConfig,
                                  path,
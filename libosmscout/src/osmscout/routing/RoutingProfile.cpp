@@ -207,6 +207,22 @@ namespace osmscout {
     return typeIndex<speeds.size() && speeds[typeIndex]>0.0;
   }
 
+  /**
+   * Return true, if a path with the given flags (see RouteNode::Path::flags)
+   * following an object of the given variant can be used
+   */
+  bool AbstractRoutingProfile::CanUse(uint8_t pathFlags,
+                                      const ObjectVariantData& objectVariant) const
+  {
+    if (!(pathFlags & vehicleRouteNodeBit)) {
+      return false;
+    }
+
+    size_t typeIndex=objectVariant.type->GetIndex();
+
+    return typeIndex<speeds.size() && speeds[typeIndex]>0.0;
+  }
+
   bool AbstractRoutingProfile::CanUse(const Area& area) const
   {
     if (area.rings.size()!=1) {
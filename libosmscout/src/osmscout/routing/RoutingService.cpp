@@ -19,6 +19,8 @@
 
 #include <osmscout/routing/RoutingService.h>
 
+#include <algorithm>
+
 namespace osmscout {
 
   RoutePosition::RoutePosition()
@@ -58,6 +60,15 @@ namespace osmscout {
     // no code
   }
 
+  RoutingParameter::RoutingParameter()
+  : bidirectional(false),
+    useLandmarks(true),
+    useRouteGraph(true),
+    threadCount(1)
+  {
+    // no code
+  }
+
   void RoutingParameter::SetBreaker(const BreakerRef& breaker)
   {
     this->breaker=breaker;
@@ -68,11 +79,56 @@ namespace osmscout {
     this->progress=progress;
   }
 
+  void RoutingParameter::SetBidirectional(bool bidirectional)
+  {
+    this->bidirectional=bidirectional;
+  }
+
+  void RoutingParameter::SetUseLandmarks(bool useLandmarks)
+  {
+    this->useLandmarks=useLandmarks;
+  }
+
+  void RoutingParameter::SetUseRouteGraph(bool useRouteGraph)
+  {
+    this->useRouteGraph=useRouteGraph;
+  }
+
+  void RoutingParameter::SetThreadCount(size_t threadCount)
+  {
+    this->threadCount=threadCount;
+  }
+
   RoutingResult::RoutingResult()
   {
     // no code
   }
 
+  RoutingMatrix::RoutingMatrix()
+  : sourceCount(0),
+    targetCount(0)
+  {
+    // no code
+  }
+
+  RoutingMatrix::RoutingMatrix(size_t sourceCount,
+                               size_t targetCount)
+  : sourceCount(sourceCount),
+    targetCount(targetCount),
+    entries(sourceCount*targetCount)
+  {
+    // no code
+  }
+
+  const size_t ReachabilityResult::NO_PREV=std::numeric_limits<size_t>::max();
+
+  ReachabilityResult::ReachabilityResult()
+  : success(false),
+    costLimit(0.0)
+  {
+    // no code
+  }
+
   std::string RoutingService::GetDataFilename(const std::string& filenamebase)
   {
     return filenamebase+".dat";
@@ -88,6 +144,66 @@ namespace osmscout {
     return filenamebase+".idx";
   }
 
+  /**
+   * Name of the file holding the contraction hierarchy for the given vehicle
+   */
+  std::string RoutingService::GetCHFilename(const std::string& filenamebase,
+                                            Vehicle vehicle)
+  {
+    switch (vehicle) {
+    case vehicleFoot:
+      return filenamebase+"_ch_foot.dat";
+    case vehicleBicycle:
+      return filenamebase+"_ch_bicycle.dat";
+    case vehicleCar:
+      return filenamebase+"_ch_car.dat";
+    }
+
+    return filenamebase+"_ch.dat";
+  }
+
+  /**
+   * Name of the file holding the landmark distances (ALT heuristic) for the given vehicle
+   */
+  std::string RoutingService::GetLandmarkFilename(const std::string& filenamebase,
+                                                  Vehicle vehicle)
+  {
+    switch (vehicle) {
+    case vehicleFoot:
+      return filenamebase+"_alt_foot.dat";
+    case vehicleBicycle:
+      return filenamebase+"_alt_bicycle.dat";
+    case vehicleCar:
+      return filenamebase+"_alt_car.dat";
+    }
+
+    return filenamebase+"_alt.dat";
+  }
+
+  /**
+   * Name of the file holding the compact routing graph (see RouteGraph)
+   */
+  std::string RoutingService::GetGraphFilename(const std::string& filenamebase)
+  {
+    return filenamebase+"_graph.dat";
+  }
+
+  /**
+   * Name of the file holding the predecessors of the route nodes (see RoutePredecessorTable)
+   */
+  std::string RoutingService::GetPredecessorFilename(const std::string& filenamebase)
+  {
+    return filenamebase+"_predecessors.dat";
+  }
+
+  /**
+   * Name of the file holding the spatial index of the routable segments (see RouteSegmentIndex)
+   */
+  std::string RoutingService::GetSegmentIndexFilename(const std::string& filenamebase)
+  {
+    return filenamebase+"_segments.idx";
+  }
+
   const char* const RoutingService::FILENAME_INTERSECTIONS_DAT   = "intersections.dat";
   const char* const RoutingService::FILENAME_INTERSECTIONS_IDX   = "intersections.idx";
 
@@ -100,4 +216,149 @@ namespace osmscout {
   RoutingService::~RoutingService()
   {
   }
+
+  const size_t RoutingService::OpenList::NOT_OPEN=std::numeric_limits<size_t>::max();
+
+  RoutingService::OpenList::OpenList()
+  : nodeCount(0)
+  {
+    // no code
+  }
+
+  /**
+   * Remove all nodes. Memory is kept for the next routing query, but the
+   * references to the route nodes are released.
+   */
+  void RoutingService::OpenList::Clear()
+  {
+    for (size_t i=0; i<nodeCount; i++) {
+      chunks[i/CHUNK_SIZE][i%CHUNK_SIZE].node=nullptr;
+    }
+
+    nodeCount=0;
+    heap.clear();
+  }
+
+  /**
+   * Move the entry at the given index up until the heap condition is met
+   */
+  void RoutingService::OpenList::SiftUp(size_t index)
+  {
+    Entry entry=heap[index];
+
+    while (index>0) {
+      size_t parent=(index-1)/4;
+
+      if (!IsLess(entry,heap[parent])) {
+        break;
+      }
+
+      Place(index,heap[parent]);
+      index=parent;
+    }
+
+    Place(index,entry);
+  }
+
+  /**
+   * Move the entry at the given index down until the heap condition is met
+   */
+  void RoutingService::OpenList::SiftDown(size_t index)
+  {
+    Entry  entry=heap[index];
+    size_t size=heap.size();
+
+    while (true) {
+      size_t firstChild=4*index+1;
+
+      if (firstChild>=size) {
+        break;
+      }
+
+      size_t lastChild=std::min(firstChild+4,size);
+      size_t minChild=firstChild;
+
+      for (size_t child=firstChild+1; child<lastChild; child++) {
+        if (IsLess(heap[child],heap[minChild])) {
+          minChild=child;
+        }
+      }
+
+      if (!IsLess(heap[minChild],entry)) {
+        break;
+      }
+
+      Place(index,heap[minChild]);
+      index=minChild;
+    }
+
+    Place(index,entry);
+  }
+
+  /**
+   * Copy the given node into the storage of the list and add it to the heap.
+   *
+   * @return
+   *    Pointer to the stored node, valid until Clear() is called
+   */
+  RoutingService::RNode* RoutingService::OpenList::Insert(const RNode& node)
+  {
+    if (nodeCount==chunks.size()*CHUNK_SIZE) {
+      chunks.push_back(std::unique_ptr<RNode[]>(new RNode[CHUNK_SIZE]));
+    }
+
+    RNode* result=&chunks[nodeCount/CHUNK_SIZE][nodeCount%CHUNK_SIZE];
+
+    nodeCount++;
+
+    *result=node;
+
+    heap.push_back(Entry{result->overallCost,result});
+    SiftUp(heap.size()-1);
+
+    return result;
+  }
+
+  /**
+   * Restore the heap order after the costs of the given node have been changed.
+   * If the node has already been removed from the heap, it is added again.
+   */
+  void RoutingService::OpenList::Update(RNode* node)
+  {
+    if (node->openIndex==NOT_OPEN) {
+      heap.push_back(Entry{node->overallCost,node});
+      SiftUp(heap.size()-1);
+
+      return;
+    }
+
+    size_t index=node->openIndex;
+
+    heap[index].overallCost=node->overallCost;
+
+    SiftUp(index);
+    SiftDown(node->openIndex);
+  }
+
+  /**
+   * Remove the node with the lowest costs from the heap and return it. The node
+   * itself stays valid until Clear() is called.
+   */
+  RoutingService::RNode* RoutingService::OpenList::Pop()
+  {
+    RNode* result=heap.front().node;
+
+    result->openIndex=NOT_OPEN;
+
+    if (heap.size()>1) {
+      heap.front()=heap.back();
+      heap.pop_back();
+      SiftDown(0);
+    }
+    else {
+      heap.pop_back();
+    }
+
+    return result;
+  }
 }
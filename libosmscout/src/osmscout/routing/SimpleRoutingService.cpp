@@ -20,9 +20,12 @@
 #include <iomanip>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include <osmscout/system/Assert.h>
 
+#include <osmscout/util/File.h>
 #include <osmscout/util/Geometry.h>
 #include <osmscout/util/Logger.h>
 #include <osmscout/util/StopClock.h>
@@ -37,6 +40,24 @@
 
 namespace osmscout {
 
+  /**
+   * Return the flag of RouteNode::Path::flags, that marks a path usable by the
+   * given vehicle
+   */
+  static uint8_t GetVehicleFlag(Vehicle vehicle)
+  {
+    switch (vehicle) {
+    case vehicleFoot:
+      return RouteNode::usableByFoot;
+    case vehicleBicycle:
+      return RouteNode::usableByBicycle;
+    case vehicleCar:
+      return RouteNode::usableByCar;
+    }
+
+    return 0;
+  }
+
   /**
    * Create a new instance of the routing service.
    *
@@ -88,6 +109,13 @@ namespace osmscout {
     return profile.CanUse(routeNode,routingDatabase.GetObjectVariantData(),pathIndex);
   }
 
+  bool SimpleRoutingService::CanUse(const RoutingProfile& profile,
+                                    const DatabaseId /*database*/,
+                                    const RouteGraph::Edge& edge)
+  {
+    return profile.CanUse(edge.flags,routingDatabase.GetObjectVariantData()[edge.objectVariantIndex]);
+  }
+
   bool SimpleRoutingService::CanUseForward(const RoutingProfile& profile,
                                            const DatabaseId& /*database*/,
                                            const WayRef& way)
@@ -110,6 +138,13 @@ namespace osmscout {
     return profile.GetCosts(routeNode,routingDatabase.GetObjectVariantData(),pathIndex);
   }
 
+  double SimpleRoutingService::GetCosts(const RoutingProfile& profile,
+                                        const DatabaseId /*database*/,
+                                        const RouteGraph::Edge& edge)
+  {
+    return profile.GetCosts(routingDatabase.GetObjectVariantData()[edge.objectVariantIndex],edge.GetDistance());
+  }
+
   double SimpleRoutingService::GetCosts(const RoutingProfile& profile,
                                         const DatabaseId /*database*/,
                                         const WayRef &way,
@@ -118,6 +153,22 @@ namespace osmscout {
     return profile.GetCosts(*way,wayLength);
   }
 
+  double SimpleRoutingService::GetTime(const RoutingProfile& profile,
+                                       const DatabaseId /*database*/,
+                                       const RouteNode& routeNode,
+                                       size_t pathIndex)
+  {
+    return profile.GetTime(routeNode,routingDatabase.GetObjectVariantData(),pathIndex);
+  }
+
+  double SimpleRoutingService::GetTime(const RoutingProfile& profile,
+                                       const DatabaseId /*database*/,
+                                       const WayRef &way,
+                                       const Distance &wayLength)
+  {
+    return profile.GetTime(*way,wayLength);
+  }
+
   double SimpleRoutingService::GetEstimateCosts(const RoutingProfile& profile,
                                                 const DatabaseId /*database*/,
                                                 const Distance &targetDistance)
@@ -132,6 +183,40 @@ namespace osmscout {
     return profile.GetCosts(profile.GetCostLimitDistance()) + profile.GetCosts(targetDistance)*profile.GetCostLimitFactor();
   }
 
+  void SimpleRoutingService::PrepareRouteCostBounds(const RoutingProfile& profile,
+                                                    RouteCostBounds& bounds)
+  {
+    bounds.landmarks.assign(1,
+                            GetLandmarkCostBounds(profile));
+  }
+
+  double SimpleRoutingService::GetRouteCostBound(const RoutingProfile& profile,
+                                                 const RouteCostBounds& bounds,
+                                                 const DBId& from,
+                                                 const DBId& to)
+  {
+    if (bounds.landmarks.empty()) {
+      return 0.0;
+    }
+
+    return GetLandmarkCostBound(profile,
+                                bounds.landmarks.front(),
+                                from.id,
+                                to.id);
+  }
+
+  const RouteGraph* SimpleRoutingService::GetRouteGraph(const RoutingProfile& /*profile*/,
+                                                        DatabaseId /*database*/)
+  {
+    return routeGraph.IsOpen() ? &routeGraph : nullptr;
+  }
+
+  const RoutePredecessorTable* SimpleRoutingService::GetRoutePredecessors(const RoutingProfile& /*profile*/,
+                                                                          DatabaseId /*database*/)
+  {
+    return GetRoutePredecessorTable();
+  }
+
   bool SimpleRoutingService::GetRouteNodes(const std::set<DBId> &routeNodeIds,
                                            std::unordered_map<DBId,RouteNodeRef> &routeNodeMap)
   {
@@ -324,6 +409,77 @@ namespace osmscout {
       return false;
     }
 
+    // Landmark distances are optional, without them the A* estimate is based on the spherical distance
+    for (Vehicle vehicle : {vehicleFoot, vehicleBicycle, vehicleCar}) {
+      std::string filename=AppendFileToDir(path,
+                                           RoutingService::GetLandmarkFilename(filenamebase,
+                                                                               vehicle));
+
+      if (!ExistsInFilesystem(filename)) {
+        continue;
+      }
+
+      if (!landmarkTables[vehicle].Load(*database->GetTypeConfig(),
+                                        filename)) {
+        log.Error() << "Cannot load landmark table '" << filename << "'";
+        landmarkTables.erase(vehicle);
+        continue;
+      }
+
+      log.Debug() << "Loaded landmark table '" << filename << "', "
+                  << landmarkTables[vehicle].GetNodeCount() << " nodes, "
+                  << landmarkTables[vehicle].GetLandmarkCount() << " landmarks";
+    }
+
+    // The compact routing graph is optional, without it the A* search loads the route nodes
+    std::string graphFilename=AppendFileToDir(path,
+                                              RoutingService::GetGraphFilename(filenamebase));
+
+    if (ExistsInFilesystem(graphFilename)) {
+      if (routeGraph.Open(graphFilename,
+                          true)) {
+        log.Debug() << "Loaded routing graph '" << graphFilename << "', "
+                    << routeGraph.GetNodeCount() << " nodes, "
+                    << routeGraph.GetEdgeCount() << " edges"
+                    << (routeGraph.IsMemoryMapped() ? ", memory mapped" : "");
+      }
+      else {
+        log.Error() << "Cannot load routing graph '" << graphFilename << "'";
+      }
+    }
+
+    // The predecessors are optional, without them the bidirectional search is not available
+    std::string predecessorFilename=AppendFileToDir(path,
+                                                    RoutingService::GetPredecessorFilename(filenamebase));
+
+    if (ExistsInFilesystem(predecessorFilename)) {
+      if (predecessorTable.Load(predecessorFilename)) {
+        log.Debug() << "Loaded route node predecessors '" << predecessorFilename << "', "
+                    << predecessorTable.GetNodeCount() << " nodes, "
+                    << predecessorTable.GetPredecessorCount() << " predecessors";
+      }
+      else {
+        log.Error() << "Cannot load route node predecessors '" << predecessorFilename << "'";
+      }
+    }
+
+    // The segment index is optional, without it the closest objects are searched via the area way index
+    std::string segmentIndexFilename=AppendFileToDir(path,
+                                                     RoutingService::GetSegmentIndexFilename(filenamebase));
+
+    if (ExistsInFilesystem(segmentIndexFilename)) {
+      if (segmentIndex.Open(segmentIndexFilename,
+                            true)) {
+        log.Debug() << "Loaded segment index '" << segmentIndexFilename << "', "
+                    << segmentIndex.GetSegmentCount() << " segments, "
+                    << segmentIndex.GetCellCount() << " cells"
+                    << (segmentIndex.IsMemoryMapped() ? ", memory mapped" : "");
+      }
+      else {
+        log.Error() << "Cannot load segment index '" << segmentIndexFilename << "'";
+      }
+    }
+
     isOpen=true;
 
     return true;
@@ -346,6 +502,10 @@ namespace osmscout {
   void SimpleRoutingService::Close()
   {
     routingDatabase.Close();
+    landmarkTables.clear();
+    routeGraph.Close();
+    predecessorTable.Clear();
+    segmentIndex.Close();
 
     isOpen=false;
   }
@@ -361,9 +521,119 @@ namespace osmscout {
     return database->GetTypeConfig();
   }
 
+  /**
+   * Returns true, if landmark distances (see LandmarkTable) have been loaded for
+   * the given vehicle
+   */
+  bool SimpleRoutingService::HasLandmarks(Vehicle vehicle) const
+  {
+    return landmarkTables.find(vehicle)!=landmarkTables.end();
+  }
+
+  /**
+   * Returns true, if the compact routing graph (see RouteGraph) has been loaded
+   */
+  bool SimpleRoutingService::HasRouteGraph() const
+  {
+    return routeGraph.IsOpen();
+  }
+
+  /**
+   * Returns true, if the predecessors of the route nodes (see RoutePredecessorTable)
+   * have been loaded, which are required by the bidirectional search
+   */
+  bool SimpleRoutingService::HasRoutePredecessors() const
+  {
+    return predecessorTable.IsLoaded();
+  }
+
+  /**
+   * Returns the predecessors of the route nodes, or nullptr, if they have not been loaded
+   */
+  const RoutePredecessorTable* SimpleRoutingService::GetRoutePredecessorTable() const
+  {
+    return predecessorTable.IsLoaded() ? &predecessorTable : nullptr;
+  }
+
+  /**
+   * Returns true, if the spatial index of the routable segments (see
+   * RouteSegmentIndex) has been loaded
+   */
+  bool SimpleRoutingService::HasSegmentIndex() const
+  {
+    return segmentIndex.IsOpen();
+  }
+
+  /**
+   * Select the landmark table for the vehicle of the given profile and calculate
+   * the factor for its travel times (see LandmarkTable::GetTimeFactor()). The
+   * result is passed to GetLandmarkCostBound() by the search using the profile.
+   * Travel times are only used for a FastestPathRoutingProfile, since other
+   * profiles do not calculate their costs based on speeds.
+   */
+  LandmarkCostBounds SimpleRoutingService::GetLandmarkCostBounds(const RoutingProfile& profile) const
+  {
+    LandmarkCostBounds bounds;
+    auto               table=landmarkTables.find(profile.GetVehicle());
+
+    if (table!=landmarkTables.end()) {
+      const auto* fastestProfile=dynamic_cast<const FastestPathRoutingProfile*>(&profile);
+
+      bounds.table=&table->second;
+
+      if (fastestProfile!=nullptr) {
+        bounds.timeFactor=bounds.table->GetTimeFactor(*fastestProfile);
+      }
+    }
+
+    return bounds;
+  }
+
+  /**
+   * Return a lower bound for the costs of any route between the given route nodes
+   * based on the landmark table selected by GetLandmarkCostBounds(). This is the
+   * maximum of the costs for the lower bound of the route length and the scaled lower
+   * bound of the travel time. If there is no landmark table or one of the nodes is
+   * unknown, 0 is returned.
+   */
+  double SimpleRoutingService::GetLandmarkCostBound(const RoutingProfile& profile,
+                                                    const LandmarkCostBounds& bounds,
+                                                    Id from,
+                                                    Id to) const
+  {
+    if (bounds.table==nullptr) {
+      return 0.0;
+    }
+
+    uint32_t fromIndex=bounds.table->GetNodeIndex(from);
+    uint32_t toIndex=bounds.table->GetNodeIndex(to);
+
+    if (fromIndex==LandmarkTable::NO_NODE ||
+        toIndex==LandmarkTable::NO_NODE) {
+      return 0.0;
+    }
+
+    Distance distance;
+    double   time;
+
+    bounds.table->GetLowerBounds(fromIndex,
+                                 toIndex,
+                                 distance,
+                                 time);
+
+    return std::max(profile.GetCosts(distance),
+                    bounds.timeFactor*time);
+  }
+
   /**
    * Calculate a route going through all the via points
    *
+   * The routes between consecutive via points (legs) are calculated in parallel
+   * using RoutingParameter::GetThreadCount() threads. All threads share the caches
+   * of the routing data. The legs are merged in order, so the result does not
+   * depend on the number of threads. The progress of the legs is only reported,
+   * if a single thread is used.
+   *
    * @param profile
    *    Profile to use
    * @param via
@@ -401,30 +671,73 @@ namespace osmscout {
       objects.push_back(target.GetObjectFileRef());
     }
 
-    for (size_t index=0; index<nodeIndexes.size()-1; index++) {
-      size_t                     fromNodeIndex=nodeIndexes.at(index);
-      osmscout::ObjectFileRef    fromObject=objects.at(index);
-      size_t                     toNodeIndex=nodeIndexes.at(index+1);
-      osmscout::ObjectFileRef    toObject=objects.at(index+1);
-      RoutingResult              partialResult;
-
-      partialResult=CalculateRoute(profile,
-                                   RoutePosition(fromObject,
-                                                 fromNodeIndex,/*database*/
-                                                 0),
-                                   RoutePosition(toObject,
-                                                 toNodeIndex,/*database*/
-                                                 0),
-                                   parameter);
-      if (!partialResult.Success()) {
-        result.GetRoute().Clear();
+    size_t                     legCount=nodeIndexes.size()-1;
+    std::vector<RoutingResult> partialResults(legCount);
+    size_t                     threadCount=parameter.GetThreadCount();
+    RoutingParameter           legParameter(parameter);
+    std::atomic<size_t>        nextLeg(0);
+    std::atomic<bool>          failed(false);
 
-        return result;
+    if (threadCount==0) {
+      threadCount=std::max(std::thread::hardware_concurrency(),1u);
+    }
+
+    threadCount=std::max(std::min(threadCount,legCount),(size_t)1);
+
+    if (threadCount>1) {
+      legParameter.SetProgress(nullptr);
+    }
+
+    auto worker=[&]() {
+      size_t index;
+
+      while (!failed &&
+             (index=nextLeg++)<legCount) {
+        if (legParameter.GetBreaker() &&
+            legParameter.GetBreaker()->IsAborted()) {
+          failed=true;
+          return;
+        }
+
+        partialResults[index]=CalculateRoute(profile,
+                                             RoutePosition(objects[index],
+                                                           nodeIndexes[index],/*database*/
+                                                           0),
+                                             RoutePosition(objects[index+1],
+                                                           nodeIndexes[index+1],/*database*/
+                                                           0),
+                                             legParameter);
+
+        if (!partialResults[index].Success()) {
+          failed=true;
+        }
       }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (size_t i=1; i<threadCount; i++) {
+      threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    if (failed ||
+        (parameter.GetBreaker() &&
+         parameter.GetBreaker()->IsAborted())) {
+      return result;
+    }
+
+    for (size_t index=0; index<legCount; index++) {
+      RoutingResult& partialResult=partialResults[index];
 
       /* In intermediary via points the end of the previous part is the start of the */
       /* next part, we need to remove the duplicate point in the calculated route */
-      if (index<nodeIndexes.size()-2) {
+      if (index<legCount-1) {
         partialResult.GetRoute().PopEntry();
       }
 
@@ -441,6 +754,73 @@ namespace osmscout {
     }
   }
 
+  /**
+   * Returns the closest node on one of the given (routable) ways. The ways are
+   * scanned as WayView in the memory mapped data file, only ways that
+   * provide a new closest node are loaded to check if they are usable by the profile.
+   */
+  RoutePosition SimpleRoutingService::GetClosestRoutableWayNode(const GeoCoord& coord,
+                                                                const RoutingProfile& profile,
+                                                                const std::vector<FileOffset>& wayOffsets) const
+  {
+    WayDataFileRef        wayDataFile=database->GetWayDataFile();
+    RoutePosition         position;
+    std::vector<WayView>  views;
+    std::vector<GeoCoord> coords;
+
+    if (!wayDataFile->GetViewsByOffset(wayOffsets.begin(),
+                                       wayOffsets.end(),
+                                       wayOffsets.size(),
+                                       views)) {
+      log.Error() << "Error reading ways in area!";
+      return position;
+    }
+
+    double minDistance=std::numeric_limits<double>::max();
+
+    for (const auto& view : views) {
+      if (!view.nodes.HasSerials()) {
+        continue;
+      }
+
+      view.nodes.GetCoords(coords);
+
+      double minWayDistance=minDistance;
+      size_t minWayNode=0;
+
+      for (size_t i=0;  i<coords.size()-1; i++) {
+        double r, intersectLon, intersectLat;
+        double distance=DistanceToSegment(coord.GetLon(),coord.GetLat(),coords[i].GetLon(),coords[i].GetLat(),
+                                          coords[i+1].GetLon(),coords[i+1].GetLat(), r, intersectLon, intersectLat);
+        if (distance<minWayDistance) {
+          minWayDistance=distance;
+          minWayNode=r<0.5 ? i : i+1;
+        }
+      }
+
+      if (minWayDistance>=minDistance) {
+        continue;
+      }
+
+      WayRef way;
+
+      if (!wayDataFile->GetByOffset(view.GetFileOffset(),
+                                    way)) {
+        log.Error() << "Error reading way " << view.GetFileOffset() << "!";
+        return RoutePosition();
+      }
+
+      if (!profile.CanUse(*way)) {
+        continue;
+      }
+
+      minDistance=minWayDistance;
+      position=RoutePosition(view.GetObjectFileRef(),minWayNode,/*database*/0);
+    }
+
+    return position;
+  }
+
   /**
    * Returns the closest routeable object (area or way) relative
    * to the given coordinate.
@@ -454,6 +834,9 @@ namespace osmscout {
    * @note The actual object may not be within the given radius
    * due to internal search index resolution.
    *
+   * If the segment index (see RouteSegmentIndex) is available, it is used
+   * instead of loading all ways within the radius.
+   *
    * @param coord
    *    coordinate of the search center
    * @param profile
@@ -468,6 +851,44 @@ namespace osmscout {
                                                              const RoutingProfile& profile,
                                                              const Distance &radius) const
   {
+    if (segmentIndex.IsOpen()) {
+      TypeConfigRef     typeConfig=database->GetTypeConfig();
+      uint8_t           vehicleFlag=GetVehicleFlag(profile.GetVehicle());
+      std::vector<bool> usableTypes(typeConfig->GetTypeCount(),false);
+
+      for (const auto& type : typeConfig->GetTypes()) {
+        ObjectVariantData objectVariant;
+
+        objectVariant.type=type;
+
+        usableTypes[type->GetIndex()]=!type->GetIgnore() &&
+                                      type->CanRoute(profile.GetVehicle()) &&
+                                      profile.CanUse(vehicleFlag,
+                                                     objectVariant);
+      }
+
+      // Areas are skipped like below, the router cannot handle them as start or target node
+      std::vector<RouteSegmentIndex::Match> matches=segmentIndex.GetClosestObjects(coord,
+                                                                                   radius,
+                                                                                   1,
+                                                                                   [&usableTypes,vehicleFlag](const RouteSegmentIndex::Segment& segment) {
+                                                                                     return (segment.flags & vehicleFlag)!=0 &&
+                                                                                            segment.type<usableTypes.size() &&
+                                                                                            usableTypes[segment.type] &&
+                                                                                            segment.GetObject().GetType()==refWay;
+                                                                                   });
+
+      if (matches.empty()) {
+        return RoutePosition();
+      }
+
+      const RouteSegmentIndex::Match& match=matches.front();
+
+      return RoutePosition(match.object,
+                           match.fraction<0.5 ? match.nodeIndex : match.nodeIndex+1,
+                           /*database*/0);
+    }
+
     TypeConfigRef    typeConfig=database->GetTypeConfig();
     AreaAreaIndexRef areaAreaIndex=database->GetAreaAreaIndex();
     AreaWayIndexRef  areaWayIndex=database->GetAreaWayIndex();
@@ -528,6 +949,13 @@ namespace osmscout {
     std::sort(wayWayOffsets.begin(),
               wayWayOffsets.end());
 
+    if (wayDataFile->IsMemoryMapped() &&
+        wayAreaSpans.empty()) {
+      return GetClosestRoutableWayNode(coord,
+                                       profile,
+                                       wayWayOffsets);
+    }
+
     if (!wayDataFile->GetByOffset(wayWayOffsets.begin(),
                                   wayWayOffsets.end(),
                                   wayWayOffsets.size(),
@@ -625,75 +1053,191 @@ namespace osmscout {
                                                                              Vehicle vehicle,
                                                                              const Distance &maxRadius)
   {
-    ClosestRoutableObjectResult result;
-    TypeInfoSet                 routeableWayTypes;
-    TypeInfoSet                 routeableAreaTypes;
+    std::vector<ClosestRoutableObjectResult> results=GetClosestRoutableObjects(location,
+                                                                               vehicle,
+                                                                               maxRadius,
+                                                                               1);
 
-    for (const auto& type : database->GetTypeConfig()->GetTypes()) {
-      if (!type->GetIgnore() &&
-          type->CanBeWay() &&
-          type->CanRoute(vehicle)) {
-        routeableWayTypes.Set(type);
+    if (results.empty()) {
+      ClosestRoutableObjectResult result;
+
+      result.distance=Distance::Max();
+
+      return result;
+    }
+
+    return results.front();
+  }
+
+  /**
+   * Collect the routable objects closest to the given location via the segment
+   * index, only the returned objects are loaded. Besides the type, the access
+   * restrictions of the objects are respected, as they are stored in the index.
+   *
+   * @return
+   *    false, if an object could not be loaded
+   */
+  bool SimpleRoutingService::GetClosestRoutableObjectsFromIndex(const GeoCoord& location,
+                                                                Vehicle vehicle,
+                                                                const Distance &maxRadius,
+                                                                size_t maxCount,
+                                                                std::vector<ClosestRoutableObjectResult>& results)
+  {
+    TypeConfigRef     typeConfig=database->GetTypeConfig();
+    uint8_t           vehicleFlag=GetVehicleFlag(vehicle);
+    std::vector<bool> routableTypes(typeConfig->GetTypeCount(),false);
+
+    for (const auto& type : typeConfig->GetTypes()) {
+      routableTypes[type->GetIndex()]=!type->GetIgnore() &&
+                                      type->CanRoute(vehicle);
+    }
+
+    std::vector<RouteSegmentIndex::Match> matches=segmentIndex.GetClosestObjects(location,
+                                                                                 maxRadius,
+                                                                                 maxCount,
+                                                                                 [&routableTypes,vehicleFlag](const RouteSegmentIndex::Segment& segment) {
+                                                                                   return (segment.flags & vehicleFlag)!=0 &&
+                                                                                          segment.type<routableTypes.size() &&
+                                                                                          routableTypes[segment.type];
+                                                                                 });
+
+    for (const auto& match : matches) {
+      ClosestRoutableObjectResult result;
+
+      result.object=match.object;
+      result.distance=match.distance;
+      result.closestPoint=match.closestPoint;
+
+      if (match.object.GetType()==refWay) {
+        if (!database->GetWayByOffset(match.object.GetFileOffset(),
+                                      result.way)) {
+          log.Error() << "Cannot load way " << match.object.GetName();
+          return false;
+        }
+      }
+      else if (!database->GetAreaByOffset(match.object.GetFileOffset(),
+                                          result.area)) {
+        log.Error() << "Cannot load area " << match.object.GetName();
+        return false;
       }
 
-      if (!type->GetIgnore() &&
-          type->CanBeArea() &&
-          type->CanRoute(vehicle)) {
-        routeableAreaTypes.Set(type);
+      results.push_back(result);
+    }
+
+    return true;
+  }
+
+  /**
+   * Returns the routable objects (ways or areas) closest to the given location,
+   * ordered by increasing distance. In contrast to GetClosestRoutableObject(),
+   * this returns alternatives, like the parallel ways of a dual carriageway, as
+   * needed for example for matching a noisy GPS track to the road network.
+   *
+   * If the segment index (see RouteSegmentIndex) is available, only the returned
+   * objects are loaded, else all routable objects within the radius.
+   *
+   * @param location
+   *    coordinate of the search center
+   * @param vehicle
+   *    The vehicle to use
+   * @param maxRadius
+   *    The maximum radius to search in from the search center
+   * @param maxCount
+   *    The maximum number of objects to return
+   * @return
+   *    Up to maxCount objects, the closest object first
+   */
+  std::vector<ClosestRoutableObjectResult> SimpleRoutingService::GetClosestRoutableObjects(const GeoCoord& location,
+                                                                                           Vehicle vehicle,
+                                                                                           const Distance &maxRadius,
+                                                                                           size_t maxCount)
+  {
+    std::vector<ClosestRoutableObjectResult> results;
+
+    if (segmentIndex.IsOpen()) {
+      if (!GetClosestRoutableObjectsFromIndex(location,
+                                              vehicle,
+                                              maxRadius,
+                                              maxCount,
+                                              results)) {
+        results.clear();
       }
     }
+    else {
+      TypeInfoSet routeableWayTypes;
+      TypeInfoSet routeableAreaTypes;
+
+      for (const auto& type : database->GetTypeConfig()->GetTypes()) {
+        if (!type->GetIgnore() &&
+            type->CanBeWay() &&
+            type->CanRoute(vehicle)) {
+          routeableWayTypes.Set(type);
+        }
 
-    Distance closestDistance=Distance::Max();
-    WayRef   closestWay;
-    AreaRef  closestArea;
+        if (!type->GetIgnore() &&
+            type->CanBeArea() &&
+            type->CanRoute(vehicle)) {
+          routeableAreaTypes.Set(type);
+        }
+      }
+
+      if (!routeableWayTypes.Empty()) {
+        WayRegionSearchResult waySearchResult=database->LoadWaysInRadius(location,
+                                                                         routeableWayTypes,
+                                                                         maxRadius);
+
+        for (const auto& entry : waySearchResult.GetWayResults()) {
+          ClosestRoutableObjectResult result;
 
-    if (!routeableWayTypes.Empty()) {
-      WayRegionSearchResult waySearchResult=database->LoadWaysInRadius(location,
-                                                                       routeableWayTypes,
-                                                                       maxRadius);
+          result.object=entry.GetWay()->GetObjectFileRef();
+          result.distance=entry.GetDistance();
+          result.closestPoint=entry.GetClosestPoint();
+          result.way=entry.GetWay();
 
-      for (const auto& entry : waySearchResult.GetWayResults()) {
-        if (entry.GetDistance()<closestDistance) {
-          closestDistance=entry.GetDistance();
-          closestWay=entry.GetWay();
-          closestArea.reset();
+          results.push_back(result);
         }
       }
-    }
 
-    if (!routeableAreaTypes.Empty()) {
-      AreaRegionSearchResult areaSearchResult=database->LoadAreasInRadius(location,
-                                                                          routeableAreaTypes,
-                                                                          maxRadius);
-      for (const auto& entry : areaSearchResult.GetAreaResults()) {
-        if (entry.GetDistance()<closestDistance) {
-          closestDistance=entry.GetDistance();
-          closestWay.reset();
-          closestArea=entry.GetArea();
+      if (!routeableAreaTypes.Empty()) {
+        AreaRegionSearchResult areaSearchResult=database->LoadAreasInRadius(location,
+                                                                            routeableAreaTypes,
+                                                                            maxRadius);
+
+        for (const auto& entry : areaSearchResult.GetAreaResults()) {
+          ClosestRoutableObjectResult result;
+
+          result.object=entry.GetArea()->GetObjectFileRef();
+          result.distance=entry.GetDistance();
+          result.closestPoint=entry.GetClosestPoint();
+          result.area=entry.GetArea();
+
+          results.push_back(result);
         }
       }
     }
 
-    if (!closestWay && !closestArea) {
-      result.distance=Distance::Max();
-      return result;
+    std::stable_sort(results.begin(),
+                     results.end(),
+                     [](const ClosestRoutableObjectResult& a,
+                        const ClosestRoutableObjectResult& b) {
+                       return a.distance<b.distance;
+                     });
+
+    if (results.size()>maxCount) {
+      results.resize(maxCount);
     }
-    else {
-      NameFeatureLabelReader nameFeatureLabelReader(*database->GetTypeConfig());
 
-      result.distance=closestDistance;
-      if (closestWay) {
-        result.way=closestWay;
-        result.object=result.way->GetObjectFileRef();
+    NameFeatureLabelReader nameFeatureLabelReader(*database->GetTypeConfig());
+
+    for (auto& result : results) {
+      if (result.way) {
         result.name=nameFeatureLabelReader.GetLabel(result.way->GetFeatureValueBuffer());
       }
       else {
-        result.area=closestArea;
-        result.object=result.area->GetObjectFileRef();
         result.name=nameFeatureLabelReader.GetLabel(result.area->GetFeatureValueBuffer());
       }
     }
 
-    return result;
+    return results;
   }
 }
@@ -0,0 +1,246 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/private/Config.h>
+
+#include <osmscout/util/BlockCompression.h>
+
+#include <limits>
+
+#if defined(HAVE_LIB_ZLIB)
+  #include <zlib.h>
+#endif
+
+#include <osmscout/system/Compiler.h>
+
+#include <osmscout/util/Exception.h>
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+
+namespace osmscout {
+
+  /**
+   * Returns true, if the library was built with support for block compressed files.
+   */
+  bool IsBlockCompressionSupported()
+  {
+#if defined(HAVE_LIB_ZLIB)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * Compress the given data as one block.
+   *
+   * Returns false, if block compression is not supported or compression failed.
+   */
+  bool CompressBlock(const char* data,
+                     size_t size,
+                     std::vector<char>& compressed)
+  {
+#if defined(HAVE_LIB_ZLIB)
+    uLongf compressedSize=compressBound((uLong)size);
+
+    compressed.resize(compressedSize);
+
+    if (compress2(reinterpret_cast<Bytef*>(compressed.data()),
+                  &compressedSize,
+                  reinterpret_cast<const Bytef*>(data),
+                  (uLong)size,
+                  Z_DEFAULT_COMPRESSION)!=Z_OK) {
+      return false;
+    }
+
+    compressed.resize(compressedSize);
+
+    return true;
+#else
+    unused(data);
+    unused(size);
+    unused(compressed);
+
+    return false;
+#endif
+  }
+
+  /**
+   * Decompress one block into the given buffer, which must have exactly the size of the
+   * uncompressed block.
+   *
+   * Returns false, if block compression is not supported, the data is corrupt or
+   * the decompressed data does not have the expected size.
+   */
+  bool DecompressBlock(const char* compressed,
+                       size_t compressedSize,
+                       char* data,
+                       size_t size)
+  {
+#if defined(HAVE_LIB_ZLIB)
+    uLongf uncompressedSize=(uLongf)size;
+
+    if (uncompress(reinterpret_cast<Bytef*>(data),
+                   &uncompressedSize,
+                   reinterpret_cast<const Bytef*>(compressed),
+                   (uLong)compressedSize)!=Z_OK) {
+      return false;
+    }
+
+    return uncompressedSize==size;
+#else
+    unused(compressed);
+    unused(compressedSize);
+    unused(data);
+    unused(size);
+
+    return false;
+#endif
+  }
+
+  /**
+   * Write a block compressed copy of the given source file.
+   *
+   * Blocks are only cut at the given offsets, which must be sorted and should be
+   * the offsets of the records in the file (the start of the file is always a valid
+   * cut). A block is closed at the last record boundary before it would exceed the
+   * given block size. A single record larger than the block size results in a larger
+   * block.
+   *
+   * @throws IOException
+   */
+  void WriteBlockCompressedFile(const std::string& sourceFilename,
+                                const std::string& targetFilename,
+                                const std::vector<FileOffset>& recordOffsets,
+                                size_t blockSize)
+  {
+    if (!IsBlockCompressionSupported()) {
+      throw IOException(targetFilename,"Cannot write block compressed file","Block compression is not supported");
+    }
+
+    FileScanner                  scanner;
+    FileWriter                   writer;
+    std::vector<FileOffset>      cuts;
+    std::vector<CompressedBlock> blocks;
+    std::vector<char>            data;
+    std::vector<char>            compressed;
+
+    try {
+      FileOffset dataSize=GetFileSize(sourceFilename);
+
+      scanner.Open(sourceFilename,
+                   FileScanner::Sequential,
+                   false);
+
+      // Calculate the blocks
+      FileOffset blockStart=0;
+      FileOffset lastBoundary=0;
+
+      for (const auto recordOffset : recordOffsets) {
+        if (recordOffset<=blockStart ||
+            recordOffset>=dataSize) {
+          continue;
+        }
+
+        if (recordOffset-blockStart>blockSize) {
+          blockStart=lastBoundary>blockStart ? lastBoundary : recordOffset;
+          cuts.push_back(blockStart);
+        }
+
+        lastBoundary=recordOffset;
+      }
+
+      if (dataSize-blockStart>blockSize &&
+          lastBoundary>blockStart) {
+        cuts.push_back(lastBoundary);
+      }
+
+      cuts.push_back(dataSize);
+
+      writer.Open(targetFilename);
+
+      writer.Write(BLOCK_COMPRESSION_MAGIC,
+                   sizeof(BLOCK_COMPRESSION_MAGIC));
+      writer.Write(BLOCK_COMPRESSION_VERSION);
+      writer.Write((uint32_t)blockSize);
+      writer.Write((uint64_t)dataSize);
+      writer.Write((uint64_t)0); // Offset of block index, rewritten at the end
+
+      blockStart=0;
+
+      for (const auto cut : cuts) {
+        if (cut==blockStart) {
+          continue;
+        }
+
+        if (cut-blockStart>std::numeric_limits<uint32_t>::max()) {
+          throw IOException(targetFilename,"Cannot write block compressed file","Record too large for a block");
+        }
+
+        CompressedBlock block;
+
+        data.resize((size_t)(cut-blockStart));
+        scanner.Read(data.data(),
+                     data.size());
+
+        if (!CompressBlock(data.data(),
+                           data.size(),
+                           compressed)) {
+          throw IOException(targetFilename,"Cannot write block compressed file","Cannot compress block");
+        }
+
+        block.logicalOffset=blockStart;
+        block.fileOffset=writer.GetPos();
+        block.compressedSize=(uint32_t)compressed.size();
+        block.uncompressedSize=(uint32_t)data.size();
+
+        writer.Write(compressed.data(),
+                     compressed.size());
+
+        blocks.push_back(block);
+
+        blockStart=cut;
+      }
+
+      FileOffset indexOffset=writer.GetPos();
+
+      writer.Write((uint32_t)blocks.size());
+
+      for (const auto& block : blocks) {
+        writer.Write((uint64_t)block.logicalOffset);
+        writer.Write((uint64_t)block.fileOffset);
+        writer.Write(block.compressedSize);
+        writer.Write(block.uncompressedSize);
+      }
+
+      writer.SetPos(BLOCK_COMPRESSION_HEADER_SIZE-8);
+      writer.Write((uint64_t)indexOffset);
+
+      scanner.Close();
+      writer.Close();
+    }
+    catch (IOException&) {
+      scanner.CloseFailsafe();
+      writer.CloseFailsafe();
+
+      throw;
+    }
+  }
+}
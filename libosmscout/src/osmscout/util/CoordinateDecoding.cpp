@@ -0,0 +1,561 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/util/CoordinateDecoding.h>
+
+#include <osmscout/GeoCoord.h>
+
+// SIMD implementations are compiled using function specific target attributes,
+// so the library itself does not need to be compiled for a specific processor.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+  #define OSMSCOUT_HAVE_X86_SIMD
+  #include <immintrin.h>
+#endif
+
+namespace osmscout {
+
+  static inline int32_t DecodeDelta(const uint8_t* data,
+                                    size_t bytes)
+  {
+    if (bytes==1) {
+      return (int8_t)data[0];
+    }
+    else if (bytes==2) {
+      return (int16_t)(data[0] | (data[1] << 8));
+    }
+
+    uint32_t value=data[0] | (data[1] << 8) | (data[2] << 16);
+
+    if (value & 0x800000) {
+      value|=0xff000000;
+    }
+
+    return (int32_t)value;
+  }
+
+  static void DecodeCoordinateDeltasScalar(const uint8_t* deltas,
+                                           size_t deltaBytes,
+                                           size_t count,
+                                           uint32_t latValue,
+                                           uint32_t lonValue,
+                                           uint32_t* latValues,
+                                           uint32_t* lonValues)
+  {
+    for (size_t i=0; i<count; i++) {
+      latValue+=DecodeDelta(deltas,deltaBytes);
+      lonValue+=DecodeDelta(deltas+deltaBytes,deltaBytes);
+
+      latValues[i]=latValue;
+      lonValues[i]=lonValue;
+
+      deltas+=2*deltaBytes;
+    }
+  }
+
+  static void ConvertCoordinateValuesScalar(const uint32_t* latValues,
+                                            const uint32_t* lonValues,
+                                            size_t count,
+                                            double* lats,
+                                            double* lons)
+  {
+    for (size_t i=0; i<count; i++) {
+      lats[i]=latValues[i]/latConversionFactor-90.0;
+      lons[i]=lonValues[i]/lonConversionFactor-180.0;
+    }
+  }
+
+#if defined(OSMSCOUT_HAVE_X86_SIMD)
+  /**
+   * Load the deltas of 4 coordinates and sign extend them to 32 bit,
+   * separated into lat and lon deltas.
+   */
+  template<size_t B>
+  __attribute__((target("sse4.1")))
+  static inline void LoadDeltas4(const uint8_t* deltas,
+                                 __m128i& lat,
+                                 __m128i& lon);
+
+  template<>
+  __attribute__((target("sse4.1")))
+  inline void LoadDeltas4<1>(const uint8_t* deltas,
+                             __m128i& lat,
+                             __m128i& lon)
+  {
+    __m128i data=_mm_loadl_epi64(reinterpret_cast<const __m128i*>(deltas));
+
+    lat=_mm_cvtepi8_epi32(_mm_shuffle_epi8(data,_mm_setr_epi8(0,2,4,6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1)));
+    lon=_mm_cvtepi8_epi32(_mm_shuffle_epi8(data,_mm_setr_epi8(1,3,5,7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1)));
+  }
+
+  template<>
+  __attribute__((target("sse4.1")))
+  inline void LoadDeltas4<2>(const uint8_t* deltas,
+                             __m128i& lat,
+                             __m128i& lon)
+  {
+    __m128i data=_mm_loadu_si128(reinterpret_cast<const __m128i*>(deltas));
+
+    lat=_mm_cvtepi16_epi32(_mm_shuffle_epi8(data,_mm_setr_epi8(0,1,4,5,8,9,12,13,-1,-1,-1,-1,-1,-1,-1,-1)));
+    lon=_mm_cvtepi16_epi32(_mm_shuffle_epi8(data,_mm_setr_epi8(2,3,6,7,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1)));
+  }
+
+  template<>
+  __attribute__((target("sse4.1")))
+  inline void LoadDeltas4<3>(const uint8_t* deltas,
+                             __m128i& lat,
+                             __m128i& lon)
+  {
+    // 24 bytes, loaded as bytes 0..15 and 8..23. The 3 bytes of each value are moved
+    // into the upper 3 bytes of a 32 bit lane, an arithmetic shift does the sign extension
+    __m128i low=_mm_loadu_si128(reinterpret_cast<const __m128i*>(deltas));
+    __m128i high=_mm_loadu_si128(reinterpret_cast<const __m128i*>(deltas+8));
+
+    lat=_mm_or_si128(_mm_shuffle_epi8(low,_mm_setr_epi8(-1,0,1,2,-1,6,7,8,-1,12,13,14,-1,-1,-1,-1)),
+                     _mm_shuffle_epi8(high,_mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,10,11,12)));
+    lon=_mm_or_si128(_mm_shuffle_epi8(low,_mm_setr_epi8(-1,3,4,5,-1,9,10,11,-1,-1,-1,-1,-1,-1,-1,-1)),
+                     _mm_shuffle_epi8(high,_mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,7,8,9,-1,13,14,15)));
+
+    lat=_mm_srai_epi32(lat,8);
+    lon=_mm_srai_epi32(lon,8);
+  }
+
+  /**
+   * Inclusive prefix sum of the 4 lanes plus the carry (the last value
+   * of the previous group in all lanes)
+   */
+  __attribute__((target("sse4.1")))
+  static inline __m128i PrefixSum4(__m128i values,
+                                   __m128i carry)
+  {
+    values=_mm_add_epi32(values,_mm_slli_si128(values,4));
+    values=_mm_add_epi32(values,_mm_slli_si128(values,8));
+
+    return _mm_add_epi32(values,carry);
+  }
+
+  template<size_t B>
+  __attribute__((target("sse4.1")))
+  static size_t DecodeCoordinateDeltasSSE41(const uint8_t* deltas,
+                                            size_t count,
+                                            uint32_t& latValue,
+                                            uint32_t& lonValue,
+                                            uint32_t* latValues,
+                                            uint32_t* lonValues)
+  {
+    __m128i latCarry=_mm_set1_epi32((int32_t)latValue);
+    __m128i lonCarry=_mm_set1_epi32((int32_t)lonValue);
+    size_t  i=0;
+
+    for (; i+4<=count; i+=4) {
+      __m128i lat;
+      __m128i lon;
+
+      LoadDeltas4<B>(deltas,lat,lon);
+
+      lat=PrefixSum4(lat,latCarry);
+      lon=PrefixSum4(lon,lonCarry);
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(latValues+i),lat);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(lonValues+i),lon);
+
+      latCarry=_mm_shuffle_epi32(lat,_MM_SHUFFLE(3,3,3,3));
+      lonCarry=_mm_shuffle_epi32(lon,_MM_SHUFFLE(3,3,3,3));
+
+      deltas+=4*2*B;
+    }
+
+    latValue=(uint32_t)_mm_cvtsi128_si32(latCarry);
+    lonValue=(uint32_t)_mm_cvtsi128_si32(lonCarry);
+
+    return i;
+  }
+
+  /**
+   * Convert 2 unsigned values to double. The values are converted as signed values,
+   * values >=2^31 are corrected afterwards.
+   */
+  __attribute__((target("sse4.1")))
+  static inline __m128d ConvertUnsigned2(__m128i values)
+  {
+    __m128d result=_mm_cvtepi32_pd(values);
+    __m128d negative=_mm_cmplt_pd(result,_mm_setzero_pd());
+
+    return _mm_add_pd(result,_mm_and_pd(negative,_mm_set1_pd(4294967296.0)));
+  }
+
+  __attribute__((target("sse4.1")))
+  static size_t ConvertCoordinateValuesSSE41(const uint32_t* latValues,
+                                             const uint32_t* lonValues,
+                                             size_t count,
+                                             double* lats,
+                                             double* lons)
+  {
+    const __m128d latFactor=_mm_set1_pd(latConversionFactor);
+    const __m128d lonFactor=_mm_set1_pd(lonConversionFactor);
+    const __m128d latOffset=_mm_set1_pd(90.0);
+    const __m128d lonOffset=_mm_set1_pd(180.0);
+    size_t        i=0;
+
+    for (; i+2<=count; i+=2) {
+      __m128d lat=ConvertUnsigned2(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(latValues+i)));
+      __m128d lon=ConvertUnsigned2(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(lonValues+i)));
+
+      _mm_storeu_pd(lats+i,_mm_sub_pd(_mm_div_pd(lat,latFactor),latOffset));
+      _mm_storeu_pd(lons+i,_mm_sub_pd(_mm_div_pd(lon,lonFactor),lonOffset));
+    }
+
+    return i;
+  }
+
+  /**
+   * Load the deltas of 8 coordinates and sign extend them to 32 bit,
+   * separated into lat and lon deltas.
+   */
+  template<size_t B>
+  __attribute__((target("avx2")))
+  static inline void LoadDeltas8(const uint8_t* deltas,
+                                 __m256i& lat,
+                                 __m256i& lon);
+
+  template<>
+  __attribute__((target("avx2")))
+  inline void LoadDeltas8<1>(const uint8_t* deltas,
+                             __m256i& lat,
+                             __m256i& lon)
+  {
+    __m128i data=_mm_loadu_si128(reinterpret_cast<const __m128i*>(deltas));
+
+    data=_mm_shuffle_epi8(data,_mm_setr_epi8(0,2,4,6,8,10,12,14,1,3,5,7,9,11,13,15));
+
+    lat=_mm256_cvtepi8_epi32(data);
+    lon=_mm256_cvtepi8_epi32(_mm_srli_si128(data,8));
+  }
+
+  template<>
+  __attribute__((target("avx2")))
+  inline void LoadDeltas8<2>(const uint8_t* deltas,
+                             __m256i& lat,
+                             __m256i& lon)
+  {
+    __m256i data=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(deltas));
+
+    // Within each 128 bit lane: 4 lat values followed by 4 lon values
+    data=_mm256_shuffle_epi8(data,_mm256_setr_epi8(0,1,4,5,8,9,12,13,2,3,6,7,10,11,14,15,
+                                                   0,1,4,5,8,9,12,13,2,3,6,7,10,11,14,15));
+    // 8 lat values followed by 8 lon values
+    data=_mm256_permute4x64_epi64(data,_MM_SHUFFLE(3,1,2,0));
+
+    lat=_mm256_cvtepi16_epi32(_mm256_castsi256_si128(data));
+    lon=_mm256_cvtepi16_epi32(_mm256_extracti128_si256(data,1));
+  }
+
+  template<>
+  __attribute__((target("avx2")))
+  inline void LoadDeltas8<3>(const uint8_t* deltas,
+                             __m256i& lat,
+                             __m256i& lon)
+  {
+    __m128i latLow;
+    __m128i lonLow;
+    __m128i latHigh;
+    __m128i lonHigh;
+
+    LoadDeltas4<3>(deltas,latLow,lonLow);
+    LoadDeltas4<3>(deltas+4*2*3,latHigh,lonHigh);
+
+    lat=_mm256_inserti128_si256(_mm256_castsi128_si256(latLow),latHigh,1);
+    lon=_mm256_inserti128_si256(_mm256_castsi128_si256(lonLow),lonHigh,1);
+  }
+
+  /**
+   * Inclusive prefix sum of the 8 lanes plus the carry (the last value
+   * of the previous group in all lanes)
+   */
+  __attribute__((target("avx2")))
+  static inline __m256i PrefixSum8(__m256i values,
+                                   __m256i carry)
+  {
+    // Prefix sum within the two 128 bit lanes
+    values=_mm256_add_epi32(values,_mm256_slli_si256(values,4));
+    values=_mm256_add_epi32(values,_mm256_slli_si256(values,8));
+
+    // Add the sum of the lower lane to the upper lane
+    __m256i lowerSum=_mm256_shuffle_epi32(values,_MM_SHUFFLE(3,3,3,3));
+
+    lowerSum=_mm256_permute2x128_si256(lowerSum,lowerSum,0x08);
+
+    values=_mm256_add_epi32(values,lowerSum);
+
+    return _mm256_add_epi32(values,carry);
+  }
+
+  template<size_t B>
+  __attribute__((target("avx2")))
+  static size_t DecodeCoordinateDeltasAVX2(const uint8_t* deltas,
+                                           size_t count,
+                                           uint32_t& latValue,
+                                           uint32_t& lonValue,
+                                           uint32_t* latValues,
+                                           uint32_t* lonValues)
+  {
+    const __m256i lastLane=_mm256_set1_epi32(7);
+    __m256i       latCarry=_mm256_set1_epi32((int32_t)latValue);
+    __m256i       lonCarry=_mm256_set1_epi32((int32_t)lonValue);
+    size_t        i=0;
+
+    for (; i+8<=count; i+=8) {
+      __m256i lat;
+      __m256i lon;
+
+      LoadDeltas8<B>(deltas,lat,lon);
+
+      lat=PrefixSum8(lat,latCarry);
+      lon=PrefixSum8(lon,lonCarry);
+
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(latValues+i),lat);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(lonValues+i),lon);
+
+      latCarry=_mm256_permutevar8x32_epi32(lat,lastLane);
+      lonCarry=_mm256_permutevar8x32_epi32(lon,lastLane);
+
+      deltas+=8*2*B;
+    }
+
+    latValue=(uint32_t)_mm_cvtsi128_si32(_mm256_castsi256_si128(latCarry));
+    lonValue=(uint32_t)_mm_cvtsi128_si32(_mm256_castsi256_si128(lonCarry));
+
+    return i;
+  }
+
+  /**
+   * Convert 4 unsigned values to double. The values are converted as signed values,
+   * values >=2^31 are corrected afterwards.
+   */
+  __attribute__((target("avx2")))
+  static inline __m256d ConvertUnsigned4(__m128i values)
+  {
+    __m256d result=_mm256_cvtepi32_pd(values);
+    __m256d negative=_mm256_cmp_pd(result,_mm256_setzero_pd(),_CMP_LT_OQ);
+
+    return _mm256_add_pd(result,_mm256_and_pd(negative,_mm256_set1_pd(4294967296.0)));
+  }
+
+  __attribute__((target("avx2")))
+  static size_t ConvertCoordinateValuesAVX2(const uint32_t* latValues,
+                                            const uint32_t* lonValues,
+                                            size_t count,
+                                            double* lats,
+                                            double* lons)
+  {
+    const __m256d latFactor=_mm256_set1_pd(latConversionFactor);
+    const __m256d lonFactor=_mm256_set1_pd(lonConversionFactor);
+    const __m256d latOffset=_mm256_set1_pd(90.0);
+    const __m256d lonOffset=_mm256_set1_pd(180.0);
+    size_t        i=0;
+
+    for (; i+4<=count; i+=4) {
+      __m256d lat=ConvertUnsigned4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(latValues+i)));
+      __m256d lon=ConvertUnsigned4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lonValues+i)));
+
+      _mm256_storeu_pd(lats+i,_mm256_sub_pd(_mm256_div_pd(lat,latFactor),latOffset));
+      _mm256_storeu_pd(lons+i,_mm256_sub_pd(_mm256_div_pd(lon,lonFactor),lonOffset));
+    }
+
+    return i;
+  }
+#endif
+
+  /**
+   * Returns true, if the given implementation can be used on this processor
+   * with this build of the library.
+   */
+  bool IsCoordinateDecoderSupported(CoordinateDecoderType type)
+  {
+    switch (type) {
+    case CoordinateDecoderType::Scalar:
+      return true;
+#if defined(OSMSCOUT_HAVE_X86_SIMD)
+    case CoordinateDecoderType::SSE41:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse4.1");
+    case CoordinateDecoderType::AVX2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2");
+#else
+    default:
+      return false;
+#endif
+    }
+
+    return false;
+  }
+
+  /**
+   * Returns the best implementation supported by the processor. The implementation
+   * is detected on the first call.
+   */
+  CoordinateDecoderType GetCoordinateDecoderType()
+  {
+    static const CoordinateDecoderType type=IsCoordinateDecoderSupported(CoordinateDecoderType::AVX2) ? CoordinateDecoderType::AVX2 :
+                                            IsCoordinateDecoderSupported(CoordinateDecoderType::SSE41) ? CoordinateDecoderType::SSE41 :
+                                            CoordinateDecoderType::Scalar;
+
+    return type;
+  }
+
+  const char* GetCoordinateDecoderName(CoordinateDecoderType type)
+  {
+    switch (type) {
+    case CoordinateDecoderType::Scalar:
+      return "scalar";
+    case CoordinateDecoderType::SSE41:
+      return "SSE4.1";
+    case CoordinateDecoderType::AVX2:
+      return "AVX2";
+    }
+
+    return "unknown";
+  }
+
+  /**
+   * Decode the given number of interleaved lat/lon deltas, each of the given size
+   * in bytes (1, 2 or 3), starting with the given (fixed point) lat and lon values.
+   * The resulting values (the start values plus the sum of all deltas so far) are
+   * written to the two output arrays, which must have space for count values.
+   *
+   * The given implementation must be supported (see IsCoordinateDecoderSupported()).
+   */
+  void DecodeCoordinateDeltas(CoordinateDecoderType type,
+                              const uint8_t* deltas,
+                              size_t deltaBytes,
+                              size_t count,
+                              uint32_t latValue,
+                              uint32_t lonValue,
+                              uint32_t* latValues,
+                              uint32_t* lonValues)
+  {
+    size_t decoded=0;
+
+#if defined(OSMSCOUT_HAVE_X86_SIMD)
+    if (type==CoordinateDecoderType::AVX2) {
+      if (deltaBytes==1) {
+        decoded=DecodeCoordinateDeltasAVX2<1>(deltas,count,latValue,lonValue,latValues,lonValues);
+      }
+      else if (deltaBytes==2) {
+        decoded=DecodeCoordinateDeltasAVX2<2>(deltas,count,latValue,lonValue,latValues,lonValues);
+      }
+      else {
+        decoded=DecodeCoordinateDeltasAVX2<3>(deltas,count,latValue,lonValue,latValues,lonValues);
+      }
+    }
+    else if (type==CoordinateDecoderType::SSE41) {
+      if (deltaBytes==1) {
+        decoded=DecodeCoordinateDeltasSSE41<1>(deltas,count,latValue,lonValue,latValues,lonValues);
+      }
+      else if (deltaBytes==2) {
+        decoded=DecodeCoordinateDeltasSSE41<2>(deltas,count,latValue,lonValue,latValues,lonValues);
+      }
+      else {
+        decoded=DecodeCoordinateDeltasSSE41<3>(deltas,count,latValue,lonValue,latValues,lonValues);
+      }
+    }
+#else
+    (void)type;
+#endif
+
+    DecodeCoordinateDeltasScalar(deltas+decoded*2*deltaBytes,
+                                 deltaBytes,
+                                 count-decoded,
+                                 latValue,
+                                 lonValue,
+                                 latValues+decoded,
+                                 lonValues+decoded);
+  }
+
+  /**
+   * Convert the given number of fixed point lat and lon values to degrees, the
+   * same way as GeoCoord does.
+   *
+   * The given implementation must be supported (see IsCoordinateDecoderSupported()).
+   */
+  void ConvertCoordinateValues(CoordinateDecoderType type,
+                               const uint32_t* latValues,
+                               const uint32_t* lonValues,
+                               size_t count,
+                               double* lats,
+                               double* lons)
+  {
+    size_t converted=0;
+
+#if defined(OSMSCOUT_HAVE_X86_SIMD)
+    if (type==CoordinateDecoderType::AVX2) {
+      converted=ConvertCoordinateValuesAVX2(latValues,lonValues,count,lats,lons);
+    }
+    else if (type==CoordinateDecoderType::SSE41) {
+      converted=ConvertCoordinateValuesSSE41(latValues,lonValues,count,lats,lons);
+    }
+#else
+    (void)type;
+#endif
+
+    ConvertCoordinateValuesScalar(latValues+converted,
+                                  lonValues+converted,
+                                  count-converted,
+                                  lats+converted,
+                                  lons+converted);
+  }
+
+  /**
+   * Decode deltas using the best implementation supported by the processor.
+   */
+  void DecodeCoordinateDeltas(const uint8_t* deltas,
+                              size_t deltaBytes,
+                              size_t count,
+                              uint32_t latValue,
+                              uint32_t lonValue,
+                              uint32_t* latValues,
+                              uint32_t* lonValues)
+  {
+    DecodeCoordinateDeltas(GetCoordinateDecoderType(),
+                           deltas,
+                           deltaBytes,
+                           count,
+                           latValue,
+                           lonValue,
+                           latValues,
+                           lonValues);
+  }
+
+  /**
+   * Convert values using the best implementation supported by the processor.
+   */
+  void ConvertCoordinateValues(const uint32_t* latValues,
+                               const uint32_t* lonValues,
+                               size_t count,
+                               double* lats,
+                               double* lons)
+  {
+    ConvertCoordinateValues(GetCoordinateDecoderType(),
+                            latValues,
+                            lonValues,
+                            count,
+                            lats,
+                            lons);
+  }
+}
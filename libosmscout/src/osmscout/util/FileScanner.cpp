@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
 #include <limits>
 
 #if defined(HAVE_MMAP)
@@ -47,6 +48,7 @@
 #include <osmscout/system/Assert.h>
 #include <osmscout/system/Compiler.h>
 
+#include <osmscout/util/CoordinateDecoding.h>
 #include <osmscout/util/Exception.h>
 #include <osmscout/util/Logger.h>
 #include <osmscout/util/Number.h>
@@ -58,10 +60,15 @@ namespace osmscout {
    : file(NULL),
      hasError(true),
      buffer(NULL),
+     sharedMapping(false),
      size(0),
      offset(0),
      byteBuffer(NULL),
-     byteBufferSize(0)
+     byteBufferSize(0),
+     blockCompressed(false),
+     currentBlock(0),
+     bufferStart(0),
+     dataSize(0)
 #if defined(_WIN32)
      ,mmfHandle((HANDLE)0)
 #endif
@@ -94,6 +101,25 @@ namespace osmscout {
 
   void FileScanner::FreeBuffer()
   {
+    if (blockCompressed) {
+      // buffer points into the decompressed block, it is not mapped
+      blockCompressed=false;
+      blocks.clear();
+      blockData=nullptr;
+      buffer=NULL;
+      bufferStart=0;
+
+      return;
+    }
+
+    if (sharedMapping) {
+      // The mapping is owned by another scanner
+      sharedMapping=false;
+      buffer=NULL;
+
+      return;
+    }
+
 #if defined(HAVE_MMAP)
     if (buffer!=NULL) {
       if (munmap(buffer,size)!=0) {
@@ -114,9 +140,95 @@ namespace osmscout {
 #endif
   }
 
+#if defined(HAVE_MMAP)
+  /**
+   * Give the operating system hints about the usage of the current memory
+   * mapping. Failures are logged, but are not fatal.
+   */
+  void FileScanner::ApplyMmapPolicy(Mode mode,
+                                    const MmapPolicy& mmapPolicy)
+  {
+#if defined(HAVE_POSIX_MADVISE)
+    MmapPolicy::Advice advice=mmapPolicy.GetAdvice();
+
+    if (advice==MmapPolicy::AdviceDefault) {
+      if (mode==FastRandom) {
+        advice=MmapPolicy::AdviceWillNeed;
+      }
+      else if (mode==Sequential) {
+        advice=MmapPolicy::AdviceSequential;
+      }
+      else if (mode==LowMemRandom) {
+        advice=MmapPolicy::AdviceRandom;
+      }
+    }
+
+    int posixAdvice=-1;
+
+    switch (advice) {
+    case MmapPolicy::AdviceDefault:
+      break;
+    case MmapPolicy::AdviceNormal:
+      posixAdvice=POSIX_MADV_NORMAL;
+      break;
+    case MmapPolicy::AdviceRandom:
+      posixAdvice=POSIX_MADV_RANDOM;
+      break;
+    case MmapPolicy::AdviceSequential:
+      posixAdvice=POSIX_MADV_SEQUENTIAL;
+      break;
+    case MmapPolicy::AdviceWillNeed:
+      posixAdvice=POSIX_MADV_WILLNEED;
+      break;
+    }
+
+    if (posixAdvice>=0) {
+      int result=posix_madvise(buffer,(size_t)size,posixAdvice);
+
+      if (result!=0) {
+        log.Error() << "Cannot set mmaped file access advice for file '" << filename << "' (" << strerror(result) << ")";
+      }
+    }
+#else
+    unused(mode);
+#endif
+
+#if !defined(MAP_POPULATE) && defined(HAVE_POSIX_MADVISE)
+    // No MAP_POPULATE, at least trigger asynchronous read ahead
+    if (mmapPolicy.GetPopulate()) {
+      int result=posix_madvise(buffer,(size_t)size,POSIX_MADV_WILLNEED);
+
+      if (result!=0) {
+        log.Error() << "Cannot set mmaped file access advice for file '" << filename << "' (" << strerror(result) << ")";
+      }
+    }
+#endif
+
+#if defined(MADV_HUGEPAGE)
+    if (mmapPolicy.GetHugePages() &&
+        madvise(buffer,(size_t)size,MADV_HUGEPAGE)!=0) {
+      log.Warn() << "Cannot request huge pages for file '" << filename << "' (" << strerror(errno) << ")";
+    }
+#endif
+
+    if (mmapPolicy.GetLock() &&
+        mlock(buffer,(size_t)size)!=0) {
+      log.Warn() << "Cannot lock file '" << filename << "' into memory (" << strerror(errno) << ")";
+    }
+  }
+#endif
+
+  /**
+   * Open the given file for reading.
+   *
+   * If useMmap is true and mmap is available, the file is mapped into memory.
+   * The mapping is set up according to the given MmapPolicy. The default
+   * policy derives the access advice from the given mode.
+   */
   void FileScanner::Open(const std::string& filename,
                          Mode mode,
-                         bool useMmap)
+                         bool useMmap,
+                         const MmapPolicy& mmapPolicy)
   {
     if (file!=NULL) {
       throw IOException(filename,"Error opening file for reading","File already opened");
@@ -190,6 +302,11 @@ namespace osmscout {
     }
 #endif
 
+    if (this->size>=BLOCK_COMPRESSION_HEADER_SIZE &&
+        OpenBlockCompressed()) {
+      return;
+    }
+
 #if defined(HAVE_POSIX_FADVISE)
     if (mode==FastRandom) {
       if (posix_fadvise(fileno(file),0,size,POSIX_FADV_WILLNEED)<0) {
@@ -212,26 +329,19 @@ namespace osmscout {
     if (useMmap && this->size>0) {
       FreeBuffer();
 
-      buffer=(char*)mmap(NULL,(size_t)size,PROT_READ,MAP_PRIVATE,fileno(file),0);
+      int flags=MAP_PRIVATE;
+
+#if defined(MAP_POPULATE)
+      if (mmapPolicy.GetPopulate()) {
+        flags|=MAP_POPULATE;
+      }
+#endif
+
+      buffer=(char*)mmap(NULL,(size_t)size,PROT_READ,flags,fileno(file),0);
       if (buffer!=MAP_FAILED) {
         offset=0;
-#if defined(HAVE_POSIX_MADVISE)
-        if (mode==FastRandom) {
-          if (posix_madvise(buffer,(size_t)size,POSIX_MADV_WILLNEED)<0) {
-            log.Error() << "Cannot set mmaped file access advice for file '" << filename << "' (" << strerror(errno) << ")";
-          }
-        }
-        else if (mode==Sequential) {
-          if (posix_madvise(buffer,(size_t)size,POSIX_MADV_SEQUENTIAL)<0) {
-            log.Error() << "Cannot set mmaped file access advice for file '" << filename << "' (" << strerror(errno) << ")";
-          }
-        }
-        else if (mode==LowMemRandom) {
-          if (posix_madvise(buffer,(size_t)size,POSIX_MADV_RANDOM)<0) {
-            log.Error() << "Cannot set mmaped file access advice for file '" << filename << "' (" << strerror(errno) << ")";
-          }
-        }
-#endif
+        ApplyMmapPolicy(mode,
+                        mmapPolicy);
       }
       else {
         log.Error() << "Cannot mmap file '" << filename << "' of size " << size << " (" << strerror(errno) << ")";
@@ -240,6 +350,7 @@ namespace osmscout {
     }
 #elif  defined(_WIN32)
     unused(mode);
+    unused(mmapPolicy);
     if (useMmap && this->size>0) {
       FreeBuffer();
 
@@ -272,6 +383,191 @@ namespace osmscout {
     hasError=false;
   }
 
+  /**
+   * Check if the file is block compressed and if so, load the block index and
+   * the first block. Returns false (with the file positioned at its start), if
+   * the file is not block compressed.
+   *
+   * throws IOException on error
+   */
+  bool FileScanner::OpenBlockCompressed()
+  {
+    char magic[sizeof(BLOCK_COMPRESSION_MAGIC)];
+
+    if (fread(magic,1,sizeof(magic),file)!=sizeof(magic)) {
+      throw IOException(filename,"Cannot read file header");
+    }
+
+    if (memcmp(magic,BLOCK_COMPRESSION_MAGIC,sizeof(magic))!=0) {
+      if (fseek(file,0L,SEEK_SET)!=0) {
+        throw IOException(filename,"Cannot seek to start of file");
+      }
+
+      return false;
+    }
+
+#if !defined(HAVE_MMAP) && !defined(_WIN32)
+    throw IOException(filename,"Cannot open block compressed file","Not supported on this platform");
+#endif
+
+    if (!IsBlockCompressionSupported()) {
+      throw IOException(filename,"Cannot open block compressed file","Block compression is not supported");
+    }
+
+    uint32_t version;
+    uint32_t blockSize;
+    uint64_t uncompressedSize;
+    uint64_t indexOffset;
+    uint32_t blockCount;
+
+    hasError=false;
+
+    Read(version);
+
+    if (version!=BLOCK_COMPRESSION_VERSION) {
+      hasError=true;
+      throw IOException(filename,"Cannot open block compressed file","Unsupported format version "+std::to_string(version));
+    }
+
+    Read(blockSize);
+    Read(uncompressedSize);
+    Read(indexOffset);
+
+    SetPos(indexOffset);
+
+    Read(blockCount);
+
+    blocks.resize(blockCount);
+
+    for (auto& block : blocks) {
+      uint64_t logicalOffset;
+      uint64_t fileOffset;
+
+      Read(logicalOffset);
+      Read(fileOffset);
+      Read(block.compressedSize);
+      Read(block.uncompressedSize);
+
+      block.logicalOffset=logicalOffset;
+      block.fileOffset=fileOffset;
+    }
+
+    blockCompressed=true;
+    dataSize=uncompressedSize;
+    size=0;
+    offset=0;
+
+    if (!blocks.empty()) {
+      LoadBlock(0);
+    }
+
+    return true;
+  }
+
+  /**
+   * Make the block with the given index the current block, positioned at its start.
+   * The block is taken from the block cache, if available, else it is read
+   * and decompressed.
+   *
+   * throws IOException on error
+   */
+  void FileScanner::LoadBlock(size_t blockIndex)
+  {
+    const CompressedBlock& block=blocks[blockIndex];
+    BlockDataRef           data;
+
+    if (!blockCache ||
+        !blockCache->Get(block.logicalOffset,data)) {
+      clearerr(file);
+
+#if defined(HAVE_FSEEKO)
+      hasError=fseeko(file,(off_t)block.fileOffset,SEEK_SET)!=0;
+#elif defined(HAVE__FSEEKi64)
+      hasError=_fseeki64(file,(__int64)block.fileOffset,SEEK_SET)!=0;
+#else
+      hasError=fseek(file,(long)block.fileOffset,SEEK_SET)!=0;
+#endif
+
+      if (hasError) {
+        throw IOException(filename,"Cannot read compressed block","Cannot seek to block");
+      }
+
+      AssureByteBufferSize(block.compressedSize);
+
+      hasError=fread(byteBuffer,1,block.compressedSize,file)!=block.compressedSize;
+
+      if (hasError) {
+        throw IOException(filename,"Cannot read compressed block");
+      }
+
+      std::shared_ptr<std::vector<char>> decompressed=std::make_shared<std::vector<char>>(block.uncompressedSize);
+
+      if (!DecompressBlock(reinterpret_cast<const char*>(byteBuffer),
+                           block.compressedSize,
+                           decompressed->data(),
+                           decompressed->size())) {
+        hasError=true;
+        throw IOException(filename,"Cannot read compressed block","Cannot decompress block");
+      }
+
+      data=decompressed;
+
+      if (blockCache) {
+        blockCache->Put(block.logicalOffset,data);
+      }
+    }
+
+    blockData=data;
+    buffer=const_cast<char*>(blockData->data());
+    size=blockData->size();
+    bufferStart=block.logicalOffset;
+    offset=0;
+    currentBlock=blockIndex;
+  }
+
+  /**
+   * Set a cache for decompressed blocks of a block compressed file. The cache
+   * can be shared between multiple scanners reading the same file. Has no effect,
+   * if the file is not block compressed.
+   */
+  void FileScanner::SetBlockCache(const BlockDataCacheRef& blockCache)
+  {
+    this->blockCache=blockCache;
+  }
+
+  /**
+   * Access the file via the memory mapping of the given scanner instead of reading it
+   * via the file handle. The given scanner must be opened on the same file and must
+   * stay open as long as this scanner is open. The mapping is not unmapped, if this
+   * scanner gets closed.
+   *
+   * This way multiple scanners for the same file only need one mapping and pointers
+   * into the mapping (see GetMappedData()) stay valid independent of the scanner
+   * used to get them.
+   *
+   * throws IOException if this scanner is not open or already memory mapped or the
+   * given scanner is not memory mapped
+   */
+  void FileScanner::ShareMapping(const FileScanner& mappedScanner)
+  {
+    if (HasError()) {
+      throw IOException(filename,"Cannot share mapping","File already in error state");
+    }
+
+    if (buffer!=NULL || blockCompressed) {
+      throw IOException(filename,"Cannot share mapping","File already has its own buffer");
+    }
+
+    if (!mappedScanner.IsMemoryMapped() ||
+        mappedScanner.size!=size) {
+      throw IOException(filename,"Cannot share mapping","Given file is not a memory mapped version of this file");
+    }
+
+    buffer=mappedScanner.buffer;
+    sharedMapping=true;
+    offset=0;
+  }
+
   /**
    * Closes the file.
    *
@@ -321,6 +617,10 @@ namespace osmscout {
       return true;
     }
 
+    if (blockCompressed) {
+      return bufferStart+offset>=dataSize;
+    }
+
     if (size==0) {
       return true;
     }
@@ -360,6 +660,29 @@ namespace osmscout {
       throw IOException(filename,"Cannot set position in file","File already in error state");
     }
 
+    if (blockCompressed) {
+      if (pos>=dataSize) {
+        hasError=true;
+        throw IOException(filename,"Cannot set position in file to "+std::to_string(pos),"Position beyond file end");
+      }
+
+      if (pos<bufferStart ||
+          pos>=bufferStart+size) {
+        auto block=std::upper_bound(blocks.begin(),
+                                    blocks.end(),
+                                    pos,
+                                    [](FileOffset position, const CompressedBlock& block) {
+                                      return position<block.logicalOffset;
+                                    });
+
+        LoadBlock((size_t)(block-blocks.begin())-1);
+      }
+
+      offset=pos-bufferStart;
+
+      return;
+    }
+
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
       if (pos>=size) {
@@ -388,6 +711,99 @@ namespace osmscout {
     }
   }
 
+  /**
+   * Returns a pointer to the given range of the memory mapped file content. The pointer
+   * stays valid until the file is closed.
+   *
+   * throws IOException if the file is not memory mapped or the range exceeds the file
+   */
+  const char* FileScanner::GetMappedData(FileOffset offset,
+                                         size_t bytes) const
+  {
+    if (HasError()) {
+      throw IOException(filename,"Cannot access mapped data","File already in error state");
+    }
+
+    if (buffer==NULL ||
+        blockCompressed) {
+      throw IOException(filename,"Cannot access mapped data","File is not memory mapped");
+    }
+
+    if (offset>size || bytes>size-offset) {
+      throw IOException(filename,"Cannot access mapped data","Cannot read beyond end of file");
+    }
+
+    return &buffer[offset];
+  }
+
+  /**
+   * Returns a pointer to the given number of bytes of the memory mapped file content
+   * at the current position and moves the position behind them. The pointer stays valid
+   * until the file is closed.
+   *
+   * throws IOException if the file is not memory mapped or the range exceeds the file
+   */
+  const char* FileScanner::ReadMappedData(size_t bytes)
+  {
+    const char* data=GetMappedData(offset,
+                                   bytes);
+
+    offset+=bytes;
+
+    return data;
+  }
+
+  /**
+   * Advise the operating system that the given range of the file will be read soon,
+   * so that it can be read ahead asynchronously and in one go. Reading a number of
+   * objects located near to each other profits from prefetching the range covering
+   * all of them, especially if the file was opened in LowMemRandom mode (which
+   * disables the read ahead of the operating system).
+   *
+   * This is only a hint, errors are logged but otherwise ignored. The range is
+   * clipped to the size of the file.
+   */
+  void FileScanner::Prefetch(FileOffset offset,
+                             size_t bytes) const
+  {
+    if (HasError() ||
+        blockCompressed ||
+        offset>=size ||
+        bytes==0) {
+      return;
+    }
+
+    if (bytes>size-offset) {
+      bytes=(size_t)(size-offset);
+    }
+
+#if defined(HAVE_MMAP) && defined(HAVE_POSIX_MADVISE)
+    if (buffer!=NULL) {
+      // posix_madvise() requires a page aligned address
+      FileOffset pageSize=(FileOffset)sysconf(_SC_PAGESIZE);
+      FileOffset start=offset-offset%pageSize;
+
+      int        result=posix_madvise(&buffer[start],(size_t)(offset-start)+bytes,POSIX_MADV_WILLNEED);
+
+      if (result!=0) {
+        log.Error() << "Cannot set mmaped file access advice for file '" << filename << "' (" << strerror(result) << ")";
+      }
+
+      return;
+    }
+#endif
+
+#if defined(HAVE_POSIX_FADVISE)
+    if (buffer==NULL) {
+      int result=posix_fadvise(fileno(file),(off_t)offset,(off_t)bytes,POSIX_FADV_WILLNEED);
+
+      if (result!=0) {
+        log.Error() << "Cannot set file access advice for file '" << filename << "' (" << strerror(result) << ")";
+      }
+    }
+#endif
+  }
+
   /**
    * Returns the current position of the reading cursor in relation to the begining of the file
    *
@@ -401,7 +817,7 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
-      return offset;
+      return bufferStart+offset;
     }
 #endif
 
@@ -443,6 +859,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (this->buffer!=NULL) {
+      AssureBlockData();
+
       if (offset+(FileOffset)bytes-1>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read byte array","Cannot read beyond end of file");
@@ -473,6 +891,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read string","Cannot read beyond end of file");
@@ -525,6 +945,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read bool","Cannot read beyond end of file");
@@ -559,6 +981,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read int8_t","Cannot read beyond end of file");
@@ -589,6 +1013,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset+2-1>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read int16_t","Cannot read beyond end of file");
@@ -643,6 +1069,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset+4-1>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read int32_t","Cannot read beyond end of file");
@@ -717,6 +1145,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset+8-1>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read int64_t","Cannot read beyond end of file");
@@ -831,6 +1261,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read uint8_t","Cannot read beyond end of file");
@@ -861,6 +1293,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset+2-1>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read uint16_t","Cannot read beyond end of file");
@@ -915,6 +1349,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset+4-1>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read uint32_t","Cannot read beyond end of file");
@@ -989,6 +1425,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset+8-1>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read uint64_t","Cannot read beyond end of file");
@@ -1104,6 +1542,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset+bytes-1>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read size limited uint16_t","Cannot read beyond end of file");
@@ -1163,6 +1603,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset+bytes-1>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read size limited uint32_t","Cannot read beyond end of file");
@@ -1250,6 +1692,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset+bytes-1>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read size limited uint64_t","Cannot read beyond end of file");
@@ -1403,6 +1847,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset+8-1>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read file offset","Cannot read beyond end of file");
@@ -1520,6 +1966,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset+bytes-1>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read file offset","Cannot read beyond end of file");
@@ -1662,6 +2110,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read int16_t number","Cannot read beyond end of file");
@@ -1742,6 +2192,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read int32_t number","Cannot read beyond end of file");
@@ -1823,6 +2275,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset>=size) {
         hasError=true;
         throw IOException(filename,"Cannot read int64_t number","Cannot read beyond end of file");
@@ -1903,6 +2357,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       unsigned int shift=0;
 
       for (; offset<size; offset++) {
@@ -1956,6 +2412,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       unsigned int shift=0;
 
       for (; offset<size; offset++) {
@@ -2009,6 +2467,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       unsigned int shift=0;
 
       for (; offset<size; offset++) {
@@ -2063,6 +2523,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset+coordByteSize-1>=size) {
         hasError=true;
 
@@ -2124,6 +2586,8 @@ namespace osmscout {
 
 #if defined(HAVE_MMAP) || defined(_WIN32)
     if (buffer!=NULL) {
+      AssureBlockData();
+
       if (offset+coordByteSize-1>=size) {
         hasError=true;
 
@@ -2271,9 +2735,8 @@ namespace osmscout {
 
     nodes.resize(nodeCount);
 
-    size_t byteBufferSize=(nodeCount-1)*coordBitSize/8;
-
-    AssureByteBufferSize(byteBufferSize);
+    size_t deltaBytes=coordBitSize/16;
+    size_t deltaBufferSize=(nodeCount-1)*2*deltaBytes;
 
     GeoCoord firstCoord;
 
@@ -2284,88 +2747,64 @@ namespace osmscout {
     uint32_t latValue=(uint32_t)round((nodes[0].GetLat()+90.0)*latConversionFactor);
     uint32_t lonValue=(uint32_t)round((nodes[0].GetLon()+180.0)*lonConversionFactor);
 
-    Read((char*)byteBuffer,byteBufferSize);
-
-    if (coordBitSize==16) {
-      size_t currentCoordPos=1;
+    const uint8_t* deltas=NULL;
 
-      for (size_t i=0; i<byteBufferSize; i+=2) {
-        int32_t latDelta=(int8_t)byteBuffer[i];
-        int32_t lonDelta=(int8_t)byteBuffer[i+1];
-
-        latValue+=latDelta;
-        lonValue+=lonDelta;
-
-        nodes[currentCoordPos].SetCoord(GeoCoord(latValue/latConversionFactor-90.0,
-                                                 lonValue/lonConversionFactor-180.0));
+#if defined(HAVE_MMAP) || defined(_WIN32)
+    if (buffer!=NULL) {
+      // Decode directly from the mapped (or decompressed) data without copying
+      AssureBlockData();
 
-        currentCoordPos++;
+      if (offset+(FileOffset)deltaBufferSize>size) {
+        hasError=true;
+        throw IOException(filename,"Cannot read coordinates","Cannot read beyond end of file");
       }
-    }
-    else if (coordBitSize==32) {
-      size_t currentCoordPos=1;
-
-      for (size_t i=0; i<byteBufferSize; i+=4) {
-        uint32_t latUDelta=byteBuffer[i+0] | (byteBuffer[i+1]<<8);
-        uint32_t lonUDelta=byteBuffer[i+2] | (byteBuffer[i+3]<<8);
-        int32_t  latDelta;
-        int32_t  lonDelta;
-
-        if (latUDelta & 0x8000) {
-          latDelta=(int32_t)(latUDelta | 0xffff0000);
-        }
-        else {
-          latDelta=(int32_t)latUDelta;
-        }
-
-        latValue+=latDelta;
 
-        if (lonUDelta & 0x8000) {
-          lonDelta=(int32_t)(lonUDelta | 0xffff0000);
-        }
-        else {
-          lonDelta=(int32_t)lonUDelta;
-        }
-
-        lonValue+=lonDelta;
-
-        nodes[currentCoordPos].SetCoord(GeoCoord(latValue/latConversionFactor-90.0,
-                                                 lonValue/lonConversionFactor-180.0));
-        currentCoordPos++;
-      }
+      deltas=reinterpret_cast<const uint8_t*>(&buffer[offset]);
+      offset+=deltaBufferSize;
     }
-    else {
-      size_t currentCoordPos=1;
+#endif
 
-      for (size_t i=0; i<byteBufferSize; i+=6) {
-        uint32_t latUDelta=(byteBuffer[i+0]) | (byteBuffer[i+1]<<8) | (byteBuffer[i+2]<<16);
-        uint32_t lonUDelta=(byteBuffer[i+3]) | (byteBuffer[i+4]<<8) | (byteBuffer[i+5]<<16);
-        int32_t  latDelta;
-        int32_t  lonDelta;
+    if (deltas==NULL) {
+      AssureByteBufferSize(deltaBufferSize);
 
-        if (latUDelta & 0x800000) {
-          latDelta=(int32_t)(latUDelta | 0xff000000);
-        }
-        else {
-          latDelta=(int32_t)latUDelta;
-        }
+      Read((char*)byteBuffer,deltaBufferSize);
 
-        latValue+=latDelta;
+      deltas=byteBuffer;
+    }
 
-        if (lonUDelta & 0x800000) {
-          lonDelta=(int32_t)(lonUDelta | 0xff000000);
-        }
-        else {
-          lonDelta=(int32_t)lonUDelta;
-        }
+    // Decode in chunks into contiguous lat and lon arrays on the stack
+    const size_t chunkSize=128;
+    uint32_t     latValues[chunkSize];
+    uint32_t     lonValues[chunkSize];
+    double       lats[chunkSize];
+    double       lons[chunkSize];
+    size_t       currentCoordPos=1;
 
-        lonValue+=lonDelta;
+    while (currentCoordPos<nodeCount) {
+      size_t count=std::min(chunkSize,nodeCount-currentCoordPos);
 
-        nodes[currentCoordPos].SetCoord(GeoCoord(latValue/latConversionFactor-90.0,
-                                                 lonValue/lonConversionFactor-180.0));
+      DecodeCoordinateDeltas(deltas,
+                             deltaBytes,
+                             count,
+                             latValue,
+                             lonValue,
+                             latValues,
+                             lonValues);
+      ConvertCoordinateValues(latValues,
+                              lonValues,
+                              count,
+                              lats,
+                              lons);
 
-        currentCoordPos++;
+      for (size_t i=0; i<count; i++) {
+        nodes[currentCoordPos+i].SetCoord(GeoCoord(lats[i],
+                                                   lons[i]));
       }
+
+      latValue=latValues[count-1];
+      lonValue=lonValues[count-1];
+      deltas+=count*2*deltaBytes;
+      currentCoordPos+=count;
     }
 
     if (hasNodes) {
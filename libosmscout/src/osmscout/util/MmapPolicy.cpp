@@ -0,0 +1,87 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2018  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/util/MmapPolicy.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <sys/resource.h>
+  #define OSMSCOUT_HAVE_GETRUSAGE
+#endif
+
+namespace osmscout {
+
+  MmapPolicy::MmapPolicy()
+  : advice(AdviceDefault),
+    populate(false),
+    lock(false),
+    hugePages(false)
+  {
+    // no code
+  }
+
+  PageFaultCount::PageFaultCount()
+  : minorFaults(0),
+    majorFaults(0)
+  {
+    // no code
+  }
+
+  PageFaultCount PageFaultCount::operator-(const PageFaultCount& other) const
+  {
+    PageFaultCount result;
+
+    result.minorFaults=minorFaults>=other.minorFaults ? minorFaults-other.minorFaults : 0;
+    result.majorFaults=majorFaults>=other.majorFaults ? majorFaults-other.majorFaults : 0;
+
+    return result;
+  }
+
+  /**
+   * Returns true, if GetPageFaultCount() returns real values on this platform
+   */
+  bool IsPageFaultCountSupported()
+  {
+#if defined(OSMSCOUT_HAVE_GETRUSAGE)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * Return the number of page faults of the current process since its start.
+   * Note that the counters are process wide and thus also contain page faults
+   * not caused by libosmscout.
+   */
+  PageFaultCount GetPageFaultCount()
+  {
+    PageFaultCount result;
+
+#if defined(OSMSCOUT_HAVE_GETRUSAGE)
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF,&usage)==0) {
+      result.minorFaults=(size_t)usage.ru_minflt;
+      result.majorFaults=(size_t)usage.ru_majflt;
+    }
+#endif
+
+    return result;
+  }
+}
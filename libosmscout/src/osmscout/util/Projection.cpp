@@ -356,7 +356,8 @@ namespace osmscout {
     lonOffset=lonMin*scaleGradtorad;
     latOffset=scale*atanh(sin(latMin*gradtorad));
 
-    pixelSize=earthExtentMeter/magnification.GetMagnification()/width;
+    // The box may span multiple tiles (metatiles), so use its real extent
+    pixelSize=earthExtentMeter*(lonMax-lonMin)/360.0/width;
     meterInPixel=1/pixelSize;
     meterInMM=meterInPixel*25.4/pixelSize;
 
@@ -201,6 +201,42 @@ namespace osmscout {
     return usedPoints++;
   }
 
+  /**
+   * Append count coordinates of the other buffer, starting at index start.
+   *
+   * @return
+   *    Index of the first appended coordinate in this buffer
+   */
+  size_t CoordBuffer::PushCoords(const CoordBuffer& other,
+                                 size_t start,
+                                 size_t count)
+  {
+    assert(start+count<=other.usedPoints);
+
+    if (usedPoints+count>bufferSize) {
+      while (usedPoints+count>bufferSize) {
+        bufferSize=bufferSize*2;
+      }
+
+      auto* newBuffer=new Vertex2D[bufferSize];
+
+      std::copy(buffer,buffer+usedPoints,newBuffer);
+
+      log.Warn() << "*** Buffer reallocation: " << bufferSize;
+
+      delete [] buffer;
+
+      buffer=newBuffer;
+    }
+
+    size_t first=usedPoints;
+
+    std::copy(other.buffer+start,other.buffer+start+count,buffer+usedPoints);
+    usedPoints+=count;
+
+    return first;
+  }
+
   bool CoordBuffer::GenerateParallelWay(size_t orgStart,
                                         size_t orgEnd,
                                         double offset,